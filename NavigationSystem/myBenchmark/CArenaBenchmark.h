@@ -0,0 +1,175 @@
+/*
+ * CArenaBenchmark.h
+ */
+
+#ifndef CARENABENCHMARK_H_
+#define CARENABENCHMARK_H_
+
+#include <iostream>
+#include <list>
+#include <vector>
+#include <utility>
+#include <cstdio>
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "CStopWatch.h"
+#include "CMemoryUsage.h"
+#include "../myCode/CArena.h"
+#include "../myCode/CWaypoint.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CRoute.h"
+
+/**
+ * This class compares the memory sources of the containers:
+ * - a bulk load and a reset of a database whose map nodes come one by one from the heap (as std::allocator)
+ *   or from a CMonotonicArena (the default of CMapStorage); each runs in a child process which starts with
+ *   the free memory of the earlier benchmarks given back to the system, the names are pooled before and
+ *   stay in the string pool after a reset,
+ * - the hops of a route which grows and shrinks: a list with std::allocator or a CNodePool against
+ *   the array of the route (Route_Collection_t).
+ */
+class CArenaBenchmark {
+public:
+
+	static void run() {
+			std::cout << "=======================================================\n";
+			std::cout << "Database load: " << waypointCount << " Waypoints into CMapStorage\n";
+
+			// the names are pooled once, both databases load the same strings
+			std::vector<Wp_Database_key_t> 	names;
+			double							poolBefore = CStringPool::getInstance().getMemoryUsage();
+
+			for (unsigned int index = 0; index < waypointCount; ++index)
+			{
+				char name[32];
+
+				snprintf(name, sizeof(name), "Waypoint %u", index);
+				names.push_back(name);
+			}
+
+			std::cout << "  string pool     : " << (CStringPool::getInstance().getMemoryUsage() - poolBefore) / (1024 * 1024)
+					  << " MB of names, not released by a reset\n";
+
+			measureLoadInChild<CHeapArena>("heap (before)  ", names);
+			measureLoadInChild<CMonotonicArena>("monotonic arena", names);
+
+			std::cout << "Route: " << routeRounds << " times " << routeHops << " hops added and removed\n";
+
+			std::list<CRouteHop>	heapRoute;
+			CStopWatch				stopWatch;
+
+			fillRoute(heapRoute);
+
+			std::cout << "  list, heap      : " << stopWatch.elapsedMs() << " ms\n";
+
+			CNodePool			nodePool;
+			Hop_Allocator_t		allocator(&nodePool);
+			Hop_List_t			poolRoute(allocator);
+
+			stopWatch.restart();
+			fillRoute(poolRoute);
+
+			std::cout << "  list, node pool : " << stopWatch.elapsedMs() << " ms\n";
+
+			Route_Collection_t	route;
+
+			stopWatch.restart();
+			fillRoute(route);
+
+			std::cout << "  route array     : " << stopWatch.elapsedMs() << " ms\n";
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	typedef CArenaAllocator<CRouteHop, CNodePool>		Hop_Allocator_t;
+	typedef std::list<CRouteHop, Hop_Allocator_t> 		Hop_List_t;
+
+	static const unsigned int waypointCount 	= 2000000;
+	static const unsigned int routeHops 		= 100000;
+	static const unsigned int routeRounds 		= 50;
+
+	/**
+	 * Measure a load in a child process: the resident set of this process is churned by the earlier
+	 * benchmarks, the child gives the free memory back to the system before it measures
+	 */
+	template<class TArena>
+	static void measureLoadInChild(char const *label, std::vector<Wp_Database_key_t> const &names) {
+			std::cout.flush();
+
+			pid_t child = fork();
+
+			if (child == 0)
+			{
+				malloc_trim(0);
+				measureLoad<TArena>(label, names);
+				std::cout.flush();
+				_exit(0);
+			}
+			else if (child > 0)
+			{
+				waitpid(child, 0, 0);
+			}
+			else
+			{
+				malloc_trim(0);
+				measureLoad<TArena>(label, names);
+			}
+		}
+
+	template<class TArena>
+	static void measureLoad(char const *label, std::vector<Wp_Database_key_t> const &names) {
+			typedef CDatabase<Wp_Database_key_t, CWaypoint, CMapStorage<Wp_Database_key_t, CWaypoint, TArena> > Database_t;
+
+			typename Database_t::Database_Batch_t 	batch;
+			double									before = CMemoryUsage::residentBytes();
+
+			// the batch is emptied by the load: the growth of the resident set is the database and the pooled names
+			for (unsigned int index = 0; index < names.size(); ++index)
+			{
+				batch.push_back(std::make_pair(names[index], CWaypoint(names[index], -80.0 + 0.1 * (index % 1600), -180.0 + 0.1 * ((index / 1600) % 3600))));
+			}
+
+			Database_t	*pDatabase 	= new Database_t;
+			CStopWatch	stopWatch;
+
+			pDatabase->replaceElements(batch);
+
+			double		loadMs 		= stopWatch.elapsedMs();
+			double		loadedBytes = CMemoryUsage::residentBytes() - before;
+
+			stopWatch.restart();
+			pDatabase->resetDatabase();
+
+			double		resetMs 	= stopWatch.elapsedMs();
+			double		resetBytes 	= CMemoryUsage::residentBytes() - before;
+
+			std::cout << "  " << label << " : load " << loadMs << " ms, " << std::showpos << loadedBytes / (1024 * 1024) << std::noshowpos << " MB; "
+					  << "reset " << resetMs << " ms, " << std::showpos << resetBytes / (1024 * 1024) << std::noshowpos << " MB left\n";
+
+			delete pDatabase;
+		}
+
+	/**
+	 * Append the hops to the route and remove them all, as a route which is planned again
+	 */
+	template<class TRoute>
+	static void fillRoute(TRoute &route) {
+			CWaypoint 	wp("Luisenplatz", 49.8728, 8.6512);
+			CRouteHop 	hop = { &wp, 0, wp.getPooledName(), (unsigned char)CWaypoint::WAYPOINT };
+
+			for (unsigned int round = 0; round < routeRounds; ++round)
+			{
+				for (unsigned int index = 0; index < routeHops; ++index)
+				{
+					route.push_back(hop);
+				}
+
+				route.clear();
+			}
+		}
+};
+
+#endif /* CARENABENCHMARK_H_ */
@@ -0,0 +1,87 @@
+/*
+ * CBatchNearestPoiBenchmark.h
+ */
+
+#ifndef CBATCHNEARESTPOIBENCHMARK_H_
+#define CBATCHNEARESTPOIBENCHMARK_H_
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+
+#include "CStopWatch.h"
+#include "../myCode/CRoute.h"
+
+/**
+ * This class compares the batched k-nearest POI query with a loop over CRoute::getDistanceNextDatabasePoi.
+ */
+class CBatchNearestPoiBenchmark {
+public:
+
+	static void run() {
+			const unsigned int 	poiCount	= 200000;
+			const unsigned int 	queryCount	= 50000;
+			CPoiDatabase 		poiDatabase;
+			CRoute 				route;
+			std::vector<CWaypoint> positions;
+
+			srand(7);
+
+			// POIs and vehicles spread over the area of Germany
+			for (unsigned int index = 0; index < poiCount; ++index)
+			{
+				std::ostringstream name;
+
+				name << "POI" << index;
+				poiDatabase.addPoi(name.str(), CPOI(CPOI::GASSTATION, name.str(), "", 47.0 + 8.0 * rand() / RAND_MAX, 6.0 + 9.0 * rand() / RAND_MAX));
+			}
+
+			for (unsigned int index = 0; index < queryCount; ++index)
+			{
+				positions.push_back(CWaypoint("Vehicle", 47.0 + 8.0 * rand() / RAND_MAX, 6.0 + 9.0 * rand() / RAND_MAX));
+			}
+
+			route.connectToPoiDatabase(&poiDatabase);
+
+			// build the index outside of the measurements
+			poiDatabase.getNearestPoi(50, 8);
+
+			CStopWatch 	stopWatch;
+			CPOI 		poi;
+			double 		checksum = 0;
+
+			for (unsigned int index = 0; index < queryCount; ++index)
+			{
+				checksum += route.getDistanceNextDatabasePoi(positions[index], poi);
+			}
+
+			double loopMs = stopWatch.elapsedMs();
+
+			CPoiDatabase::Poi_Neighbour_Container_t results;
+			const unsigned int ks[] = { 1, 8 };
+
+			std::cout << "=======================================================\n";
+			std::cout << "Batched nearest POI: " << poiCount << " POIs, " << queryCount << " positions\n";
+			std::cout << "  getDistanceNextDatabasePoi loop (k = 1) : " << loopMs << " ms (checksum " << checksum << ")\n";
+
+			for (unsigned int index = 0; index < sizeof(ks) / sizeof(ks[0]); ++index)
+			{
+				stopWatch.restart();
+				route.getDistanceNextPois(&positions[0], queryCount, ks[index], results);
+				double batchMs = stopWatch.elapsedMs();
+
+				checksum = 0;
+
+				for (unsigned int query = 0; query < queryCount; ++query)
+				{
+					checksum += results[query * ks[index]].distance;
+				}
+
+				std::cout << "  getDistanceNextPois batch (k = " << ks[index] << ")       : " << batchMs << " ms (checksum " << checksum << ")\n";
+			}
+			std::cout << "=======================================================\n";
+		}
+};
+
+#endif /* CBATCHNEARESTPOIBENCHMARK_H_ */
@@ -0,0 +1,283 @@
+/*
+ * CContractionHierarchyBenchmark.h
+ */
+
+#ifndef CCONTRACTIONHIERARCHYBENCHMARK_H_
+#define CCONTRACTIONHIERARCHYBENCHMARK_H_
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "CStopWatch.h"
+#include "../myCode/CRoadGraph.h"
+#include "../myCode/CContractionHierarchy.h"
+#include "../myCode/CJsonPersistence.h"
+
+/**
+ * This class compares the contraction hierarchy with Dijkstra and A* on a synthetic street grid,
+ * on a synthetic road network of towns joined by straight roads and on the waypoints of
+ * Database.json connected by a generated street grid around them.
+ */
+class CContractionHierarchyBenchmark {
+public:
+
+	static void run() {
+			std::cout << "=======================================================\n";
+			std::cout << "Contraction hierarchy\n";
+
+			{
+				CRoadGraph graph;
+
+				addGrid(graph, "Crossing", gridSize, 49.0, 8.0, 0.0009, 0.0014);
+				measure("synthetic grid", graph);
+			}
+
+			{
+				CRoadGraph graph;
+
+				addRoadNetwork(graph, "Town", townCount, crossingCount, 49.0, 8.0, 1.0);
+				measure("synthetic road network", graph);
+			}
+
+			{
+				CRoadGraph 			graph;
+				CWpDatabase 		wpDatabase;
+				CPoiDatabase 		poiDatabase;
+				CJsonPersistence 	jsonFormat;
+
+				jsonFormat.setMediaName("Database.json");
+
+				if (jsonFormat.readData(wpDatabase, poiDatabase, CJsonPersistence::REPLACE))
+				{
+					// a street every ~70 m around the waypoints of the database
+					const double minLatitude = 49.80, minLongitude = 8.60, step = 0.0007;
+
+					graph.addNodes(wpDatabase);
+					addGrid(graph, "Street", sampleGridSize, minLatitude, minLongitude, step, step);
+
+					for (CWpDatabase::Wp_ConstItr_t itr = wpDatabase.begin(); itr != wpDatabase.end(); ++itr)
+					{
+						unsigned int row 	= (unsigned int)floor((itr->second.getLatitude() - minLatitude) / step + 0.5);
+						unsigned int column = (unsigned int)floor((itr->second.getLongitude() - minLongitude) / step + 0.5);
+
+						graph.addEdge(itr->first, name("Street", row, column));
+					}
+
+					measure("Database.json + generated streets", graph);
+				}
+			}
+
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	static const unsigned int gridSize			= 150;
+	static const unsigned int townCount			= 60;
+	static const unsigned int crossingCount		= 25000;
+	static const unsigned int sampleGridSize	= 120;
+	static const unsigned int queries			= 200;
+
+	static std::string name(char const *prefix, unsigned int row, unsigned int column) {
+			std::ostringstream stream;
+
+			stream << prefix << " " << row << "/" << column;
+
+			return stream.str();
+		}
+
+	/**
+	 * Streets between the crossings of a grid, up to 50% longer than the straight line
+	 */
+	static void addGrid(CRoadGraph &graph, char const *prefix, unsigned int size, double latitude, double longitude, double latitudeStep, double longitudeStep) {
+			srand(17);
+
+			for (unsigned int row = 0; row < size; ++row)
+			{
+				for (unsigned int column = 0; column < size; ++column)
+				{
+					graph.addNode(name(prefix, row, column), latitude + latitudeStep * row, longitude + longitudeStep * column);
+				}
+			}
+
+			for (unsigned int row = 0; row < size; ++row)
+			{
+				for (unsigned int column = 0; column < size; ++column)
+				{
+					if (column + 1 < size)
+					{
+						graph.addEdge(name(prefix, row, column), name(prefix, row, column + 1), false, 0.1 * (1.0 + 0.5 * rand() / RAND_MAX));
+					}
+
+					if (row + 1 < size)
+					{
+						graph.addEdge(name(prefix, row, column), name(prefix, row + 1, column), false, 0.1 * (1.0 + 0.5 * rand() / RAND_MAX));
+					}
+				}
+			}
+		}
+
+	/**
+	 * Towns of very different size at random places: the streets of a town join every crossing
+	 * to its nearest crossings and are up to 50% longer than the straight line, the centre of
+	 * every town has a straight road to the centres of the nearest towns
+	 */
+	static void addRoadNetwork(CRoadGraph &graph, char const *prefix, unsigned int towns, unsigned int crossings, double latitude, double longitude, double size) {
+			std::vector<CWaypoint> 					centres;
+			std::vector<std::vector<CWaypoint> > 	townCrossings(towns);
+			double 									share = 0;
+
+			srand(19);
+
+			for (unsigned int town = 0; town < towns; ++town)
+			{
+				centres.push_back(CWaypoint(name(prefix, town, 0), latitude + size * rand() / RAND_MAX, longitude + 1.5 * size * rand() / RAND_MAX));
+				share += 1.0 / (town + 1);
+			}
+
+			// the size of the towns falls like 1, 1/2, 1/3, ...; a town spreads with its size
+			for (unsigned int town = 0; town < towns; ++town)
+			{
+				unsigned int 	count 	= (unsigned int)(crossings / share / (town + 1)) + 1;
+				double 			radius 	= 0.15 * size * sqrt((double)count / crossings);
+
+				townCrossings[town].push_back(centres[town]);
+
+				for (unsigned int crossing = 1; crossing < count; ++crossing)
+				{
+					double latitudeOffset 	= radius * ((double)rand() / RAND_MAX + (double)rand() / RAND_MAX - 1);
+					double longitudeOffset 	= 1.5 * radius * ((double)rand() / RAND_MAX + (double)rand() / RAND_MAX - 1);
+
+					townCrossings[town].push_back(CWaypoint(name(prefix, town, crossing),
+							centres[town].getLatitude() + latitudeOffset, centres[town].getLongitude() + longitudeOffset));
+				}
+
+				for (unsigned int crossing = 0; crossing < count; ++crossing)
+				{
+					CWaypoint const &wp = townCrossings[town][crossing];
+
+					graph.addNode(wp.getPooledName(), wp.getLatitude(), wp.getLongitude());
+				}
+
+				for (unsigned int crossing = 0; crossing < count; ++crossing)
+				{
+					std::vector<std::pair<double, unsigned int> > nearest;
+
+					for (unsigned int other = 0; other < count; ++other)
+					{
+						if (other != crossing)
+						{
+							nearest.push_back(std::make_pair(townCrossings[town][crossing].calculateDistance(townCrossings[town][other]), other));
+						}
+					}
+
+					unsigned int streets = std::min(3u, (unsigned int)nearest.size());
+
+					std::partial_sort(nearest.begin(), nearest.begin() + streets, nearest.end());
+
+					for (unsigned int street = 0; street < streets; ++street)
+					{
+						graph.addEdge(townCrossings[town][crossing].getPooledName(), townCrossings[town][nearest[street].second].getPooledName(),
+								false, nearest[street].first * (1.0 + 0.5 * rand() / RAND_MAX));
+					}
+				}
+			}
+
+			for (unsigned int town = 0; town < towns; ++town)
+			{
+				std::vector<std::pair<double, unsigned int> > nearest;
+
+				for (unsigned int other = 0; other < towns; ++other)
+				{
+					if (other != town)
+					{
+						nearest.push_back(std::make_pair(centres[town].calculateDistance(centres[other]), other));
+					}
+				}
+
+				std::partial_sort(nearest.begin(), nearest.begin() + 3, nearest.end());
+
+				for (unsigned int road = 0; road < 3; ++road)
+				{
+					graph.addEdge(centres[town].getPooledName(), centres[nearest[road].second].getPooledName());
+				}
+			}
+		}
+
+	static void measure(char const *graphName, CRoadGraph &graph) {
+			CContractionHierarchy 	hierarchy, loaded;
+			CStopWatch 				stopWatch;
+			const char 				*fileName = "Benchmark-hierarchy.ch";
+
+			graph.build();
+			hierarchy.build(graph);
+
+			double buildMs = stopWatch.elapsedMs();
+
+			stopWatch.restart();
+			hierarchy.writeToFile(fileName);
+
+			double writeMs = stopWatch.elapsedMs();
+
+			stopWatch.restart();
+			loaded.readFromFile(fileName);
+
+			double readMs = stopWatch.elapsedMs();
+			std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+
+			std::cout << "  " << graphName << ": " << graph.getNodeCount() << " nodes, " << graph.getEdgeCount() << " edges\n";
+			std::cout << "    preprocessing " << buildMs << " ms, " << hierarchy.getShortcutCount() << " shortcuts, file "
+					  << (file.tellg() / 1024) << " KB written in " << writeMs << " ms, read in " << readMs << " ms\n";
+
+			file.close();
+			std::remove(fileName);
+
+			CRoadGraph::Path_t 	path;
+			double 				length, checksum[3] = { 0, 0, 0 }, settled[3] = { 0, 0, 0 }, ms[3];
+
+			for (unsigned int search = 0; search < 3; ++search)
+			{
+				srand(23);
+				stopWatch.restart();
+
+				for (unsigned int query = 0; query < queries; ++query)
+				{
+					CRoadGraph::Node_t source = rand() % graph.getNodeCount();
+					CRoadGraph::Node_t target = rand() % graph.getNodeCount();
+					bool isFound;
+
+					if (search == 2)
+					{
+						isFound = loaded.findPath(source, target, path, length);
+						settled[search] += loaded.getSettledCount();
+					}
+					else
+					{
+						isFound = graph.findPath(source, target, path, length, (search == 0) ? CRoadGraph::DIJKSTRA : CRoadGraph::ASTAR);
+						settled[search] += graph.getSettledCount();
+					}
+
+					checksum[search] += isFound ? length : 0;
+				}
+
+				ms[search] = stopWatch.elapsedMs() / queries;
+			}
+
+			const char *searchNames[] = { "Dijkstra", "A*      ", "CH      " };
+
+			for (unsigned int search = 0; search < 3; ++search)
+			{
+				std::cout << "    " << searchNames[search] << " : " << (ms[search] * 1000) << " us per query, "
+						  << (settled[search] / queries) << " settled nodes per query, speed-up "
+						  << (ms[0] / ms[search]) << " (checksum " << checksum[search] << ")\n";
+			}
+		}
+};
+
+#endif /* CCONTRACTIONHIERARCHYBENCHMARK_H_ */
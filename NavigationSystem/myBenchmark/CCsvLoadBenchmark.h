@@ -0,0 +1,95 @@
+/*
+ * CCsvLoadBenchmark.h
+ */
+
+#ifndef CCSVLOADBENCHMARK_H_
+#define CCSVLOADBENCHMARK_H_
+
+#include <iostream>
+#include <cstdio>
+#include <algorithm>
+#include <thread>
+
+#include "CStopWatch.h"
+#include "CRandomDatabase.h"
+#include "../myCode/CCSV.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class measures the time to read the CSV files of databases of several sizes
+ * with 1, 2, 4 and 8 threads, and up to the number of cores if there are more.
+ * With more threads than cores the chunks take turns on the cores: those rows show
+ * the cost of the split and of the shared string pool, not a speed-up.
+ */
+class CCsvLoadBenchmark {
+public:
+
+	static void run() {
+			unsigned int 	cores 		= std::max(1u, std::thread::hardware_concurrency());
+			unsigned int 	maxThreads 	= std::max(minThreads, cores);
+
+			std::cout << "=======================================================\n";
+			std::cout << "CSV load: " << cores << " cores\n";
+
+			for (unsigned int scale = 1; scale <= maxScale; scale *= 2)
+			{
+				runSize(wpCount * scale, poiCount * scale, maxThreads);
+			}
+
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	/**
+	 * Write the CSV files of a database of the given size and read them with 1, 2, 4, ... threads
+	 */
+	static void runSize(unsigned int wps, unsigned int pois, unsigned int maxThreads) {
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 	*pPOIDatabase 	= new CPoiDatabase;
+			CCSV 			csv;
+
+			CRandomDatabase::fillWaypoints(pWpDatabase, wps, 31);
+			CRandomDatabase::fillPois(pPOIDatabase, pois, 32);
+
+			csv.setMediaName("CsvLoadBenchmark");
+			csv.writeData(*pWpDatabase, *pPOIDatabase);
+
+			std::cout << "  " << wps << " waypoints, " << pois << " POIs\n";
+
+			// the files are split into one chunk per thread
+			for (unsigned int threads = 1; threads <= maxThreads; threads *= 2)
+			{
+				pWpDatabase->resetWpsDatabase();
+				pPOIDatabase->resetPoisDatabase();
+				csv.setThreadCount(threads);
+
+				CStopWatch 	stopWatch;
+
+				csv.readData(*pWpDatabase, *pPOIDatabase, CCSV::REPLACE);
+
+				double 		elapsed = stopWatch.elapsedMs();
+
+				std::cout << "    read, " << threads << " threads  : " << elapsed << " ms, " << elapsed * 1000000 / (wps + pois) << " ns per line, "
+						  << pWpDatabase->getElementCount() + pPOIDatabase->getElementCount() << " elements\n";
+			}
+
+			std::remove("CsvLoadBenchmark-wp.txt");
+			std::remove("CsvLoadBenchmark-poi.txt");
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+	/**
+	 * The smallest database and its scales 1, 2, 4, ... maxScale; the thread counts up to minThreads
+	 * are measured on any machine
+	 */
+	static const unsigned int wpCount 		= 100000;
+	static const unsigned int poiCount 		= 500000;
+	static const unsigned int maxScale 		= 4;
+	static const unsigned int minThreads 	= 8;
+};
+
+#endif /* CCSVLOADBENCHMARK_H_ */
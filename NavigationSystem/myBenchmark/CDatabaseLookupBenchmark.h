@@ -0,0 +1,105 @@
+/*
+ * CDatabaseLookupBenchmark.h
+ */
+
+#ifndef CDATABASELOOKUPBENCHMARK_H_
+#define CDATABASELOOKUPBENCHMARK_H_
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+#include "CStopWatch.h"
+#include "../myCode/CPOI.h"
+#include "../myCode/CDatabase.h"
+
+/**
+ * This class compares the lookups by name (as done by CRoute::addWaypoint and addPoi)
+ * of the storage policies of the CDatabase.
+ */
+class CDatabaseLookupBenchmark {
+public:
+
+	static void run() {
+			std::vector<std::string> names, queries;
+
+			srand(23);
+
+			for (unsigned int index = 0; index < elementCount; ++index)
+			{
+				std::ostringstream name;
+
+				name << "Point of interest " << rand() << "/" << index;
+				names.push_back(name.str());
+			}
+
+			// 90% of the queries find an element
+			for (unsigned int index = 0; index < queryCount; ++index)
+			{
+				if (rand() % 10)
+				{
+					queries.push_back(names[rand() % elementCount]);
+				}
+				else
+				{
+					queries.push_back(names[rand() % elementCount] + "?");
+				}
+			}
+
+			std::cout << "=======================================================\n";
+			std::cout << "Database lookup by name: " << elementCount << " POIs, " << queryCount << " lookups\n";
+
+			measure<CMapStorage<std::string, CPOI> >("map (NAME_ORDER)     ", names, queries);
+			measure<CMortonStorage<std::string, CPOI> >("Morton (MORTON_ORDER)", names, queries);
+			measure<CHashStorage<std::string, CPOI> >("hash (HASH_TABLE)    ", names, queries);
+
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	static const unsigned int elementCount	= 500000;
+	static const unsigned int queryCount	= 2000000;
+
+	template<class TStorage>
+	static void measure(char const *label, std::vector<std::string> const &names, std::vector<std::string> const &queries) {
+			CDatabase<std::string, CPOI, TStorage> 	*pDatabase 	= new CDatabase<std::string, CPOI, TStorage>;
+			CStopWatch 								stopWatch;
+
+			for (unsigned int index = 0; index < names.size(); ++index)
+			{
+				pDatabase->addElement(names[index], CPOI(CPOI::RESTAURANT, names[index], "", -80.0 + 0.1 * (index % 1600), -180.0 + 0.1 * (index / 1600)));
+			}
+
+			// the first lookup merges the added elements of the Morton storage
+			pDatabase->getPointerToElement(names[0]);
+
+			double 			addMs 		= stopWatch.elapsedMs();
+			unsigned int 	found 		= 0;
+			double 			checksum 	= 0;
+
+			stopWatch.restart();
+
+			for (unsigned int index = 0; index < queries.size(); ++index)
+			{
+				CPOI *pPoi = pDatabase->getPointerToElement(queries[index]);
+
+				if (pPoi)
+				{
+					found++;
+					checksum += pPoi->getLatitude();
+				}
+			}
+
+			double lookupMs = stopWatch.elapsedMs();
+
+			std::cout << "  " << label << " : add " << addMs << " ms, " << (lookupMs * 1000000 / queries.size()) << " ns per lookup"
+					  << " (" << found << " found, checksum " << checksum << ")\n";
+
+			delete pDatabase;
+		}
+};
+
+#endif /* CDATABASELOOKUPBENCHMARK_H_ */
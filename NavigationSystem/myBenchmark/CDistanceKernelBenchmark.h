@@ -0,0 +1,99 @@
+/*
+ * CDistanceKernelBenchmark.h
+ */
+
+#ifndef CDISTANCEKERNELBENCHMARK_H_
+#define CDISTANCEKERNELBENCHMARK_H_
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "CStopWatch.h"
+#include "../myCode/CWaypoint.h"
+#include "../myCode/CDistanceKernel.h"
+
+/**
+ * This class compares the implementations of the distance kernel with a loop over CWaypoint::calculateDistance.
+ */
+class CDistanceKernelBenchmark {
+public:
+
+	static void run() {
+			const unsigned int 	positionCount	= 1000000;
+			const unsigned int 	rounds			= 10;
+			const char 			*names[]		= { "scalar", "SSE2  ", "AVX2  " };
+			std::vector<double> latitudes, longitudes, distances(positionCount);
+			std::vector<CWaypoint> waypoints;
+			CWaypoint 			origin("Darmstadt", 49.8728, 8.6512);
+
+			srand(11);
+
+			for (unsigned int index = 0; index < positionCount; ++index)
+			{
+				latitudes.push_back(47.0 + 8.0 * rand() / RAND_MAX);
+				longitudes.push_back(6.0 + 9.0 * rand() / RAND_MAX);
+				waypoints.push_back(CWaypoint("Position", latitudes.back(), longitudes.back()));
+			}
+
+			std::cout << "=======================================================\n";
+			std::cout << "Distance kernel: " << positionCount << " positions x " << rounds << " rounds\n";
+
+			CStopWatch 	stopWatch;
+			double 		checksum = 0;
+
+			for (unsigned int round = 0; round < rounds; ++round)
+			{
+				for (unsigned int index = 0; index < positionCount; ++index)
+				{
+					checksum += origin.calculateDistance(waypoints[index]);
+				}
+			}
+
+			report("calculateDistance loop     ", stopWatch.elapsedMs(), positionCount * rounds, checksum);
+
+			CDistanceKernel::t_implementation selected = CDistanceKernel::getImplementation();
+
+			for (unsigned int implementation = CDistanceKernel::SCALAR; implementation <= CDistanceKernel::AVX2; ++implementation)
+			{
+				if (!CDistanceKernel::setImplementation((CDistanceKernel::t_implementation)implementation))
+				{
+					std::cout << "  " << names[implementation] << " haversine           : not supported\n";
+					continue;
+				}
+
+				stopWatch.restart();
+				checksum = 0;
+
+				for (unsigned int round = 0; round < rounds; ++round)
+				{
+					CDistanceKernel::haversine(origin.getLatitude(), origin.getLongitude(), &latitudes[0], &longitudes[0], positionCount, &distances[0]);
+					checksum += distances[round];
+				}
+
+				report(std::string(names[implementation]) + " haversine          ", stopWatch.elapsedMs(), positionCount * rounds, checksum);
+
+				stopWatch.restart();
+				checksum = 0;
+
+				for (unsigned int round = 0; round < rounds; ++round)
+				{
+					checksum += CDistanceKernel::nearest(origin.getLatitude(), origin.getLongitude(), &latitudes[0], &longitudes[0], positionCount);
+				}
+
+				report(std::string(names[implementation]) + " nearest            ", stopWatch.elapsedMs(), positionCount * rounds, checksum);
+			}
+
+			CDistanceKernel::setImplementation(selected);
+
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	static void report(std::string const &name, double ms, double count, double checksum) {
+			std::cout << "  " << name << " : " << ms << " ms, " << (count / ms / 1000) << " M distances/s (checksum " << checksum << ")\n";
+		}
+};
+
+#endif /* CDISTANCEKERNELBENCHMARK_H_ */
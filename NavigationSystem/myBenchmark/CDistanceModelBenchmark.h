@@ -0,0 +1,93 @@
+/*
+ * CDistanceModelBenchmark.h
+ */
+
+#ifndef CDISTANCEMODELBENCHMARK_H_
+#define CDISTANCEMODELBENCHMARK_H_
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+
+#include "CStopWatch.h"
+#include "../myCode/CWaypoint.h"
+
+/**
+ * This class compares the cost and the error of the distance models of CWaypoint,
+ * VINCENTY being the reference, on short local pairs and on pairs all over the world.
+ */
+class CDistanceModelBenchmark {
+public:
+
+	static void run() {
+			std::vector<CWaypoint> local, global;
+
+			srand(13);
+
+			for (unsigned int index = 0; index < pairCount; ++index)
+			{
+				// pairs in the Darmstadt area, up to ~50 km apart
+				local.push_back(CWaypoint("Position", 49.6 + 0.5 * rand() / RAND_MAX, 8.4 + 0.7 * rand() / RAND_MAX));
+				global.push_back(CWaypoint("Position", -89 + 178.0 * rand() / RAND_MAX, -180 + 360.0 * rand() / RAND_MAX));
+			}
+
+			std::cout << "=======================================================\n";
+			std::cout << "Distance models: " << pairCount << " pairs x " << rounds << " rounds\n";
+
+			measure("Darmstadt area", local);
+			measure("world         ", global);
+
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	static const unsigned int pairCount	= 100000;
+	static const unsigned int rounds	= 10;
+
+	static void measure(std::string const &name, std::vector<CWaypoint> &positions) {
+			const CWaypoint::t_distance_model models[] 	= { CWaypoint::VINCENTY, CWaypoint::HAVERSINE, CWaypoint::EQUIRECTANGULAR };
+			const char *modelNames[] 					= { "vincenty       ", "haversine      ", "equirectangular" };
+			std::vector<double> reference(positions.size() / 2);
+
+			for (unsigned int index = 0; index < reference.size(); ++index)
+			{
+				reference[index] = positions[2 * index].calculateDistance(positions[2 * index + 1], CWaypoint::VINCENTY);
+			}
+
+			for (unsigned int model = 0; model < sizeof(models) / sizeof(models[0]); ++model)
+			{
+				CStopWatch 	stopWatch;
+				double 		checksum = 0;
+
+				for (unsigned int round = 0; round < rounds; ++round)
+				{
+					for (unsigned int index = 0; index < reference.size(); ++index)
+					{
+						checksum += positions[2 * index].calculateDistance(positions[2 * index + 1], models[model]);
+					}
+				}
+
+				double ms = stopWatch.elapsedMs();
+				double maxError = 0;
+
+				for (unsigned int index = 0; index < reference.size(); ++index)
+				{
+					double distance = positions[2 * index].calculateDistance(positions[2 * index + 1], models[model]);
+
+					if (reference[index] > 0)
+					{
+						maxError = std::max(maxError, std::fabs(distance - reference[index]) / reference[index]);
+					}
+				}
+
+				std::cout << "  " << name << " " << modelNames[model] << " : " << ms << " ms, "
+						  << (reference.size() * rounds / ms / 1000) << " M distances/s, max error "
+						  << (maxError * 100) << " % (checksum " << checksum << ")\n";
+			}
+		}
+};
+
+#endif /* CDISTANCEMODELBENCHMARK_H_ */
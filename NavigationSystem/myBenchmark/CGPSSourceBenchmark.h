@@ -0,0 +1,155 @@
+/*
+ * CGPSSourceBenchmark.h
+ */
+
+#ifndef CGPSSOURCEBENCHMARK_H_
+#define CGPSSOURCEBENCHMARK_H_
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <cmath>
+
+#include "CStopWatch.h"
+#include "CRandomDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CGPSSource.h"
+#include "../myCode/CNmeaGPSProvider.h"
+#include "../myCode/CSyntheticGPSProvider.h"
+#include "../myCode/CNearestPoiTracker.h"
+
+/**
+ * This class measures the rate of the fixes passed from a provider thread
+ * through the ring buffer to the navigation loop, without and with the
+ * nearest POI tracker in the loop.
+ */
+class CGPSSourceBenchmark {
+public:
+
+	static void run() {
+			std::cout << "=======================================================\n";
+			std::cout << "GPS source: " << fixCount << " fixes\n";
+
+			double 					rate;
+
+			CSyntheticGPSProvider 	synthetic(49.866851, 8.634864, fixCount);
+			unsigned int 			count = drain(synthetic, 0, rate);
+
+			std::cout << "  synthetic       : " << rate << " fixes per s (" << count << ")\n";
+
+			// a log of 10 Hz GGA and RMC sentences
+			const char 		*fileName 	= "GPSSourceBenchmark.nmea";
+			std::ofstream 	log(fileName);
+			CGPSFix 		fix;
+
+			synthetic.open();
+
+			while (synthetic.readFix(fix))
+			{
+				log << sentence("GPGGA", fix, ",1,08,0.9,145.0,M,47.9,M,,") << "\n";
+				log << sentence("GPRMC", fix, ",0.0,0.0,010120,,,A") << "\n";
+			}
+
+			log.close();
+
+			CNmeaGPSProvider 		nmea(fileName);
+
+			count = drain(nmea, 0, rate);
+			std::remove(fileName);
+
+			std::cout << "  NMEA replay     : " << rate << " fixes per s (" << count << ")\n";
+
+			CPoiDatabase 			*pPOIDatabase = new CPoiDatabase;
+
+			// restaurants only
+			CRandomDatabase::fillPois(pPOIDatabase, poiCount, 29, 1, 49.0, 51.0, 7.5, 9.5);
+
+			pPOIDatabase->buildSpatialIndex();
+
+			CNearestPoiTracker 		tracker(pPOIDatabase);
+
+			count = drain(synthetic, &tracker, rate);
+
+			std::cout << "  with tracker    : " << rate << " fixes per s (" << count << "), "
+					  << tracker.getQueryCount() << " index queries\n";
+			std::cout << "=======================================================\n";
+
+			delete pPOIDatabase;
+		}
+
+private:
+
+	static const unsigned int fixCount 	= 1000000;
+	static const unsigned int poiCount 	= 50000;
+
+	/**
+	 * Take all the fixes of a provider through a source, optionally tracking the nearest POI;
+	 * the rate is in fixes per second
+	 */
+	static unsigned int drain(CGPSProvider &provider, CNearestPoiTracker *pTracker, double &rate) {
+			CGPSSource 		source(&provider);
+			CGPSFix 		fix;
+			unsigned int 	count 	= 0;
+			double 			distance;
+			CStopWatch 		stopWatch;
+
+			source.start();
+
+			while (!source.isFinished())
+			{
+				if (!source.poll(fix))
+				{
+					std::this_thread::yield();
+					continue;
+				}
+
+				if (pTracker)
+				{
+					pTracker->update(fix.latitude, fix.longitude, distance);
+				}
+
+				count++;
+			}
+
+			rate = count / (stopWatch.elapsedMs() / 1000);
+
+			return count;
+		}
+
+	/**
+	 * Build a sentence with the time and the position of a fix and its checksum
+	 */
+	static std::string sentence(char const *pType, CGPSFix const &fix, char const *pTail) {
+			char 			text[128];
+			char 			hex[4];
+			unsigned char 	checksum 	= 0;
+			double 			latitude 	= fabs(fix.latitude);
+			double 			longitude 	= fabs(fix.longitude);
+			bool 			isRmc 		= (pType[2] == 'R');
+
+			// 10 Hz: hhmmss.ss, the day wraps around after 864000 fixes
+			double 			seconds 	= fmod(fix.time / 10, 86400);
+			double 			hours 		= floor(seconds / 3600);
+			double 			minutes 	= floor((seconds - hours * 3600) / 60);
+
+			// ddmm.mmmm: the hundreds are the degrees
+			snprintf(text, sizeof(text), "$%s,%09.2f%s,%09.4f,%c,%010.4f,%c%s", pType,
+					hours * 10000 + minutes * 100 + (seconds - hours * 3600 - minutes * 60), isRmc ? ",A" : "",
+					floor(latitude) * 100 + (latitude - floor(latitude)) * 60, (fix.latitude < 0) ? 'S' : 'N',
+					floor(longitude) * 100 + (longitude - floor(longitude)) * 60, (fix.longitude < 0) ? 'W' : 'E',
+					pTail);
+
+			for (char const *pChar = text + 1; *pChar; ++pChar)
+			{
+				checksum ^= (unsigned char)*pChar;
+			}
+
+			snprintf(hex, sizeof(hex), "*%02X", checksum);
+
+			return std::string(text) + hex;
+		}
+};
+
+#endif /* CGPSSOURCEBENCHMARK_H_ */
@@ -0,0 +1,148 @@
+/*
+ * CMappedDatabaseBenchmark.h
+ */
+
+#ifndef CMAPPEDDATABASEBENCHMARK_H_
+#define CMAPPEDDATABASEBENCHMARK_H_
+
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+
+#include "CStopWatch.h"
+#include "CRandomDatabase.h"
+#include "CMemoryUsage.h"
+#include "../myCode/CSnapshot.h"
+#include "../myCode/CMappedDatabase.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class compares the databases loaded from a snapshot with the queries served
+ * directly from the mapped snapshot: startup time, query time and the memory of the
+ * process which is not shared through the page cache.
+ */
+class CMappedDatabaseBenchmark {
+public:
+
+	static void run() {
+			writeSnapshot();
+
+			// the messages of the storages are not part of the measurement
+			std::streambuf 	*pConsole = std::cout.rdbuf(0);
+
+			// mapped: only the header is read at startup, the queries fault in the pages they touch
+			double 			mappedBase 		= CMemoryUsage::privateBytes();
+			CStopWatch 		openWatch;
+			CMappedDatabase *pMapped 		= new CMappedDatabase;
+
+			pMapped->open("MappedDatabaseBenchmark.snapshot");
+
+			double 			openElapsed 	= openWatch.elapsedMs();
+			double 			mappedQuery 	= measureQueries(*pMapped);
+			double 			mappedPrivate 	= CMemoryUsage::privateBytes() - mappedBase;
+			double 			mappedResident 	= CMemoryUsage::residentBytes();
+
+			delete pMapped;
+
+			// heap: the whole snapshot is copied into the databases
+			double 			heapBase 		= CMemoryUsage::privateBytes();
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 	*pPOIDatabase 	= new CPoiDatabase;
+			CSnapshot 		snapshot;
+			CStopWatch 		loadWatch;
+
+			snapshot.setMediaName("MappedDatabaseBenchmark.snapshot");
+			snapshot.readData(*pWpDatabase, *pPOIDatabase, CPersistentStorage::REPLACE);
+
+			double 			loadElapsed 	= loadWatch.elapsedMs();
+			double 			heapQuery 		= measureQueries(*pPOIDatabase);
+			double 			heapPrivate 	= CMemoryUsage::privateBytes() - heapBase;
+
+			std::cout.rdbuf(pConsole);
+			std::cout.clear();
+
+			std::cout << "=======================================================\n";
+			std::cout << "Mapped database: " << wpCount << " waypoints, " << poiCount << " POIs, " << queryCount << " nearest POI queries\n";
+			std::cout << "  startup  snapshot load : " << loadElapsed << " ms\n";
+			std::cout << "  startup  mapped open   : " << openElapsed << " ms\n";
+			std::cout << "  query    heap          : " << heapQuery * 1000000 / queryCount << " ns per query\n";
+			std::cout << "  query    mapped        : " << mappedQuery * 1000000 / queryCount << " ns per query\n";
+			std::cout << "  private  heap          : " << heapPrivate / (1024 * 1024) << " MB\n";
+			std::cout << "  private  mapped        : " << mappedPrivate / (1024 * 1024) << " MB (resident with the shared pages "
+					  << mappedResident / (1024 * 1024) << " MB)\n";
+			std::cout << "=======================================================\n";
+
+			std::remove("MappedDatabaseBenchmark.snapshot");
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+private:
+
+	static const unsigned int wpCount 		= 100000;
+	static const unsigned int poiCount 		= 500000;
+	static const unsigned int queryCount 	= 100000;
+
+	/**
+	 * Write the snapshot and give the memory of the databases back to the system
+	 */
+	static void writeSnapshot() {
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 	*pPOIDatabase 	= new CPoiDatabase;
+			CSnapshot 		snapshot;
+
+			CRandomDatabase::fillWaypoints(pWpDatabase, wpCount, 43);
+			CRandomDatabase::fillPois(pPOIDatabase, poiCount, 44);
+
+			std::streambuf 	*pConsole = std::cout.rdbuf(0);
+
+			snapshot.setMediaName("MappedDatabaseBenchmark.snapshot");
+			snapshot.writeData(*pWpDatabase, *pPOIDatabase);
+
+			std::cout.rdbuf(pConsole);
+			std::cout.clear();
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+			malloc_trim(0);
+		}
+
+	/**
+	 * Time of the nearest POI queries at random positions, in ms
+	 */
+	template<class TDatabase>
+	static double measureQueries(TDatabase &database) {
+			unsigned long 	checksum = 0;
+			CStopWatch 		stopWatch;
+
+			srand(47);
+
+			for (unsigned int query = 0; query < queryCount; ++query)
+			{
+				checksum += (unsigned long)nearestPoi(database, -80.0 + 160.0 * rand() / RAND_MAX, -180.0 + 360.0 * rand() / RAND_MAX);
+			}
+
+			double elapsed = stopWatch.elapsedMs();
+
+			// keeps the queries from being optimized away
+			if (!checksum)
+			{
+				std::cout << "";
+			}
+
+			return elapsed;
+		}
+
+	static CPOI const* nearestPoi(CPoiDatabase &database, double latitude, double longitude) {
+			return database.getNearestPoi(latitude, longitude);
+		}
+
+	static CMappedDatabase::Row_t nearestPoi(CMappedDatabase const &database, double latitude, double longitude) {
+			return database.getNearestPoi(latitude, longitude);
+		}
+};
+
+#endif /* CMAPPEDDATABASEBENCHMARK_H_ */
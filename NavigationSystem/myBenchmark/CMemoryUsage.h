@@ -0,0 +1,52 @@
+/*
+ * CMemoryUsage.h
+ */
+
+#ifndef CMEMORYUSAGE_H_
+#define CMEMORYUSAGE_H_
+
+#include <fstream>
+#include <unistd.h>
+
+/**
+ * This class reads the memory used by the benchmark process.
+ */
+class CMemoryUsage {
+public:
+
+	/**
+	 * Resident set of the process in bytes (Linux), 0 if it is not known
+	 */
+	static double residentBytes() {
+			std::ifstream 	statm("/proc/self/statm");
+			double 			totalPages 	= 0;
+			double 			residentPages = 0;
+
+			if (!(statm >> totalPages >> residentPages))
+			{
+				return 0;
+			}
+
+			return residentPages * sysconf(_SC_PAGESIZE);
+		}
+
+	/**
+	 * Resident set of the process without the pages of mapped files, which the page cache
+	 * shares with other processes, in bytes (Linux), 0 if it is not known
+	 */
+	static double privateBytes() {
+			std::ifstream 	statm("/proc/self/statm");
+			double 			totalPages 	= 0;
+			double 			residentPages = 0;
+			double 			sharedPages = 0;
+
+			if (!(statm >> totalPages >> residentPages >> sharedPages))
+			{
+				return 0;
+			}
+
+			return (residentPages - sharedPages) * sysconf(_SC_PAGESIZE);
+		}
+};
+
+#endif /* CMEMORYUSAGE_H_ */
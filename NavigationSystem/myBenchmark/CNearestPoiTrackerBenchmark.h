@@ -0,0 +1,88 @@
+/*
+ * CNearestPoiTrackerBenchmark.h
+ */
+
+#ifndef CNEARESTPOITRACKERBENCHMARK_H_
+#define CNEARESTPOITRACKERBENCHMARK_H_
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "CStopWatch.h"
+#include "CRandomDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CNearestPoiTracker.h"
+
+/**
+ * This class compares a query of the spatial index for every fix of a GPS trace
+ * with the CNearestPoiTracker which re-checks its candidates.
+ */
+class CNearestPoiTrackerBenchmark {
+public:
+
+	static void run() {
+			CPoiDatabase 			*pPOIDatabase = new CPoiDatabase;
+			std::vector<double> 	latitudes, longitudes;
+
+			// restaurants only
+			CRandomDatabase::fillPois(pPOIDatabase, poiCount, 23, 1, 48.0, 52.0, 7.0, 11.0);
+
+			pPOIDatabase->buildSpatialIndex();
+
+			// about 20 m per fix, a car at 70 km/h with one fix per second
+			double latitude = 49.0, longitude = 8.0;
+
+			for (unsigned int fix = 0; fix < fixCount; ++fix)
+			{
+				latitudes.push_back(latitude);
+				longitudes.push_back(longitude);
+				latitude 	+= 0.00012 + 0.00004 * rand() / RAND_MAX;
+				longitude 	+= 0.00012 - 0.00024 * rand() / RAND_MAX;
+			}
+
+			std::cout << "=======================================================\n";
+			std::cout << "Nearest POI along a trace: " << poiCount << " POIs, " << fixCount << " fixes\n";
+
+			CStopWatch 	stopWatch;
+			double 		indexSum = 0;
+
+			for (unsigned int fix = 0; fix < fixCount; ++fix)
+			{
+				indexSum += pPOIDatabase->getNearestPoi(latitudes[fix], longitudes[fix])->getLatitude();
+			}
+
+			std::cout << "  index query     : " << stopWatch.elapsedMs() * 1000 / fixCount << " us per fix\n";
+
+			CNearestPoiTracker 	tracker(pPOIDatabase);
+			double 				trackerSum = 0;
+
+			stopWatch.restart();
+
+			for (unsigned int fix = 0; fix < fixCount; ++fix)
+			{
+				double distance;
+
+				trackerSum += tracker.update(latitudes[fix], longitudes[fix], distance)->getLatitude();
+			}
+
+			std::cout << "  tracker         : " << stopWatch.elapsedMs() * 1000 / fixCount << " us per fix, "
+					  << tracker.getQueryCount() << " index queries\n";
+
+			if (indexSum != trackerSum)
+			{
+				std::cout << "  WARNING: the tracker and the index do not agree\n";
+			}
+
+			std::cout << "=======================================================\n";
+
+			delete pPOIDatabase;
+		}
+
+private:
+
+	static const unsigned int poiCount 	= 200000;
+	static const unsigned int fixCount 	= 20000;
+};
+
+#endif /* CNEARESTPOITRACKERBENCHMARK_H_ */
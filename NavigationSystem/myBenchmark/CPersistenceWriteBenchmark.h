@@ -0,0 +1,101 @@
+/*
+ * CPersistenceWriteBenchmark.h
+ */
+
+#ifndef CPERSISTENCEWRITEBENCHMARK_H_
+#define CPERSISTENCEWRITEBENCHMARK_H_
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+#include "CStopWatch.h"
+#include "CRandomDatabase.h"
+#include "../myCode/CCSV.h"
+#include "../myCode/CJsonPersistence.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class measures the time to write a large database as CSV and as JSON files,
+ * compared to the same CSV lines formatted by an ofstream.
+ */
+class CPersistenceWriteBenchmark {
+public:
+
+	/**
+	 * Writes the POIs like the writer did before, with an ofstream and 10 digits
+	 */
+	struct CStreamPoiWriter
+	{
+		std::ofstream	*pStream;
+
+		void operator()(POI_Database_key_t const &, CPOI const &poi)
+		{
+			*pStream << poi.getPoiTypeName() << "; " << poi.getPooledName() << "; " << poi.getPooledDescription() << "; "
+					 << poi.getLatitude() << "; " << poi.getLongitude() << '\n';
+		}
+	};
+
+	static void run() {
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 	*pPOIDatabase 	= new CPoiDatabase;
+			CCSV 			csv;
+			CJsonPersistence json;
+
+			CRandomDatabase::fillPois(pPOIDatabase, poiCount, 37);
+
+			std::cout << "=======================================================\n";
+			std::cout << "Database write: " << poiCount << " POIs\n";
+
+			{
+				std::ofstream 		stream("PersistenceWriteBenchmark-stream.txt");
+				CStreamPoiWriter 	poiWriter = { &stream };
+				CStopWatch 			stopWatch;
+
+				stream.precision(10);
+				pPOIDatabase->visitPois(poiWriter);
+				stream.close();
+
+				double 				elapsed = stopWatch.elapsedMs();
+
+				std::cout << "  ofstream CSV        : " << elapsed << " ms, " << elapsed * 1000000 / poiCount << " ns per line\n";
+			}
+
+			// the messages of the writers are not part of the measurement
+			std::streambuf 	*pConsole = std::cout.rdbuf(0);
+			CStopWatch 		csvStopWatch;
+
+			csv.setMediaName("PersistenceWriteBenchmark");
+			csv.writeData(*pWpDatabase, *pPOIDatabase);
+
+			double 			csvElapsed = csvStopWatch.elapsedMs();
+			CStopWatch 		jsonStopWatch;
+
+			json.setMediaName("PersistenceWriteBenchmark.json");
+			json.writeData(*pWpDatabase, *pPOIDatabase);
+
+			double 			jsonElapsed = jsonStopWatch.elapsedMs();
+
+			std::cout.rdbuf(pConsole);
+			std::cout.clear();
+
+			std::cout << "  buffered CSV        : " << csvElapsed << " ms, " << csvElapsed * 1000000 / poiCount << " ns per line\n";
+			std::cout << "  buffered JSON       : " << jsonElapsed << " ms, " << jsonElapsed * 1000000 / poiCount << " ns per object\n";
+			std::cout << "=======================================================\n";
+
+			std::remove("PersistenceWriteBenchmark-stream.txt");
+			std::remove("PersistenceWriteBenchmark-wp.txt");
+			std::remove("PersistenceWriteBenchmark-poi.txt");
+			std::remove("PersistenceWriteBenchmark.json");
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+private:
+
+	static const unsigned int poiCount 	= 1000000;
+};
+
+#endif /* CPERSISTENCEWRITEBENCHMARK_H_ */
@@ -0,0 +1,153 @@
+/*
+ * CPoiColumnStoreBenchmark.h
+ */
+
+#ifndef CPOICOLUMNSTOREBENCHMARK_H_
+#define CPOICOLUMNSTOREBENCHMARK_H_
+
+#include <iostream>
+#include <limits>
+
+#include "CStopWatch.h"
+#include "CRandomDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CPoiColumnStore.h"
+#include "../myCode/CDistanceKernel.h"
+
+/**
+ * This class compares full scans over the POIs kept as objects in a CPoiDatabase
+ * and over the columns of a CPoiColumnStore:
+ * - the nearest POI of a type (every row),
+ * - a count of the POIs of a type inside a rectangle.
+ */
+class CPoiColumnStoreBenchmark {
+public:
+
+	static void run() {
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+			CPoiColumnStore	store;
+
+			CRandomDatabase::fillPois(pPOIDatabase, poiCount, 3, CPOI::DEFAULT_POI + 1);
+
+			store.assign(*pPOIDatabase);
+
+			std::cout << "=======================================================\n";
+			std::cout << "Column store: " << poiCount << " POIs, " << queryCount << " full scans each\n";
+			std::cout << "  columns                  : " << (double)store.getMemoryUsage() / poiCount << " bytes per POI\n";
+
+			CStopWatch 	stopWatch;
+			unsigned int	mismatches = 0;
+			CPOI const 		*nearestPois[queryCount];
+
+			for (unsigned int query = 0; query < queryCount; ++query)
+			{
+				NearestOfType nearest = { 49.8728, 8.6512 + query, CPOI::RESTAURANT, 0, std::numeric_limits<double>::max() };
+
+				pPOIDatabase->visitPois(nearest);
+				nearestPois[query] = nearest.pNearest;
+			}
+
+			std::cout << "  nearest of type, objects : " << stopWatch.elapsedMs() / queryCount << " ms per scan\n";
+
+			stopWatch.restart();
+
+			for (unsigned int query = 0; query < queryCount; ++query)
+			{
+				CPoiColumnStore::Row_t row = store.findNearest(49.8728, 8.6512 + query, CPOI::RESTAURANT);
+
+				mismatches += (nearestPois[query]->getPooledName() != store.getName(row));
+			}
+
+			std::cout << "  nearest of type, columns : " << stopWatch.elapsedMs() / queryCount << " ms per scan\n";
+
+			RectangleCount objectCount = { CPOI::GASSTATION, 0 };
+
+			stopWatch.restart();
+
+			for (unsigned int query = 0; query < queryCount; ++query)
+			{
+				pPOIDatabase->visitPois(objectCount);
+			}
+
+			std::cout << "  rectangle, objects       : " << stopWatch.elapsedMs() / queryCount << " ms per scan\n";
+
+			RowCount columnCount = { 0 };
+
+			stopWatch.restart();
+
+			for (unsigned int query = 0; query < queryCount; ++query)
+			{
+				store.visitRectangle(40, 60, -10, 30, CPOI::GASSTATION, columnCount);
+			}
+
+			std::cout << "  rectangle, columns       : " << stopWatch.elapsedMs() / queryCount << " ms per scan\n";
+
+			if ((mismatches != 0) || (objectCount.count != columnCount.count))
+			{
+				std::cout << "  WARNING: the scans do not agree\n";
+			}
+
+			std::cout << "=======================================================\n";
+
+			delete pPOIDatabase;
+		}
+
+private:
+
+	static const unsigned int poiCount 		= 1000000;
+	static const unsigned int queryCount 	= 20;
+
+	/**
+	 * Nearest POI of a type over the objects
+	 */
+	struct NearestOfType {
+		double 			latitude;
+		double 			longitude;
+		CPOI::t_poi 	type;
+		CPOI const 		*pNearest;
+		double 			nearestDistance;
+
+		void operator()(POI_Database_key_t const &, CPOI const &poi) {
+				if (poi.getPoiType() == type)
+				{
+					double poiLatitude 	= poi.getLatitude();
+					double poiLongitude = poi.getLongitude();
+					double distance;
+
+					CDistanceKernel::haversine(latitude, longitude, &poiLatitude, &poiLongitude, 1, &distance);
+
+					if (distance < nearestDistance)
+					{
+						nearestDistance = distance;
+						pNearest 		= &poi;
+					}
+				}
+			}
+	};
+
+	/**
+	 * POIs of a type inside the rectangle 40..60 N, 10 W..30 E over the objects
+	 */
+	struct RectangleCount {
+		CPOI::t_poi 	type;
+		unsigned int 	count;
+
+		void operator()(POI_Database_key_t const &, CPOI const &poi) {
+				if ((poi.getPoiType() == type) && (poi.getLatitude() >= 40) && (poi.getLatitude() <= 60)
+						&& (poi.getLongitude() >= -10) && (poi.getLongitude() <= 30))
+				{
+					count++;
+				}
+			}
+	};
+
+	struct RowCount {
+		unsigned int 	count;
+
+		void operator()(CPoiColumnStore::Row_t) {
+				count++;
+			}
+	};
+};
+
+#endif /* CPOICOLUMNSTOREBENCHMARK_H_ */
@@ -0,0 +1,69 @@
+/*
+ * CRandomDatabase.h
+ */
+
+#ifndef CRANDOMDATABASE_H_
+#define CRANDOMDATABASE_H_
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class fills the databases of the benchmarks with elements at random positions.
+ * The positions cover the world up to the latitudes +-80 by default: half of the
+ * coordinates are negative and need all the digits of a double.
+ */
+class CRandomDatabase {
+public:
+
+	/**
+	 * Fill the database with Waypoints named "Waypoint <index>"
+	 * param@ CWpDatabase *pWpDatabase		-	database to be filled				(IN)
+	 * param@ unsigned int count			-	number of Waypoints					(IN)
+	 * param@ unsigned int seed				-	seed of the positions				(IN)
+	 */
+	static void fillWaypoints(CWpDatabase *pWpDatabase, unsigned int count, unsigned int seed) {
+			srand(seed);
+
+			for (unsigned int index = 0; index < count; ++index)
+			{
+				char 	name[32];
+				double 	latitude 	= -80.0 + 160.0 * rand() / RAND_MAX;
+				double 	longitude 	= -180.0 + 360.0 * rand() / RAND_MAX;
+
+				snprintf(name, sizeof(name), "Waypoint %u", index);
+				pWpDatabase->addWaypoint(name, CWaypoint(name, latitude, longitude));
+			}
+		}
+
+	/**
+	 * Fill the database with POIs named "POI <index>" inside the given area
+	 * param@ CPoiDatabase *pPOIDatabase	-	database to be filled					(IN)
+	 * param@ unsigned int count			-	number of POIs							(IN)
+	 * param@ unsigned int seed				-	seed of the positions					(IN)
+	 * param@ unsigned int typeCount		-	the types 0 to typeCount - 1 take turns	(IN)
+	 * param@ double minLatitude			-	southern border of the positions		(IN)
+	 * param@ double maxLatitude			-	northern border of the positions		(IN)
+	 * param@ double minLongitude			-	western border of the positions			(IN)
+	 * param@ double maxLongitude			-	eastern border of the positions			(IN)
+	 */
+	static void fillPois(CPoiDatabase *pPOIDatabase, unsigned int count, unsigned int seed, unsigned int typeCount = CPOI::DEFAULT_POI,
+			double minLatitude = -80.0, double maxLatitude = 80.0, double minLongitude = -180.0, double maxLongitude = 180.0) {
+			srand(seed);
+
+			for (unsigned int index = 0; index < count; ++index)
+			{
+				char 	name[32];
+				double 	latitude 	= minLatitude + (maxLatitude - minLatitude) * rand() / RAND_MAX;
+				double 	longitude 	= minLongitude + (maxLongitude - minLongitude) * rand() / RAND_MAX;
+
+				snprintf(name, sizeof(name), "POI %u", index);
+				pPOIDatabase->addPoi(name, CPOI((CPOI::t_poi)(index % typeCount), name, "A point of interest", latitude, longitude));
+			}
+		}
+};
+
+#endif /* CRANDOMDATABASE_H_ */
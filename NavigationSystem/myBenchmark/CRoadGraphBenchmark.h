@@ -0,0 +1,107 @@
+/*
+ * CRoadGraphBenchmark.h
+ */
+
+#ifndef CROADGRAPHBENCHMARK_H_
+#define CROADGRAPHBENCHMARK_H_
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+#include "CStopWatch.h"
+#include "../myCode/CRoadGraph.h"
+
+/**
+ * This class measures the shortest path search of the road graph (Dijkstra and A*)
+ * on a grid of streets with random detours, about 100 m between the crossings.
+ */
+class CRoadGraphBenchmark {
+public:
+
+	static void run() {
+			CRoadGraph 	graph;
+			CStopWatch 	stopWatch;
+
+			srand(17);
+
+			for (unsigned int row = 0; row < gridSize; ++row)
+			{
+				for (unsigned int column = 0; column < gridSize; ++column)
+				{
+					graph.addNode(name(row, column), 49.0 + 0.0009 * row, 8.0 + 0.0014 * column);
+				}
+			}
+
+			for (unsigned int row = 0; row < gridSize; ++row)
+			{
+				for (unsigned int column = 0; column < gridSize; ++column)
+				{
+					// streets are up to 50% longer than the straight line between the crossings
+					if (column + 1 < gridSize)
+					{
+						graph.addEdge(name(row, column), name(row, column + 1), false, 0.1 * (1.0 + 0.5 * rand() / RAND_MAX));
+					}
+
+					if (row + 1 < gridSize)
+					{
+						graph.addEdge(name(row, column), name(row + 1, column), false, 0.1 * (1.0 + 0.5 * rand() / RAND_MAX));
+					}
+				}
+			}
+
+			double loadMs = stopWatch.elapsedMs();
+
+			stopWatch.restart();
+			graph.build();
+
+			std::cout << "=======================================================\n";
+			std::cout << "Road graph: " << graph.getNodeCount() << " nodes, " << graph.getEdgeCount() << " edges\n";
+			std::cout << "  load " << loadMs << " ms, CSR build " << stopWatch.elapsedMs() << " ms\n";
+
+			measure(graph, CRoadGraph::DIJKSTRA, "Dijkstra");
+			measure(graph, CRoadGraph::ASTAR, "A*      ");
+
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	static const unsigned int gridSize	= 1000;
+	static const unsigned int queries	= 20;
+
+	static std::string name(unsigned int row, unsigned int column) {
+			std::ostringstream stream;
+
+			stream << "Crossing " << row << "/" << column;
+
+			return stream.str();
+		}
+
+	static void measure(CRoadGraph &graph, CRoadGraph::t_search search, char const *searchName) {
+			CRoadGraph::Path_t 	path;
+			double 				length, checksum = 0, settled = 0;
+
+			srand(23);
+
+			CStopWatch stopWatch;
+
+			for (unsigned int query = 0; query < queries; ++query)
+			{
+				CRoadGraph::Node_t source = rand() % graph.getNodeCount();
+				CRoadGraph::Node_t target = rand() % graph.getNodeCount();
+
+				if (graph.findPath(source, target, path, length, search))
+				{
+					checksum += length;
+				}
+
+				settled += graph.getSettledCount();
+			}
+
+			std::cout << "  " << searchName << " : " << (stopWatch.elapsedMs() / queries) << " ms per query, "
+					  << (settled / queries) << " settled nodes per query (checksum " << checksum << ")\n";
+		}
+};
+
+#endif /* CROADGRAPHBENCHMARK_H_ */
@@ -0,0 +1,113 @@
+/*
+ * CRouteBenchmark.h
+ */
+
+#ifndef CROUTEBENCHMARK_H_
+#define CROUTEBENCHMARK_H_
+
+#include <iostream>
+#include <vector>
+#include <cstdio>
+
+#include "CStopWatch.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CRoute.h"
+
+/**
+ * This class measures the operations of a long CRoute:
+ * appending the waypoints, inserting POIs after named waypoints spread over the route,
+ * reading the route and concatenating it.
+ */
+class CRouteBenchmark {
+public:
+
+	static void run() {
+			CWpDatabase		*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+			std::vector<std::string> names;
+
+			for (unsigned int index = 0; index < hopCount; ++index)
+			{
+				char name[32];
+
+				snprintf(name, sizeof(name), "Waypoint %u", index);
+				names.push_back(name);
+				pWpDatabase->addWaypoint(name, CWaypoint(name, 49.0 + index * 1e-5, 8.0));
+			}
+
+			for (unsigned int index = 0; index < poiCount; ++index)
+			{
+				char name[32];
+
+				snprintf(name, sizeof(name), "POI %u", index);
+				pPOIDatabase->addPoi(name, CPOI(CPOI::RESTAURANT, name, "A restaurant", 49.0 + index * 1e-3, 8.001));
+			}
+
+			CRoute		*pRoute = new CRoute;
+			CStopWatch	stopWatch;
+
+			pRoute->connectToWpDatabase(pWpDatabase);
+			pRoute->connectToPoiDatabase(pPOIDatabase);
+
+			std::cout << "=======================================================\n";
+			std::cout << "Route: " << hopCount << " waypoints, " << poiCount << " POIs inserted after named waypoints\n";
+
+			stopWatch.restart();
+
+			for (unsigned int index = 0; index < hopCount; ++index)
+			{
+				pRoute->addWaypoint(names[index]);
+			}
+
+			std::cout << "  add waypoints   : " << stopWatch.elapsedMs() << " ms\n";
+
+			stopWatch.restart();
+
+			for (unsigned int index = 0; index < poiCount; ++index)
+			{
+				char name[32];
+
+				snprintf(name, sizeof(name), "POI %u", index);
+				pRoute->addPoi(name, names[(index * 7919) % hopCount]);
+			}
+
+			std::cout << "  add POIs        : " << stopWatch.elapsedMs() << " ms\n";
+
+			unsigned int hops = 0;
+
+			stopWatch.restart();
+
+			for (unsigned int round = 0; round < readRounds; ++round)
+			{
+				hops += pRoute->getRoute().size();
+			}
+
+			std::cout << "  get route       : " << stopWatch.elapsedMs() / readRounds << " ms\n";
+
+			stopWatch.restart();
+
+			CRoute sum = *pRoute + *pRoute;
+
+			std::cout << "  concatenate     : " << stopWatch.elapsedMs() << " ms\n";
+
+			if ((hops != readRounds * (hopCount + poiCount)) || (sum.getRoute().size() != 2 * (hopCount + poiCount)))
+			{
+				std::cout << "  WARNING: the route is incomplete\n";
+			}
+
+			std::cout << "=======================================================\n";
+
+			delete pRoute;
+			delete pPOIDatabase;
+			delete pWpDatabase;
+		}
+
+private:
+
+	static const unsigned int hopCount 		= 100000;
+	static const unsigned int poiCount 		= 1000;
+	static const unsigned int readRounds 	= 20;
+};
+
+#endif /* CROUTEBENCHMARK_H_ */
@@ -0,0 +1,90 @@
+/*
+ * CSnapshotLoadBenchmark.h
+ */
+
+#ifndef CSNAPSHOTLOADBENCHMARK_H_
+#define CSNAPSHOTLOADBENCHMARK_H_
+
+#include <iostream>
+#include <cstdio>
+
+#include "CStopWatch.h"
+#include "CRandomDatabase.h"
+#include "../myCode/CCSV.h"
+#include "../myCode/CJsonPersistence.h"
+#include "../myCode/CSnapshot.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class measures the time to read the same databases from the CSV files,
+ * the JSON file and the binary snapshot.
+ */
+class CSnapshotLoadBenchmark {
+public:
+
+	static void run() {
+			CWpDatabase 		*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 		*pPOIDatabase 	= new CPoiDatabase;
+			CCSV 				csv;
+			CJsonPersistence 	json;
+			CSnapshot 			snapshot;
+
+			CRandomDatabase::fillWaypoints(pWpDatabase, wpCount, 41);
+			CRandomDatabase::fillPois(pPOIDatabase, poiCount, 42);
+
+			// the messages of the storages are not part of the measurement
+			std::streambuf 	*pConsole = std::cout.rdbuf(0);
+
+			csv.setMediaName("SnapshotLoadBenchmark");
+			csv.writeData(*pWpDatabase, *pPOIDatabase);
+			json.setMediaName("SnapshotLoadBenchmark.json");
+			json.writeData(*pWpDatabase, *pPOIDatabase);
+			snapshot.setMediaName("SnapshotLoadBenchmark.snapshot");
+			snapshot.writeData(*pWpDatabase, *pPOIDatabase);
+
+			double 			csvElapsed 		= measureRead(csv, *pWpDatabase, *pPOIDatabase);
+			double 			jsonElapsed 	= measureRead(json, *pWpDatabase, *pPOIDatabase);
+			double 			snapshotElapsed = measureRead(snapshot, *pWpDatabase, *pPOIDatabase);
+
+			std::cout.rdbuf(pConsole);
+			std::cout.clear();
+
+			std::cout << "=======================================================\n";
+			std::cout << "Database load: " << wpCount << " waypoints, " << poiCount << " POIs, "
+					  << pWpDatabase->getElementCount() + pPOIDatabase->getElementCount() << " elements read\n";
+			std::cout << "  CSV                 : " << csvElapsed << " ms, " << csvElapsed * 1000000 / (wpCount + poiCount) << " ns per element\n";
+			std::cout << "  JSON                : " << jsonElapsed << " ms, " << jsonElapsed * 1000000 / (wpCount + poiCount) << " ns per element\n";
+			std::cout << "  snapshot            : " << snapshotElapsed << " ms, " << snapshotElapsed * 1000000 / (wpCount + poiCount) << " ns per element\n";
+			std::cout << "=======================================================\n";
+
+			std::remove("SnapshotLoadBenchmark-wp.txt");
+			std::remove("SnapshotLoadBenchmark-poi.txt");
+			std::remove("SnapshotLoadBenchmark.json");
+			std::remove("SnapshotLoadBenchmark.snapshot");
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+private:
+
+	static const unsigned int wpCount 	= 100000;
+	static const unsigned int poiCount 	= 500000;
+
+	/**
+	 * Time of a read into the emptied databases, spatial index included
+	 */
+	static double measureRead(CPersistentStorage &storage, CWpDatabase &wpDatabase, CPoiDatabase &poiDatabase) {
+			wpDatabase.resetWpsDatabase();
+			poiDatabase.resetPoisDatabase();
+
+			CStopWatch 	stopWatch;
+
+			storage.readData(wpDatabase, poiDatabase, CPersistentStorage::REPLACE);
+
+			return stopWatch.elapsedMs();
+		}
+};
+
+#endif /* CSNAPSHOTLOADBENCHMARK_H_ */
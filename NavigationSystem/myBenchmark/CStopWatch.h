@@ -0,0 +1,39 @@
+/*
+ * CStopWatch.h
+ */
+
+#ifndef CSTOPWATCH_H_
+#define CSTOPWATCH_H_
+
+#include <chrono>
+
+/**
+ * This class measures the wall clock time elapsed since its creation or the last restart.
+ */
+class CStopWatch {
+private:
+
+	std::chrono::steady_clock::time_point 	m_start;
+
+public:
+
+	CStopWatch() {
+			this->restart();
+		}
+
+	/**
+	 * Start a new measurement
+	 */
+	void restart() {
+			this->m_start = std::chrono::steady_clock::now();
+		}
+
+	/**
+	 * Elapsed time in milliseconds
+	 */
+	double elapsedMs() const {
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - this->m_start).count();
+		}
+};
+
+#endif /* CSTOPWATCH_H_ */
@@ -0,0 +1,136 @@
+/*
+ * CStringPoolBenchmark.h
+ */
+
+#ifndef CSTRINGPOOLBENCHMARK_H_
+#define CSTRINGPOOLBENCHMARK_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdio>
+
+#include "CStopWatch.h"
+#include "CMemoryUsage.h"
+#include "../myCode/CPOI.h"
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CStringPool.h"
+
+/**
+ * This class compares the memory held by the POIs of a large database when the names and
+ * descriptions are pooled strings with the former layout of one std::string per key, name and description.
+ * Both layouts have the size of a database entry and only differ in the strings, so the build
+ * times compare the interning with the copies of the strings.
+ * The memory is the growth of the resident set of the process (Linux).
+ */
+class CStringPoolBenchmark {
+public:
+
+	static void run() {
+			std::cout << "=======================================================\n";
+			std::cout << "String pool: " << poiCount << " POIs, " << descriptionCount << " different descriptions\n";
+
+			measurePooled();
+			measureStdString();
+
+			std::cout << "=======================================================\n";
+		}
+
+private:
+
+	static const unsigned int poiCount 			= 10000000;
+	static const unsigned int descriptionCount 	= 100;
+
+	/**
+	 * The former layout of a database entry: the key, the name and the description are
+	 * std::string, the other members of the CPOI are the same
+	 */
+	struct CStdStringPoi
+	{
+		std::string		key;
+		std::string		name;
+		std::string		description;
+		char			otherMembers[sizeof(CPOI) - 2 * sizeof(CPooledString)];
+	};
+
+	/**
+	 * A database entry with pooled strings: the key is the name, the other members of the CPOI are the same
+	 */
+	struct CPooledStringPoi
+	{
+		POI_Database_key_t	key;
+		CPooledString		name;
+		CPooledString		description;
+		char				otherMembers[sizeof(CPOI) - 2 * sizeof(CPooledString)];
+	};
+
+	static void makeName(unsigned int index, char *pName, unsigned int size) {
+			snprintf(pName, size, "Point of interest %u", index);
+		}
+
+	static void makeDescription(unsigned int index, char *pDescription, unsigned int size) {
+			snprintf(pDescription, size, "Category %u, opening hours on request", index % descriptionCount);
+		}
+
+	static void report(char const *label, double buildMs, double bytes) {
+			std::cout << "  " << label << " : build " << buildMs << " ms, "
+					  << bytes / (1024 * 1024) << " MB, " << bytes / poiCount << " bytes per POI\n";
+		}
+
+	static void measurePooled() {
+			std::vector<CPooledStringPoi> 	*pPois 	= new std::vector<CPooledStringPoi>;
+			double							before 	= CMemoryUsage::residentBytes();
+			size_t							poolBefore = CStringPool::getInstance().getMemoryUsage();
+			CStopWatch						stopWatch;
+			char							name[64], description[64];
+
+			pPois->resize(poiCount);
+
+			for (unsigned int index = 0; index < poiCount; ++index)
+			{
+				makeName(index, name, sizeof(name));
+				makeDescription(index, description, sizeof(description));
+
+				// the key is the name: the same string of the pool
+				(*pPois)[index].name 		= name;
+				(*pPois)[index].key 		= (*pPois)[index].name;
+				(*pPois)[index].description = description;
+			}
+
+			double buildMs = stopWatch.elapsedMs();
+
+			report("pooled strings      ", buildMs, CMemoryUsage::residentBytes() - before);
+			std::cout << "    of which the pool: " << (CStringPool::getInstance().getMemoryUsage() - poolBefore) / (1024.0 * 1024) << " MB, "
+					  << CStringPool::getInstance().getStringCount() << " strings\n";
+
+			delete pPois;
+		}
+
+	static void measureStdString() {
+			std::vector<CStdStringPoi> 	*pPois 	= new std::vector<CStdStringPoi>;
+			double						before 	= CMemoryUsage::residentBytes();
+			CStopWatch					stopWatch;
+			char						name[64], description[64];
+
+			pPois->resize(poiCount);
+
+			for (unsigned int index = 0; index < poiCount; ++index)
+			{
+				makeName(index, name, sizeof(name));
+				makeDescription(index, description, sizeof(description));
+
+				(*pPois)[index].key 		= name;
+				(*pPois)[index].name 		= name;
+				(*pPois)[index].description = description;
+			}
+
+			double buildMs = stopWatch.elapsedMs();
+
+			report("std::string (before)", buildMs, CMemoryUsage::residentBytes() - before);
+
+			delete pPois;
+		}
+};
+
+#endif /* CSTRINGPOOLBENCHMARK_H_ */
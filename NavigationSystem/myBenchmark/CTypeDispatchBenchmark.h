@@ -0,0 +1,174 @@
+/*
+ * CTypeDispatchBenchmark.h
+ */
+
+#ifndef CTYPEDISPATCHBENCHMARK_H_
+#define CTYPEDISPATCHBENCHMARK_H_
+
+#include <iostream>
+#include <vector>
+#include <cstdio>
+
+#include "CStopWatch.h"
+#include "../myCode/CWaypoint.h"
+#include "../myCode/CPOI.h"
+#include "../myCode/CRoute.h"
+
+/**
+ * This class compares the ways to tell the POIs from the waypoints:
+ * - a dynamic_cast on every element against the type tag (CPOI::castFrom),
+ * - a walk of the route with a dynamic_cast on every hop against the POI stream of the route (CRoute::visitPois).
+ */
+class CTypeDispatchBenchmark {
+public:
+
+	static void run() {
+			std::vector<CWaypoint *> points;
+
+			// every third element is a POI
+			for (unsigned int index = 0; index < elementCount; ++index)
+			{
+				if (index % 3)
+				{
+					points.push_back(new CWaypoint("Waypoint", 49.0 + index * 1e-6, 8.0));
+				}
+				else
+				{
+					points.push_back(new CPOI(CPOI::RESTAURANT, "POI", "A restaurant", 49.0 + index * 1e-6, 8.0));
+				}
+			}
+
+			std::cout << "=======================================================\n";
+			std::cout << "Type dispatch: " << elementCount << " elements, " << rounds << " rounds\n";
+
+			CStopWatch 	stopWatch;
+			double		castSum = 0;
+
+			for (unsigned int round = 0; round < rounds; ++round)
+			{
+				for (unsigned int index = 0; index < points.size(); ++index)
+				{
+					CPOI *pPoi = dynamic_cast<CPOI *>(points[index]);
+
+					if (pPoi)
+					{
+						castSum += pPoi->getLatitude();
+					}
+				}
+			}
+
+			std::cout << "  dynamic_cast    : " << stopWatch.elapsedMs() / rounds << " ms per round\n";
+
+			double tagSum = 0;
+
+			stopWatch.restart();
+
+			for (unsigned int round = 0; round < rounds; ++round)
+			{
+				for (unsigned int index = 0; index < points.size(); ++index)
+				{
+					CPOI *pPoi = CPOI::castFrom(points[index]);
+
+					if (pPoi)
+					{
+						tagSum += pPoi->getLatitude();
+					}
+				}
+			}
+
+			std::cout << "  type tag        : " << stopWatch.elapsedMs() / rounds << " ms per round\n";
+
+			// a route over the same elements
+			CWpDatabase		*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+			CRoute			route;
+
+			route.connectToWpDatabase(pWpDatabase);
+			route.connectToPoiDatabase(pPOIDatabase);
+
+			// a POI follows every second waypoint, it is added after the waypoint before it
+			for (unsigned int index = 1; index <= routeHops; ++index)
+			{
+				char name[32], previousName[32];
+
+				snprintf(name, sizeof(name), "Hop %u", index);
+				snprintf(previousName, sizeof(previousName), "Hop %u", index - 1);
+
+				if (index % 3)
+				{
+					pWpDatabase->addWaypoint(name, CWaypoint(name, 49.0 + index * 1e-6, 8.0));
+					route.addWaypoint(name);
+				}
+				else
+				{
+					pPOIDatabase->addPoi(name, CPOI(CPOI::RESTAURANT, name, "A restaurant", 49.0 + index * 1e-6, 8.0));
+					route.addPoi(name, previousName);
+				}
+			}
+
+			std::cout << "Route: " << routeHops << " hops\n";
+
+			double routeCastSum = 0;
+
+			stopWatch.restart();
+
+			for (unsigned int round = 0; round < rounds; ++round)
+			{
+				std::vector<const CWaypoint*> hops = route.getRoute();
+
+				for (unsigned int index = 0; index < hops.size(); ++index)
+				{
+					CPOI const *pPoi = dynamic_cast<CPOI const *>(hops[index]);
+
+					if (pPoi)
+					{
+						routeCastSum += pPoi->getLatitude();
+					}
+				}
+			}
+
+			std::cout << "  dynamic_cast    : " << stopWatch.elapsedMs() / rounds << " ms per round\n";
+
+			LatitudeSum routeSum = { 0 };
+
+			stopWatch.restart();
+
+			for (unsigned int round = 0; round < rounds; ++round)
+			{
+				route.visitPois(routeSum);
+			}
+
+			std::cout << "  POI stream      : " << stopWatch.elapsedMs() / rounds << " ms per round\n";
+
+			if ((castSum != tagSum) || (routeCastSum != routeSum.sum))
+			{
+				std::cout << "  WARNING: the dispatches do not agree\n";
+			}
+
+			std::cout << "=======================================================\n";
+
+			for (unsigned int index = 0; index < points.size(); ++index)
+			{
+				delete points[index];
+			}
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+private:
+
+	static const unsigned int elementCount 	= 1000000;
+	static const unsigned int routeHops 	= 100000;
+	static const unsigned int rounds 		= 20;
+
+	struct LatitudeSum {
+		double sum;
+
+		void operator()(CPOI &poi) {
+				sum += poi.getLatitude();
+			}
+	};
+};
+
+#endif /* CTYPEDISPATCHBENCHMARK_H_ */
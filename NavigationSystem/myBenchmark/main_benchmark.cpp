@@ -0,0 +1,52 @@
+/*
+ * main_benchmark.cpp
+ */
+
+#include <iostream>
+#include <iomanip>
+
+#include "CBatchNearestPoiBenchmark.h"
+#include "CDistanceKernelBenchmark.h"
+#include "CDistanceModelBenchmark.h"
+#include "CRoadGraphBenchmark.h"
+#include "CContractionHierarchyBenchmark.h"
+#include "CDatabaseLookupBenchmark.h"
+#include "CStringPoolBenchmark.h"
+#include "CArenaBenchmark.h"
+#include "CPoiColumnStoreBenchmark.h"
+#include "CRouteBenchmark.h"
+#include "CTypeDispatchBenchmark.h"
+#include "CNearestPoiTrackerBenchmark.h"
+#include "CGPSSourceBenchmark.h"
+#include "CCsvLoadBenchmark.h"
+#include "CPersistenceWriteBenchmark.h"
+#include "CSnapshotLoadBenchmark.h"
+#include "CMappedDatabaseBenchmark.h"
+
+/**
+ * Benchmarks entry point
+ */
+int main() {
+
+	std::cout << std::fixed << std::setprecision(3);
+
+	CBatchNearestPoiBenchmark::run();
+	CDistanceKernelBenchmark::run();
+	CDistanceModelBenchmark::run();
+	CRoadGraphBenchmark::run();
+	CContractionHierarchyBenchmark::run();
+	CDatabaseLookupBenchmark::run();
+	CStringPoolBenchmark::run();
+	CArenaBenchmark::run();
+	CPoiColumnStoreBenchmark::run();
+	CRouteBenchmark::run();
+	CTypeDispatchBenchmark::run();
+	CNearestPoiTrackerBenchmark::run();
+	CGPSSourceBenchmark::run();
+	CCsvLoadBenchmark::run();
+	CPersistenceWriteBenchmark::run();
+	CSnapshotLoadBenchmark::run();
+	CMappedDatabaseBenchmark::run();
+
+	return 0;
+}
@@ -0,0 +1,256 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CArena.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class types - class CMonotonicArena, class CNodePool
+* 					and class CHeapArena.
+*
+****************************************************************************/
+
+//System Include Files
+#include <new>
+#include <algorithm>
+#include <stdint.h>
+
+//Own Include Files
+#include "CArena.h"
+
+//Namespaces
+using namespace std;
+
+//Method Implementations
+const bool		CMonotonicArena::CAN_RELEASE_ALL;
+const size_t	CMonotonicArena::FIRST_BLOCK_SIZE;
+const size_t	CMonotonicArena::MAX_BLOCK_SIZE;
+const bool		CNodePool::CAN_RELEASE_ALL;
+const bool		CHeapArena::CAN_RELEASE_ALL;
+
+
+/**
+ * CMonotonicArena constructor: no memory is taken before the first allocation
+ */
+CMonotonicArena::CMonotonicArena()
+{
+	this->m_pFree 			= 0;
+	this->m_freeLength 		= 0;
+	this->m_nextBlockSize 	= FIRST_BLOCK_SIZE;
+	this->m_reservedBytes 	= 0;
+}
+
+
+/**
+ * CMonotonicArena destructor: frees all the blocks
+ */
+CMonotonicArena::~CMonotonicArena()
+{
+	this->release();
+}
+
+
+/**
+ * Take memory from the current block, a new block is started if it is too small.
+ * The blocks double in size up to MAX_BLOCK_SIZE.
+ * param@ size_t bytes				-	size of the memory		(IN)
+ * param@ size_t alignment			-	alignment, a power of 2	(IN)
+ * returnvalue@ void*				-	the memory
+ */
+void* CMonotonicArena::allocate(size_t bytes, size_t alignment)
+{
+	size_t padding = (alignment - ((uintptr_t)this->m_pFree & (alignment - 1))) & (alignment - 1);
+
+	if (!this->m_pFree || (padding + bytes > this->m_freeLength))
+	{
+		// the rest of the current block is given up
+		size_t size = max(this->m_nextBlockSize, bytes + alignment);
+
+		this->m_pFree 			= static_cast<char *>(::operator new(size));
+		this->m_freeLength 		= size;
+		this->m_reservedBytes 	+= size;
+		this->m_nextBlockSize 	= min(this->m_nextBlockSize * 2, MAX_BLOCK_SIZE);
+		this->m_blocks.push_back(this->m_pFree);
+
+		padding = (alignment - ((uintptr_t)this->m_pFree & (alignment - 1))) & (alignment - 1);
+	}
+
+	void *pMemory = this->m_pFree + padding;
+
+	this->m_pFree 		+= padding + bytes;
+	this->m_freeLength 	-= padding + bytes;
+
+	return pMemory;
+}
+
+
+/**
+ * Single elements are not freed: the memory is kept until release()
+ * param@ void *pMemory				-	memory from allocate()	(IN)
+ * param@ size_t bytes				-	size of the memory		(IN)
+ * param@ size_t alignment			-	alignment of the memory	(IN)
+ * returnvalue@ void
+ */
+void CMonotonicArena::deallocate(void *, size_t, size_t)
+{
+	// do nothing
+}
+
+
+/**
+ * Free all the blocks; the cost depends on the number of blocks, not of elements
+ * returnvalue@ void
+ */
+void CMonotonicArena::release()
+{
+	for (unsigned int index = 0; index < this->m_blocks.size(); ++index)
+	{
+		::operator delete(this->m_blocks[index]);
+	}
+
+	vector<char *>().swap(this->m_blocks);
+
+	this->m_pFree 			= 0;
+	this->m_freeLength 		= 0;
+	this->m_nextBlockSize 	= FIRST_BLOCK_SIZE;
+	this->m_reservedBytes 	= 0;
+}
+
+
+/**
+ * Get the memory of all the blocks
+ * returnvalue@ size_t				-	bytes
+ */
+size_t CMonotonicArena::getReservedBytes() const
+{
+	return this->m_reservedBytes;
+}
+
+
+/**
+ * CNodePool constructor: the node size is taken from the first allocation
+ */
+CNodePool::CNodePool()
+{
+	this->m_pFreeList 		= 0;
+	this->m_nodeSize 		= 0;
+	this->m_nodeAlignment 	= 0;
+}
+
+
+/**
+ * Take a node from the free list or from the blocks of the pool.
+ * Memory larger or more aligned than the first allocation comes from the heap.
+ * param@ size_t bytes				-	size of the memory		(IN)
+ * param@ size_t alignment			-	alignment, a power of 2	(IN)
+ * returnvalue@ void*				-	the memory
+ */
+void* CNodePool::allocate(size_t bytes, size_t alignment)
+{
+	if (!this->m_nodeSize)
+	{
+		// a free node has to hold the pointer to the next one
+		this->m_nodeAlignment 	= max(alignment, alignof(FreeNode));
+		this->m_nodeSize 		= (max(bytes, sizeof(FreeNode)) + this->m_nodeAlignment - 1) & ~(this->m_nodeAlignment - 1);
+	}
+
+	if (!this->isNode(bytes, alignment))
+	{
+		return ::operator new(bytes, align_val_t(alignment));
+	}
+
+	if (this->m_pFreeList)
+	{
+		FreeNode *pNode = this->m_pFreeList;
+
+		this->m_pFreeList = pNode->pNext;
+
+		return pNode;
+	}
+
+	return this->m_arena.allocate(this->m_nodeSize, this->m_nodeAlignment);
+}
+
+
+/**
+ * Put a node back on the free list; the memory which allocate() took from the heap goes back to the heap
+ * param@ void *pMemory				-	memory from allocate()	(IN)
+ * param@ size_t bytes				-	size of the memory		(IN)
+ * param@ size_t alignment			-	alignment of the memory	(IN)
+ * returnvalue@ void
+ */
+void CNodePool::deallocate(void *pMemory, size_t bytes, size_t alignment)
+{
+	if (!this->isNode(bytes, alignment))
+	{
+		::operator delete(pMemory, align_val_t(alignment));
+		return;
+	}
+
+	FreeNode *pNode = static_cast<FreeNode *>(pMemory);
+
+	pNode->pNext 		= this->m_pFreeList;
+	this->m_pFreeList 	= pNode;
+}
+
+
+/**
+ * Free all the nodes at once
+ * returnvalue@ void
+ */
+void CNodePool::release()
+{
+	this->m_arena.release();
+	this->m_pFreeList = 0;
+}
+
+
+/**
+ * Get the memory of all the blocks
+ * returnvalue@ size_t				-	bytes
+ */
+size_t CNodePool::getReservedBytes() const
+{
+	return this->m_arena.getReservedBytes();
+}
+
+
+/**
+ * Check if memory of the size and alignment is a node of the pool; the same test for
+ * allocate() and deallocate() sends the other memory to the heap and back
+ */
+bool CNodePool::isNode(size_t bytes, size_t alignment) const
+{
+	return (bytes <= this->m_nodeSize) && (alignment <= this->m_nodeAlignment);
+}
+
+
+/**
+ * CHeapArena constructor
+ */
+CHeapArena::CHeapArena()
+{
+	// do nothing
+}
+
+
+/**
+ * Memory from the heap
+ */
+void* CHeapArena::allocate(size_t bytes, size_t)
+{
+	return ::operator new(bytes);
+}
+
+void CHeapArena::deallocate(void *pMemory, size_t, size_t)
+{
+	::operator delete(pMemory);
+}
+
+
+/**
+ * Nothing to do: the elements are freed by the container
+ */
+void CHeapArena::release()
+{
+	// do nothing
+}
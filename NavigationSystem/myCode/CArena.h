@@ -0,0 +1,327 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CArena.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines the memory sources of the containers
+* 					of the databases and the route, and a template class
+* 					CArenaAllocator which makes a standard container take
+* 					its memory from one of them:
+* 					CMonotonicArena	-	hands out the memory of large
+* 										blocks one after the other, a
+* 										single element is never freed;
+* 										release() frees all the blocks
+* 										at once. For bulk loads.
+* 					CNodePool		-	nodes of one size with a free
+* 										list, e.g. the nodes of a list
+* 										which grows and shrinks.
+* 					CHeapArena		-	every element from the heap,
+* 										like std::allocator.
+* 					A memory source belongs to one container, no locks are
+* 					taken.
+*
+****************************************************************************/
+
+#ifndef CARENA_H
+#define CARENA_H
+
+//System Include Files
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+class CMonotonicArena {
+public:
+
+	/**
+	 * release() frees all the memory at once
+	 */
+	static const bool 	CAN_RELEASE_ALL = true;
+
+	/**
+	 * CMonotonicArena constructor: no memory is taken before the first allocation
+	 */
+	CMonotonicArena();
+
+	/**
+	 * CMonotonicArena destructor: frees all the blocks
+	 */
+	~CMonotonicArena();
+
+	/**
+	 * Take memory from the current block, a new block is started if it is too small.
+	 * The blocks double in size up to MAX_BLOCK_SIZE.
+	 * param@ size_t bytes				-	size of the memory		(IN)
+	 * param@ size_t alignment			-	alignment, a power of 2	(IN)
+	 * returnvalue@ void*				-	the memory
+	 */
+	void* allocate(size_t bytes, size_t alignment);
+
+	/**
+	 * Single elements are not freed: the memory is kept until release()
+	 * param@ void *pMemory				-	memory from allocate()	(IN)
+	 * param@ size_t bytes				-	size of the memory		(IN)
+	 * param@ size_t alignment			-	alignment of the memory	(IN)
+	 * returnvalue@ void
+	 */
+	void deallocate(void *pMemory, size_t bytes, size_t alignment);
+
+	/**
+	 * Free all the blocks; the cost depends on the number of blocks, not of elements
+	 * returnvalue@ void
+	 */
+	void release();
+
+	/**
+	 * Get the memory of all the blocks
+	 * returnvalue@ size_t				-	bytes
+	 */
+	size_t getReservedBytes() const;
+
+private:
+
+	static const size_t			FIRST_BLOCK_SIZE 	= 64 * 1024;
+	static const size_t			MAX_BLOCK_SIZE 		= 16 * 1024 * 1024;
+
+	/**
+	 * The blocks; the unused rest of the last block
+	 */
+	std::vector<char *>			m_blocks;
+	char						*m_pFree;
+	size_t						m_freeLength;
+	size_t						m_nextBlockSize;
+	size_t						m_reservedBytes;
+
+	/**
+	 * The memory cannot be copied
+	 */
+	CMonotonicArena(CMonotonicArena const &origin);
+	CMonotonicArena& operator=(CMonotonicArena const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+
+
+class CNodePool {
+public:
+
+	/**
+	 * release() frees all the memory at once
+	 */
+	static const bool 	CAN_RELEASE_ALL = true;
+
+	/**
+	 * CNodePool constructor: the node size is taken from the first allocation
+	 */
+	CNodePool();
+
+	/**
+	 * Take a node from the free list or from the blocks of the pool.
+	 * Memory larger or more aligned than the first allocation comes from the heap.
+	 * param@ size_t bytes				-	size of the memory		(IN)
+	 * param@ size_t alignment			-	alignment, a power of 2	(IN)
+	 * returnvalue@ void*				-	the memory
+	 */
+	void* allocate(size_t bytes, size_t alignment);
+
+	/**
+	 * Put a node back on the free list; the memory which allocate() took from the heap goes back to the heap
+	 * param@ void *pMemory				-	memory from allocate()	(IN)
+	 * param@ size_t bytes				-	size of the memory		(IN)
+	 * param@ size_t alignment			-	alignment of the memory	(IN)
+	 * returnvalue@ void
+	 */
+	void deallocate(void *pMemory, size_t bytes, size_t alignment);
+
+	/**
+	 * Free all the nodes at once
+	 * returnvalue@ void
+	 */
+	void release();
+
+	/**
+	 * Get the memory of all the blocks
+	 * returnvalue@ size_t				-	bytes
+	 */
+	size_t getReservedBytes() const;
+
+private:
+
+	/**
+	 * A free node holds the next free node
+	 */
+	struct FreeNode
+	{
+		FreeNode	*pNext;
+	};
+
+	CMonotonicArena				m_arena;
+	FreeNode					*m_pFreeList;
+	size_t						m_nodeSize;
+	size_t						m_nodeAlignment;
+
+	/**
+	 * Check if memory of the size and alignment is a node of the pool; the same test for
+	 * allocate() and deallocate() sends the other memory to the heap and back
+	 */
+	bool isNode(size_t bytes, size_t alignment) const;
+
+	/**
+	 * The memory cannot be copied
+	 */
+	CNodePool(CNodePool const &origin);
+	CNodePool& operator=(CNodePool const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+
+
+class CHeapArena {
+public:
+
+	/**
+	 * The elements have to be freed one by one
+	 */
+	static const bool 	CAN_RELEASE_ALL = false;
+
+	CHeapArena();
+
+	/**
+	 * Memory from the heap
+	 */
+	void* allocate(size_t bytes, size_t alignment);
+	void deallocate(void *pMemory, size_t bytes, size_t alignment);
+
+	/**
+	 * Nothing to do: the elements are freed by the container
+	 */
+	void release();
+
+private:
+
+	CHeapArena(CHeapArena const &origin);
+	CHeapArena& operator=(CHeapArena const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * Tells if the destructor of a T may be skipped when all the memory of a
+ * container is released at once: T owns no memory or other resources.
+ * True for the types which are trivially destructible. Another type opts in by a
+ * specialization, which asserts that its members are trivially destructible.
+ */
+template<class T>
+struct CArenaTraits
+{
+	static const bool	CAN_SKIP_DESTRUCTOR = std::is_trivially_destructible<T>::value;
+};
+
+
+// a template class for the allocator of a standard container which takes the memory from a TArena
+template<class T, class TArena>
+class CArenaAllocator {
+public:
+
+	typedef T				value_type;
+
+	template<class TOther>
+	struct rebind
+	{
+		typedef CArenaAllocator<TOther, TArena>	other;
+	};
+
+	/**
+	 * CArenaAllocator constructor
+	 * param@ TArena *pArena			-	source of the memory	(IN)
+	 */
+	explicit CArenaAllocator(TArena *pArena);
+
+	template<class TOther>
+	CArenaAllocator(CArenaAllocator<TOther, TArena> const &origin);
+
+	/**
+	 * Memory for count elements
+	 */
+	T* allocate(size_t count);
+	void deallocate(T *pElements, size_t count);
+
+	/**
+	 * Get the source of the memory
+	 * returnvalue@ TArena*
+	 */
+	TArena* getArena() const;
+
+private:
+
+	TArena		*m_pArena;
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * CArenaAllocator constructor
+ * param@ TArena *pArena			-	source of the memory	(IN)
+ */
+template<class T, class TArena>
+CArenaAllocator<T, TArena>::CArenaAllocator(TArena *pArena)
+{
+	this->m_pArena = pArena;
+}
+
+template<class T, class TArena>
+template<class TOther>
+CArenaAllocator<T, TArena>::CArenaAllocator(CArenaAllocator<TOther, TArena> const &origin)
+{
+	this->m_pArena = origin.getArena();
+}
+
+
+/**
+ * Memory for count elements
+ */
+template<class T, class TArena>
+T* CArenaAllocator<T, TArena>::allocate(size_t count)
+{
+	return static_cast<T *>(this->m_pArena->allocate(count * sizeof(T), alignof(T)));
+}
+
+template<class T, class TArena>
+void CArenaAllocator<T, TArena>::deallocate(T *pElements, size_t count)
+{
+	this->m_pArena->deallocate(pElements, count * sizeof(T), alignof(T));
+}
+
+
+/**
+ * Get the source of the memory
+ * returnvalue@ TArena*
+ */
+template<class T, class TArena>
+TArena* CArenaAllocator<T, TArena>::getArena() const
+{
+	return this->m_pArena;
+}
+
+
+/**
+ * Allocators are equal if they share the source of the memory
+ */
+template<class T, class TOther, class TArena>
+bool operator==(CArenaAllocator<T, TArena> const &lhs, CArenaAllocator<TOther, TArena> const &rhs)
+{
+	return (lhs.getArena() == rhs.getArena());
+}
+
+template<class T, class TOther, class TArena>
+bool operator!=(CArenaAllocator<T, TArena> const &lhs, CArenaAllocator<TOther, TArena> const &rhs)
+{
+	return (lhs.getArena() != rhs.getArena());
+}
+#endif /* CARENA_H */
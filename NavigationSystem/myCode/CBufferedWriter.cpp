@@ -0,0 +1,184 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CBufferedWriter.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CBufferedWriter.
+*
+****************************************************************************/
+
+//System Include Files
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Own Include Files
+#include "CBufferedWriter.h"
+
+//Namespaces
+using namespace std;
+
+const size_t CBufferedWriter::DEFAULT_CAPACITY = 1024 * 1024;
+const size_t CBufferedWriter::NUMBER_LENGTH_MAX;
+
+//Method Implementations
+/**
+ * CBufferedWriter constructor
+ * param@ size_t capacity				-	size of the buffer in bytes	(IN)
+ */
+CBufferedWriter::CBufferedWriter(size_t capacity)
+{
+	// a number always fits into an empty buffer
+	this->m_buffer.resize(max(capacity, NUMBER_LENGTH_MAX));
+	this->m_used 		= 0;
+	this->m_descriptor 	= -1;
+	this->m_isOk 		= false;
+}
+
+
+/**
+ * CBufferedWriter destructor: writes the rest of the buffer and closes the file
+ */
+CBufferedWriter::~CBufferedWriter()
+{
+	this->close();
+}
+
+
+/**
+ * Create or truncate a file; a file opened before is closed
+ * param@ std::string const &fileName	-	name of the file	(IN)
+ * returnvalue@ bool					-	false if the file can not be opened
+ */
+bool CBufferedWriter::open(string const &fileName)
+{
+	this->close();
+
+	this->m_descriptor 	= ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	this->m_isOk 		= (this->m_descriptor >= 0);
+
+	return this->m_isOk;
+}
+
+
+/**
+ * Write the rest of the buffer and close the file
+ * returnvalue@ bool					-	false if a block could not be written
+ */
+bool CBufferedWriter::close()
+{
+	if (this->m_descriptor < 0)
+	{
+		return this->m_isOk;
+	}
+
+	this->flush();
+
+	if (::close(this->m_descriptor) < 0)
+	{
+		this->m_isOk = false;
+	}
+
+	this->m_descriptor = -1;
+
+	return this->m_isOk;
+}
+
+
+/**
+ * Check if all the blocks so far were written
+ * returnvalue@ bool
+ */
+bool CBufferedWriter::isOk() const
+{
+	return this->m_isOk;
+}
+
+
+/**
+ * Replace characters which were written before, e.g. a checksum in the header of a file
+ * which is only known at its end; the buffer is written first
+ * param@ uint64_t offset				-	position in the file	(IN)
+ * param@ char const *pChars			-	characters				(IN)
+ * param@ size_t length					-	number of characters	(IN)
+ * returnvalue@ void
+ */
+void CBufferedWriter::overwrite(uint64_t offset, char const *pChars, size_t length)
+{
+	this->flush();
+
+	if (!this->m_isOk || (this->m_descriptor < 0))
+	{
+		this->m_isOk = false;
+		return;
+	}
+
+	while (length > 0)
+	{
+		ssize_t written = ::pwrite(this->m_descriptor, pChars, length, (off_t)offset);
+
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			this->m_isOk = false;
+			return;
+		}
+
+		pChars 	+= written;
+		length 	-= written;
+		offset 	+= written;
+	}
+}
+
+
+/**
+ * Write the content of the buffer as one block
+ * returnvalue@ void
+ */
+void CBufferedWriter::flush()
+{
+	this->writeBlock(&this->m_buffer[0], this->m_used);
+	this->m_used = 0;
+}
+
+
+/**
+ * Write characters to the file
+ * param@ char const *pChars			-	characters				(IN)
+ * param@ size_t length					-	number of characters	(IN)
+ * returnvalue@ void
+ */
+void CBufferedWriter::writeBlock(char const *pChars, size_t length)
+{
+	// after an error the rest is dropped, the file is incomplete anyway
+	if (!this->m_isOk || (this->m_descriptor < 0))
+	{
+		this->m_isOk = false;
+		return;
+	}
+
+	while (length > 0)
+	{
+		ssize_t written = ::write(this->m_descriptor, pChars, length);
+
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			this->m_isOk = false;
+			return;
+		}
+
+		pChars 	+= written;
+		length 	-= written;
+	}
+}
@@ -0,0 +1,203 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CBufferedWriter.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CBufferedWriter.
+* 					The class CBufferedWriter collects the text of a file
+* 					in a large buffer and writes it in blocks; an error
+* 					is checked once per block and remembered until the
+* 					file is closed. Numbers are formatted with to_chars:
+* 					the shortest text which reads back to the same
+* 					double, in the style of printf("%g") (e.g. 49.866851,
+* 					-0.5, 1e-05), independent of the locale.
+*
+****************************************************************************/
+
+#ifndef CBUFFEREDWRITER_H
+#define CBUFFEREDWRITER_H
+
+//System Include Files
+#include <string>
+#include <string_view>
+#include <vector>
+#include <charconv>
+#include <cstring>
+#include <stdint.h>
+
+//Own Include Files
+
+class CBufferedWriter {
+public:
+
+	/**
+	 * Size of the buffer by default, the size of a block
+	 */
+	static const size_t DEFAULT_CAPACITY;
+
+	/**
+	 * CBufferedWriter constructor
+	 * param@ size_t capacity				-	size of the buffer in bytes	(IN)
+	 */
+	explicit CBufferedWriter(size_t capacity = DEFAULT_CAPACITY);
+
+	/**
+	 * CBufferedWriter destructor: writes the rest of the buffer and closes the file
+	 */
+	~CBufferedWriter();
+
+	/**
+	 * Create or truncate a file; a file opened before is closed
+	 * param@ std::string const &fileName	-	name of the file	(IN)
+	 * returnvalue@ bool					-	false if the file can not be opened
+	 */
+	bool open(std::string const &fileName);
+
+	/**
+	 * Write the rest of the buffer and close the file
+	 * returnvalue@ bool					-	false if a block could not be written
+	 */
+	bool close();
+
+	/**
+	 * Check if all the blocks so far were written
+	 * returnvalue@ bool
+	 */
+	bool isOk() const;
+
+	/**
+	 * Append characters
+	 * param@ char const *pChars			-	characters				(IN)
+	 * param@ size_t length					-	number of characters	(IN)
+	 * returnvalue@ void
+	 */
+	void write(char const *pChars, size_t length);
+
+	/**
+	 * Replace characters which were written before, e.g. a checksum in the header of a file
+	 * which is only known at its end; the buffer is written first
+	 * param@ uint64_t offset				-	position in the file	(IN)
+	 * param@ char const *pChars			-	characters				(IN)
+	 * param@ size_t length					-	number of characters	(IN)
+	 * returnvalue@ void
+	 */
+	void overwrite(uint64_t offset, char const *pChars, size_t length);
+
+	/**
+	 * Append a text, a character or a number (shortest round trip)
+	 * returnvalue@ CBufferedWriter&		-	the writer
+	 */
+	CBufferedWriter& operator<<(std::string_view text);
+	CBufferedWriter& operator<<(char character);
+	CBufferedWriter& operator<<(double number);
+
+private:
+
+	/**
+	 * Longest text of a double: sign, 17 digits, point, exponent
+	 */
+	static const size_t	NUMBER_LENGTH_MAX = 32;
+
+	std::vector<char>		m_buffer;
+	size_t					m_used;
+	int						m_descriptor;
+	bool					m_isOk;
+
+	/**
+	 * Write the content of the buffer as one block
+	 * returnvalue@ void
+	 */
+	void flush();
+
+	/**
+	 * Write characters to the file
+	 * param@ char const *pChars			-	characters				(IN)
+	 * param@ size_t length					-	number of characters	(IN)
+	 * returnvalue@ void
+	 */
+	void writeBlock(char const *pChars, size_t length);
+
+	/**
+	 * The writer owns the file, it is not copied
+	 */
+	CBufferedWriter(CBufferedWriter const &origin);
+	CBufferedWriter& operator=(CBufferedWriter const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * Append characters; inline, the writers call it for every field
+ * param@ char const *pChars			-	characters				(IN)
+ * param@ size_t length					-	number of characters	(IN)
+ * returnvalue@ void
+ */
+inline void CBufferedWriter::write(char const *pChars, size_t length)
+{
+	if (this->m_used + length > this->m_buffer.size())
+	{
+		this->flush();
+
+		// longer than the buffer: written directly
+		if (length > this->m_buffer.size())
+		{
+			this->writeBlock(pChars, length);
+			return;
+		}
+	}
+
+	memcpy(&this->m_buffer[this->m_used], pChars, length);
+	this->m_used += length;
+}
+
+
+/**
+ * Append a text
+ * returnvalue@ CBufferedWriter&		-	the writer
+ */
+inline CBufferedWriter& CBufferedWriter::operator<<(std::string_view text)
+{
+	this->write(text.data(), text.size());
+
+	return *this;
+}
+
+
+/**
+ * Append a character
+ * returnvalue@ CBufferedWriter&		-	the writer
+ */
+inline CBufferedWriter& CBufferedWriter::operator<<(char character)
+{
+	if (this->m_used == this->m_buffer.size())
+	{
+		this->flush();
+	}
+
+	this->m_buffer[this->m_used++] = character;
+
+	return *this;
+}
+
+
+/**
+ * Append a number: the shortest text which reads back to the same double
+ * returnvalue@ CBufferedWriter&		-	the writer
+ */
+inline CBufferedWriter& CBufferedWriter::operator<<(double number)
+{
+	if (this->m_used + NUMBER_LENGTH_MAX > this->m_buffer.size())
+	{
+		this->flush();
+	}
+
+	char 				*pFirst = &this->m_buffer[this->m_used];
+	std::to_chars_result result = std::to_chars(pFirst, pFirst + NUMBER_LENGTH_MAX, number, std::chars_format::general);
+
+	this->m_used += result.ptr - pFirst;
+
+	return *this;
+}
+#endif /* CBUFFEREDWRITER_H */
@@ -14,11 +14,19 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
 
 //Own Include Files
 #include "CCSV.h"
 #include "CPOI.h"
+#include "CMappedFile.h"
+#include "CBufferedWriter.h"
 
 //Namespaces
 using namespace std;
@@ -26,13 +34,395 @@ using namespace std;
 //Macros
 //#define RUN_TEST_CASE
 
+// a file is split only into chunks of this size or more, a small file is parsed by one thread
+#define CSV_MIN_CHUNK_BYTES		(256 * 1024)
+
+/**
+ * Writes every visited Waypoint as a line of the waypoint file, straight from the database
+ */
+struct CCSVWaypointWriter
+{
+	CBufferedWriter	*pWriter;
+
+	void operator()(Wp_Database_key_t const &, CWaypoint const &wp)
+	{
+		// assuming all the elements in Database is valid
+		CPooledString const &name = wp.getPooledName();
+
+		pWriter->write(name.data(), name.size());
+		*pWriter << "; " << wp.getLatitude() << "; " << wp.getLongitude() << '\n';
+	}
+};
+
+/**
+ * Writes every visited POI as a line of the POI file, straight from the database
+ */
+struct CCSVPoiWriter
+{
+	CBufferedWriter	*pWriter;
+
+	void operator()(POI_Database_key_t const &, CPOI const &poi)
+	{
+		// assuming all the elements in Database is valid
+		CPooledString const &name 			= poi.getPooledName();
+		CPooledString const &description 	= poi.getPooledDescription();
+
+		*pWriter << poi.getPoiTypeName() << "; ";
+		pWriter->write(name.data(), name.size());
+		*pWriter << "; ";
+		pWriter->write(description.data(), description.size());
+		*pWriter << "; " << poi.getLatitude() << "; " << poi.getLongitude() << '\n';
+	}
+};
+
+/**
+ * A part of a mapped file from the start of a line to the start of another line,
+ * parsed by one thread into a batch of its own
+ */
+template<class TBatch>
+struct CCSVChunk
+{
+	char const		*pBegin;
+	char const		*pEnd;
+	unsigned int	firstLine;		// number of the line before the chunk
+	unsigned int	lineCount;
+	string			messages;		// errors of the lines, printed in the order of the file
+	TBatch			batch;
+};
+
+/**
+ * Two neighbouring batches sorted by key; the second one is merged into the first one
+ */
+template<class TBatch>
+struct CCSVBatchMerge
+{
+	TBatch			*pFirst;
+	TBatch			*pSecond;
+};
+
+/**
+ * Take the next line of a mapped file, without the line end ("\n" or "\r\n")
+ * @param char const *&pChars	-	start of the line, moved to the next line	(IN/OUT)
+ * @param char const *pEnd		-	end of the file								(IN)
+ * @return string_view			-	the line, in place
+ */
+static string_view nextLine(char const *&pChars, char const *pEnd)
+{
+	char const 	*pLineEnd 	= static_cast<char const *>(memchr(pChars, '\n', pEnd - pChars));
+	string_view line;
+
+	if (pLineEnd)
+	{
+		line 	= string_view(pChars, pLineEnd - pChars);
+		pChars 	= pLineEnd + 1;
+	}
+	else
+	{
+		// the last line has no line end
+		line 	= string_view(pChars, pEnd - pChars);
+		pChars 	= pEnd;
+	}
+
+	if (!line.empty() && (line.back() == '\r'))
+	{
+		line.remove_suffix(1);
+	}
+
+	return line;
+}
+
+/**
+ * Parse a line of the waypoint file and append the Waypoint to the batch
+ */
+static void parseLine(CParser &parser, string_view readLine, unsigned int lineNumber, ostream &messages, CWpDatabase::Database_Batch_t &batch)
+{
+	string_view		name;
+	double 			latitude = (LATITUDE_MAX + 1), longitude = (LONGITUDE_MAX  + 1);	// set to invalid values
+
+	if (!parser.parserEachLine(readLine, name, latitude, longitude, lineNumber, messages))
+	{
+		return;
+	}
+
+	CPooledString pooledName;
+
+	if (!CPooledString::intern(name, pooledName))
+	{
+		messages << "ERROR: The string pool is full, line " << lineNumber << " is not added: " << readLine << "\n";
+		return;
+	}
+
+	CWaypoint wp(pooledName, latitude, longitude);
+
+	if (wp.isValid())
+	{
+		batch.push_back(std::pair<Wp_Database_key_t, CWaypoint>(wp.getPooledName(), std::move(wp)));
+	}
+	else
+	{
+		messages << "ERROR: Invalid Waypoint in line " << lineNumber << ": " << readLine << "\n";
+	}
+}
+
+/**
+ * Parse a line of the POI file and append the POI to the batch
+ */
+static void parseLine(CParser &parser, string_view readLine, unsigned int lineNumber, ostream &messages, CPoiDatabase::Database_Batch_t &batch)
+{
+	CPOI::t_poi		type;
+	string_view		name, description;
+	double 			latitude = (LATITUDE_MAX + 1), longitude = (LONGITUDE_MAX  + 1);	// set to invalid values
+
+	if (!parser.parserEachLine(readLine, type, name, description, latitude, longitude, lineNumber, messages))
+	{
+		return;
+	}
+
+	CPooledString pooledName, pooledDescription;
+
+	if (!CPooledString::intern(name, pooledName) || !CPooledString::intern(description, pooledDescription))
+	{
+		messages << "ERROR: The string pool is full, line " << lineNumber << " is not added: " << readLine << "\n";
+		return;
+	}
+
+	CPOI poi(type, pooledName, pooledDescription, latitude, longitude);
+
+	if (poi.isValid())
+	{
+		batch.push_back(std::pair<POI_Database_key_t, CPOI>(poi.getPooledName(), std::move(poi)));
+	}
+	else
+	{
+		messages << "ERROR: Invalid POI in line " << lineNumber << ": " << readLine << "\n";
+	}
+}
+
+/**
+ * Order of the elements of a batch: by key only, as the databases sort a batch
+ */
+template<class TElement>
+static bool isKeyBefore(TElement const &lhs, TElement const &rhs)
+{
+	return lhs.first < rhs.first;
+}
+
+/**
+ * Count the lines of a chunk
+ */
+template<class TBatch>
+static void countLines(CCSVChunk<TBatch> *pChunk)
+{
+	pChunk->lineCount = count(pChunk->pBegin, pChunk->pEnd, '\n');
+
+	// the last line of the file may have no line end
+	if ((pChunk->pEnd > pChunk->pBegin) && (pChunk->pEnd[-1] != '\n'))
+	{
+		pChunk->lineCount++;
+	}
+}
+
+/**
+ * Parse the lines of a chunk into its batch and sort the batch by key; the order of the
+ * file is kept for equal keys
+ */
+template<class TBatch>
+static void parseChunk(CCSVChunk<TBatch> *pChunk)
+{
+	CParser			parser;
+	ostringstream	messages;
+	char const		*pChars 	= pChunk->pBegin;
+	unsigned int	lineNumber 	= pChunk->firstLine;
+
+	while (pChars < pChunk->pEnd)
+	{
+		string_view		readLine = nextLine(pChars, pChunk->pEnd);
+
+		lineNumber++;
+
+		if (readLine.length() == 0)
+		{
+			// empty line - ignore them
+			messages << "ERROR: Empty line in line " << lineNumber << "\n";
+			continue;
+		}
+
+		parseLine(parser, readLine, lineNumber, messages, pChunk->batch);
+	}
+
+	pChunk->messages = messages.str();
+
+	// a file written by writeData is in the order of the keys already
+	if (!is_sorted(pChunk->batch.begin(), pChunk->batch.end(), isKeyBefore<typename TBatch::value_type>))
+	{
+		stable_sort(pChunk->batch.begin(), pChunk->batch.end(), isKeyBefore<typename TBatch::value_type>);
+	}
+}
+
+/**
+ * Merge the second batch into the first one; on equal keys the elements of the first batch,
+ * which come earlier in the file, stay in front
+ */
+template<class TBatch>
+static void mergeBatches(CCSVBatchMerge<TBatch> *pMerge)
+{
+	TBatch merged;
+
+	merged.reserve(pMerge->pFirst->size() + pMerge->pSecond->size());
+	merge(make_move_iterator(pMerge->pFirst->begin()), make_move_iterator(pMerge->pFirst->end()),
+		  make_move_iterator(pMerge->pSecond->begin()), make_move_iterator(pMerge->pSecond->end()),
+		  back_inserter(merged), isKeyBefore<typename TBatch::value_type>);
+
+	pMerge->pFirst->swap(merged);
+	TBatch().swap(*pMerge->pSecond);
+}
+
+/**
+ * Run a job for each of the items, one thread per item; the first item is handled by the calling thread
+ */
+template<class TItem>
+static void runJobs(void (*pJob)(TItem *), vector<TItem *> const &items)
+{
+	vector<thread>	workers;
+
+	for (unsigned int index = 1; index < items.size(); ++index)
+	{
+		workers.push_back(thread(pJob, items[index]));
+	}
+
+	if (!items.empty())
+	{
+		pJob(items[0]);
+	}
+
+	for (unsigned int index = 0; index < workers.size(); ++index)
+	{
+		workers[index].join();
+	}
+}
+
+/**
+ * Parse a mapped file with the given number of threads. The file is split into chunks at
+ * line ends; the chunks count their lines, then parse them, then the sorted batches are
+ * merged in pairs. Afterwards the first chunk holds all the elements in the order of their
+ * keys, equal keys in the order of the file, and every chunk the errors of its lines.
+ * @param CMappedFile const *pFile			-	the file					(IN)
+ * @param unsigned int threads				-	number of threads			(IN)
+ * @param vector<CCSVChunk<TBatch> > *pChunks	-	the chunks				(OUT)
+ * @returnval void
+ */
+template<class TBatch>
+static void ingestFile(CMappedFile const *pFile, unsigned int threads, vector<CCSVChunk<TBatch> > *pChunks)
+{
+	vector<CCSVChunk<TBatch> >	&chunks 	= *pChunks;
+	char const					*pData 		= pFile->getData();
+	size_t						size 		= pFile->getSize();
+	unsigned int				count 		= max<size_t>(1, min<size_t>(threads, size / CSV_MIN_CHUNK_BYTES));
+	char const					*pBegin 	= pData;
+	vector<CCSVChunk<TBatch> *>	jobs;
+
+	chunks.resize(count);
+
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		char const *pEnd = pData + size;
+
+		// a chunk ends behind the first line end after its share of the file
+		if (index + 1 < count)
+		{
+			char const *pSplit = max(pBegin, pData + size / count * (index + 1));
+			char const *pLineEnd = static_cast<char const *>(memchr(pSplit, '\n', pData + size - pSplit));
+
+			pEnd = pLineEnd ? (pLineEnd + 1) : (pData + size);
+		}
+
+		chunks[index].pBegin 	= pBegin;
+		chunks[index].pEnd 		= pEnd;
+		pBegin 					= pEnd;
+
+		jobs.push_back(&chunks[index]);
+	}
+
+	// the numbers of the lines of a chunk follow from the lines of the chunks before it
+	runJobs(countLines<TBatch>, jobs);
+
+	for (unsigned int index = 0, lines = 0; index < count; ++index)
+	{
+		chunks[index].firstLine = lines;
+		lines += chunks[index].lineCount;
+	}
+
+	runJobs(parseChunk<TBatch>, jobs);
+
+	for (unsigned int width = 1; width < count; width *= 2)
+	{
+		vector<CCSVBatchMerge<TBatch> >		merges;
+		vector<CCSVBatchMerge<TBatch> *>	mergeJobs;
+
+		for (unsigned int index = 0; index + width < count; index += 2 * width)
+		{
+			CCSVBatchMerge<TBatch> pair = { &chunks[index].batch, &chunks[index + width].batch };
+
+			merges.push_back(pair);
+		}
+
+		for (unsigned int index = 0; index < merges.size(); ++index)
+		{
+			mergeJobs.push_back(&merges[index]);
+		}
+
+		runJobs(mergeBatches<TBatch>, mergeJobs);
+	}
+}
+
+/**
+ * Print the request of a database
+ * @param char const *pDatabaseName		-	"Waypoint" or "POI"		(IN)
+ * @param MergeMode mode				-	the merge mode			(IN)
+ * @return false if the mode is unknown
+ */
+static bool printRequest(char const *pDatabaseName, CPersistentStorage::MergeMode mode)
+{
+	cout << "=======================================================\n";
+
+	if (mode == CCSV::MERGE)
+	{
+		cout << "INFO: " << pDatabaseName << " Database Merge Request.\n";
+	}
+	else if (mode == CCSV::REPLACE)
+	{
+		cout << "INFO: " << pDatabaseName << " Database Replace Request.\n";
+	}
+	else
+	{
+		cout << "ERROR: " << pDatabaseName << " Database Unknown MergeMode Request.\n";
+		return false;
+	}
+
+	cout << "=======================================================\n";
+
+	return true;
+}
+
+/**
+ * Print the errors of the chunks in the order of the file
+ */
+template<class TBatch>
+static void printMessages(vector<CCSVChunk<TBatch> > const &chunks)
+{
+	for (unsigned int index = 0; index < chunks.size(); ++index)
+	{
+		cout << chunks[index].messages;
+	}
+}
+
 
 /**
  * Constructor
  */
 CCSV::CCSV()
 {
-	this->lineCounter = 0;
+	this->threadCount = 0;
 }
 
 /**
@@ -59,6 +449,20 @@ void CCSV::setMediaName(string name)
 }
 
 
+/**
+* Set the number of threads which parse the files. A file is split into
+* chunks at line ends, one per thread; the waypoint and the POI file are
+* parsed at the same time. The result does not depend on the number.
+*
+* @param threads number of threads, 0 for all the cores (default), 1 to parse on the calling thread
+* @returnval void
+*/
+void CCSV::setThreadCount(unsigned int threads)
+{
+	this->threadCount = threads;
+}
+
+
 /**
 * Write the data to the persistent storage.
 *
@@ -68,110 +472,65 @@ void CCSV::setMediaName(string name)
 */
 bool CCSV::writeData (const CWpDatabase& waypointDb, const CPoiDatabase& poiDb)
 {
-	bool			ret = true;
-	ofstream 		fileStream;
-	string 			fileName;
+	bool				ret = true;
+	CBufferedWriter 	writer;
+	string 				fileName;
 
 	fileName = this->mediaName + "-wp.txt";
-	fileStream.precision(10);
-	fileStream.clear();
 
 	// Write Waypoints
-	fileStream.open(fileName.c_str(), ofstream::out);
-
 	cout << "=======================================================\n";
 	cout << "INFO: Waypoint Database backup request\n";
 
 	// is the open successful?
-	if (!fileStream.fail())
+	if (writer.open(fileName))
 	{
-		CWpDatabase::Wp_Map_t		Waypoints;
-		CWpDatabase::Wp_Map_Itr_t 	itr;
-		string			name;
-		double 			latitude, longitude;
+		CCSVWaypointWriter wpWriter = { &writer };
 
-		Waypoints = waypointDb.getWpsFromDatabase();
+		// streamed from the database, the Waypoints are not copied
+		waypointDb.visitWaypoints(wpWriter);
 
-		for (itr = Waypoints.begin(); itr != Waypoints.end(); ++(itr))
+		// the blocks are checked once, when the file is complete
+		if (!writer.close())
 		{
-			// assuming all the elements in Database is valid
-			itr->second.getAllDataByReference(name, latitude, longitude);
-
-			fileStream << name << "; ";
-			fileStream << latitude << "; ";
-			fileStream << longitude << "\n";
-
-			if (fileStream.fail())
-			{
-				fileStream.clear();
-				cout << "WARNING: Error writing a Waypoint into the file.\n" << itr->second << endl;
-				ret = false;
-			}
+			cout << "WARNING: Error writing the Waypoints into the file - " << fileName << endl;
+			ret = false;
 		}
 	}
 	else
 	{
-		fileStream.clear();
 		cout << "WARNING: Error opening the file to write - " << fileName << endl;
 		ret = false;
 	}
 
-	fileStream.flush();
-	fileStream.close();
-
 	cout << "=======================================================\n";
 
 	fileName = this->mediaName + "-poi.txt";
-	fileStream.precision(10);
-	fileStream.clear();
 
 	// Write Point of Interests
-	fileStream.open(fileName.c_str(), ofstream::out);
-
 	cout << "=======================================================\n";
 	cout << "INFO: POI Database backup request\n";
 
 	// is the open successful?
-	if (!fileStream.fail())
+	if (writer.open(fileName))
 	{
-		CPoiDatabase::Poi_Map_t			Pois;
-		CPoiDatabase::Poi_Map_Itr_t 	itr;
-		CPOI::t_poi		type;
-		string			name, description, typeName;
-		double 			latitude, longitude;
+		CCSVPoiWriter poiWriter = { &writer };
 
-		Pois = poiDb.getPoisFromDatabase();
+		// streamed from the database, the POIs are not copied
+		poiDb.visitPois(poiWriter);
 
-		for (itr = Pois.begin(); itr != Pois.end(); ++(itr))
+		if (!writer.close())
 		{
-			// assuming all the elements in Database is valid
-			itr->second.getAllDataByReference(name, latitude, longitude, type, description);
-			typeName = itr->second.getPoiTypeName();
-
-			fileStream << typeName << "; ";
-			fileStream << name << "; ";
-			fileStream << description << "; ";
-			fileStream << latitude << "; ";
-			fileStream << longitude << "\n";
-
-			if (fileStream.fail())
-			{
-				fileStream.clear();
-				cout << "WARNING: Error writing a POI into the file.\n" << itr->second << endl;
-				ret = false;
-			}
+			cout << "WARNING: Error writing the POIs into the file - " << fileName << endl;
+			ret = false;
 		}
 	}
 	else
 	{
-		fileStream.clear();
 		cout << "WARNING: Error opening the file to write - " << fileName << endl;
 		ret = false;
 	}
 
-	fileStream.flush();
-	fileStream.close();
-
 	cout << "=======================================================\n";
 
 	return ret;
@@ -185,6 +544,9 @@ bool CCSV::writeData (const CWpDatabase& waypointDb, const CPoiDatabase& poiDb)
 * bases. If merge mode is REPLACE, already existing content
 * will be removed before inserting the content from the persistent
 * storage.
+* A key which is in the file more than once keeps its first element,
+* a key which is already in the data base keeps the existing element;
+* the rejected elements are reported.
 *
 * @param waypointDb the the data base with way points
 * @param poiDb the database with points of interest
@@ -193,175 +555,102 @@ bool CCSV::writeData (const CWpDatabase& waypointDb, const CPoiDatabase& poiDb)
 */
 bool CCSV::readData (CWpDatabase& waypointDb, CPoiDatabase& poiDb, MergeMode mode)
 {
-	bool			ret = true;
-	ifstream 		fileStream;
-	string 			fileName;
+	bool											ret = true;
+	CMappedFile										wpFile, poiFile;
+	string 											wpFileName 	= this->mediaName + "-wp.txt";
+	string 											poiFileName = this->mediaName + "-poi.txt";
+	vector<CCSVChunk<CWpDatabase::Database_Batch_t> >	wpChunks;
+	vector<CCSVChunk<CPoiDatabase::Database_Batch_t> >	poiChunks;
+
+	// the files are mapped, the lines are parsed in place
+	bool 			isWpOpen 	= wpFile.open(wpFileName);
+	bool 			isPoiOpen 	= poiFile.open(poiFileName);
+	unsigned int 	threads 	= this->threadCount ? this->threadCount : thread::hardware_concurrency();
+	bool 			isValidMode = (mode == CCSV::MERGE) || (mode == CCSV::REPLACE);
+
+	threads = max(1u, threads);
+
+	if (isValidMode && isWpOpen && isPoiOpen && (threads > 1))
+	{
+		// both files at the same time, the threads are shared by the size of the files
+		size_t 			totalSize 	= wpFile.getSize() + poiFile.getSize();
+		unsigned int 	wpThreads 	= totalSize ? (unsigned int)(threads * wpFile.getSize() / totalSize) : 1;
 
-	fileName = this->mediaName + "-wp.txt";
-	fileStream.precision(10);
-	fileStream.clear();
+		wpThreads = min(max(1u, wpThreads), threads - 1);
 
-	// Read Waypoints
-	fileStream.open(fileName.c_str(), ifstream::in);
+		thread wpWorker(ingestFile<CWpDatabase::Database_Batch_t>, &wpFile, wpThreads, &wpChunks);
 
-	// is the open successful?
-	if (!fileStream.fail())
+		ingestFile(&poiFile, threads - wpThreads, &poiChunks);
+		wpWorker.join();
+	}
+	else if (isValidMode)
 	{
-		string			readLine;
-
-		this->lineCounter = 0;
-
-		cout << "=======================================================\n";
-		if (mode == CCSV::MERGE)
+		if (isWpOpen)
 		{
-			cout << "INFO: Waypoint Database Merge Request.\n";
+			ingestFile(&wpFile, threads, &wpChunks);
 		}
-		else if (mode == CCSV::REPLACE)
+
+		if (isPoiOpen)
 		{
-			waypointDb.resetWpsDatabase();
-			cout << "INFO: Waypoint Database Replace Request.\n";
+			ingestFile(&poiFile, threads, &poiChunks);
 		}
-		else
+	}
+
+	// Read Waypoints
+	// is the open successful?
+	if (isWpOpen)
+	{
+		if (!printRequest("Waypoint", mode))
 		{
-			cout << "ERROR: Waypoint Database Unknown MergeMode Request.\n";
 			return false;
 		}
 
-		cout << "=======================================================\n";
+		printMessages(wpChunks);
 
-		while (!fileStream.eof())
+		// load all the Waypoints of the file at once
+		if (mode == CCSV::MERGE)
 		{
-			getline(fileStream, readLine, '\n');
-			this->lineCounter++;
-
-			if (readLine.length() == 0)
-			{
-				// empty line - ignore them
-				cout << "ERROR: Empty line in line " << this->lineCounter << "\n";
-				continue;
-			}
-
-			if (fileStream.fail())
-			{
-				fileStream.clear();
-				cout << "ERROR: Reading a waypoint from the file - " << fileName << endl;
-				ret = false;
-			}
-			else
-			{
-				string			name;
-				double 			latitude = (LATITUDE_MAX + 1), longitude = (LONGITUDE_MAX  + 1);	// set to invalid values
-
-				if (!this->parserEachLine(readLine, name, latitude, longitude, this->lineCounter))
-				{
-					continue;
-				}
-
-				CWaypoint wp(name, latitude, longitude);
-
-				if (!wp.getName().empty())
-				{
-					waypointDb.addWaypoint(wp.getName(), wp);
-				}
-				else
-				{
-					cout << "ERROR: Invalid Waypoint in line " << this->lineCounter << ": " << readLine << "\n";
-				}
-			}
+			waypointDb.mergeElements(wpChunks[0].batch);
+		}
+		else
+		{
+			waypointDb.replaceElements(wpChunks[0].batch);
 		}
 	}
 	else
 	{
-		fileStream.clear();
-		cout << "WARNING: Error opening the file to read - " << fileName << endl;
+		cout << "WARNING: Error opening the file to read - " << wpFileName << endl;
 		ret = false;
 	}
 
-	fileStream.close();
-
-	fileName = this->mediaName + "-poi.txt";
-	fileStream.precision(10);
-	fileStream.clear();
-
 	// Read POIs
-	fileStream.open(fileName.c_str(), ifstream::in);
-
 	// is the open successful?
-	if (!fileStream.fail())
+	if (isPoiOpen)
 	{
-		string			readLine;
-
-		this->lineCounter = 0;
+		if (!printRequest("POI", mode))
+		{
+			return false;
+		}
 
-		cout << "=======================================================\n";
+		printMessages(poiChunks);
 
+		// load and index all the POIs of the file at once
 		if (mode == CCSV::MERGE)
 		{
-			cout << "INFO: POI Database Merge Request.\n";
-		}
-		else if (mode == CCSV::REPLACE)
-		{
-			poiDb.resetPoisDatabase();
-			cout << "INFO: POI Database Replace Request.\n";
+			poiDb.mergeElements(poiChunks[0].batch);
 		}
 		else
 		{
-			cout << "ERROR: POI Database Unknown MergeMode Request.\n";
-			return false;
+			poiDb.replaceElements(poiChunks[0].batch);
 		}
 
-		cout << "=======================================================\n";
-
-		while (!fileStream.eof())
-		{
-			getline(fileStream, readLine, '\n');
-			this->lineCounter++;
-
-			if (readLine.length() == 0)
-			{
-				// empty line - ignore them
-				cout << "ERROR: Empty line in line " << this->lineCounter << "\n";
-				continue;
-			}
-
-			if (fileStream.fail())
-			{
-				fileStream.clear();
-				cout << "ERROR: Reading a POI from the file - " << fileName << endl;
-				ret = false;
-			}
-			else
-			{
-				CPOI::t_poi		type;
-				string			name, description;
-				double 			latitude = (LATITUDE_MAX + 1), longitude = (LONGITUDE_MAX  + 1);	// set to invalid values
-
-				if (!this->parserEachLine(readLine, type, name, description, latitude, longitude, this->lineCounter))
-				{
-					continue;
-				}
-
-				CPOI poi(type, name, description, latitude, longitude);
-
-				if (!poi.getName().empty())
-				{
-					poiDb.addPoi(poi.getName(), poi);
-				}
-				else
-				{
-					cout << "ERROR: Invalid Waypoint in line " << this->lineCounter << ": " << readLine << "\n";
-				}
-			}
-		}
+		poiDb.buildSpatialIndex();
 	}
 	else
 	{
-		fileStream.clear();
-		cout << "WARNING: Error opening the file to read - " << fileName << endl;
+		cout << "WARNING: Error opening the file to read - " << poiFileName << endl;
 		ret = false;
 	}
 
-	fileStream.close();
-
 	return ret;
 }
@@ -27,9 +27,9 @@ private:
 	std::string 					mediaName;
 
 	/**
-	 * Line number of Database which is currently Parsing
+	 * Number of threads which parse the files, 0 for all the cores
 	 */
-	unsigned int 	lineCounter;
+	unsigned int 	threadCount;
 
 public:
 	/**
@@ -51,6 +51,16 @@ public:
     * @returnval void
 	*/
     void setMediaName(std::string name);
+
+    /**
+    * Set the number of threads which parse the files. A file is split into
+	* chunks at line ends, one per thread; the waypoint and the POI file are
+	* parsed at the same time. The result does not depend on the number.
+	*
+    * @param threads number of threads, 0 for all the cores (default), 1 to parse on the calling thread
+    * @returnval void
+	*/
+    void setThreadCount(unsigned int threads);
 	
     /**
     * Write the data to the persistent storage.
@@ -68,6 +78,9 @@ public:
 	* bases. If merge mode is REPLACE, already existing content
 	* will be removed before inserting the content from the persistent
 	* storage.
+	* A key which is in the file more than once keeps its first element,
+	* a key which is already in the data base keeps the existing element;
+	* the rejected elements are reported.
 	*
     * @param waypointDb the the data base with way points
 	* @param poiDb the database with points of interest
@@ -0,0 +1,1076 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CContractionHierarchy.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CContractionHierarchy.
+* 					The class CContractionHierarchy is used to answer
+* 					shortest path queries on a road graph in a fraction
+* 					of the time of Dijkstra or A*.
+*
+****************************************************************************/
+
+//System Include Files
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <queue>
+#include <limits>
+#include <cstring>
+
+//Own Include Files
+#include "CContractionHierarchy.h"
+
+//Namespaces
+using namespace std;
+
+//Macros
+// nodes a witness search may settle and edges a witness may have before a shortcut is added
+// anyway; the simulated contractions for the priorities only need an estimate
+#define WITNESS_SETTLE_LIMIT		300
+#define WITNESS_HOP_LIMIT			5
+#define SIMULATION_SETTLE_LIMIT		20
+#define SIMULATION_HOP_LIMIT		2
+
+// first bytes of a hierarchy file and version of the format
+#define HIERARCHY_FILE_ID		"NAVSYSCH"
+#define HIERARCHY_FILE_VERSION	1
+
+typedef CRoadGraph::Node_t		Node_t;
+
+/**
+ * An edge of the graph during the contraction
+ */
+struct ContractionEdge
+{
+	Node_t		node;
+	double		length;
+	Node_t		middle;
+};
+
+/**
+ * The graph of the nodes which are not contracted yet, with the state of the witness searches
+ */
+struct ContractionGraph
+{
+	vector<vector<ContractionEdge> >		out;
+	vector<vector<ContractionEdge> >		in;
+	vector<unsigned int>			levels;
+	vector<unsigned int>			deletedNeighbours;
+	vector<double>					distances;
+	vector<unsigned int>			hops;
+	vector<unsigned int>			reached;
+	unsigned int					query;
+	vector<unsigned int>			targets;
+	unsigned int					contraction;
+	vector<pair<double, Node_t> >	queue;
+};
+
+/**
+ * Add an edge to the work graph or shorten the existing one
+ * param@ ContractionGraph &work		-	work graph					(IN/OUT)
+ * param@ Node_t from			-	start of the edge			(IN)
+ * param@ Node_t to				-	end of the edge				(IN)
+ * param@ double length			-	length of the edge			(IN)
+ * param@ Node_t middle			-	node skipped by a shortcut	(IN)
+ * returnvalue@ void
+ */
+static void addContractionEdge(ContractionGraph &work, Node_t from, Node_t to, double length, Node_t middle)
+{
+	vector<ContractionEdge> &out = work.out[from];
+
+	for (unsigned int index = 0; index < out.size(); index++)
+	{
+		if (out[index].node == to)
+		{
+			if (length < out[index].length)
+			{
+				vector<ContractionEdge> &in = work.in[to];
+
+				out[index].length = length;
+				out[index].middle = middle;
+
+				for (unsigned int other = 0; other < in.size(); other++)
+				{
+					if (in[other].node == from)
+					{
+						in[other].length = length;
+						in[other].middle = middle;
+					}
+				}
+			}
+
+			return;
+		}
+	}
+
+	ContractionEdge edge;
+
+	edge.node 	= to;
+	edge.length = length;
+	edge.middle = middle;
+	out.push_back(edge);
+
+	edge.node 	= from;
+	work.in[to].push_back(edge);
+}
+
+/**
+ * Remove the edges to a node from a list of edges
+ * param@ vector<ContractionEdge> &edges	-	list of edges		(IN/OUT)
+ * param@ Node_t node				-	node to be removed	(IN)
+ * returnvalue@ void
+ */
+static void removeContractionEdge(vector<ContractionEdge> &edges, Node_t node)
+{
+	for (unsigned int index = 0; index < edges.size(); )
+	{
+		if (edges[index].node == node)
+		{
+			edges[index] = edges.back();
+			edges.pop_back();
+		}
+		else
+		{
+			index++;
+		}
+	}
+}
+
+/**
+ * Check if a list of edges has an edge to a node
+ * param@ vector<ContractionEdge> const &edges	-	list of edges	(IN)
+ * param@ Node_t node				-	node			(IN)
+ * returnvalue@ bool
+ */
+static bool hasContractionEdge(vector<ContractionEdge> const &edges, Node_t node)
+{
+	for (unsigned int index = 0; index < edges.size(); index++)
+	{
+		if (edges[index].node == node)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Search the shortest distances from a node without passing the node to be contracted.
+ * The search stops when the targets, the nodes marked with the current contraction, are
+ * settled, at the given distance or after the given number of settled nodes. It does not
+ * follow paths of more than the given number of edges: a witness which is not found only
+ * costs a shortcut which is not needed.
+ * param@ ContractionGraph &work		-	work graph						(IN/OUT)
+ * param@ Node_t source				-	start of the search				(IN)
+ * param@ Node_t excluded			-	node to be contracted			(IN)
+ * param@ unsigned int targetCount	-	number of targets				(IN)
+ * param@ double maxDistance		-	longest distance of interest	(IN)
+ * param@ unsigned int settleLimit	-	most nodes to be settled		(IN)
+ * param@ unsigned int hopLimit		-	most edges of a witness			(IN)
+ * returnvalue@ void
+ */
+static void searchWitnesses(ContractionGraph &work, Node_t source, Node_t excluded, unsigned int targetCount, double maxDistance,
+							unsigned int settleLimit, unsigned int hopLimit)
+{
+	vector<pair<double, Node_t> > 	&queue 		= work.queue;
+	greater<pair<double, Node_t> > 	isFurther;
+	unsigned int 					settled 	= 0;
+
+	if (++work.query == 0)
+	{
+		fill(work.reached.begin(), work.reached.end(), 0);
+		work.query = 1;
+	}
+
+	work.distances[source] 	= 0;
+	work.hops[source] 		= 0;
+	work.reached[source] 	= work.query;
+	queue.assign(1, make_pair(0.0, source));
+
+	while (!queue.empty())
+	{
+		pop_heap(queue.begin(), queue.end(), isFurther);
+
+		double 	distance 	= queue.back().first;
+		Node_t 	node 		= queue.back().second;
+
+		queue.pop_back();
+
+		if (distance > work.distances[node])
+		{
+			continue;
+		}
+
+		if ((distance > maxDistance) || (++settled > settleLimit))
+		{
+			break;
+		}
+
+		// the distances to all the targets are known
+		if ((work.targets[node] == work.contraction) && (node != source) && !--targetCount)
+		{
+			break;
+		}
+
+		if (work.hops[node] >= hopLimit)
+		{
+			continue;
+		}
+
+		for (unsigned int index = 0; index < work.out[node].size(); index++)
+		{
+			ContractionEdge const 	&edge 		= work.out[node][index];
+			double 			next 		= distance + edge.length;
+
+			if ((edge.node != excluded) && ((work.reached[edge.node] != work.query) || (next < work.distances[edge.node])))
+			{
+				work.distances[edge.node] 	= next;
+				work.hops[edge.node] 		= work.hops[node] + 1;
+				work.reached[edge.node] 	= work.query;
+				queue.push_back(make_pair(next, edge.node));
+				push_heap(queue.begin(), queue.end(), isFurther);
+			}
+		}
+	}
+}
+
+/**
+ * Contract a node: add a shortcut between its neighbours wherever it lies on their shortest path
+ * param@ ContractionGraph &work		-	work graph										(IN/OUT)
+ * param@ Node_t node			-	node to be contracted							(IN)
+ * param@ bool isSimulation		-	true to count the shortcuts without adding them	(IN)
+ * returnvalue@ unsigned int	-	number of shortcuts
+ */
+static unsigned int contractNode(ContractionGraph &work, Node_t node, bool isSimulation)
+{
+	unsigned int shortcuts = 0;
+
+	// the ends of the outgoing edges are the targets of the witness searches
+	if (++work.contraction == 0)
+	{
+		fill(work.targets.begin(), work.targets.end(), 0);
+		work.contraction = 1;
+	}
+
+	for (unsigned int out = 0; out < work.out[node].size(); out++)
+	{
+		work.targets[work.out[node][out].node] = work.contraction;
+	}
+
+	for (unsigned int in = 0; in < work.in[node].size(); in++)
+	{
+		Node_t 			from 		= work.in[node][in].node;
+		double 			toNode 		= work.in[node][in].length;
+		double 			maxDistance = -1;
+		unsigned int 	targetCount = work.out[node].size() - (work.targets[from] == work.contraction);
+
+		for (unsigned int out = 0; out < work.out[node].size(); out++)
+		{
+			if (work.out[node][out].node != from)
+			{
+				maxDistance = max(maxDistance, toNode + work.out[node][out].length);
+			}
+		}
+
+		if (maxDistance < 0)
+		{
+			continue;
+		}
+
+		if (isSimulation)
+		{
+			searchWitnesses(work, from, node, targetCount, maxDistance, SIMULATION_SETTLE_LIMIT, SIMULATION_HOP_LIMIT);
+		}
+		else
+		{
+			searchWitnesses(work, from, node, targetCount, maxDistance, WITNESS_SETTLE_LIMIT, WITNESS_HOP_LIMIT);
+		}
+
+		for (unsigned int out = 0; out < work.out[node].size(); out++)
+		{
+			Node_t to 		= work.out[node][out].node;
+			double length 	= toNode + work.out[node][out].length;
+
+			if ((to != from) && ((work.reached[to] != work.query) || (work.distances[to] > length)))
+			{
+				shortcuts++;
+
+				if (!isSimulation)
+				{
+					addContractionEdge(work, from, to, length, node);
+				}
+			}
+		}
+	}
+
+	return shortcuts;
+}
+
+/**
+ * Importance of a node: the number of shortcuts its contraction adds minus the edges it removes,
+ * plus its contracted neighbours and its level, i.e. the longest chain of contracted nodes below
+ * it. The last two spread the contraction evenly over the graph, which keeps the query searches small.
+ * param@ ContractionGraph &work		-	work graph		(IN/OUT)
+ * param@ Node_t node			-	node			(IN)
+ * returnvalue@ int
+ */
+static int getPriority(ContractionGraph &work, Node_t node)
+{
+	int edgeDifference = (int)contractNode(work, node, true) - (int)(work.in[node].size() + work.out[node].size());
+
+	return (edgeDifference + (int)work.deletedNeighbours[node] + (int)work.levels[node]);
+}
+
+/**
+ * Move the edges of all the nodes into a CSR array
+ * param@ vector<vector<TEdge> > &lists		-	edges of every node, emptied	(IN/OUT)
+ * param@ vector<unsigned int> &offsets		-	first edge of every node		(OUT)
+ * param@ vector<TEdge> &edges				-	edges							(OUT)
+ * returnvalue@ void
+ */
+template<class TEdge>
+static void appendEdges(vector<vector<TEdge> > &lists, vector<unsigned int> &offsets, vector<TEdge> &edges)
+{
+	offsets.assign(1, 0);
+
+	for (unsigned int node = 0; node < lists.size(); node++)
+	{
+		edges.insert(edges.end(), lists[node].begin(), lists[node].end());
+		offsets.push_back(edges.size());
+		vector<TEdge>().swap(lists[node]);
+	}
+}
+
+
+//Method Implementations
+/**
+ * CContractionHierarchy constructor
+ */
+CContractionHierarchy::CContractionHierarchy()
+{
+	this->m_query = 0;
+	this->clear();
+}
+
+
+/**
+ * CContractionHierarchy destructor
+ */
+CContractionHierarchy::~CContractionHierarchy()
+{
+	// do nothing
+}
+
+
+/**
+ * Drop the current hierarchy and contract all the nodes of the road graph.
+ * The nodes keep the numbers of the built road graph.
+ * param@ CRoadGraph &graph				-	road graph		(IN)
+ * returnvalue@ void
+ */
+void CContractionHierarchy::build(CRoadGraph &graph)
+{
+	vector<Wp_Database_key_t> 	names;
+	ContractionGraph 					work;
+
+	this->clear();
+	graph.build();
+
+	unsigned int nodeCount = graph.getNodeCount();
+
+	work.out.resize(nodeCount);
+	work.in.resize(nodeCount);
+	work.levels.assign(nodeCount, 0);
+	work.deletedNeighbours.assign(nodeCount, 0);
+	work.distances.resize(nodeCount);
+	work.hops.resize(nodeCount);
+	work.reached.assign(nodeCount, 0);
+	work.query = 0;
+	work.targets.assign(nodeCount, 0);
+	work.contraction = 0;
+
+	for (Node_t node = 0; node < nodeCount; node++)
+	{
+		unsigned int begin, end;
+
+		names.push_back(graph.getName(node));
+		graph.getEdges(node, begin, end);
+
+		for (unsigned int edge = begin; edge < end; edge++)
+		{
+			if (graph.getEdgeTarget(edge) != node)
+			{
+				addContractionEdge(work, node, graph.getEdgeTarget(edge), graph.getEdgeLength(edge), CRoadGraph::INVALID_NODE);
+			}
+		}
+	}
+
+	this->setNames(names);
+
+	// the least important node first; a priority is only computed again when its node is on top
+	priority_queue<pair<int, Node_t>, vector<pair<int, Node_t> >, greater<pair<int, Node_t> > > queue;
+
+	for (Node_t node = 0; node < nodeCount; node++)
+	{
+		queue.push(make_pair(getPriority(work, node), node));
+	}
+
+	vector<vector<Edge> > 	upward(nodeCount), downward(nodeCount);
+	unsigned int 			rank = 0;
+
+	this->m_ranks.assign(nodeCount, 0);
+
+	while (!queue.empty())
+	{
+		Node_t 	node 		= queue.top().second;
+
+		queue.pop();
+
+		// the contractions around the node may have made it more important: it waits for its turn again
+		int 	priority 	= getPriority(work, node);
+
+		if (!queue.empty() && (priority > queue.top().first))
+		{
+			queue.push(make_pair(priority, node));
+			continue;
+		}
+
+		contractNode(work, node, false);
+		this->m_ranks[node] = rank++;
+
+		// the remaining edges lead to nodes of a higher rank
+		for (unsigned int index = 0; index < work.out[node].size(); index++)
+		{
+			ContractionEdge const &workEdge = work.out[node][index];
+			Edge 			edge;
+
+			edge.node 	= workEdge.node;
+			edge.length = workEdge.length;
+			edge.middle = workEdge.middle;
+			upward[node].push_back(edge);
+
+			removeContractionEdge(work.in[workEdge.node], node);
+			work.levels[workEdge.node] = max(work.levels[workEdge.node], work.levels[node] + 1);
+			work.deletedNeighbours[workEdge.node]++;
+		}
+
+		for (unsigned int index = 0; index < work.in[node].size(); index++)
+		{
+			ContractionEdge const &workEdge = work.in[node][index];
+			Edge 			edge;
+
+			edge.node 	= workEdge.node;
+			edge.length = workEdge.length;
+			edge.middle = workEdge.middle;
+			downward[node].push_back(edge);
+
+			removeContractionEdge(work.out[workEdge.node], node);
+			work.levels[workEdge.node] = max(work.levels[workEdge.node], work.levels[node] + 1);
+
+			// a neighbour on both sides is counted once
+			if (!hasContractionEdge(work.out[node], workEdge.node))
+			{
+				work.deletedNeighbours[workEdge.node]++;
+			}
+		}
+
+		vector<ContractionEdge>().swap(work.out[node]);
+		vector<ContractionEdge>().swap(work.in[node]);
+	}
+
+	appendEdges(upward, this->m_upward.offsets, this->m_upward.edges);
+	appendEdges(downward, this->m_downward.offsets, this->m_downward.edges);
+
+	for (unsigned int index = 0; index < this->m_upward.edges.size(); index++)
+	{
+		this->m_shortcutCount += (this->m_upward.edges[index].middle != CRoadGraph::INVALID_NODE);
+	}
+
+	for (unsigned int index = 0; index < this->m_downward.edges.size(); index++)
+	{
+		this->m_shortcutCount += (this->m_downward.edges[index].middle != CRoadGraph::INVALID_NODE);
+	}
+
+	this->resetSearches();
+}
+
+
+/**
+ * Save the hierarchy to a binary file
+ * param@ std::string const &fileName	-	name of the file	(IN)
+ * returnvalue@ bool					-	false if the file cannot be written
+ */
+bool CContractionHierarchy::writeToFile(std::string const &fileName) const
+{
+	ofstream 	file(fileName.c_str(), ios::binary);
+	unsigned int version = HIERARCHY_FILE_VERSION;
+	unsigned int nodeCount = this->m_names.size();
+
+	if (!file)
+	{
+		cout << "ERROR: The file \"" << fileName << "\" cannot be opened for writing.\n";
+		return false;
+	}
+
+	file.write(HIERARCHY_FILE_ID, strlen(HIERARCHY_FILE_ID));
+	file.write(reinterpret_cast<char const *>(&version), sizeof(version));
+	file.write(reinterpret_cast<char const *>(&nodeCount), sizeof(nodeCount));
+
+	for (unsigned int node = 0; node < nodeCount; node++)
+	{
+		unsigned int length = this->m_names[node]->size();
+
+		file.write(reinterpret_cast<char const *>(&length), sizeof(length));
+		file.write(this->m_names[node]->data(), length);
+	}
+
+	writeArray(file, this->m_ranks);
+	writeArray(file, this->m_upward.offsets);
+	writeArray(file, this->m_upward.edges);
+	writeArray(file, this->m_downward.offsets);
+	writeArray(file, this->m_downward.edges);
+
+	if (!file)
+	{
+		cout << "ERROR: The contraction hierarchy could not be written to \"" << fileName << "\".\n";
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * Load a hierarchy saved by writeToFile
+ * param@ std::string const &fileName	-	name of the file	(IN)
+ * returnvalue@ bool					-	false if the file cannot be read or is not a hierarchy
+ */
+bool CContractionHierarchy::readFromFile(std::string const &fileName)
+{
+	ifstream 					file(fileName.c_str(), ios::binary);
+	char 						fileId[sizeof(HIERARCHY_FILE_ID)] = { 0 };
+	unsigned int 				version = 0, nodeCount = 0;
+	vector<Wp_Database_key_t> 	names;
+	bool 						isValid;
+
+	this->clear();
+
+	if (!file)
+	{
+		cout << "ERROR: The file \"" << fileName << "\" cannot be opened for reading.\n";
+		return false;
+	}
+
+	file.read(fileId, strlen(HIERARCHY_FILE_ID));
+	file.read(reinterpret_cast<char *>(&version), sizeof(version));
+	file.read(reinterpret_cast<char *>(&nodeCount), sizeof(nodeCount));
+
+	isValid = file && !strcmp(fileId, HIERARCHY_FILE_ID) && (version == HIERARCHY_FILE_VERSION);
+
+	for (unsigned int node = 0; isValid && (node < nodeCount); node++)
+	{
+		unsigned int 	length = 0;
+		string 			name;
+
+		isValid = (file.read(reinterpret_cast<char *>(&length), sizeof(length)) && (length < (1u << 16)));
+
+		if (isValid)
+		{
+			name.resize(length);
+			isValid = (length == 0) || file.read(&name[0], length);
+			names.push_back(name);
+		}
+	}
+
+	isValid = isValid
+			  && readArray(file, this->m_ranks)
+			  && readArray(file, this->m_upward.offsets)
+			  && readArray(file, this->m_upward.edges)
+			  && readArray(file, this->m_downward.offsets)
+			  && readArray(file, this->m_downward.edges)
+			  && (this->m_ranks.size() == nodeCount)
+			  && (this->m_upward.offsets.size() == nodeCount + 1) && (this->m_upward.offsets.back() == this->m_upward.edges.size())
+			  && (this->m_downward.offsets.size() == nodeCount + 1) && (this->m_downward.offsets.back() == this->m_downward.edges.size());
+
+	// the queries must not leave the arrays
+	for (unsigned int node = 0; isValid && (node < nodeCount); node++)
+	{
+		isValid = (this->m_upward.offsets[node] <= this->m_upward.offsets[node + 1])
+				  && (this->m_downward.offsets[node] <= this->m_downward.offsets[node + 1]);
+	}
+
+	// the ranks are a permutation of the nodes
+	vector<bool> isRankUsed(isValid ? nodeCount : 0, false);
+
+	for (unsigned int node = 0; isValid && (node < nodeCount); node++)
+	{
+		isValid = (this->m_ranks[node] < nodeCount) && !isRankUsed[this->m_ranks[node]];
+
+		if (isValid)
+		{
+			isRankUsed[this->m_ranks[node]] = true;
+		}
+	}
+
+	// the searches and the unpacking of the shortcuts rely on the order of the ranks
+	isValid = isValid && this->hasValidEdges(this->m_upward) && this->hasValidEdges(this->m_downward);
+
+	if (!isValid)
+	{
+		cout << "ERROR: The file \"" << fileName << "\" is not a valid contraction hierarchy.\n";
+		this->clear();
+		return false;
+	}
+
+	this->setNames(names);
+	this->resetSearches();
+
+	return true;
+}
+
+
+/**
+ * Check the edges of a file against the ranks: every edge goes to a node of a higher rank
+ * than the node it is stored at, and a shortcut skips a node of a lower rank. The offsets
+ * must be checked before. Counts the shortcuts.
+ * param@ EdgeArray const &edges		-	upward or downward edges	(IN)
+ * returnvalue@ bool					-	false if an edge leaves the nodes or the order of the ranks
+ */
+bool CContractionHierarchy::hasValidEdges(EdgeArray const &edges)
+{
+	unsigned int nodeCount = this->m_ranks.size();
+
+	for (unsigned int owner = 0; owner < nodeCount; owner++)
+	{
+		for (unsigned int index = edges.offsets[owner]; index < edges.offsets[owner + 1]; index++)
+		{
+			Edge const &edge = edges.edges[index];
+
+			if ((edge.node >= nodeCount) || (this->m_ranks[edge.node] <= this->m_ranks[owner]))
+			{
+				return false;
+			}
+
+			if (edge.middle != CRoadGraph::INVALID_NODE)
+			{
+				// the shortcut was added when its middle node was contracted, before both of its ends
+				if ((edge.middle >= nodeCount) || (this->m_ranks[edge.middle] >= this->m_ranks[owner]))
+				{
+					return false;
+				}
+
+				this->m_shortcutCount++;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Number of nodes
+ * returnvalue@ unsigned int
+ */
+unsigned int CContractionHierarchy::getNodeCount() const
+{
+	return this->m_names.size();
+}
+
+
+/**
+ * Number of edges of the hierarchy, including the shortcuts
+ * returnvalue@ unsigned int
+ */
+unsigned int CContractionHierarchy::getEdgeCount() const
+{
+	return (this->m_upward.edges.size() + this->m_downward.edges.size());
+}
+
+
+/**
+ * Number of shortcuts added by the contraction
+ * returnvalue@ unsigned int
+ */
+unsigned int CContractionHierarchy::getShortcutCount() const
+{
+	return this->m_shortcutCount;
+}
+
+
+/**
+ * Get the node of the given name
+ * param@ std::string_view name		-	name of the node	(IN)
+ * returnvalue@ Node_t					-	node, CRoadGraph::INVALID_NODE if the name is unknown
+ */
+CContractionHierarchy::Node_t CContractionHierarchy::getNode(string_view name) const
+{
+	Wp_Database_key_t key;
+
+	// a name which is not in the string pool is not the name of any node
+	if (!Wp_Database_key_t::find(name, key))
+	{
+		return CRoadGraph::INVALID_NODE;
+	}
+
+	map<Wp_Database_key_t, Node_t>::const_iterator itr = this->m_nodes.find(key);
+
+	return ((itr != this->m_nodes.end()) ? itr->second : CRoadGraph::INVALID_NODE);
+}
+
+
+/**
+ * Get the name of a node
+ * param@ Node_t node						-	node	(IN)
+ * returnvalue@ Wp_Database_key_t const&	-	name of the node
+ */
+Wp_Database_key_t const& CContractionHierarchy::getName(Node_t node) const
+{
+	return *this->m_names[node];
+}
+
+
+/**
+ * Find the shortest path between two nodes given by their names
+ * param@ std::string_view from		-	start of the path				(IN)
+ * param@ std::string_view to			-	end of the path					(IN)
+ * param@ Name_Path_t &path				-	names of the nodes of the path	(OUT)
+ * param@ double &length				-	length of the path in KMs		(OUT)
+ * returnvalue@ bool					-	false if there is no path
+ */
+bool CContractionHierarchy::findPath(string_view from, string_view to, Name_Path_t &path, double &length)
+{
+	Path_t	nodes;
+	Node_t	source = this->getNode(from);
+	Node_t	target = this->getNode(to);
+
+	path.clear();
+
+	if ((source == CRoadGraph::INVALID_NODE) || (target == CRoadGraph::INVALID_NODE))
+	{
+		cout << "WARNING: The path from \"" << from << "\" to \"" << to << "\" has no node in the contraction hierarchy.\n";
+		return false;
+	}
+
+	if (!this->findPath(source, target, nodes, length))
+	{
+		return false;
+	}
+
+	for (unsigned int index = 0; index < nodes.size(); index++)
+	{
+		path.push_back(this->getName(nodes[index]));
+	}
+
+	return true;
+}
+
+
+/**
+ * Find the shortest path between two nodes.
+ * The search state is reused between the queries: the method is not thread safe.
+ * param@ Node_t source					-	start of the path				(IN)
+ * param@ Node_t target					-	end of the path					(IN)
+ * param@ Path_t &path					-	nodes of the path				(OUT)
+ * param@ double &length				-	length of the path in KMs		(OUT)
+ * returnvalue@ bool					-	false if there is no path
+ */
+bool CContractionHierarchy::findPath(Node_t source, Node_t target, Path_t &path, double &length)
+{
+	path.clear();
+	this->m_settledCount = 0;
+
+	if ((source >= this->m_names.size()) || (target >= this->m_names.size()))
+	{
+		return false;
+	}
+
+	// a new query number marks all the distances as unknown
+	if (++this->m_query == 0)
+	{
+		fill(this->m_forward.reached.begin(), this->m_forward.reached.end(), 0);
+		fill(this->m_backward.reached.begin(), this->m_backward.reached.end(), 0);
+		this->m_query = 1;
+	}
+
+	Search 		*searches[] = { &this->m_forward, &this->m_backward };
+	Node_t 		starts[] 	= { source, target };
+	double 		shortest 	= numeric_limits<double>::max();
+	Node_t 		meeting 	= CRoadGraph::INVALID_NODE;
+
+	for (unsigned int direction = 0; direction < 2; direction++)
+	{
+		Search 		&search = *searches[direction];
+		QueueEntry 	entry;
+
+		entry.distance 	= 0;
+		entry.node 		= starts[direction];
+
+		search.distances[entry.node] 	= 0;
+		search.parents[entry.node] 		= CRoadGraph::INVALID_NODE;
+		search.reached[entry.node] 		= this->m_query;
+		search.queue.assign(1, entry);
+	}
+
+	if (source == target)
+	{
+		shortest 	= 0;
+		meeting 	= source;
+	}
+
+	// advance the direction with the closer node until no shorter path is possible
+	while (true)
+	{
+		double forward 	= this->m_forward.queue.empty() ? numeric_limits<double>::max() : this->m_forward.queue.front().distance;
+		double backward = this->m_backward.queue.empty() ? numeric_limits<double>::max() : this->m_backward.queue.front().distance;
+
+		if (min(forward, backward) >= shortest)
+		{
+			break;
+		}
+
+		if (forward <= backward)
+		{
+			this->advance(this->m_forward, this->m_upward, this->m_downward, this->m_backward, shortest, meeting);
+		}
+		else
+		{
+			this->advance(this->m_backward, this->m_downward, this->m_upward, this->m_forward, shortest, meeting);
+		}
+	}
+
+	if (meeting == CRoadGraph::INVALID_NODE)
+	{
+		return false;
+	}
+
+	// source ... meeting over the upward edges
+	vector<Node_t> upwardPath;
+
+	for (Node_t node = meeting; node != source; node = this->m_forward.parents[node])
+	{
+		upwardPath.push_back(node);
+	}
+
+	path.push_back(source);
+
+	for (unsigned int index = upwardPath.size(); index > 0; index--)
+	{
+		Node_t 		node = upwardPath[index - 1];
+		Node_t 		from = this->m_forward.parents[node];
+
+		this->unpack(from, node, this->m_upward.edges[this->m_forward.parentEdges[node]].middle, path);
+	}
+
+	// meeting ... target over the downward edges
+	for (Node_t node = meeting; node != target; node = this->m_backward.parents[node])
+	{
+		Node_t to = this->m_backward.parents[node];
+
+		this->unpack(node, to, this->m_downward.edges[this->m_backward.parentEdges[node]].middle, path);
+	}
+
+	length = shortest;
+
+	return true;
+}
+
+
+/**
+ * Number of nodes settled by the last query, both directions together
+ * returnvalue@ unsigned int
+ */
+unsigned int CContractionHierarchy::getSettledCount() const
+{
+	return this->m_settledCount;
+}
+
+
+/**
+ * Order of the priority queues: std heaps keep the largest element on top, so the comparison is reversed
+ * param@ QueueEntry const &rhs		-	other entry		(IN)
+ * returnvalue@ bool				-	true if this entry is further away
+ */
+bool CContractionHierarchy::QueueEntry::operator<(QueueEntry const &rhs) const
+{
+	return (this->distance > rhs.distance);
+}
+
+
+/**
+ * Remove the hierarchy
+ * returnvalue@ void
+ */
+void CContractionHierarchy::clear()
+{
+	this->m_nodes.clear();
+	vector<Wp_Database_key_t const *>().swap(this->m_names);
+	vector<unsigned int>().swap(this->m_ranks);
+
+	this->m_upward.offsets.assign(1, 0);
+	this->m_downward.offsets.assign(1, 0);
+	Edge_Container_t().swap(this->m_upward.edges);
+	Edge_Container_t().swap(this->m_downward.edges);
+
+	this->m_shortcutCount 	= 0;
+	this->m_settledCount 	= 0;
+	this->resetSearches();
+}
+
+
+/**
+ * Add a name for every node
+ * param@ std::vector<Wp_Database_key_t> const &names	-	names of the nodes	(IN)
+ * returnvalue@ void
+ */
+void CContractionHierarchy::setNames(std::vector<Wp_Database_key_t> const &names)
+{
+	this->m_nodes.clear();
+	this->m_names.clear();
+
+	for (Node_t node = 0; node < names.size(); node++)
+	{
+		this->m_names.push_back(&this->m_nodes.insert(make_pair(names[node], node)).first->first);
+	}
+}
+
+
+/**
+ * Size the query state for the nodes
+ * returnvalue@ void
+ */
+void CContractionHierarchy::resetSearches()
+{
+	Search *searches[] = { &this->m_forward, &this->m_backward };
+
+	for (unsigned int direction = 0; direction < 2; direction++)
+	{
+		searches[direction]->distances.resize(this->m_names.size());
+		searches[direction]->parents.resize(this->m_names.size());
+		searches[direction]->parentEdges.resize(this->m_names.size());
+		searches[direction]->reached.assign(this->m_names.size(), 0);
+		searches[direction]->queue.clear();
+	}
+
+	this->m_query = 0;
+}
+
+
+/**
+ * Settle the closest node of one search direction and relax its edges. A node is stalled, i.e.
+ * its edges are not relaxed, if the search reached it shorter over an edge from a node of a
+ * higher rank: no shortest path goes on from it.
+ * param@ Search &search				-	search direction to advance			(IN)
+ * param@ EdgeArray const &edges		-	edges of the search direction		(IN)
+ * param@ EdgeArray const &stallEdges	-	edges of the other direction		(IN)
+ * param@ Search const &opposite		-	the other search direction			(IN)
+ * param@ double &shortest				-	shortest path found so far			(IN/OUT)
+ * param@ Node_t &meeting				-	node where the searches meet		(IN/OUT)
+ * returnvalue@ void
+ */
+void CContractionHierarchy::advance(Search &search, EdgeArray const &edges, EdgeArray const &stallEdges, Search const &opposite, double &shortest, Node_t &meeting)
+{
+	pop_heap(search.queue.begin(), search.queue.end());
+
+	QueueEntry entry = search.queue.back();
+
+	search.queue.pop_back();
+
+	// a shorter way to the node has been found after this entry was queued
+	if (entry.distance > search.distances[entry.node])
+	{
+		return;
+	}
+
+	this->m_settledCount++;
+
+	// the edges of the other direction at the node come from the nodes of a higher rank
+	for (unsigned int index = stallEdges.offsets[entry.node]; index < stallEdges.offsets[entry.node + 1]; index++)
+	{
+		Edge const &edge = stallEdges.edges[index];
+
+		if ((search.reached[edge.node] == this->m_query) && (search.distances[edge.node] + edge.length < entry.distance))
+		{
+			return;
+		}
+	}
+
+	for (unsigned int index = edges.offsets[entry.node]; index < edges.offsets[entry.node + 1]; index++)
+	{
+		Edge const 	&edge 		= edges.edges[index];
+		double 		distance 	= entry.distance + edge.length;
+
+		if ((search.reached[edge.node] != this->m_query) || (distance < search.distances[edge.node]))
+		{
+			QueueEntry next;
+
+			next.distance 	= distance;
+			next.node 		= edge.node;
+
+			search.distances[edge.node] 	= distance;
+			search.parents[edge.node] 		= entry.node;
+			search.parentEdges[edge.node] 	= index;
+			search.reached[edge.node] 		= this->m_query;
+			search.queue.push_back(next);
+			push_heap(search.queue.begin(), search.queue.end());
+
+			// the searches meet
+			if ((opposite.reached[edge.node] == this->m_query) && (distance + opposite.distances[edge.node] < shortest))
+			{
+				shortest 	= distance + opposite.distances[edge.node];
+				meeting 	= edge.node;
+			}
+		}
+	}
+}
+
+
+/**
+ * Append the nodes of an edge of the hierarchy after its start, replacing the shortcuts by the original edges
+ * param@ Node_t from					-	start of the edge								(IN)
+ * param@ Node_t to						-	end of the edge									(IN)
+ * param@ Node_t middle					-	node skipped by a shortcut, INVALID_NODE else	(IN)
+ * param@ Path_t &path					-	path to be extended								(IN/OUT)
+ * returnvalue@ void
+ */
+void CContractionHierarchy::unpack(Node_t from, Node_t to, Node_t middle, Path_t &path) const
+{
+	if (middle == CRoadGraph::INVALID_NODE)
+	{
+		path.push_back(to);
+	}
+	else
+	{
+		this->unpack(from, middle, this->findMiddle(from, middle), path);
+		this->unpack(middle, to, this->findMiddle(middle, to), path);
+	}
+}
+
+
+/**
+ * Find the node skipped by the edge between two nodes of the hierarchy
+ * param@ Node_t from					-	start of the edge		(IN)
+ * param@ Node_t to						-	end of the edge			(IN)
+ * returnvalue@ Node_t					-	skipped node, INVALID_NODE for an original edge
+ */
+CContractionHierarchy::Node_t CContractionHierarchy::findMiddle(Node_t from, Node_t to) const
+{
+	// the edge is stored at its node of the lower rank
+	bool 				isUpward 	= (this->m_ranks[from] < this->m_ranks[to]);
+	EdgeArray const 	&edges 		= isUpward ? this->m_upward : this->m_downward;
+	Node_t 				owner 		= isUpward ? from : to;
+	Node_t 				other 		= isUpward ? to : from;
+
+	for (unsigned int index = edges.offsets[owner]; index < edges.offsets[owner + 1]; index++)
+	{
+		if (edges.edges[index].node == other)
+		{
+			return edges.edges[index].middle;
+		}
+	}
+
+	return CRoadGraph::INVALID_NODE;
+}
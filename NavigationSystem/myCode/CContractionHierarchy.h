@@ -0,0 +1,351 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CContractionHierarchy.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CContractionHierarchy.
+* 					The class CContractionHierarchy is used to answer
+* 					shortest path queries on a road graph in a fraction
+* 					of the time of Dijkstra or A*.
+*
+* 					The preprocessing contracts the nodes one after the
+* 					other, the least important first: a contracted node
+* 					is removed from the graph and shortcuts are added
+* 					between its neighbours where it lies on their only
+* 					shortest path. A query searches from both ends and
+* 					only follows edges towards nodes contracted later;
+* 					the two searches meet at the most important node of
+* 					the path. The shortcuts are unpacked at the end.
+*
+* 					The hierarchy can be saved to a binary file and
+* 					loaded without the road graph.
+*
+****************************************************************************/
+
+#ifndef CCONTRACTIONHIERARCHY_H
+#define CCONTRACTIONHIERARCHY_H
+
+//System Include Files
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <iostream>
+#include <algorithm>
+
+//Own Include Files
+#include "CRoadGraph.h"
+
+class CContractionHierarchy {
+public:
+
+	typedef CRoadGraph::Node_t						Node_t;
+	typedef CRoadGraph::Path_t						Path_t;
+	typedef CRoadGraph::Name_Path_t					Name_Path_t;
+
+	/**
+	 * CContractionHierarchy constructor
+	 */
+	CContractionHierarchy();
+
+	/**
+	 * CContractionHierarchy destructor
+	 */
+	~CContractionHierarchy();
+
+	/**
+	 * Drop the current hierarchy and contract all the nodes of the road graph.
+	 * The nodes keep the numbers of the built road graph.
+	 * param@ CRoadGraph &graph				-	road graph		(IN)
+	 * returnvalue@ void
+	 */
+	void build(CRoadGraph &graph);
+
+	/**
+	 * Save the hierarchy to a binary file
+	 * param@ std::string const &fileName	-	name of the file	(IN)
+	 * returnvalue@ bool					-	false if the file cannot be written
+	 */
+	bool writeToFile(std::string const &fileName) const;
+
+	/**
+	 * Load a hierarchy saved by writeToFile
+	 * param@ std::string const &fileName	-	name of the file	(IN)
+	 * returnvalue@ bool					-	false if the file cannot be read or is not a hierarchy
+	 */
+	bool readFromFile(std::string const &fileName);
+
+	/**
+	 * Number of nodes
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getNodeCount() const;
+
+	/**
+	 * Number of edges of the hierarchy, including the shortcuts
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getEdgeCount() const;
+
+	/**
+	 * Number of shortcuts added by the contraction
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getShortcutCount() const;
+
+	/**
+	 * Get the node of the given name
+	 * param@ std::string_view name		-	name of the node	(IN)
+	 * returnvalue@ Node_t					-	node, CRoadGraph::INVALID_NODE if the name is unknown
+	 */
+	Node_t getNode(std::string_view name) const;
+
+	/**
+	 * Get the name of a node
+	 * param@ Node_t node						-	node	(IN)
+	 * returnvalue@ Wp_Database_key_t const&	-	name of the node
+	 */
+	Wp_Database_key_t const& getName(Node_t node) const;
+
+	/**
+	 * Find the shortest path between two nodes given by their names
+	 * param@ std::string_view from		-	start of the path				(IN)
+	 * param@ std::string_view to			-	end of the path					(IN)
+	 * param@ Name_Path_t &path				-	names of the nodes of the path	(OUT)
+	 * param@ double &length				-	length of the path in KMs		(OUT)
+	 * returnvalue@ bool					-	false if there is no path
+	 */
+	bool findPath(std::string_view from, std::string_view to, Name_Path_t &path, double &length);
+
+	/**
+	 * Find the shortest path between two nodes.
+	 * The search state is reused between the queries: the method is not thread safe.
+	 * param@ Node_t source					-	start of the path				(IN)
+	 * param@ Node_t target					-	end of the path					(IN)
+	 * param@ Path_t &path					-	nodes of the path				(OUT)
+	 * param@ double &length				-	length of the path in KMs		(OUT)
+	 * returnvalue@ bool					-	false if there is no path
+	 */
+	bool findPath(Node_t source, Node_t target, Path_t &path, double &length);
+
+	/**
+	 * Number of nodes settled by the last query, both directions together
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getSettledCount() const;
+
+private:
+
+	/**
+	 * An edge of the hierarchy: the other node, the length and the contracted node a shortcut skips
+	 */
+	struct Edge
+	{
+		double		length;
+		Node_t		node;
+		Node_t		middle;
+	};
+
+	typedef std::vector<Edge>						Edge_Container_t;
+
+	/**
+	 * Edges in CSR form: the edges of node i are [offsets[i], offsets[i + 1])
+	 */
+	struct EdgeArray
+	{
+		std::vector<unsigned int>	offsets;
+		Edge_Container_t			edges;
+	};
+
+	/**
+	 * A node in the priority queue of a search
+	 */
+	struct QueueEntry
+	{
+		double		distance;
+		Node_t		node;
+
+		bool operator<(QueueEntry const &rhs) const;
+	};
+
+	/**
+	 * State of one search direction
+	 */
+	struct Search
+	{
+		std::vector<double>			distances;
+		std::vector<Node_t>			parents;
+		std::vector<unsigned int>	parentEdges;
+		std::vector<unsigned int>	reached;
+		std::vector<QueueEntry>		queue;
+	};
+
+	/**
+	 * Node of every name and names of the nodes
+	 */
+	std::map<Wp_Database_key_t, Node_t>		m_nodes;
+	std::vector<Wp_Database_key_t const *>	m_names;
+
+	/**
+	 * Contraction order of every node
+	 */
+	std::vector<unsigned int>				m_ranks;
+
+	/**
+	 * Edges to nodes of a higher rank, stored at their start (forward search)
+	 */
+	EdgeArray								m_upward;
+
+	/**
+	 * Edges from nodes of a higher rank, stored at their end (backward search)
+	 */
+	EdgeArray								m_downward;
+
+	/**
+	 * Number of shortcuts
+	 */
+	unsigned int							m_shortcutCount;
+
+	/**
+	 * Query state: forward and backward search, query number and settled nodes of the last query
+	 */
+	Search									m_forward;
+	Search									m_backward;
+	unsigned int							m_query;
+	unsigned int							m_settledCount;
+
+	/**
+	 * The names point into m_nodes: the hierarchy is not copyable
+	 */
+	CContractionHierarchy(CContractionHierarchy const &origin);
+	CContractionHierarchy& operator=(CContractionHierarchy const &rhs);
+
+	/**
+	 * Remove the hierarchy
+	 * returnvalue@ void
+	 */
+	void clear();
+
+	/**
+	 * Add a name for every node
+	 * param@ std::vector<Wp_Database_key_t> const &names	-	names of the nodes	(IN)
+	 * returnvalue@ void
+	 */
+	void setNames(std::vector<Wp_Database_key_t> const &names);
+
+	/**
+	 * Size the query state for the nodes
+	 * returnvalue@ void
+	 */
+	void resetSearches();
+
+	/**
+	 * Settle the closest node of one search direction and relax its edges. A node is stalled, i.e.
+	 * its edges are not relaxed, if the search reached it shorter over an edge from a node of a
+	 * higher rank: no shortest path goes on from it.
+	 * param@ Search &search				-	search direction to advance			(IN)
+	 * param@ EdgeArray const &edges		-	edges of the search direction		(IN)
+	 * param@ EdgeArray const &stallEdges	-	edges of the other direction		(IN)
+	 * param@ Search const &opposite		-	the other search direction			(IN)
+	 * param@ double &shortest				-	shortest path found so far			(IN/OUT)
+	 * param@ Node_t &meeting				-	node where the searches meet		(IN/OUT)
+	 * returnvalue@ void
+	 */
+	void advance(Search &search, EdgeArray const &edges, EdgeArray const &stallEdges, Search const &opposite, double &shortest, Node_t &meeting);
+
+	/**
+	 * Append the nodes of an edge of the hierarchy after its start, replacing the shortcuts by the original edges
+	 * param@ Node_t from					-	start of the edge								(IN)
+	 * param@ Node_t to						-	end of the edge									(IN)
+	 * param@ Node_t middle					-	node skipped by a shortcut, INVALID_NODE else	(IN)
+	 * param@ Path_t &path					-	path to be extended								(IN/OUT)
+	 * returnvalue@ void
+	 */
+	void unpack(Node_t from, Node_t to, Node_t middle, Path_t &path) const;
+
+	/**
+	 * Find the node skipped by the edge between two nodes of the hierarchy
+	 * param@ Node_t from					-	start of the edge		(IN)
+	 * param@ Node_t to						-	end of the edge			(IN)
+	 * returnvalue@ Node_t					-	skipped node, INVALID_NODE for an original edge
+	 */
+	Node_t findMiddle(Node_t from, Node_t to) const;
+
+	/**
+	 * Check the edges of a file against the ranks: every edge goes to a node of a higher rank
+	 * than the node it is stored at, and a shortcut skips a node of a lower rank. The offsets
+	 * must be checked before. Counts the shortcuts.
+	 * param@ EdgeArray const &edges		-	upward or downward edges	(IN)
+	 * returnvalue@ bool					-	false if an edge leaves the nodes or the order of the ranks
+	 */
+	bool hasValidEdges(EdgeArray const &edges);
+
+	/**
+	 * Write / read an array with its size to / from a binary stream
+	 */
+	template<class T>
+	static void writeArray(std::ostream &stream, std::vector<T> const &array);
+
+	template<class T>
+	static bool readArray(std::istream &stream, std::vector<T> &array);
+};
+/********************
+**  CLASS END
+*********************/
+
+/**
+ * Write an array with its size to a binary stream
+ * param@ std::ostream &stream			-	stream	(IN)
+ * param@ std::vector<T> const &array	-	array	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+void CContractionHierarchy::writeArray(std::ostream &stream, std::vector<T> const &array)
+{
+	unsigned int size = array.size();
+
+	stream.write(reinterpret_cast<char const *>(&size), sizeof(size));
+
+	if (size)
+	{
+		stream.write(reinterpret_cast<char const *>(&array[0]), size * sizeof(T));
+	}
+}
+
+
+/**
+ * Read an array with its size from a binary stream
+ * param@ std::istream &stream			-	stream	(IN)
+ * param@ std::vector<T> &array			-	array	(OUT)
+ * returnvalue@ bool					-	false if the stream ends too early
+ */
+template<class T>
+bool CContractionHierarchy::readArray(std::istream &stream, std::vector<T> &array)
+{
+	unsigned int size = 0;
+
+	if (!stream.read(reinterpret_cast<char *>(&size), sizeof(size)))
+	{
+		return false;
+	}
+
+	// grow with the data, a damaged size must not allocate gigabytes up front
+	array.clear();
+
+	const unsigned int chunk = 65536;
+
+	for (unsigned int done = 0; done < size; done += chunk)
+	{
+		unsigned int count = std::min(chunk, size - done);
+
+		array.resize(done + count);
+
+		if (!stream.read(reinterpret_cast<char *>(&array[done]), count * sizeof(T)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif /* CCONTRACTIONHIERARCHY_H */
@@ -0,0 +1,114 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CCsvGPSProvider.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CCsvGPSProvider.
+*
+****************************************************************************/
+
+//System Include Files
+#include <iostream>
+#include <cstring>
+
+//Own Include Files
+#include "CCsvGPSProvider.h"
+#include "CWaypoint.h"
+#include "CParser.h"
+
+//Namespaces
+using namespace std;
+
+//Method Implementations
+/**
+ * CCsvGPSProvider constructor
+ * @param fileName the trace to be replayed
+ */
+CCsvGPSProvider::CCsvGPSProvider(string fileName)
+{
+	this->m_fileName 		= fileName;
+	this->m_rejectedCount 	= 0;
+}
+
+
+/**
+ * Open the trace
+ * @return true if the file could be opened
+ */
+bool CCsvGPSProvider::open()
+{
+	this->m_stream.open(this->m_fileName.c_str(), ifstream::in);
+
+	if (this->m_stream.fail())
+	{
+		cout << "ERROR: The GPS trace \"" << this->m_fileName << "\" can not be opened.\n";
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * Read the position of the next line
+ * @param fix the next position
+ * @return false at the end of the trace
+ */
+bool CCsvGPSProvider::readFix(CGPSFix &fix)
+{
+	while (getline(this->m_stream, this->m_line))
+	{
+		char const *pChars = this->m_line.c_str();
+
+		if (this->m_line.find_first_not_of(" \t\r") == string::npos)
+		{
+			// empty line - ignore it
+			continue;
+		}
+
+		if (parseField(pChars, false, fix.time) && parseField(pChars, false, fix.latitude) && parseField(pChars, true, fix.longitude)
+				&& (fix.latitude >= LATITUDE_MIN) && (fix.latitude <= LATITUDE_MAX)
+				&& (fix.longitude >= LONGITUDE_MIN) && (fix.longitude <= LONGITUDE_MAX))
+		{
+			return true;
+		}
+
+		this->m_rejectedCount++;
+	}
+
+	return false;
+}
+
+
+/**
+ * Get the number of lines which were skipped because they are malformed
+ * @return number of lines
+ */
+unsigned int CCsvGPSProvider::getRejectedCount() const
+{
+	return this->m_rejectedCount;
+}
+
+
+/**
+ * Read a number followed by the separator or the end of the line
+ * @param pChars the characters, moved behind the separator
+ * @param isLast true for the last number of the line
+ * @param value the number
+ * @return false if the number or the separator is missing
+ */
+bool CCsvGPSProvider::parseField(char const *&pChars, bool isLast, double &value)
+{
+	char const *pEnd = isLast ? (pChars + strlen(pChars)) : strchr(pChars, ';');
+
+	// spaces around the separator as in the CSV databases are skipped by the parser
+	if ((pEnd == 0) || !CParser::parseNumber(string_view(pChars, pEnd - pChars), value))
+	{
+		return false;
+	}
+
+	pChars = isLast ? pEnd : (pEnd + 1);
+
+	return true;
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CCsvGPSProvider.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CCsvGPSProvider.
+* 					The class CCsvGPSProvider replays a trace recorded as
+* 					lines "time; latitude; longitude" (seconds and
+* 					degrees, the separators of the CSV databases) as fast
+* 					as it is read. Malformed lines are skipped.
+*
+****************************************************************************/
+
+#ifndef CCSVGPSPROVIDER_H
+#define CCSVGPSPROVIDER_H
+
+//System Include Files
+#include <string>
+#include <fstream>
+
+//Own Include Files
+#include "CGPSProvider.h"
+
+class CCsvGPSProvider : public CGPSProvider {
+public:
+
+	/**
+	 * CCsvGPSProvider constructor
+	 * @param fileName the trace to be replayed
+	 */
+	CCsvGPSProvider(std::string fileName);
+
+	/**
+	 * Open the trace
+	 * @return true if the file could be opened
+	 */
+	bool open();
+
+	/**
+	 * Read the position of the next line
+	 * @param fix the next position
+	 * @return false at the end of the trace
+	 */
+	bool readFix(CGPSFix &fix);
+
+	/**
+	 * Get the number of lines which were skipped because they are malformed
+	 * @return number of lines
+	 */
+	unsigned int getRejectedCount() const;
+
+private:
+
+	std::string					m_fileName;
+	std::ifstream				m_stream;
+	std::string					m_line;
+	unsigned int				m_rejectedCount;
+
+	/**
+	 * Read a number followed by the separator or the end of the line
+	 * @param pChars the characters, moved behind the separator
+	 * @param isLast true for the last number of the line
+	 * @param value the number
+	 * @return false if the number or the separator is missing
+	 */
+	static bool parseField(char const *&pChars, bool isLast, double &value);
+
+	/**
+	 * The provider reads one file, it is not copied
+	 */
+	CCsvGPSProvider(CCsvGPSProvider const &origin);
+	CCsvGPSProvider& operator=(CCsvGPSProvider const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CCSVGPSPROVIDER_H */
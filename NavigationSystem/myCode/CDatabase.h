@@ -6,20 +6,55 @@
 * Description     : The file defines a template class CDatabase.
 * 					The class CDatabase is used to hold the information
 * 					of elements in an associative container.
+* 					The layout of the elements in memory is given by a
+* 					storage policy: CMapStorage (ordered by key, the
+* 					default), CMortonStorage (ordered by position) or
+* 					CHashStorage (hash table, fastest lookup by key).
 *
 ****************************************************************************/
 
 #ifndef CDATABASE_H_
 #define CDATABASE_H_
 
+//System Include Files
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <iostream>
+
+//Own Include Files
+#include "CMapStorage.h"
+#include "CMortonStorage.h"
+#include "CHashStorage.h"
+
+//Macros
+#define NAME_ORDER						0
+#define MORTON_ORDER					1
+#define HASH_TABLE						2
+
+// storage of the waypoint and POI databases; with MORTON_ORDER spatial sweeps touch
+// neighbouring memory, with HASH_TABLE the lookups by name are O(1), but with both
+// adding an element moves the others (pointers into the database are only valid
+// until the next element is added; a CRoute looks its hops up again by name)
+#ifndef CONFIG_DATABASE_STORAGE
+#define CONFIG_DATABASE_STORAGE			NAME_ORDER
+//#define CONFIG_DATABASE_STORAGE		MORTON_ORDER
+//#define CONFIG_DATABASE_STORAGE		HASH_TABLE
+#endif
+
 // a template class for the Database
-template<class T1, class T2>
+template<class T1, class T2, class TStorage = CMapStorage<T1, T2> >
 class CDatabase {
 public:
 
 	typedef std::map<T1, T2> 						Database_Container_t;
 	typedef typename std::map<T1, T2>::iterator 	Database_Container_Itr_t;
 	typedef T1										Database_Container_key_t;
+	typedef TStorage								Database_Storage_t;
+	typedef typename TStorage::Storage_Itr_t		Database_Storage_Itr_t;
+	typedef typename TStorage::Storage_ConstItr_t	Database_Storage_ConstItr_t;
+	typedef std::vector<std::pair<T1, T2> >			Database_Batch_t;
 
     /**
 	 * CDatabase constructor
@@ -35,9 +70,9 @@ public:
 	 * Add an element to the database
 	 * param@ T1 const &key				-	a key to associative container (IN)
 	 * param@ T2 const &elem			-	an element to be added   (IN)
-	 * returnvalue@ void
+	 * returnvalue@ bool				-	true if the element was added
 	 */
-    void addElement(T1 const &key, T2 const &elem);
+    bool addElement(T1 const &key, T2 const &elem);
 
     /**
 	 * Get pointer to an element from the Database which matches the key
@@ -47,11 +82,42 @@ public:
     T2* getPointerToElement(T1 elemIdentifier);
 
     /**
-     * Get Elements' container from the Database
+	 * Get read only access to an element from the Database which matches the key
+	 * param@ T1 const &elemIdentifier	-	Identifier for an element	(IN)
+	 * returnvalue@ T2 const*			-	Pointer to the element in the database, 0 if not found
+	 */
+    T2 const* getPointerToElement(T1 const &elemIdentifier) const;
+
+    /**
+     * Get a copy of the Elements' container from the Database.
+     * The whole database is copied: use visitElements or begin() / end() to read the elements in place.
      * returnvalue@ Database_Container_t	-	Elements in the Database	(OUT)
      */
     const Database_Container_t getElementsFromDatabase() const;
 
+    /**
+     * Iterate the elements in place, in the order of the storage policy; itr->first is the key, itr->second the element.
+     * The iterators are invalidated when an element is added.
+     * returnvalue@ Database_Storage_ConstItr_t
+     */
+    Database_Storage_ConstItr_t begin() const;
+    Database_Storage_ConstItr_t end() const;
+
+    /**
+     * Visit all the elements in place, in the order of their keys, e.g. to save the database.
+     * The visitor is called as visitor(T1 const &key, T2 const &elem) and must not add elements to the database.
+     * param@ TVisitor &visitor			-	called for every element	(IN)
+     * returnvalue@ void
+     */
+    template<class TVisitor>
+    void visitElements(TVisitor &visitor) const;
+
+    /**
+     * Get the number of elements in the Database
+     * returnvalue@ unsigned int
+     */
+    unsigned int getElementCount() const;
+
     /**
 	 * Resets the Database
 	 * returnvalue@ void
@@ -65,6 +131,23 @@ public:
 	 */
 	void setDatabase(Database_Container_t const elemsEontainer);
 
+	/**
+	 * Replace the content of the Database by a batch of elements, e.g. read from a file.
+	 * The elements are moved out of the batch, which is empty afterwards; a batch sorted
+	 * by key is loaded in linear time. Of several elements with the same key the first one is kept.
+	 * param@ Database_Batch_t &batch	-	elements to be loaded	(IN/OUT)
+	 * returnvalue@ unsigned int		-	number of elements loaded
+	 */
+	unsigned int replaceElements(Database_Batch_t &batch);
+
+	/**
+	 * Add a batch of elements to the Database with a linear merge (see replaceElements).
+	 * Elements whose key already exists in the Database are not added.
+	 * param@ Database_Batch_t &batch	-	elements to be loaded	(IN/OUT)
+	 * returnvalue@ unsigned int		-	number of elements loaded
+	 */
+	unsigned int mergeElements(Database_Batch_t &batch);
+
 	/**
 	 * Getter method Database
 	 * returnvalue@ Database_Container_t const
@@ -72,37 +155,112 @@ public:
 	Database_Container_t const getDatabase();
 
 	/**
-	 * Print all the elements in the database
+	 * Print all the elements in the database in the order of their keys
 	 * returnvalue@ void
 	 */
 	void print();
 
+	/**
+	 * Get the modification counter of the Database.
+	 * The counter changes whenever an element is added, the content is reset or replaced or
+	 * the storage moves the elements, e.g. the MORTON_ORDER storage on a non-const look-up.
+	 * returnvalue@ unsigned long
+	 */
+	unsigned long getGeneration() const;
+
+	/**
+	 * Check if the elements keep their address when other elements are added
+	 * returnvalue@ bool
+	 */
+	bool hasStableAddresses() const;
+
+protected:
+
+	/**
+	 * A container to store Key and Element, its layout is given by the storage policy.
+	 * itr->first 	- name
+	 * itr->second	- POI
+	 */
+	Database_Storage_t 					m_container;
+
+	/**
+	 * Get the addresses of the elements with the given keys, e.g. to take over an index which
+	 * numbers the elements in the order of their keys
+	 * param@ std::vector<T1> const &keys	-	keys of the elements				(IN)
+	 * param@ std::vector<T2 *> &elements	-	addresses, 0 for a missing key		(OUT)
+	 * returnvalue@ bool					-	false if a key is not in the Database
+	 */
+	bool getElementsByKey(std::vector<T1> const &keys, std::vector<T2 *> &elements);
+
+	/**
+	 * Get the addresses of all the elements in the order of their keys, e.g. to number the
+	 * elements of an index the way a snapshot stores them
+	 * param@ std::vector<T2 *> &elements	-	addresses	(OUT)
+	 * returnvalue@ void
+	 */
+	void getElementsInKeyOrder(std::vector<T2 *> &elements);
+
 private:
 
 	/**
-	 * An Associative container to store Key and Element.
-	 * key 		- name
-	 * value	- POI
+	 * Visitor which collects the keys of the Database
+	 */
+	struct KeyCollector
+	{
+		std::vector<T1> 	*pKeys;
+
+		void operator()(T1 const &key, T2 const &)
+		{
+			pKeys->push_back(key);
+		}
+	};
+
+	/**
+	 * Visitor which prints the elements of the Database
+	 */
+	struct ElementPrinter
+	{
+		void operator()(T1 const &, T2 const &element)
+		{
+			std::cout << element << std::endl;
+		}
+	};
+
+	/**
+	 * Modification counter of the container
+	 */
+	unsigned long						m_generation;
+
+	/**
+	 * Sort a batch by key if needed and move it into the storage, reporting the rejected elements
+	 * param@ Database_Batch_t &batch	-	elements to be loaded	(IN/OUT)
+	 * param@ bool isMerge				-	false to replace the content	(IN)
+	 * returnvalue@ unsigned int		-	number of elements loaded
+	 */
+	unsigned int loadElements(Database_Batch_t &batch, bool isMerge);
+
+	/**
+	 * Order of the elements of a batch: by key only
 	 */
-	Database_Container_t 				m_container;
+	static bool isKeyBefore(std::pair<T1, T2> const &lhs, std::pair<T1, T2> const &rhs);
 };
 
 
 /**
  * CDatabase constructor
  */
-template<class T1, class T2>
-CDatabase<T1, T2>::CDatabase()
+template<class T1, class T2, class TStorage>
+CDatabase<T1, T2, TStorage>::CDatabase()
 {
-	// do nothing
+	this->m_generation = 0;
 }
 
 
 /**
  * CDatabase destructor
  */
-template<class T1, class T2>
-CDatabase<T1, T2>::~CDatabase()
+template<class T1, class T2, class TStorage>
+CDatabase<T1, T2, TStorage>::~CDatabase()
 {
 	// do nothing
 }
@@ -112,21 +270,25 @@ CDatabase<T1, T2>::~CDatabase()
  * Add an element to the database
  * param@ T1 const &key				-	a key to associative container (IN)
  * param@ T2 const &elem			-	an element to be added   (IN)
- * returnvalue@ void
+ * returnvalue@ bool				-	true if the element was added
  */
-template<class T1, class T2>
-void CDatabase<T1, T2>::addElement(T1 const &key, T2 const &elem)
+template<class T1, class T2, class TStorage>
+bool CDatabase<T1, T2, TStorage>::addElement(T1 const &key, T2 const &elem)
 {
-	std::pair<CDatabase<T1, T2>::Database_Container_Itr_t, bool> 	ret;
-
-	ret = this->m_container.insert(std::pair<T1, T2>(key, elem));
+	bool isInserted = this->m_container.insert(key, elem);
 
-	if (ret.second == false)
+	if (isInserted == false)
 	{
 		std::cout << "WARNING: Element already exists in the Database.\n";
 		std::cout << "Key = " << key << std::endl;
 		std::cout << "Element = " << elem << std::endl;
 	}
+	else
+	{
+		this->m_generation++;
+	}
+
+	return isInserted;
 }
 
 
@@ -135,23 +297,22 @@ void CDatabase<T1, T2>::addElement(T1 const &key, T2 const &elem)
  * param@ T1 elemIdentifier		-	Identifier for an element	(IN)
  * returnvalue@ T2*				-	Pointer to the element in the database
  */
-template<class T1, class T2>
-T2* CDatabase<T1, T2>::getPointerToElement(T1 elemIdentifier)
+template<class T1, class T2, class TStorage>
+T2* CDatabase<T1, T2, TStorage>::getPointerToElement(T1 elemIdentifier)
 {
-	T2 	*pT2 = 0;
-
-	if (!this->m_container.empty())
-	{
-		CDatabase<T1, T2>::Database_Container_Itr_t 	itr = this->m_container.find(elemIdentifier);
+	return this->m_container.find(elemIdentifier);
+}
 
-		if (itr != this->m_container.end())
-		{
-			// element found
-			pT2 = &itr->second;
-		}
-	}
 
-	return pT2;
+/**
+ * Get read only access to an element from the Database which matches the key
+ * param@ T1 const &elemIdentifier	-	Identifier for an element	(IN)
+ * returnvalue@ T2 const*			-	Pointer to the element in the database, 0 if not found
+ */
+template<class T1, class T2, class TStorage>
+T2 const* CDatabase<T1, T2, TStorage>::getPointerToElement(T1 const &elemIdentifier) const
+{
+	return this->m_container.find(elemIdentifier);
 }
 
 
@@ -159,10 +320,57 @@ T2* CDatabase<T1, T2>::getPointerToElement(T1 elemIdentifier)
  * Get Elements' container from the Database
  * returnvalue@ Database_Container_t	-	Elements in the Database	(OUT)
  */
-template<class T1, class T2>
-const typename CDatabase<T1, T2>::Database_Container_t CDatabase<T1, T2>::getElementsFromDatabase() const
+template<class T1, class T2, class TStorage>
+const typename CDatabase<T1, T2, TStorage>::Database_Container_t CDatabase<T1, T2, TStorage>::getElementsFromDatabase() const
 {
-	return (this->m_container);
+	Database_Container_t elements;
+
+	this->m_container.copyTo(elements);
+
+	return elements;
+}
+
+
+/**
+ * Iterate the elements in place, in the order of the storage policy; itr->first is the key, itr->second the element.
+ * The iterators are invalidated when an element is added.
+ * returnvalue@ Database_Storage_ConstItr_t
+ */
+template<class T1, class T2, class TStorage>
+typename CDatabase<T1, T2, TStorage>::Database_Storage_ConstItr_t CDatabase<T1, T2, TStorage>::begin() const
+{
+	return this->m_container.begin();
+}
+
+template<class T1, class T2, class TStorage>
+typename CDatabase<T1, T2, TStorage>::Database_Storage_ConstItr_t CDatabase<T1, T2, TStorage>::end() const
+{
+	return this->m_container.end();
+}
+
+
+/**
+ * Visit all the elements in place, in the order of their keys, e.g. to save the database.
+ * The visitor is called as visitor(T1 const &key, T2 const &elem) and must not add elements to the database.
+ * param@ TVisitor &visitor			-	called for every element	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TStorage>
+template<class TVisitor>
+void CDatabase<T1, T2, TStorage>::visitElements(TVisitor &visitor) const
+{
+	this->m_container.visitInKeyOrder(visitor);
+}
+
+
+/**
+ * Get the number of elements in the Database
+ * returnvalue@ unsigned int
+ */
+template<class T1, class T2, class TStorage>
+unsigned int CDatabase<T1, T2, TStorage>::getElementCount() const
+{
+	return this->m_container.size();
 }
 
 
@@ -170,43 +378,185 @@ const typename CDatabase<T1, T2>::Database_Container_t CDatabase<T1, T2>::getEle
  * Resets the Database
  * returnvalue@ void
  */
-template<class T1, class T2>
-void CDatabase<T1, T2>::resetDatabase()
+template<class T1, class T2, class TStorage>
+void CDatabase<T1, T2, TStorage>::resetDatabase()
 {
 	this->m_container.clear();
+	this->m_generation++;
 }
 
 /**
  * Setter method Database
  * returnvalue@ void
  */
-template<class T1, class T2>
-void CDatabase<T1, T2>::setDatabase(Database_Container_t const elemsEontainer)
+template<class T1, class T2, class TStorage>
+void CDatabase<T1, T2, TStorage>::setDatabase(Database_Container_t const elemsEontainer)
 {
-	this->m_container = elemsEontainer;
+	this->m_container.assign(elemsEontainer);
+	this->m_generation++;
+}
+
+/**
+ * Replace the content of the Database by a batch of elements, e.g. read from a file.
+ * The elements are moved out of the batch, which is empty afterwards; a batch sorted
+ * by key is loaded in linear time. Of several elements with the same key the first one is kept.
+ * param@ Database_Batch_t &batch	-	elements to be loaded	(IN/OUT)
+ * returnvalue@ unsigned int		-	number of elements loaded
+ */
+template<class T1, class T2, class TStorage>
+unsigned int CDatabase<T1, T2, TStorage>::replaceElements(Database_Batch_t &batch)
+{
+	return this->loadElements(batch, false);
+}
+
+/**
+ * Add a batch of elements to the Database with a linear merge (see replaceElements).
+ * Elements whose key already exists in the Database are not added.
+ * param@ Database_Batch_t &batch	-	elements to be loaded	(IN/OUT)
+ * returnvalue@ unsigned int		-	number of elements loaded
+ */
+template<class T1, class T2, class TStorage>
+unsigned int CDatabase<T1, T2, TStorage>::mergeElements(Database_Batch_t &batch)
+{
+	return this->loadElements(batch, true);
 }
 
 /**
  * Getter method Database
  * returnvalue@ Database_Container_t const
  */
-template<class T1, class T2>
-const typename CDatabase<T1, T2>::Database_Container_t CDatabase<T1, T2>::getDatabase()
+template<class T1, class T2, class TStorage>
+const typename CDatabase<T1, T2, TStorage>::Database_Container_t CDatabase<T1, T2, TStorage>::getDatabase()
 {
-	return this->m_container;
+	return this->getElementsFromDatabase();
 }
 
 /**
- * Print all the elements in the database
+ * Print all the elements in the database in the order of their keys
  * returnvalue@ void
  */
-template<class T1, class T2>
-void CDatabase<T1, T2>::print()
+template<class T1, class T2, class TStorage>
+void CDatabase<T1, T2, TStorage>::print()
 {
-	for (CDatabase<T1, T2>::Database_Container_Itr_t itr = this->m_container.begin(); itr != this->m_container.end(); ++itr)
+	ElementPrinter printer;
+
+	this->visitElements(printer);
+}
+
+/**
+ * Get the modification counter of the Database.
+ * The counter changes whenever an element is added, the content is reset or replaced or
+ * the storage moves the elements, e.g. the MORTON_ORDER storage on a non-const look-up.
+ * returnvalue@ unsigned long
+ */
+template<class T1, class T2, class TStorage>
+unsigned long CDatabase<T1, T2, TStorage>::getGeneration() const
+{
+	// both counters only grow: their sum changes with either of them
+	return this->m_generation + this->m_container.getMoveCount();
+}
+
+/**
+ * Check if the elements keep their address when other elements are added
+ * returnvalue@ bool
+ */
+template<class T1, class T2, class TStorage>
+bool CDatabase<T1, T2, TStorage>::hasStableAddresses() const
+{
+	return TStorage::HAS_STABLE_ADDRESSES;
+}
+
+/**
+ * Get the addresses of the elements with the given keys, e.g. to take over an index which
+ * numbers the elements in the order of their keys
+ * param@ std::vector<T1> const &keys	-	keys of the elements				(IN)
+ * param@ std::vector<T2 *> &elements	-	addresses, 0 for a missing key		(OUT)
+ * returnvalue@ bool					-	false if a key is not in the Database
+ */
+template<class T1, class T2, class TStorage>
+bool CDatabase<T1, T2, TStorage>::getElementsByKey(std::vector<T1> const &keys, std::vector<T2 *> &elements)
+{
+	Database_Storage_Itr_t 	itr 		= this->m_container.begin();
+	unsigned int 			index 		= 0;
+	bool 					isComplete 	= true;
+
+	elements.assign(keys.size(), 0);
+
+	// the storage usually keeps the order of the keys: the elements are taken one after the other
+	while ((itr != this->m_container.end()) && (index < keys.size()) && (itr->first == keys[index]))
+	{
+		elements[index++] = &itr->second;
+		++itr;
+	}
+
+	// the rest is looked up key by key, e.g. with the HASH_TABLE storage
+	for (; index < keys.size(); ++index)
+	{
+		elements[index] = this->getPointerToElement(keys[index]);
+		isComplete 		= isComplete && elements[index];
+	}
+
+	return isComplete;
+}
+
+
+/**
+ * Get the addresses of all the elements in the order of their keys, e.g. to number the
+ * elements of an index the way a snapshot stores them
+ * param@ std::vector<T2 *> &elements	-	addresses	(OUT)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TStorage>
+void CDatabase<T1, T2, TStorage>::getElementsInKeyOrder(std::vector<T2 *> &elements)
+{
+	std::vector<T1> keys;
+	KeyCollector 	collector;
+
+	keys.reserve(this->m_container.size());
+	collector.pKeys = &keys;
+	this->visitElements(collector);
+
+	this->getElementsByKey(keys, elements);
+}
+
+/**
+ * Sort a batch by key if needed and move it into the storage, reporting the rejected elements
+ * param@ Database_Batch_t &batch	-	elements to be loaded	(IN/OUT)
+ * param@ bool isMerge				-	false to replace the content	(IN)
+ * returnvalue@ unsigned int		-	number of elements loaded
+ */
+template<class T1, class T2, class TStorage>
+unsigned int CDatabase<T1, T2, TStorage>::loadElements(Database_Batch_t &batch, bool isMerge)
+{
+	// the order of the file is kept for equal keys, so the first one wins as with addElement
+	if (!std::is_sorted(batch.begin(), batch.end(), isKeyBefore))
 	{
-		std::cout << itr->second << std::endl;
+		std::stable_sort(batch.begin(), batch.end(), isKeyBefore);
 	}
+
+	unsigned int loaded = this->m_container.load(batch, isMerge);
+
+	for (typename Database_Batch_t::iterator itr = batch.begin(); itr != batch.end(); ++itr)
+	{
+		std::cout << "WARNING: Element already exists in the Database.\n";
+		std::cout << "Key = " << itr->first << std::endl;
+		std::cout << "Element = " << itr->second << std::endl;
+	}
+
+	// release the memory of the batch
+	Database_Batch_t().swap(batch);
+	this->m_generation++;
+
+	return loaded;
+}
+
+/**
+ * Order of the elements of a batch: by key only
+ */
+template<class T1, class T2, class TStorage>
+bool CDatabase<T1, T2, TStorage>::isKeyBefore(std::pair<T1, T2> const &lhs, std::pair<T1, T2> const &rhs)
+{
+	return lhs.first < rhs.first;
 }
 
 #endif /* CDATABASE_H_ */
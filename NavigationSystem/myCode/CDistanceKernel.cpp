@@ -0,0 +1,464 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CDistanceKernel.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CDistanceKernel.
+*
+* 					haversine: a = sin^2(dLat / 2) + cos(lat1) cos(lat2) sin^2(dLon / 2)
+* 					           d = 2 R asin(sqrt(a))
+* 					The SIMD implementations compute a with a polynomial
+* 					sine (error below 1e-15), the scalar one with libm.
+*
+****************************************************************************/
+
+//System Include Files
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+
+//Own Include Files
+#include "CDistanceKernel.h"
+#include "CWaypoint.h"
+
+#if (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+#define DISTANCE_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+//Namespaces
+using namespace std;
+
+//Macros
+#define HALF_PI							(3.14159265358979323846 / 2)
+#define KERNEL_BLOCK_SIZE				256
+
+//typedefs
+/**
+ * The origin of a block in radians
+ */
+typedef struct
+{
+	double		latitude;
+	double		longitude;
+	double		cosLatitude;
+} Kernel_Origin_t;
+
+/**
+ * Compute the haversine term a of every position; the angles are multiplied by scale first
+ */
+typedef void (*Kernel_t)(Kernel_Origin_t const &origin, double const latitudes[], double const longitudes[], double const cosLatitudes[],
+							double scale, unsigned int count, double terms[]);
+
+/**
+ * Taylor coefficients of sin(x) / x - 1 in x^2, enough for double precision up to |x| = PI / 2
+ */
+static const double sinCoefficients[] = {
+		-1.0 / 121645100408832000.0,	// x^19
+		 1.0 / 355687428096000.0,
+		-1.0 / 1307674368000.0,
+		 1.0 / 6227020800.0,
+		-1.0 / 39916800.0,
+		 1.0 / 362880.0,
+		-1.0 / 5040.0,
+		 1.0 / 120.0,
+		-1.0 / 6.0						// x^3
+};
+
+#define SIN_COEFFICIENTS				(sizeof(sinCoefficients) / sizeof(sinCoefficients[0]))
+
+/**
+ * Scalar implementation
+ */
+static void haversineTermsScalar(Kernel_Origin_t const &origin, double const latitudes[], double const longitudes[], double const cosLatitudes[],
+									double scale, unsigned int count, double terms[])
+{
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		double latitude		= latitudes[index] * scale;
+		double cosLatitude	= cosLatitudes ? cosLatitudes[index] : cos(latitude);
+		double sinLatitude	= sin(0.5 * (latitude - origin.latitude));
+		double sinLongitude	= sin(0.5 * (longitudes[index] * scale - origin.longitude));
+
+		terms[index] = sinLatitude * sinLatitude + origin.cosLatitude * cosLatitude * sinLongitude * sinLongitude;
+	}
+}
+
+#ifdef DISTANCE_KERNEL_X86
+/**
+ * sin(x) for |x| <= PI / 2
+ */
+__attribute__((target("sse2")))
+static inline __m128d sinSse2(__m128d x)
+{
+	__m128d x2	= _mm_mul_pd(x, x);
+	__m128d sum	= _mm_set1_pd(sinCoefficients[0]);
+
+	for (unsigned int index = 1; index < SIN_COEFFICIENTS; ++index)
+	{
+		sum = _mm_add_pd(_mm_mul_pd(sum, x2), _mm_set1_pd(sinCoefficients[index]));
+	}
+
+	return _mm_add_pd(x, _mm_mul_pd(_mm_mul_pd(x, x2), sum));
+}
+
+/**
+ * sin^2(x) for |x| <= PI: sin^2 is even and symmetric around PI / 2
+ */
+__attribute__((target("sse2")))
+static inline __m128d sinSquaredSse2(__m128d x)
+{
+	__m128d t = _mm_andnot_pd(_mm_set1_pd(-0.0), x);
+
+	t = _mm_min_pd(t, _mm_sub_pd(_mm_set1_pd(2 * HALF_PI), t));
+	t = sinSse2(t);
+
+	return _mm_mul_pd(t, t);
+}
+
+/**
+ * SSE2 implementation
+ */
+__attribute__((target("sse2")))
+static void haversineTermsSse2(Kernel_Origin_t const &origin, double const latitudes[], double const longitudes[], double const cosLatitudes[],
+									double scale, unsigned int count, double terms[])
+{
+	const __m128d	half			= _mm_set1_pd(0.5);
+	const __m128d	vScale			= _mm_set1_pd(scale);
+	const __m128d	originLatitude	= _mm_set1_pd(origin.latitude);
+	const __m128d	originLongitude	= _mm_set1_pd(origin.longitude);
+	const __m128d	originCos		= _mm_set1_pd(origin.cosLatitude);
+	unsigned int	index			= 0;
+
+	for (; index + 2 <= count; index += 2)
+	{
+		__m128d latitude	= _mm_mul_pd(_mm_loadu_pd(latitudes + index), vScale);
+		__m128d longitude	= _mm_mul_pd(_mm_loadu_pd(longitudes + index), vScale);
+		__m128d cosLatitude;
+
+		if (cosLatitudes)
+		{
+			cosLatitude = _mm_loadu_pd(cosLatitudes + index);
+		}
+		else
+		{
+			// cos(lat) = sin(PI / 2 - |lat|)
+			cosLatitude = sinSse2(_mm_sub_pd(_mm_set1_pd(HALF_PI), _mm_andnot_pd(_mm_set1_pd(-0.0), latitude)));
+		}
+
+		__m128d sinLatitude		= sinSquaredSse2(_mm_mul_pd(half, _mm_sub_pd(latitude, originLatitude)));
+		__m128d sinLongitude	= sinSquaredSse2(_mm_mul_pd(half, _mm_sub_pd(longitude, originLongitude)));
+
+		_mm_storeu_pd(terms + index, _mm_add_pd(sinLatitude, _mm_mul_pd(_mm_mul_pd(originCos, cosLatitude), sinLongitude)));
+	}
+
+	haversineTermsScalar(origin, latitudes + index, longitudes + index, cosLatitudes ? cosLatitudes + index : 0, scale, count - index, terms + index);
+}
+
+/**
+ * sin(x) for |x| <= PI / 2
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d sinAvx2(__m256d x)
+{
+	__m256d x2	= _mm256_mul_pd(x, x);
+	__m256d sum	= _mm256_set1_pd(sinCoefficients[0]);
+
+	for (unsigned int index = 1; index < SIN_COEFFICIENTS; ++index)
+	{
+		sum = _mm256_fmadd_pd(sum, x2, _mm256_set1_pd(sinCoefficients[index]));
+	}
+
+	return _mm256_fmadd_pd(_mm256_mul_pd(x, x2), sum, x);
+}
+
+/**
+ * sin^2(x) for |x| <= PI: sin^2 is even and symmetric around PI / 2
+ */
+__attribute__((target("avx2,fma")))
+static inline __m256d sinSquaredAvx2(__m256d x)
+{
+	__m256d t = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+
+	t = _mm256_min_pd(t, _mm256_sub_pd(_mm256_set1_pd(2 * HALF_PI), t));
+	t = sinAvx2(t);
+
+	return _mm256_mul_pd(t, t);
+}
+
+/**
+ * AVX2 implementation
+ */
+__attribute__((target("avx2,fma")))
+static void haversineTermsAvx2(Kernel_Origin_t const &origin, double const latitudes[], double const longitudes[], double const cosLatitudes[],
+									double scale, unsigned int count, double terms[])
+{
+	const __m256d	half			= _mm256_set1_pd(0.5);
+	const __m256d	vScale			= _mm256_set1_pd(scale);
+	const __m256d	originLatitude	= _mm256_set1_pd(origin.latitude);
+	const __m256d	originLongitude	= _mm256_set1_pd(origin.longitude);
+	const __m256d	originCos		= _mm256_set1_pd(origin.cosLatitude);
+	unsigned int	index			= 0;
+
+	for (; index + 4 <= count; index += 4)
+	{
+		__m256d latitude	= _mm256_mul_pd(_mm256_loadu_pd(latitudes + index), vScale);
+		__m256d longitude	= _mm256_mul_pd(_mm256_loadu_pd(longitudes + index), vScale);
+		__m256d cosLatitude;
+
+		if (cosLatitudes)
+		{
+			cosLatitude = _mm256_loadu_pd(cosLatitudes + index);
+		}
+		else
+		{
+			// cos(lat) = sin(PI / 2 - |lat|)
+			cosLatitude = sinAvx2(_mm256_sub_pd(_mm256_set1_pd(HALF_PI), _mm256_andnot_pd(_mm256_set1_pd(-0.0), latitude)));
+		}
+
+		__m256d sinLatitude		= sinSquaredAvx2(_mm256_mul_pd(half, _mm256_sub_pd(latitude, originLatitude)));
+		__m256d sinLongitude	= sinSquaredAvx2(_mm256_mul_pd(half, _mm256_sub_pd(longitude, originLongitude)));
+
+		_mm256_storeu_pd(terms + index, _mm256_fmadd_pd(_mm256_mul_pd(originCos, cosLatitude), sinLongitude, sinLatitude));
+	}
+
+	haversineTermsSse2(origin, latitudes + index, longitudes + index, cosLatitudes ? cosLatitudes + index : 0, scale, count - index, terms + index);
+}
+#endif
+
+/**
+ * Get the kernel of an implementation
+ */
+static Kernel_t getKernel(CDistanceKernel::t_implementation implementation)
+{
+	Kernel_t kernel = haversineTermsScalar;
+
+#ifdef DISTANCE_KERNEL_X86
+	if (implementation == CDistanceKernel::AVX2)
+	{
+		kernel = haversineTermsAvx2;
+	}
+	else if (implementation == CDistanceKernel::SSE2)
+	{
+		kernel = haversineTermsSse2;
+	}
+#endif
+
+	return kernel;
+}
+
+/**
+ * Get the best implementation supported by the CPU
+ */
+static CDistanceKernel::t_implementation getBestImplementation()
+{
+	CDistanceKernel::t_implementation implementation = CDistanceKernel::SCALAR;
+
+	if (CDistanceKernel::isSupported(CDistanceKernel::AVX2))
+	{
+		implementation = CDistanceKernel::AVX2;
+	}
+	else if (CDistanceKernel::isSupported(CDistanceKernel::SSE2))
+	{
+		implementation = CDistanceKernel::SSE2;
+	}
+
+	return implementation;
+}
+
+/**
+ * The selected implementation; it is resolved on the first use, so the kernels may be
+ * called from static initializers, and it may be changed while other threads compute
+ */
+static std::atomic<CDistanceKernel::t_implementation>& selectedImplementation()
+{
+	static std::atomic<CDistanceKernel::t_implementation> implementation(getBestImplementation());
+
+	return implementation;
+}
+
+/**
+ * Get the kernel of the selected implementation
+ */
+static Kernel_t selectedKernel()
+{
+	return getKernel(selectedImplementation().load(std::memory_order_relaxed));
+}
+
+/**
+ * Convert haversine terms to distances in KMs
+ */
+static void termsToDistances(unsigned int count, double distances[])
+{
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		distances[index] = 2 * EARTH_RADIUS_KM * asin(sqrt(min(distances[index], 1.0)));
+	}
+}
+
+/**
+ * Find the position with the smallest haversine term; the distance grows with it, no need to convert it
+ */
+static unsigned int findNearest(Kernel_Origin_t const &origin, double const latitudes[], double const longitudes[], double const cosLatitudes[],
+									double scale, unsigned int count)
+{
+	double			terms[KERNEL_BLOCK_SIZE];
+	double			smallestTerm	= 2;
+	unsigned int	nearestIndex	= count;
+	Kernel_t		kernel			= selectedKernel();
+
+	for (unsigned int begin = 0; begin < count; begin += KERNEL_BLOCK_SIZE)
+	{
+		unsigned int blockSize = min(count - begin, (unsigned int)KERNEL_BLOCK_SIZE);
+
+		kernel(origin, latitudes + begin, longitudes + begin, cosLatitudes ? cosLatitudes + begin : 0, scale, blockSize, terms);
+
+		for (unsigned int index = 0; index < blockSize; ++index)
+		{
+			if (terms[index] < smallestTerm)
+			{
+				smallestTerm = terms[index];
+				nearestIndex = begin + index;
+			}
+		}
+	}
+
+	return nearestIndex;
+}
+
+//Method Implementations
+/**
+ * Compute the distances from the origin to every position, all the angles in degrees
+ * param@ double latitude				-	latitude of the origin		(IN)
+ * param@ double longitude				-	longitude of the origin		(IN)
+ * param@ double const latitudes[]		-	latitudes of the positions	(IN)
+ * param@ double const longitudes[]		-	longitudes of the positions	(IN)
+ * param@ unsigned int count			-	number of positions			(IN)
+ * param@ double distances[]			-	distances in KMs			(OUT)
+ * returnvalue@ void
+ */
+void CDistanceKernel::haversine(double latitude, double longitude, double const latitudes[], double const longitudes[], unsigned int count, double distances[])
+{
+	Kernel_Origin_t origin = { latitude * DEG_TO_RAD, longitude * DEG_TO_RAD, cos(latitude * DEG_TO_RAD) };
+
+	selectedKernel()(origin, latitudes, longitudes, 0, DEG_TO_RAD, count, distances);
+	termsToDistances(count, distances);
+}
+
+
+/**
+ * Compute the distances from the origin to every position, all the angles in radians.
+ * The cosines of the latitudes may be passed if they are stored with the positions.
+ * param@ double latitude				-	latitude of the origin					(IN)
+ * param@ double longitude				-	longitude of the origin					(IN)
+ * param@ double cosLatitude			-	cosine of the latitude of the origin	(IN)
+ * param@ double const latitudes[]		-	latitudes of the positions				(IN)
+ * param@ double const longitudes[]		-	longitudes of the positions				(IN)
+ * param@ double const cosLatitudes[]	-	cosines of the latitudes, 0 to compute them	(IN)
+ * param@ unsigned int count			-	number of positions						(IN)
+ * param@ double distances[]			-	distances in KMs						(OUT)
+ * returnvalue@ void
+ */
+void CDistanceKernel::haversineRadians(double latitude, double longitude, double cosLatitude, double const latitudes[], double const longitudes[],
+										double const cosLatitudes[], unsigned int count, double distances[])
+{
+	Kernel_Origin_t origin = { latitude, longitude, cosLatitude };
+
+	selectedKernel()(origin, latitudes, longitudes, cosLatitudes, 1.0, count, distances);
+	termsToDistances(count, distances);
+}
+
+
+/**
+ * Find the position closest to the origin, all the angles in degrees
+ * param@ double latitude				-	latitude of the origin		(IN)
+ * param@ double longitude				-	longitude of the origin		(IN)
+ * param@ double const latitudes[]		-	latitudes of the positions	(IN)
+ * param@ double const longitudes[]		-	longitudes of the positions	(IN)
+ * param@ unsigned int count			-	number of positions			(IN)
+ * returnvalue@ unsigned int			-	index of the closest position, count if there is none
+ */
+unsigned int CDistanceKernel::nearest(double latitude, double longitude, double const latitudes[], double const longitudes[], unsigned int count)
+{
+	Kernel_Origin_t origin = { latitude * DEG_TO_RAD, longitude * DEG_TO_RAD, cos(latitude * DEG_TO_RAD) };
+
+	return findNearest(origin, latitudes, longitudes, 0, DEG_TO_RAD, count);
+}
+
+
+/**
+ * Find the position closest to the origin, all the angles in radians.
+ * The cosines of the latitudes may be passed if they are stored with the positions.
+ * param@ double latitude				-	latitude of the origin					(IN)
+ * param@ double longitude				-	longitude of the origin					(IN)
+ * param@ double cosLatitude			-	cosine of the latitude of the origin	(IN)
+ * param@ double const latitudes[]		-	latitudes of the positions				(IN)
+ * param@ double const longitudes[]		-	longitudes of the positions				(IN)
+ * param@ double const cosLatitudes[]	-	cosines of the latitudes, 0 to compute them	(IN)
+ * param@ unsigned int count			-	number of positions						(IN)
+ * returnvalue@ unsigned int			-	index of the closest position, count if there is none
+ */
+unsigned int CDistanceKernel::nearestRadians(double latitude, double longitude, double cosLatitude, double const latitudes[], double const longitudes[],
+												double const cosLatitudes[], unsigned int count)
+{
+	Kernel_Origin_t origin = { latitude, longitude, cosLatitude };
+
+	return findNearest(origin, latitudes, longitudes, cosLatitudes, 1.0, count);
+}
+
+
+/**
+ * Check if the CPU supports an implementation
+ * param@ t_implementation implementation	-	implementation	(IN)
+ * returnvalue@ bool
+ */
+bool CDistanceKernel::isSupported(t_implementation implementation)
+{
+	bool isSupported = (implementation == SCALAR);
+
+#ifdef DISTANCE_KERNEL_X86
+	// the selection may run before main()
+	__builtin_cpu_init();
+
+	if (implementation == SSE2)
+	{
+		isSupported = __builtin_cpu_supports("sse2");
+	}
+	else if (implementation == AVX2)
+	{
+		isSupported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	}
+#endif
+
+	return isSupported;
+}
+
+
+/**
+ * Select an implementation, e.g. to compare them; the best one is selected by default
+ * A computation which is already running keeps the kernel it started with
+ * param@ t_implementation implementation	-	implementation	(IN)
+ * returnvalue@ bool						-	false if the CPU does not support it
+ */
+bool CDistanceKernel::setImplementation(t_implementation implementation)
+{
+	bool isSupported = CDistanceKernel::isSupported(implementation);
+
+	if (isSupported)
+	{
+		selectedImplementation().store(implementation, std::memory_order_relaxed);
+	}
+
+	return isSupported;
+}
+
+
+/**
+ * Get the selected implementation
+ * returnvalue@ t_implementation
+ */
+CDistanceKernel::t_implementation CDistanceKernel::getImplementation()
+{
+	return selectedImplementation().load(std::memory_order_relaxed);
+}
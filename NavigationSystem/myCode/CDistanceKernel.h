@@ -0,0 +1,110 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CDistanceKernel.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CDistanceKernel.
+* 					The class CDistanceKernel computes the great circle
+* 					(haversine) distances from one origin to a block of
+* 					positions given as separate latitude and longitude
+* 					arrays (structure of arrays).
+*
+* 					The SSE2 and AVX2 implementations process 2 / 4
+* 					positions at once; the best one supported by the CPU
+* 					is selected at runtime, the scalar one is the
+* 					fallback on any other platform.
+*
+****************************************************************************/
+
+#ifndef CDISTANCEKERNEL_H
+#define CDISTANCEKERNEL_H
+
+class CDistanceKernel {
+public:
+
+	enum t_implementation
+	{
+		SCALAR,
+		SSE2,
+		AVX2,
+	};
+
+	/**
+	 * Compute the distances from the origin to every position, all the angles in degrees
+	 * param@ double latitude				-	latitude of the origin		(IN)
+	 * param@ double longitude				-	longitude of the origin		(IN)
+	 * param@ double const latitudes[]		-	latitudes of the positions	(IN)
+	 * param@ double const longitudes[]		-	longitudes of the positions	(IN)
+	 * param@ unsigned int count			-	number of positions			(IN)
+	 * param@ double distances[]			-	distances in KMs			(OUT)
+	 * returnvalue@ void
+	 */
+	static void haversine(double latitude, double longitude, double const latitudes[], double const longitudes[], unsigned int count, double distances[]);
+
+	/**
+	 * Compute the distances from the origin to every position, all the angles in radians.
+	 * The cosines of the latitudes may be passed if they are stored with the positions.
+	 * param@ double latitude				-	latitude of the origin					(IN)
+	 * param@ double longitude				-	longitude of the origin					(IN)
+	 * param@ double cosLatitude			-	cosine of the latitude of the origin	(IN)
+	 * param@ double const latitudes[]		-	latitudes of the positions				(IN)
+	 * param@ double const longitudes[]		-	longitudes of the positions				(IN)
+	 * param@ double const cosLatitudes[]	-	cosines of the latitudes, 0 to compute them	(IN)
+	 * param@ unsigned int count			-	number of positions						(IN)
+	 * param@ double distances[]			-	distances in KMs						(OUT)
+	 * returnvalue@ void
+	 */
+	static void haversineRadians(double latitude, double longitude, double cosLatitude, double const latitudes[], double const longitudes[],
+									double const cosLatitudes[], unsigned int count, double distances[]);
+
+	/**
+	 * Find the position closest to the origin, all the angles in degrees
+	 * param@ double latitude				-	latitude of the origin		(IN)
+	 * param@ double longitude				-	longitude of the origin		(IN)
+	 * param@ double const latitudes[]		-	latitudes of the positions	(IN)
+	 * param@ double const longitudes[]		-	longitudes of the positions	(IN)
+	 * param@ unsigned int count			-	number of positions			(IN)
+	 * returnvalue@ unsigned int			-	index of the closest position, count if there is none
+	 */
+	static unsigned int nearest(double latitude, double longitude, double const latitudes[], double const longitudes[], unsigned int count);
+
+	/**
+	 * Find the position closest to the origin, all the angles in radians.
+	 * The cosines of the latitudes may be passed if they are stored with the positions.
+	 * param@ double latitude				-	latitude of the origin					(IN)
+	 * param@ double longitude				-	longitude of the origin					(IN)
+	 * param@ double cosLatitude			-	cosine of the latitude of the origin	(IN)
+	 * param@ double const latitudes[]		-	latitudes of the positions				(IN)
+	 * param@ double const longitudes[]		-	longitudes of the positions				(IN)
+	 * param@ double const cosLatitudes[]	-	cosines of the latitudes, 0 to compute them	(IN)
+	 * param@ unsigned int count			-	number of positions						(IN)
+	 * returnvalue@ unsigned int			-	index of the closest position, count if there is none
+	 */
+	static unsigned int nearestRadians(double latitude, double longitude, double cosLatitude, double const latitudes[], double const longitudes[],
+										double const cosLatitudes[], unsigned int count);
+
+	/**
+	 * Check if the CPU supports an implementation
+	 * param@ t_implementation implementation	-	implementation	(IN)
+	 * returnvalue@ bool
+	 */
+	static bool isSupported(t_implementation implementation);
+
+	/**
+	 * Select an implementation, e.g. to compare them; the best one is selected by default
+	 * A computation which is already running keeps the kernel it started with
+	 * param@ t_implementation implementation	-	implementation	(IN)
+	 * returnvalue@ bool						-	false if the CPU does not support it
+	 */
+	static bool setImplementation(t_implementation implementation);
+
+	/**
+	 * Get the selected implementation
+	 * returnvalue@ t_implementation
+	 */
+	static t_implementation getImplementation();
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CDISTANCEKERNEL_H */
@@ -0,0 +1,56 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CGPSProvider.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CGPSProvider.
+* 					The class CGPSProvider is an abstract class which
+* 					provides the interface of a source of GPS fixes, e.g.
+* 					the replay of a recorded trace or a generator. The
+* 					fixes are read one after the other by a CGPSSource.
+*
+****************************************************************************/
+
+#ifndef CGPSPROVIDER_H
+#define CGPSPROVIDER_H
+
+//System Include Files
+#include <string>
+
+//Own Include Files
+
+/**
+ * A position of the GPS receiver
+ */
+struct CGPSFix
+{
+	double		time;			// seconds since the start of the day (NMEA) or the trace
+	double		latitude;		// degrees, negative in the south
+	double		longitude;		// degrees, negative in the west
+};
+
+class CGPSProvider {
+public:
+
+	/**
+	 * Prepare the first fix, e.g. open the file of a recorded trace
+	 * @return true if the provider can deliver fixes
+	 */
+	virtual bool open() = 0;
+
+	/**
+	 * Read the next fix; the call does not wait for user input
+	 * @param fix the next position
+	 * @return false at the end of the trace
+	 */
+	virtual bool readFix(CGPSFix &fix) = 0;
+
+	/**
+	 * A Virtual Destructor for an abstract class
+	 */
+	virtual ~CGPSProvider() {}
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CGPSPROVIDER_H */
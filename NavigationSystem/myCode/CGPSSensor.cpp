@@ -69,7 +69,7 @@ CWaypoint CGPSSensor::getCurrentPosition()
 
 	} while (1);
 
-	CWaypoint gpsSensorValue("Current Position", latitude, longitude, CWaypoint::WAYPOINT);
+	CWaypoint gpsSensorValue("Current Position", latitude, longitude);
 
 	return gpsSensorValue;
 }
@@ -0,0 +1,121 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CGPSSource.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CGPSSource.
+*
+****************************************************************************/
+
+//System Include Files
+
+//Own Include Files
+#include "CGPSSource.h"
+
+//Namespaces
+using namespace std;
+
+const unsigned int CGPSSource::DEFAULT_CAPACITY = 1024;
+
+//Method Implementations
+/**
+ * CGPSSource constructor
+ * param@ CGPSProvider *pProvider		-	the provider of the fixes, owned by the caller	(IN)
+ * param@ unsigned int capacity			-	number of fixes buffered						(IN)
+ */
+CGPSSource::CGPSSource(CGPSProvider *pProvider, unsigned int capacity)
+	: m_buffer(capacity), m_isStopRequested(false), m_isProducerDone(true)
+{
+	this->m_pProvider = pProvider;
+}
+
+
+/**
+ * CGPSSource destructor: stops the producer thread
+ */
+CGPSSource::~CGPSSource()
+{
+	this->stop();
+}
+
+
+/**
+ * Open the provider and start reading the fixes
+ * returnvalue@ bool				-	false if the provider can not be opened or the source runs
+ */
+bool CGPSSource::start()
+{
+	if (this->m_producer.joinable() || !this->m_pProvider || !this->m_pProvider->open())
+	{
+		return false;
+	}
+
+	this->m_isStopRequested.store(false);
+	this->m_isProducerDone.store(false);
+	this->m_producer = thread(&CGPSSource::produce, this);
+
+	return true;
+}
+
+
+/**
+ * Stop reading the fixes and wait for the producer thread; fixes in the buffer remain
+ * returnvalue@ void
+ */
+void CGPSSource::stop()
+{
+	if (this->m_producer.joinable())
+	{
+		this->m_isStopRequested.store(true);
+		this->m_producer.join();
+	}
+}
+
+
+/**
+ * Take the oldest fix without waiting
+ * param@ CGPSFix &fix				-	the fix		(OUT)
+ * returnvalue@ bool				-	false if no fix is available at the moment
+ */
+bool CGPSSource::poll(CGPSFix &fix)
+{
+	return this->m_buffer.pop(fix);
+}
+
+
+/**
+ * Check if all the fixes of the provider were taken
+ * returnvalue@ bool				-	true at the end of the trace and an empty buffer
+ */
+bool CGPSSource::isFinished() const
+{
+	// the last fix is pushed before the producer reports the end
+	return this->m_isProducerDone.load(memory_order_acquire) && this->m_buffer.isEmpty();
+}
+
+
+/**
+ * Producer thread: read the fixes and push them into the buffer
+ * returnvalue@ void
+ */
+void CGPSSource::produce()
+{
+	CGPSFix fix;
+
+	while (!this->m_isStopRequested.load(memory_order_relaxed) && this->m_pProvider->readFix(fix))
+	{
+		// the loop is slower than the provider: wait for a free slot
+		while (!this->m_buffer.push(fix))
+		{
+			if (this->m_isStopRequested.load(memory_order_relaxed))
+			{
+				break;
+			}
+
+			this_thread::yield();
+		}
+	}
+
+	this->m_isProducerDone.store(true, memory_order_release);
+}
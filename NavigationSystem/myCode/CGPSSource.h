@@ -0,0 +1,98 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CGPSSource.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CGPSSource.
+* 					The class CGPSSource reads the fixes of a CGPSProvider
+* 					in a thread of its own and passes them through a
+* 					lock-free CRingBuffer to the navigation loop. The loop
+* 					polls the fixes and never waits for the provider;
+* 					the producer yields while the buffer is full.
+*
+****************************************************************************/
+
+#ifndef CGPSSOURCE_H
+#define CGPSSOURCE_H
+
+//System Include Files
+#include <atomic>
+#include <thread>
+
+//Own Include Files
+#include "CGPSProvider.h"
+#include "CRingBuffer.h"
+
+class CGPSSource {
+public:
+
+	/**
+	 * Number of fixes buffered by default
+	 */
+	static const unsigned int DEFAULT_CAPACITY;
+
+	/**
+	 * CGPSSource constructor
+	 * param@ CGPSProvider *pProvider		-	the provider of the fixes, owned by the caller	(IN)
+	 * param@ unsigned int capacity			-	number of fixes buffered						(IN)
+	 */
+	CGPSSource(CGPSProvider *pProvider, unsigned int capacity = DEFAULT_CAPACITY);
+
+	/**
+	 * CGPSSource destructor: stops the producer thread
+	 */
+	~CGPSSource();
+
+	/**
+	 * Open the provider and start reading the fixes
+	 * returnvalue@ bool				-	false if the provider can not be opened or the source runs
+	 */
+	bool start();
+
+	/**
+	 * Stop reading the fixes and wait for the producer thread; fixes in the buffer remain
+	 * returnvalue@ void
+	 */
+	void stop();
+
+	/**
+	 * Take the oldest fix without waiting
+	 * param@ CGPSFix &fix				-	the fix		(OUT)
+	 * returnvalue@ bool				-	false if no fix is available at the moment
+	 */
+	bool poll(CGPSFix &fix);
+
+	/**
+	 * Check if all the fixes of the provider were taken
+	 * returnvalue@ bool				-	true at the end of the trace and an empty buffer
+	 */
+	bool isFinished() const;
+
+private:
+
+	CGPSProvider					*m_pProvider;
+	CRingBuffer<CGPSFix>			m_buffer;
+	std::thread						m_producer;
+
+	/**
+	 * Set by the loop to stop the producer; set by the producer after its last fix
+	 */
+	std::atomic<bool>				m_isStopRequested;
+	std::atomic<bool>				m_isProducerDone;
+
+	/**
+	 * Producer thread: read the fixes and push them into the buffer
+	 * returnvalue@ void
+	 */
+	void produce();
+
+	/**
+	 * The source owns a thread, it is not copied
+	 */
+	CGPSSource(CGPSSource const &origin);
+	CGPSSource& operator=(CGPSSource const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CGPSSOURCE_H */
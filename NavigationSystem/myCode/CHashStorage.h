@@ -0,0 +1,694 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CHashStorage.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a template class CHashStorage.
+* 					The class CHashStorage is a storage policy of the
+* 					CDatabase which finds the elements by key in a flat
+* 					open addressing hash table (Swiss table): a lookup
+* 					costs one hash and mostly one key comparison instead
+* 					of O(log N) comparisons along the nodes of a map.
+*
+* 					The elements are kept in one contiguous array in the
+* 					order they were added, together with their hash. The
+* 					table holds one control byte per slot (7 bits of the
+* 					hash, or EMPTY) and the array index of the element;
+* 					the control bytes of a group of 16 slots are compared
+* 					with the key at once (SSE2). The iteration in key
+* 					order uses an index which the bulk loads sort and an
+* 					added element drops; without it a visit sorts a
+* 					temporary index, the storage is never changed by a
+* 					const method.
+*
+* 					The address of an element may change whenever an
+* 					element is added.
+*
+****************************************************************************/
+
+#ifndef CHASHSTORAGE_H_
+#define CHASHSTORAGE_H_
+
+//System Include Files
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <functional>
+
+#if (defined(__GNUC__) && defined(__SSE2__))
+#define HASH_STORAGE_SSE2
+#include <emmintrin.h>
+#endif
+
+// a template class for the storage in a hash table
+template<class T1, class T2>
+class CHashStorage {
+public:
+
+	typedef std::vector<std::pair<T1, T2> >						Storage_Container_t;
+	typedef typename std::vector<std::pair<T1, T2> >::iterator			Storage_Itr_t;
+	typedef typename std::vector<std::pair<T1, T2> >::const_iterator	Storage_ConstItr_t;
+
+	/**
+	 * The elements move when other elements are added
+	 */
+	static const bool		HAS_STABLE_ADDRESSES = false;
+
+	/**
+	 * CHashStorage constructor
+	 */
+	CHashStorage();
+
+	/**
+	 * Add an element to the storage
+	 * param@ T1 const &key				-	key of the element			(IN)
+	 * param@ T2 const &elem			-	an element to be added		(IN)
+	 * returnvalue@ bool				-	false if the key already exists
+	 */
+	bool insert(T1 const &key, T2 const &elem);
+
+	/**
+	 * Find an element by its key
+	 * param@ T1 const &key				-	key of the element			(IN)
+	 * returnvalue@ T2*					-	Pointer to the element, 0 if not found
+	 */
+	T2* find(T1 const &key);
+	T2 const* find(T1 const &key) const;
+
+	/**
+	 * Visit all the elements in the order of their keys without copying them.
+	 * The visitor is called as visitor(T1 const &key, T2 const &elem).
+	 * param@ TVisitor &visitor			-	called for every element	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitInKeyOrder(TVisitor &visitor) const;
+
+	/**
+	 * Iterate the elements in the order they were added; itr->first is the key, itr->second the element
+	 * returnvalue@ Storage_Itr_t
+	 */
+	Storage_Itr_t begin();
+	Storage_Itr_t end();
+	Storage_ConstItr_t begin() const;
+	Storage_ConstItr_t end() const;
+
+	/**
+	 * Get the number of elements
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int size() const;
+
+	/**
+	 * Get the number of times the elements were moved other than by an insertion: never,
+	 * the elements move only when one is added; the Database adds it to its modification counter
+	 * returnvalue@ unsigned long
+	 */
+	unsigned long getMoveCount() const;
+
+	/**
+	 * Remove all the elements
+	 * returnvalue@ void
+	 */
+	void clear();
+
+	/**
+	 * Replace the content of the storage by the elements of the map
+	 * param@ std::map<T1, T2> const &elements	-	new content	(IN)
+	 * returnvalue@ void
+	 */
+	void assign(std::map<T1, T2> const &elements);
+
+	/**
+	 * Move a batch of elements into the storage, in linear time.
+	 * The elements whose key already exists (or repeats in the batch) are left in the batch.
+	 * param@ std::vector<std::pair<T1, T2> > &batch	-	elements sorted by key, the rejected ones afterwards	(IN/OUT)
+	 * param@ bool isMerge							-	false to replace the content of the storage				(IN)
+	 * returnvalue@ unsigned int					-	number of elements moved into the storage
+	 */
+	unsigned int load(std::vector<std::pair<T1, T2> > &batch, bool isMerge);
+
+	/**
+	 * Copy the content of the storage into a map
+	 * param@ std::map<T1, T2> &elements	-	content of the storage	(OUT)
+	 * returnvalue@ void
+	 */
+	void copyTo(std::map<T1, T2> &elements) const;
+
+private:
+
+	/**
+	 * Slots per group, control byte of a free slot, array index of a missing element
+	 */
+	static const unsigned int		GROUP_SIZE		= 16;
+	static const signed char		EMPTY			= -128;
+	static const unsigned int		NOT_FOUND		= 0xFFFFFFFFu;
+
+	/**
+	 * Elements in the order they were added, and the hash of every element
+	 */
+	Storage_Container_t				m_elements;
+	std::vector<size_t>				m_hashes;
+
+	/**
+	 * Hash table: control byte (7 bits of the hash or EMPTY) and element index of every slot
+	 */
+	std::vector<signed char>		m_control;
+	std::vector<unsigned int>		m_slots;
+
+	/**
+	 * Number of groups minus one; the number of groups is a power of 2
+	 */
+	size_t							m_groupMask;
+
+	/**
+	 * Element indexes sorted by key, valid while it has as many entries as there are elements
+	 */
+	std::vector<unsigned int>		m_order;
+
+	/**
+	 * Order of the element indexes by key
+	 */
+	struct KeyLess
+	{
+		Storage_Container_t const *pElements;
+
+		bool operator()(unsigned int lhs, unsigned int rhs) const
+		{
+			return (*pElements)[lhs].first < (*pElements)[rhs].first;
+		}
+	};
+
+	/**
+	 * Find the array index of an element
+	 * param@ T1 const &key				-	key of the element			(IN)
+	 * param@ size_t hash				-	hash of the key				(IN)
+	 * returnvalue@ unsigned int		-	array index, NOT_FOUND if the key does not exist
+	 */
+	unsigned int findIndex(T1 const &key, size_t hash) const;
+
+	/**
+	 * Append an element whose key does not exist yet; the table grows at 7/8 load
+	 * param@ std::pair<T1, T2> &&elem	-	element to be moved into the storage	(IN)
+	 * param@ size_t hash				-	hash of the key							(IN)
+	 * returnvalue@ void
+	 */
+	void append(std::pair<T1, T2> &&elem, size_t hash);
+
+	/**
+	 * Sort the indexes of all the elements by key
+	 * param@ std::vector<unsigned int> &order	-	element indexes in key order	(OUT)
+	 * returnvalue@ void
+	 */
+	void sortOrder(std::vector<unsigned int> &order) const;
+
+	/**
+	 * Put an element index into the first free slot of its probe sequence
+	 * param@ unsigned int index		-	array index of the element	(IN)
+	 * returnvalue@ void
+	 */
+	void place(unsigned int index);
+
+	/**
+	 * Rebuild the table with enough groups for the given number of elements
+	 * param@ unsigned int count		-	number of elements		(IN)
+	 * returnvalue@ void
+	 */
+	void reserve(unsigned int count);
+
+	/**
+	 * Hash of a key, first group of its probe sequence and its 7 bit tag
+	 */
+	static size_t hashKey(T1 const &key);
+	size_t firstGroup(size_t hash) const;
+	static signed char tag(size_t hash);
+
+	/**
+	 * Bit i is set if the control byte of slot i of the group equals the value
+	 * param@ signed char const *pGroup	-	control bytes of a group	(IN)
+	 * param@ signed char value			-	value to be compared		(IN)
+	 * returnvalue@ unsigned int
+	 */
+	static unsigned int matchGroup(signed char const *pGroup, signed char value);
+};
+/********************
+**  CLASS END
+*********************/
+
+template<class T1, class T2>
+const unsigned int CHashStorage<T1, T2>::GROUP_SIZE;
+
+template<class T1, class T2>
+const signed char CHashStorage<T1, T2>::EMPTY;
+
+template<class T1, class T2>
+const unsigned int CHashStorage<T1, T2>::NOT_FOUND;
+
+
+/**
+ * CHashStorage constructor
+ */
+template<class T1, class T2>
+CHashStorage<T1, T2>::CHashStorage()
+{
+	this->m_groupMask = 0;
+}
+
+
+/**
+ * Add an element to the storage
+ * param@ T1 const &key				-	key of the element			(IN)
+ * param@ T2 const &elem			-	an element to be added		(IN)
+ * returnvalue@ bool				-	false if the key already exists
+ */
+template<class T1, class T2>
+bool CHashStorage<T1, T2>::insert(T1 const &key, T2 const &elem)
+{
+	size_t 	hash 		= hashKey(key);
+	bool 	isInserted 	= (this->findIndex(key, hash) == NOT_FOUND);
+
+	if (isInserted)
+	{
+		this->append(std::pair<T1, T2>(key, elem), hash);
+	}
+
+	return isInserted;
+}
+
+
+/**
+ * Find an element by its key
+ * param@ T1 const &key				-	key of the element			(IN)
+ * returnvalue@ T2*					-	Pointer to the element, 0 if not found
+ */
+template<class T1, class T2>
+T2* CHashStorage<T1, T2>::find(T1 const &key)
+{
+	unsigned int index = this->findIndex(key, hashKey(key));
+
+	return (index == NOT_FOUND) ? 0 : &this->m_elements[index].second;
+}
+
+template<class T1, class T2>
+T2 const* CHashStorage<T1, T2>::find(T1 const &key) const
+{
+	unsigned int index = this->findIndex(key, hashKey(key));
+
+	return (index == NOT_FOUND) ? 0 : &this->m_elements[index].second;
+}
+
+
+/**
+ * Visit all the elements in the order of their keys without copying them.
+ * The visitor is called as visitor(T1 const &key, T2 const &elem).
+ * param@ TVisitor &visitor			-	called for every element	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+template<class TVisitor>
+void CHashStorage<T1, T2>::visitInKeyOrder(TVisitor &visitor) const
+{
+	std::vector<unsigned int> 			sorted;
+	std::vector<unsigned int> const 	*pOrder = &this->m_order;
+
+	// the index is dropped when an element is added, the storage is not changed here
+	if (this->m_order.size() != this->m_elements.size())
+	{
+		this->sortOrder(sorted);
+		pOrder = &sorted;
+	}
+
+	for (unsigned int index = 0; index < pOrder->size(); ++index)
+	{
+		std::pair<T1, T2> const &elem = this->m_elements[(*pOrder)[index]];
+
+		visitor(elem.first, elem.second);
+	}
+}
+
+
+/**
+ * Iterate the elements in the order they were added; itr->first is the key, itr->second the element
+ * returnvalue@ Storage_Itr_t
+ */
+template<class T1, class T2>
+typename CHashStorage<T1, T2>::Storage_Itr_t CHashStorage<T1, T2>::begin()
+{
+	return this->m_elements.begin();
+}
+
+template<class T1, class T2>
+typename CHashStorage<T1, T2>::Storage_Itr_t CHashStorage<T1, T2>::end()
+{
+	return this->m_elements.end();
+}
+
+template<class T1, class T2>
+typename CHashStorage<T1, T2>::Storage_ConstItr_t CHashStorage<T1, T2>::begin() const
+{
+	return this->m_elements.begin();
+}
+
+template<class T1, class T2>
+typename CHashStorage<T1, T2>::Storage_ConstItr_t CHashStorage<T1, T2>::end() const
+{
+	return this->m_elements.end();
+}
+
+
+/**
+ * Get the number of elements
+ * returnvalue@ unsigned int
+ */
+template<class T1, class T2>
+unsigned int CHashStorage<T1, T2>::size() const
+{
+	return this->m_elements.size();
+}
+
+
+/**
+ * Get the number of times the elements were moved other than by an insertion: never
+ * returnvalue@ unsigned long
+ */
+template<class T1, class T2>
+unsigned long CHashStorage<T1, T2>::getMoveCount() const
+{
+	// the elements move only when one is added
+	return 0;
+}
+
+
+/**
+ * Remove all the elements
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+void CHashStorage<T1, T2>::clear()
+{
+	// the memory is given back, not kept for the next elements
+	Storage_Container_t().swap(this->m_elements);
+	std::vector<size_t>().swap(this->m_hashes);
+	std::vector<signed char>().swap(this->m_control);
+	std::vector<unsigned int>().swap(this->m_slots);
+	std::vector<unsigned int>().swap(this->m_order);
+	this->m_groupMask = 0;
+}
+
+
+/**
+ * Replace the content of the storage by the elements of the map
+ * param@ std::map<T1, T2> const &elements	-	new content	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+void CHashStorage<T1, T2>::assign(std::map<T1, T2> const &elements)
+{
+	this->clear();
+	this->reserve(elements.size());
+
+	for (typename std::map<T1, T2>::const_iterator itr = elements.begin(); itr != elements.end(); ++itr)
+	{
+		this->append(std::pair<T1, T2>(itr->first, itr->second), hashKey(itr->first));
+	}
+
+	this->sortOrder(this->m_order);
+}
+
+
+/**
+ * Move a batch of elements into the storage, in linear time.
+ * The elements whose key already exists (or repeats in the batch) are left in the batch.
+ * param@ std::vector<std::pair<T1, T2> > &batch	-	elements sorted by key, the rejected ones afterwards	(IN/OUT)
+ * param@ bool isMerge							-	false to replace the content of the storage				(IN)
+ * returnvalue@ unsigned int					-	number of elements moved into the storage
+ */
+template<class T1, class T2>
+unsigned int CHashStorage<T1, T2>::load(std::vector<std::pair<T1, T2> > &batch, bool isMerge)
+{
+	unsigned int loaded 	= 0;
+	unsigned int rejected 	= 0;
+
+	if (!isMerge)
+	{
+		this->clear();
+	}
+
+	this->reserve(this->m_elements.size() + batch.size());
+
+	for (unsigned int index = 0; index < batch.size(); ++index)
+	{
+		size_t hash = hashKey(batch[index].first);
+
+		// a repeated key of the batch finds the element moved in before
+		if (this->findIndex(batch[index].first, hash) != NOT_FOUND)
+		{
+			if (rejected != index)
+			{
+				batch[rejected] = std::move(batch[index]);
+			}
+
+			++rejected;
+		}
+		else
+		{
+			this->append(std::move(batch[index]), hash);
+			++loaded;
+		}
+	}
+
+	batch.resize(rejected);
+
+	// sorted once for the whole batch
+	this->sortOrder(this->m_order);
+
+	return loaded;
+}
+
+
+/**
+ * Copy the content of the storage into a map
+ * param@ std::map<T1, T2> &elements	-	content of the storage	(OUT)
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+void CHashStorage<T1, T2>::copyTo(std::map<T1, T2> &elements) const
+{
+	elements.clear();
+	elements.insert(this->m_elements.begin(), this->m_elements.end());
+}
+
+
+/**
+ * Find the array index of an element
+ * param@ T1 const &key				-	key of the element			(IN)
+ * param@ size_t hash				-	hash of the key				(IN)
+ * returnvalue@ unsigned int		-	array index, NOT_FOUND if the key does not exist
+ */
+template<class T1, class T2>
+unsigned int CHashStorage<T1, T2>::findIndex(T1 const &key, size_t hash) const
+{
+	if (this->m_control.empty())
+	{
+		return NOT_FOUND;
+	}
+
+	size_t 		group 	= this->firstGroup(hash);
+	signed char value 	= tag(hash);
+
+	// triangular probing over the groups visits every group once
+	for (size_t step = 1; ; ++step)
+	{
+		signed char const 	*pGroup 	= &this->m_control[group * GROUP_SIZE];
+		unsigned int 		matches 	= matchGroup(pGroup, value);
+
+		while (matches)
+		{
+			unsigned int slot 	= group * GROUP_SIZE + __builtin_ctz(matches);
+			unsigned int index 	= this->m_slots[slot];
+
+			if ((this->m_hashes[index] == hash) && (this->m_elements[index].first == key))
+			{
+				return index;
+			}
+
+			matches &= matches - 1;
+		}
+
+		// the key would have been placed into a free slot of this group
+		if (matchGroup(pGroup, EMPTY))
+		{
+			return NOT_FOUND;
+		}
+
+		group = (group + step) & this->m_groupMask;
+	}
+}
+
+
+/**
+ * Append an element whose key does not exist yet; the table grows at 7/8 load
+ * param@ std::pair<T1, T2> &&elem	-	element to be moved into the storage	(IN)
+ * param@ size_t hash				-	hash of the key							(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+void CHashStorage<T1, T2>::append(std::pair<T1, T2> &&elem, size_t hash)
+{
+	this->reserve(this->m_elements.size() + 1);
+
+	this->m_elements.push_back(std::move(elem));
+	this->m_hashes.push_back(hash);
+	this->place(this->m_elements.size() - 1);
+
+	// the key order is sorted again by the bulk loads
+	this->m_order.clear();
+}
+
+
+/**
+ * Sort the indexes of all the elements by key
+ * param@ std::vector<unsigned int> &order	-	element indexes in key order	(OUT)
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+void CHashStorage<T1, T2>::sortOrder(std::vector<unsigned int> &order) const
+{
+	KeyLess isBefore = { &this->m_elements };
+
+	order.resize(this->m_elements.size());
+
+	for (unsigned int index = 0; index < order.size(); ++index)
+	{
+		order[index] = index;
+	}
+
+	std::sort(order.begin(), order.end(), isBefore);
+}
+
+
+/**
+ * Put an element index into the first free slot of its probe sequence
+ * param@ unsigned int index		-	array index of the element	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+void CHashStorage<T1, T2>::place(unsigned int index)
+{
+	size_t hash 	= this->m_hashes[index];
+	size_t group 	= this->firstGroup(hash);
+
+	for (size_t step = 1; ; ++step)
+	{
+		unsigned int freeSlots = matchGroup(&this->m_control[group * GROUP_SIZE], EMPTY);
+
+		if (freeSlots)
+		{
+			unsigned int slot = group * GROUP_SIZE + __builtin_ctz(freeSlots);
+
+			this->m_control[slot] 	= tag(hash);
+			this->m_slots[slot] 	= index;
+			return;
+		}
+
+		group = (group + step) & this->m_groupMask;
+	}
+}
+
+
+/**
+ * Rebuild the table with enough groups for the given number of elements
+ * param@ unsigned int count		-	number of elements		(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2>
+void CHashStorage<T1, T2>::reserve(unsigned int count)
+{
+	size_t groups = this->m_control.size() / GROUP_SIZE;
+
+	if ((groups != 0) && ((size_t)count * 8 <= groups * GROUP_SIZE * 7))
+	{
+		return;
+	}
+
+	if (groups == 0)
+	{
+		groups = 1;
+	}
+
+	while ((size_t)count * 8 > groups * GROUP_SIZE * 7)
+	{
+		groups *= 2;
+	}
+
+	this->m_control.assign(groups * GROUP_SIZE, EMPTY);
+	this->m_slots.resize(groups * GROUP_SIZE);
+	this->m_groupMask = groups - 1;
+	this->m_elements.reserve(count);
+	this->m_hashes.reserve(count);
+
+	// the stored hashes spare hashing the keys again
+	for (unsigned int index = 0; index < this->m_elements.size(); ++index)
+	{
+		this->place(index);
+	}
+}
+
+
+/**
+ * Hash of a key: the standard hash, mixed so that also weak hashes spread over the whole table
+ */
+template<class T1, class T2>
+size_t CHashStorage<T1, T2>::hashKey(T1 const &key)
+{
+	unsigned long long mixed = (unsigned long long)std::hash<T1>()(key) * 0x9E3779B97F4A7C15ull;
+
+	return (size_t)(mixed ^ (mixed >> 32));
+}
+
+/**
+ * First group of the probe sequence of a hash
+ */
+template<class T1, class T2>
+size_t CHashStorage<T1, T2>::firstGroup(size_t hash) const
+{
+	return (hash >> 7) & this->m_groupMask;
+}
+
+/**
+ * Control byte of a hash: its lowest 7 bits, never EMPTY
+ */
+template<class T1, class T2>
+signed char CHashStorage<T1, T2>::tag(size_t hash)
+{
+	return (signed char)(hash & 0x7F);
+}
+
+
+/**
+ * Bit i is set if the control byte of slot i of the group equals the value
+ * param@ signed char const *pGroup	-	control bytes of a group	(IN)
+ * param@ signed char value			-	value to be compared		(IN)
+ * returnvalue@ unsigned int
+ */
+template<class T1, class T2>
+unsigned int CHashStorage<T1, T2>::matchGroup(signed char const *pGroup, signed char value)
+{
+#ifdef HASH_STORAGE_SSE2
+	__m128i control = _mm_loadu_si128(reinterpret_cast<__m128i const *>(pGroup));
+
+	return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(value)));
+#else
+	unsigned int matches = 0;
+
+	for (unsigned int slot = 0; slot < GROUP_SIZE; ++slot)
+	{
+		matches |= (unsigned int)(pGroup[slot] == value) << slot;
+	}
+
+	return matches;
+#endif
+}
+
+#endif /* CHASHSTORAGE_H_ */
@@ -19,11 +19,66 @@
 //Own Include Files
 #include "CPOI.h"
 #include "CJsonPersistence.h"
+#include "CBufferedWriter.h"
 
 
 using namespace std;
 using namespace APT;
 
+/**
+ * Writes every visited Waypoint as an object of the "waypoints" array, straight from the database
+ */
+struct CJsonWaypointWriter
+{
+	CBufferedWriter	*pWriter;
+	unsigned int	remaining;
+
+	void operator()(Wp_Database_key_t const &, CWaypoint const &wp)
+	{
+		// assuming all the elements in Database is valid
+		CPooledString const &name = wp.getPooledName();
+
+		*pWriter << "\t{\n";
+		*pWriter << "\t\t\"name\": \"";
+		pWriter->write(name.data(), name.size());
+		*pWriter << "\",\n";
+		*pWriter << "\t\t\"latitude\": " << wp.getLatitude() << ",\n";
+		*pWriter << "\t\t\"longitude\": " << wp.getLongitude() << "\n";
+
+		// check if this is the last element in the database
+		*pWriter << ((--remaining) ? "\t},\n" : "\t}\n");
+	}
+};
+
+/**
+ * Writes every visited POI as an object of the "pois" array, straight from the database
+ */
+struct CJsonPoiWriter
+{
+	CBufferedWriter	*pWriter;
+	unsigned int	remaining;
+
+	void operator()(POI_Database_key_t const &, CPOI const &poi)
+	{
+		// assuming all the elements in Database is valid
+		CPooledString const &name 			= poi.getPooledName();
+		CPooledString const &description 	= poi.getPooledDescription();
+
+		*pWriter << "\t{\n";
+		*pWriter << "\t\t\"name\": \"";
+		pWriter->write(name.data(), name.size());
+		*pWriter << "\",\n";
+		*pWriter << "\t\t\"latitude\": " << poi.getLatitude() << ",\n";
+		*pWriter << "\t\t\"longitude\": " << poi.getLongitude() << ",\n";
+		*pWriter << "\t\t\"type\": \"" << poi.getPoiTypeName() << "\",\n";
+		*pWriter << "\t\t\"description\": \"";
+		pWriter->write(description.data(), description.size());
+		*pWriter << "\"\n";
+
+		*pWriter << ((--remaining) ? "\t},\n" : "\t}\n");
+	}
+};
+
 CJsonPersistence::CJsonPersistence()
 {
 	this->m_pToken 					= 0;
@@ -69,111 +124,50 @@ void CJsonPersistence::setMediaName(string name)
 */
 bool CJsonPersistence::writeData (const CWpDatabase& waypointDb, const CPoiDatabase& poiDb)
 {
-	bool			ret = true;
-	ofstream 		fileStream;
-	string 			fileName;
+	bool				ret = true;
+	CBufferedWriter 	writer;
+	string 				fileName;
 
 	cout << "=======================================================\n";
 	cout << "INFO: Waypoint Database backup request\n";
 
 	fileName = this->mediaName;
-	fileStream.precision(10);
 
-	fileStream.open(fileName.c_str(), ofstream::out);
-
-	if (!fileStream.fail())
+	if (writer.open(fileName))
 	{
-		CWpDatabase::Wp_Map_t		Waypoints;
-		CPoiDatabase::Poi_Map_t		Pois;
-		CPOI::t_poi		type;
-		string			name, description, typeName;
-		double 			latitude, longitude;
-
-		Waypoints = waypointDb.getWpsFromDatabase();
+		CJsonWaypointWriter wpWriter 	= { &writer, waypointDb.getElementCount() };
+		CJsonPoiWriter 		poiWriter 	= { &writer, poiDb.getElementCount() };
 
-		// create waypoint object in the Json format
-		fileStream << "{\n";
-		fileStream << "\"waypoints\": [\n";
-
-		for (CWpDatabase::Wp_Map_Itr_t itr = Waypoints.begin(); itr != Waypoints.end(); ++(itr))
-		{
-			// assuming all the elements in Database is valid
-			itr->second.getAllDataByReference(name, latitude, longitude);
+		// create waypoint object in the Json format, streamed from the database
+		writer << "{\n";
+		writer << "\"waypoints\": [\n";
 
-			fileStream << "\t{\n";
-			fileStream << "\t\t\"name\": \"" << name << "\",\n";
-			fileStream << "\t\t\"latitude\": " << latitude << ",\n";
-			fileStream << "\t\t\"longitude\": " << longitude << "\n";
-
-			// check if this is the last element in the database
-			if (&(*itr) != &(*Waypoints.rbegin()))
-			{
-				fileStream << "\t},\n";
-			}
-			else
-			{
-				fileStream << "\t}\n";
-			}
-
-			if (fileStream.fail())
-			{
-				fileStream.clear();
-				cout << "WARNING: Error writing a Waypoint into the file.\n" << itr->second << endl;
-				ret = false;
-			}
-		}
+		waypointDb.visitWaypoints(wpWriter);
 
 		// end the waypoint object
-		fileStream << "],\n";
+		writer << "],\n";
 
-		Pois = poiDb.getPoisFromDatabase();
+		// create poi object in the Json format
+		writer << "\"pois\": [\n";
 
-		// create waypoint object in the Json format
-		fileStream << "\"pois\": [\n";
+		poiDb.visitPois(poiWriter);
 
-		for (CPoiDatabase::Poi_Map_Itr_t itr = Pois.begin(); itr != Pois.end(); ++(itr))
-		{
-			// assuming all the elements in Database is valid
-			itr->second.getAllDataByReference(name, latitude, longitude, type, description);
-			typeName = itr->second.getPoiTypeName();
-
-			fileStream << "\t{\n";
-			fileStream << "\t\t\"name\": \"" << name << "\",\n";
-			fileStream << "\t\t\"latitude\": " << latitude << ",\n";
-			fileStream << "\t\t\"longitude\": " << longitude << ",\n";
-			fileStream << "\t\t\"type\": \"" << typeName << "\",\n";
-			fileStream << "\t\t\"description\": \"" << description << "\"\n";
-
-			if (&(*itr) != &(*Pois.rbegin()))
-			{
-				fileStream << "\t},\n";
-			}
-			else
-			{
-				fileStream << "\t}\n";
-			}
+		// end the poi object
+		writer << "]\n}\n";
 
-			if (fileStream.fail())
-			{
-				fileStream.clear();
-				cout << "WARNING: Error writing a POI into the file.\n" << itr->second << endl;
-				ret = false;
-			}
+		// the blocks are checked once, when the file is complete
+		if (!writer.close())
+		{
+			cout << "WARNING: Error writing the Databases into the file - " << fileName << endl;
+			ret = false;
 		}
-
-		// end the poi object
-		fileStream << "]\n}\n";
 	}
 	else
 	{
-		fileStream.clear();
 		cout << "WARNING: Error opening the file to write - " << fileName << endl;
 		ret = false;
 	}
 
-	fileStream.flush();
-	fileStream.close();
-
 	cout << "=======================================================\n";
 	return ret;
 }
@@ -233,8 +227,9 @@ bool CJsonPersistence::readData (CWpDatabase& waypointDb, CPoiDatabase& poiDb, M
 		 */
 		try
 		{
-			CDatabase<Wp_Database_key_t, CWaypoint>::Database_Container_t	wpsRead 	= waypointDb.getDatabase();
-			CDatabase<POI_Database_key_t, CPOI>::Database_Container_t		poisRead	= poiDb.getDatabase();
+			// the elements are collected and loaded at once when the whole file is read
+			CWpDatabase::Database_Batch_t	wpsRead;
+			CPoiDatabase::Database_Batch_t	poisRead;
 
 			CPOI::t_poi		type = CPOI::DEFAULT_POI;
 			string			name = "", description = "";
@@ -391,46 +386,47 @@ bool CJsonPersistence::readData (CWpDatabase& waypointDb, CPoiDatabase& poiDb, M
 								{
 									if (this->m_currentObjectRead[WAYPOINTS])
 									{
-										CWaypoint wp(name, latitude, longitude);
+										CPooledString pooledName;
 
-										if (!wp.getName().empty())
+										// a string which the full pool cannot take is not replaced by the empty string
+										if (!CPooledString::intern(name, pooledName))
 										{
-											pair<CDatabase<Wp_Database_key_t, CWaypoint>::Database_Container_Itr_t, bool> 	ret;
-
-											ret = wpsRead.insert(std::pair<Wp_Database_key_t, CWaypoint>(wp.getName(), wp));
-
-											if (ret.second == false)
-											{
-												std::cout << "WARNING: Element already exists in the Database.\n";
-												std::cout << "Key = " << wp.getName() << endl;
-												std::cout << "Element = " << wp << endl;
-											}
+											cout << "ERROR: The string pool is full, the Waypoint " << name << " is not added\n";
 										}
 										else
 										{
-											cout << "ERROR: Invalid Waypoint Values\n";
+											CWaypoint wp(pooledName, latitude, longitude);
+
+											if (!wp.getName().empty())
+											{
+												wpsRead.push_back(std::pair<Wp_Database_key_t, CWaypoint>(wp.getName(), std::move(wp)));
+											}
+											else
+											{
+												cout << "ERROR: Invalid Waypoint Values\n";
+											}
 										}
 									}
 									else if (this->m_currentObjectRead[POINT_OF_INTEREST])
 									{
-										CPOI poi(type, name, description, latitude, longitude);
+										CPooledString pooledName, pooledDescription;
 
-										if (!poi.getName().empty())
+										if (!CPooledString::intern(name, pooledName) || !CPooledString::intern(description, pooledDescription))
 										{
-											pair<CDatabase<POI_Database_key_t, CPOI>::Database_Container_Itr_t, bool> 	ret;
-
-											ret = poisRead.insert(std::pair<POI_Database_key_t, CPOI>(poi.getName(), poi));
-
-											if (ret.second == false)
-											{
-												std::cout << "WARNING: Element already exists in the Database.\n";
-												std::cout << "Key = " << poi.getName() << endl;
-												std::cout << "Element = " << poi << endl;
-											}
+											cout << "ERROR: The string pool is full, the POI " << name << " is not added\n";
 										}
 										else
 										{
-											cout << "ERROR: Invalid POI Values\n";
+											CPOI poi(type, pooledName, pooledDescription, latitude, longitude);
+
+											if (!poi.getName().empty())
+											{
+												poisRead.push_back(std::pair<POI_Database_key_t, CPOI>(poi.getName(), std::move(poi)));
+											}
+											else
+											{
+												cout << "ERROR: Invalid POI Values\n";
+											}
 										}
 									}
 									previousState = currentState;
@@ -508,17 +504,14 @@ bool CJsonPersistence::readData (CWpDatabase& waypointDb, CPoiDatabase& poiDb, M
 			if (mode == CJsonPersistence::MERGE)
 			{
 				cout << "INFO: Waypoint Database Merge Request.\n";
-				waypointDb.setDatabase(wpsRead);
-				poiDb.setDatabase(poisRead);
+				waypointDb.mergeElements(wpsRead);
+				poiDb.mergeElements(poisRead);
 			}
 			else if (mode == CJsonPersistence::REPLACE)
 			{
 				cout << "INFO: Waypoint Database Replace Request.\n";
-				waypointDb.resetWpsDatabase();
-				poiDb.resetPoisDatabase();
-
-				waypointDb.setDatabase(wpsRead);
-				poiDb.setDatabase(poisRead);
+				waypointDb.replaceElements(wpsRead);
+				poiDb.replaceElements(poisRead);
 			}
 			else
 			{
@@ -526,6 +519,9 @@ bool CJsonPersistence::readData (CWpDatabase& waypointDb, CPoiDatabase& poiDb, M
 				return false;
 			}
 
+			// index all the POIs of the file at once
+			poiDb.buildSpatialIndex();
+
 			cout << "=======================================================\n";
 
 		}
@@ -0,0 +1,435 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMapStorage.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a template class CMapStorage.
+* 					The class CMapStorage is the default storage policy
+* 					of the CDatabase: the elements are kept in a
+* 					std::map ordered by their key. The address of an
+* 					element never changes while it is in the storage.
+* 					The nodes of the map are taken from an arena given as
+* 					template parameter (CArena.h); with the default
+* 					CMonotonicArena a bulk load allocates large blocks
+* 					instead of one node per element, and clearing the
+* 					storage frees them at once.
+*
+****************************************************************************/
+
+#ifndef CMAPSTORAGE_H_
+#define CMAPSTORAGE_H_
+
+//System Include Files
+#include <map>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <new>
+#include <type_traits>
+
+//Own Include Files
+#include "CArena.h"
+
+// a template class for the storage ordered by key, the nodes of the map are taken from a TArena
+template<class T1, class T2, class TArena = CMonotonicArena>
+class CMapStorage {
+public:
+
+	typedef CArenaAllocator<std::pair<const T1, T2>, TArena>			Storage_Allocator_t;
+	typedef std::map<T1, T2, std::less<T1>, Storage_Allocator_t>		Storage_Container_t;
+	typedef typename Storage_Container_t::iterator						Storage_Itr_t;
+	typedef typename Storage_Container_t::const_iterator				Storage_ConstItr_t;
+
+	/**
+	 * The elements keep their address when other elements are added
+	 */
+	static const bool		HAS_STABLE_ADDRESSES = true;
+
+	/**
+	 * CMapStorage constructor
+	 */
+	CMapStorage();
+
+	/**
+	 * CMapStorage copy constructor: the copy takes the nodes from its own arena
+	 * param@ CMapStorage const &origin	-	storage to be copied	(IN)
+	 */
+	CMapStorage(CMapStorage const &origin);
+
+	/**
+	 * CMapStorage destructor: releases all the nodes at once
+	 */
+	~CMapStorage();
+
+	/**
+	 * A copy assignment operator: the nodes are taken from the own arena
+	 * param@ CMapStorage const &rhs		-	storage to be copied	(IN)
+	 * returnvalue@ CMapStorage&
+	 */
+	CMapStorage& operator=(CMapStorage const &rhs);
+
+	/**
+	 * Add an element to the storage
+	 * param@ T1 const &key				-	key of the element			(IN)
+	 * param@ T2 const &elem			-	an element to be added		(IN)
+	 * returnvalue@ bool				-	false if the key already exists
+	 */
+	bool insert(T1 const &key, T2 const &elem);
+
+	/**
+	 * Find an element by its key
+	 * param@ T1 const &key				-	key of the element			(IN)
+	 * returnvalue@ T2*					-	Pointer to the element, 0 if not found
+	 */
+	T2* find(T1 const &key);
+	T2 const* find(T1 const &key) const;
+
+	/**
+	 * Visit all the elements in the order of their keys without copying them.
+	 * The visitor is called as visitor(T1 const &key, T2 const &elem).
+	 * param@ TVisitor &visitor			-	called for every element	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitInKeyOrder(TVisitor &visitor) const;
+
+	/**
+	 * Iterate the elements in the order of their keys; itr->first is the key, itr->second the element
+	 * returnvalue@ Storage_Itr_t
+	 */
+	Storage_Itr_t begin();
+	Storage_Itr_t end();
+	Storage_ConstItr_t begin() const;
+	Storage_ConstItr_t end() const;
+
+	/**
+	 * Get the number of elements
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int size() const;
+
+	/**
+	 * Get the number of times the elements were moved other than by an insertion: never,
+	 * the Database adds it to its modification counter
+	 * returnvalue@ unsigned long
+	 */
+	unsigned long getMoveCount() const;
+
+	/**
+	 * Remove all the elements and give back their memory. If the arena can release all
+	 * its memory at once and the keys and elements own no resources (CArenaTraits), the
+	 * nodes are not destroyed one by one and the cost does not depend on the number of elements.
+	 * returnvalue@ void
+	 */
+	void clear();
+
+	/**
+	 * Replace the content of the storage by the elements of the map
+	 * param@ std::map<T1, T2> const &elements	-	new content	(IN)
+	 * returnvalue@ void
+	 */
+	void assign(std::map<T1, T2> const &elements);
+
+	/**
+	 * Move a batch of elements sorted by key into the storage, in linear time.
+	 * The elements whose key already exists (or repeats in the batch) are left in the batch.
+	 * param@ std::vector<std::pair<T1, T2> > &batch	-	elements sorted by key, the rejected ones afterwards	(IN/OUT)
+	 * param@ bool isMerge							-	false to replace the content of the storage				(IN)
+	 * returnvalue@ unsigned int					-	number of elements moved into the storage
+	 */
+	unsigned int load(std::vector<std::pair<T1, T2> > &batch, bool isMerge);
+
+	/**
+	 * Copy the content of the storage into a map
+	 * param@ std::map<T1, T2> &elements	-	content of the storage	(OUT)
+	 * returnvalue@ void
+	 */
+	void copyTo(std::map<T1, T2> &elements) const;
+
+private:
+
+	/**
+	 * Source of the nodes of the map, it has to outlive the map
+	 */
+	TArena								m_arena;
+
+	/**
+	 * Elements ordered by key
+	 */
+	Storage_Container_t					m_elements;
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * CMapStorage constructor
+ */
+template<class T1, class T2, class TArena>
+CMapStorage<T1, T2, TArena>::CMapStorage() : m_elements(std::less<T1>(), Storage_Allocator_t(&m_arena))
+{
+}
+
+
+/**
+ * CMapStorage copy constructor: the copy takes the nodes from its own arena
+ * param@ CMapStorage const &origin	-	storage to be copied	(IN)
+ */
+template<class T1, class T2, class TArena>
+CMapStorage<T1, T2, TArena>::CMapStorage(CMapStorage const &origin) : m_elements(origin.m_elements.begin(), origin.m_elements.end(), std::less<T1>(), Storage_Allocator_t(&m_arena))
+{
+}
+
+
+/**
+ * CMapStorage destructor: releases all the nodes at once
+ */
+template<class T1, class T2, class TArena>
+CMapStorage<T1, T2, TArena>::~CMapStorage()
+{
+	this->clear();
+}
+
+
+/**
+ * A copy assignment operator: the nodes are taken from the own arena
+ * param@ CMapStorage const &rhs		-	storage to be copied	(IN)
+ * returnvalue@ CMapStorage&
+ */
+template<class T1, class T2, class TArena>
+CMapStorage<T1, T2, TArena>& CMapStorage<T1, T2, TArena>::operator=(CMapStorage const &rhs)
+{
+	if (this != &rhs)
+	{
+		this->clear();
+		this->m_elements.insert(rhs.m_elements.begin(), rhs.m_elements.end());
+	}
+
+	return *this;
+}
+
+
+/**
+ * Add an element to the storage
+ * param@ T1 const &key				-	key of the element			(IN)
+ * param@ T2 const &elem			-	an element to be added		(IN)
+ * returnvalue@ bool				-	false if the key already exists
+ */
+template<class T1, class T2, class TArena>
+bool CMapStorage<T1, T2, TArena>::insert(T1 const &key, T2 const &elem)
+{
+	return this->m_elements.insert(std::pair<T1, T2>(key, elem)).second;
+}
+
+
+/**
+ * Find an element by its key
+ * param@ T1 const &key				-	key of the element			(IN)
+ * returnvalue@ T2*					-	Pointer to the element, 0 if not found
+ */
+template<class T1, class T2, class TArena>
+T2* CMapStorage<T1, T2, TArena>::find(T1 const &key)
+{
+	T2				*pT2	= 0;
+	Storage_Itr_t	itr		= this->m_elements.find(key);
+
+	if (itr != this->m_elements.end())
+	{
+		pT2 = &itr->second;
+	}
+
+	return pT2;
+}
+
+template<class T1, class T2, class TArena>
+T2 const* CMapStorage<T1, T2, TArena>::find(T1 const &key) const
+{
+	T2 const			*pT2	= 0;
+	Storage_ConstItr_t	itr		= this->m_elements.find(key);
+
+	if (itr != this->m_elements.end())
+	{
+		pT2 = &itr->second;
+	}
+
+	return pT2;
+}
+
+
+/**
+ * Visit all the elements in the order of their keys without copying them.
+ * The visitor is called as visitor(T1 const &key, T2 const &elem).
+ * param@ TVisitor &visitor			-	called for every element	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+template<class TVisitor>
+void CMapStorage<T1, T2, TArena>::visitInKeyOrder(TVisitor &visitor) const
+{
+	for (Storage_ConstItr_t itr = this->m_elements.begin(); itr != this->m_elements.end(); ++itr)
+	{
+		visitor(itr->first, itr->second);
+	}
+}
+
+
+/**
+ * Iterate the elements in the order of their keys; itr->first is the key, itr->second the element
+ * returnvalue@ Storage_Itr_t
+ */
+template<class T1, class T2, class TArena>
+typename CMapStorage<T1, T2, TArena>::Storage_Itr_t CMapStorage<T1, T2, TArena>::begin()
+{
+	return this->m_elements.begin();
+}
+
+template<class T1, class T2, class TArena>
+typename CMapStorage<T1, T2, TArena>::Storage_Itr_t CMapStorage<T1, T2, TArena>::end()
+{
+	return this->m_elements.end();
+}
+
+template<class T1, class T2, class TArena>
+typename CMapStorage<T1, T2, TArena>::Storage_ConstItr_t CMapStorage<T1, T2, TArena>::begin() const
+{
+	return this->m_elements.begin();
+}
+
+template<class T1, class T2, class TArena>
+typename CMapStorage<T1, T2, TArena>::Storage_ConstItr_t CMapStorage<T1, T2, TArena>::end() const
+{
+	return this->m_elements.end();
+}
+
+
+/**
+ * Get the number of elements
+ * returnvalue@ unsigned int
+ */
+template<class T1, class T2, class TArena>
+unsigned int CMapStorage<T1, T2, TArena>::size() const
+{
+	return this->m_elements.size();
+}
+
+
+/**
+ * Get the number of times the elements were moved other than by an insertion: never
+ * returnvalue@ unsigned long
+ */
+template<class T1, class T2, class TArena>
+unsigned long CMapStorage<T1, T2, TArena>::getMoveCount() const
+{
+	// a node never moves
+	return 0;
+}
+
+
+/**
+ * Remove all the elements and give back their memory. If the arena can release all
+ * its memory at once and the keys and elements own no resources (CArenaTraits), the
+ * nodes are not destroyed one by one and the cost does not depend on the number of elements.
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+void CMapStorage<T1, T2, TArena>::clear()
+{
+	static_assert(std::is_trivially_destructible<Storage_Allocator_t>::value, "an abandoned map must not need its allocator destroyed");
+
+	if (TArena::CAN_RELEASE_ALL && CArenaTraits<T1>::CAN_SKIP_DESTRUCTOR && CArenaTraits<T2>::CAN_SKIP_DESTRUCTOR)
+	{
+		// the old map and its nodes are abandoned, their memory goes with the arena. The map is
+		// not destroyed before its memory is reused: its destructor would only destroy the elements,
+		// which opted out of that (CArenaTraits), and give the nodes back to the arena
+		new (&this->m_elements) Storage_Container_t(std::less<T1>(), Storage_Allocator_t(&this->m_arena));
+	}
+	else
+	{
+		this->m_elements.clear();
+	}
+
+	this->m_arena.release();
+}
+
+
+/**
+ * Replace the content of the storage by the elements of the map
+ * param@ std::map<T1, T2> const &elements	-	new content	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+void CMapStorage<T1, T2, TArena>::assign(std::map<T1, T2> const &elements)
+{
+	this->clear();
+	this->m_elements.insert(elements.begin(), elements.end());
+}
+
+
+/**
+ * Move a batch of elements sorted by key into the storage, in linear time.
+ * The elements whose key already exists (or repeats in the batch) are left in the batch.
+ * param@ std::vector<std::pair<T1, T2> > &batch	-	elements sorted by key, the rejected ones afterwards	(IN/OUT)
+ * param@ bool isMerge							-	false to replace the content of the storage				(IN)
+ * returnvalue@ unsigned int					-	number of elements moved into the storage
+ */
+template<class T1, class T2, class TArena>
+unsigned int CMapStorage<T1, T2, TArena>::load(std::vector<std::pair<T1, T2> > &batch, bool isMerge)
+{
+	unsigned int 	loaded 		= 0;
+	unsigned int 	rejected 	= 0;
+	Storage_Itr_t 	next 		= this->m_elements.begin();
+
+	if (!isMerge)
+	{
+		this->clear();
+		next = this->m_elements.end();
+	}
+
+	for (unsigned int index = 0; index < batch.size(); ++index)
+	{
+		// walk the map along with the batch, every element is inserted right before its successor
+		while ((next != this->m_elements.end()) && (next->first < batch[index].first))
+		{
+			++next;
+		}
+
+		bool isDuplicate = ((next != this->m_elements.end()) && !(batch[index].first < next->first))
+							|| ((next != this->m_elements.begin()) && !(std::prev(next)->first < batch[index].first));
+
+		if (isDuplicate)
+		{
+			if (rejected != index)
+			{
+				batch[rejected] = std::move(batch[index]);
+			}
+
+			++rejected;
+		}
+		else
+		{
+			this->m_elements.emplace_hint(next, std::move(batch[index].first), std::move(batch[index].second));
+			++loaded;
+		}
+	}
+
+	batch.resize(rejected);
+
+	return loaded;
+}
+
+
+/**
+ * Copy the content of the storage into a map
+ * param@ std::map<T1, T2> &elements	-	content of the storage	(OUT)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+void CMapStorage<T1, T2, TArena>::copyTo(std::map<T1, T2> &elements) const
+{
+	elements.clear();
+	elements.insert(this->m_elements.begin(), this->m_elements.end());
+}
+
+#endif /* CMAPSTORAGE_H_ */
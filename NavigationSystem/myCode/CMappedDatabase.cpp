@@ -0,0 +1,480 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMappedDatabase.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CMappedDatabase.
+*
+****************************************************************************/
+
+//System Include Files
+#include <iostream>
+#include <algorithm>
+
+//Own Include Files
+#include "CMappedDatabase.h"
+
+//Namespaces
+using namespace std;
+
+//Method Implementations
+/**
+ * CMappedDatabase constructor: no file is open
+ */
+CMappedDatabase::CMappedDatabase()
+{
+	this->close();
+}
+
+
+/**
+ * CMappedDatabase destructor: releases the mapping
+ */
+CMappedDatabase::~CMappedDatabase()
+{
+	// the mapping is released by m_file
+}
+
+
+/**
+ * Map a snapshot file; only the header is checked, the content is read by the queries.
+ * A file opened before is closed.
+ * param@ std::string const &fileName	-	name of the snapshot file	(IN)
+ * returnvalue@ bool					-	false if the file can not be mapped or is not a valid snapshot
+ */
+bool CMappedDatabase::open(string const &fileName)
+{
+	this->close();
+
+	// the queries jump through the file, a read ahead would fault in pages nobody asked for
+	if (!this->m_file.open(fileName, CMappedFile::RANDOM))
+	{
+		cout << "WARNING: Error opening the file to read - " << fileName << endl;
+		return false;
+	}
+
+	char const 					*pData 		= this->m_file.getData();
+	CSnapshot::Header const 	*pHeader 	= CSnapshot::getHeader(pData, this->m_file.getSize());
+
+	if (!pHeader)
+	{
+		cout << "WARNING: The file is not a valid snapshot - " << fileName << endl;
+		this->m_file.close();
+		return false;
+	}
+
+	this->m_pHeader 			= pHeader;
+	this->m_pWpLatitudes 		= CSnapshot::getSection<double>(pData, *pHeader, CSnapshot::WP_LATITUDES);
+	this->m_pWpLongitudes 		= CSnapshot::getSection<double>(pData, *pHeader, CSnapshot::WP_LONGITUDES);
+	this->m_pWpNames 			= CSnapshot::getSection<CSnapshot::String>(pData, *pHeader, CSnapshot::WP_NAMES);
+	this->m_pPoiLatitudes 		= CSnapshot::getSection<double>(pData, *pHeader, CSnapshot::POI_LATITUDES);
+	this->m_pPoiLongitudes 		= CSnapshot::getSection<double>(pData, *pHeader, CSnapshot::POI_LONGITUDES);
+	this->m_pPoiNames 			= CSnapshot::getSection<CSnapshot::String>(pData, *pHeader, CSnapshot::POI_NAMES);
+	this->m_pPoiDescriptions 	= CSnapshot::getSection<CSnapshot::String>(pData, *pHeader, CSnapshot::POI_DESCRIPTIONS);
+	this->m_pPoiTypes 			= CSnapshot::getSection<uint8_t>(pData, *pHeader, CSnapshot::POI_TYPES);
+	this->m_pHeap 				= CSnapshot::getSection<char>(pData, *pHeader, CSnapshot::STRING_HEAP);
+	this->m_heapSize 			= pHeader->sections[CSnapshot::STRING_HEAP].size;
+	this->m_pWpTree 			= CSnapshot::getSection<CSnapshot::Node>(pData, *pHeader, CSnapshot::WP_TREE);
+	this->m_pPoiTrees 			= CSnapshot::getSection<CSnapshot::Node>(pData, *pHeader, CSnapshot::POI_TREES);
+	this->m_pPoiTreeBounds 		= CSnapshot::getSection<uint32_t>(pData, *pHeader, CSnapshot::POI_TREE_BOUNDS);
+
+	return true;
+}
+
+
+/**
+ * Release the mapping
+ * returnvalue@ void
+ */
+void CMappedDatabase::close()
+{
+	this->m_file.close();
+
+	this->m_pHeader 			= 0;
+	this->m_pWpLatitudes 		= 0;
+	this->m_pWpLongitudes 		= 0;
+	this->m_pWpNames 			= 0;
+	this->m_pPoiLatitudes 		= 0;
+	this->m_pPoiLongitudes 		= 0;
+	this->m_pPoiNames 			= 0;
+	this->m_pPoiDescriptions 	= 0;
+	this->m_pPoiTypes 			= 0;
+	this->m_pHeap 				= 0;
+	this->m_heapSize 			= 0;
+	this->m_pWpTree 			= 0;
+	this->m_pPoiTrees 			= 0;
+	this->m_pPoiTreeBounds 		= 0;
+}
+
+
+/**
+ * Check if a snapshot is mapped
+ * returnvalue@ bool
+ */
+bool CMappedDatabase::isOpen() const
+{
+	return (this->m_pHeader != 0);
+}
+
+
+/**
+ * Check the checksum of the mapped snapshot; the whole file is read
+ * returnvalue@ bool					-	false if no file is open or the file is damaged
+ */
+bool CMappedDatabase::verify() const
+{
+	return this->isOpen() && CSnapshot::hasValidChecksum(this->m_file.getData(), *this->m_pHeader);
+}
+
+
+/**
+ * Get the number of elements; 0 if no file is open
+ * returnvalue@ unsigned int
+ */
+unsigned int CMappedDatabase::getWaypointCount() const
+{
+	return this->isOpen() ? this->m_pHeader->wpCount : 0;
+}
+
+
+unsigned int CMappedDatabase::getPoiCount() const
+{
+	return this->isOpen() ? this->m_pHeader->poiCount : 0;
+}
+
+
+/**
+ * Find an element by its name through the name index of the snapshot
+ * param@ std::string_view name		-	name of the element		(IN)
+ * returnvalue@ Row_t				-	row of the element, the element count if the name is unknown
+ */
+CMappedDatabase::Row_t CMappedDatabase::findWaypoint(string_view name) const
+{
+	uint32_t row = CSnapshot::NOT_FOUND;
+
+	if (this->isOpen())
+	{
+		row = CSnapshot::findName(this->m_file.getData(), *this->m_pHeader, CSnapshot::WP_NAMES, CSnapshot::WP_NAME_INDEX, name.data(), name.size());
+	}
+
+	return (row == CSnapshot::NOT_FOUND) ? this->getWaypointCount() : row;
+}
+
+
+CMappedDatabase::Row_t CMappedDatabase::findPoi(string_view name) const
+{
+	uint32_t row = CSnapshot::NOT_FOUND;
+
+	if (this->isOpen())
+	{
+		row = CSnapshot::findName(this->m_file.getData(), *this->m_pHeader, CSnapshot::POI_NAMES, CSnapshot::POI_NAME_INDEX, name.data(), name.size());
+	}
+
+	return (row == CSnapshot::NOT_FOUND) ? this->getPoiCount() : row;
+}
+
+
+/**
+ * Read single values of a Waypoint; the strings point into the mapped file
+ * param@ Row_t row					-	row of a Waypoint	(IN)
+ */
+string_view CMappedDatabase::getWaypointName(Row_t row) const
+{
+	return this->getString(this->m_pWpNames[row]);
+}
+
+
+double CMappedDatabase::getWaypointLatitude(Row_t row) const
+{
+	return this->m_pWpLatitudes[row];
+}
+
+
+double CMappedDatabase::getWaypointLongitude(Row_t row) const
+{
+	return this->m_pWpLongitudes[row];
+}
+
+
+/**
+ * Read single values of a POI; the strings point into the mapped file
+ * param@ Row_t row					-	row of a POI		(IN)
+ */
+string_view CMappedDatabase::getPoiName(Row_t row) const
+{
+	return this->getString(this->m_pPoiNames[row]);
+}
+
+
+string_view CMappedDatabase::getPoiDescription(Row_t row) const
+{
+	return this->getString(this->m_pPoiDescriptions[row]);
+}
+
+
+CPOI::t_poi CMappedDatabase::getPoiType(Row_t row) const
+{
+	return (CPOI::t_poi)min((unsigned int)this->m_pPoiTypes[row], (unsigned int)CPOI::DEFAULT_POI);
+}
+
+
+double CMappedDatabase::getPoiLatitude(Row_t row) const
+{
+	return this->m_pPoiLatitudes[row];
+}
+
+
+double CMappedDatabase::getPoiLongitude(Row_t row) const
+{
+	return this->m_pPoiLongitudes[row];
+}
+
+
+/**
+ * Build the full record of a row. Its strings are added to the string pool straight from the
+ * mapped file; the pool keeps them until the program ends, so the pool grows with every
+ * distinct row read this way. The single values above read the file without the pool.
+ * param@ Row_t row					-	row of the element	(IN)
+ * returnvalue@ CWaypoint / CPOI	-	a copy of the element
+ */
+CWaypoint CMappedDatabase::getWaypoint(Row_t row) const
+{
+	string_view name = this->getWaypointName(row);
+
+	return CWaypoint(CPooledString(name.data(), name.size()), this->getWaypointLatitude(row), this->getWaypointLongitude(row));
+}
+
+
+CPOI CMappedDatabase::getPoi(Row_t row) const
+{
+	string_view name 		= this->getPoiName(row);
+	string_view description = this->getPoiDescription(row);
+
+	return CPOI(this->getPoiType(row), CPooledString(name.data(), name.size()), CPooledString(description.data(), description.size()),
+			this->getPoiLatitude(row), this->getPoiLongitude(row));
+}
+
+
+/**
+ * Get the element closest to the given position
+ * param@ double latitude			-	latitude of the position	(IN)
+ * param@ double longitude			-	longitude of the position	(IN)
+ * returnvalue@ Row_t				-	row of the element, the element count if there is none
+ */
+CMappedDatabase::Row_t CMappedDatabase::getNearestWaypoint(double latitude, double longitude) const
+{
+	Neighbour_Container_t result;
+
+	kNearest(Tree_Container_t(1, this->getWaypointTree()), latitude, longitude, 1, result);
+
+	return result.empty() ? this->getWaypointCount() : result[0].row;
+}
+
+
+CMappedDatabase::Row_t CMappedDatabase::getNearestPoi(double latitude, double longitude) const
+{
+	Neighbour_Container_t result;
+
+	this->getNearestPois(latitude, longitude, 1, result);
+
+	return result.empty() ? this->getPoiCount() : result[0].row;
+}
+
+
+/**
+ * Get the POI of the given type closest to the given position
+ * param@ double latitude			-	latitude of the position	(IN)
+ * param@ double longitude			-	longitude of the position	(IN)
+ * param@ CPOI::t_poi type			-	type of the POI				(IN)
+ * returnvalue@ Row_t				-	row of the POI, getPoiCount() if there is no POI of the type
+ */
+CMappedDatabase::Row_t CMappedDatabase::getNearestPoi(double latitude, double longitude, CPOI::t_poi type) const
+{
+	Neighbour_Container_t result;
+
+	this->getNearestPois(latitude, longitude, 1, type, result);
+
+	return result.empty() ? this->getPoiCount() : result[0].row;
+}
+
+
+/**
+ * Get the k POIs closest to the given position, the closest one first
+ * param@ double latitude				-	latitude of the position	(IN)
+ * param@ double longitude				-	longitude of the position	(IN)
+ * param@ unsigned int k				-	number of POIs				(IN)
+ * param@ Neighbour_Container_t &result	-	rows and distances in KMs	(OUT)
+ * returnvalue@ void
+ */
+void CMappedDatabase::getNearestPois(double latitude, double longitude, unsigned int k, Neighbour_Container_t &result) const
+{
+	Tree_Container_t trees;
+
+	this->getPoiTrees(trees);
+	kNearest(trees, latitude, longitude, k, result);
+}
+
+
+/**
+ * Get the k POIs of the given type closest to the given position, the closest one first
+ * param@ CPOI::t_poi type				-	type of the POIs			(IN)
+ * see getNearestPois above for the other parameters
+ */
+void CMappedDatabase::getNearestPois(double latitude, double longitude, unsigned int k, CPOI::t_poi type, Neighbour_Container_t &result) const
+{
+	kNearest(Tree_Container_t(1, this->getPoiTree(type)), latitude, longitude, k, result);
+}
+
+
+/**
+ * Get all the POIs within the radius around the given position, the closest one first
+ * param@ double latitude				-	latitude of the position	(IN)
+ * param@ double longitude				-	longitude of the position	(IN)
+ * param@ double radius					-	radius in KMs				(IN)
+ * param@ Neighbour_Container_t &result	-	rows and distances in KMs	(OUT)
+ * returnvalue@ void
+ */
+void CMappedDatabase::getPoisWithinRadius(double latitude, double longitude, double radius, Neighbour_Container_t &result) const
+{
+	Tree_Container_t trees;
+
+	this->getPoiTrees(trees);
+	withinRadius(trees, latitude, longitude, radius, result);
+}
+
+
+/**
+ * Get all the POIs of the given type within the radius around the given position
+ * param@ CPOI::t_poi type				-	type of the POIs			(IN)
+ * see getPoisWithinRadius above for the other parameters
+ */
+void CMappedDatabase::getPoisWithinRadius(double latitude, double longitude, double radius, CPOI::t_poi type, Neighbour_Container_t &result) const
+{
+	withinRadius(Tree_Container_t(1, this->getPoiTree(type)), latitude, longitude, radius, result);
+}
+
+
+/**
+ * Get the tree of the Waypoints; an empty tree if no file is open
+ */
+CMappedDatabase::Tree CMappedDatabase::getWaypointTree() const
+{
+	Tree tree = { this->m_pWpTree, this->getWaypointCount(), this->getWaypointCount(), this->m_pWpLatitudes, this->m_pWpLongitudes };
+
+	return tree;
+}
+
+
+/**
+ * Get the tree of the POIs of one type; an empty tree for an unknown type
+ */
+CMappedDatabase::Tree CMappedDatabase::getPoiTree(unsigned int type) const
+{
+	Tree tree = { this->m_pPoiTrees, 0, this->getPoiCount(), this->m_pPoiLatitudes, this->m_pPoiLongitudes };
+
+	if (this->isOpen() && (type < CSnapshot::POI_TREE_COUNT))
+	{
+		tree.pNodes 	= this->m_pPoiTrees + this->m_pPoiTreeBounds[type];
+		tree.size 		= this->m_pPoiTreeBounds[type + 1] - this->m_pPoiTreeBounds[type];
+	}
+
+	return tree;
+}
+
+
+/**
+ * Get the trees of all the POI types
+ */
+void CMappedDatabase::getPoiTrees(Tree_Container_t &trees) const
+{
+	trees.clear();
+
+	for (unsigned int type = 0; type < CSnapshot::POI_TREE_COUNT; ++type)
+	{
+		trees.push_back(this->getPoiTree(type));
+	}
+}
+
+
+/**
+ * Get a string of the heap; an empty string if it is not inside the heap
+ */
+string_view CMappedDatabase::getString(CSnapshot::String const &string) const
+{
+	if ((uint64_t)string.offset + string.length >= this->m_heapSize)
+	{
+		return string_view();
+	}
+
+	return string_view(this->m_pHeap + string.offset, string.length);
+}
+
+
+/**
+ * Get the k closest rows out of several trees, the closest one first
+ */
+void CMappedDatabase::kNearest(Tree_Container_t const &trees, double latitude, double longitude, unsigned int k, Neighbour_Container_t &result)
+{
+	double				query[3];
+	Candidate_Heap_t	heap;
+
+	result.clear();
+
+	if (k == 0)
+	{
+		return;
+	}
+
+	Sphere_t::toUnitVector(latitude, longitude, query);
+
+	for (unsigned int index = 0; index < trees.size(); ++index)
+	{
+		Sphere_t::searchKNearest(trees[index], 0, trees[index].size, query, k, heap);
+	}
+
+	// the heap returns the farthest row first
+	result.resize(heap.size());
+
+	for (unsigned int index = heap.size(); index > 0; --index)
+	{
+		result[index - 1].row		= heap.top().second;
+		result[index - 1].distance	= Sphere_t::chord2ToDistance(heap.top().first);
+		heap.pop();
+	}
+}
+
+
+/**
+ * Get all the rows within the radius out of several trees, the closest one first
+ */
+void CMappedDatabase::withinRadius(Tree_Container_t const &trees, double latitude, double longitude, double radius, Neighbour_Container_t &result)
+{
+	double						query[3];
+	vector<Candidate_t>			found;
+
+	result.clear();
+
+	if (radius < 0)
+	{
+		return;
+	}
+
+	Sphere_t::toUnitVector(latitude, longitude, query);
+
+	for (unsigned int index = 0; index < trees.size(); ++index)
+	{
+		Sphere_t::searchRadius(trees[index], 0, trees[index].size, query, Sphere_t::distanceToChord2(radius), found);
+	}
+
+	sort(found.begin(), found.end(), Sphere_t::CandidateLess());
+
+	result.resize(found.size());
+
+	for (unsigned int index = 0; index < found.size(); ++index)
+	{
+		result[index].row		= found[index].second;
+		result[index].distance	= Sphere_t::chord2ToDistance(found[index].first);
+	}
+}
+
@@ -0,0 +1,376 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMappedDatabase.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CMappedDatabase.
+* 					The class CMappedDatabase answers the look-ups and the
+* 					spatial queries of the Waypoint and POI databases
+* 					directly on a snapshot file (see CSnapshot) which is
+* 					mapped read-only: nothing is copied to the heap.
+* 					Opening only checks the header, whatever the size of
+* 					the databases; the pages are read when a query first
+* 					touches them and are shared through the page cache by
+* 					all the processes which map the same file.
+* 					The elements are addressed by their row, the number
+* 					of the element in the snapshot (the order of the
+* 					names); a CWaypoint or CPOI is only built when the
+* 					full record is asked for.
+*
+****************************************************************************/
+
+#ifndef CMAPPEDDATABASE_H
+#define CMAPPEDDATABASE_H
+
+//System Include Files
+#include <string>
+#include <string_view>
+#include <vector>
+#include <queue>
+#include <stdint.h>
+
+//Own Include Files
+#include "CMappedFile.h"
+#include "CSnapshot.h"
+#include "CSpatialIndex.h"
+
+class CMappedDatabase {
+public:
+
+	typedef unsigned int			Row_t;
+
+	/**
+	 * A query result: the row of the element and its great circle distance in KMs
+	 */
+	struct Neighbour
+	{
+		Row_t		row;
+		double		distance;
+	};
+
+	typedef std::vector<Neighbour>	Neighbour_Container_t;
+
+	/**
+	 * CMappedDatabase constructor: no file is open
+	 */
+	CMappedDatabase();
+
+	/**
+	 * CMappedDatabase destructor: releases the mapping
+	 */
+	~CMappedDatabase();
+
+	/**
+	 * Map a snapshot file; only the header is checked, the content is read by the queries.
+	 * A file opened before is closed.
+	 * param@ std::string const &fileName	-	name of the snapshot file	(IN)
+	 * returnvalue@ bool					-	false if the file can not be mapped or is not a valid snapshot
+	 */
+	bool open(std::string const &fileName);
+
+	/**
+	 * Release the mapping
+	 * returnvalue@ void
+	 */
+	void close();
+
+	/**
+	 * Check if a snapshot is mapped
+	 * returnvalue@ bool
+	 */
+	bool isOpen() const;
+
+	/**
+	 * Check the checksum of the mapped snapshot; the whole file is read
+	 * returnvalue@ bool					-	false if no file is open or the file is damaged
+	 */
+	bool verify() const;
+
+	/**
+	 * Get the number of elements; 0 if no file is open
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getWaypointCount() const;
+	unsigned int getPoiCount() const;
+
+	/**
+	 * Find an element by its name through the name index of the snapshot
+	 * param@ std::string_view name		-	name of the element		(IN)
+	 * returnvalue@ Row_t				-	row of the element, the element count if the name is unknown
+	 */
+	Row_t findWaypoint(std::string_view name) const;
+	Row_t findPoi(std::string_view name) const;
+
+	/**
+	 * Read single values of a Waypoint; the strings point into the mapped file
+	 * param@ Row_t row					-	row of a Waypoint	(IN)
+	 */
+	std::string_view getWaypointName(Row_t row) const;
+	double getWaypointLatitude(Row_t row) const;
+	double getWaypointLongitude(Row_t row) const;
+
+	/**
+	 * Read single values of a POI; the strings point into the mapped file
+	 * param@ Row_t row					-	row of a POI		(IN)
+	 */
+	std::string_view getPoiName(Row_t row) const;
+	std::string_view getPoiDescription(Row_t row) const;
+	CPOI::t_poi getPoiType(Row_t row) const;
+	double getPoiLatitude(Row_t row) const;
+	double getPoiLongitude(Row_t row) const;
+
+	/**
+	 * Build the full record of a row. Its strings are added to the string pool straight from the
+	 * mapped file; the pool keeps them until the program ends, so the pool grows with every
+	 * distinct row read this way. The single values above read the file without the pool.
+	 * param@ Row_t row					-	row of the element	(IN)
+	 * returnvalue@ CWaypoint / CPOI	-	a copy of the element
+	 */
+	CWaypoint getWaypoint(Row_t row) const;
+	CPOI getPoi(Row_t row) const;
+
+	/**
+	 * Get the element closest to the given position
+	 * param@ double latitude			-	latitude of the position	(IN)
+	 * param@ double longitude			-	longitude of the position	(IN)
+	 * returnvalue@ Row_t				-	row of the element, the element count if there is none
+	 */
+	Row_t getNearestWaypoint(double latitude, double longitude) const;
+	Row_t getNearestPoi(double latitude, double longitude) const;
+
+	/**
+	 * Get the POI of the given type closest to the given position
+	 * param@ double latitude			-	latitude of the position	(IN)
+	 * param@ double longitude			-	longitude of the position	(IN)
+	 * param@ CPOI::t_poi type			-	type of the POI				(IN)
+	 * returnvalue@ Row_t				-	row of the POI, getPoiCount() if there is no POI of the type
+	 */
+	Row_t getNearestPoi(double latitude, double longitude, CPOI::t_poi type) const;
+
+	/**
+	 * Get the k POIs closest to the given position, the closest one first
+	 * param@ double latitude				-	latitude of the position	(IN)
+	 * param@ double longitude				-	longitude of the position	(IN)
+	 * param@ unsigned int k				-	number of POIs				(IN)
+	 * param@ Neighbour_Container_t &result	-	rows and distances in KMs	(OUT)
+	 * returnvalue@ void
+	 */
+	void getNearestPois(double latitude, double longitude, unsigned int k, Neighbour_Container_t &result) const;
+
+	/**
+	 * Get the k POIs of the given type closest to the given position, the closest one first
+	 * param@ CPOI::t_poi type				-	type of the POIs			(IN)
+	 * see getNearestPois above for the other parameters
+	 */
+	void getNearestPois(double latitude, double longitude, unsigned int k, CPOI::t_poi type, Neighbour_Container_t &result) const;
+
+	/**
+	 * Get all the POIs within the radius around the given position, the closest one first
+	 * param@ double latitude				-	latitude of the position	(IN)
+	 * param@ double longitude				-	longitude of the position	(IN)
+	 * param@ double radius					-	radius in KMs				(IN)
+	 * param@ Neighbour_Container_t &result	-	rows and distances in KMs	(OUT)
+	 * returnvalue@ void
+	 */
+	void getPoisWithinRadius(double latitude, double longitude, double radius, Neighbour_Container_t &result) const;
+
+	/**
+	 * Get all the POIs of the given type within the radius around the given position
+	 * param@ CPOI::t_poi type				-	type of the POIs			(IN)
+	 * see getPoisWithinRadius above for the other parameters
+	 */
+	void getPoisWithinRadius(double latitude, double longitude, double radius, CPOI::t_poi type, Neighbour_Container_t &result) const;
+
+	/**
+	 * Visit the rows of all the elements inside the latitude / longitude rectangle, with the
+	 * rules of CSpatialIndex::visitRectangle. The visitor is called as visitor(Row_t row).
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ TVisitor &visitor			-	called for every row in the rectangle	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitWaypointsInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const;
+
+	template<class TVisitor>
+	void visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const;
+
+	/**
+	 * Visit the rows of the POIs of the given type inside the latitude / longitude rectangle.
+	 * param@ CPOI::t_poi type			-	type of the POIs	(IN)
+	 * see visitPoisInRectangle above for the other parameters
+	 */
+	template<class TVisitor>
+	void visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, CPOI::t_poi type, TVisitor &visitor) const;
+
+private:
+
+	/**
+	 * The geometry of the spatial index: unit vectors, chord lengths and rectangles
+	 */
+	typedef CSpatialIndex<CWaypoint const>	Sphere_t;
+
+	/**
+	 * A range of nodes which forms one implicit k-d tree, with the positions of its elements.
+	 * It is the accessor of the searches of CSpatialIndex to the nodes; a node with a damaged
+	 * element number is skipped.
+	 */
+	struct Tree
+	{
+		CSnapshot::Node const	*pNodes;
+		unsigned int			size;
+		unsigned int			elementCount;
+		double const			*pLatitudes;
+		double const			*pLongitudes;
+
+		double const* getCoord(unsigned int node) const
+		{
+			return this->pNodes[node].coord;
+		}
+
+		unsigned int getAxis(unsigned int node) const
+		{
+			return this->pNodes[node].axis % 3;
+		}
+
+		bool getElement(unsigned int node, Row_t &row) const
+		{
+			row = this->pNodes[node].element;
+			return (row < this->elementCount);
+		}
+
+		template<class TVisitor>
+		void visitIfInside(unsigned int node, Sphere_t::Rectangle const &rectangle, TVisitor &visitor) const
+		{
+			Row_t row;
+
+			if (this->getElement(node, row) && Sphere_t::isInside(rectangle, this->pLatitudes[row], this->pLongitudes[row]))
+			{
+				visitor(row);
+			}
+		}
+	};
+
+	typedef std::vector<Tree>		Tree_Container_t;
+
+	/**
+	 * A (squared chord, row) pair ordered by the distance only
+	 */
+	typedef std::pair<double, Row_t>				Candidate_t;
+
+	typedef std::priority_queue<Candidate_t, std::vector<Candidate_t>, Sphere_t::CandidateLess>	Candidate_Heap_t;
+
+	CMappedFile							m_file;
+
+	/**
+	 * The header and the sections of the mapped file, 0 if no file is open
+	 */
+	CSnapshot::Header const				*m_pHeader;
+	double const						*m_pWpLatitudes;
+	double const						*m_pWpLongitudes;
+	CSnapshot::String const				*m_pWpNames;
+	double const						*m_pPoiLatitudes;
+	double const						*m_pPoiLongitudes;
+	CSnapshot::String const				*m_pPoiNames;
+	CSnapshot::String const				*m_pPoiDescriptions;
+	uint8_t const						*m_pPoiTypes;
+	char const							*m_pHeap;
+	uint64_t							m_heapSize;
+	CSnapshot::Node const				*m_pWpTree;
+	CSnapshot::Node const				*m_pPoiTrees;
+	uint32_t const						*m_pPoiTreeBounds;
+
+	/**
+	 * Get the tree of the Waypoints, of the POIs of one type or of all the POIs
+	 */
+	Tree getWaypointTree() const;
+	Tree getPoiTree(unsigned int type) const;
+	void getPoiTrees(Tree_Container_t &trees) const;
+
+	/**
+	 * Get a string of the heap; an empty string if it is not inside the heap
+	 */
+	std::string_view getString(CSnapshot::String const &string) const;
+
+	/**
+	 * The searches of CSpatialIndex over the nodes of the mapped trees
+	 */
+	static void kNearest(Tree_Container_t const &trees, double latitude, double longitude, unsigned int k, Neighbour_Container_t &result);
+	static void withinRadius(Tree_Container_t const &trees, double latitude, double longitude, double radius, Neighbour_Container_t &result);
+
+	template<class TVisitor>
+	static void visitRectangle(Tree_Container_t const &trees, double minLatitude, double maxLatitude, double minLongitude, double maxLongitude,
+			TVisitor &visitor);
+
+	/**
+	 * The object owns the mapping, it is not copied
+	 */
+	CMappedDatabase(CMappedDatabase const &origin);
+	CMappedDatabase& operator=(CMappedDatabase const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * Visit the rows of all the elements inside the latitude / longitude rectangle, with the
+ * rules of CSpatialIndex::visitRectangle. The visitor is called as visitor(Row_t row).
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ TVisitor &visitor			-	called for every row in the rectangle	(IN)
+ * returnvalue@ void
+ */
+template<class TVisitor>
+void CMappedDatabase::visitWaypointsInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const
+{
+	visitRectangle(Tree_Container_t(1, this->getWaypointTree()), minLatitude, maxLatitude, minLongitude, maxLongitude, visitor);
+}
+
+
+template<class TVisitor>
+void CMappedDatabase::visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const
+{
+	Tree_Container_t trees;
+
+	this->getPoiTrees(trees);
+	visitRectangle(trees, minLatitude, maxLatitude, minLongitude, maxLongitude, visitor);
+}
+
+
+/**
+ * Visit the rows of the POIs of the given type inside the latitude / longitude rectangle.
+ * param@ CPOI::t_poi type			-	type of the POIs	(IN)
+ * see visitPoisInRectangle above for the other parameters
+ */
+template<class TVisitor>
+void CMappedDatabase::visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, CPOI::t_poi type, TVisitor &visitor) const
+{
+	visitRectangle(Tree_Container_t(1, this->getPoiTree(type)), minLatitude, maxLatitude, minLongitude, maxLongitude, visitor);
+}
+
+
+/**
+ * Visit the rows of the trees inside the rectangle
+ */
+template<class TVisitor>
+void CMappedDatabase::visitRectangle(Tree_Container_t const &trees, double minLatitude, double maxLatitude, double minLongitude, double maxLongitude,
+		TVisitor &visitor)
+{
+	Sphere_t::Rectangle rectangle;
+
+	if (!Sphere_t::makeRectangle(minLatitude, maxLatitude, minLongitude, maxLongitude, rectangle))
+	{
+		return;
+	}
+
+	for (unsigned int index = 0; index < trees.size(); ++index)
+	{
+		Sphere_t::searchRectangle(trees[index], 0, trees[index].size, rectangle, visitor);
+	}
+}
+#endif /* CMAPPEDDATABASE_H */
@@ -0,0 +1,127 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMappedFile.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CMappedFile.
+*
+****************************************************************************/
+
+//System Include Files
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+//Own Include Files
+#include "CMappedFile.h"
+
+//Namespaces
+using namespace std;
+
+//Method Implementations
+/**
+ * CMappedFile constructor: no file is mapped
+ */
+CMappedFile::CMappedFile()
+{
+	this->m_pData 	= 0;
+	this->m_size 	= 0;
+}
+
+
+/**
+ * CMappedFile destructor: releases the mapping
+ */
+CMappedFile::~CMappedFile()
+{
+	this->close();
+}
+
+
+/**
+ * Map a file; a file mapped before is released
+ * param@ std::string const &fileName	-	name of the file	(IN)
+ * param@ t_access access				-	the way the file is read	(IN)
+ * returnvalue@ bool					-	false if the file can not be opened or mapped
+ */
+bool CMappedFile::open(string const &fileName, t_access access)
+{
+	struct stat 	status;
+	int 			descriptor;
+
+	this->close();
+
+	descriptor = ::open(fileName.c_str(), O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		return false;
+	}
+
+	if (fstat(descriptor, &status) < 0)
+	{
+		::close(descriptor);
+		return false;
+	}
+
+	// an empty file can not be mapped, there is nothing to read
+	if (status.st_size > 0)
+	{
+		void *pMapping = mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+		if (pMapping == MAP_FAILED)
+		{
+			::close(descriptor);
+			return false;
+		}
+
+		// no read ahead for a random access: a look-up only faults in the pages it touches
+		madvise(pMapping, status.st_size, (access == SEQUENTIAL) ? MADV_SEQUENTIAL : MADV_RANDOM);
+
+		this->m_pData 	= static_cast<char const *>(pMapping);
+		this->m_size 	= status.st_size;
+	}
+
+	// the mapping remains valid without the descriptor
+	::close(descriptor);
+
+	return true;
+}
+
+
+/**
+ * Release the mapping
+ * returnvalue@ void
+ */
+void CMappedFile::close()
+{
+	if (this->m_pData)
+	{
+		munmap(const_cast<char *>(this->m_pData), this->m_size);
+	}
+
+	this->m_pData 	= 0;
+	this->m_size 	= 0;
+}
+
+
+/**
+ * Get the characters of the file; they are not terminated by '\0'
+ * returnvalue@ char const*			-	first character, 0 for an empty file
+ */
+char const* CMappedFile::getData() const
+{
+	return this->m_pData;
+}
+
+
+/**
+ * Get the number of characters of the file
+ * returnvalue@ size_t
+ */
+size_t CMappedFile::getSize() const
+{
+	return this->m_size;
+}
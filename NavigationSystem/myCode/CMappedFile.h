@@ -0,0 +1,89 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMappedFile.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CMappedFile.
+* 					The class CMappedFile maps a file read-only into the
+* 					memory of the process. The characters are read in
+* 					place, the file is not copied into a buffer; the
+* 					mapping is released with the object.
+* 					A file read once from the start to the end is mapped
+* 					SEQUENTIAL (read ahead, pages dropped behind), a file
+* 					queried in place is mapped RANDOM: only the touched
+* 					pages are read, they stay shared in the page cache.
+*
+****************************************************************************/
+
+#ifndef CMAPPEDFILE_H
+#define CMAPPEDFILE_H
+
+//System Include Files
+#include <string>
+#include <cstddef>
+
+//Own Include Files
+
+class CMappedFile {
+public:
+
+	/**
+	 * The way the characters of the file are read
+	 */
+	enum t_access
+	{
+		SEQUENTIAL,
+		RANDOM
+	};
+
+	/**
+	 * CMappedFile constructor: no file is mapped
+	 */
+	CMappedFile();
+
+	/**
+	 * CMappedFile destructor: releases the mapping
+	 */
+	~CMappedFile();
+
+	/**
+	 * Map a file; a file mapped before is released
+	 * param@ std::string const &fileName	-	name of the file	(IN)
+	 * param@ t_access access				-	the way the file is read	(IN)
+	 * returnvalue@ bool					-	false if the file can not be opened or mapped
+	 */
+	bool open(std::string const &fileName, t_access access = SEQUENTIAL);
+
+	/**
+	 * Release the mapping
+	 * returnvalue@ void
+	 */
+	void close();
+
+	/**
+	 * Get the characters of the file; they are not terminated by '\0'
+	 * returnvalue@ char const*			-	first character, 0 for an empty file
+	 */
+	char const* getData() const;
+
+	/**
+	 * Get the number of characters of the file
+	 * returnvalue@ size_t
+	 */
+	size_t getSize() const;
+
+private:
+
+	char const				*m_pData;
+	size_t					m_size;
+
+	/**
+	 * The object owns the mapping, it is not copied
+	 */
+	CMappedFile(CMappedFile const &origin);
+	CMappedFile& operator=(CMappedFile const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CMAPPEDFILE_H */
@@ -0,0 +1,71 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMortonCode.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CMortonCode.
+* 					The class CMortonCode maps a latitude and a longitude
+* 					to a Z-order (Morton) code.
+*
+****************************************************************************/
+
+//System Include Files
+
+//Own Include Files
+#include "CMortonCode.h"
+#include "CWaypoint.h"
+
+//Method Implementations
+/**
+ * Get the Morton code of a position; the latitude and the longitude are
+ * quantized to 32 bits each and their bits are interleaved.
+ * param@ double latitude		-	latitude in degrees		(IN)
+ * param@ double longitude		-	longitude in degrees	(IN)
+ * returnvalue@ Morton_Code_t	-	Morton code of the position
+ */
+CMortonCode::Morton_Code_t CMortonCode::encode(double latitude, double longitude)
+{
+	Morton_Code_t latBits = spreadBits(quantize(latitude, LATITUDE_MIN, LATITUDE_MAX));
+	Morton_Code_t lonBits = spreadBits(quantize(longitude, LONGITUDE_MIN, LONGITUDE_MAX));
+
+	// the longitude takes the odd bits: it has the wider range
+	return ((lonBits << 1) | latBits);
+}
+
+
+/**
+ * Quantize a value of the range [min, max] to 32 bits
+ */
+uint32_t CMortonCode::quantize(double value, double min, double max)
+{
+	double scaled = (value - min) / (max - min);
+
+	if (!(scaled > 0))
+	{
+		scaled = 0;
+	}
+	else if (scaled > 1)
+	{
+		scaled = 1;
+	}
+
+	return (uint32_t)(scaled * 4294967295.0);
+}
+
+
+/**
+ * Move the 32 bits of the value to the even bit positions
+ */
+CMortonCode::Morton_Code_t CMortonCode::spreadBits(uint32_t value)
+{
+	Morton_Code_t bits = value;
+
+	bits = (bits | (bits << 16)) & 0x0000FFFF0000FFFFULL;
+	bits = (bits | (bits << 8))  & 0x00FF00FF00FF00FFULL;
+	bits = (bits | (bits << 4))  & 0x0F0F0F0F0F0F0F0FULL;
+	bits = (bits | (bits << 2))  & 0x3333333333333333ULL;
+	bits = (bits | (bits << 1))  & 0x5555555555555555ULL;
+
+	return bits;
+}
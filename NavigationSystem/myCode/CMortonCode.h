@@ -0,0 +1,48 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMortonCode.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CMortonCode.
+* 					The class CMortonCode maps a latitude and a longitude
+* 					to a Z-order (Morton) code: positions which are close
+* 					on the map mostly get close codes.
+*
+****************************************************************************/
+
+#ifndef CMORTONCODE_H
+#define CMORTONCODE_H
+
+//System Include Files
+#include <stdint.h>
+
+class CMortonCode {
+public:
+
+	typedef uint64_t			Morton_Code_t;
+
+	/**
+	 * Get the Morton code of a position; the latitude and the longitude are
+	 * quantized to 32 bits each and their bits are interleaved.
+	 * param@ double latitude		-	latitude in degrees		(IN)
+	 * param@ double longitude		-	longitude in degrees	(IN)
+	 * returnvalue@ Morton_Code_t	-	Morton code of the position
+	 */
+	static Morton_Code_t encode(double latitude, double longitude);
+
+private:
+
+	/**
+	 * Quantize a value of the range [min, max] to 32 bits
+	 */
+	static uint32_t quantize(double value, double min, double max);
+
+	/**
+	 * Move the 32 bits of the value to the even bit positions
+	 */
+	static Morton_Code_t spreadBits(uint32_t value);
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CMORTONCODE_H */
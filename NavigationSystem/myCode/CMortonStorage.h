@@ -0,0 +1,574 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CMortonStorage.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a template class CMortonStorage.
+* 					The class CMortonStorage is a storage policy of the
+* 					CDatabase which keeps the elements in one contiguous
+* 					array sorted by the Z-order (Morton) code of their
+* 					position, so elements which are close on the map
+* 					are mostly close in memory. A name to slot index
+* 					keeps the lookups by key working.
+*
+* 					Added elements are appended and merged into the
+* 					sorted array by the next load or non-const access,
+* 					hence the address of an element may change whenever
+* 					an element is added. The const accessors never
+* 					change the storage: they see the appended elements
+* 					through the name index and after the sorted ones.
+* 					T2 needs getLatitude() and getLongitude().
+*
+****************************************************************************/
+
+#ifndef CMORTONSTORAGE_H_
+#define CMORTONSTORAGE_H_
+
+//System Include Files
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <iterator>
+#include <functional>
+#include <new>
+#include <type_traits>
+
+//Own Include Files
+#include "CMortonCode.h"
+#include "CArena.h"
+
+// a template class for the storage ordered by position, the nodes of the name index are taken from a TArena
+template<class T1, class T2, class TArena = CMonotonicArena>
+class CMortonStorage {
+public:
+
+	/**
+	 * A stored element: first is the key, second the element
+	 */
+	struct Entry : public std::pair<T1, T2>
+	{
+		CMortonCode::Morton_Code_t		code;
+
+		Entry(T1 const &key, T2 const &elem) : std::pair<T1, T2>(key, elem)
+		{
+			this->code = CMortonCode::encode(elem.getLatitude(), elem.getLongitude());
+		}
+
+		Entry(std::pair<T1, T2> &&elem) : std::pair<T1, T2>(std::move(elem))
+		{
+			this->code = CMortonCode::encode(this->second.getLatitude(), this->second.getLongitude());
+		}
+	};
+
+	typedef std::vector<Entry>								Storage_Container_t;
+	typedef typename std::vector<Entry>::iterator			Storage_Itr_t;
+	typedef typename std::vector<Entry>::const_iterator		Storage_ConstItr_t;
+	typedef std::map<T1, unsigned int, std::less<T1>, CArenaAllocator<std::pair<const T1, unsigned int>, TArena> >	Slot_Index_t;
+
+	/**
+	 * The elements move when other elements are added
+	 */
+	static const bool		HAS_STABLE_ADDRESSES = false;
+
+	/**
+	 * CMortonStorage constructor
+	 */
+	CMortonStorage();
+
+	/**
+	 * CMortonStorage copy constructor: the copy takes the nodes of its name index from its own arena
+	 * param@ CMortonStorage const &origin	-	storage to be copied	(IN)
+	 */
+	CMortonStorage(CMortonStorage const &origin);
+
+	/**
+	 * CMortonStorage destructor: releases all the nodes at once
+	 */
+	~CMortonStorage();
+
+	/**
+	 * A copy assignment operator: the nodes are taken from the own arena
+	 * param@ CMortonStorage const &rhs		-	storage to be copied	(IN)
+	 * returnvalue@ CMortonStorage&
+	 */
+	CMortonStorage& operator=(CMortonStorage const &rhs);
+
+	/**
+	 * Add an element to the storage
+	 * param@ T1 const &key				-	key of the element			(IN)
+	 * param@ T2 const &elem			-	an element to be added		(IN)
+	 * returnvalue@ bool				-	false if the key already exists
+	 */
+	bool insert(T1 const &key, T2 const &elem);
+
+	/**
+	 * Find an element by its key; the non-const version merges the added elements first
+	 * param@ T1 const &key				-	key of the element			(IN)
+	 * returnvalue@ T2*					-	Pointer to the element, 0 if not found
+	 */
+	T2* find(T1 const &key);
+	T2 const* find(T1 const &key) const;
+
+	/**
+	 * Visit all the elements in the order of their keys without copying them.
+	 * The visitor is called as visitor(T1 const &key, T2 const &elem).
+	 * param@ TVisitor &visitor			-	called for every element	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitInKeyOrder(TVisitor &visitor) const;
+
+	/**
+	 * Iterate the elements in Z-order; itr->first is the key, itr->second the element.
+	 * The const iterators see the elements added since the last merge after the sorted ones.
+	 * returnvalue@ Storage_Itr_t
+	 */
+	Storage_Itr_t begin();
+	Storage_Itr_t end();
+	Storage_ConstItr_t begin() const;
+	Storage_ConstItr_t end() const;
+
+	/**
+	 * Get the number of elements
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int size() const;
+
+	/**
+	 * Get the number of times the elements were moved other than by an insertion: the merge of
+	 * the added elements by a non-const access moves them. The Database adds it to its
+	 * modification counter, so a pointer taken before the merge is known to be stale.
+	 * returnvalue@ unsigned long
+	 */
+	unsigned long getMoveCount() const;
+
+	/**
+	 * Remove all the elements and give back their memory; the nodes of the name index are
+	 * released at once if the arena allows it and the keys own no resources (CArenaTraits)
+	 * returnvalue@ void
+	 */
+	void clear();
+
+	/**
+	 * Replace the content of the storage by the elements of the map
+	 * param@ std::map<T1, T2> const &elements	-	new content	(IN)
+	 * returnvalue@ void
+	 */
+	void assign(std::map<T1, T2> const &elements);
+
+	/**
+	 * Move a batch of elements sorted by key into the storage; the name index is filled
+	 * in linear time, the array is sorted once at the end.
+	 * The elements whose key already exists (or repeats in the batch) are left in the batch.
+	 * param@ std::vector<std::pair<T1, T2> > &batch	-	elements sorted by key, the rejected ones afterwards	(IN/OUT)
+	 * param@ bool isMerge							-	false to replace the content of the storage				(IN)
+	 * returnvalue@ unsigned int					-	number of elements moved into the storage
+	 */
+	unsigned int load(std::vector<std::pair<T1, T2> > &batch, bool isMerge);
+
+	/**
+	 * Copy the content of the storage into a map
+	 * param@ std::map<T1, T2> &elements	-	content of the storage	(OUT)
+	 * returnvalue@ void
+	 */
+	void copyTo(std::map<T1, T2> &elements) const;
+
+private:
+
+	/**
+	 * Elements sorted by Morton code and key, followed by the elements added since the last merge
+	 */
+	Storage_Container_t							m_elements;
+
+	/**
+	 * Source of the nodes of the name index, it has to outlive the index
+	 */
+	TArena										m_arena;
+
+	/**
+	 * Slot of every element in m_elements
+	 */
+	Slot_Index_t								m_slots;
+
+	/**
+	 * Number of elements at the start of m_elements which are sorted
+	 */
+	unsigned int								m_sortedCount;
+
+	/**
+	 * Number of merges of the added elements, it never decreases
+	 */
+	unsigned long								m_moveCount;
+
+	/**
+	 * Order of the elements: by Morton code, the key breaks ties
+	 */
+	static bool isBefore(Entry const &lhs, Entry const &rhs);
+
+	/**
+	 * Merge the added elements into the sorted array and update their slots
+	 */
+	void normalize();
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * CMortonStorage constructor
+ */
+template<class T1, class T2, class TArena>
+CMortonStorage<T1, T2, TArena>::CMortonStorage() : m_slots(std::less<T1>(), typename Slot_Index_t::allocator_type(&m_arena))
+{
+	this->m_sortedCount = 0;
+	this->m_moveCount 	= 0;
+}
+
+
+/**
+ * CMortonStorage copy constructor: the copy takes the nodes of its name index from its own arena
+ * param@ CMortonStorage const &origin	-	storage to be copied	(IN)
+ */
+template<class T1, class T2, class TArena>
+CMortonStorage<T1, T2, TArena>::CMortonStorage(CMortonStorage const &origin) : m_elements(origin.m_elements),
+		m_slots(origin.m_slots.begin(), origin.m_slots.end(), std::less<T1>(), typename Slot_Index_t::allocator_type(&m_arena))
+{
+	this->m_sortedCount = origin.m_sortedCount;
+	this->m_moveCount 	= 0;
+}
+
+
+/**
+ * CMortonStorage destructor: releases all the nodes at once
+ */
+template<class T1, class T2, class TArena>
+CMortonStorage<T1, T2, TArena>::~CMortonStorage()
+{
+	this->clear();
+}
+
+
+/**
+ * A copy assignment operator: the nodes are taken from the own arena
+ * param@ CMortonStorage const &rhs		-	storage to be copied	(IN)
+ * returnvalue@ CMortonStorage&
+ */
+template<class T1, class T2, class TArena>
+CMortonStorage<T1, T2, TArena>& CMortonStorage<T1, T2, TArena>::operator=(CMortonStorage const &rhs)
+{
+	if (this != &rhs)
+	{
+		this->clear();
+		this->m_elements 	= rhs.m_elements;
+		this->m_slots.insert(rhs.m_slots.begin(), rhs.m_slots.end());
+		this->m_sortedCount = rhs.m_sortedCount;
+	}
+
+	return *this;
+}
+
+
+/**
+ * Add an element to the storage
+ * param@ T1 const &key				-	key of the element			(IN)
+ * param@ T2 const &elem			-	an element to be added		(IN)
+ * returnvalue@ bool				-	false if the key already exists
+ */
+template<class T1, class T2, class TArena>
+bool CMortonStorage<T1, T2, TArena>::insert(T1 const &key, T2 const &elem)
+{
+	bool isInserted = this->m_slots.insert(std::pair<T1, unsigned int>(key, this->m_elements.size())).second;
+
+	if (isInserted)
+	{
+		// merged by the next non-const access, several additions are sorted together
+		this->m_elements.push_back(Entry(key, elem));
+	}
+
+	return isInserted;
+}
+
+
+/**
+ * Find an element by its key
+ * param@ T1 const &key				-	key of the element			(IN)
+ * returnvalue@ T2*					-	Pointer to the element, 0 if not found
+ */
+template<class T1, class T2, class TArena>
+T2* CMortonStorage<T1, T2, TArena>::find(T1 const &key)
+{
+	T2 *pT2 = 0;
+
+	this->normalize();
+
+	typename Slot_Index_t::iterator itr = this->m_slots.find(key);
+
+	if (itr != this->m_slots.end())
+	{
+		pT2 = &this->m_elements[itr->second].second;
+	}
+
+	return pT2;
+}
+
+template<class T1, class T2, class TArena>
+T2 const* CMortonStorage<T1, T2, TArena>::find(T1 const &key) const
+{
+	T2 const *pT2 = 0;
+
+	// the slots of the added elements are valid before the merge
+	typename Slot_Index_t::const_iterator itr = this->m_slots.find(key);
+
+	if (itr != this->m_slots.end())
+	{
+		pT2 = &this->m_elements[itr->second].second;
+	}
+
+	return pT2;
+}
+
+
+/**
+ * Visit all the elements in the order of their keys without copying them.
+ * The visitor is called as visitor(T1 const &key, T2 const &elem).
+ * param@ TVisitor &visitor			-	called for every element	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+template<class TVisitor>
+void CMortonStorage<T1, T2, TArena>::visitInKeyOrder(TVisitor &visitor) const
+{
+	// the slot index is ordered by key
+	for (typename Slot_Index_t::const_iterator itr = this->m_slots.begin(); itr != this->m_slots.end(); ++itr)
+	{
+		visitor(itr->first, this->m_elements[itr->second].second);
+	}
+}
+
+
+/**
+ * Iterate the elements in Z-order; itr->first is the key, itr->second the element.
+ * The const iterators see the elements added since the last merge after the sorted ones.
+ * returnvalue@ Storage_Itr_t
+ */
+template<class T1, class T2, class TArena>
+typename CMortonStorage<T1, T2, TArena>::Storage_Itr_t CMortonStorage<T1, T2, TArena>::begin()
+{
+	this->normalize();
+	return this->m_elements.begin();
+}
+
+template<class T1, class T2, class TArena>
+typename CMortonStorage<T1, T2, TArena>::Storage_Itr_t CMortonStorage<T1, T2, TArena>::end()
+{
+	this->normalize();
+	return this->m_elements.end();
+}
+
+template<class T1, class T2, class TArena>
+typename CMortonStorage<T1, T2, TArena>::Storage_ConstItr_t CMortonStorage<T1, T2, TArena>::begin() const
+{
+	return this->m_elements.begin();
+}
+
+template<class T1, class T2, class TArena>
+typename CMortonStorage<T1, T2, TArena>::Storage_ConstItr_t CMortonStorage<T1, T2, TArena>::end() const
+{
+	return this->m_elements.end();
+}
+
+
+/**
+ * Get the number of elements
+ * returnvalue@ unsigned int
+ */
+template<class T1, class T2, class TArena>
+unsigned int CMortonStorage<T1, T2, TArena>::size() const
+{
+	return this->m_elements.size();
+}
+
+
+/**
+ * Get the number of times the elements were moved other than by an insertion: the merges of the added elements
+ * returnvalue@ unsigned long
+ */
+template<class T1, class T2, class TArena>
+unsigned long CMortonStorage<T1, T2, TArena>::getMoveCount() const
+{
+	return this->m_moveCount;
+}
+
+
+/**
+ * Remove all the elements and give back their memory; the nodes of the name index are
+ * released at once if the arena allows it and the keys own no resources (CArenaTraits)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+void CMortonStorage<T1, T2, TArena>::clear()
+{
+	static_assert(std::is_trivially_destructible<typename Slot_Index_t::allocator_type>::value, "an abandoned index must not need its allocator destroyed");
+
+	Storage_Container_t().swap(this->m_elements);
+
+	if (TArena::CAN_RELEASE_ALL && CArenaTraits<T1>::CAN_SKIP_DESTRUCTOR)
+	{
+		// the old index and its nodes are abandoned, their memory goes with the arena. The index is
+		// not destroyed before its memory is reused: its destructor would only destroy the keys,
+		// which opted out of that (CArenaTraits), and give the nodes back to the arena
+		new (&this->m_slots) Slot_Index_t(std::less<T1>(), typename Slot_Index_t::allocator_type(&this->m_arena));
+	}
+	else
+	{
+		this->m_slots.clear();
+	}
+
+	this->m_arena.release();
+	this->m_sortedCount = 0;
+}
+
+
+/**
+ * Replace the content of the storage by the elements of the map
+ * param@ std::map<T1, T2> const &elements	-	new content	(IN)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+void CMortonStorage<T1, T2, TArena>::assign(std::map<T1, T2> const &elements)
+{
+	this->clear();
+	this->m_elements.reserve(elements.size());
+
+	for (typename std::map<T1, T2>::const_iterator itr = elements.begin(); itr != elements.end(); ++itr)
+	{
+		// the keys come in order, the hint makes every insertion O(1)
+		this->m_slots.insert(this->m_slots.end(), std::pair<T1, unsigned int>(itr->first, this->m_elements.size()));
+		this->m_elements.push_back(Entry(itr->first, itr->second));
+	}
+
+	this->normalize();
+}
+
+
+/**
+ * Move a batch of elements sorted by key into the storage; the name index is filled
+ * in linear time, the array is sorted once at the end.
+ * The elements whose key already exists (or repeats in the batch) are left in the batch.
+ * param@ std::vector<std::pair<T1, T2> > &batch	-	elements sorted by key, the rejected ones afterwards	(IN/OUT)
+ * param@ bool isMerge							-	false to replace the content of the storage				(IN)
+ * returnvalue@ unsigned int					-	number of elements moved into the storage
+ */
+template<class T1, class T2, class TArena>
+unsigned int CMortonStorage<T1, T2, TArena>::load(std::vector<std::pair<T1, T2> > &batch, bool isMerge)
+{
+	unsigned int loaded 	= 0;
+	unsigned int rejected 	= 0;
+
+	if (!isMerge)
+	{
+		this->clear();
+	}
+
+	this->m_elements.reserve(this->m_elements.size() + batch.size());
+
+	typename Slot_Index_t::iterator next = this->m_slots.begin();
+
+	for (unsigned int index = 0; index < batch.size(); ++index)
+	{
+		// walk the name index along with the batch, every key is inserted right before its successor
+		while ((next != this->m_slots.end()) && (next->first < batch[index].first))
+		{
+			++next;
+		}
+
+		bool isDuplicate = ((next != this->m_slots.end()) && !(batch[index].first < next->first))
+							|| ((next != this->m_slots.begin()) && !(std::prev(next)->first < batch[index].first));
+
+		if (isDuplicate)
+		{
+			if (rejected != index)
+			{
+				batch[rejected] = std::move(batch[index]);
+			}
+
+			++rejected;
+		}
+		else
+		{
+			this->m_slots.emplace_hint(next, batch[index].first, this->m_elements.size());
+			this->m_elements.push_back(Entry(std::move(batch[index])));
+			++loaded;
+		}
+	}
+
+	batch.resize(rejected);
+
+	// one sort for the whole batch, the const accessors see the elements in Z-order
+	this->normalize();
+
+	return loaded;
+}
+
+
+/**
+ * Copy the content of the storage into a map
+ * param@ std::map<T1, T2> &elements	-	content of the storage	(OUT)
+ * returnvalue@ void
+ */
+template<class T1, class T2, class TArena>
+void CMortonStorage<T1, T2, TArena>::copyTo(std::map<T1, T2> &elements) const
+{
+	elements.clear();
+
+	for (typename Slot_Index_t::const_iterator itr = this->m_slots.begin(); itr != this->m_slots.end(); ++itr)
+	{
+		elements.insert(elements.end(), std::pair<T1, T2>(itr->first, this->m_elements[itr->second].second));
+	}
+}
+
+
+/**
+ * Order of the elements: by Morton code, the key breaks ties
+ */
+template<class T1, class T2, class TArena>
+bool CMortonStorage<T1, T2, TArena>::isBefore(Entry const &lhs, Entry const &rhs)
+{
+	return (lhs.code < rhs.code) || ((lhs.code == rhs.code) && (lhs.first < rhs.first));
+}
+
+
+/**
+ * Merge the added elements into the sorted array and update their slots
+ */
+template<class T1, class T2, class TArena>
+void CMortonStorage<T1, T2, TArena>::normalize()
+{
+	if (this->m_sortedCount == this->m_elements.size())
+	{
+		return;
+	}
+
+	Storage_Itr_t	first		= this->m_elements.begin();
+	Storage_Itr_t	middle		= first + this->m_sortedCount;
+	Storage_Itr_t	last		= this->m_elements.end();
+
+	std::sort(middle, last, isBefore);
+
+	// the elements before the first added one keep their slot
+	unsigned int	firstMoved	= std::upper_bound(first, middle, *middle, isBefore) - first;
+
+	std::inplace_merge(first, middle, last, isBefore);
+
+	for (unsigned int slot = firstMoved; slot < this->m_elements.size(); ++slot)
+	{
+		this->m_slots[this->m_elements[slot].first] = slot;
+	}
+
+	this->m_sortedCount = this->m_elements.size();
+	this->m_moveCount++;
+}
+
+#endif /* CMORTONSTORAGE_H_ */
@@ -12,20 +12,49 @@
 
 //System Include Files
 #include <iostream>
+#include <thread>
 
 //Own Include Files
 #include "CNavigationSystem.h"
 #include "CCSV.h"
 #include "CJsonPersistence.h"
+#include "CSnapshot.h"
+#include "CGPSSource.h"
+#include "CNmeaGPSProvider.h"
+#include "CCsvGPSProvider.h"
+#include "CSyntheticGPSProvider.h"
+#include "CNearestPoiTracker.h"
 
 //Namespaces
 using namespace std;
 
 #define CSV						0
 #define JSON					1
+#define SNAPSHOT				2
 
+// with SNAPSHOT the databases start from the binary snapshot; without a valid
+// snapshot they are read from the JSON file once and the snapshot is written
+#ifndef CONFIG_PERSISTENCE_STORAGE
 //#define CONFIG_PERSISTENCE_STORAGE		CSV
 #define CONFIG_PERSISTENCE_STORAGE		JSON
+//#define CONFIG_PERSISTENCE_STORAGE		SNAPSHOT
+#endif
+
+// input of the current position: the interactive sensor or a trace replayed through a CGPSSource
+#define GPS_SENSOR				0
+#define GPS_NMEA				1
+#define GPS_CSV					2
+#define GPS_SYNTHETIC			3
+
+#ifndef CONFIG_GPS_INPUT
+#define CONFIG_GPS_INPUT				GPS_SENSOR
+//#define CONFIG_GPS_INPUT				GPS_NMEA
+//#define CONFIG_GPS_INPUT				GPS_CSV
+//#define CONFIG_GPS_INPUT				GPS_SYNTHETIC
+#endif
+
+// number of fixes of the synthetic trace, one per second
+#define GPS_SYNTHETIC_FIX_COUNT	3600
 
 
 //Method Implementations
@@ -178,6 +207,71 @@ void CNavigationSystem::printDistanceCurPosNextPoi()
 }
 
 
+/**
+ * Follow the trace of the configured GPS provider and print the closest POI
+ * whenever it changes; the fixes are polled without waiting for the provider
+ * @returnval void
+ */
+void CNavigationSystem::followGPSTrace()
+{
+#if (defined(CONFIG_GPS_INPUT) && (CONFIG_GPS_INPUT == GPS_NMEA))
+
+	CNmeaGPSProvider		provider("GPS.nmea");
+
+#elif (defined(CONFIG_GPS_INPUT) && (CONFIG_GPS_INPUT == GPS_CSV))
+
+	CCsvGPSProvider			provider("GPS.csv");
+
+#else
+
+	// a drive starting at the first waypoint of the route
+	CSyntheticGPSProvider	provider(49.866851, 8.634864, GPS_SYNTHETIC_FIX_COUNT);
+
+#endif
+
+	CGPSSource				source(&provider);
+	CNearestPoiTracker		tracker(&this->m_PoiDatabase);
+	CPOI					*pLastPoi 	= 0;
+	unsigned int			fixCount 	= 0;
+	CGPSFix					fix;
+
+	if (!source.start())
+	{
+		cout << "WARNING: Invalid Sensor data.\n";
+		return;
+	}
+
+	while (!source.isFinished())
+	{
+		if (!source.poll(fix))
+		{
+			// no fix yet: give the time to the provider
+			this_thread::yield();
+			continue;
+		}
+
+		double 	distance 	= 0;
+		CPOI 	*pPoi 		= tracker.update(fix.latitude, fix.longitude, distance);
+
+		fixCount++;
+
+		if (!pPoi)
+		{
+			cout << "WARNING: Can not compute the distance.\n";
+			break;
+		}
+
+		if (pPoi != pLastPoi)
+		{
+			cout << "Time " << fix.time << " s: Distance to next POI = " << distance << " Kms (approx.)\n\n" << *pPoi << endl;
+			pLastPoi = pPoi;
+		}
+	}
+
+	cout << "INFO: " << fixCount << " GPS fixes, " << tracker.getQueryCount() << " queries of the POI Database.\n";
+}
+
+
 /**
  * Creates Waypoint Database and Poi Database
  * @returnval void
@@ -214,6 +308,12 @@ bool CNavigationSystem::writeToFile()
 	jsonFormat.setMediaName("Database.json");
 	ret = jsonFormat.writeData(this->getWpDatabase(), this->getPoiDatabase());
 
+#elif (defined(CONFIG_PERSISTENCE_STORAGE) && (CONFIG_PERSISTENCE_STORAGE == SNAPSHOT))
+
+	CSnapshot			snapshot;
+	snapshot.setMediaName("Database.snapshot");
+	ret = snapshot.writeData(this->getWpDatabase(), this->getPoiDatabase());
+
 #else
 
 #endif
@@ -245,6 +345,24 @@ bool CNavigationSystem::readFromFile()
 	// write the current Databases' contents to files
 	ret = jsonFormat.readData(this->getWpDatabase(), this->getPoiDatabase(), CJsonPersistence::REPLACE);
 
+#elif (defined(CONFIG_PERSISTENCE_STORAGE) && (CONFIG_PERSISTENCE_STORAGE == SNAPSHOT))
+
+	CSnapshot				snapshot;
+	snapshot.setMediaName("Database.snapshot");
+
+	// no parsing: the sections of the file are read in place
+	ret = snapshot.readData(this->getWpDatabase(), this->getPoiDatabase(), CSnapshot::REPLACE);
+
+	if (!ret)
+	{
+		CJsonPersistence	jsonFormat;
+		jsonFormat.setMediaName("Database.json");
+
+		// cold start, the snapshot is written by writeToFile
+		cout << "INFO: Reading the JSON file instead of the snapshot.\n";
+		ret = jsonFormat.readData(this->getWpDatabase(), this->getPoiDatabase(), CJsonPersistence::REPLACE);
+	}
+
 #else
 
 #endif
@@ -289,7 +407,12 @@ void CNavigationSystem::run()
 
 	this->enterRoute();
 	this->printRoute();
+
+#if (defined(CONFIG_GPS_INPUT) && (CONFIG_GPS_INPUT == GPS_SENSOR))
 	this->printDistanceCurPosNextPoi();
+#else
+	this->followGPSTrace();
+#endif
 }
 
 
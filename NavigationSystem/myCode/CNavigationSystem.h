@@ -80,6 +80,13 @@ private:
 	 */
 	void printDistanceCurPosNextPoi();
 
+    /**
+	 * Follow the trace of the configured GPS provider and print the closest POI
+	 * whenever it changes; the fixes are polled without waiting for the provider
+	 * @returnval void
+	 */
+	void followGPSTrace();
+
     /**
 	 * Creates Waypoint Database and Poi Database
 	 * @returnval void
@@ -0,0 +1,185 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CNearestPoiTracker.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CNearestPoiTracker.
+*
+****************************************************************************/
+
+//System Include Files
+#include <limits>
+
+//Own Include Files
+#include "CNearestPoiTracker.h"
+#include "CDistanceKernel.h"
+
+//Namespaces
+using namespace std;
+
+//Macros
+// rounding of the vectorized distance kernel: a candidate must win by this margin
+#define TRACKER_MARGIN_KM			1e-6
+
+//Method Implementations
+const unsigned int CNearestPoiTracker::DEFAULT_CANDIDATES = 16;
+
+
+/**
+ * CNearestPoiTracker constructor
+ * param@ CPoiDatabase *pDatabase		-	the POIs to be tracked		(IN)
+ * param@ unsigned int candidateCount	-	number of candidates (k)	(IN)
+ */
+CNearestPoiTracker::CNearestPoiTracker(CPoiDatabase *pDatabase, unsigned int candidateCount)
+{
+	this->m_pDatabase 		= pDatabase;
+	this->m_candidateCount 	= (candidateCount > 0) ? candidateCount : 1;
+	this->m_updateCount 	= 0;
+	this->m_queryCount 		= 0;
+
+	this->reset();
+}
+
+
+/**
+ * Get the POI closest to the next position of the trace (great circle distance)
+ * param@ double latitude			-	latitude of the position	(IN)
+ * param@ double longitude			-	longitude of the position	(IN)
+ * param@ double &distance			-	distance in KMs				(OUT)
+ * returnvalue@ CPOI*				-	Pointer to a POI in the database, 0 if the database is empty
+ */
+CPOI* CNearestPoiTracker::update(double latitude, double longitude, double &distance)
+{
+	distance = numeric_limits<double>::max();
+
+	if (!this->m_pDatabase)
+	{
+		return 0;
+	}
+
+	this->m_updateCount++;
+
+	if (!this->m_isValid || (this->m_generation != this->m_pDatabase->getGeneration()))
+	{
+		this->queryCandidates(latitude, longitude);
+	}
+
+	if (this->m_candidates.empty())
+	{
+		return 0;
+	}
+
+	double			moved;
+	unsigned int	closest = this->findClosestCandidate(latitude, longitude, distance);
+
+	CDistanceKernel::haversine(latitude, longitude, &this->m_anchorLatitude, &this->m_anchorLongitude, 1, &moved);
+
+	// a POI outside the candidates can be closer: the position left the region of the candidates
+	if (distance + moved + TRACKER_MARGIN_KM > this->m_radius)
+	{
+		this->queryCandidates(latitude, longitude);
+		closest = this->findClosestCandidate(latitude, longitude, distance);
+	}
+
+	return this->m_candidates[closest];
+}
+
+
+/**
+ * Forget the candidates; the next position queries the spatial index
+ * returnvalue@ void
+ */
+void CNearestPoiTracker::reset()
+{
+	this->m_isValid 		= false;
+	this->m_generation 		= 0;
+	this->m_anchorLatitude 	= 0;
+	this->m_anchorLongitude = 0;
+	this->m_radius 			= 0;
+
+	this->m_candidates.clear();
+	this->m_latitudes.clear();
+	this->m_longitudes.clear();
+}
+
+
+/**
+ * Get the number of positions and of queries of the spatial index since the construction
+ * returnvalue@ unsigned int
+ */
+unsigned int CNearestPoiTracker::getUpdateCount() const
+{
+	return this->m_updateCount;
+}
+
+unsigned int CNearestPoiTracker::getQueryCount() const
+{
+	return this->m_queryCount;
+}
+
+
+/**
+ * Take the candidates around the position from the spatial index
+ * param@ double latitude			-	latitude of the position	(IN)
+ * param@ double longitude			-	longitude of the position	(IN)
+ * returnvalue@ void
+ */
+void CNearestPoiTracker::queryCandidates(double latitude, double longitude)
+{
+	CPoiDatabase::Poi_Neighbour_Container_t neighbours;
+
+	this->reset();
+	this->m_queryCount++;
+
+	// one more than the candidates: the distance of the first POI outside bounds the others
+	this->m_pDatabase->getNearestPois(latitude, longitude, this->m_candidateCount + 1, neighbours);
+
+	this->m_generation 		= this->m_pDatabase->getGeneration();
+	this->m_anchorLatitude 	= latitude;
+	this->m_anchorLongitude = longitude;
+	this->m_radius 			= numeric_limits<double>::max();
+	this->m_isValid 		= true;
+
+	for (unsigned int index = 0; (index < neighbours.size()) && neighbours[index].pElement; ++index)
+	{
+		if (index == this->m_candidateCount)
+		{
+			this->m_radius = neighbours[index].distance;
+			break;
+		}
+
+		this->m_candidates.push_back(neighbours[index].pElement);
+		this->m_latitudes.push_back(neighbours[index].pElement->getLatitude());
+		this->m_longitudes.push_back(neighbours[index].pElement->getLongitude());
+	}
+
+	this->m_distances.resize(this->m_candidates.size());
+}
+
+
+/**
+ * Find the closest candidate
+ * param@ double latitude			-	latitude of the position	(IN)
+ * param@ double longitude			-	longitude of the position	(IN)
+ * param@ double &distance			-	distance in KMs				(OUT)
+ * returnvalue@ unsigned int		-	index of the candidate
+ */
+unsigned int CNearestPoiTracker::findClosestCandidate(double latitude, double longitude, double &distance)
+{
+	unsigned int closest = 0;
+
+	CDistanceKernel::haversine(latitude, longitude, this->m_latitudes.data(), this->m_longitudes.data(), this->m_candidates.size(), this->m_distances.data());
+
+	for (unsigned int index = 1; index < this->m_candidates.size(); ++index)
+	{
+		if (this->m_distances[index] < this->m_distances[closest])
+		{
+			closest = index;
+		}
+	}
+
+	distance = this->m_distances[closest];
+
+	return closest;
+}
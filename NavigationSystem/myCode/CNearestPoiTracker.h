@@ -0,0 +1,132 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CNearestPoiTracker.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CNearestPoiTracker.
+* 					The class CNearestPoiTracker follows the nearest POI
+* 					of a CPoiDatabase along a trace of GPS positions.
+* 					A query of the spatial index keeps the k POIs closest
+* 					to the position as candidates. A POI which is not a
+* 					candidate was at least as far as the k-th candidate;
+* 					after a move of m KMs it is still at least that
+* 					distance minus m away. As long as the closest
+* 					candidate is closer than that, it is the nearest POI
+* 					and a position costs k distances; else the index is
+* 					queried again around the new position.
+*
+****************************************************************************/
+
+#ifndef CNEARESTPOITRACKER_H
+#define CNEARESTPOITRACKER_H
+
+//System Include Files
+#include <vector>
+
+//Own Include Files
+#include "CPoiDatabase.h"
+
+class CNearestPoiTracker {
+public:
+
+	/**
+	 * Number of candidates kept by default
+	 */
+	static const unsigned int DEFAULT_CANDIDATES;
+
+	/**
+	 * CNearestPoiTracker constructor
+	 * param@ CPoiDatabase *pDatabase		-	the POIs to be tracked		(IN)
+	 * param@ unsigned int candidateCount	-	number of candidates (k)	(IN)
+	 */
+	CNearestPoiTracker(CPoiDatabase *pDatabase, unsigned int candidateCount = DEFAULT_CANDIDATES);
+
+	/**
+	 * Get the POI closest to the next position of the trace (great circle distance)
+	 * param@ double latitude			-	latitude of the position	(IN)
+	 * param@ double longitude			-	longitude of the position	(IN)
+	 * param@ double &distance			-	distance in KMs				(OUT)
+	 * returnvalue@ CPOI*				-	Pointer to a POI in the database, 0 if the database is empty
+	 */
+	CPOI* update(double latitude, double longitude, double &distance);
+
+	/**
+	 * Forget the candidates; the next position queries the spatial index
+	 * returnvalue@ void
+	 */
+	void reset();
+
+	/**
+	 * Get the number of positions and of queries of the spatial index since the construction
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getUpdateCount() const;
+	unsigned int getQueryCount() const;
+
+private:
+
+	/**
+	 * The tracked POIs
+	 */
+	CPoiDatabase				*m_pDatabase;
+
+	/**
+	 * Number of candidates taken from the spatial index
+	 */
+	unsigned int				m_candidateCount;
+
+	/**
+	 * Database generation of the candidates; a change of the database invalidates them
+	 */
+	unsigned long				m_generation;
+	bool						m_isValid;
+
+	/**
+	 * Position of the last query and the distance from there to the k-th candidate,
+	 * no POI outside the candidates is closer to that position
+	 */
+	double						m_anchorLatitude;
+	double						m_anchorLongitude;
+	double						m_radius;
+
+	/**
+	 * The candidates and their positions as separate arrays for the distance kernel
+	 */
+	std::vector<CPOI *>			m_candidates;
+	std::vector<double>			m_latitudes;
+	std::vector<double>			m_longitudes;
+	std::vector<double>			m_distances;
+
+	/**
+	 * Counters of update() and of the queries of the spatial index
+	 */
+	unsigned int				m_updateCount;
+	unsigned int				m_queryCount;
+
+	/**
+	 * Take the candidates around the position from the spatial index
+	 * param@ double latitude			-	latitude of the position	(IN)
+	 * param@ double longitude			-	longitude of the position	(IN)
+	 * returnvalue@ void
+	 */
+	void queryCandidates(double latitude, double longitude);
+
+	/**
+	 * Find the closest candidate
+	 * param@ double latitude			-	latitude of the position	(IN)
+	 * param@ double longitude			-	longitude of the position	(IN)
+	 * param@ double &distance			-	distance in KMs				(OUT)
+	 * returnvalue@ unsigned int		-	index of the candidate
+	 */
+	unsigned int findClosestCandidate(double latitude, double longitude, double &distance);
+
+	/**
+	 * The tracker refers to one database, it is not copied
+	 */
+	CNearestPoiTracker(CNearestPoiTracker const &origin);
+	CNearestPoiTracker& operator=(CNearestPoiTracker const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CNEARESTPOITRACKER_H */
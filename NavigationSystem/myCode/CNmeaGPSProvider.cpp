@@ -0,0 +1,260 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CNmeaGPSProvider.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CNmeaGPSProvider.
+*
+****************************************************************************/
+
+//System Include Files
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+//Own Include Files
+#include "CNmeaGPSProvider.h"
+#include "CParser.h"
+
+//Namespaces
+using namespace std;
+
+//Macros
+// GGA and RMC have less fields, the others are not looked at
+#define NMEA_MAX_FIELDS				20
+
+//Method Implementations
+/**
+ * CNmeaGPSProvider constructor
+ * @param fileName the NMEA log to be replayed
+ */
+CNmeaGPSProvider::CNmeaGPSProvider(string fileName)
+{
+	this->m_fileName 		= fileName;
+	this->m_lastTime 		= 0;
+	this->m_hasLastTime 	= false;
+	this->m_rejectedCount 	= 0;
+}
+
+
+/**
+ * Open the NMEA log
+ * @return true if the file could be opened
+ */
+bool CNmeaGPSProvider::open()
+{
+	this->m_stream.open(this->m_fileName.c_str(), ifstream::in);
+
+	if (this->m_stream.fail())
+	{
+		cout << "ERROR: The NMEA log \"" << this->m_fileName << "\" can not be opened.\n";
+		return false;
+	}
+
+	this->m_hasLastTime = false;
+
+	return true;
+}
+
+
+/**
+ * Read the position of the next GGA or RMC sentence
+ * @param fix the next position
+ * @return false at the end of the log
+ */
+bool CNmeaGPSProvider::readFix(CGPSFix &fix)
+{
+	while (getline(this->m_stream, this->m_line))
+	{
+		// lines of a log recorded on Windows end with "\r\n"
+		if (!this->m_line.empty() && (this->m_line[this->m_line.size() - 1] == '\r'))
+		{
+			this->m_line.resize(this->m_line.size() - 1);
+		}
+
+		// $ttGGA or $ttRMC, tt is the talker: GP, GN, GL, ...
+		if ((this->m_line.size() < 7) || (this->m_line[0] != '$'))
+		{
+			continue;
+		}
+
+		bool isGga = !this->m_line.compare(3, 3, "GGA");
+		bool isRmc = !this->m_line.compare(3, 3, "RMC");
+
+		if (!isGga && !isRmc)
+		{
+			continue;
+		}
+
+		if (!hasValidChecksum(this->m_line))
+		{
+			this->m_rejectedCount++;
+			continue;
+		}
+
+		// split the fields in place: the commas and the '*' become the ends of the fields
+		char			*pChars 				= &this->m_line[0];
+		char const		*fields[NMEA_MAX_FIELDS];
+		unsigned int	fieldCount 				= 0;
+
+		fields[fieldCount++] = pChars;
+
+		for (char *pChar = pChars; *pChar && (fieldCount < NMEA_MAX_FIELDS); ++pChar)
+		{
+			if ((*pChar == ',') || (*pChar == '*'))
+			{
+				bool isEnd = (*pChar == '*');
+
+				*pChar = '\0';
+
+				if (isEnd)
+				{
+					break;
+				}
+
+				fields[fieldCount++] = pChar + 1;
+			}
+		}
+
+		bool 	isValid;
+		double	time;
+
+		if (isGga)
+		{
+			// time, latitude, N/S, longitude, E/W, quality (0 = no fix)
+			isValid = (fieldCount > 6) && parseTime(fields[1], time)
+					&& parseCoordinate(fields[2], fields[3], fix.latitude)
+					&& parseCoordinate(fields[4], fields[5], fix.longitude)
+					&& (fields[6][0] != '\0') && (fields[6][0] != '0');
+		}
+		else
+		{
+			// time, status (A = valid, V = warning), latitude, N/S, longitude, E/W
+			isValid = (fieldCount > 6) && parseTime(fields[1], time) && (fields[2][0] == 'A')
+					&& parseCoordinate(fields[3], fields[4], fix.latitude)
+					&& parseCoordinate(fields[5], fields[6], fix.longitude);
+		}
+
+		if (!isValid)
+		{
+			this->m_rejectedCount++;
+			continue;
+		}
+
+		// the GGA and the RMC sentence of one epoch carry the same position
+		if (this->m_hasLastTime && (time == this->m_lastTime))
+		{
+			continue;
+		}
+
+		fix.time 				= time;
+		this->m_lastTime 		= time;
+		this->m_hasLastTime 	= true;
+
+		return true;
+	}
+
+	return false;
+}
+
+
+/**
+ * Get the number of GGA / RMC sentences which were rejected (checksum, no fix, bad field)
+ * @return number of sentences
+ */
+unsigned int CNmeaGPSProvider::getRejectedCount() const
+{
+	return this->m_rejectedCount;
+}
+
+
+/**
+ * Check the checksum of a sentence: the XOR of the characters between '$' and '*'
+ * @param sentence a line of the log
+ * @return true if the checksum is present and matches
+ */
+bool CNmeaGPSProvider::hasValidChecksum(string const &sentence)
+{
+	unsigned char 	checksum 	= 0;
+	size_t 			index 		= 1;
+
+	for ( ; (index < sentence.size()) && (sentence[index] != '*'); ++index)
+	{
+		checksum ^= (unsigned char)sentence[index];
+	}
+
+	// no '*' or less than two hex digits behind it
+	if (index + 2 >= sentence.size())
+	{
+		return false;
+	}
+
+	char 	hex[3] 	= { sentence[index + 1], sentence[index + 2], '\0' };
+	char 	*pEnd 	= 0;
+	long 	expected = strtol(hex, &pEnd, 16);
+
+	return (*pEnd == '\0') && (expected == checksum);
+}
+
+
+/**
+ * Convert a field ddmm.mmmm or dddmm.mmmm and its hemisphere to degrees
+ * @param pField the field
+ * @param pHemisphere the field of the hemisphere: N, S, E or W
+ * @param value degrees, negative in the south and the west
+ * @return false if a field is empty or malformed
+ */
+bool CNmeaGPSProvider::parseCoordinate(char const *pField, char const *pHemisphere, double &value)
+{
+	double 	number 	= 0;
+
+	if (!CParser::parseNumber(pField, number) || (number < 0))
+	{
+		return false;
+	}
+
+	double degrees = floor(number / 100);
+
+	value = degrees + (number - degrees * 100) / 60;
+
+	switch (pHemisphere[0])
+	{
+	case 'N':
+	case 'E':
+		return true;
+
+	case 'S':
+	case 'W':
+		value = -value;
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+
+/**
+ * Convert a field hhmmss.ss to seconds since the start of the day
+ * @param pField the field
+ * @param time seconds
+ * @return false if the field is empty or malformed
+ */
+bool CNmeaGPSProvider::parseTime(char const *pField, double &time)
+{
+	double 	number 	= 0;
+
+	if (!CParser::parseNumber(pField, number) || (number < 0))
+	{
+		return false;
+	}
+
+	double hours 	= floor(number / 10000);
+	double minutes 	= floor((number - hours * 10000) / 100);
+
+	time = hours * 3600 + minutes * 60 + (number - hours * 10000 - minutes * 100);
+
+	return true;
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CNmeaGPSProvider.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CNmeaGPSProvider.
+* 					The class CNmeaGPSProvider replays a log of NMEA 0183
+* 					sentences as fast as it is read. The positions are
+* 					taken from the GGA and RMC sentences of any talker
+* 					($GPGGA, $GNRMC, ...) with a valid checksum and a
+* 					valid fix; a second sentence of the same time is
+* 					skipped. The fields are split in place, a sentence
+* 					is not copied.
+*
+****************************************************************************/
+
+#ifndef CNMEAGPSPROVIDER_H
+#define CNMEAGPSPROVIDER_H
+
+//System Include Files
+#include <string>
+#include <fstream>
+
+//Own Include Files
+#include "CGPSProvider.h"
+
+class CNmeaGPSProvider : public CGPSProvider {
+public:
+
+	/**
+	 * CNmeaGPSProvider constructor
+	 * @param fileName the NMEA log to be replayed
+	 */
+	CNmeaGPSProvider(std::string fileName);
+
+	/**
+	 * Open the NMEA log
+	 * @return true if the file could be opened
+	 */
+	bool open();
+
+	/**
+	 * Read the position of the next GGA or RMC sentence
+	 * @param fix the next position
+	 * @return false at the end of the log
+	 */
+	bool readFix(CGPSFix &fix);
+
+	/**
+	 * Get the number of GGA / RMC sentences which were rejected (checksum, no fix, bad field)
+	 * @return number of sentences
+	 */
+	unsigned int getRejectedCount() const;
+
+private:
+
+	std::string					m_fileName;
+	std::ifstream				m_stream;
+
+	/**
+	 * The current sentence; its fields are split in place
+	 */
+	std::string					m_line;
+
+	/**
+	 * Time of the last fix, a second sentence of the same epoch is skipped
+	 */
+	double						m_lastTime;
+	bool						m_hasLastTime;
+
+	unsigned int				m_rejectedCount;
+
+	/**
+	 * Check the checksum of a sentence: the XOR of the characters between '$' and '*'
+	 * @param sentence a line of the log
+	 * @return true if the checksum is present and matches
+	 */
+	static bool hasValidChecksum(std::string const &sentence);
+
+	/**
+	 * Convert a field ddmm.mmmm or dddmm.mmmm and its hemisphere to degrees
+	 * @param pField the field
+	 * @param pHemisphere the field of the hemisphere: N, S, E or W
+	 * @param value degrees, negative in the south and the west
+	 * @return false if a field is empty or malformed
+	 */
+	static bool parseCoordinate(char const *pField, char const *pHemisphere, double &value);
+
+	/**
+	 * Convert a field hhmmss.ss to seconds since the start of the day
+	 * @param pField the field
+	 * @param time seconds
+	 * @return false if the field is empty or malformed
+	 */
+	static bool parseTime(char const *pField, double &time);
+
+	/**
+	 * The provider reads one file, it is not copied
+	 */
+	CNmeaGPSProvider(CNmeaGPSProvider const &origin);
+	CNmeaGPSProvider& operator=(CNmeaGPSProvider const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CNMEAGPSPROVIDER_H */
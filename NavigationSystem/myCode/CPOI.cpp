@@ -42,12 +42,13 @@ static const POITypeName POI_names[CPOI::DEFAULT_POI + 1] =
 /**
  * CPOI constructor:
  * Sets the value of an object when created.
- * param@ t_poi type		-	type of a Point of interest	(IN)
- * param@ string name		-	name of a Waypoint			(IN)
- * param@ double latitude	-	latitude of a Waypoint		(IN)
- * param@ double longitude	-	longitude of a Waypoint		(IN)
+ * param@ t_poi type					-	type of a Point of interest	(IN)
+ * param@ CPooledString name			-	name of a Waypoint			(IN)
+ * param@ CPooledString description	-	description of a POI		(IN)
+ * param@ double latitude				-	latitude of a Waypoint		(IN)
+ * param@ double longitude				-	longitude of a Waypoint		(IN)
  */
-CPOI::CPOI(t_poi type, string name, string description, double latitude, double longitude) : CWaypoint(name, latitude, longitude, CWaypoint::POI)
+CPOI::CPOI(t_poi type, CPooledString name, CPooledString description, double latitude, double longitude) : CWaypoint(name, latitude, longitude, CWaypoint::POI)
 {
 	this->m_type 			= type;
 	this->m_description 	= description;
@@ -73,31 +74,51 @@ CPOI::~CPOI()
  * param@ string&description-	description of a POI			(OUT)
  * returnvalue@ void
 */
-void CPOI::getAllDataByReference(string& name, double& latitude, double& longitude, t_poi &type, string &description)
+void CPOI::getAllDataByReference(string& name, double& latitude, double& longitude, t_poi &type, string &description) const
 {
 	type 		= this->m_type;
-	description = this->m_description;
+	description = this->m_description.str();
 
 	this->CWaypoint::getAllDataByReference(name, latitude, longitude);
 }
 
 
+/**
+ * Gets the description as a string of the pool
+ * returnvalue@ CPooledString const&	-	description of the POI
+ */
+CPooledString const& CPOI::getPooledDescription() const
+{
+	return this->m_description;
+}
+
+
 /**
  * Gets the type name in the string
  * returnvalue@ string 	-	name of the POI type
  */
-string CPOI::getPoiTypeName()
+string CPOI::getPoiTypeName() const
 {
 	return POI_names[this->m_type].poiTypeName;
 }
 
 
+/**
+ * Gets the type of the POI
+ * returnvalue@ CPOI::t_poi 		-	POI type
+ */
+CPOI::t_poi CPOI::getPoiType() const
+{
+	return this->m_type;
+}
+
+
 /**
  * Gets the type
- * param@ const string &poiTypeName	-	POI name (IN)
+ * param@ string_view poiTypeName	-	POI name (IN)
  * returnvalue@ CPOI::t_poi 		-	POI type
  */
-CPOI::t_poi CPOI::getPoiType(const std::string &poiTypeName)
+CPOI::t_poi CPOI::getPoiType(std::string_view poiTypeName)
 {
 	CPOI::t_poi		ret = CPOI::DEFAULT_POI;
 
@@ -14,6 +14,7 @@
 
 //System Include Files
 #include <string>
+#include <string_view>
 
 //Own Include Files
 #include "CWaypoint.h"
@@ -44,12 +45,13 @@ public:
     /**
 	 * CPOI constructor:
 	 * Sets the value of an object when created.
-	 * param@ t_poi type		-	type of a Point of interest	(IN)
-	 * param@ string name		-	name of a Waypoint			(IN)
-	 * param@ double latitude	-	latitude of a Waypoint		(IN)
-	 * param@ double longitude	-	longitude of a Waypoint		(IN)
+	 * param@ t_poi type					-	type of a Point of interest	(IN)
+	 * param@ CPooledString name			-	name of a Waypoint			(IN)
+	 * param@ CPooledString description	-	description of a POI		(IN)
+	 * param@ double latitude				-	latitude of a Waypoint		(IN)
+	 * param@ double longitude				-	longitude of a Waypoint		(IN)
 	 */
-	CPOI(t_poi type = DEFAULT_POI, std::string name = "", std::string description = "", double latitude = 0, double longitude = 0);
+	CPOI(t_poi type = DEFAULT_POI, CPooledString name = CPooledString(), CPooledString description = CPooledString(), double latitude = 0, double longitude = 0);
 
 	/**
 	 * CPOI Destructor:
@@ -57,6 +59,14 @@ public:
 	 */
     ~CPOI();
 
+    /**
+	 * Copy and move: a moved POI hands over its name and description
+	 */
+    CPOI(CPOI const &origin) = default;
+    CPOI(CPOI &&origin) = default;
+    CPOI& operator=(CPOI const &rhs) = default;
+    CPOI& operator=(CPOI &&rhs) = default;
+
     /*
 	 * Return the current point of interest's values
 	 * param@ string& name		-	name of a POI					(OUT)
@@ -66,20 +76,40 @@ public:
 	 * param@ string&description-	description of a POI			(OUT)
 	 * returnvalue@ void
 	 */
-	void getAllDataByReference(std::string& name, double& latitude, double& longitude, t_poi &type, std::string &description);
+	void getAllDataByReference(std::string& name, double& latitude, double& longitude, t_poi &type, std::string &description) const;
+
+	/**
+	 * Gets the description as a string of the pool
+	 * returnvalue@ CPooledString const&	-	description of the POI
+	 */
+	CPooledString const& getPooledDescription() const;
 
 	/**
 	 * Gets the type name in the string
 	 * returnvalue@ string 	-	name of the POI type
 	 */
-	std::string getPoiTypeName();
+	std::string getPoiTypeName() const;
+
+	/**
+	 * Gets the type of the POI
+	 * returnvalue@ CPOI::t_poi 		-	POI type
+	 */
+	CPOI::t_poi getPoiType() const;
 
 	/**
 	 * Gets the type - Global function
-	 * param@ const string &poiTypeName	-	POI name (IN)
+	 * param@ string_view poiTypeName	-	POI name (IN)
 	 * returnvalue@ CPOI::t_poi 		-	POI type
 	 */
-	static CPOI::t_poi getPoiType(const std::string &poiTypeName);
+	static CPOI::t_poi getPoiType(std::string_view poiTypeName);
+
+	/**
+	 * Get the POI of a Waypoint by its type tag instead of a dynamic_cast
+	 * param@ CWaypoint *pWp			-	a Waypoint or a POI, may be null	(IN)
+	 * returnvalue@ CPOI*				-	the POI, null if the object is not a POI
+	 */
+	static CPOI* castFrom(CWaypoint *pWp);
+	static CPOI const* castFrom(CWaypoint const *pWp);
 
 	/**
 	 * Prints the POI values in Degree-Mins-secs format or Decimal format
@@ -104,11 +134,41 @@ private:
 	t_poi 			m_type;
 
 	/**
-	 * A description about the point of interest.
+	 * A description about the point of interest; many POIs share the same one.
 	 */
-	std::string 	m_description;
+	CPooledString 	m_description;
 };
 /********************
 **  CLASS END
 *********************/
+
+/**
+ * The destructor may be skipped when a database releases all its memory at once:
+ * like the Waypoint it is made of, the POI keeps its description in the string pool
+ */
+template<>
+struct CArenaTraits<CPOI>
+{
+	static_assert(CArenaTraits<CWaypoint>::CAN_SKIP_DESTRUCTOR && std::is_trivially_destructible<CPooledString>::value,
+			"the description of a POI must own no memory");
+
+	static const bool	CAN_SKIP_DESTRUCTOR = true;
+};
+
+
+/**
+ * Get the POI of a Waypoint by its type tag instead of a dynamic_cast;
+ * inline, the check is a compare of one member
+ * param@ CWaypoint *pWp			-	a Waypoint or a POI, may be null	(IN)
+ * returnvalue@ CPOI*				-	the POI, null if the object is not a POI
+ */
+inline CPOI* CPOI::castFrom(CWaypoint *pWp)
+{
+	return (pWp && (pWp->getType() == CWaypoint::POI)) ? static_cast<CPOI *>(pWp) : 0;
+}
+
+inline CPOI const* CPOI::castFrom(CWaypoint const *pWp)
+{
+	return (pWp && (pWp->getType() == CWaypoint::POI)) ? static_cast<CPOI const *>(pWp) : 0;
+}
 #endif /* CPOI_H */
@@ -12,9 +12,9 @@
 
 //System Include Files
 #include <iostream>
-#include <fstream>
 #include <string>
-#include <sstream>
+#include <algorithm>
+#include <charconv>
 
 //Own Include Files
 #include "CParser.h"
@@ -45,42 +45,102 @@ CParser::~CParser()
  */
 bool CParser::extractNumberFromString(const std::string &str, double &number)
 {
-	bool 			isNumber = false;
+	return parseNumber(str, number);
+}
+
 
-	if (!str.empty())
+/**
+ * Convert a field to a number independent of the locale: an optional sign, digits with
+ * a '.' as decimal point and an optional exponent; spaces and tabs around it are ignored
+ * @param std::string_view field	-	the field			(IN)
+ * @param double &number			-	Number to return 	(OUT)
+ * @returnval bool					- 	Success - true or Failure - false
+ */
+bool CParser::parseNumber(string_view field, double &number)
+{
+	char const 		*pFirst 	= field.data();
+	char const 		*pLast 		= field.data() + field.size();
+
+	// remove the spaces and tabs around the number (and the '\r' of a Windows line end)
+	while ((pFirst < pLast) && ((*pFirst == ' ') || (*pFirst == '\t')))
 	{
-		unsigned int index = 0;
+		pFirst++;
+	}
 
-		// remove all the leading spaces and tabs
-		while ((str[index] == ' ') || (str[index] == '\t'))
-		{
-			index++;
-		}
+	while ((pFirst < pLast) && ((pLast[-1] == ' ') || (pLast[-1] == '\t') || (pLast[-1] == '\r')))
+	{
+		pLast--;
+	}
 
-		for (unsigned int decPointCount = 0; index < str.length(); ++index)
-		{
-			// check if the string contains only numbers and maybe a .
-			if (!((str[index] >= '0' && str[index] <= '9') || (str[index] == '.' && !decPointCount++)))
-			{
-				isNumber = false;
-				break;
-			}
-			else
-			{
-				isNumber = true;
-			}
-		}
+	char const *pDigits = pFirst;
 
-		if (isNumber)
-		{
-			stringstream	ss(str);
+	// from_chars takes a '-' but no '+'
+	if ((pDigits < pLast) && (*pDigits == '+'))
+	{
+		pFirst = ++pDigits;
+	}
+	else if ((pDigits < pLast) && (*pDigits == '-'))
+	{
+		pDigits++;
+	}
 
-			// extract the number
-			ss >> number;
-		}
+	// a digit or the decimal point must follow the sign: "inf", "nan" are no coordinates
+	if ((pDigits == pLast) || !(((*pDigits >= '0') && (*pDigits <= '9')) || (*pDigits == '.')))
+	{
+		return false;
+	}
+
+	double 				value;
+	from_chars_result 	result = from_chars(pFirst, pLast, value);
+
+	if ((result.ec != errc()) || (result.ptr != pLast))
+	{
+		return false;
 	}
 
-	return isNumber;
+	number = value;
+
+	return true;
+}
+
+
+/**
+ * Split a line into fields at the delimiter which comes first in the list of the delimiters
+ * and exists in the line; the last field takes the rest of the line. Leading spaces and tabs of the fields are removed.
+ * @param std::string_view line			-	Each Line				(IN)
+ * @param std::string_view fields[]		-	the fields, in place	(OUT)
+ * @param unsigned int count			-	number of fields		(IN)
+ * @returnval bool						- 	false if there is no delimiter
+ */
+bool CParser::splitFields(string_view line, string_view fields[], unsigned int count)
+{
+	size_t delimiterIndex = 0;
+
+	// a ',' splits the line even if a ';' comes before it
+	while ((delimiterIndex < delimiters.length()) && (line.find(delimiters[delimiterIndex]) == string_view::npos))
+	{
+		delimiterIndex++;
+	}
+
+	if (delimiterIndex == delimiters.length())
+	{
+		return false;
+	}
+
+	char 	delimiter 	= delimiters[delimiterIndex];
+
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		size_t end = (index + 1 < count) ? line.find(delimiter) : string_view::npos;
+
+		fields[index] = line.substr(0, end);
+		fields[index].remove_prefix(min(fields[index].find_first_not_of(" \t"), fields[index].size()));
+
+		// too few fields: the missing ones are empty
+		line = (end == string_view::npos) ? string_view() : line.substr(end + 1);
+	}
+
+	return true;
 }
 
 
@@ -94,42 +154,12 @@ bool CParser::extractNumberFromString(const std::string &str, double &number)
  */
 bool CParser::parserEachLine(const string &readLine, std::string &name, double &latitude, double &longitude, const unsigned int lineCounter)
 {
-	bool			ret = true;
-
-	// check if the one of the delimiters exists
-	if (readLine.find_first_of(this->delimiters) != string::npos)
-	{
-		stringstream	ss(readLine);
-		string			nameParsed, latitudeParsed, longitudeParsed;
+	string_view		nameParsed;
+	bool			ret = this->parserEachLine(string_view(readLine), nameParsed, latitude, longitude, lineCounter);
 
-		for (unsigned int index = 0; index < this->delimiters.length(); index++)
-		{
-			if (readLine.find_first_of(this->delimiters[index]) != string::npos)
-			{
-				getline(ss, nameParsed, 		this->delimiters[index]);
-				getline(ss, latitudeParsed, 	this->delimiters[index]);
-				getline(ss, longitudeParsed,	'\n');
-
-				// remove leading spaces and tables
-				nameParsed.erase(0, nameParsed.find_first_not_of(' '));
-				nameParsed.erase(0, nameParsed.find_first_not_of('\t'));
-				name = nameParsed;
-				break;
-			}
-		}
-
-		if ((!this->extractNumberFromString(latitudeParsed, latitude)) ||
-			(!this->extractNumberFromString(longitudeParsed, longitude)) ||
-			(nameParsed.empty()))
-		{
-			cout << "ERROR: Invalid or too few fields in line " << lineCounter << ": " << readLine << "\n";
-			ret = false;
-		}
-	}
-	else
+	if (ret)
 	{
-		cout << "ERROR: Could not find the delimiters in line " << lineCounter << ": " << readLine << "\n";
-		ret = false;
+		name.assign(nameParsed);
 	}
 
 	return ret;
@@ -147,55 +177,94 @@ bool CParser::parserEachLine(const string &readLine, std::string &name, double &
  * @returnval bool					- 	Success - true or Failure - false
  */
 bool CParser::parserEachLine(const string &readLine, CPOI::t_poi &type, string &name, std::string &description, double &latitude, double &longitude, const unsigned int lineCounter)
+{
+	string_view		nameParsed, descriptionParsed;
+	bool			ret = this->parserEachLine(string_view(readLine), type, nameParsed, descriptionParsed, latitude, longitude, lineCounter);
+
+	if (ret)
+	{
+		name.assign(nameParsed);
+		description.assign(descriptionParsed);
+	}
+
+	return ret;
+}
+
+
+/**
+ * Parse a line to get waypoint information such as name, latitude and longitude in order;
+ * the name refers to the characters of the line, nothing is copied
+ * @param std::string_view readLine		-	Each Line				(IN)
+ * @param std::string_view &name		-	name of waypoint		(OUT)
+ * @param double &latitude				-	latitude of waypoint	(OUT)
+ * @param double &longitude				-	longitude of waypoint	(OUT)
+ * @param std::ostream &messages		-	stream of the errors	(IN/OUT)
+ * @returnval bool						- 	Success - true or Failure - false
+ */
+bool CParser::parserEachLine(string_view readLine, string_view &name, double &latitude, double &longitude, const unsigned int lineCounter, ostream &messages)
 {
 	bool			ret = true;
+	string_view		fields[3];
 
 	// check if the one of the delimiters exists
-	if (readLine.find_first_of(this->delimiters) != string::npos)
+	if (splitFields(readLine, fields, 3))
 	{
-		stringstream	ss(readLine);
-		string			typeParsed, nameParsed, descriptionParsed, latitudeParsed, longitudeParsed;
+		name = fields[0];
 
-		for (unsigned int index = 0; index < this->delimiters.length(); index++)
+		if ((!parseNumber(fields[1], latitude)) ||
+			(!parseNumber(fields[2], longitude)) ||
+			(name.empty()))
 		{
-			if (readLine.find_first_of(this->delimiters[index]) != string::npos)
-			{
-				getline(ss, typeParsed, 		this->delimiters[index]);
-				getline(ss, nameParsed, 		this->delimiters[index]);
-				getline(ss, descriptionParsed,	this->delimiters[index]);
-				getline(ss, latitudeParsed, 	this->delimiters[index]);
-				getline(ss, longitudeParsed,	'\n');
-
-				// remove leading spaces and tables
-				nameParsed.erase(0, nameParsed.find_first_not_of(' '));
-				nameParsed.erase(0, nameParsed.find_first_not_of('\t'));
-				name 			= nameParsed;
-
-				// remove leading spaces and tables
-				descriptionParsed.erase(0, descriptionParsed.find_first_not_of(' '));
-				descriptionParsed.erase(0, descriptionParsed.find_first_not_of('\t'));
-				description 	= descriptionParsed;
-
-				// remove leading spaces and tables
-				typeParsed.erase(0, typeParsed.find_first_not_of(' '));
-				typeParsed.erase(0, typeParsed.find_first_not_of('\t'));
-				type			= CPOI::getPoiType(typeParsed);
-				break;
-			}
+			messages << "ERROR: Invalid or too few fields in line " << lineCounter << ": " << readLine << "\n";
+			ret = false;
 		}
+	}
+	else
+	{
+		messages << "ERROR: Could not find the delimiters in line " << lineCounter << ": " << readLine << "\n";
+		ret = false;
+	}
+
+	return ret;
+}
+
+
+/**
+ * Parse a line to get POI information such as type, name, description, latitude and longitude in order;
+ * the name and the description refer to the characters of the line, nothing is copied
+ * @param std::string_view readLine		-	Each Line				(IN)
+ * @param t_poi &type					-	type of POI				(OUT)
+ * @param std::string_view &name		-	name of POI				(OUT)
+ * @param std::string_view &description	-	description of POI		(OUT)
+ * @param double &latitude				-	latitude of POI			(OUT)
+ * @param double &longitude				-	longitude of POI		(OUT)
+ * @param std::ostream &messages		-	stream of the errors	(IN/OUT)
+ * @returnval bool						- 	Success - true or Failure - false
+ */
+bool CParser::parserEachLine(string_view readLine, CPOI::t_poi &type, string_view &name, string_view &description, double &latitude, double &longitude, const unsigned int lineCounter, ostream &messages)
+{
+	bool			ret = true;
+	string_view		fields[5];
+
+	// check if the one of the delimiters exists
+	if (splitFields(readLine, fields, 5))
+	{
+		type			= CPOI::getPoiType(fields[0]);
+		name 			= fields[1];
+		description 	= fields[2];
 
-		if ((!this->extractNumberFromString(latitudeParsed, latitude)) ||
-			(!this->extractNumberFromString(longitudeParsed, longitude)) ||
+		if ((!parseNumber(fields[3], latitude)) ||
+			(!parseNumber(fields[4], longitude)) ||
 			(CPOI::DEFAULT_POI == type) ||
-			(nameParsed.empty()))
+			(name.empty()))
 		{
-			cout << "ERROR: Invalid or too few fields in line " << lineCounter << ": " << readLine << "\n";
+			messages << "ERROR: Invalid or too few fields in line " << lineCounter << ": " << readLine << "\n";
 			ret = false;
 		}
 	}
 	else
 	{
-		cout << "ERROR: Could not find the delimiters in line " << lineCounter << ": " << readLine << "\n";
+		messages << "ERROR: Could not find the delimiters in line " << lineCounter << ": " << readLine << "\n";
 		ret = false;
 	}
 
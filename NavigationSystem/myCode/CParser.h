@@ -14,6 +14,8 @@
 
 //System Include Files
 #include <string>
+#include <string_view>
+#include <iostream>
 
 //Own Include Files
 #include "CPOI.h"
@@ -27,6 +29,16 @@ private:
 	 */
 	static const std::string 		delimiters;
 
+	/**
+	 * Split a line into fields at the delimiter which comes first in the list of the delimiters
+	 * and exists in the line; the last field takes the rest of the line. Leading spaces and tabs of the fields are removed.
+	 * @param std::string_view line			-	Each Line				(IN)
+	 * @param std::string_view fields[]		-	the fields, in place	(OUT)
+	 * @param unsigned int count			-	number of fields		(IN)
+	 * @returnval bool						- 	false if there is no delimiter
+	 */
+	static bool splitFields(std::string_view line, std::string_view fields[], unsigned int count);
+
 public:
 	CParser();
 	virtual ~CParser();
@@ -39,6 +51,15 @@ public:
 	 */
 	bool extractNumberFromString(const std::string &str, double &number);
 
+	/**
+	 * Convert a field to a number independent of the locale: an optional sign, digits with
+	 * a '.' as decimal point and an optional exponent; spaces and tabs around it are ignored
+	 * @param std::string_view field	-	the field			(IN)
+	 * @param double &number			-	Number to return 	(OUT)
+	 * @returnval bool					- 	Success - true or Failure - false
+	 */
+	static bool parseNumber(std::string_view field, double &number);
+
 	/**
 	 * Parse a line to get waypoint information such as name, latitude and longitude in order
 	 * @param const string &readLine	-	Each Line				(IN)
@@ -61,6 +82,32 @@ public:
 	 */
 	bool parserEachLine(const std::string &readLine, CPOI::t_poi &type, std::string &name, std::string &description, double &latitude, double &longitude, const unsigned int lineCounter);
 
+	/**
+	 * Parse a line to get waypoint information such as name, latitude and longitude in order;
+	 * the name refers to the characters of the line, nothing is copied
+	 * @param std::string_view readLine		-	Each Line				(IN)
+	 * @param std::string_view &name		-	name of waypoint		(OUT)
+	 * @param double &latitude				-	latitude of waypoint	(OUT)
+	 * @param double &longitude				-	longitude of waypoint	(OUT)
+	 * @param std::ostream &messages		-	stream of the errors	(IN/OUT)
+	 * @returnval bool						- 	Success - true or Failure - false
+	 */
+	bool parserEachLine(std::string_view readLine, std::string_view &name, double &latitude, double &longitude, const unsigned int lineCounter, std::ostream &messages = std::cout);
+
+	/**
+	 * Parse a line to get POI information such as type, name, description, latitude and longitude in order;
+	 * the name and the description refer to the characters of the line, nothing is copied
+	 * @param std::string_view readLine		-	Each Line				(IN)
+	 * @param t_poi &type					-	type of POI				(OUT)
+	 * @param std::string_view &name		-	name of POI				(OUT)
+	 * @param std::string_view &description	-	description of POI		(OUT)
+	 * @param double &latitude				-	latitude of POI			(OUT)
+	 * @param double &longitude				-	longitude of POI		(OUT)
+	 * @param std::ostream &messages		-	stream of the errors	(IN/OUT)
+	 * @returnval bool						- 	Success - true or Failure - false
+	 */
+	bool parserEachLine(std::string_view readLine, CPOI::t_poi &type, std::string_view &name, std::string_view &description, double &latitude, double &longitude, const unsigned int lineCounter, std::ostream &messages = std::cout);
+
 };
 
 #endif /* CPARSER_H_ */
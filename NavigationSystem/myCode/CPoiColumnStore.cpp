@@ -0,0 +1,223 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CPoiColumnStore.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CPoiColumnStore.
+*
+****************************************************************************/
+
+//System Include Files
+#include <limits>
+
+//Own Include Files
+#include "CPoiColumnStore.h"
+#include "CPoiDatabase.h"
+#include "CDistanceKernel.h"
+
+//Namespaces
+using namespace std;
+
+//Macros
+// rows per block of a scan with a type filter: the distances of a block stay in the cache
+#define COLUMN_SCAN_BLOCK			1024
+
+/**
+ * Appends the visited POIs of a database to a column store
+ */
+struct CPoiColumnWriter
+{
+	CPoiColumnStore		*pStore;
+
+	void operator()(POI_Database_key_t const &, CPOI const &poi)
+	{
+		this->pStore->addPoi(poi);
+	}
+};
+
+//Method Implementations
+/**
+ * CPoiColumnStore constructor: an empty store
+ */
+CPoiColumnStore::CPoiColumnStore()
+{
+	// do nothing
+}
+
+
+/**
+ * Replace the content of the store by the POIs of a database, in the order of their names
+ * param@ CPoiDatabase const &database	-	POIs to be copied	(IN)
+ * returnvalue@ void
+ */
+void CPoiColumnStore::assign(CPoiDatabase const &database)
+{
+	CPoiColumnWriter writer = { this };
+
+	this->clear();
+
+	this->m_latitudes.reserve(database.getElementCount());
+	this->m_longitudes.reserve(database.getElementCount());
+	this->m_types.reserve(database.getElementCount());
+	this->m_names.reserve(database.getElementCount());
+	this->m_descriptions.reserve(database.getElementCount());
+
+	database.visitPois(writer);
+}
+
+
+/**
+ * Append a POI as a new row
+ * param@ CPOI const &poi			-	a POI			(IN)
+ * returnvalue@ Row_t				-	row of the POI
+ */
+CPoiColumnStore::Row_t CPoiColumnStore::addPoi(CPOI const &poi)
+{
+	this->m_latitudes.push_back(poi.getLatitude());
+	this->m_longitudes.push_back(poi.getLongitude());
+	this->m_types.push_back((uint8_t)poi.getPoiType());
+	this->m_names.push_back(poi.getPooledName());
+	this->m_descriptions.push_back(poi.getPooledDescription());
+
+	return (Row_t)(this->m_latitudes.size() - 1);
+}
+
+
+/**
+ * Remove all the rows
+ * returnvalue@ void
+ */
+void CPoiColumnStore::clear()
+{
+	this->m_latitudes.clear();
+	this->m_longitudes.clear();
+	this->m_types.clear();
+	this->m_names.clear();
+	this->m_descriptions.clear();
+}
+
+
+/**
+ * Get the number of rows
+ * returnvalue@ unsigned int
+ */
+unsigned int CPoiColumnStore::getCount() const
+{
+	return this->m_latitudes.size();
+}
+
+
+/**
+ * Read single values of a row
+ * param@ Row_t row					-	row of a POI	(IN)
+ */
+double CPoiColumnStore::getLatitude(Row_t row) const
+{
+	return this->m_latitudes[row];
+}
+
+double CPoiColumnStore::getLongitude(Row_t row) const
+{
+	return this->m_longitudes[row];
+}
+
+CPOI::t_poi CPoiColumnStore::getType(Row_t row) const
+{
+	return (CPOI::t_poi)this->m_types[row];
+}
+
+CPooledString const& CPoiColumnStore::getName(Row_t row) const
+{
+	return this->m_names[row];
+}
+
+
+/**
+ * Get the columns of the positions, e.g. for the CDistanceKernel
+ * returnvalue@ double const*		-	getCount() values, in degrees
+ */
+double const* CPoiColumnStore::getLatitudes() const
+{
+	return this->m_latitudes.empty() ? 0 : &this->m_latitudes[0];
+}
+
+double const* CPoiColumnStore::getLongitudes() const
+{
+	return this->m_longitudes.empty() ? 0 : &this->m_longitudes[0];
+}
+
+
+/**
+ * Build the full record of a row
+ * param@ Row_t row					-	row of a POI	(IN)
+ * returnvalue@ CPOI				-	the POI
+ */
+CPOI CPoiColumnStore::getPoi(Row_t row) const
+{
+	// the pooled strings are shared, nothing is copied or looked up
+	return CPOI(this->getType(row), this->m_names[row], this->m_descriptions[row], this->m_latitudes[row], this->m_longitudes[row]);
+}
+
+
+/**
+ * Find the POI closest to the position; only the position columns are read
+ * param@ double latitude			-	latitude of the position	(IN)
+ * param@ double longitude			-	longitude of the position	(IN)
+ * returnvalue@ Row_t				-	row of the POI, getCount() if the store is empty
+ */
+CPoiColumnStore::Row_t CPoiColumnStore::findNearest(double latitude, double longitude) const
+{
+	if (this->m_latitudes.empty())
+	{
+		return 0;
+	}
+
+	return CDistanceKernel::nearest(latitude, longitude, this->getLatitudes(), this->getLongitudes(), this->getCount());
+}
+
+
+/**
+ * Find the POI of the given type closest to the position; only the position and type columns are read
+ * param@ double latitude			-	latitude of the position	(IN)
+ * param@ double longitude			-	longitude of the position	(IN)
+ * param@ CPOI::t_poi type			-	type of the POI				(IN)
+ * returnvalue@ Row_t				-	row of the POI, getCount() if there is no POI of the type
+ */
+CPoiColumnStore::Row_t CPoiColumnStore::findNearest(double latitude, double longitude, CPOI::t_poi type) const
+{
+	Row_t 	nearest 		= this->getCount();
+	double	nearestDistance = numeric_limits<double>::max();
+	double	distances[COLUMN_SCAN_BLOCK];
+
+	for (Row_t begin = 0; begin < this->getCount(); begin += COLUMN_SCAN_BLOCK)
+	{
+		unsigned int count = min((unsigned int)COLUMN_SCAN_BLOCK, this->getCount() - begin);
+
+		// the distances of the whole block are computed at once by the vectorized kernel
+		CDistanceKernel::haversine(latitude, longitude, &this->m_latitudes[begin], &this->m_longitudes[begin], count, distances);
+
+		for (unsigned int index = 0; index < count; ++index)
+		{
+			if ((this->m_types[begin + index] == type) && (distances[index] < nearestDistance))
+			{
+				nearestDistance = distances[index];
+				nearest 		= begin + index;
+			}
+		}
+	}
+
+	return nearest;
+}
+
+
+/**
+ * Get the memory of the columns; the strings are kept by the string pool
+ * returnvalue@ size_t				-	bytes
+ */
+size_t CPoiColumnStore::getMemoryUsage() const
+{
+	return this->m_latitudes.capacity() * sizeof(double) + this->m_longitudes.capacity() * sizeof(double)
+			+ this->m_types.capacity() * sizeof(uint8_t)
+			+ this->m_names.capacity() * sizeof(CPooledString) + this->m_descriptions.capacity() * sizeof(CPooledString);
+}
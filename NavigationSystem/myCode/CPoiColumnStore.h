@@ -0,0 +1,229 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CPoiColumnStore.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CPoiColumnStore.
+* 					The class CPoiColumnStore keeps a copy of the POIs
+* 					of a CPoiDatabase column by column (structure of
+* 					arrays): latitudes, longitudes, types (one byte)
+* 					and the numbers of the names and descriptions in the
+* 					string pool. A scan reads only the columns it needs,
+* 					e.g. 17 bytes per POI for a search by position and
+* 					type instead of the whole CPOI. The CPOI of a row is
+* 					only built when the full record is asked for.
+*
+****************************************************************************/
+
+#ifndef CPOICOLUMNSTORE_H
+#define CPOICOLUMNSTORE_H
+
+//System Include Files
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+//Own Include Files
+#include "CPOI.h"
+#include "CStringPool.h"
+#include "CSpatialIndex.h"
+
+class CPoiDatabase;
+
+class CPoiColumnStore {
+public:
+
+	typedef unsigned int			Row_t;
+
+	/**
+	 * CPoiColumnStore constructor: an empty store
+	 */
+	CPoiColumnStore();
+
+	/**
+	 * Replace the content of the store by the POIs of a database, in the order of their names
+	 * param@ CPoiDatabase const &database	-	POIs to be copied	(IN)
+	 * returnvalue@ void
+	 */
+	void assign(CPoiDatabase const &database);
+
+	/**
+	 * Append a POI as a new row
+	 * param@ CPOI const &poi			-	a POI			(IN)
+	 * returnvalue@ Row_t				-	row of the POI
+	 */
+	Row_t addPoi(CPOI const &poi);
+
+	/**
+	 * Remove all the rows
+	 * returnvalue@ void
+	 */
+	void clear();
+
+	/**
+	 * Get the number of rows
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getCount() const;
+
+	/**
+	 * Read single values of a row
+	 * param@ Row_t row					-	row of a POI	(IN)
+	 */
+	double getLatitude(Row_t row) const;
+	double getLongitude(Row_t row) const;
+	CPOI::t_poi getType(Row_t row) const;
+	CPooledString const& getName(Row_t row) const;
+
+	/**
+	 * Get the columns of the positions, e.g. for the CDistanceKernel
+	 * returnvalue@ double const*		-	getCount() values, in degrees
+	 */
+	double const* getLatitudes() const;
+	double const* getLongitudes() const;
+
+	/**
+	 * Build the full record of a row
+	 * param@ Row_t row					-	row of a POI	(IN)
+	 * returnvalue@ CPOI				-	the POI
+	 */
+	CPOI getPoi(Row_t row) const;
+
+	/**
+	 * Find the POI closest to the position; only the position columns are read
+	 * param@ double latitude			-	latitude of the position	(IN)
+	 * param@ double longitude			-	longitude of the position	(IN)
+	 * returnvalue@ Row_t				-	row of the POI, getCount() if the store is empty
+	 */
+	Row_t findNearest(double latitude, double longitude) const;
+
+	/**
+	 * Find the POI of the given type closest to the position; only the position and type columns are read
+	 * param@ double latitude			-	latitude of the position	(IN)
+	 * param@ double longitude			-	longitude of the position	(IN)
+	 * param@ CPOI::t_poi type			-	type of the POI				(IN)
+	 * returnvalue@ Row_t				-	row of the POI, getCount() if there is no POI of the type
+	 */
+	Row_t findNearest(double latitude, double longitude, CPOI::t_poi type) const;
+
+	/**
+	 * Visit the rows of all the POIs inside the latitude / longitude rectangle, in the order of the rows.
+	 * A rectangle with minLongitude > maxLongitude crosses the date line; a POI on a pole is inside
+	 * for every longitude, as in the rectangle queries of CSpatialIndex.
+	 * The visitor is called as visitor(Row_t row).
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ TVisitor &visitor			-	called for every row in the rectangle	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const;
+
+	/**
+	 * Visit the rows of the POIs of the given type inside the latitude / longitude rectangle.
+	 * param@ CPOI::t_poi type			-	type of the POIs	(IN)
+	 * see visitRectangle above for the other parameters
+	 */
+	template<class TVisitor>
+	void visitRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, CPOI::t_poi type, TVisitor &visitor) const;
+
+	/**
+	 * Get the memory of the columns; the strings are kept by the string pool
+	 * returnvalue@ size_t				-	bytes
+	 */
+	size_t getMemoryUsage() const;
+
+private:
+
+	/**
+	 * The columns, one value per row
+	 */
+	std::vector<double>					m_latitudes;
+	std::vector<double>					m_longitudes;
+	std::vector<uint8_t>				m_types;
+	std::vector<CPooledString>			m_names;
+	std::vector<CPooledString>			m_descriptions;
+
+	/**
+	 * The rectangle of the spatial index, with its date line and pole rules
+	 */
+	typedef CSpatialIndex<CPOI>::Rectangle	Rectangle_t;
+
+	/**
+	 * Check if a row is inside the rectangle
+	 */
+	bool isInRectangle(Row_t row, Rectangle_t const &rectangle) const;
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * Check if a row is inside the rectangle; inline, it is called for every row of a scan
+ */
+inline bool CPoiColumnStore::isInRectangle(Row_t row, Rectangle_t const &rectangle) const
+{
+	return CSpatialIndex<CPOI>::isInside(rectangle, this->m_latitudes[row], this->m_longitudes[row]);
+}
+
+
+/**
+ * Visit the rows of all the POIs inside the latitude / longitude rectangle, in the order of the rows.
+ * A rectangle with minLongitude > maxLongitude crosses the date line; a POI on a pole is inside
+ * for every longitude, as in the rectangle queries of CSpatialIndex.
+ * The visitor is called as visitor(Row_t row).
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ TVisitor &visitor			-	called for every row in the rectangle	(IN)
+ * returnvalue@ void
+ */
+template<class TVisitor>
+void CPoiColumnStore::visitRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const
+{
+	Rectangle_t	rectangle;
+
+	if (!CSpatialIndex<CPOI>::makeRectangle(minLatitude, maxLatitude, minLongitude, maxLongitude, rectangle))
+	{
+		return;
+	}
+
+	for (Row_t row = 0; row < this->m_latitudes.size(); ++row)
+	{
+		if (this->isInRectangle(row, rectangle))
+		{
+			visitor(row);
+		}
+	}
+}
+
+
+/**
+ * Visit the rows of the POIs of the given type inside the latitude / longitude rectangle.
+ * param@ CPOI::t_poi type			-	type of the POIs	(IN)
+ * see visitRectangle above for the other parameters
+ */
+template<class TVisitor>
+void CPoiColumnStore::visitRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, CPOI::t_poi type, TVisitor &visitor) const
+{
+	Rectangle_t	rectangle;
+
+	if (!CSpatialIndex<CPOI>::makeRectangle(minLatitude, maxLatitude, minLongitude, maxLongitude, rectangle))
+	{
+		return;
+	}
+
+	for (Row_t row = 0; row < this->m_types.size(); ++row)
+	{
+		// the type column is checked first, the positions of the other types are not read
+		if ((this->m_types[row] == type) && this->isInRectangle(row, rectangle))
+		{
+			visitor(row);
+		}
+	}
+}
+#endif /* CPOICOLUMNSTORE_H */
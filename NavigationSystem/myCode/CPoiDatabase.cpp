@@ -12,20 +12,63 @@
 
 //System Include Files
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <thread>
 
 //Own Include Files
 #include "CPoiDatabase.h"
+#include "CMortonCode.h"
 
 //Namespaces
 using namespace std;
 
+//Macros
+#define BATCH_MIN_QUERIES_PER_THREAD		256
+
+//typedefs
+typedef pair<CMortonCode::Morton_Code_t, unsigned int>		Batch_Order_t;
+
+/**
+ * Answer the queries [begin, end) of the Z-ordered batch
+ */
+static void queryBatch(CPoiDatabase::Poi_Index_Container_t const *pIndexes, CWaypoint const positions[], vector<Batch_Order_t> const *pOrder,
+						unsigned int begin, unsigned int end, unsigned int k, CSpatialIndex<CPOI>::Neighbour *pResults)
+{
+	CPoiDatabase::Poi_Neighbour_Container_t 	neighbours;
+
+	for (unsigned int index = begin; index < end; ++index)
+	{
+		unsigned int query = (*pOrder)[index].second;
+
+		CSpatialIndex<CPOI>::kNearest(*pIndexes, positions[query].getLatitude(), positions[query].getLongitude(), k, neighbours);
+
+		for (unsigned int rank = 0; rank < neighbours.size(); ++rank)
+		{
+			pResults[query * k + rank] = neighbours[rank];
+		}
+	}
+}
+
 //Method Implementations
 /**
  * CPoiDatabase constructor
  */
 CPoiDatabase::CPoiDatabase()
 {
-	// do nothing
+	this->initAllIndexes();
+	this->m_indexGeneration = this->getGeneration();
+}
+
+/**
+ * CPoiDatabase copy constructor: the spatial indexes are rebuilt over the copied POIs
+ * param@ CPoiDatabase const &origin	-	database to be copied	(IN)
+ */
+CPoiDatabase::CPoiDatabase(CPoiDatabase const &origin) : CDatabase<POI_Database_key_t, CPOI, Poi_Storage_t>(origin)
+{
+	// the indexes of the origin point to the POIs of the origin
+	this->initAllIndexes();
+	this->rebuildSpatialIndex();
 }
 
 /**
@@ -37,6 +80,23 @@ CPoiDatabase::~CPoiDatabase()
 }
 
 
+/**
+ * A copy assignment operator: the spatial indexes are rebuilt over the copied POIs
+ * param@ CPoiDatabase const &rhs		-	database to be copied	(IN)
+ * returnvalue@ CPoiDatabase&
+ */
+CPoiDatabase& CPoiDatabase::operator=(CPoiDatabase const &rhs)
+{
+	if (this != &rhs)
+	{
+		this->CDatabase<POI_Database_key_t, CPOI, Poi_Storage_t>::operator=(rhs);
+		this->rebuildSpatialIndex();
+	}
+
+	return *this;
+}
+
+
 /*
  * Add a Point of interest to the database
  * param@ POI_Database_key_t &name	- 	unique name for the poi		(IN)
@@ -45,23 +105,60 @@ CPoiDatabase::~CPoiDatabase()
  */
 void CPoiDatabase::addPoi(POI_Database_key_t const &key, CPOI const &poi)
 {
-	this->addElement(key, poi);
+	// the other elements must stay where the index saw them
+	bool isIndexInSync = (this->m_indexGeneration == this->getGeneration()) && this->hasStableAddresses();
+
+	if (this->addElement(key, poi) && isIndexInSync)
+	{
+		// keep the index up to date instead of rebuilding it on the next query
+		CPOI *pPoi = this->getPointerToElement(key);
+
+		this->m_spatialIndex[pPoi->getPoiType()].insert(pPoi);
+		this->m_indexGeneration = this->getGeneration();
+	}
 }
 
 
 /**
- * Get pointer to a POI from the Database which matches the name
- * param@ string key		-	name of a POI					(IN)
- * returnvalue@ CPOI*		-	Pointer to a POI in the database
+ * Get pointer to a POI from the Database which matches the name;
+ * the name is not added to the string pool
+ * param@ string_view name	-	name of a POI					(IN)
+ * returnvalue@ CPOI*		-	Pointer to a POI in the database, 0 if not found
  */
-CPOI* CPoiDatabase::getPointerToPoi(Database_Container_key_t key)
+CPOI* CPoiDatabase::getPointerToPoi(string_view name)
 {
+	POI_Database_key_t key;
+
+	// a name which is not in the pool is not the name of any POI
+	if (!POI_Database_key_t::find(name, key))
+	{
+		return 0;
+	}
+
 	return (this->getPointerToElement(key));
 }
 
 
 /**
- * Get POIs from the Database
+ * Get read only access to a POI from the Database which matches the name
+ * param@ std::string_view name			-	name of a POI					(IN)
+ * returnvalue@ CPOI const*				-	Pointer to a POI in the database, 0 if not found
+ */
+CPOI const* CPoiDatabase::getPointerToPoi(string_view name) const
+{
+	POI_Database_key_t key;
+
+	if (!POI_Database_key_t::find(name, key))
+	{
+		return 0;
+	}
+
+	return (this->getPointerToElement(key));
+}
+
+
+/**
+ * Get a copy of the POIs from the Database; visitPois reads them without a copy
  * returnvalue@ Poi_Map_t			-	POIs in the Database	(OUT)
  */
 const CPoiDatabase::Poi_Map_t CPoiDatabase::getPoisFromDatabase() const
@@ -88,3 +185,310 @@ void CPoiDatabase::print()
 {
 	this->CDatabase::print();
 }
+
+
+/**
+ * Get the POI closest to the given position
+ * param@ double latitude		-	latitude of the position	(IN)
+ * param@ double longitude		-	longitude of the position	(IN)
+ * returnvalue@ CPOI*			-	Pointer to a POI in the database, 0 if the database is empty or the position is invalid
+ */
+CPOI* CPoiDatabase::getNearestPoi(double latitude, double longitude)
+{
+	CPOI						*pPoi = 0;
+	Poi_Neighbour_Container_t	result;
+
+	this->getNearestPois(latitude, longitude, 1, result);
+
+	if (!result.empty())
+	{
+		pPoi = result[0].pElement;
+	}
+
+	return pPoi;
+}
+
+
+/**
+ * Get the POI of the given type closest to the given position
+ * param@ double latitude		-	latitude of the position	(IN)
+ * param@ double longitude		-	longitude of the position	(IN)
+ * param@ CPOI::t_poi type		-	type of the POI				(IN)
+ * returnvalue@ CPOI*			-	Pointer to a POI in the database, 0 if there is no POI of the type or the position is invalid
+ */
+CPOI* CPoiDatabase::getNearestPoi(double latitude, double longitude, CPOI::t_poi type)
+{
+	if (!CWaypoint::isValidPosition(latitude, longitude))
+	{
+		return 0;
+	}
+
+	this->syncSpatialIndex();
+
+	return (this->m_spatialIndex[type].nearest(latitude, longitude));
+}
+
+
+/**
+ * Get the POI closest to the given position under the given distance model.
+ * The spatial index prefilters on the sphere; for VINCENTY the POIs which can still be
+ * closer on the ellipsoid are re-ranked, the other models measure the nearest POI of the sphere.
+ * param@ double latitude							-	latitude of the position	(IN)
+ * param@ double longitude							-	longitude of the position	(IN)
+ * param@ CWaypoint::t_distance_model model		-	distance model				(IN)
+ * param@ double &distance							-	distance in KMs				(OUT)
+ * returnvalue@ CPOI*								-	Pointer to a POI in the database, 0 if the database is empty or the position is invalid
+ */
+CPOI* CPoiDatabase::getNearestPoi(double latitude, double longitude, CWaypoint::t_distance_model model, double &distance)
+{
+	// the name of the position is added to the string pool once
+	static const CPooledString 	positionName("Position");
+
+	CPOI		*pNearest = this->getNearestPoi(latitude, longitude);
+
+	if (pNearest)
+	{
+		// the distance models are methods of the Waypoint
+		CWaypoint	position(positionName, latitude, longitude);
+
+		distance = position.calculateDistance(*pNearest, model);
+
+		if (model == CWaypoint::VINCENTY)
+		{
+			Poi_Neighbour_Container_t	candidates;
+
+			// no POI further away on the sphere can be closer on the ellipsoid
+			double radius = position.calculateDistance(*pNearest) * ELLIPSOID_RATIO_MAX / ELLIPSOID_RATIO_MIN;
+
+			this->getPoisWithinRadius(latitude, longitude, radius, candidates);
+
+			for (unsigned int i = 0; i < candidates.size(); i++)
+			{
+				double candidateDistance = position.calculateDistance(*candidates[i].pElement, model);
+
+				if (candidateDistance < distance)
+				{
+					distance = candidateDistance;
+					pNearest = candidates[i].pElement;
+				}
+			}
+		}
+	}
+
+	return pNearest;
+}
+
+
+/**
+ * Get the k POIs closest to the given position, the closest one first; none for an invalid position
+ * param@ double latitude						-	latitude of the position	(IN)
+ * param@ double longitude						-	longitude of the position	(IN)
+ * param@ unsigned int k						-	number of POIs				(IN)
+ * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+ * returnvalue@ void
+ */
+void CPoiDatabase::getNearestPois(double latitude, double longitude, unsigned int k, Poi_Neighbour_Container_t &result)
+{
+	if (!CWaypoint::isValidPosition(latitude, longitude))
+	{
+		result.clear();
+		return;
+	}
+
+	this->syncSpatialIndex();
+	CSpatialIndex<CPOI>::kNearest(this->m_allIndexes, latitude, longitude, k, result);
+}
+
+
+/**
+ * Get the k POIs of the given type closest to the given position, the closest one first; none for an invalid position
+ * param@ double latitude						-	latitude of the position	(IN)
+ * param@ double longitude						-	longitude of the position	(IN)
+ * param@ unsigned int k						-	number of POIs				(IN)
+ * param@ CPOI::t_poi type						-	type of the POIs			(IN)
+ * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+ * returnvalue@ void
+ */
+void CPoiDatabase::getNearestPois(double latitude, double longitude, unsigned int k, CPOI::t_poi type, Poi_Neighbour_Container_t &result)
+{
+	if (!CWaypoint::isValidPosition(latitude, longitude))
+	{
+		result.clear();
+		return;
+	}
+
+	this->syncSpatialIndex();
+	this->m_spatialIndex[type].kNearest(latitude, longitude, k, result);
+}
+
+
+/**
+ * Get the k POIs closest to each of the given positions.
+ * The positions are processed in Z-order for cache locality and split across the cores.
+ * The result of position i is stored at [i * k, i * k + k), the closest POI first;
+ * missing POIs (database smaller than k) have a null pointer.
+ * param@ CWaypoint const positions[]			-	query positions				(IN)
+ * param@ unsigned int count					-	number of positions			(IN)
+ * param@ unsigned int k						-	number of POIs per position	(IN)
+ * param@ Poi_Neighbour_Container_t &results	-	POIs and distances in KMs	(OUT)
+ * param@ unsigned int threads					-	number of threads, 0 for all the cores	(IN)
+ * returnvalue@ void
+ */
+void CPoiDatabase::getNearestPois(CWaypoint const positions[], unsigned int count, unsigned int k, Poi_Neighbour_Container_t &results, unsigned int threads)
+{
+	CSpatialIndex<CPOI>::Neighbour	missing = { 0, numeric_limits<double>::max() };
+
+	results.assign(count * k, missing);
+
+	if ((count == 0) || (k == 0))
+	{
+		return;
+	}
+
+	// the index must be complete before the worker threads share it
+	this->syncSpatialIndex();
+
+	// neighbouring queries walk the same tree nodes
+	vector<Batch_Order_t>	order(count);
+
+	for (unsigned int index = 0; index < count; ++index)
+	{
+		order[index] = Batch_Order_t(CMortonCode::encode(positions[index].getLatitude(), positions[index].getLongitude()), index);
+	}
+
+	sort(order.begin(), order.end());
+
+	if (threads == 0)
+	{
+		threads = thread::hardware_concurrency();
+	}
+
+	threads = max(1u, min(threads, (count + BATCH_MIN_QUERIES_PER_THREAD - 1) / BATCH_MIN_QUERIES_PER_THREAD));
+
+	vector<thread>	workers;
+	unsigned int	chunk = (count + threads - 1) / threads;
+
+	for (unsigned int begin = chunk; begin < count; begin += chunk)
+	{
+		workers.push_back(thread(queryBatch, &this->m_allIndexes, positions, &order, begin, min(begin + chunk, count), k, &results[0]));
+	}
+
+	// the first chunk is handled by the calling thread
+	queryBatch(&this->m_allIndexes, positions, &order, 0, min(chunk, count), k, &results[0]);
+
+	for (unsigned int index = 0; index < workers.size(); ++index)
+	{
+		workers[index].join();
+	}
+}
+
+
+/**
+ * Get all the POIs within the radius around the given position, the closest one first
+ * param@ double latitude						-	latitude of the position	(IN)
+ * param@ double longitude						-	longitude of the position	(IN)
+ * param@ double radius							-	radius in KMs				(IN)
+ * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+ * returnvalue@ void
+ */
+void CPoiDatabase::getPoisWithinRadius(double latitude, double longitude, double radius, Poi_Neighbour_Container_t &result)
+{
+	this->syncSpatialIndex();
+	CSpatialIndex<CPOI>::withinRadius(this->m_allIndexes, latitude, longitude, radius, result);
+}
+
+
+/**
+ * Get all the POIs of the given type within the radius around the given position, the closest one first
+ * param@ double latitude						-	latitude of the position	(IN)
+ * param@ double longitude						-	longitude of the position	(IN)
+ * param@ double radius							-	radius in KMs				(IN)
+ * param@ CPOI::t_poi type						-	type of the POIs			(IN)
+ * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+ * returnvalue@ void
+ */
+void CPoiDatabase::getPoisWithinRadius(double latitude, double longitude, double radius, CPOI::t_poi type, Poi_Neighbour_Container_t &result)
+{
+	this->syncSpatialIndex();
+	this->m_spatialIndex[type].withinRadius(latitude, longitude, radius, result);
+}
+
+
+/**
+ * Build the spatial indexes now instead of on the next query, e.g. after loading the database;
+ * POIs added one by one are merged into the trees
+ * returnvalue@ void
+ */
+void CPoiDatabase::buildSpatialIndex()
+{
+	bool isNumbered = true;
+
+	for (unsigned int type = 0; type <= CPOI::DEFAULT_POI; ++type)
+	{
+		isNumbered = isNumbered && this->m_spatialIndex[type].isNumbered();
+	}
+
+	// the POIs added one by one since the last build are merged into one tree per type
+	if ((this->m_indexGeneration != this->getGeneration()) || !isNumbered)
+	{
+		this->rebuildSpatialIndex();
+	}
+}
+
+
+/**
+ * Rebuild the spatial indexes if the database has changed since they were built
+ * returnvalue@ void
+ */
+void CPoiDatabase::syncSpatialIndex()
+{
+	if (this->m_indexGeneration != this->getGeneration())
+	{
+		this->rebuildSpatialIndex();
+	}
+}
+
+
+/**
+ * Build the spatial indexes over all the POIs of the database
+ * returnvalue@ void
+ */
+void CPoiDatabase::rebuildSpatialIndex()
+{
+	vector<CPOI *> 		all;
+	vector<CPOI *> 		pois[CPOI::DEFAULT_POI + 1];
+	vector<uint32_t> 	numbers[CPOI::DEFAULT_POI + 1];
+
+	// a POI is numbered in the order of the names of all the POIs, as a snapshot stores it
+	this->getElementsInKeyOrder(all);
+
+	for (uint32_t number = 0; number < all.size(); ++number)
+	{
+		unsigned int type = all[number]->getPoiType();
+
+		pois[type].push_back(all[number]);
+		numbers[type].push_back(number);
+	}
+
+	for (unsigned int type = 0; type <= CPOI::DEFAULT_POI; ++type)
+	{
+		this->m_spatialIndex[type].build(pois[type], numbers[type]);
+	}
+
+	this->m_indexGeneration = this->getGeneration();
+}
+
+
+/**
+ * Point the list of all the spatial indexes to the indexes of this database
+ * returnvalue@ void
+ */
+void CPoiDatabase::initAllIndexes()
+{
+	this->m_allIndexes.clear();
+
+	for (unsigned int type = 0; type <= CPOI::DEFAULT_POI; ++type)
+	{
+		this->m_allIndexes.push_back(&this->m_spatialIndex[type]);
+	}
+}
@@ -14,30 +14,57 @@
 
 //System Include Files
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
 
 //Own Include Files
 #include "CPOI.h"
 #include "CDatabase.h"
+#include "CSpatialIndex.h"
 
-typedef std::string								POI_Database_key_t;
+typedef CPooledString							POI_Database_key_t;
 
-class CPoiDatabase : public CDatabase<POI_Database_key_t, CPOI> {
+#if (defined(CONFIG_DATABASE_STORAGE) && (CONFIG_DATABASE_STORAGE == MORTON_ORDER))
+typedef CMortonStorage<POI_Database_key_t, CPOI>				Poi_Storage_t;
+#elif (defined(CONFIG_DATABASE_STORAGE) && (CONFIG_DATABASE_STORAGE == HASH_TABLE))
+typedef CHashStorage<POI_Database_key_t, CPOI>					Poi_Storage_t;
+#else
+typedef CMapStorage<POI_Database_key_t, CPOI>					Poi_Storage_t;
+#endif
+
+class CPoiDatabase : public CDatabase<POI_Database_key_t, CPOI, Poi_Storage_t> {
 public:
 
 	typedef std::map<POI_Database_key_t, CPOI> 					Poi_Map_t;
 	typedef std::map<POI_Database_key_t, CPOI>::iterator 		Poi_Map_Itr_t;
+	typedef Poi_Storage_t::Storage_ConstItr_t					Poi_ConstItr_t;
+	typedef CSpatialIndex<CPOI>::Neighbour_Container_t			Poi_Neighbour_Container_t;
+	typedef CSpatialIndex<CPOI>::Index_Container_t				Poi_Index_Container_t;
 
     /**
 	 * CPoiDatabase constructor
 	 */
     CPoiDatabase();
 
+    /**
+     * CPoiDatabase copy constructor: the spatial indexes are rebuilt over the copied POIs
+     * param@ CPoiDatabase const &origin	-	database to be copied	(IN)
+     */
+    CPoiDatabase(CPoiDatabase const &origin);
+
     /**
      * CPoiDatabase destructor
      */
     ~CPoiDatabase();
 
+    /**
+     * A copy assignment operator: the spatial indexes are rebuilt over the copied POIs
+     * param@ CPoiDatabase const &rhs		-	database to be copied	(IN)
+     * returnvalue@ CPoiDatabase&
+     */
+    CPoiDatabase& operator=(CPoiDatabase const &rhs);
+
     /*
      * Add a Point of interest to the database
      * param@ POI_Database_key_t const &key	- 	unique name for the poi		(IN)
@@ -47,18 +74,36 @@ public:
     void addPoi(POI_Database_key_t const &key, CPOI const &poi);
 
     /**
-	 * Get pointer to a POI from the Database which matches the name
-	 * param@ POI_Database_key_t key		-	key of a POI					(IN)
-	 * returnvalue@ CPOI*						-	Pointer to a POI in the database(IN)
+	 * Get pointer to a POI from the Database which matches the name;
+	 * the name is not added to the string pool
+	 * param@ std::string_view name			-	name of a POI					(IN)
+	 * returnvalue@ CPOI*						-	Pointer to a POI in the database, 0 if not found
 	 */
-    CPOI* getPointerToPoi(POI_Database_key_t key);
+    CPOI* getPointerToPoi(std::string_view name);
 
     /**
-     * Get POIs from the Database
+	 * Get read only access to a POI from the Database which matches the name
+	 * param@ std::string_view name			-	name of a POI					(IN)
+	 * returnvalue@ CPOI const*				-	Pointer to a POI in the database, 0 if not found
+	 */
+    CPOI const* getPointerToPoi(std::string_view name) const;
+
+    /**
+     * Get a copy of the POIs from the Database; visitPois reads them without a copy
      * returnvalue@ Poi_Map_t			-	POIs in the Database	(OUT)
      */
     const Poi_Map_t getPoisFromDatabase() const;
 
+    /**
+	 * Visit all the POIs in place, in the order of their names.
+	 * The visitor is called as visitor(POI_Database_key_t const &key, CPOI const &poi)
+	 * and must not add POIs to the database.
+	 * param@ TVisitor &visitor			-	called for every POI	(IN)
+	 * returnvalue@ void
+	 */
+    template<class TVisitor>
+    void visitPois(TVisitor &visitor) const;
+
     /**
 	 * Resets the Database
 	 * returnvalue@ void
@@ -71,8 +116,324 @@ public:
 	 */
 	void print();
 
+	/**
+	 * Get the POI closest to the given position
+	 * param@ double latitude		-	latitude of the position	(IN)
+	 * param@ double longitude		-	longitude of the position	(IN)
+	 * returnvalue@ CPOI*			-	Pointer to a POI in the database, 0 if the database is empty or the position is invalid
+	 */
+	CPOI* getNearestPoi(double latitude, double longitude);
+
+	/**
+	 * Get the POI of the given type closest to the given position
+	 * param@ double latitude		-	latitude of the position	(IN)
+	 * param@ double longitude		-	longitude of the position	(IN)
+	 * param@ CPOI::t_poi type		-	type of the POI				(IN)
+	 * returnvalue@ CPOI*			-	Pointer to a POI in the database, 0 if there is no POI of the type or the position is invalid
+	 */
+	CPOI* getNearestPoi(double latitude, double longitude, CPOI::t_poi type);
+
+	/**
+	 * Get the POI closest to the given position under the given distance model.
+	 * The spatial index prefilters on the sphere; for VINCENTY the POIs which can still be
+	 * closer on the ellipsoid are re-ranked, the other models measure the nearest POI of the sphere.
+	 * param@ double latitude							-	latitude of the position	(IN)
+	 * param@ double longitude							-	longitude of the position	(IN)
+	 * param@ CWaypoint::t_distance_model model		-	distance model				(IN)
+	 * param@ double &distance							-	distance in KMs				(OUT)
+	 * returnvalue@ CPOI*								-	Pointer to a POI in the database, 0 if the database is empty or the position is invalid
+	 */
+	CPOI* getNearestPoi(double latitude, double longitude, CWaypoint::t_distance_model model, double &distance);
+
+	/**
+	 * Get the k POIs closest to the given position, the closest one first; none for an invalid position
+	 * param@ double latitude						-	latitude of the position	(IN)
+	 * param@ double longitude						-	longitude of the position	(IN)
+	 * param@ unsigned int k						-	number of POIs				(IN)
+	 * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+	 * returnvalue@ void
+	 */
+	void getNearestPois(double latitude, double longitude, unsigned int k, Poi_Neighbour_Container_t &result);
+
+	/**
+	 * Get the k POIs of the given type closest to the given position, the closest one first; none for an invalid position
+	 * param@ double latitude						-	latitude of the position	(IN)
+	 * param@ double longitude						-	longitude of the position	(IN)
+	 * param@ unsigned int k						-	number of POIs				(IN)
+	 * param@ CPOI::t_poi type						-	type of the POIs			(IN)
+	 * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+	 * returnvalue@ void
+	 */
+	void getNearestPois(double latitude, double longitude, unsigned int k, CPOI::t_poi type, Poi_Neighbour_Container_t &result);
+
+	/**
+	 * Get the k POIs closest to each of the given positions.
+	 * The positions are processed in Z-order for cache locality and split across the cores.
+	 * The result of position i is stored at [i * k, i * k + k), the closest POI first;
+	 * missing POIs (database smaller than k) have a null pointer.
+	 * param@ CWaypoint const positions[]			-	query positions				(IN)
+	 * param@ unsigned int count					-	number of positions			(IN)
+	 * param@ unsigned int k						-	number of POIs per position	(IN)
+	 * param@ Poi_Neighbour_Container_t &results	-	POIs and distances in KMs	(OUT)
+	 * param@ unsigned int threads					-	number of threads, 0 for all the cores	(IN)
+	 * returnvalue@ void
+	 */
+	void getNearestPois(CWaypoint const positions[], unsigned int count, unsigned int k, Poi_Neighbour_Container_t &results, unsigned int threads = 0);
+
+	/**
+	 * Get all the POIs within the radius around the given position, the closest one first
+	 * param@ double latitude						-	latitude of the position	(IN)
+	 * param@ double longitude						-	longitude of the position	(IN)
+	 * param@ double radius							-	radius in KMs				(IN)
+	 * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+	 * returnvalue@ void
+	 */
+	void getPoisWithinRadius(double latitude, double longitude, double radius, Poi_Neighbour_Container_t &result);
+
+	/**
+	 * Get all the POIs of the given type within the radius around the given position, the closest one first
+	 * param@ double latitude						-	latitude of the position	(IN)
+	 * param@ double longitude						-	longitude of the position	(IN)
+	 * param@ double radius							-	radius in KMs				(IN)
+	 * param@ CPOI::t_poi type						-	type of the POIs			(IN)
+	 * param@ Poi_Neighbour_Container_t &result		-	POIs and distances in KMs	(OUT)
+	 * returnvalue@ void
+	 */
+	void getPoisWithinRadius(double latitude, double longitude, double radius, CPOI::t_poi type, Poi_Neighbour_Container_t &result);
+
+	/**
+	 * Visit all the POIs inside the latitude / longitude rectangle, e.g. the viewport of the map.
+	 * A rectangle with minLongitude > maxLongitude crosses the date line.
+	 * The visitor is called as visitor(CPOI &poi) and must not add POIs to the database.
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ TVisitor &visitor			-	called for every POI in the rectangle	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor);
+
+	/**
+	 * Visit all the POIs of the given type inside the latitude / longitude rectangle
+	 * (see the method above).
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ CPOI::t_poi type			-	type of the POIs	(IN)
+	 * param@ TVisitor &visitor			-	called for every POI in the rectangle	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, CPOI::t_poi type, TVisitor &visitor);
+
+	/**
+	 * Build the spatial indexes now instead of on the next query, e.g. after loading the database;
+	 * POIs added one by one are merged into the trees
+	 * returnvalue@ void
+	 */
+	void buildSpatialIndex();
+
+	/**
+	 * Take over the spatial indexes which were built over the POIs of the database, e.g. stored in
+	 * a snapshot, instead of building them again. The trees of the POI types follow each other,
+	 * a node gives the number of its POI in keys; the indexes are built again if the nodes do not
+	 * match the POIs.
+	 * param@ TNode const pNodes[]							-	nodes of all the trees					(IN)
+	 * param@ uint32_t const pBounds[]						-	first node of every tree and the end	(IN)
+	 * param@ std::vector<POI_Database_key_t> const &keys	-	names of the POIs by number				(IN)
+	 * returnvalue@ bool									-	false if the indexes were built again
+	 */
+	template<class TNode>
+	bool adoptSpatialIndex(TNode const pNodes[], uint32_t const pBounds[], std::vector<POI_Database_key_t> const &keys);
+
+	/**
+	 * Visit the nodes of the spatial indexes, e.g. to store them in a snapshot: the trees of the
+	 * POI types follow each other, a node gives the number of its POI in the order of the names
+	 * (see CSpatialIndex::visitNodes).
+	 * The visitor is called as visitor(CPOI const &poi, uint32_t number, double const coord[3], int axis).
+	 * param@ TVisitor &visitor			-	called for every node	(IN)
+	 * returnvalue@ bool				-	false if the indexes are not one tree per type over the current
+	 * 										POIs; nothing is visited then
+	 */
+	template<class TVisitor>
+	bool visitSpatialIndexNodes(TVisitor &visitor) const;
+
+private:
+
+	/**
+	 * One spatial index per POI type; unfiltered queries search all of them
+	 */
+	CSpatialIndex<CPOI>											m_spatialIndex[CPOI::DEFAULT_POI + 1];
+
+	/**
+	 * The spatial indexes of all the POI types
+	 */
+	Poi_Index_Container_t										m_allIndexes;
+
+	/**
+	 * The database generation the spatial indexes reflect
+	 */
+	unsigned long												m_indexGeneration;
+
+	/**
+	 * Rebuild the spatial indexes if the database has changed since they were built
+	 * returnvalue@ void
+	 */
+	void syncSpatialIndex();
+
+	/**
+	 * Build the spatial indexes over all the POIs of the database
+	 * returnvalue@ void
+	 */
+	void rebuildSpatialIndex();
+
+	/**
+	 * Point the list of all the spatial indexes to the indexes of this database
+	 * returnvalue@ void
+	 */
+	void initAllIndexes();
 };
 /********************
 **  CLASS END
 *********************/
+
+/**
+ * Visit all the POIs inside the latitude / longitude rectangle, e.g. the viewport of the map.
+ * A rectangle with minLongitude > maxLongitude crosses the date line.
+ * The visitor is called as visitor(CPOI &poi) and must not add POIs to the database.
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ TVisitor &visitor			-	called for every POI in the rectangle	(IN)
+ * returnvalue@ void
+ */
+template<class TVisitor>
+void CPoiDatabase::visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor)
+{
+	this->syncSpatialIndex();
+	CSpatialIndex<CPOI>::visitRectangle(this->m_allIndexes, minLatitude, maxLatitude, minLongitude, maxLongitude, visitor);
+}
+
+
+/**
+ * Visit all the POIs in place, in the order of their names.
+ * The visitor is called as visitor(POI_Database_key_t const &key, CPOI const &poi)
+ * and must not add POIs to the database.
+ * param@ TVisitor &visitor			-	called for every POI	(IN)
+ * returnvalue@ void
+ */
+template<class TVisitor>
+void CPoiDatabase::visitPois(TVisitor &visitor) const
+{
+	this->visitElements(visitor);
+}
+
+
+/**
+ * Visit all the POIs of the given type inside the latitude / longitude rectangle
+ * (see the method above).
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ CPOI::t_poi type			-	type of the POIs	(IN)
+ * param@ TVisitor &visitor			-	called for every POI in the rectangle	(IN)
+ * returnvalue@ void
+ */
+template<class TVisitor>
+void CPoiDatabase::visitPoisInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, CPOI::t_poi type, TVisitor &visitor)
+{
+	this->syncSpatialIndex();
+	this->m_spatialIndex[type].visitRectangle(minLatitude, maxLatitude, minLongitude, maxLongitude, visitor);
+}
+
+
+/**
+ * Take over the spatial indexes which were built over the POIs of the database, e.g. stored in
+ * a snapshot, instead of building them again. The trees of the POI types follow each other,
+ * a node gives the number of its POI in keys; the indexes are built again if the nodes do not
+ * match the POIs.
+ * param@ TNode const pNodes[]							-	nodes of all the trees					(IN)
+ * param@ uint32_t const pBounds[]						-	first node of every tree and the end	(IN)
+ * param@ std::vector<POI_Database_key_t> const &keys	-	names of the POIs by number				(IN)
+ * returnvalue@ bool									-	false if the indexes were built again
+ */
+template<class TNode>
+bool CPoiDatabase::adoptSpatialIndex(TNode const pNodes[], uint32_t const pBounds[], std::vector<POI_Database_key_t> const &keys)
+{
+	std::vector<CPOI *> pois;
+	std::vector<bool> 	isIndexed(keys.size(), false);
+	bool 				isValid = !pBounds[0] && (pBounds[CPOI::DEFAULT_POI + 1] == keys.size())
+									&& (this->getElementCount() == keys.size()) && this->getElementsByKey(keys, pois);
+
+	// every POI is in the tree of its type once
+	for (unsigned int type = 0; isValid && (type <= CPOI::DEFAULT_POI); ++type)
+	{
+		isValid = (pBounds[type] <= pBounds[type + 1]);
+
+		for (uint32_t node = pBounds[type]; isValid && (node < pBounds[type + 1]); ++node)
+		{
+			uint32_t element = pNodes[node].element;
+
+			isValid = (element < keys.size()) && !isIndexed[element] && (pois[element]->getPoiType() == type) && (pNodes[node].axis < 3);
+
+			if (isValid)
+			{
+				isIndexed[element] = true;
+			}
+		}
+	}
+
+	if (isValid)
+	{
+		for (unsigned int type = 0; type <= CPOI::DEFAULT_POI; ++type)
+		{
+			this->m_spatialIndex[type].adoptTree(pNodes + pBounds[type], pBounds[type + 1] - pBounds[type], pois.data());
+		}
+
+		this->m_indexGeneration = this->getGeneration();
+	}
+	else
+	{
+		this->rebuildSpatialIndex();
+	}
+
+	return isValid;
+}
+
+
+/**
+ * Visit the nodes of the spatial indexes, e.g. to store them in a snapshot: the trees of the
+ * POI types follow each other, a node gives the number of its POI in the order of the names
+ * (see CSpatialIndex::visitNodes).
+ * The visitor is called as visitor(CPOI const &poi, uint32_t number, double const coord[3], int axis).
+ * param@ TVisitor &visitor			-	called for every node	(IN)
+ * returnvalue@ bool				-	false if the indexes are not one tree per type over the current
+ * 										POIs; nothing is visited then
+ */
+template<class TVisitor>
+bool CPoiDatabase::visitSpatialIndexNodes(TVisitor &visitor) const
+{
+	bool 			isCurrent 	= (this->m_indexGeneration == this->getGeneration());
+	unsigned int 	size 		= 0;
+
+	for (unsigned int type = 0; isCurrent && (type <= CPOI::DEFAULT_POI); ++type)
+	{
+		isCurrent 	= this->m_spatialIndex[type].isNumbered();
+		size 		+= this->m_spatialIndex[type].size();
+	}
+
+	isCurrent = isCurrent && (size == this->getElementCount());
+
+	for (unsigned int type = 0; isCurrent && (type <= CPOI::DEFAULT_POI); ++type)
+	{
+		this->m_spatialIndex[type].visitNodes(visitor);
+	}
+
+	return isCurrent;
+}
 #endif /* CPOIDATABASE_H */
@@ -0,0 +1,178 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CRingBuffer.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a template class CRingBuffer.
+* 					The class CRingBuffer passes elements from one
+* 					producer thread to one consumer thread without a
+* 					lock: the producer only writes the tail, the consumer
+* 					only writes the head, both are atomic counters on
+* 					cache lines of their own. push() and pop() never
+* 					wait, they fail when the buffer is full or empty.
+*
+****************************************************************************/
+
+#ifndef CRINGBUFFER_H
+#define CRINGBUFFER_H
+
+//System Include Files
+#include <vector>
+#include <atomic>
+
+//Own Include Files
+
+//Macros
+// size of a cache line: the counters of the producer and the consumer do not share one
+#define RING_BUFFER_CACHE_LINE			64
+
+template<class T>
+class CRingBuffer {
+public:
+
+	/**
+	 * CRingBuffer constructor
+	 * param@ unsigned int capacity		-	number of elements, rounded up to a power of two	(IN)
+	 */
+	explicit CRingBuffer(unsigned int capacity);
+
+	/**
+	 * Append an element; called by the producer thread only
+	 * param@ T const &elem				-	element			(IN)
+	 * returnvalue@ bool				-	false if the buffer is full
+	 */
+	bool push(T const &elem);
+
+	/**
+	 * Take the oldest element; called by the consumer thread only
+	 * param@ T &elem					-	element			(OUT)
+	 * returnvalue@ bool				-	false if the buffer is empty
+	 */
+	bool pop(T &elem);
+
+	/**
+	 * Check if the buffer is empty; exact when called by the consumer
+	 * returnvalue@ bool
+	 */
+	bool isEmpty() const;
+
+	/**
+	 * Get the number of elements the buffer can hold
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getCapacity() const;
+
+private:
+
+	/**
+	 * The elements; a counter is turned into a slot by the mask
+	 */
+	std::vector<T>									m_slots;
+	unsigned int									m_mask;
+
+	/**
+	 * Number of elements taken by the consumer and appended by the producer
+	 */
+	alignas(RING_BUFFER_CACHE_LINE) std::atomic<unsigned int>	m_head;
+	alignas(RING_BUFFER_CACHE_LINE) std::atomic<unsigned int>	m_tail;
+
+	/**
+	 * The buffer is shared by two threads, it is not copied
+	 */
+	CRingBuffer(CRingBuffer const &origin);
+	CRingBuffer& operator=(CRingBuffer const &rhs);
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * CRingBuffer constructor
+ * param@ unsigned int capacity		-	number of elements, rounded up to a power of two	(IN)
+ */
+template<class T>
+CRingBuffer<T>::CRingBuffer(unsigned int capacity) : m_head(0), m_tail(0)
+{
+	unsigned int size = 1;
+
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+
+	this->m_slots.resize(size);
+	this->m_mask = size - 1;
+}
+
+
+/**
+ * Append an element; called by the producer thread only
+ * param@ T const &elem				-	element			(IN)
+ * returnvalue@ bool				-	false if the buffer is full
+ */
+template<class T>
+bool CRingBuffer<T>::push(T const &elem)
+{
+	unsigned int tail = this->m_tail.load(std::memory_order_relaxed);
+
+	// the counters wrap around together, the difference is the number of elements
+	if (tail - this->m_head.load(std::memory_order_acquire) == this->m_slots.size())
+	{
+		return false;
+	}
+
+	this->m_slots[tail & this->m_mask] = elem;
+
+	// the element is written before the consumer sees the new tail
+	this->m_tail.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+
+/**
+ * Take the oldest element; called by the consumer thread only
+ * param@ T &elem					-	element			(OUT)
+ * returnvalue@ bool				-	false if the buffer is empty
+ */
+template<class T>
+bool CRingBuffer<T>::pop(T &elem)
+{
+	unsigned int head = this->m_head.load(std::memory_order_relaxed);
+
+	if (head == this->m_tail.load(std::memory_order_acquire))
+	{
+		return false;
+	}
+
+	elem = this->m_slots[head & this->m_mask];
+
+	// the slot is read before the producer may write it again
+	this->m_head.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+
+
+/**
+ * Check if the buffer is empty; exact when called by the consumer
+ * returnvalue@ bool
+ */
+template<class T>
+bool CRingBuffer<T>::isEmpty() const
+{
+	return (this->m_head.load(std::memory_order_acquire) == this->m_tail.load(std::memory_order_acquire));
+}
+
+
+/**
+ * Get the number of elements the buffer can hold
+ * returnvalue@ unsigned int
+ */
+template<class T>
+unsigned int CRingBuffer<T>::getCapacity() const
+{
+	return this->m_slots.size();
+}
+#endif /* CRINGBUFFER_H */
@@ -0,0 +1,560 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CRoadGraph.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CRoadGraph.
+* 					The class CRoadGraph is used to hold the roads between
+* 					the waypoints and to find the shortest path between
+* 					two waypoints (Dijkstra or A*).
+*
+****************************************************************************/
+
+//System Include Files
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+
+//Own Include Files
+#include "CRoadGraph.h"
+#include "CMortonCode.h"
+#include "CSpatialIndex.h"
+
+//Namespaces
+using namespace std;
+
+//Method Implementations
+/**
+ * CRoadGraph constructor
+ */
+CRoadGraph::CRoadGraph()
+{
+	this->m_isBuilt			= true;
+	this->m_heuristicScale	= 1;
+	this->m_query			= 0;
+	this->m_settledCount	= 0;
+	this->m_offsets.push_back(0);
+}
+
+
+/**
+ * CRoadGraph destructor
+ */
+CRoadGraph::~CRoadGraph()
+{
+	// do nothing
+}
+
+
+/**
+ * Add a node for every Waypoint of the database
+ * param@ CWpDatabase const &wpDatabase	-	Waypoint database	(IN)
+ * returnvalue@ void
+ */
+void CRoadGraph::addNodes(CWpDatabase const &wpDatabase)
+{
+	for (CWpDatabase::Wp_ConstItr_t itr = wpDatabase.begin(); itr != wpDatabase.end(); ++itr)
+	{
+		this->addNode(itr->first, itr->second.getLatitude(), itr->second.getLongitude());
+	}
+}
+
+
+/**
+ * Add a node
+ * param@ Wp_Database_key_t const &name	-	unique name of the node, e.g. of a Waypoint	(IN)
+ * param@ double latitude				-	latitude of the node						(IN)
+ * param@ double longitude				-	longitude of the node						(IN)
+ * returnvalue@ bool					-	false if the name already exists or the position is invalid
+ */
+bool CRoadGraph::addNode(Wp_Database_key_t const &name, double latitude, double longitude)
+{
+	if (!CWaypoint::isValidPosition(latitude, longitude))
+	{
+		cout << "WARNING: The node - \"" << name << "\" has an invalid position.\n";
+		return false;
+	}
+
+	pair<map<Wp_Database_key_t, Node_t>::iterator, bool> result = this->m_nodes.insert(make_pair(name, (Node_t)this->m_names.size()));
+
+	if (!result.second)
+	{
+		cout << "WARNING: The node - \"" << name << "\" is already available in the road graph.\n";
+		return false;
+	}
+
+	double coord[3];
+
+	CSpatialIndex<CWaypoint>::toUnitVector(latitude, longitude, coord);
+
+	this->unbuild();
+	this->m_names.push_back(&result.first->first);
+	this->m_coords.insert(this->m_coords.end(), coord, coord + 3);
+
+	return true;
+}
+
+
+/**
+ * Add a road between two nodes
+ * param@ Wp_Database_key_t const &from	-	start of the road							(IN)
+ * param@ Wp_Database_key_t const &to	-	end of the road								(IN)
+ * param@ bool isOneWay					-	false to add the road in both directions	(IN)
+ * param@ double length					-	length in KMs, <= 0 for the great circle distance	(IN)
+ * returnvalue@ bool					-	false if a node does not exist
+ */
+bool CRoadGraph::addEdge(Wp_Database_key_t const &from, Wp_Database_key_t const &to, bool isOneWay, double length)
+{
+	map<Wp_Database_key_t, Node_t>::const_iterator fromItr 	= this->m_nodes.find(from);
+	map<Wp_Database_key_t, Node_t>::const_iterator toItr 	= this->m_nodes.find(to);
+
+	if ((fromItr == this->m_nodes.end()) || (toItr == this->m_nodes.end()))
+	{
+		cout << "WARNING: The road from \"" << from << "\" to \"" << to << "\" has no node in the road graph.\n";
+		return false;
+	}
+
+	Edge edge;
+
+	edge.from 	= fromItr->second;
+	edge.to 	= toItr->second;
+
+	if (length <= 0)
+	{
+		// great circle distance from the chord
+		length = 2 * EARTH_RADIUS_KM * asin(min(1.0, this->chordDistance(edge.from, edge.to) / (2 * EARTH_RADIUS_KM)));
+	}
+
+	edge.length = (float)length;
+
+	this->unbuild();
+	this->m_edges.push_back(edge);
+
+	if (!isOneWay)
+	{
+		swap(edge.from, edge.to);
+		this->m_edges.push_back(edge);
+	}
+
+	return true;
+}
+
+
+/**
+ * Build the CSR arrays now instead of on the next query, e.g. after loading all the roads
+ * returnvalue@ void
+ */
+void CRoadGraph::build()
+{
+	if (this->m_isBuilt)
+	{
+		return;
+	}
+
+	unsigned int nodeCount = this->m_names.size();
+
+	// number the nodes in Z-order
+	vector<pair<CMortonCode::Morton_Code_t, Node_t> > order(nodeCount);
+
+	for (Node_t node = 0; node < nodeCount; node++)
+	{
+		double const *coord = &this->m_coords[3 * node];
+
+		order[node].first 	= CMortonCode::encode(asin(max(-1.0, min(1.0, coord[2]))) / DEG_TO_RAD, atan2(coord[1], coord[0]) / DEG_TO_RAD);
+		order[node].second 	= node;
+	}
+
+	sort(order.begin(), order.end());
+
+	vector<Node_t> 						newNode(nodeCount);
+	vector<Wp_Database_key_t const *> 	names(nodeCount);
+	vector<double> 						coords(3 * nodeCount);
+
+	for (Node_t node = 0; node < nodeCount; node++)
+	{
+		Node_t oldNode = order[node].second;
+
+		newNode[oldNode] = node;
+		names[node] 	 = this->m_names[oldNode];
+		copy(&this->m_coords[3 * oldNode], &this->m_coords[3 * oldNode] + 3, &coords[3 * node]);
+	}
+
+	this->m_names.swap(names);
+	this->m_coords.swap(coords);
+
+	for (map<Wp_Database_key_t, Node_t>::iterator itr = this->m_nodes.begin(); itr != this->m_nodes.end(); ++itr)
+	{
+		itr->second = newNode[itr->second];
+	}
+
+	// counting sort of the roads by their start
+	this->m_offsets.assign(nodeCount + 1, 0);
+	this->m_targets.resize(this->m_edges.size());
+	this->m_lengths.resize(this->m_edges.size());
+
+	for (unsigned int index = 0; index < this->m_edges.size(); index++)
+	{
+		this->m_offsets[newNode[this->m_edges[index].from] + 1]++;
+	}
+
+	for (Node_t node = 0; node < nodeCount; node++)
+	{
+		this->m_offsets[node + 1] += this->m_offsets[node];
+	}
+
+	vector<unsigned int> 	next(this->m_offsets.begin(), this->m_offsets.end() - 1);
+
+	this->m_heuristicScale = 1;
+
+	for (unsigned int index = 0; index < this->m_edges.size(); index++)
+	{
+		Edge const 		&edge 	= this->m_edges[index];
+		unsigned int 	slot 	= next[newNode[edge.from]]++;
+
+		this->m_targets[slot] = newNode[edge.to];
+		this->m_lengths[slot] = edge.length;
+
+		// the heuristic must not overestimate any road
+		double chord = this->chordDistance(newNode[edge.from], newNode[edge.to]);
+
+		if (edge.length < chord * this->m_heuristicScale)
+		{
+			this->m_heuristicScale = edge.length / chord;
+		}
+	}
+
+	// margin for the rounding of the estimates
+	this->m_heuristicScale *= (1 - 1e-12);
+
+	vector<Edge>().swap(this->m_edges);
+
+	this->m_distances.resize(nodeCount);
+	this->m_parents.resize(nodeCount);
+	this->m_reached.assign(nodeCount, 0);
+	this->m_query	= 0;
+	this->m_isBuilt = true;
+}
+
+
+/**
+ * Remove all the nodes and roads
+ * returnvalue@ void
+ */
+void CRoadGraph::clear()
+{
+	this->m_nodes.clear();
+	vector<Wp_Database_key_t const *>().swap(this->m_names);
+	vector<double>().swap(this->m_coords);
+	vector<Edge>().swap(this->m_edges);
+	vector<Node_t>().swap(this->m_targets);
+	vector<float>().swap(this->m_lengths);
+	vector<double>().swap(this->m_distances);
+	vector<Node_t>().swap(this->m_parents);
+	vector<unsigned int>().swap(this->m_reached);
+	vector<QueueEntry>().swap(this->m_queue);
+
+	this->m_offsets.assign(1, 0);
+	this->m_isBuilt			= true;
+	this->m_heuristicScale	= 1;
+	this->m_query			= 0;
+	this->m_settledCount	= 0;
+}
+
+
+/**
+ * Number of nodes
+ * returnvalue@ unsigned int
+ */
+unsigned int CRoadGraph::getNodeCount() const
+{
+	return this->m_names.size();
+}
+
+
+/**
+ * Number of directed edges
+ * returnvalue@ unsigned int
+ */
+unsigned int CRoadGraph::getEdgeCount() const
+{
+	return (this->m_isBuilt ? this->m_targets.size() : this->m_edges.size());
+}
+
+
+/**
+ * Get the node of the given name; the graph is built first, as this changes the numbers
+ * param@ std::string_view name		-	name of the node	(IN)
+ * returnvalue@ Node_t					-	node, INVALID_NODE if the name is unknown
+ */
+CRoadGraph::Node_t CRoadGraph::getNode(string_view name)
+{
+	Wp_Database_key_t key;
+
+	this->build();
+
+	// a name which is not in the string pool is not the name of any node
+	if (!Wp_Database_key_t::find(name, key))
+	{
+		return INVALID_NODE;
+	}
+
+	map<Wp_Database_key_t, Node_t>::const_iterator itr = this->m_nodes.find(key);
+
+	return ((itr != this->m_nodes.end()) ? itr->second : INVALID_NODE);
+}
+
+
+/**
+ * Get the name of a node
+ * param@ Node_t node						-	node	(IN)
+ * returnvalue@ Wp_Database_key_t const&	-	name of the node
+ */
+Wp_Database_key_t const& CRoadGraph::getName(Node_t node) const
+{
+	return *this->m_names[node];
+}
+
+
+/**
+ * Get the range of the outgoing edges of a node; the graph is built first
+ * param@ Node_t node					-	node						(IN)
+ * param@ unsigned int &begin			-	first edge					(OUT)
+ * param@ unsigned int &end				-	one past the last edge		(OUT)
+ * returnvalue@ void
+ */
+void CRoadGraph::getEdges(Node_t node, unsigned int &begin, unsigned int &end)
+{
+	this->build();
+
+	begin 	= this->m_offsets[node];
+	end 	= this->m_offsets[node + 1];
+}
+
+
+/**
+ * Get the end of an edge of the built graph
+ * param@ unsigned int edge				-	edge	(IN)
+ * returnvalue@ Node_t
+ */
+CRoadGraph::Node_t CRoadGraph::getEdgeTarget(unsigned int edge) const
+{
+	return this->m_targets[edge];
+}
+
+
+/**
+ * Get the length of an edge of the built graph in KMs
+ * param@ unsigned int edge				-	edge	(IN)
+ * returnvalue@ double
+ */
+double CRoadGraph::getEdgeLength(unsigned int edge) const
+{
+	return this->m_lengths[edge];
+}
+
+
+/**
+ * Find the shortest path between two nodes given by their names
+ * param@ std::string_view from		-	start of the path				(IN)
+ * param@ std::string_view to			-	end of the path					(IN)
+ * param@ Name_Path_t &path				-	names of the nodes of the path	(OUT)
+ * param@ double &length				-	length of the path in KMs		(OUT)
+ * param@ t_search search				-	search algorithm				(IN)
+ * returnvalue@ bool					-	false if there is no path
+ */
+bool CRoadGraph::findPath(string_view from, string_view to, Name_Path_t &path, double &length, t_search search)
+{
+	Path_t	nodes;
+	Node_t	source = this->getNode(from);
+	Node_t	target = this->getNode(to);
+
+	path.clear();
+
+	if ((source == INVALID_NODE) || (target == INVALID_NODE))
+	{
+		cout << "WARNING: The path from \"" << from << "\" to \"" << to << "\" has no node in the road graph.\n";
+		return false;
+	}
+
+	if (!this->findPath(source, target, nodes, length, search))
+	{
+		return false;
+	}
+
+	for (unsigned int index = 0; index < nodes.size(); index++)
+	{
+		path.push_back(this->getName(nodes[index]));
+	}
+
+	return true;
+}
+
+
+/**
+ * Find the shortest path between two nodes.
+ * The search state is reused between the queries: the method is not thread safe.
+ * param@ Node_t source					-	start of the path				(IN)
+ * param@ Node_t target					-	end of the path					(IN)
+ * param@ Path_t &path					-	nodes of the path				(OUT)
+ * param@ double &length				-	length of the path in KMs		(OUT)
+ * param@ t_search search				-	search algorithm				(IN)
+ * returnvalue@ bool					-	false if there is no path
+ */
+bool CRoadGraph::findPath(Node_t source, Node_t target, Path_t &path, double &length, t_search search)
+{
+	this->build();
+
+	path.clear();
+	this->m_settledCount = 0;
+
+	if ((source >= this->m_names.size()) || (target >= this->m_names.size()))
+	{
+		return false;
+	}
+
+	// a new query number marks all the distances as unknown
+	if (++this->m_query == 0)
+	{
+		fill(this->m_reached.begin(), this->m_reached.end(), 0);
+		this->m_query = 1;
+	}
+
+	double		scale = (search == ASTAR) ? this->m_heuristicScale : 0;
+	QueueEntry	entry;
+
+	entry.distance 	= 0;
+	entry.estimate 	= scale * this->chordDistance(source, target);
+	entry.node 		= source;
+
+	this->m_distances[source] 	= 0;
+	this->m_parents[source] 	= INVALID_NODE;
+	this->m_reached[source] 	= this->m_query;
+	this->m_queue.assign(1, entry);
+
+	while (!this->m_queue.empty())
+	{
+		pop_heap(this->m_queue.begin(), this->m_queue.end());
+		entry = this->m_queue.back();
+		this->m_queue.pop_back();
+
+		// a shorter way to the node has been found after this entry was queued
+		if (entry.distance > this->m_distances[entry.node])
+		{
+			continue;
+		}
+
+		this->m_settledCount++;
+
+		if (entry.node == target)
+		{
+			break;
+		}
+
+		for (unsigned int edge = this->m_offsets[entry.node]; edge < this->m_offsets[entry.node + 1]; edge++)
+		{
+			Node_t node 	= this->m_targets[edge];
+			double distance = entry.distance + this->m_lengths[edge];
+
+			if ((this->m_reached[node] != this->m_query) || (distance < this->m_distances[node]))
+			{
+				QueueEntry next;
+
+				next.distance 	= distance;
+				next.estimate 	= distance + ((scale > 0) ? scale * this->chordDistance(node, target) : 0);
+				next.node 		= node;
+
+				this->m_distances[node] = distance;
+				this->m_parents[node] 	= entry.node;
+				this->m_reached[node] 	= this->m_query;
+				this->m_queue.push_back(next);
+				push_heap(this->m_queue.begin(), this->m_queue.end());
+			}
+		}
+	}
+
+	if (this->m_reached[target] != this->m_query)
+	{
+		return false;
+	}
+
+	for (Node_t node = target; node != INVALID_NODE; node = this->m_parents[node])
+	{
+		path.push_back(node);
+	}
+
+	reverse(path.begin(), path.end());
+	length = this->m_distances[target];
+
+	return true;
+}
+
+
+/**
+ * Number of nodes settled by the last search
+ * returnvalue@ unsigned int
+ */
+unsigned int CRoadGraph::getSettledCount() const
+{
+	return this->m_settledCount;
+}
+
+
+/**
+ * Order of the priority queue: std heaps keep the largest element on top, so the comparison is reversed
+ * param@ QueueEntry const &rhs		-	other entry		(IN)
+ * returnvalue@ bool				-	true if this entry has the longer estimate
+ */
+bool CRoadGraph::QueueEntry::operator<(QueueEntry const &rhs) const
+{
+	return (this->estimate > rhs.estimate);
+}
+
+
+/**
+ * Move the CSR arrays back into the list of roads before the graph changes
+ * returnvalue@ void
+ */
+void CRoadGraph::unbuild()
+{
+	if (!this->m_isBuilt)
+	{
+		return;
+	}
+
+	for (Node_t node = 0; node + 1 < this->m_offsets.size(); node++)
+	{
+		for (unsigned int edge = this->m_offsets[node]; edge < this->m_offsets[node + 1]; edge++)
+		{
+			Edge road;
+
+			road.from 	= node;
+			road.to 	= this->m_targets[edge];
+			road.length = this->m_lengths[edge];
+
+			this->m_edges.push_back(road);
+		}
+	}
+
+	vector<unsigned int>().swap(this->m_offsets);
+	vector<Node_t>().swap(this->m_targets);
+	vector<float>().swap(this->m_lengths);
+
+	this->m_isBuilt = false;
+}
+
+
+/**
+ * Straight line distance between two nodes through the earth in KMs
+ * param@ Node_t lhs		-	first node	(IN)
+ * param@ Node_t rhs		-	second node	(IN)
+ * returnvalue@ double
+ */
+double CRoadGraph::chordDistance(Node_t lhs, Node_t rhs) const
+{
+	double const *a = &this->m_coords[3 * lhs];
+	double const *b = &this->m_coords[3 * rhs];
+	double dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+
+	return (EARTH_RADIUS_KM * sqrt(dx * dx + dy * dy + dz * dz));
+}
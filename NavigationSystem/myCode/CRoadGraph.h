@@ -0,0 +1,278 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CRoadGraph.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CRoadGraph.
+* 					The class CRoadGraph is used to hold the roads between
+* 					the waypoints and to find the shortest path between
+* 					two waypoints (Dijkstra or A*).
+*
+* 					The edges are kept in compressed sparse row (CSR)
+* 					arrays: the outgoing edges of node i are the entries
+* 					[offsets[i], offsets[i + 1]) of the target and the
+* 					length arrays. The nodes are numbered in Z-order, so
+* 					neighbouring nodes are mostly close in memory.
+*
+* 					The A* heuristic is the straight line (chord) distance
+* 					through the earth, which never exceeds the great
+* 					circle distance; it is scaled down further when an
+* 					edge is shorter than the great circle between its
+* 					ends, so the search stays exact.
+*
+****************************************************************************/
+
+#ifndef CROADGRAPH_H
+#define CROADGRAPH_H
+
+//System Include Files
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+
+//Own Include Files
+#include "CWpDatabase.h"
+
+class CRoadGraph {
+public:
+
+	typedef unsigned int							Node_t;
+	typedef std::vector<Node_t>						Path_t;
+	typedef std::vector<Wp_Database_key_t>			Name_Path_t;
+
+	/**
+	 * Search algorithms for the shortest path
+	 */
+	enum t_search
+	{
+		DIJKSTRA,
+		ASTAR,
+	};
+
+	/**
+	 * Node number of an unknown waypoint
+	 */
+	static const Node_t INVALID_NODE = 0xFFFFFFFFu;
+
+	/**
+	 * CRoadGraph constructor
+	 */
+	CRoadGraph();
+
+	/**
+	 * CRoadGraph destructor
+	 */
+	~CRoadGraph();
+
+	/**
+	 * Add a node for every Waypoint of the database
+	 * param@ CWpDatabase const &wpDatabase	-	Waypoint database	(IN)
+	 * returnvalue@ void
+	 */
+	void addNodes(CWpDatabase const &wpDatabase);
+
+	/**
+	 * Add a node
+	 * param@ Wp_Database_key_t const &name	-	unique name of the node, e.g. of a Waypoint	(IN)
+	 * param@ double latitude				-	latitude of the node						(IN)
+	 * param@ double longitude				-	longitude of the node						(IN)
+	 * returnvalue@ bool					-	false if the name already exists or the position is invalid
+	 */
+	bool addNode(Wp_Database_key_t const &name, double latitude, double longitude);
+
+	/**
+	 * Add a road between two nodes
+	 * param@ Wp_Database_key_t const &from	-	start of the road							(IN)
+	 * param@ Wp_Database_key_t const &to	-	end of the road								(IN)
+	 * param@ bool isOneWay					-	false to add the road in both directions	(IN)
+	 * param@ double length					-	length in KMs, <= 0 for the great circle distance	(IN)
+	 * returnvalue@ bool					-	false if a node does not exist
+	 */
+	bool addEdge(Wp_Database_key_t const &from, Wp_Database_key_t const &to, bool isOneWay = false, double length = 0);
+
+	/**
+	 * Build the CSR arrays now instead of on the next query, e.g. after loading all the roads
+	 * returnvalue@ void
+	 */
+	void build();
+
+	/**
+	 * Remove all the nodes and roads
+	 * returnvalue@ void
+	 */
+	void clear();
+
+	/**
+	 * Number of nodes
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getNodeCount() const;
+
+	/**
+	 * Number of directed edges
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getEdgeCount() const;
+
+	/**
+	 * Get the node of the given name; the graph is built first, as this changes the numbers
+	 * param@ std::string_view name		-	name of the node	(IN)
+	 * returnvalue@ Node_t					-	node, INVALID_NODE if the name is unknown
+	 */
+	Node_t getNode(std::string_view name);
+
+	/**
+	 * Get the name of a node
+	 * param@ Node_t node						-	node	(IN)
+	 * returnvalue@ Wp_Database_key_t const&	-	name of the node
+	 */
+	Wp_Database_key_t const& getName(Node_t node) const;
+
+	/**
+	 * Get the range of the outgoing edges of a node; the graph is built first
+	 * param@ Node_t node					-	node						(IN)
+	 * param@ unsigned int &begin			-	first edge					(OUT)
+	 * param@ unsigned int &end				-	one past the last edge		(OUT)
+	 * returnvalue@ void
+	 */
+	void getEdges(Node_t node, unsigned int &begin, unsigned int &end);
+
+	/**
+	 * Get the end of an edge of the built graph
+	 * param@ unsigned int edge				-	edge	(IN)
+	 * returnvalue@ Node_t
+	 */
+	Node_t getEdgeTarget(unsigned int edge) const;
+
+	/**
+	 * Get the length of an edge of the built graph in KMs
+	 * param@ unsigned int edge				-	edge	(IN)
+	 * returnvalue@ double
+	 */
+	double getEdgeLength(unsigned int edge) const;
+
+	/**
+	 * Find the shortest path between two nodes given by their names
+	 * param@ std::string_view from		-	start of the path				(IN)
+	 * param@ std::string_view to			-	end of the path					(IN)
+	 * param@ Name_Path_t &path				-	names of the nodes of the path	(OUT)
+	 * param@ double &length				-	length of the path in KMs		(OUT)
+	 * param@ t_search search				-	search algorithm				(IN)
+	 * returnvalue@ bool					-	false if there is no path
+	 */
+	bool findPath(std::string_view from, std::string_view to, Name_Path_t &path, double &length, t_search search = ASTAR);
+
+	/**
+	 * Find the shortest path between two nodes.
+	 * The search state is reused between the queries: the method is not thread safe.
+	 * param@ Node_t source					-	start of the path				(IN)
+	 * param@ Node_t target					-	end of the path					(IN)
+	 * param@ Path_t &path					-	nodes of the path				(OUT)
+	 * param@ double &length				-	length of the path in KMs		(OUT)
+	 * param@ t_search search				-	search algorithm				(IN)
+	 * returnvalue@ bool					-	false if there is no path
+	 */
+	bool findPath(Node_t source, Node_t target, Path_t &path, double &length, t_search search = ASTAR);
+
+	/**
+	 * Number of nodes settled by the last search
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int getSettledCount() const;
+
+private:
+
+	/**
+	 * A road before the CSR arrays are built
+	 */
+	struct Edge
+	{
+		Node_t		from;
+		Node_t		to;
+		float		length;
+	};
+
+	/**
+	 * A node in the priority queue: its distance from the source and the estimated total length
+	 */
+	struct QueueEntry
+	{
+		double		estimate;
+		double		distance;
+		Node_t		node;
+
+		bool operator<(QueueEntry const &rhs) const;
+	};
+
+	/**
+	 * Node of every name
+	 */
+	std::map<Wp_Database_key_t, Node_t>	m_nodes;
+
+	/**
+	 * Names of the nodes, pointing to the keys of m_nodes
+	 */
+	std::vector<Wp_Database_key_t const *>	m_names;
+
+	/**
+	 * Positions of the nodes on the unit sphere, 3 coordinates per node
+	 */
+	std::vector<double>					m_coords;
+
+	/**
+	 * Roads which are not in the CSR arrays yet
+	 */
+	std::vector<Edge>					m_edges;
+
+	/**
+	 * CSR arrays: first outgoing edge of every node (one more entry than nodes), targets and lengths of the edges
+	 */
+	std::vector<unsigned int>			m_offsets;
+	std::vector<Node_t>					m_targets;
+	std::vector<float>					m_lengths;
+
+	/**
+	 * True if the CSR arrays contain all the nodes and the roads
+	 */
+	bool								m_isBuilt;
+
+	/**
+	 * Factor to keep the chord distance below the length of every edge
+	 */
+	double								m_heuristicScale;
+
+	/**
+	 * Search state: distance from the source and predecessor of every node reached by the query m_reached[node]
+	 */
+	std::vector<double>					m_distances;
+	std::vector<Node_t>					m_parents;
+	std::vector<unsigned int>			m_reached;
+	unsigned int						m_query;
+	std::vector<QueueEntry>				m_queue;
+	unsigned int						m_settledCount;
+
+	/**
+	 * The names point into m_nodes: the graph is not copyable
+	 */
+	CRoadGraph(CRoadGraph const &origin);
+	CRoadGraph& operator=(CRoadGraph const &rhs);
+
+	/**
+	 * Move the CSR arrays back into the list of roads before the graph changes
+	 * returnvalue@ void
+	 */
+	void unbuild();
+
+	/**
+	 * Straight line distance between two nodes through the earth in KMs
+	 * param@ Node_t lhs		-	first node	(IN)
+	 * param@ Node_t rhs		-	second node	(IN)
+	 * returnvalue@ double
+	 */
+	double chordDistance(Node_t lhs, Node_t rhs) const;
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CROADGRAPH_H */
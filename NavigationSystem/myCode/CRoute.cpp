@@ -13,13 +13,36 @@
 //System Include Files
 #include <iostream>
 #include <limits>
+#include <algorithm>
 
 //Own Include Files
 #include "CRoute.h"
+#include "CDistanceKernel.h"
+#include "CRoadGraph.h"
+#include "CContractionHierarchy.h"
 
 //Namespace
 using namespace std;
 
+/**
+ * Collects the POIs of a route and their cached positions for the distance kernel
+ */
+struct CRoutePoiCollector
+{
+	vector<CPOI *>		*pPois;
+	vector<double>		*pLatitudes;
+	vector<double>		*pLongitudes;
+	vector<double>		*pCosLatitudes;
+
+	void operator()(CPOI &poi)
+	{
+		this->pPois->push_back(&poi);
+		this->pLatitudes->push_back(poi.getLatitudeRad());
+		this->pLongitudes->push_back(poi.getLongitudeRad());
+		this->pCosLatitudes->push_back(poi.getCosLatitude());
+	}
+};
+
 //Method Implementations
 /**
  * CRoute Constructor:
@@ -30,6 +53,8 @@ CRoute::CRoute()
 	this->m_Course.clear();
 	this->m_pPoiDatabase	= 0;
 	this->m_pWpDatabase		= 0;
+	this->m_isPoiIndexValid	= false;
+	this->m_poiIndexGeneration = 0;
 }
 
 
@@ -43,8 +68,12 @@ CRoute::CRoute(CRoute const &origin)
 	cout << "INFO: Performing deep copy.\n";
 
 	this->m_Course 		= origin.m_Course;
+	this->m_nameSlots	= origin.m_nameSlots;
+	this->m_lastPositions = origin.m_lastPositions;
 	this->m_pPoiDatabase= origin.m_pPoiDatabase;
 	this->m_pWpDatabase	= origin.m_pWpDatabase;
+	this->m_isPoiIndexValid	= false;
+	this->m_poiIndexGeneration = 0;
 }
 
 
@@ -55,6 +84,8 @@ CRoute::~CRoute()
 {
 	// clear all the elements
 	this->m_Course.clear();
+	this->m_nameSlots.clear();
+	this->m_lastPositions.clear();
 
 	// disconnect from the Database
 	this->m_pPoiDatabase 	= 0;
@@ -73,6 +104,7 @@ void CRoute::connectToPoiDatabase(CPoiDatabase *pPoiDB)
 	if (pPoiDB)
 	{
 		this->m_pPoiDatabase 	= pPoiDB;
+		this->m_isPoiIndexValid	= false;
 		cout << "INFO: POI Database connected to the route.\n";
 	}
 	else
@@ -104,26 +136,26 @@ void CRoute::connectToWpDatabase(CWpDatabase *pWpDB)
 
 /**
  * Search the waypoint in the waypoint-database by the name; Add the waypoint to current route
- * @param Database_key_t key		- name of a waypoint		(IN)
+ * @param string_view name			- name of a waypoint		(IN)
  * @returnval void
  */
-void CRoute::addWaypoint(Database_key_t key)
+void CRoute::addWaypoint(string_view name)
 {
 	CWaypoint *pWp;
 
 	// check if the database is connected
 	if (this->m_pWpDatabase)
 	{
-		pWp = this->m_pWpDatabase->getPointerToWaypoint(key);
+		pWp = this->m_pWpDatabase->getPointerToWaypoint(name);
 
 		if (pWp)
 		{
-			// save the pointer to the waypoint in the current route
-			this->m_Course.push_back(static_cast<CWaypoint *>(pWp));
+			// save the handle of the waypoint in the current route
+			this->insertHop(this->m_Course.size(), pWp, CWaypoint::WAYPOINT, this->m_pWpDatabase->getGeneration());
 		}
 		else
 		{
-			cout << "WARNING: The Requested Waypoint -\"" << key << "\" is not available in the Database.\n";
+			cout << "WARNING: The Requested Waypoint -\"" << name << "\" is not available in the Database.\n";
 		}
 	}
 	else
@@ -133,6 +165,77 @@ void CRoute::addWaypoint(Database_key_t key)
 }
 
 
+/**
+ * Find the shortest path between two waypoints on the road graph and add its waypoints to the current route.
+ * The start is not added again if the route already ends there.
+ * @param CRoadGraph &graph			- roads between the waypoints of the waypoint-database	(IN)
+ * @param string_view from			- name of the start waypoint		(IN)
+ * @param string_view to				- name of the destination waypoint	(IN)
+ * @returnval bool					- false if there is no path
+ */
+bool CRoute::addShortestPath(CRoadGraph &graph, string_view from, string_view to)
+{
+	CRoadGraph::Name_Path_t	path;
+	double					length;
+
+	if (!graph.findPath(from, to, path, length))
+	{
+		cout << "WARNING: There is no path from \"" << from << "\" to \"" << to << "\" in the road graph.\n";
+		return false;
+	}
+
+	this->addPath(path);
+
+	return true;
+}
+
+
+/**
+ * Find the shortest path between two waypoints in the contraction hierarchy and add its waypoints to the current route.
+ * The start is not added again if the route already ends there.
+ * @param CContractionHierarchy &hierarchy	- hierarchy of the roads between the waypoints	(IN)
+ * @param string_view from					- name of the start waypoint		(IN)
+ * @param string_view to					- name of the destination waypoint	(IN)
+ * @returnval bool							- false if there is no path
+ */
+bool CRoute::addShortestPath(CContractionHierarchy &hierarchy, string_view from, string_view to)
+{
+	CContractionHierarchy::Name_Path_t	path;
+	double								length;
+
+	if (!hierarchy.findPath(from, to, path, length))
+	{
+		cout << "WARNING: There is no path from \"" << from << "\" to \"" << to << "\" in the contraction hierarchy.\n";
+		return false;
+	}
+
+	this->addPath(path);
+
+	return true;
+}
+
+
+/**
+ * Add the waypoints of a path to the route; the start is skipped if the route already ends there
+ * @param std::vector<Database_key_t> const &path	- names of the waypoints	(IN)
+ * @returnval void
+ */
+void CRoute::addPath(vector<Database_key_t> const &path)
+{
+	unsigned int start = 0;
+
+	if (!path.empty() && !this->m_Course.empty() && (this->m_Course.back().name == path[0]))
+	{
+		start = 1;
+	}
+
+	for (unsigned int index = start; index < path.size(); index++)
+	{
+		this->addWaypoint(path[index]);
+	}
+}
+
+
 /**
  * Search the POI in the POI-database by the name; Add the POI to current route after "afterWp"
  * if ->
@@ -141,15 +244,14 @@ void CRoute::addWaypoint(Database_key_t key)
  * 		namePoi is not empty 	and afterWp is empty		-> Add POI to Route at the end
  * 		namePoi is not empty 	and afterWp is not empty	-> Add POI afterWp where afterWP is already added
  *
- * @param Database_key_t namePoi	- name of a POI		(IN)
- * @param string afterWp			- name of a waypoint(IN)
+ * @param string_view namePoi		- name of a POI		(IN)
+ * @param string_view afterWp		- name of a waypoint(IN)
  * @returnval void
  */
-void CRoute::addPoi(Database_key_t namePoi, string afterWp)
+void CRoute::addPoi(string_view namePoi, string_view afterWp)
 {
-	bool		isAfterWp 	= false;
-	CPOI		*pPoi 		= 0;
-	CWaypoint 	*pWp 		= 0;
+	CPOI			*pPoi 		= 0;
+	Database_key_t	afterWpKey;
 
 	// check if the database is connected
 	if (this->m_pPoiDatabase)
@@ -158,26 +260,21 @@ void CRoute::addPoi(Database_key_t namePoi, string afterWp)
 
 		if (pPoi)
 		{
-			for (Route_Collection_RevItr revItr = this->m_Course.rbegin(); revItr != this->m_Course.rend(); ++revItr)
-			{
-				pWp = dynamic_cast<CWaypoint *>(*revItr);
+			// the last hop with the name of the waypoint; a name which is not in the string pool is in no hop
+			Route_Position_Index_t::const_iterator slotItr = this->m_nameSlots.end();
 
-				// is this a Waypoint ?
-				if (pWp)
-				{
-					// are the names matching ?
-					if (!afterWp.compare(pWp->getName()))
-					{
-						this->m_Course.insert(revItr.base(), pPoi);
-						isAfterWp = true;
-						break;
-					}
-				}
+			if (Database_key_t::find(afterWp, afterWpKey))
+			{
+				slotItr = this->m_nameSlots.find(afterWpKey);
 			}
 
-			if (!isAfterWp)
+			if (slotItr != this->m_nameSlots.end())
+			{
+				this->insertHop(this->m_lastPositions[slotItr->second] + 1, pPoi, CWaypoint::POI, this->m_pPoiDatabase->getGeneration());
+			}
+			else
 			{
-				this->m_Course.push_back(static_cast<CPOI *>(pPoi));
+				this->insertHop(this->m_Course.size(), pPoi, CWaypoint::POI, this->m_pPoiDatabase->getGeneration());
 
 				cout << "WARNING: The Requested Waypoint - \"" << afterWp << "\" is not available in the Route.\n";
 			}
@@ -194,6 +291,66 @@ void CRoute::addPoi(Database_key_t namePoi, string afterWp)
 }
 
 
+/**
+ * Insert a hop into the route and update the positions of the names behind it
+ * @param unsigned int position			- position of the new hop			(IN)
+ * @param CWaypoint *pPoint				- the waypoint or POI				(IN)
+ * @param CWaypoint::wp_type type		- WAYPOINT or POI					(IN)
+ * @param unsigned long generation		- generation of the database		(IN)
+ * @returnval void
+ */
+void CRoute::insertHop(unsigned int position, CWaypoint *pPoint, CWaypoint::wp_type type, unsigned long generation)
+{
+	CRouteHop hop = { pPoint, generation, pPoint->getPooledName(), (unsigned char)type };
+
+	if (position < this->m_Course.size())
+	{
+		// the hops behind move by one
+		for (unsigned int slot = 0; slot < this->m_lastPositions.size(); ++slot)
+		{
+			this->m_lastPositions[slot] += (this->m_lastPositions[slot] >= position);
+		}
+	}
+
+	this->m_Course.insert(this->m_Course.begin() + position, hop);
+	this->m_isPoiIndexValid = false;
+
+	pair<Route_Position_Index_t::iterator, bool> slot = this->m_nameSlots.insert(make_pair(hop.name, (unsigned int)this->m_lastPositions.size()));
+
+	if (slot.second)
+	{
+		this->m_lastPositions.push_back(position);
+	}
+	else
+	{
+		this->m_lastPositions[slot.first->second] = max(this->m_lastPositions[slot.first->second], position);
+	}
+}
+
+
+/**
+ * Get the address of the element of a hop; it is looked up again by the name
+ * if the database was changed since the address was taken
+ * @param CRouteHop &hop			- a hop of the route	(IN/OUT)
+ * @returnval CWaypoint*			- null if the element is no longer in the database
+ */
+CWaypoint* CRoute::resolveHop(CRouteHop &hop)
+{
+	if ((hop.type == CWaypoint::POI) && this->m_pPoiDatabase && (hop.generation != this->m_pPoiDatabase->getGeneration()))
+	{
+		hop.pPoint 		= this->m_pPoiDatabase->getPointerToPoi(hop.name);
+		hop.generation 	= this->m_pPoiDatabase->getGeneration();
+	}
+	else if ((hop.type == CWaypoint::WAYPOINT) && this->m_pWpDatabase && (hop.generation != this->m_pWpDatabase->getGeneration()))
+	{
+		hop.pPoint 		= this->m_pWpDatabase->getPointerToWaypoint(hop.name);
+		hop.generation 	= this->m_pWpDatabase->getGeneration();
+	}
+
+	return hop.pPoint;
+}
+
+
 /**
  * Get the current route information
  * @returnval vector - 	Current route having Waypoints and POI
@@ -202,9 +359,17 @@ const vector<const CWaypoint*> CRoute::getRoute()
 {
 	vector<const CWaypoint*> currentRoute;
 
-	for (Route_Collection_FwdItr itr = this->m_Course.begin(); itr != this->m_Course.end(); ++itr)
+	currentRoute.reserve(this->m_Course.size());
+
+	for (unsigned int index = 0; index < this->m_Course.size(); ++index)
 	{
-		currentRoute.push_back(*itr);
+		CWaypoint *pPoint = this->resolveHop(this->m_Course[index]);
+
+		// elements removed from the database are left out
+		if (pPoint)
+		{
+			currentRoute.push_back(pPoint);
+		}
 	}
 
 	return currentRoute;
@@ -212,84 +377,209 @@ const vector<const CWaypoint*> CRoute::getRoute()
 
 
 /**
- * Calculates the distance between waypoint and POI
- * @param CWaypoint const &wp	- waypoint			(IN)
- * @param CPOI& poi				- POI				(IN)
- * @return double				- Distance in Kms
+ * Calculates the distance between waypoint and the closest POI of the route.
+ * The POIs of the route are looked up in a spatial index of the route.
+ * @param CWaypoint const &wp					- waypoint			(IN)
+ * @param CPOI& poi								- POI				(IN)
+ * @param CWaypoint::t_distance_model model	- distance model	(IN)
+ * @return double								- Distance in Kms
  */
-double CRoute::getDistanceNextPoi(CWaypoint const &wp, CPOI& poi)
+double CRoute::getDistanceNextPoi(CWaypoint const &wp, CPOI& poi, CWaypoint::t_distance_model model)
 {
-	CPOI	*pPoi = 0;
-	double	shortestDistance = numeric_limits<double>::max(), currentDistance = 0;
+	CSpatialIndex<CPOI> const 	&index 				= this->getPoiIndex();
+	CPOI						*pNearest 			= index.nearest(wp.getLatitude(), wp.getLongitude());
+	double						shortestDistance 	= numeric_limits<double>::max();
 
-	if (!this->m_Course.empty())
+	if (pNearest)
 	{
-		for (Route_Collection_FwdItr fwdItr = this->m_Course.begin(); fwdItr != this->m_Course.end(); ++fwdItr)
+		shortestDistance = pNearest->CWaypoint::calculateDistance(wp, model);
+
+		if (model == CWaypoint::VINCENTY)
 		{
-			pPoi = dynamic_cast<CPOI *>(*fwdItr);
+			CSpatialIndex<CPOI>::Neighbour_Container_t candidates;
+
+			// no POI further away on the sphere can be closer on the ellipsoid
+			double radius = pNearest->CWaypoint::calculateDistance(wp) * ELLIPSOID_RATIO_MAX / ELLIPSOID_RATIO_MIN;
 
-			if (pPoi)
+			index.withinRadius(wp.getLatitude(), wp.getLongitude(), radius, candidates);
+
+			for (unsigned int i = 0; i < candidates.size(); i++)
 			{
-				currentDistance = pPoi->CWaypoint::calculateDistance(wp);
+				double distance = candidates[i].pElement->CWaypoint::calculateDistance(wp, model);
 
-				if (currentDistance <= shortestDistance)
+				if (distance < shortestDistance)
 				{
-					shortestDistance = currentDistance;
-					poi				 = *pPoi;
+					shortestDistance = distance;
+					pNearest		 = candidates[i].pElement;
 				}
 			}
 		}
+
+		poi = *pNearest;
+	}
+
+	return shortestDistance;
+}
+
+
+/**
+ * Calculates the distance between waypoint and the closest POI of the connected POI Database,
+ * on the route or not; it is looked up in the spatial index of the Database.
+ * @param CWaypoint const &wp					- waypoint			(IN)
+ * @param CPOI& poi								- POI				(IN)
+ * @param CWaypoint::t_distance_model model	- distance model	(IN)
+ * @return double								- Distance in Kms
+ */
+double CRoute::getDistanceNextDatabasePoi(CWaypoint const &wp, CPOI& poi, CWaypoint::t_distance_model model)
+{
+	CPOI	*pPoi = 0;
+	double	shortestDistance = numeric_limits<double>::max();
+
+	if (this->m_pPoiDatabase)
+	{
+		pPoi = this->m_pPoiDatabase->getNearestPoi(wp.getLatitude(), wp.getLongitude(), model, shortestDistance);
+
+		if (pPoi)
+		{
+			poi = *pPoi;
+		}
 	}
 
 	return shortestDistance;
 }
 
 
+/**
+ * Calculates the k closest POIs and their distances for each of the given positions.
+ * If a POI Database is connected, its batch query is used; otherwise the POIs of the route are searched.
+ * The result of position i is stored at [i * k, i * k + k), the closest POI first;
+ * missing POIs have a null pointer.
+ * @param CWaypoint const positions[]						- query positions				(IN)
+ * @param unsigned int count								- number of positions			(IN)
+ * @param unsigned int k									- number of POIs per position	(IN)
+ * @param CPoiDatabase::Poi_Neighbour_Container_t &results	- POIs and distances in Kms		(OUT)
+ * @returnval void
+ */
+void CRoute::getDistanceNextPois(CWaypoint const positions[], unsigned int count, unsigned int k, CPoiDatabase::Poi_Neighbour_Container_t &results)
+{
+	if (this->m_pPoiDatabase)
+	{
+		this->m_pPoiDatabase->getNearestPois(positions, count, k, results);
+	}
+	else
+	{
+		CSpatialIndex<CPOI>::Neighbour				missing = { 0, numeric_limits<double>::max() };
+		CPoiDatabase::Poi_Neighbour_Container_t		candidates;
+		vector<CPOI *>								pois;
+		vector<double>								latitudes, longitudes, cosLatitudes, distances;
+
+		results.assign(count * k, missing);
+
+		this->getPoiPositions(pois, latitudes, longitudes, cosLatitudes);
+		distances.resize(pois.size());
+
+		unsigned int found = min(k, (unsigned int)pois.size());
+
+		for (unsigned int query = 0; query < count; ++query)
+		{
+			CDistanceKernel::haversineRadians(positions[query].getLatitudeRad(), positions[query].getLongitudeRad(), positions[query].getCosLatitude(),
+												latitudes.data(), longitudes.data(), cosLatitudes.data(), pois.size(), distances.data());
+
+			candidates.clear();
+
+			for (unsigned int index = 0; index < pois.size(); ++index)
+			{
+				CSpatialIndex<CPOI>::Neighbour candidate = { pois[index], distances[index] };
+
+				candidates.push_back(candidate);
+			}
+
+			partial_sort(candidates.begin(), candidates.begin() + found, candidates.end(), CRoute::isCloser);
+			copy(candidates.begin(), candidates.begin() + found, results.begin() + query * k);
+		}
+	}
+}
+
+
+/**
+ * Collect the POIs of the route and their cached positions as separate arrays for the distance kernel
+ * @param std::vector<CPOI *> &pois			- POIs of the route					(OUT)
+ * @param std::vector<double> &latitudes	- latitudes of the POIs in radians	(OUT)
+ * @param std::vector<double> &longitudes	- longitudes of the POIs in radians	(OUT)
+ * @param std::vector<double> &cosLatitudes	- cosines of the latitudes			(OUT)
+ * @returnval void
+ */
+void CRoute::getPoiPositions(vector<CPOI *> &pois, vector<double> &latitudes, vector<double> &longitudes, vector<double> &cosLatitudes)
+{
+	CRoutePoiCollector collector = { &pois, &latitudes, &longitudes, &cosLatitudes };
+
+	this->visitPois(collector);
+}
+
+
+/**
+ * Get the spatial index of the POIs of the route; it is built again if the route
+ * or the POI Database was changed since it was built
+ * @returnval CSpatialIndex<CPOI> const&	- index of the POIs of the route
+ */
+CSpatialIndex<CPOI> const& CRoute::getPoiIndex()
+{
+	unsigned long generation = this->m_pPoiDatabase ? this->m_pPoiDatabase->getGeneration() : 0;
+
+	if (!this->m_isPoiIndexValid || (this->m_poiIndexGeneration != generation))
+	{
+		vector<CPOI *>	pois;
+		vector<double>	latitudes, longitudes, cosLatitudes;
+
+		this->getPoiPositions(pois, latitudes, longitudes, cosLatitudes);
+		this->m_poiIndex.build(pois);
+
+		this->m_isPoiIndexValid 	= true;
+		this->m_poiIndexGeneration 	= generation;
+	}
+
+	return this->m_poiIndex;
+}
+
+
+/**
+ * Compare two POIs by their distance
+ * @param CSpatialIndex<CPOI>::Neighbour const &lhs	- first POI		(IN)
+ * @param CSpatialIndex<CPOI>::Neighbour const &rhs	- second POI	(IN)
+ * @returnval bool	- true if the first POI is closer
+ */
+bool CRoute::isCloser(CSpatialIndex<CPOI>::Neighbour const &lhs, CSpatialIndex<CPOI>::Neighbour const &rhs)
+{
+	return (lhs.distance < rhs.distance);
+}
+
+
 /**
  * prints all the waypoints and POIs in the route
  */
 void CRoute::print()
 {
-	CPOI		*pPoi	= 0;
-	CWaypoint 	*pWp 	= 0;
+	CWaypoint 	*pPoint = 0;
 
 	cout << "=======================================================\n";
 	cout << "The Route Information:\n";
 	cout << "=======================================================\n";
 
-	for (Route_Collection_FwdItr fwdItr = this->m_Course.begin(); fwdItr != this->m_Course.end(); ++fwdItr)
+	for (unsigned int index = 0; index < this->m_Course.size(); ++index)
 	{
-		pPoi = dynamic_cast<CPOI *>(*fwdItr);
-
-#ifdef RUN_TEST_PRINT
-		// The iterator can point to
-		// 1. Address of a CWaypoint	-> CWaypoint::print() 	will be invoked.
-		// 2. Address of a CPOI			-> CPOI::print() 		will be invoked.
-		// The respective print function will be called due to polymorphic virtual function
-		(*this->m_ForwardItr)->print(2);
-
-		// Since the container used is of type CWaypoint, even the POI will be treated as
-		// a Waypoint data(since there is not explict dynamic casting) and the
-		// CWaypointer's operator<< will be invoked.
-		cout << (**this->m_ForwardItr) << endl;
-#endif
+		pPoint = this->resolveHop(this->m_Course[index]);
 
-		if (pPoi)
+		if (!pPoint)
+		{
+			cout << "WARNING: \"" << this->m_Course[index].name << "\" is no longer available in the Database.\n" << endl;
+		}
+		else if (this->m_Course[index].type == CWaypoint::POI)
 		{
-			cout << *pPoi << endl;
+			cout << *static_cast<CPOI *>(pPoint) << endl;
 		}
 		else
 		{
-			pWp = dynamic_cast<CWaypoint *>(*fwdItr);
-
-			if (pWp)
-			{
-				cout << *pWp << endl;
-			}
-			else
-			{
-				cout << "WARNING: Unknown type of Data in the Route.\n" << endl;
-			}
+			cout << *pPoint << endl;
 		}
 	}
 }
@@ -299,7 +589,7 @@ void CRoute::print()
  * The function is an extension of addPoi which searches the Databases and add the
  * Waypoint and/or the POI which matches the name.
  */
-void CRoute::operator += (Database_key_t const &name)
+void CRoute::operator += (string_view name)
 {
 	CPOI		*pPoi = 0;
 	CWaypoint	*pWp  = 0;
@@ -337,12 +627,17 @@ void CRoute::operator += (Database_key_t const &name)
 CRoute& CRoute::operator=(CRoute const & rhs)
 {
 	this->m_Course.clear();
+	this->m_nameSlots.clear();
+	this->m_lastPositions.clear();
 	this->m_pPoiDatabase= 0;
 	this->m_pWpDatabase	= 0;
 
 	this->m_Course 		= rhs.m_Course;
+	this->m_nameSlots	= rhs.m_nameSlots;
+	this->m_lastPositions = rhs.m_lastPositions;
 	this->m_pPoiDatabase= rhs.m_pPoiDatabase;
 	this->m_pWpDatabase	= rhs.m_pWpDatabase;
+	this->m_isPoiIndexValid	= false;
 
 	return *this;
 }
@@ -361,12 +656,29 @@ CRoute CRoute::operator+(CRoute const & rhs)
 	if ((this->m_pPoiDatabase == rhs.m_pPoiDatabase) &&
 		(this->m_pWpDatabase == rhs.m_pWpDatabase))
 	{
-		Route_Collection_t 		rhs1 = this->m_Course;
-		Route_Collection_t 		rhs2 = rhs.m_Course;
-		Route_Collection_FwdItr fwdItr = result.m_Course.begin();
+		result.m_Course.reserve(this->m_Course.size() + rhs.m_Course.size());
+		result.m_Course.insert(result.m_Course.end(), this->m_Course.begin(), this->m_Course.end());
+		result.m_Course.insert(result.m_Course.end(), rhs.m_Course.begin(), rhs.m_Course.end());
+
+		// the last hops of the names are in the right hand side, else in the left hand side
+		result.m_nameSlots 		= this->m_nameSlots;
+		result.m_lastPositions 	= this->m_lastPositions;
+
+		for (Route_Position_Index_t::const_iterator itr = rhs.m_nameSlots.begin(); itr != rhs.m_nameSlots.end(); ++itr)
+		{
+			pair<Route_Position_Index_t::iterator, bool> slot = result.m_nameSlots.insert(make_pair(itr->first, (unsigned int)result.m_lastPositions.size()));
+			unsigned int lastPosition = this->m_Course.size() + rhs.m_lastPositions[itr->second];
+
+			if (slot.second)
+			{
+				result.m_lastPositions.push_back(lastPosition);
+			}
+			else
+			{
+				result.m_lastPositions[slot.first->second] = lastPosition;
+			}
+		}
 
-		result.m_Course.splice(fwdItr, rhs1);
-		result.m_Course.splice(fwdItr, rhs2);
 		result.m_pPoiDatabase	= rhs.m_pPoiDatabase;
 		result.m_pWpDatabase	= rhs.m_pWpDatabase;
 	}
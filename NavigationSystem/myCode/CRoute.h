@@ -14,27 +14,54 @@
 
 //System Include Files
 #include <string>
-#include <list>
+#include <string_view>
 #include <vector>
+#include <unordered_map>
 
 //Own Include Files
 #include "CPoiDatabase.h"
 #include "CWpDatabase.h"
 
+class CRoadGraph;
+class CContractionHierarchy;
+
 typedef POI_Database_key_t							Database_key_t;
 //typedef Wp_Database_key_t							Database_key_t;
 
-typedef std::list<CWaypoint *> 						Route_Collection_t;
-typedef std::list<CWaypoint *>::iterator			Route_Collection_FwdItr;
-typedef std::list<CWaypoint *>::reverse_iterator	Route_Collection_RevItr;
+/**
+ * A hop of a route: a handle to a waypoint or a POI of the connected databases.
+ * The name (an index into the string pool) identifies the element, the address is a
+ * cache which is valid as long as the database has the generation of the hop.
+ */
+struct CRouteHop
+{
+	CWaypoint							*pPoint;
+	unsigned long						generation;
+	Database_key_t						name;
+	unsigned char						type;
+};
+
+typedef std::vector<CRouteHop>							Route_Collection_t;
+typedef std::unordered_map<Database_key_t, unsigned int>	Route_Position_Index_t;
 
 class CRoute {
 private:
 
 	/**
-	 * An list container to store the waypoints and POI of the route
+	 * The hops of the route (waypoints and POIs) one after the other in memory
+	 */
+	Route_Collection_t							m_Course;
+
+	/**
+	 * Slot of every name of the route in m_lastPositions
+	 */
+	Route_Position_Index_t						m_nameSlots;
+
+	/**
+	 * Position of the last hop of every name in the route; one array, an insertion
+	 * in the middle of the route moves the positions behind it in one pass
 	 */
-	std::list<CWaypoint *>						m_Course;
+	std::vector<unsigned int>					m_lastPositions;
 
 	/**
 	 * A pointer to the Point of interest Database
@@ -46,6 +73,68 @@ private:
 	 */
 	CWpDatabase									*m_pWpDatabase;
 
+	/**
+	 * Spatial index of the POIs of the route; it is built on the first query after
+	 * the route or the POI Database was changed
+	 */
+	CSpatialIndex<CPOI>							m_poiIndex;
+
+	/**
+	 * Is the index built for the current hops, and the generation of the POI Database it was built for
+	 */
+	bool										m_isPoiIndexValid;
+	unsigned long								m_poiIndexGeneration;
+
+	/**
+	 * Get the address of the element of a hop; it is looked up again by the name
+	 * if the database was changed since the address was taken
+	 * @param CRouteHop &hop			- a hop of the route	(IN/OUT)
+	 * @returnval CWaypoint*			- null if the element is no longer in the database
+	 */
+	CWaypoint* resolveHop(CRouteHop &hop);
+
+	/**
+	 * Insert a hop into the route and update the positions of the names behind it
+	 * @param unsigned int position			- position of the new hop			(IN)
+	 * @param CWaypoint *pPoint				- the waypoint or POI				(IN)
+	 * @param CWaypoint::wp_type type		- WAYPOINT or POI					(IN)
+	 * @param unsigned long generation		- generation of the database		(IN)
+	 * @returnval void
+	 */
+	void insertHop(unsigned int position, CWaypoint *pPoint, CWaypoint::wp_type type, unsigned long generation);
+
+	/**
+	 * Collect the POIs of the route and their cached positions as separate arrays for the distance kernel
+	 * @param std::vector<CPOI *> &pois			- POIs of the route					(OUT)
+	 * @param std::vector<double> &latitudes	- latitudes of the POIs in radians	(OUT)
+	 * @param std::vector<double> &longitudes	- longitudes of the POIs in radians	(OUT)
+	 * @param std::vector<double> &cosLatitudes	- cosines of the latitudes			(OUT)
+	 * @returnval void
+	 */
+	void getPoiPositions(std::vector<CPOI *> &pois, std::vector<double> &latitudes, std::vector<double> &longitudes, std::vector<double> &cosLatitudes);
+
+	/**
+	 * Get the spatial index of the POIs of the route; it is built again if the route
+	 * or the POI Database was changed since it was built
+	 * @returnval CSpatialIndex<CPOI> const&	- index of the POIs of the route
+	 */
+	CSpatialIndex<CPOI> const& getPoiIndex();
+
+	/**
+	 * Compare two POIs by their distance
+	 * @param CSpatialIndex<CPOI>::Neighbour const &lhs	- first POI		(IN)
+	 * @param CSpatialIndex<CPOI>::Neighbour const &rhs	- second POI	(IN)
+	 * @returnval bool	- true if the first POI is closer
+	 */
+	static bool isCloser(CSpatialIndex<CPOI>::Neighbour const &lhs, CSpatialIndex<CPOI>::Neighbour const &rhs);
+
+	/**
+	 * Add the waypoints of a path to the route; the start is skipped if the route already ends there
+	 * @param std::vector<Database_key_t> const &path	- names of the waypoints	(IN)
+	 * @returnval void
+	 */
+	void addPath(std::vector<Database_key_t> const &path);
+
 public:
 
 	/**
@@ -83,18 +172,38 @@ public:
 
     /**
 	 * Search the waypoint in the waypoint-database by the name; Add the waypoint to current route
-	 * @param Database_key_t key		- name of a waypoint		(IN)
+	 * @param string_view name			- name of a waypoint		(IN)
 	 * @returnval void
 	 */
-    void addWaypoint(Database_key_t key);
+    void addWaypoint(std::string_view name);
+
+    /**
+	 * Find the shortest path between two waypoints on the road graph and add its waypoints to the current route.
+	 * The start is not added again if the route already ends there.
+	 * @param CRoadGraph &graph			- roads between the waypoints of the waypoint-database	(IN)
+	 * @param string_view from			- name of the start waypoint		(IN)
+	 * @param string_view to				- name of the destination waypoint	(IN)
+	 * @returnval bool					- false if there is no path
+	 */
+    bool addShortestPath(CRoadGraph &graph, std::string_view from, std::string_view to);
+
+    /**
+	 * Find the shortest path between two waypoints in the contraction hierarchy and add its waypoints to the current route.
+	 * The start is not added again if the route already ends there.
+	 * @param CContractionHierarchy &hierarchy	- hierarchy of the roads between the waypoints	(IN)
+	 * @param string_view from					- name of the start waypoint		(IN)
+	 * @param string_view to					- name of the destination waypoint	(IN)
+	 * @returnval bool							- false if there is no path
+	 */
+    bool addShortestPath(CContractionHierarchy &hierarchy, std::string_view from, std::string_view to);
 
     /**
      * Search the POI in the POI-database by the name; Add the POI to current route after "afterWp"
-     * @param Database_key_t namePoi			- name of a POI		(IN)
-     * @param string afterWp			- name of a waypoint(IN)
+     * @param string_view namePoi		- name of a POI		(IN)
+     * @param string_view afterWp		- name of a waypoint(IN)
      * @returnval void
      */
-    void addPoi(Database_key_t namePoi, std::string afterWp);
+    void addPoi(std::string_view namePoi, std::string_view afterWp);
 
     /**
      * Get the current route information
@@ -103,12 +212,55 @@ public:
     const std::vector<const CWaypoint*> getRoute();
 
     /**
-	 * Calculates the distance between waypoint and POI
-	 * @param CWaypoint const &wp	- waypoint			(IN)
-	 * @param CPOI& poi				- POI				(IN)
-	 * @return double				- Distance in Kms
+     * Visit the POIs of the route in their order; the waypoints are skipped by the type of the hop.
+     * The visitor is called as visitor(CPOI &poi).
+     * @param TVisitor &visitor			- called for every POI		(IN)
+     * @returnval void
+     */
+    template<class TVisitor>
+    void visitPois(TVisitor &visitor);
+
+    /**
+     * Visit the waypoints of the route in their order; the POIs are skipped by the type of the hop.
+     * The visitor is called as visitor(CWaypoint &wp).
+     * @param TVisitor &visitor			- called for every waypoint	(IN)
+     * @returnval void
+     */
+    template<class TVisitor>
+    void visitWaypoints(TVisitor &visitor);
+
+    /**
+	 * Calculates the distance between waypoint and the closest POI of the route.
+	 * The POIs of the route are looked up in a spatial index of the route.
+	 * @param CWaypoint const &wp					- waypoint			(IN)
+	 * @param CPOI& poi								- POI				(IN)
+	 * @param CWaypoint::t_distance_model model	- distance model	(IN)
+	 * @return double								- Distance in Kms
+	 */
+	double getDistanceNextPoi(CWaypoint const &wp, CPOI& poi, CWaypoint::t_distance_model model = CWaypoint::HAVERSINE);
+
+	/**
+	 * Calculates the distance between waypoint and the closest POI of the connected POI Database,
+	 * on the route or not; it is looked up in the spatial index of the Database.
+	 * @param CWaypoint const &wp					- waypoint			(IN)
+	 * @param CPOI& poi								- POI				(IN)
+	 * @param CWaypoint::t_distance_model model	- distance model	(IN)
+	 * @return double								- Distance in Kms
 	 */
-	double getDistanceNextPoi(CWaypoint const &wp, CPOI& poi);
+	double getDistanceNextDatabasePoi(CWaypoint const &wp, CPOI& poi, CWaypoint::t_distance_model model = CWaypoint::HAVERSINE);
+
+	/**
+	 * Calculates the k closest POIs and their distances for each of the given positions.
+	 * If a POI Database is connected, its batch query is used; otherwise the POIs of the route are searched.
+	 * The result of position i is stored at [i * k, i * k + k), the closest POI first;
+	 * missing POIs have a null pointer.
+	 * @param CWaypoint const positions[]						- query positions				(IN)
+	 * @param unsigned int count								- number of positions			(IN)
+	 * @param unsigned int k									- number of POIs per position	(IN)
+	 * @param CPoiDatabase::Poi_Neighbour_Container_t &results	- POIs and distances in Kms		(OUT)
+	 * @returnval void
+	 */
+	void getDistanceNextPois(CWaypoint const positions[], unsigned int count, unsigned int k, CPoiDatabase::Poi_Neighbour_Container_t &results);
 
     /**
 	 * prints all the waypoints and POIs in the route
@@ -119,7 +271,7 @@ public:
 	 * The function is an extension of addPoi which searches the Databases and add the
 	 * Waypoint or the POI which matches the name.
 	 */
-	void operator += (Database_key_t const &name);
+	void operator += (std::string_view name);
 
     /**
      * A copy assignment operator
@@ -139,4 +291,52 @@ public:
 /********************
 **  CLASS END
 *********************/
+
+
+/**
+ * Visit the POIs of the route in their order; the waypoints are skipped by the type of the hop.
+ * The visitor is called as visitor(CPOI &poi).
+ * @param TVisitor &visitor			- called for every POI		(IN)
+ * @returnval void
+ */
+template<class TVisitor>
+void CRoute::visitPois(TVisitor &visitor)
+{
+	for (unsigned int index = 0; index < this->m_Course.size(); ++index)
+	{
+		if (this->m_Course[index].type == CWaypoint::POI)
+		{
+			CWaypoint *pPoint = this->resolveHop(this->m_Course[index]);
+
+			if (pPoint)
+			{
+				visitor(*static_cast<CPOI *>(pPoint));
+			}
+		}
+	}
+}
+
+
+/**
+ * Visit the waypoints of the route in their order; the POIs are skipped by the type of the hop.
+ * The visitor is called as visitor(CWaypoint &wp).
+ * @param TVisitor &visitor			- called for every waypoint	(IN)
+ * @returnval void
+ */
+template<class TVisitor>
+void CRoute::visitWaypoints(TVisitor &visitor)
+{
+	for (unsigned int index = 0; index < this->m_Course.size(); ++index)
+	{
+		if (this->m_Course[index].type == CWaypoint::WAYPOINT)
+		{
+			CWaypoint *pPoint = this->resolveHop(this->m_Course[index]);
+
+			if (pPoint)
+			{
+				visitor(*pPoint);
+			}
+		}
+	}
+}
 #endif /* CROUTE_H */
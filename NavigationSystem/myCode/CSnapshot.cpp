@@ -0,0 +1,1126 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CSnapshot.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CSnapshot.
+*
+****************************************************************************/
+
+//System Include Files
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+//Own Include Files
+#include "CSnapshot.h"
+#include "CMappedFile.h"
+#include "CBufferedWriter.h"
+#include "CSpatialIndex.h"
+
+//Namespaces
+using namespace std;
+
+//Macros
+// the first 8 bytes of the file, '\0' included
+#define SNAPSHOT_MAGIC					"NAVSNAP"
+
+// read back as another number if the file was written on a machine of the other byte order
+#define SNAPSHOT_BYTE_ORDER				0x01020304u
+
+// words summed up before the sums are reduced; the sums stay below 2^64
+#define CHECKSUM_BLOCK_WORDS			1024
+
+// bytes of the file collected before they are added to the checksum and written
+#define SNAPSHOT_CHUNK_SIZE				(64 * 1024)
+
+// descriptions remembered while the heap is written, a power of 2
+#define SNAPSHOT_STRING_CACHE_SIZE		4096
+
+const uint32_t CSnapshot::FORMAT_VERSION 		= 3;
+const unsigned int CSnapshot::POI_TREE_COUNT;
+const uint64_t CSnapshot::SECTION_ALIGNMENT 	= 64;
+const uint32_t CSnapshot::NOT_FOUND 			= 0xFFFFFFFFu;
+
+/**
+ * Fletcher-64 over 32 bit words, summed up piece by piece while the file is written;
+ * a word may be split between two pieces
+ */
+struct CSnapshotChecksum
+{
+	uint64_t	sumA;
+	uint64_t	sumB;
+	size_t		blockWords;
+	char		pending[sizeof(uint32_t)];
+	size_t		pendingSize;
+
+	CSnapshotChecksum()
+	{
+		sumA 		= 0;
+		sumB 		= 0;
+		blockWords 	= 0;
+		pendingSize = 0;
+	}
+
+	void add(char const *pData, size_t size)
+	{
+		// complete the word the previous piece started
+		while (pendingSize && size)
+		{
+			pending[pendingSize++] = *pData++;
+			size--;
+
+			if (pendingSize == sizeof(uint32_t))
+			{
+				addWords(pending, 1);
+				pendingSize = 0;
+			}
+		}
+
+		addWords(pData, size / sizeof(uint32_t));
+
+		pendingSize = size % sizeof(uint32_t);
+		memcpy(pending, pData + size - pendingSize, pendingSize);
+	}
+
+	void addWords(char const *pData, size_t wordCount)
+	{
+		while (wordCount)
+		{
+			size_t count = min(wordCount, (size_t)CHECKSUM_BLOCK_WORDS - blockWords);
+
+			for (size_t index = 0; index < count; ++index)
+			{
+				uint32_t word;
+
+				memcpy(&word, pData + index * sizeof(uint32_t), sizeof(word));
+				sumA += word;
+				sumB += sumA;
+			}
+
+			pData 		+= count * sizeof(uint32_t);
+			wordCount 	-= count;
+			blockWords 	+= count;
+
+			if (blockWords == CHECKSUM_BLOCK_WORDS)
+			{
+				sumA 		%= 0xFFFFFFFFu;
+				sumB 		%= 0xFFFFFFFFu;
+				blockWords 	= 0;
+			}
+		}
+	}
+
+	// the bytes of an incomplete last word are not part of the checksum
+	uint64_t get() const
+	{
+		return ((sumB % 0xFFFFFFFFu) << 32) | (sumA % 0xFFFFFFFFu);
+	}
+};
+
+/**
+ * The file while it is written: the bytes are collected in chunks, each one is added to
+ * the checksum and handed to the writer
+ */
+struct CSnapshotStream
+{
+	CBufferedWriter 	*pWriter;
+	CSnapshotChecksum 	checksum;
+	vector<char> 		chunk;
+	size_t 				used;
+	uint64_t 			position;
+
+	explicit CSnapshotStream(CBufferedWriter *pFile)
+	{
+		pWriter 	= pFile;
+		used 		= 0;
+		position 	= 0;
+		chunk.resize(SNAPSHOT_CHUNK_SIZE);
+	}
+
+	void write(void const *pData, size_t size)
+	{
+		if (used + size > chunk.size())
+		{
+			flush();
+		}
+
+		if (size > chunk.size())
+		{
+			checksum.add(static_cast<char const *>(pData), size);
+			pWriter->write(static_cast<char const *>(pData), size);
+		}
+		else
+		{
+			memcpy(&chunk[used], pData, size);
+			used += size;
+		}
+
+		position += size;
+	}
+
+	// zeros up to the given position, e.g. the start of the next section
+	void padTo(uint64_t offset)
+	{
+		static char const zeros[64] = { 0 };
+
+		while (position < offset)
+		{
+			write(zeros, min(offset - position, (uint64_t)sizeof(zeros)));
+		}
+	}
+
+	void flush()
+	{
+		checksum.add(&chunk[0], used);
+		pWriter->write(&chunk[0], used);
+		used = 0;
+	}
+};
+
+/**
+ * Places the descriptions of the POIs in the heap behind the names. A string which is in a
+ * small cache of the strings placed last is placed once, so a description used by many POIs
+ * is usually stored once; the memory does not grow with the database. Every pass over the
+ * POIs places the strings at the same offsets.
+ */
+struct CSnapshotDescriptionPlacer
+{
+	CStringPool::String_Id_t 	ids[SNAPSHOT_STRING_CACHE_SIZE];
+	uint32_t 					offsets[SNAPSHOT_STRING_CACHE_SIZE];
+	uint64_t 					end;
+
+	explicit CSnapshotDescriptionPlacer(uint64_t first)
+	{
+		fill(ids, ids + SNAPSHOT_STRING_CACHE_SIZE, CStringPool::NOT_FOUND);
+		end = first;
+	}
+
+	// isNew tells if the characters are stored at the offset of the string by this call
+	CSnapshot::String place(CPooledString const &text, bool &isNew)
+	{
+		CSnapshot::String 	string 	= { 0, (uint32_t)text.size() };
+		size_t 				slot 	= text.getId() & (SNAPSHOT_STRING_CACHE_SIZE - 1);
+
+		// the empty string is the first one of the heap
+		isNew = !text.empty() && (ids[slot] != text.getId());
+
+		if (isNew)
+		{
+			ids[slot] 		= text.getId();
+			offsets[slot] 	= (uint32_t)end;
+			end 			+= text.size() + 1;
+		}
+
+		if (!text.empty())
+		{
+			string.offset = offsets[slot];
+		}
+
+		return string;
+	}
+};
+
+/**
+ * Counts the bytes of the names and the descriptions in the heap
+ */
+struct CSnapshotHeapCounter
+{
+	uint64_t 					end;
+	CSnapshotDescriptionPlacer 	*pDescriptions;
+
+	void operator()(CPooledString const &, CWaypoint const &wp)
+	{
+		end += wp.getPooledName().size() + 1;
+	}
+
+	void operator()(CPooledString const &, CPOI const &poi)
+	{
+		bool isNew;
+
+		end += poi.getPooledName().size() + 1;
+		pDescriptions->place(poi.getPooledDescription(), isNew);
+	}
+};
+
+/**
+ * Writes the latitude or the longitude of every visited element
+ */
+struct CSnapshotCoordinateWriter
+{
+	CSnapshotStream 	*pStream;
+	bool 				isLatitude;
+
+	void operator()(CPooledString const &, CWaypoint const &wp)
+	{
+		double coordinate = isLatitude ? wp.getLatitude() : wp.getLongitude();
+
+		pStream->write(&coordinate, sizeof(coordinate));
+	}
+};
+
+/**
+ * Writes the name of every visited element: the names follow each other in the heap
+ */
+struct CSnapshotNameWriter
+{
+	CSnapshotStream 	*pStream;
+	uint32_t 			offset;
+
+	void operator()(CPooledString const &, CWaypoint const &wp)
+	{
+		CSnapshot::String name = { offset, (uint32_t)wp.getPooledName().size() };
+
+		pStream->write(&name, sizeof(name));
+		offset += name.length + 1;
+	}
+};
+
+/**
+ * Writes the description and the type of every visited POI
+ */
+struct CSnapshotPoiWriter
+{
+	CSnapshotStream 			*pStream;
+	CSnapshotDescriptionPlacer 	*pDescriptions;
+	bool 						isDescription;
+
+	void operator()(CPooledString const &, CPOI const &poi)
+	{
+		if (isDescription)
+		{
+			bool 				isNew;
+			CSnapshot::String 	description = pDescriptions->place(poi.getPooledDescription(), isNew);
+
+			pStream->write(&description, sizeof(description));
+		}
+		else
+		{
+			uint8_t type = (uint8_t)poi.getPoiType();
+
+			pStream->write(&type, sizeof(type));
+		}
+	}
+};
+
+/**
+ * Writes the characters of the names or the descriptions of the visited elements into the heap
+ */
+struct CSnapshotHeapWriter
+{
+	CSnapshotStream 			*pStream;
+	CSnapshotDescriptionPlacer 	*pDescriptions;		// 0 for the names
+
+	void operator()(CPooledString const &, CWaypoint const &wp)
+	{
+		writeString(wp.getPooledName());
+	}
+
+	void operator()(CPooledString const &, CPOI const &poi)
+	{
+		bool isNew = true;
+
+		if (pDescriptions)
+		{
+			pDescriptions->place(poi.getPooledDescription(), isNew);
+		}
+
+		if (isNew)
+		{
+			writeString(pDescriptions ? poi.getPooledDescription() : poi.getPooledName());
+		}
+	}
+
+	// the characters of a pooled string are followed by '\0'
+	void writeString(CPooledString const &text)
+	{
+		pStream->write(text.data(), text.size() + 1);
+	}
+};
+
+/**
+ * Adds every visited element to the name index
+ */
+struct CSnapshotNameIndexBuilder
+{
+	vector<uint32_t> 	*pSlots;
+	uint32_t 			element;
+
+	void operator()(CPooledString const &, CWaypoint const &wp)
+	{
+		size_t mask = pSlots->size() - 1;
+		size_t slot = CSnapshot::hashName(wp.getPooledName().data(), wp.getPooledName().size()) & mask;
+
+		while ((*pSlots)[slot])
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		(*pSlots)[slot] = ++element;
+	}
+};
+
+/**
+ * Writes every visited node of a spatial index and counts the nodes of every POI type
+ */
+struct CSnapshotNodeWriter
+{
+	CSnapshotStream 	*pStream;
+	uint32_t 			treeSizes[CSnapshot::POI_TREE_COUNT];
+
+	void operator()(CWaypoint const &, uint32_t number, double const coord[3], int axis)
+	{
+		CSnapshot::Node node;
+
+		memcpy(node.coord, coord, sizeof(node.coord));
+		node.axis 		= axis;
+		node.element 	= number;
+
+		pStream->write(&node, sizeof(node));
+	}
+
+	void operator()(CPOI const &poi, uint32_t number, double const coord[3], int axis)
+	{
+		treeSizes[min((unsigned int)poi.getPoiType(), CSnapshot::POI_TREE_COUNT - 1)]++;
+		(*this)(static_cast<CWaypoint const &>(poi), number, coord, axis);
+	}
+};
+
+/**
+ * Collects the elements in the order of their names, for a tree built for the snapshot
+ */
+struct CSnapshotElementCollector
+{
+	vector<CWaypoint const *> 	wps;
+	vector<CPOI const *> 		pois[CSnapshot::POI_TREE_COUNT];
+	vector<uint32_t> 			numbers[CSnapshot::POI_TREE_COUNT];
+	uint32_t 					poiCount;
+
+	CSnapshotElementCollector()
+	{
+		poiCount = 0;
+	}
+
+	void operator()(CPooledString const &, CWaypoint const &wp)
+	{
+		wps.push_back(&wp);
+	}
+
+	void operator()(CPooledString const &, CPOI const &poi)
+	{
+		unsigned int type = min((unsigned int)poi.getPoiType(), CSnapshot::POI_TREE_COUNT - 1);
+
+		pois[type].push_back(&poi);
+		numbers[type].push_back(poiCount++);
+	}
+};
+
+/**
+ * Round a position up to the next section
+ */
+static uint64_t alignSection(uint64_t offset)
+{
+	return (offset + CSnapshot::SECTION_ALIGNMENT - 1) / CSnapshot::SECTION_ALIGNMENT * CSnapshot::SECTION_ALIGNMENT;
+}
+
+/**
+ * Number of slots of a name index: twice as many as elements, a power of 2
+ */
+static size_t getSlotCount(size_t count)
+{
+	size_t slotCount = 2;
+
+	while (slotCount < 2 * count)
+	{
+		slotCount *= 2;
+	}
+
+	return slotCount;
+}
+
+/**
+ * Pad the file up to the start of a section, SECTION_COUNT for the end of the file.
+ * Returns false if the previous section does not end where the header places it.
+ */
+static bool beginSection(CSnapshotStream &stream, CSnapshot::Header const &header, unsigned int section)
+{
+	bool isComplete = true;
+
+	if (section > 0)
+	{
+		isComplete = (stream.position == header.sections[section - 1].offset + header.sections[section - 1].size);
+	}
+
+	stream.padTo((section < CSnapshot::SECTION_COUNT) ? header.sections[section].offset : header.fileSize);
+
+	return isComplete;
+}
+
+/**
+ * Write the name index of the elements of a database; it is the one section which is built
+ * in memory before it is written, 4 bytes per slot
+ */
+template<class TDatabase>
+static void writeNameIndex(CSnapshotStream &stream, TDatabase const &database, CSnapshot::Section const &bounds)
+{
+	vector<uint32_t> 			slots(bounds.size / sizeof(uint32_t), 0);
+	CSnapshotNameIndexBuilder 	builder = { &slots, 0 };
+
+	database.visitElements(builder);
+	stream.write(&slots[0], bounds.size);
+}
+
+/**
+ * Write the tree of the Waypoints: the one of the database if it is up to date, else one
+ * built for the snapshot, e.g. after Waypoints were added one by one
+ */
+static void writeWaypointTree(CWpDatabase const &waypointDb, CSnapshotNodeWriter &nodes)
+{
+	if (!waypointDb.visitSpatialIndexNodes(nodes))
+	{
+		CSnapshotElementCollector 		elements;
+		CSpatialIndex<CWaypoint const> 	index;
+
+		waypointDb.visitWaypoints(elements);
+		index.build(elements.wps);
+		index.visitNodes(nodes);
+	}
+}
+
+/**
+ * Write the trees of the POI types: the ones of the database if they are up to date, else
+ * ones built for the snapshot
+ */
+static void writePoiTrees(CPoiDatabase const &poiDb, CSnapshotNodeWriter &nodes)
+{
+	if (!poiDb.visitSpatialIndexNodes(nodes))
+	{
+		CSnapshotElementCollector elements;
+
+		poiDb.visitPois(elements);
+
+		for (unsigned int type = 0; type < CSnapshot::POI_TREE_COUNT; ++type)
+		{
+			CSpatialIndex<CPOI const> index;
+
+			index.build(elements.pois[type], elements.numbers[type]);
+			index.visitNodes(nodes);
+		}
+	}
+}
+
+/**
+ * Check that the names of the elements of a section lie in the string heap
+ */
+static bool hasValidStrings(char const *pData, CSnapshot::Header const &header, CSnapshot::t_section section, uint32_t count)
+{
+	CSnapshot::String const *pStrings 	= CSnapshot::getSection<CSnapshot::String>(pData, header, section);
+	uint64_t 				heapSize 	= header.sections[CSnapshot::STRING_HEAP].size;
+
+	for (uint32_t element = 0; element < count; ++element)
+	{
+		if ((uint64_t)pStrings[element].offset + pStrings[element].length >= heapSize)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * The strings of the heap of a snapshot, each added to the pool once, by their offset
+ */
+struct CSnapshotHeap
+{
+	char const 				*pChars;
+	vector<uint32_t> 		offsets;
+	vector<CPooledString> 	strings;
+};
+
+/**
+ * Add every string of the heap to the pool; the strings follow each other, each terminated by '\0'.
+ * A string which the full pool cannot take is kept as the empty string: its length tells it apart.
+ */
+static void readHeap(char const *pChars, uint64_t size, CSnapshotHeap &heap)
+{
+	heap.pChars = pChars;
+
+	for (uint64_t offset = 0; offset < size; )
+	{
+		char const 		*pEnd 	= static_cast<char const *>(memchr(pChars + offset, '\0', size - offset));
+		uint64_t 		length 	= pEnd ? (uint64_t)(pEnd - (pChars + offset)) : (size - offset);
+		CPooledString 	pooled;
+
+		CPooledString::intern(string_view(pChars + offset, length), pooled);
+		heap.offsets.push_back((uint32_t)offset);
+		heap.strings.push_back(pooled);
+		offset += length + 1;
+	}
+}
+
+/**
+ * Get the pooled string of a string of the heap. A string which is not one of the heap, e.g.
+ * one with a '\0' in it, is added to the pool on its own; false if the pool is full.
+ */
+static bool getPooledString(CSnapshotHeap const &heap, CSnapshot::String const &string, CPooledString &pooled)
+{
+	vector<uint32_t>::const_iterator itr = lower_bound(heap.offsets.begin(), heap.offsets.end(), string.offset);
+
+	if ((itr != heap.offsets.end()) && (*itr == string.offset) && (heap.strings[itr - heap.offsets.begin()].size() == string.length))
+	{
+		pooled = heap.strings[itr - heap.offsets.begin()];
+		return true;
+	}
+
+	return CPooledString::intern(string_view(heap.pChars + string.offset, string.length), pooled);
+}
+
+//Method Implementations
+/**
+ * Constructor
+ */
+CSnapshot::CSnapshot()
+{
+	// Do nothing
+}
+
+
+/**
+ * Destructor
+ */
+CSnapshot::~CSnapshot()
+{
+	// Do nothing
+}
+
+
+/**
+* Set the name of the media to be used for persistent storage.
+* The exact interpretation of the name depends on the implementation
+* of the component.
+*
+* @param name the media to be used: the name of the file
+* @returnval void
+*/
+void CSnapshot::setMediaName(string name)
+{
+	this->mediaName = name;
+}
+
+
+/**
+* Write the data to the persistent storage.
+* The sections are streamed from the databases through a buffer of the writer, the checksum
+* is summed up on the way and written into the header at the end. The trees of the databases
+* are stored as they are if they are up to date; only a name index is built in memory.
+*
+* @param waypointDb the data base with way points
+* @param poiDb the database with points of interest
+* @return true if the data could be saved successfully
+*/
+bool CSnapshot::writeData (const CWpDatabase& waypointDb, const CPoiDatabase& poiDb)
+{
+	uint32_t 					wpCount 		= waypointDb.getElementCount();
+	uint32_t 					poiCount 		= poiDb.getElementCount();
+	CSnapshotDescriptionPlacer 	descriptionSize(0);
+	CSnapshotHeapCounter 		heapCounter 	= { 1, &descriptionSize };
+	Header 						header;
+	bool 						ret 			= true;
+
+	cout << "=======================================================\n";
+	cout << "INFO: Database snapshot backup request\n";
+
+	// the heap: the empty string, the names of the Waypoints, the names of the POIs, the descriptions
+	waypointDb.visitWaypoints(heapCounter);
+
+	uint32_t wpNamesEnd = (uint32_t)heapCounter.end;
+
+	poiDb.visitPois(heapCounter);
+
+	uint64_t poiNamesEnd 	= heapCounter.end;
+	uint64_t heapSize 		= poiNamesEnd + descriptionSize.end;
+
+	if (heapSize > 0xFFFFFFFFu)
+	{
+		cout << "WARNING: The strings of the Databases do not fit into a snapshot - " << this->mediaName << endl;
+		cout << "=======================================================\n";
+		return false;
+	}
+
+	// the sections are placed from the numbers of the elements before anything is written
+	uint64_t const 	sectionSizes[SECTION_COUNT] 	= { wpCount * sizeof(double), wpCount * sizeof(double), wpCount * sizeof(String),
+													getSlotCount(wpCount) * sizeof(uint32_t), poiCount * sizeof(double),
+													poiCount * sizeof(double), poiCount * sizeof(String), poiCount * sizeof(String),
+													poiCount * sizeof(uint8_t), getSlotCount(poiCount) * sizeof(uint32_t), heapSize,
+													wpCount * sizeof(Node), poiCount * sizeof(Node), (POI_TREE_COUNT + 1) * sizeof(uint32_t) };
+	uint64_t 		end 							= sizeof(Header);
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version 		= FORMAT_VERSION;
+	header.byteOrder 	= SNAPSHOT_BYTE_ORDER;
+	header.wpCount 		= wpCount;
+	header.poiCount 	= poiCount;
+
+	for (unsigned int section = 0; section < SECTION_COUNT; ++section)
+	{
+		header.sections[section].offset = alignSection(end);
+		header.sections[section].size 	= sectionSizes[section];
+
+		end = header.sections[section].offset + header.sections[section].size;
+	}
+
+	// the file ends at a section boundary, the checksum reads whole words
+	header.fileSize = alignSection(end);
+
+	CBufferedWriter writer;
+
+	if (!writer.open(this->mediaName))
+	{
+		cout << "WARNING: Error opening the file to write - " << this->mediaName << endl;
+		cout << "=======================================================\n";
+		return false;
+	}
+
+	CSnapshotStream 			stream(&writer);
+	CSnapshotCoordinateWriter 	latitudes 			= { &stream, true };
+	CSnapshotCoordinateWriter 	longitudes 			= { &stream, false };
+	CSnapshotNameWriter 		wpNames 			= { &stream, 1 };
+	CSnapshotNameWriter 		poiNames 			= { &stream, wpNamesEnd };
+	CSnapshotDescriptionPlacer 	descriptions(poiNamesEnd);
+	CSnapshotDescriptionPlacer 	heapDescriptions(poiNamesEnd);
+	CSnapshotPoiWriter 			poiDescriptions 	= { &stream, &descriptions, true };
+	CSnapshotPoiWriter 			poiTypes 			= { &stream, 0, false };
+	CSnapshotHeapWriter 		heapNames 			= { &stream, 0 };
+	CSnapshotHeapWriter 		heapTexts 			= { &stream, &heapDescriptions };
+	CSnapshotNodeWriter 		nodes 				= { &stream, { 0 } };
+	vector<uint32_t> 			poiTreeBounds(1, 0);
+	bool 						isComplete;
+
+	// the checksum field is 0 until the end
+	stream.write(&header, sizeof(header));
+
+	isComplete = beginSection(stream, header, WP_LATITUDES);
+	waypointDb.visitWaypoints(latitudes);
+	isComplete = beginSection(stream, header, WP_LONGITUDES) && isComplete;
+	waypointDb.visitWaypoints(longitudes);
+	isComplete = beginSection(stream, header, WP_NAMES) && isComplete;
+	waypointDb.visitWaypoints(wpNames);
+	isComplete = beginSection(stream, header, WP_NAME_INDEX) && isComplete;
+	writeNameIndex(stream, waypointDb, header.sections[WP_NAME_INDEX]);
+
+	isComplete = beginSection(stream, header, POI_LATITUDES) && isComplete;
+	poiDb.visitPois(latitudes);
+	isComplete = beginSection(stream, header, POI_LONGITUDES) && isComplete;
+	poiDb.visitPois(longitudes);
+	isComplete = beginSection(stream, header, POI_NAMES) && isComplete;
+	poiDb.visitPois(poiNames);
+	isComplete = beginSection(stream, header, POI_DESCRIPTIONS) && isComplete;
+	poiDb.visitPois(poiDescriptions);
+	isComplete = beginSection(stream, header, POI_TYPES) && isComplete;
+	poiDb.visitPois(poiTypes);
+	isComplete = beginSection(stream, header, POI_NAME_INDEX) && isComplete;
+	writeNameIndex(stream, poiDb, header.sections[POI_NAME_INDEX]);
+
+	isComplete = beginSection(stream, header, STRING_HEAP) && isComplete;
+	stream.write("", 1);
+	waypointDb.visitWaypoints(heapNames);
+	poiDb.visitPois(heapNames);
+	poiDb.visitPois(heapTexts);
+
+	isComplete = beginSection(stream, header, WP_TREE) && isComplete;
+	writeWaypointTree(waypointDb, nodes);
+	isComplete = beginSection(stream, header, POI_TREES) && isComplete;
+	writePoiTrees(poiDb, nodes);
+
+	for (unsigned int type = 0; type < POI_TREE_COUNT; ++type)
+	{
+		poiTreeBounds.push_back(poiTreeBounds.back() + nodes.treeSizes[type]);
+	}
+
+	isComplete = beginSection(stream, header, POI_TREE_BOUNDS) && isComplete;
+	stream.write(&poiTreeBounds[0], poiTreeBounds.size() * sizeof(uint32_t));
+	isComplete = beginSection(stream, header, SECTION_COUNT) && isComplete;
+	stream.flush();
+
+	// the checksum covers the whole file with its own field as 0; without it the file is not read
+	if (isComplete)
+	{
+		header.checksum = stream.checksum.get();
+		writer.overwrite(offsetof(Header, checksum), reinterpret_cast<char const *>(&header.checksum), sizeof(header.checksum));
+	}
+	else
+	{
+		cout << "ERROR: A section of the snapshot does not have the size given in its header.\n";
+		ret = false;
+	}
+
+	if (!writer.close())
+	{
+		cout << "WARNING: Error writing the Databases into the file - " << this->mediaName << endl;
+		ret = false;
+	}
+
+	cout << "=======================================================\n";
+
+	return ret;
+}
+
+
+/**
+* Fill the databases with the data from persistent storage. If
+* merge mode is MERGE, the content in the persistent storage
+* will be merged with any content already existing in the data
+* bases. If merge mode is REPLACE, already existing content
+* will be removed before inserting the content from the persistent
+* storage.
+* The file is mapped and its checksum is checked; a file which is not
+* valid leaves the databases unchanged. Every string of the heap is
+* added to the pool once; a replace takes the spatial indexes over
+* from the file instead of building them.
+*
+* @param waypointDb the the data base with way points
+* @param poiDb the database with points of interest
+* @param mode the merge mode
+* @return true if the data could be read successfully
+*/
+bool CSnapshot::readData (CWpDatabase& waypointDb, CPoiDatabase& poiDb, MergeMode mode)
+{
+	CMappedFile 	file;
+
+	if ((mode != CSnapshot::MERGE) && (mode != CSnapshot::REPLACE))
+	{
+		cout << "ERROR: Database snapshot Unknown MergeMode Request.\n";
+		return false;
+	}
+
+	if (!file.open(this->mediaName))
+	{
+		cout << "WARNING: Error opening the file to read - " << this->mediaName << endl;
+		return false;
+	}
+
+	char const 		*pData 		= file.getData();
+	Header const 	*pHeader 	= getHeader(pData, file.getSize());
+
+	if (!pHeader)
+	{
+		cout << "WARNING: The file is not a valid snapshot - " << this->mediaName << endl;
+		return false;
+	}
+
+	if (!hasValidChecksum(pData, *pHeader))
+	{
+		cout << "WARNING: The checksum of the snapshot does not match - " << this->mediaName << endl;
+		return false;
+	}
+
+	if (!hasValidStrings(pData, *pHeader, WP_NAMES, pHeader->wpCount)
+			|| !hasValidStrings(pData, *pHeader, POI_NAMES, pHeader->poiCount)
+			|| !hasValidStrings(pData, *pHeader, POI_DESCRIPTIONS, pHeader->poiCount))
+	{
+		cout << "WARNING: A string of the snapshot is not in its heap - " << this->mediaName << endl;
+		return false;
+	}
+
+	// the sections are read in place, the elements are only constructed
+	char const 		*pHeap 				= getSection<char>(pData, *pHeader, STRING_HEAP);
+	double const 	*pWpLatitudes 		= getSection<double>(pData, *pHeader, WP_LATITUDES);
+	double const 	*pWpLongitudes 		= getSection<double>(pData, *pHeader, WP_LONGITUDES);
+	String const 	*pWpNames 			= getSection<String>(pData, *pHeader, WP_NAMES);
+	Node const 		*pWpTree 			= getSection<Node>(pData, *pHeader, WP_TREE);
+	double const 	*pPoiLatitudes 		= getSection<double>(pData, *pHeader, POI_LATITUDES);
+	double const 	*pPoiLongitudes 	= getSection<double>(pData, *pHeader, POI_LONGITUDES);
+	String const 	*pPoiNames 			= getSection<String>(pData, *pHeader, POI_NAMES);
+	String const 	*pPoiDescriptions 	= getSection<String>(pData, *pHeader, POI_DESCRIPTIONS);
+	uint8_t const 	*pPoiTypes 			= getSection<uint8_t>(pData, *pHeader, POI_TYPES);
+	Node const 		*pPoiTrees 			= getSection<Node>(pData, *pHeader, POI_TREES);
+	uint32_t const 	*pPoiTreeBounds 	= getSection<uint32_t>(pData, *pHeader, POI_TREE_BOUNDS);
+
+	CSnapshotHeap 					heap;
+	CWpDatabase::Database_Batch_t 	wpsRead;
+	CPoiDatabase::Database_Batch_t 	poisRead;
+	vector<Wp_Database_key_t> 		wpKeys;
+	vector<POI_Database_key_t> 		poiKeys;
+	bool 							isComplete = true;
+
+	// a string used by several elements is added to the pool once
+	readHeap(pHeap, pHeader->sections[STRING_HEAP].size, heap);
+
+	wpsRead.reserve(pHeader->wpCount);
+	poisRead.reserve(pHeader->poiCount);
+	wpKeys.reserve(pHeader->wpCount);
+	poiKeys.reserve(pHeader->poiCount);
+
+	for (uint32_t element = 0; element < pHeader->wpCount; ++element)
+	{
+		CPooledString 	name;
+		bool 			isPooled 	= getPooledString(heap, pWpNames[element], name);
+		CWaypoint 		wp(name, pWpLatitudes[element], pWpLongitudes[element]);
+
+		wpKeys.push_back(wp.getPooledName());
+
+		if (!isPooled)
+		{
+			cout << "ERROR: The string pool is full, Waypoint " << element << " of the snapshot is not added.\n";
+			isComplete = false;
+		}
+		else if (wp.isValid())
+		{
+			wpsRead.push_back(pair<Wp_Database_key_t, CWaypoint>(wp.getPooledName(), std::move(wp)));
+		}
+		else
+		{
+			cout << "ERROR: Invalid Waypoint " << element << " in the snapshot.\n";
+			isComplete = false;
+		}
+	}
+
+	for (uint32_t element = 0; element < pHeader->poiCount; ++element)
+	{
+		CPOI::t_poi 	type 		= (pPoiTypes[element] < CPOI::DEFAULT_POI) ? (CPOI::t_poi)pPoiTypes[element] : CPOI::DEFAULT_POI;
+		CPooledString 	name, description;
+		bool 			isPooled 	= getPooledString(heap, pPoiNames[element], name) && getPooledString(heap, pPoiDescriptions[element], description);
+		CPOI 			poi(type, name, description, pPoiLatitudes[element], pPoiLongitudes[element]);
+
+		poiKeys.push_back(poi.getPooledName());
+
+		if (!isPooled)
+		{
+			cout << "ERROR: The string pool is full, POI " << element << " of the snapshot is not added.\n";
+			isComplete = false;
+		}
+		else if (poi.isValid())
+		{
+			poisRead.push_back(pair<POI_Database_key_t, CPOI>(poi.getPooledName(), std::move(poi)));
+		}
+		else
+		{
+			cout << "ERROR: Invalid POI " << element << " in the snapshot.\n";
+			isComplete = false;
+		}
+	}
+
+	cout << "=======================================================\n";
+
+	// the elements are in the order of their names: a linear load
+	if (mode == CSnapshot::MERGE)
+	{
+		cout << "INFO: Database snapshot Merge Request.\n";
+		waypointDb.mergeElements(wpsRead);
+		poiDb.mergeElements(poisRead);
+	}
+	else
+	{
+		cout << "INFO: Database snapshot Replace Request.\n";
+		waypointDb.replaceElements(wpsRead);
+		poiDb.replaceElements(poisRead);
+	}
+
+	if ((mode == CSnapshot::REPLACE) && isComplete)
+	{
+		// the databases hold exactly the elements of the file: its trees are taken over
+		waypointDb.adoptSpatialIndex(pWpTree, pHeader->wpCount, wpKeys);
+		poiDb.adoptSpatialIndex(pPoiTrees, pPoiTreeBounds, poiKeys);
+	}
+	else
+	{
+		// index all the POIs of the file at once
+		poiDb.buildSpatialIndex();
+	}
+
+	cout << "=======================================================\n";
+
+	return true;
+}
+
+
+/**
+* Check the header of a snapshot: magic, version, byte order, size and
+* the bounds of the sections. The checksum is not checked.
+*
+* @param pData the first byte of the file, aligned to SECTION_ALIGNMENT
+* @param size the size of the file
+* @return the header, 0 if it is not valid (the reason is printed)
+*/
+CSnapshot::Header const* CSnapshot::getHeader(char const *pData, size_t size)
+{
+	Header const *pHeader = reinterpret_cast<Header const *>(pData);
+
+	if ((size < alignSection(sizeof(Header))) || memcmp(pHeader->magic, SNAPSHOT_MAGIC, sizeof(pHeader->magic)))
+	{
+		cout << "ERROR: The file is not a snapshot of the databases.\n";
+		return 0;
+	}
+
+	if ((pHeader->version != FORMAT_VERSION) || (pHeader->byteOrder != SNAPSHOT_BYTE_ORDER))
+	{
+		cout << "ERROR: The snapshot has the format version " << pHeader->version << " of another machine or program, expected "
+			 << FORMAT_VERSION << ".\n";
+		return 0;
+	}
+
+	if (pHeader->fileSize != size)
+	{
+		cout << "ERROR: The snapshot is truncated: " << size << " of " << pHeader->fileSize << " bytes.\n";
+		return 0;
+	}
+
+	// size of an element of every section; the name indexes and the heap are checked apart
+	uint64_t const 	elementSizes[SECTION_COUNT] 	= { sizeof(double), sizeof(double), sizeof(String), 0,
+													sizeof(double), sizeof(double), sizeof(String), sizeof(String), sizeof(uint8_t), 0, 0,
+													sizeof(Node), sizeof(Node), 0 };
+	bool 			isPoi[SECTION_COUNT] 			= { false, false, false, false, true, true, true, true, true, true, false,
+													false, true, false };
+	bool 			isValid 						= true;
+
+	for (unsigned int section = 0; section < SECTION_COUNT; ++section)
+	{
+		Section const 	&bounds 	= pHeader->sections[section];
+		uint64_t 		count 		= isPoi[section] ? pHeader->poiCount : pHeader->wpCount;
+
+		isValid = isValid && (bounds.offset >= alignSection(sizeof(Header))) && !(bounds.offset % SECTION_ALIGNMENT)
+				&& (bounds.offset <= size) && (bounds.size <= size - bounds.offset);
+
+		if (elementSizes[section])
+		{
+			isValid = isValid && (bounds.size == count * elementSizes[section]);
+		}
+		else if (section == POI_TREE_BOUNDS)
+		{
+			// the trees follow each other and cover all the POIs
+			uint32_t const *pBounds = reinterpret_cast<uint32_t const *>(pData + bounds.offset);
+
+			isValid = isValid && (bounds.size == (POI_TREE_COUNT + 1) * sizeof(uint32_t)) && !pBounds[0]
+					&& (pBounds[POI_TREE_COUNT] == pHeader->poiCount);
+
+			for (unsigned int tree = 0; isValid && (tree < POI_TREE_COUNT); ++tree)
+			{
+				isValid = (pBounds[tree] <= pBounds[tree + 1]);
+			}
+		}
+		else if (section != STRING_HEAP)
+		{
+			// a power of 2 with more slots than elements: a look-up always reaches a free slot
+			uint64_t slotCount = bounds.size / sizeof(uint32_t);
+
+			isValid = isValid && !(bounds.size % sizeof(uint32_t)) && (slotCount > count) && !(slotCount & (slotCount - 1));
+		}
+		else
+		{
+			isValid = isValid && (bounds.size > 0) && !pData[bounds.offset + bounds.size - 1];
+		}
+	}
+
+	if (!isValid)
+	{
+		cout << "ERROR: A section of the snapshot is out of the file.\n";
+		return 0;
+	}
+
+	return pHeader;
+}
+
+
+/**
+* Get the checksum of a part of the file (Fletcher-64 over 32 bit words)
+*
+* @param pData the first byte
+* @param size number of bytes, a multiple of 4
+* @return the checksum
+*/
+uint64_t CSnapshot::computeChecksum(char const *pData, size_t size)
+{
+	CSnapshotChecksum checksum;
+
+	checksum.add(pData, size);
+
+	return checksum.get();
+}
+
+
+/**
+* Check the checksum of a snapshot with a valid header; every byte of the
+* file is read, the checksum field of the header counts as 0
+*
+* @param pData the first byte of the file
+* @param header the header of the file
+* @return true if the checksum matches
+*/
+bool CSnapshot::hasValidChecksum(char const *pData, Header const &header)
+{
+	CSnapshotChecksum 	checksum;
+	Header 				copy;
+
+	memcpy(&copy, &header, sizeof(copy));
+	copy.checksum = 0;
+
+	checksum.add(reinterpret_cast<char const *>(&copy), sizeof(copy));
+	checksum.add(pData + sizeof(Header), header.fileSize - sizeof(Header));
+
+	return (checksum.get() == header.checksum);
+}
+
+
+/**
+* Get the hash of a name for the name index (FNV-1a)
+*
+* @param pChars the characters of the name
+* @param length number of characters
+* @return the hash
+*/
+uint32_t CSnapshot::hashName(char const *pChars, size_t length)
+{
+	uint32_t hash = 2166136261u;
+
+	for (size_t index = 0; index < length; ++index)
+	{
+		hash = (hash ^ (unsigned char)pChars[index]) * 16777619u;
+	}
+
+	return hash;
+}
+
+
+/**
+* Look a name up in a name index of a valid snapshot
+*
+* @param pData the first byte of the file
+* @param header the header of the file
+* @param names WP_NAMES or POI_NAMES
+* @param index WP_NAME_INDEX or POI_NAME_INDEX
+* @param pChars the characters of the name
+* @param length number of characters
+* @return the number of the element, NOT_FOUND if the name is not in the file
+*/
+uint32_t CSnapshot::findName(char const *pData, Header const &header, t_section names, t_section index, char const *pChars, size_t length)
+{
+	char const 		*pHeap 		= getSection<char>(pData, header, STRING_HEAP);
+	String const 	*pNames 	= getSection<String>(pData, header, names);
+	uint32_t const 	*pSlots 	= getSection<uint32_t>(pData, header, index);
+	size_t 			mask 		= header.sections[index].size / sizeof(uint32_t) - 1;
+	size_t 			slot 		= hashName(pChars, length) & mask;
+	uint64_t 		nameCount 	= header.sections[names].size / sizeof(String);
+	uint64_t 		heapSize 	= header.sections[STRING_HEAP].size;
+
+	// linear probing up to the name or a free slot; a damaged slot ends the search,
+	// and every slot is probed at most once: a damaged index may have no free slot, the checksum is not checked
+	for (size_t probe = 0; (probe <= mask) && pSlots[slot] && (pSlots[slot] <= nameCount); ++probe)
+	{
+		String const &name = pNames[pSlots[slot] - 1];
+
+		if ((name.length == length) && ((uint64_t)name.offset + length < heapSize) && !memcmp(pHeap + name.offset, pChars, length))
+		{
+			return pSlots[slot] - 1;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return NOT_FOUND;
+}
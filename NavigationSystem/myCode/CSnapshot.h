@@ -0,0 +1,273 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CSnapshot.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CSnapshot.
+* 					The class CSnapshot is used to implement the Persistence
+* 					feature with a binary image of the databases: nothing
+* 					of the file has to be parsed when it is read.
+*
+* 					Layout of the file (native byte order, every section
+* 					starts at a multiple of SECTION_ALIGNMENT):
+* 					- Header: magic, format version, byte order mark,
+* 					  file size, checksum of the whole file (the checksum
+* 					  field counted as 0),
+* 					  number of Waypoints and POIs, offset and size of
+* 					  the sections
+* 					- Waypoints: latitudes, longitudes (double arrays),
+* 					  names (String array), name index
+* 					- POIs: latitudes, longitudes, names, descriptions,
+* 					  types (one byte per POI), name index
+* 					- Spatial index: the implicit k-d tree of the
+* 					  Waypoints and one tree per POI type (the nodes of
+* 					  a CSpatialIndex with element numbers instead of
+* 					  addresses), the first node of every POI tree
+* 					- String heap: the characters of all the strings,
+* 					  each one is followed by '\0': the names, then the
+* 					  descriptions; a description used by many POIs is
+* 					  usually stored once
+* 					The elements are stored in the order of their names.
+* 					A name index is a hash table (linear probing) of the
+* 					element numbers + 1, 0 marks a free slot.
+*
+****************************************************************************/
+
+#ifndef CSNAPSHOT_H
+#define CSNAPSHOT_H
+
+//System Include Files
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+//Own Include Files
+#include "CPersistentStorage.h"
+
+class CSnapshot : public CPersistentStorage {
+public:
+
+	/**
+	 * The sections of the file
+	 */
+	enum t_section
+	{
+		WP_LATITUDES = 0,
+		WP_LONGITUDES,
+		WP_NAMES,
+		WP_NAME_INDEX,
+		POI_LATITUDES,
+		POI_LONGITUDES,
+		POI_NAMES,
+		POI_DESCRIPTIONS,
+		POI_TYPES,
+		POI_NAME_INDEX,
+		STRING_HEAP,
+		WP_TREE,
+		POI_TREES,
+		POI_TREE_BOUNDS,
+		SECTION_COUNT,
+	};
+
+	/**
+	 * Position and size in bytes of a section
+	 */
+	struct Section
+	{
+		uint64_t	offset;
+		uint64_t	size;
+	};
+
+	/**
+	 * A string of the heap: position of the first character and number of characters
+	 */
+	struct String
+	{
+		uint32_t	offset;
+		uint32_t	length;
+	};
+
+	/**
+	 * A node of a k-d tree: position on the unit sphere, split axis and number of the element
+	 */
+	struct Node
+	{
+		double		coord[3];
+		uint32_t	axis;
+		uint32_t	element;
+	};
+
+	/**
+	 * Number of POI trees: one per type, DEFAULT_POI included
+	 */
+	static const unsigned int	POI_TREE_COUNT = CPOI::DEFAULT_POI + 1;
+
+	/**
+	 * The start of the file
+	 */
+	struct Header
+	{
+		char		magic[8];
+		uint32_t	version;
+		uint32_t	byteOrder;
+		uint64_t	fileSize;
+		uint64_t	checksum;
+		uint32_t	wpCount;
+		uint32_t	poiCount;
+		Section		sections[SECTION_COUNT];
+	};
+
+	/**
+	 * Version of the layout; a file of another version is not read
+	 */
+	static const uint32_t		FORMAT_VERSION;
+
+	/**
+	 * Alignment of the sections in bytes, the header is padded to it
+	 */
+	static const uint64_t		SECTION_ALIGNMENT;
+
+	/**
+	 * Result of findName if the name is not in the index
+	 */
+	static const uint32_t		NOT_FOUND;
+
+	/**
+	 * Constructor
+	 */
+	CSnapshot();
+
+	/**
+	 * Destructor
+	 */
+	~CSnapshot();
+
+	/**
+	* Set the name of the media to be used for persistent storage.
+	* The exact interpretation of the name depends on the implementation
+	* of the component.
+	*
+	* @param name the media to be used: the name of the file
+	* @returnval void
+	*/
+	void setMediaName(std::string name);
+
+	/**
+	* Write the data to the persistent storage.
+	* The sections are streamed from the databases through a buffer of the writer, the checksum
+	* is summed up on the way and written into the header at the end. The trees of the databases
+	* are stored as they are if they are up to date; only a name index is built in memory.
+	*
+	* @param waypointDb the data base with way points
+	* @param poiDb the database with points of interest
+	* @return true if the data could be saved successfully
+	*/
+	bool writeData (const CWpDatabase& waypointDb, const CPoiDatabase& poiDb);
+
+	/**
+	* Fill the databases with the data from persistent storage. If
+	* merge mode is MERGE, the content in the persistent storage
+	* will be merged with any content already existing in the data
+	* bases. If merge mode is REPLACE, already existing content
+	* will be removed before inserting the content from the persistent
+	* storage.
+	* The file is mapped and its checksum is checked; a file which is not
+	* valid leaves the databases unchanged. Every string of the heap is
+	* added to the pool once; a replace takes the spatial indexes over
+	* from the file instead of building them.
+	*
+	* @param waypointDb the the data base with way points
+	* @param poiDb the database with points of interest
+	* @param mode the merge mode
+	* @return true if the data could be read successfully
+	*/
+	bool readData (CWpDatabase& waypointDb, CPoiDatabase& poiDb, MergeMode mode);
+
+	/**
+	* Check the header of a snapshot: magic, version, byte order, size and
+	* the bounds of the sections. The checksum is not checked.
+	*
+	* @param pData the first byte of the file, aligned to SECTION_ALIGNMENT
+	* @param size the size of the file
+	* @return the header, 0 if it is not valid (the reason is printed)
+	*/
+	static Header const* getHeader(char const *pData, size_t size);
+
+	/**
+	* Get the checksum of a part of the file (Fletcher-64 over 32 bit words)
+	*
+	* @param pData the first byte
+	* @param size number of bytes, a multiple of 4
+	* @return the checksum
+	*/
+	static uint64_t computeChecksum(char const *pData, size_t size);
+
+	/**
+	* Check the checksum of a snapshot with a valid header; every byte of the
+	* file is read, the checksum field of the header counts as 0
+	*
+	* @param pData the first byte of the file
+	* @param header the header of the file
+	* @return true if the checksum matches
+	*/
+	static bool hasValidChecksum(char const *pData, Header const &header);
+
+	/**
+	* Get the hash of a name for the name index (FNV-1a)
+	*
+	* @param pChars the characters of the name
+	* @param length number of characters
+	* @return the hash
+	*/
+	static uint32_t hashName(char const *pChars, size_t length);
+
+	/**
+	* Look a name up in a name index of a valid snapshot
+	*
+	* @param pData the first byte of the file
+	* @param header the header of the file
+	* @param names WP_NAMES or POI_NAMES
+	* @param index WP_NAME_INDEX or POI_NAME_INDEX
+	* @param pChars the characters of the name
+	* @param length number of characters
+	* @return the number of the element, NOT_FOUND if the name is not in the file
+	*/
+	static uint32_t findName(char const *pData, Header const &header, t_section names, t_section index, char const *pChars, size_t length);
+
+	/**
+	* Get the first element of a section of a valid snapshot
+	*
+	* @param pData the first byte of the file
+	* @param header the header of the file
+	* @param section the section
+	* @return the first element
+	*/
+	template<class T>
+	static T const* getSection(char const *pData, Header const &header, t_section section);
+
+private:
+
+	/**
+	 * Media Name of the Storage
+	 */
+	std::string 		mediaName;
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+* Get the first element of a section of a valid snapshot
+*
+* @param pData the first byte of the file
+* @param header the header of the file
+* @param section the section
+* @return the first element
+*/
+template<class T>
+T const* CSnapshot::getSection(char const *pData, Header const &header, t_section section)
+{
+	return reinterpret_cast<T const *>(pData + header.sections[section].offset);
+}
+#endif /* CSNAPSHOT_H */
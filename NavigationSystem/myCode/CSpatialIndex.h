@@ -0,0 +1,1231 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CSpatialIndex.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a template class CSpatialIndex.
+* 					The class CSpatialIndex is used to answer nearest,
+* 					k-nearest and within-radius queries over elements
+* 					which have a latitude and a longitude, and to visit
+* 					the elements inside a latitude / longitude rectangle.
+*
+* 					The elements are projected on the unit sphere and
+* 					kept in implicit k-d trees (the median of every
+* 					sub-range is its root). The straight line (chord)
+* 					distance on the unit sphere grows with the great
+* 					circle distance, hence the poles and the date line
+* 					need no special handling.
+*
+* 					Elements added after a bulk build are kept in
+* 					additional trees of size 1, 2, 4, ... which are
+* 					merged like a binary counter, so an insertion costs
+* 					O(log^2 N) amortized. A nearest neighbour query
+* 					usually descends O(log N) nodes per tree, O(log^2 N)
+* 					over all the trees (clustered elements may need more).
+* 					A rectangle query costs O(sqrt(N) + k) per tree for
+* 					k elements found (see visitRectangle).
+*
+****************************************************************************/
+
+#ifndef CSPATIALINDEX_H_
+#define CSPATIALINDEX_H_
+
+//System Include Files
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+
+//Own Include Files
+#include "CWaypoint.h"
+
+// a template class for the spatial index
+template<class T>
+class CSpatialIndex {
+public:
+
+	/**
+	 * A query result: the element and its great circle distance in KMs
+	 */
+	struct Neighbour
+	{
+		T			*pElement;
+		double		distance;
+	};
+
+	typedef std::vector<Neighbour>					Neighbour_Container_t;
+	typedef std::vector<CSpatialIndex<T> const *>	Index_Container_t;
+
+	/**
+	 * CSpatialIndex constructor
+	 */
+	CSpatialIndex();
+
+	/**
+	 * CSpatialIndex destructor
+	 */
+	~CSpatialIndex();
+
+	/**
+	 * Drop the current content and index all the given elements at once; an element is
+	 * numbered by its position in elements
+	 * param@ std::vector<T*> const &elements	-	elements to be indexed	(IN)
+	 * returnvalue@ void
+	 */
+	void build(std::vector<T*> const &elements);
+
+	/**
+	 * Drop the current content and index all the given elements at once with the given numbers,
+	 * e.g. their position in the order of the keys of a database (see visitNodes)
+	 * param@ std::vector<T*> const &elements	-	elements to be indexed	(IN)
+	 * param@ std::vector<uint32_t> const &numbers	-	number of every element	(IN)
+	 * returnvalue@ void
+	 */
+	void build(std::vector<T*> const &elements, std::vector<uint32_t> const &numbers);
+
+	/**
+	 * Drop the current content and take over a tree which build() made before, e.g. stored in a file:
+	 * the nodes are in the order visitNodes() gave them and are not sorted again.
+	 * A node has the members coord[3], axis and element, the number of its element in pElements;
+	 * the caller checks the numbers and the axes. The elements keep their numbers.
+	 * param@ TNode const pNodes[]			-	nodes of the tree			(IN)
+	 * param@ unsigned int count			-	number of nodes				(IN)
+	 * param@ T * const pElements[]		-	elements by their number	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TNode>
+	void adoptTree(TNode const pNodes[], unsigned int count, T * const pElements[]);
+
+	/**
+	 * Add a single element to the index
+	 * param@ T *pElement			-	element to be indexed	(IN)
+	 * returnvalue@ void
+	 */
+	void insert(T *pElement);
+
+	/**
+	 * Remove all the elements from the index
+	 * returnvalue@ void
+	 */
+	void clear();
+
+	/**
+	 * Number of indexed elements
+	 * returnvalue@ unsigned int
+	 */
+	unsigned int size() const;
+
+	/**
+	 * Check if the index is the single tree of a build() or an adoptTree(), so that visitNodes()
+	 * gives the numbers of the elements; insert() adds elements without a number
+	 * returnvalue@ bool
+	 */
+	bool isNumbered() const;
+
+	/**
+	 * Get the element closest to the given position
+	 * param@ double latitude		-	latitude of the position	(IN)
+	 * param@ double longitude		-	longitude of the position	(IN)
+	 * returnvalue@ T*				-	closest element, 0 if the index is empty
+	 */
+	T* nearest(double latitude, double longitude) const;
+
+	/**
+	 * Get the k elements closest to the given position, the closest one first
+	 * param@ double latitude				-	latitude of the position	(IN)
+	 * param@ double longitude				-	longitude of the position	(IN)
+	 * param@ unsigned int k				-	number of elements			(IN)
+	 * param@ Neighbour_Container_t &result	-	found elements				(OUT)
+	 * returnvalue@ void
+	 */
+	void kNearest(double latitude, double longitude, unsigned int k, Neighbour_Container_t &result) const;
+
+	/**
+	 * Get all the elements within the radius around the given position, the closest one first
+	 * param@ double latitude				-	latitude of the position	(IN)
+	 * param@ double longitude				-	longitude of the position	(IN)
+	 * param@ double radius					-	radius in KMs				(IN)
+	 * param@ Neighbour_Container_t &result	-	found elements				(OUT)
+	 * returnvalue@ void
+	 */
+	void withinRadius(double latitude, double longitude, double radius, Neighbour_Container_t &result) const;
+
+	/**
+	 * Get the k elements closest to the given position out of several indexes, the closest one first
+	 * param@ Index_Container_t const &indexes	-	indexes to be searched		(IN)
+	 * param@ double latitude					-	latitude of the position	(IN)
+	 * param@ double longitude					-	longitude of the position	(IN)
+	 * param@ unsigned int k					-	number of elements			(IN)
+	 * param@ Neighbour_Container_t &result		-	found elements				(OUT)
+	 * returnvalue@ void
+	 */
+	static void kNearest(Index_Container_t const &indexes, double latitude, double longitude, unsigned int k, Neighbour_Container_t &result);
+
+	/**
+	 * Get all the elements within the radius around the given position out of several indexes, the closest one first
+	 * param@ Index_Container_t const &indexes	-	indexes to be searched		(IN)
+	 * param@ double latitude					-	latitude of the position	(IN)
+	 * param@ double longitude					-	longitude of the position	(IN)
+	 * param@ double radius						-	radius in KMs				(IN)
+	 * param@ Neighbour_Container_t &result		-	found elements				(OUT)
+	 * returnvalue@ void
+	 */
+	static void withinRadius(Index_Container_t const &indexes, double latitude, double longitude, double radius, Neighbour_Container_t &result);
+
+	/**
+	 * Visit all the elements inside the latitude / longitude rectangle. The trees are searched
+	 * with the 3-D bounding box of the rectangle on the unit sphere: like any k-d tree range
+	 * search this costs O(sqrt(N) + k) for k elements found when the elements spread over the
+	 * sphere (O(N^(2/3) + k) at worst in 3-D), and the box also holds points outside the
+	 * rectangle, e.g. beyond its corners, which are visited and checked one by one.
+	 * A rectangle with minLongitude > maxLongitude crosses the date line. Elements on a pole
+	 * are inside the rectangle whenever the pole is, whatever their longitude.
+	 * The visitor is called as visitor(T &element) and must not modify the index.
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ TVisitor &visitor			-	called for every element in the rectangle	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const;
+
+	/**
+	 * Visit all the elements of several indexes inside the latitude / longitude rectangle
+	 * (see the method above).
+	 * param@ Index_Container_t const &indexes	-	indexes to be searched	(IN)
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ TVisitor &visitor			-	called for every element in the rectangle	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	static void visitRectangle(Index_Container_t const &indexes, double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor);
+
+	/**
+	 * Convert a position to a point on the unit sphere
+	 * param@ double latitude		-	latitude in degrees		(IN)
+	 * param@ double longitude		-	longitude in degrees	(IN)
+	 * param@ double coord[3]		-	x, y and z				(OUT)
+	 * returnvalue@ void
+	 */
+	static void toUnitVector(double latitude, double longitude, double coord[3]);
+
+	/**
+	 * Convert a squared chord length on the unit sphere to a great circle distance
+	 * param@ double chord2			-	squared chord length	(IN)
+	 * returnvalue@ double			-	distance in KMs
+	 */
+	static double chord2ToDistance(double chord2);
+
+	/**
+	 * Convert a great circle distance to a squared chord length on the unit sphere
+	 * param@ double distance		-	distance in KMs			(IN)
+	 * returnvalue@ double			-	squared chord length
+	 */
+	static double distanceToChord2(double distance);
+
+	/**
+	 * Visit the nodes of the index in their order in memory, e.g. to store the index in a file.
+	 * After build() the nodes form one implicit k-d tree: the root of the range [lo, hi) is the
+	 * node lo + (hi - lo) / 2 and splits it at its coordinate of the axis.
+	 * The visitor is called as visitor(T &element, uint32_t number, double const coord[3], int axis)
+	 * with the number the element got from build() or adoptTree().
+	 * param@ TVisitor &visitor			-	called for every node	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitNodes(TVisitor &visitor) const;
+
+	/**
+	 * A latitude / longitude rectangle split at the date line into at most two longitude
+	 * ranges, each with the bounding box of its part of the sphere
+	 */
+	struct Rectangle
+	{
+		double			minLatitude, maxLatitude;
+		double			minLongitude[2], maxLongitude[2];
+		double			minCoord[2][3], maxCoord[2][3];
+		unsigned int	ranges;
+	};
+
+	/**
+	 * Validate the rectangle, split it at the date line and compute the bounding boxes of its parts
+	 * on the unit sphere
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ Rectangle &rectangle		-	the rectangle		(OUT)
+	 * returnvalue@ bool				-	false if the rectangle is empty
+	 */
+	static bool makeRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, Rectangle &rectangle);
+
+	/**
+	 * Check if a position is inside the rectangle
+	 * param@ Rectangle const &rectangle	-	the rectangle				(IN)
+	 * param@ double latitude				-	latitude of the position	(IN)
+	 * param@ double longitude				-	longitude of the position	(IN)
+	 * returnvalue@ bool
+	 */
+	static bool isInside(Rectangle const &rectangle, double latitude, double longitude);
+
+	/**
+	 * Orders (squared chord, element) pairs by the distance only, whatever the element is
+	 */
+	struct CandidateLess
+	{
+		template<class TCandidate>
+		bool operator()(TCandidate const &lhs, TCandidate const &rhs) const
+		{
+			return lhs.first < rhs.first;
+		}
+	};
+
+	/**
+	 * The searches of one implicit k-d tree, the nodes [lo, hi). They are shared by the index and by
+	 * trees stored elsewhere, e.g. in a mapped snapshot file (see CMappedDatabase): the nodes are read
+	 * through an accessor TNodes with the methods
+	 *   double const* getCoord(unsigned int node) const		-	the unit vector of the node
+	 *   unsigned int getAxis(unsigned int node) const			-	the split axis, 0 to 2
+	 *   bool getElement(unsigned int node, E &element) const	-	false if the node is skipped
+	 *   void visitIfInside(unsigned int node, Rectangle const &rectangle, TVisitor &visitor) const
+	 * where E is the element type of the candidates, std::pair<double, E>.
+	 * searchKNearest collects the k closest elements in a max-heap ordered by CandidateLess,
+	 * searchRadius all the elements within the squared chord length maxChord2 and searchRectangle
+	 * visits the nodes whose part of the tree can overlap the bounding boxes of the rectangle.
+	 */
+	template<class TNodes, class TCandidate>
+	static void searchKNearest(TNodes const &nodes, unsigned int lo, unsigned int hi, const double query[3], unsigned int k,
+			std::priority_queue<TCandidate, std::vector<TCandidate>, CandidateLess> &heap);
+
+	template<class TNodes, class TCandidate>
+	static void searchRadius(TNodes const &nodes, unsigned int lo, unsigned int hi, const double query[3], double maxChord2,
+			std::vector<TCandidate> &found);
+
+	template<class TNodes, class TVisitor>
+	static void searchRectangle(TNodes const &nodes, unsigned int lo, unsigned int hi, Rectangle const &rectangle, TVisitor &visitor);
+
+private:
+
+	/**
+	 * A node of an implicit k-d tree
+	 */
+	struct Entry
+	{
+		double		coord[3];
+		int			axis;
+		uint32_t	number;
+		T			*pElement;
+	};
+
+	typedef std::vector<Entry>						Tree_t;
+
+	/**
+	 * A (squared chord, element) pair ordered by the distance only
+	 */
+	typedef std::pair<double, T*>					Candidate_t;
+
+	typedef std::priority_queue<Candidate_t, std::vector<Candidate_t>, CandidateLess>	Candidate_Heap_t;
+
+	struct AxisLess
+	{
+		int axis;
+		bool operator()(Entry const &lhs, Entry const &rhs) const
+		{
+			return lhs.coord[axis] < rhs.coord[axis];
+		}
+	};
+
+	/**
+	 * The accessor of the searches to the nodes of a tree of the index
+	 */
+	struct EntryNodes
+	{
+		Entry const		*pEntries;
+
+		double const* getCoord(unsigned int node) const
+		{
+			return this->pEntries[node].coord;
+		}
+
+		unsigned int getAxis(unsigned int node) const
+		{
+			return this->pEntries[node].axis;
+		}
+
+		bool getElement(unsigned int node, T* &pElement) const
+		{
+			pElement = this->pEntries[node].pElement;
+			return true;
+		}
+
+		template<class TVisitor>
+		void visitIfInside(unsigned int node, Rectangle const &rectangle, TVisitor &visitor) const
+		{
+			T *pElement = this->pEntries[node].pElement;
+
+			if (CSpatialIndex<T>::isInside(rectangle, *pElement))
+			{
+				visitor(*pElement);
+			}
+		}
+	};
+
+	/**
+	 * Trees built by build() and by insert(); empty trees are unused slots
+	 */
+	std::vector<Tree_t>								m_trees;
+
+	/**
+	 * Number of indexed elements
+	 */
+	unsigned int									m_size;
+
+	/**
+	 * True while the index is one tree of numbered elements
+	 */
+	bool											m_isNumbered;
+
+	static Entry makeEntry(T *pElement, uint32_t number);
+	static void buildTree(Tree_t &tree, unsigned int lo, unsigned int hi);
+	static double chord2(const double coord[3], const double query[3]);
+	static void boundingBox(Rectangle &rectangle, unsigned int range);
+	static bool isInside(Rectangle const &rectangle, T const &element);
+};
+
+
+/**
+ * CSpatialIndex constructor
+ */
+template<class T>
+CSpatialIndex<T>::CSpatialIndex()
+{
+	this->m_size 		= 0;
+	this->m_isNumbered 	= true;
+}
+
+
+/**
+ * CSpatialIndex destructor
+ */
+template<class T>
+CSpatialIndex<T>::~CSpatialIndex()
+{
+	// do nothing
+}
+
+
+/**
+ * Drop the current content and index all the given elements at once; an element is
+ * numbered by its position in elements
+ * param@ std::vector<T*> const &elements	-	elements to be indexed	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::build(std::vector<T*> const &elements)
+{
+	std::vector<uint32_t> numbers(elements.size());
+
+	for (unsigned int index = 0; index < numbers.size(); ++index)
+	{
+		numbers[index] = index;
+	}
+
+	this->build(elements, numbers);
+}
+
+
+/**
+ * Drop the current content and index all the given elements at once with the given numbers,
+ * e.g. their position in the order of the keys of a database (see visitNodes)
+ * param@ std::vector<T*> const &elements	-	elements to be indexed	(IN)
+ * param@ std::vector<uint32_t> const &numbers	-	number of every element	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::build(std::vector<T*> const &elements, std::vector<uint32_t> const &numbers)
+{
+	this->clear();
+
+	if (!elements.empty())
+	{
+		Tree_t tree;
+
+		tree.reserve(elements.size());
+
+		for (unsigned int index = 0; index < elements.size(); ++index)
+		{
+			tree.push_back(makeEntry(elements[index], numbers[index]));
+		}
+
+		buildTree(tree, 0, tree.size());
+
+		this->m_trees.push_back(Tree_t());
+		this->m_trees.back().swap(tree);
+		this->m_size = elements.size();
+	}
+}
+
+
+/**
+ * Drop the current content and take over a tree which build() made before, e.g. stored in a file:
+ * the nodes are in the order visitNodes() gave them and are not sorted again.
+ * A node has the members coord[3], axis and element, the number of its element in pElements;
+ * the caller checks the numbers and the axes. The elements keep their numbers.
+ * param@ TNode const pNodes[]			-	nodes of the tree			(IN)
+ * param@ unsigned int count			-	number of nodes				(IN)
+ * param@ T * const pElements[]		-	elements by their number	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+template<class TNode>
+void CSpatialIndex<T>::adoptTree(TNode const pNodes[], unsigned int count, T * const pElements[])
+{
+	this->clear();
+
+	if (count)
+	{
+		Tree_t tree(count);
+
+		for (unsigned int index = 0; index < count; ++index)
+		{
+			tree[index].coord[0] 	= pNodes[index].coord[0];
+			tree[index].coord[1] 	= pNodes[index].coord[1];
+			tree[index].coord[2] 	= pNodes[index].coord[2];
+			tree[index].axis 		= pNodes[index].axis;
+			tree[index].number 		= pNodes[index].element;
+			tree[index].pElement 	= pElements[pNodes[index].element];
+		}
+
+		this->m_trees.push_back(Tree_t());
+		this->m_trees.back().swap(tree);
+		this->m_size = count;
+	}
+}
+
+
+/**
+ * Add a single element to the index
+ * param@ T *pElement			-	element to be indexed	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::insert(T *pElement)
+{
+	Tree_t			carry(1, makeEntry(pElement, 0));
+	unsigned int	slot = 0;
+
+	// merge the trees like a binary counter: a tree is only merged with trees not larger than itself
+	while ((slot < this->m_trees.size()) &&
+			(this->m_trees[slot].empty() || (this->m_trees[slot].size() <= carry.size())))
+	{
+		carry.insert(carry.end(), this->m_trees[slot].begin(), this->m_trees[slot].end());
+		Tree_t().swap(this->m_trees[slot]);
+		slot++;
+	}
+
+	buildTree(carry, 0, carry.size());
+
+	// keep the larger trees (e.g. the bulk built one) at the end of the list
+	if (slot > 0)
+	{
+		slot--;
+	}
+	else
+	{
+		this->m_trees.insert(this->m_trees.begin(), Tree_t());
+	}
+
+	this->m_trees[slot].swap(carry);
+	this->m_size++;
+	this->m_isNumbered = false;
+}
+
+
+/**
+ * Remove all the elements from the index
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::clear()
+{
+	this->m_trees.clear();
+	this->m_size 		= 0;
+	this->m_isNumbered 	= true;
+}
+
+
+/**
+ * Number of indexed elements
+ * returnvalue@ unsigned int
+ */
+template<class T>
+unsigned int CSpatialIndex<T>::size() const
+{
+	return this->m_size;
+}
+
+
+/**
+ * Check if the index is the single tree of a build() or an adoptTree(), so that visitNodes()
+ * gives the numbers of the elements; insert() adds elements without a number
+ * returnvalue@ bool
+ */
+template<class T>
+bool CSpatialIndex<T>::isNumbered() const
+{
+	return this->m_isNumbered;
+}
+
+
+/**
+ * Get the element closest to the given position
+ * param@ double latitude		-	latitude of the position	(IN)
+ * param@ double longitude		-	longitude of the position	(IN)
+ * returnvalue@ T*				-	closest element, 0 if the index is empty
+ */
+template<class T>
+T* CSpatialIndex<T>::nearest(double latitude, double longitude) const
+{
+	T						*pElement = 0;
+	Neighbour_Container_t	result;
+
+	this->kNearest(latitude, longitude, 1, result);
+
+	if (!result.empty())
+	{
+		pElement = result[0].pElement;
+	}
+
+	return pElement;
+}
+
+
+/**
+ * Get the k elements closest to the given position, the closest one first
+ * param@ double latitude				-	latitude of the position	(IN)
+ * param@ double longitude				-	longitude of the position	(IN)
+ * param@ unsigned int k				-	number of elements			(IN)
+ * param@ Neighbour_Container_t &result	-	found elements				(OUT)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::kNearest(double latitude, double longitude, unsigned int k, Neighbour_Container_t &result) const
+{
+	kNearest(Index_Container_t(1, this), latitude, longitude, k, result);
+}
+
+
+/**
+ * Get all the elements within the radius around the given position, the closest one first
+ * param@ double latitude				-	latitude of the position	(IN)
+ * param@ double longitude				-	longitude of the position	(IN)
+ * param@ double radius					-	radius in KMs				(IN)
+ * param@ Neighbour_Container_t &result	-	found elements				(OUT)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::withinRadius(double latitude, double longitude, double radius, Neighbour_Container_t &result) const
+{
+	withinRadius(Index_Container_t(1, this), latitude, longitude, radius, result);
+}
+
+
+/**
+ * Get the k elements closest to the given position out of several indexes, the closest one first
+ * param@ Index_Container_t const &indexes	-	indexes to be searched		(IN)
+ * param@ double latitude					-	latitude of the position	(IN)
+ * param@ double longitude					-	longitude of the position	(IN)
+ * param@ unsigned int k					-	number of elements			(IN)
+ * param@ Neighbour_Container_t &result		-	found elements				(OUT)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::kNearest(Index_Container_t const &indexes, double latitude, double longitude, unsigned int k, Neighbour_Container_t &result)
+{
+	double				query[3];
+	Candidate_Heap_t	heap;
+
+	result.clear();
+
+	if (k == 0)
+	{
+		return;
+	}
+
+	toUnitVector(latitude, longitude, query);
+
+	for (unsigned int index = 0; index < indexes.size(); ++index)
+	{
+		for (unsigned int slot = 0; slot < indexes[index]->m_trees.size(); ++slot)
+		{
+			Tree_t const	&tree	= indexes[index]->m_trees[slot];
+			EntryNodes		nodes	= { tree.data() };
+
+			searchKNearest(nodes, 0, tree.size(), query, k, heap);
+		}
+	}
+
+	// the heap returns the farthest element first
+	result.resize(heap.size());
+
+	for (unsigned int index = heap.size(); index > 0; --index)
+	{
+		result[index - 1].pElement	= heap.top().second;
+		result[index - 1].distance	= chord2ToDistance(heap.top().first);
+		heap.pop();
+	}
+}
+
+
+/**
+ * Get all the elements within the radius around the given position out of several indexes, the closest one first
+ * param@ Index_Container_t const &indexes	-	indexes to be searched		(IN)
+ * param@ double latitude					-	latitude of the position	(IN)
+ * param@ double longitude					-	longitude of the position	(IN)
+ * param@ double radius						-	radius in KMs				(IN)
+ * param@ Neighbour_Container_t &result		-	found elements				(OUT)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::withinRadius(Index_Container_t const &indexes, double latitude, double longitude, double radius, Neighbour_Container_t &result)
+{
+	double						query[3];
+	std::vector<Candidate_t>	found;
+
+	result.clear();
+
+	if (radius < 0)
+	{
+		return;
+	}
+
+	toUnitVector(latitude, longitude, query);
+
+	for (unsigned int index = 0; index < indexes.size(); ++index)
+	{
+		for (unsigned int slot = 0; slot < indexes[index]->m_trees.size(); ++slot)
+		{
+			Tree_t const	&tree	= indexes[index]->m_trees[slot];
+			EntryNodes		nodes	= { tree.data() };
+
+			searchRadius(nodes, 0, tree.size(), query, distanceToChord2(radius), found);
+		}
+	}
+
+	std::sort(found.begin(), found.end(), CandidateLess());
+
+	result.resize(found.size());
+
+	for (unsigned int index = 0; index < found.size(); ++index)
+	{
+		result[index].pElement	= found[index].second;
+		result[index].distance	= chord2ToDistance(found[index].first);
+	}
+}
+
+
+/**
+ * Visit all the elements inside the latitude / longitude rectangle. The trees are searched
+ * with the 3-D bounding box of the rectangle on the unit sphere: like any k-d tree range
+ * search this costs O(sqrt(N) + k) for k elements found when the elements spread over the
+ * sphere (O(N^(2/3) + k) at worst in 3-D), and the box also holds points outside the
+ * rectangle, e.g. beyond its corners, which are visited and checked one by one.
+ * A rectangle with minLongitude > maxLongitude crosses the date line. Elements on a pole
+ * are inside the rectangle whenever the pole is, whatever their longitude.
+ * The visitor is called as visitor(T &element) and must not modify the index.
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ TVisitor &visitor			-	called for every element in the rectangle	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+template<class TVisitor>
+void CSpatialIndex<T>::visitRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor) const
+{
+	visitRectangle(Index_Container_t(1, this), minLatitude, maxLatitude, minLongitude, maxLongitude, visitor);
+}
+
+
+/**
+ * Visit all the elements of several indexes inside the latitude / longitude rectangle
+ * (see the method above).
+ * param@ Index_Container_t const &indexes	-	indexes to be searched	(IN)
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ TVisitor &visitor			-	called for every element in the rectangle	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+template<class TVisitor>
+void CSpatialIndex<T>::visitRectangle(Index_Container_t const &indexes, double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor)
+{
+	Rectangle rectangle;
+
+	if (!makeRectangle(minLatitude, maxLatitude, minLongitude, maxLongitude, rectangle))
+	{
+		return;
+	}
+
+	for (unsigned int index = 0; index < indexes.size(); ++index)
+	{
+		for (unsigned int slot = 0; slot < indexes[index]->m_trees.size(); ++slot)
+		{
+			Tree_t const	&tree	= indexes[index]->m_trees[slot];
+			EntryNodes		nodes	= { tree.data() };
+
+			searchRectangle(nodes, 0, tree.size(), rectangle, visitor);
+		}
+	}
+}
+
+
+/**
+ * Visit the nodes of the index in their order in memory, e.g. to store the index in a file.
+ * After build() the nodes form one implicit k-d tree: the root of the range [lo, hi) is the
+ * node lo + (hi - lo) / 2 and splits it at its coordinate of the axis.
+ * The visitor is called as visitor(T &element, uint32_t number, double const coord[3], int axis)
+ * with the number the element got from build() or adoptTree().
+ * param@ TVisitor &visitor			-	called for every node	(IN)
+ * returnvalue@ void
+ */
+template<class T>
+template<class TVisitor>
+void CSpatialIndex<T>::visitNodes(TVisitor &visitor) const
+{
+	for (unsigned int slot = 0; slot < this->m_trees.size(); ++slot)
+	{
+		for (unsigned int index = 0; index < this->m_trees[slot].size(); ++index)
+		{
+			Entry const &node = this->m_trees[slot][index];
+
+			visitor(*node.pElement, node.number, node.coord, node.axis);
+		}
+	}
+}
+
+
+/**
+ * Convert a position to a point on the unit sphere
+ * param@ double latitude		-	latitude in degrees		(IN)
+ * param@ double longitude		-	longitude in degrees	(IN)
+ * param@ double coord[3]		-	x, y and z				(OUT)
+ * returnvalue@ void
+ */
+template<class T>
+void CSpatialIndex<T>::toUnitVector(double latitude, double longitude, double coord[3])
+{
+	double latRad = latitude * DEG_TO_RAD;
+	double lonRad = longitude * DEG_TO_RAD;
+
+	coord[0] = cos(latRad) * cos(lonRad);
+	coord[1] = cos(latRad) * sin(lonRad);
+	coord[2] = sin(latRad);
+}
+
+
+/**
+ * Convert a squared chord length on the unit sphere to a great circle distance
+ * param@ double chord2			-	squared chord length	(IN)
+ * returnvalue@ double			-	distance in KMs
+ */
+template<class T>
+double CSpatialIndex<T>::chord2ToDistance(double chord2)
+{
+	double halfChord = sqrt(chord2) / 2;
+
+	if (halfChord > 1)
+	{
+		halfChord = 1;
+	}
+
+	return (2 * EARTH_RADIUS_KM * asin(halfChord));
+}
+
+
+/**
+ * Convert a great circle distance to a squared chord length on the unit sphere
+ * param@ double distance		-	distance in KMs			(IN)
+ * returnvalue@ double			-	squared chord length
+ */
+template<class T>
+double CSpatialIndex<T>::distanceToChord2(double distance)
+{
+	double angle = distance / EARTH_RADIUS_KM;
+	double chord = 2;
+
+	// beyond half the circumference every point on the sphere is within the radius
+	if (angle < (4 * atan(1)))
+	{
+		chord = 2 * sin(angle / 2);
+	}
+
+	return (chord * chord);
+}
+
+
+/**
+ * Create a k-d tree node for an element
+ */
+template<class T>
+typename CSpatialIndex<T>::Entry CSpatialIndex<T>::makeEntry(T *pElement, uint32_t number)
+{
+	Entry entry;
+
+	pElement->getUnitVector(entry.coord);
+	entry.axis		= 0;
+	entry.number	= number;
+	entry.pElement	= pElement;
+
+	return entry;
+}
+
+
+/**
+ * Arrange the range [lo, hi) of the tree as an implicit k-d tree.
+ * The split axis of every node is the one with the widest spread.
+ */
+template<class T>
+void CSpatialIndex<T>::buildTree(Tree_t &tree, unsigned int lo, unsigned int hi)
+{
+	if (hi <= lo)
+	{
+		return;
+	}
+
+	double		minCoord[3] = { 2, 2, 2 }, maxCoord[3] = { -2, -2, -2 };
+	AxisLess	less;
+
+	for (unsigned int index = lo; index < hi; ++index)
+	{
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			minCoord[axis] = std::min(minCoord[axis], tree[index].coord[axis]);
+			maxCoord[axis] = std::max(maxCoord[axis], tree[index].coord[axis]);
+		}
+	}
+
+	less.axis = 0;
+
+	for (int axis = 1; axis < 3; ++axis)
+	{
+		if ((maxCoord[axis] - minCoord[axis]) > (maxCoord[less.axis] - minCoord[less.axis]))
+		{
+			less.axis = axis;
+		}
+	}
+
+	unsigned int mid = lo + (hi - lo) / 2;
+
+	std::nth_element(tree.begin() + lo, tree.begin() + mid, tree.begin() + hi, less);
+	tree[mid].axis = less.axis;
+
+	buildTree(tree, lo, mid);
+	buildTree(tree, mid + 1, hi);
+}
+
+
+/**
+ * Squared chord length between a node and the query point
+ */
+template<class T>
+double CSpatialIndex<T>::chord2(const double coord[3], const double query[3])
+{
+	double dx = coord[0] - query[0];
+	double dy = coord[1] - query[1];
+	double dz = coord[2] - query[2];
+
+	return (dx * dx + dy * dy + dz * dz);
+}
+
+
+/**
+ * Collect the k closest elements of the range [lo, hi) in a max-heap
+ * param@ TNodes const &nodes		-	accessor to the nodes of the tree (see the declaration)	(IN)
+ * param@ unsigned int lo			-	first node of the range				(IN)
+ * param@ unsigned int hi			-	end of the range					(IN)
+ * param@ const double query[3]		-	unit vector of the position			(IN)
+ * param@ unsigned int k			-	number of elements					(IN)
+ * param@ std::priority_queue<...> &heap	-	the k closest elements so far	(IN/OUT)
+ * returnvalue@ void
+ */
+template<class T>
+template<class TNodes, class TCandidate>
+void CSpatialIndex<T>::searchKNearest(TNodes const &nodes, unsigned int lo, unsigned int hi, const double query[3], unsigned int k,
+		std::priority_queue<TCandidate, std::vector<TCandidate>, CandidateLess> &heap)
+{
+	if (hi <= lo)
+	{
+		return;
+	}
+
+	unsigned int					mid		= lo + (hi - lo) / 2;
+	double const					*pCoord	= nodes.getCoord(mid);
+	unsigned int					axis	= nodes.getAxis(mid);
+	double							dist2	= chord2(pCoord, query);
+	typename TCandidate::second_type	element;
+
+	if (nodes.getElement(mid, element))
+	{
+		if (heap.size() < k)
+		{
+			heap.push(TCandidate(dist2, element));
+		}
+		else if (dist2 < heap.top().first)
+		{
+			heap.pop();
+			heap.push(TCandidate(dist2, element));
+		}
+	}
+
+	double diff = query[axis] - pCoord[axis];
+
+	// visit the side of the query point first, the other one only if it can still hold a closer element
+	if (diff < 0)
+	{
+		searchKNearest(nodes, lo, mid, query, k, heap);
+
+		if ((heap.size() < k) || ((diff * diff) < heap.top().first))
+		{
+			searchKNearest(nodes, mid + 1, hi, query, k, heap);
+		}
+	}
+	else
+	{
+		searchKNearest(nodes, mid + 1, hi, query, k, heap);
+
+		if ((heap.size() < k) || ((diff * diff) < heap.top().first))
+		{
+			searchKNearest(nodes, lo, mid, query, k, heap);
+		}
+	}
+}
+
+
+/**
+ * Collect all the elements of the range [lo, hi) within the squared chord length
+ * param@ double maxChord2			-	squared chord length of the radius	(IN)
+ * param@ std::vector<TCandidate> &found	-	found elements, not sorted	(IN/OUT)
+ * see searchKNearest above for the other parameters
+ */
+template<class T>
+template<class TNodes, class TCandidate>
+void CSpatialIndex<T>::searchRadius(TNodes const &nodes, unsigned int lo, unsigned int hi, const double query[3], double maxChord2,
+		std::vector<TCandidate> &found)
+{
+	if (hi <= lo)
+	{
+		return;
+	}
+
+	unsigned int					mid		= lo + (hi - lo) / 2;
+	double const					*pCoord	= nodes.getCoord(mid);
+	unsigned int					axis	= nodes.getAxis(mid);
+	double							dist2	= chord2(pCoord, query);
+	typename TCandidate::second_type	element;
+
+	if ((dist2 <= maxChord2) && nodes.getElement(mid, element))
+	{
+		found.push_back(TCandidate(dist2, element));
+	}
+
+	double diff = query[axis] - pCoord[axis];
+
+	if ((diff <= 0) || ((diff * diff) <= maxChord2))
+	{
+		searchRadius(nodes, lo, mid, query, maxChord2, found);
+	}
+
+	if ((diff >= 0) || ((diff * diff) <= maxChord2))
+	{
+		searchRadius(nodes, mid + 1, hi, query, maxChord2, found);
+	}
+}
+
+/**
+ * Validate the rectangle, split it at the date line and compute the bounding boxes of its parts
+ * on the unit sphere
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ Rectangle &rectangle		-	the rectangle		(OUT)
+ * returnvalue@ bool				-	false if the rectangle is empty
+ */
+template<class T>
+bool CSpatialIndex<T>::makeRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, Rectangle &rectangle)
+{
+	rectangle.minLatitude	= std::max(minLatitude, (double)LATITUDE_MIN);
+	rectangle.maxLatitude	= std::min(maxLatitude, (double)LATITUDE_MAX);
+	minLongitude			= std::max(minLongitude, (double)LONGITUDE_MIN);
+	maxLongitude			= std::min(maxLongitude, (double)LONGITUDE_MAX);
+
+	if (rectangle.minLatitude > rectangle.maxLatitude)
+	{
+		return false;
+	}
+
+	if (minLongitude <= maxLongitude)
+	{
+		rectangle.minLongitude[0]	= minLongitude;
+		rectangle.maxLongitude[0]	= maxLongitude;
+		rectangle.ranges			= 1;
+	}
+	else
+	{
+		// the rectangle crosses the date line
+		rectangle.minLongitude[0]	= minLongitude;
+		rectangle.maxLongitude[0]	= LONGITUDE_MAX;
+		rectangle.minLongitude[1]	= LONGITUDE_MIN;
+		rectangle.maxLongitude[1]	= maxLongitude;
+		rectangle.ranges			= 2;
+	}
+
+	for (unsigned int range = 0; range < rectangle.ranges; ++range)
+	{
+		boundingBox(rectangle, range);
+	}
+
+	return true;
+}
+
+
+/**
+ * Compute the bounding box on the unit sphere of one longitude range of the rectangle
+ */
+template<class T>
+void CSpatialIndex<T>::boundingBox(Rectangle &rectangle, unsigned int range)
+{
+	// the bounding box is only used to skip sub-trees, a small margin absorbs rounding errors
+	const double	margin		= 1e-9;
+	double			minLat		= rectangle.minLatitude * DEG_TO_RAD;
+	double			maxLat		= rectangle.maxLatitude * DEG_TO_RAD;
+	double			minLon		= rectangle.minLongitude[range];
+	double			maxLon		= rectangle.maxLongitude[range];
+
+	// range of cos(latitude), which scales x and y
+	double minCosLat = std::min(cos(minLat), cos(maxLat));
+	double maxCosLat = ((minLat <= 0) && (maxLat >= 0)) ? 1 : std::max(cos(minLat), cos(maxLat));
+
+	// range of cos(longitude) and sin(longitude): the end points or the extremes inside the range
+	double minCosLon = std::min(cos(minLon * DEG_TO_RAD), cos(maxLon * DEG_TO_RAD));
+	double maxCosLon = std::max(cos(minLon * DEG_TO_RAD), cos(maxLon * DEG_TO_RAD));
+	double minSinLon = std::min(sin(minLon * DEG_TO_RAD), sin(maxLon * DEG_TO_RAD));
+	double maxSinLon = std::max(sin(minLon * DEG_TO_RAD), sin(maxLon * DEG_TO_RAD));
+
+	if ((minLon <= 0) && (maxLon >= 0))
+	{
+		maxCosLon = 1;
+	}
+
+	if ((minLon <= LONGITUDE_MIN) || (maxLon >= LONGITUDE_MAX))
+	{
+		minCosLon = -1;
+	}
+
+	if ((minLon <= 90) && (maxLon >= 90))
+	{
+		maxSinLon = 1;
+	}
+
+	if ((minLon <= -90) && (maxLon >= -90))
+	{
+		minSinLon = -1;
+	}
+
+	// x = cos(lat) * cos(lon), y = cos(lat) * sin(lon), z = sin(lat) with cos(lat) >= 0
+	rectangle.minCoord[range][0] = ((minCosLon < 0) ? maxCosLat : minCosLat) * minCosLon - margin;
+	rectangle.maxCoord[range][0] = ((maxCosLon > 0) ? maxCosLat : minCosLat) * maxCosLon + margin;
+	rectangle.minCoord[range][1] = ((minSinLon < 0) ? maxCosLat : minCosLat) * minSinLon - margin;
+	rectangle.maxCoord[range][1] = ((maxSinLon > 0) ? maxCosLat : minCosLat) * maxSinLon + margin;
+	rectangle.minCoord[range][2] = sin(minLat) - margin;
+	rectangle.maxCoord[range][2] = sin(maxLat) + margin;
+}
+
+
+/**
+ * Check if an element is inside the rectangle
+ */
+template<class T>
+bool CSpatialIndex<T>::isInside(Rectangle const &rectangle, T const &element)
+{
+	return isInside(rectangle, element.getLatitude(), element.getLongitude());
+}
+
+
+/**
+ * Check if a position is inside the rectangle
+ * param@ Rectangle const &rectangle	-	the rectangle				(IN)
+ * param@ double latitude				-	latitude of the position	(IN)
+ * param@ double longitude				-	longitude of the position	(IN)
+ * returnvalue@ bool
+ */
+template<class T>
+bool CSpatialIndex<T>::isInside(Rectangle const &rectangle, double latitude, double longitude)
+{
+	bool	isInside	= false;
+
+	if ((latitude >= rectangle.minLatitude) && (latitude <= rectangle.maxLatitude))
+	{
+		// on a pole every longitude is the same point
+		isInside = (latitude == LATITUDE_MIN) || (latitude == LATITUDE_MAX);
+
+		for (unsigned int range = 0; (range < rectangle.ranges) && !isInside; ++range)
+		{
+			isInside = (longitude >= rectangle.minLongitude[range]) && (longitude <= rectangle.maxLongitude[range]);
+		}
+	}
+
+	return isInside;
+}
+
+
+/**
+ * Visit all the elements of the range [lo, hi) inside the rectangle
+ * param@ Rectangle const &rectangle	-	the rectangle of makeRectangle()					(IN)
+ * param@ TVisitor &visitor				-	passed to the visitIfInside() of the accessor	(IN)
+ * see searchKNearest above for the other parameters
+ */
+template<class T>
+template<class TNodes, class TVisitor>
+void CSpatialIndex<T>::searchRectangle(TNodes const &nodes, unsigned int lo, unsigned int hi, Rectangle const &rectangle, TVisitor &visitor)
+{
+	if (hi <= lo)
+	{
+		return;
+	}
+
+	unsigned int	mid			= lo + (hi - lo) / 2;
+	double const	*pCoord		= nodes.getCoord(mid);
+	unsigned int	axis		= nodes.getAxis(mid);
+	bool			visitLeft	= false, visitRight = false;
+
+	for (unsigned int range = 0; range < rectangle.ranges; ++range)
+	{
+		visitLeft	= visitLeft || (rectangle.minCoord[range][axis] <= pCoord[axis]);
+		visitRight	= visitRight || (rectangle.maxCoord[range][axis] >= pCoord[axis]);
+	}
+
+	nodes.visitIfInside(mid, rectangle, visitor);
+
+	if (visitLeft)
+	{
+		searchRectangle(nodes, lo, mid, rectangle, visitor);
+	}
+
+	if (visitRight)
+	{
+		searchRectangle(nodes, mid + 1, hi, rectangle, visitor);
+	}
+}
+
+#endif /* CSPATIALINDEX_H_ */
@@ -0,0 +1,639 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CStringPool.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class types - class CStringPool and class
+* 					CPooledString.
+*
+****************************************************************************/
+
+//System Include Files
+#include <iostream>
+#include <cstring>
+
+//Own Include Files
+#include "CStringPool.h"
+
+//Namespaces
+using namespace std;
+
+//Method Implementations
+const CStringPool::String_Id_t	CStringPool::EMPTY_STRING;
+const CStringPool::String_Id_t	CStringPool::NOT_FOUND;
+const unsigned int				CStringPool::BLOCK_BITS;
+const unsigned int				CStringPool::BLOCK_SIZE;
+const unsigned int				CStringPool::BLOCK_COUNT;
+const size_t					CStringPool::CHUNK_SIZE;
+const unsigned int				CStringPool::SHARD_BITS;
+const unsigned int				CStringPool::SHARD_COUNT;
+const unsigned int				CStringPool::ID_BITS;
+const CStringPool::String_Id_t	CStringPool::ID_MASK;
+
+
+/**
+ * The pool of the program
+ * returnvalue@ CStringPool&		-	the pool
+ */
+CStringPool& CStringPool::getInstance()
+{
+	// created on the first use, also if that is during the initialization of another static object
+	static CStringPool pool;
+
+	return pool;
+}
+
+
+/**
+ * CStringPool constructor: the pool holds the empty string
+ */
+CStringPool::CStringPool()
+{
+	for (unsigned int index = 0; index < SHARD_COUNT; ++index)
+	{
+		Shard &shard = this->m_shards[index];
+
+		shard.blocks.assign(BLOCK_COUNT, (Entry *)0);
+		shard.count 		= 0;
+		shard.pFree 		= 0;
+		shard.freeLength 	= 0;
+		shard.charBytes 	= 0;
+		shard.tables.push_back(new Table(1024 / SHARD_COUNT));
+		shard.pTable 		= shard.tables.back();
+	}
+
+	Shard &first = this->m_shards[0];
+
+	first.blocks[0] = new Entry[BLOCK_SIZE];
+
+	Entry &empty = first.blocks[0][EMPTY_STRING];
+
+	empty.pChars = storeChars(first, "", 0);
+	empty.length = 0;
+	empty.hash	 = hashChars("", 0);
+
+	first.count = 1;
+}
+
+
+/**
+ * CStringPool destructor
+ */
+CStringPool::~CStringPool()
+{
+	for (unsigned int shardIndex = 0; shardIndex < SHARD_COUNT; ++shardIndex)
+	{
+		Shard &shard = this->m_shards[shardIndex];
+
+		for (unsigned int index = 0; index < shard.blocks.size(); ++index)
+		{
+			delete[] shard.blocks[index];
+		}
+
+		for (unsigned int index = 0; index < shard.chunks.size(); ++index)
+		{
+			delete[] shard.chunks[index];
+		}
+
+		for (unsigned int index = 0; index < shard.tables.size(); ++index)
+		{
+			delete shard.tables[index];
+		}
+	}
+}
+
+
+/**
+ * Get the number of a string, the string is added to the pool if it is not yet in it.
+ * The method may be called by several threads at the same time: a string which is in the
+ * pool already is found without a lock, a new string locks only its shard.
+ * param@ char const *pChars		-	characters of the string	(IN)
+ * param@ size_t length				-	number of characters		(IN)
+ * returnvalue@ String_Id_t			-	number of the string, NOT_FOUND if the pool is full
+ */
+CStringPool::String_Id_t CStringPool::intern(char const *pChars, size_t length)
+{
+	if (length == 0)
+	{
+		return EMPTY_STRING;
+	}
+
+	uint32_t			hash 		= hashChars(pChars, length);
+	unsigned int		shardIndex 	= getShard(hash);
+	Shard				&shard 		= this->m_shards[shardIndex];
+	String_Id_t			value;
+
+	this->findSlot(*shard.pTable.load(memory_order_acquire), pChars, length, hash, value);
+
+	if (value != EMPTY_STRING)
+	{
+		return value & ID_MASK;
+	}
+
+	lock_guard<mutex>	lock(shard.mutex);
+	Table				&table = *shard.tables.back();
+	size_t				slot = this->findSlot(table, pChars, length, hash, value);
+
+	// added by another thread after the look-up without the lock
+	if (value != EMPTY_STRING)
+	{
+		return value & ID_MASK;
+	}
+
+	String_Id_t local = shard.count.load(memory_order_relaxed);
+
+	// the caller reports the string which is not added
+	if (local == (String_Id_t)BLOCK_SIZE * BLOCK_COUNT)
+	{
+		return NOT_FOUND;
+	}
+
+	if (!shard.blocks[local >> BLOCK_BITS])
+	{
+		shard.blocks[local >> BLOCK_BITS] = new Entry[BLOCK_SIZE];
+	}
+
+	Entry 		&entry 	= shard.blocks[local >> BLOCK_BITS][local & (BLOCK_SIZE - 1)];
+	String_Id_t	id 		= (local << SHARD_BITS) | shardIndex;
+
+	entry.pChars = storeChars(shard, pChars, length);
+	entry.length = (uint32_t)length;
+	entry.hash	 = hash;
+
+	// the entry is complete before a look-up without the lock can find its slot
+	table.slots[slot].store(id | (hash & ~ID_MASK), memory_order_release);
+	shard.count.store(local + 1, memory_order_relaxed);
+
+	// at most 3/4 of the slots are used: the probe sequences stay short
+	if ((local + 1) * 4 > table.slots.size() * 3)
+	{
+		this->growTable(shardIndex);
+	}
+
+	return id;
+}
+
+
+/**
+ * Get the number of a string without adding it to the pool, e.g. to look a name up.
+ * The method may be called by several threads at the same time, it takes no lock:
+ * a string which is added during the look-up may or may not be found.
+ * param@ char const *pChars		-	characters of the string	(IN)
+ * param@ size_t length				-	number of characters		(IN)
+ * returnvalue@ String_Id_t			-	number of the string, NOT_FOUND if it is not in the pool
+ */
+CStringPool::String_Id_t CStringPool::find(char const *pChars, size_t length) const
+{
+	if (length == 0)
+	{
+		return EMPTY_STRING;
+	}
+
+	uint32_t		hash = hashChars(pChars, length);
+	String_Id_t		value;
+
+	this->findSlot(*this->m_shards[getShard(hash)].pTable.load(memory_order_acquire), pChars, length, hash, value);
+
+	return (value != EMPTY_STRING) ? (value & ID_MASK) : NOT_FOUND;
+}
+
+
+/**
+ * Get the characters of a string, terminated by '\0'
+ * param@ String_Id_t id			-	number of the string		(IN)
+ * returnvalue@ char const*			-	characters of the string
+ */
+char const* CStringPool::getChars(String_Id_t id) const
+{
+	return this->getEntry(id).pChars;
+}
+
+
+/**
+ * Get the number of characters of a string
+ * param@ String_Id_t id			-	number of the string		(IN)
+ * returnvalue@ size_t				-	number of characters
+ */
+size_t CStringPool::getLength(String_Id_t id) const
+{
+	return this->getEntry(id).length;
+}
+
+
+/**
+ * Get the number of strings in the pool, the empty string included
+ * returnvalue@ size_t				-	number of strings
+ */
+size_t CStringPool::getStringCount() const
+{
+	size_t count = 0;
+
+	for (unsigned int index = 0; index < SHARD_COUNT; ++index)
+	{
+		count += this->m_shards[index].count.load(memory_order_relaxed);
+	}
+
+	return count;
+}
+
+
+/**
+ * Get the memory held by the pool: characters, string table and hash table
+ * returnvalue@ size_t				-	bytes
+ */
+size_t CStringPool::getMemoryUsage() const
+{
+	size_t bytes = 0;
+
+	for (unsigned int shardIndex = 0; shardIndex < SHARD_COUNT; ++shardIndex)
+	{
+		Shard const 		&shard = this->m_shards[shardIndex];
+		lock_guard<mutex>	lock(shard.mutex);
+		size_t 				blocks = (shard.count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+		for (unsigned int index = 0; index < shard.tables.size(); ++index)
+		{
+			bytes += shard.tables[index]->slots.size() * sizeof(String_Id_t);
+		}
+
+		bytes += shard.charBytes + blocks * BLOCK_SIZE * sizeof(Entry) + shard.blocks.capacity() * sizeof(Entry *);
+	}
+
+	return bytes;
+}
+
+
+/**
+ * Get the entry of a string
+ */
+CStringPool::Entry const& CStringPool::getEntry(String_Id_t id) const
+{
+	String_Id_t local = id >> SHARD_BITS;
+
+	return this->m_shards[id & (SHARD_COUNT - 1)].blocks[local >> BLOCK_BITS][local & (BLOCK_SIZE - 1)];
+}
+
+
+/**
+ * Hash of the characters of a string (FNV-1a)
+ */
+uint32_t CStringPool::hashChars(char const *pChars, size_t length)
+{
+	uint32_t hash = 2166136261u;
+
+	for (size_t index = 0; index < length; ++index)
+	{
+		hash = (hash ^ (unsigned char)pChars[index]) * 16777619u;
+	}
+
+	return hash;
+}
+
+
+/**
+ * Shard of a string: the top bits of the hash multiplied by the golden ratio, they depend on
+ * all the bits of the hash. The low bits, which choose the slot, and the top bits, which are
+ * the tag, would put the strings of a shard into a part of its table or give them one tag
+ */
+unsigned int CStringPool::getShard(uint32_t hash)
+{
+	return (hash * 2654435769u) >> (32 - SHARD_BITS);
+}
+
+
+/**
+ * Find the slot of a string in a hash table: the slot which holds it or the free
+ * slot where it is to be added, and the value read from it
+ */
+size_t CStringPool::findSlot(Table const &table, char const *pChars, size_t length, uint32_t hash, String_Id_t &value) const
+{
+	size_t		mask 	= table.slots.size() - 1;
+	size_t		slot 	= hash & mask;
+	String_Id_t	tag 	= hash & ~ID_MASK;
+
+	// linear probing up to the string or a free slot; the entry is only read if the tag matches
+	for (value = table.slots[slot].load(memory_order_acquire); value != EMPTY_STRING; value = table.slots[slot].load(memory_order_acquire))
+	{
+		if ((value & ~ID_MASK) == tag)
+		{
+			Entry const &entry = this->getEntry(value & ID_MASK);
+
+			if ((entry.hash == hash) && (entry.length == length) && !memcmp(entry.pChars, pChars, length))
+			{
+				break;
+			}
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+
+/**
+ * Copy characters into the chunks of a shard, terminated by '\0'
+ */
+char const* CStringPool::storeChars(Shard &shard, char const *pChars, size_t length)
+{
+	if (length + 1 > shard.freeLength)
+	{
+		// a long string gets a chunk of its own, the rest of the current chunk is kept for the next strings
+		size_t size = max(CHUNK_SIZE, length + 1);
+		char   *pChunk = new char[size];
+
+		shard.chunks.push_back(pChunk);
+		shard.charBytes += size;
+
+		if (size > CHUNK_SIZE)
+		{
+			memcpy(pChunk, pChars, length);
+			pChunk[length] = '\0';
+			return pChunk;
+		}
+
+		shard.pFree 		= pChunk;
+		shard.freeLength 	= size;
+	}
+
+	char *pStored = shard.pFree;
+
+	memcpy(pStored, pChars, length);
+	pStored[length] = '\0';
+
+	shard.pFree 		+= length + 1;
+	shard.freeLength 	-= length + 1;
+
+	return pStored;
+}
+
+
+/**
+ * Double the hash table of a shard; the table is filled before it is published to the look-ups
+ */
+void CStringPool::growTable(unsigned int shardIndex)
+{
+	Shard		&shard 	= this->m_shards[shardIndex];
+	Table		*pTable = new Table(shard.tables.back()->slots.size() * 2);
+	size_t		mask 	= pTable->slots.size() - 1;
+	String_Id_t	count 	= shard.count.load(memory_order_relaxed);
+
+	// the stored hashes spare hashing the strings again; the empty string is not in a table
+	for (String_Id_t local = (shardIndex == 0) ? 1 : 0; local < count; ++local)
+	{
+		String_Id_t id 		= (local << SHARD_BITS) | shardIndex;
+		uint32_t	hash 	= this->getEntry(id).hash;
+		size_t 		slot 	= hash & mask;
+
+		while (pTable->slots[slot].load(memory_order_relaxed) != EMPTY_STRING)
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		pTable->slots[slot].store(id | (hash & ~ID_MASK), memory_order_relaxed);
+	}
+
+	shard.tables.push_back(pTable);
+	shard.pTable.store(pTable, memory_order_release);
+}
+
+
+/**
+ * Number of the string of a CPooledString: the empty string if the pool is full
+ */
+static CStringPool::String_Id_t internOrEmpty(char const *pChars, size_t length)
+{
+	CStringPool::String_Id_t id = CStringPool::getInstance().intern(pChars, length);
+
+	return (id != CStringPool::NOT_FOUND) ? id : CStringPool::EMPTY_STRING;
+}
+
+
+/**
+ * CPooledString constructor: the empty string
+ */
+CPooledString::CPooledString() : m_id(CStringPool::EMPTY_STRING)
+{
+}
+
+
+/**
+ * CPooledString constructor: the string is added to the pool, the empty string if the pool is full
+ * param@ std::string const &text	-	the string	(IN)
+ */
+CPooledString::CPooledString(string const &text)
+{
+	this->m_id = internOrEmpty(text.data(), text.size());
+}
+
+
+/**
+ * CPooledString constructor: the string is added to the pool, the empty string if the pool is full
+ * param@ char const *pText			-	the string, terminated by '\0'	(IN)
+ */
+CPooledString::CPooledString(char const *pText)
+{
+	this->m_id = internOrEmpty(pText, strlen(pText));
+}
+
+
+/**
+ * CPooledString constructor: the characters are added to the pool, e.g. a string read in place from a file;
+ * the empty string if the pool is full
+ * param@ char const *pChars		-	characters of the string	(IN)
+ * param@ size_t length				-	number of characters		(IN)
+ */
+CPooledString::CPooledString(char const *pChars, size_t length)
+{
+	this->m_id = internOrEmpty(pChars, length);
+}
+
+
+/**
+ * Get the pooled string with the given characters, the string is added to the pool if it is not yet in it
+ * param@ std::string_view text		-	the string			(IN)
+ * param@ CPooledString &pooled		-	the pooled string	(OUT)
+ * returnvalue@ bool				-	false if the pool is full
+ */
+bool CPooledString::intern(string_view text, CPooledString &pooled)
+{
+	CStringPool::String_Id_t id = CStringPool::getInstance().intern(text.data(), text.size());
+
+	if (id == CStringPool::NOT_FOUND)
+	{
+		return false;
+	}
+
+	pooled.m_id = id;
+
+	return true;
+}
+
+
+/**
+ * Get the pooled string with the given characters without adding it to the pool,
+ * e.g. to look a name up in a database
+ * param@ std::string_view text		-	the string			(IN)
+ * param@ CPooledString &pooled		-	the pooled string	(OUT)
+ * returnvalue@ bool				-	false if the string is not in the pool
+ */
+bool CPooledString::find(string_view text, CPooledString &pooled)
+{
+	CStringPool::String_Id_t id = CStringPool::getInstance().find(text.data(), text.size());
+
+	if (id == CStringPool::NOT_FOUND)
+	{
+		return false;
+	}
+
+	pooled.m_id = id;
+
+	return true;
+}
+
+
+/**
+ * Get the number of the string in the pool
+ * returnvalue@ CStringPool::String_Id_t	-	number of the string
+ */
+CStringPool::String_Id_t CPooledString::getId() const
+{
+	return this->m_id;
+}
+
+
+/**
+ * Get a copy of the string
+ * returnvalue@ std::string			-	the string
+ */
+string CPooledString::str() const
+{
+	return string(this->data(), this->size());
+}
+
+
+/**
+ * Get a copy of the string
+ * returnvalue@ std::string			-	the string
+ */
+CPooledString::operator string() const
+{
+	return this->str();
+}
+
+
+/**
+ * Get the characters of the string, terminated by '\0'
+ * returnvalue@ char const*			-	characters of the string
+ */
+char const* CPooledString::data() const
+{
+	return CStringPool::getInstance().getChars(this->m_id);
+}
+
+
+/**
+ * Get the characters of the string, terminated by '\0'
+ * returnvalue@ char const*			-	characters of the string
+ */
+char const* CPooledString::c_str() const
+{
+	return this->data();
+}
+
+
+/**
+ * Get the characters of the string without a copy, e.g. for a look-up by name
+ * returnvalue@ std::string_view	-	the string
+ */
+CPooledString::operator string_view() const
+{
+	return string_view(this->data(), this->size());
+}
+
+
+/**
+ * Get the number of characters of the string
+ * returnvalue@ size_t				-	number of characters
+ */
+size_t CPooledString::size() const
+{
+	return CStringPool::getInstance().getLength(this->m_id);
+}
+
+
+/**
+ * Check if the string is empty
+ * returnvalue@ bool				-	true for the empty string
+ */
+bool CPooledString::empty() const
+{
+	return (this->m_id == CStringPool::EMPTY_STRING);
+}
+
+
+/**
+ * Compare the characters of two strings like std::string::compare
+ * param@ CPooledString const &other	-	string to compare with	(IN)
+ * returnvalue@ int				-	<0, 0 or >0
+ */
+int CPooledString::compare(CPooledString const &other) const
+{
+	if (this->m_id == other.m_id)
+	{
+		return 0;
+	}
+
+	size_t	length 	= this->size();
+	size_t	otherLength = other.size();
+	int		result 	= memcmp(this->data(), other.data(), min(length, otherLength));
+
+	if (result)
+	{
+		return result;
+	}
+
+	return (length < otherLength) ? -1 : ((length > otherLength) ? 1 : 0);
+}
+
+
+/**
+ * Equal strings have equal numbers: an integer comparison
+ */
+bool CPooledString::operator==(CPooledString const &rhs) const
+{
+	return (this->m_id == rhs.m_id);
+}
+
+
+/**
+ * Equal strings have equal numbers: an integer comparison
+ */
+bool CPooledString::operator!=(CPooledString const &rhs) const
+{
+	return (this->m_id != rhs.m_id);
+}
+
+
+/**
+ * Order of the characters, like std::string
+ */
+bool CPooledString::operator<(CPooledString const &rhs) const
+{
+	return (this->compare(rhs) < 0);
+}
+
+
+/**
+ * An operator overloaded friend function which prints the string
+ * param@ ostream &stream				-	output stream	(IN/OUT)
+ * param@ CPooledString const &text	-	the string		(IN)
+ * returnvalue@ output stream with the string
+ */
+ostream& operator<< (ostream &stream, CPooledString const &text)
+{
+	stream.write(text.data(), text.size());
+
+	return stream;
+}
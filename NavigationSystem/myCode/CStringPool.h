@@ -0,0 +1,385 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CStringPool.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines the classes CStringPool and
+* 					CPooledString.
+* 					The class CStringPool keeps one copy of every string
+* 					it is given (interning) and identifies it by a
+* 					number. The strings are spread over shards with a
+* 					lock each, so that threads which add strings at the
+* 					same time, e.g. the CSV parser, rarely wait for each
+* 					other. The characters are packed one after the other
+* 					into chunks, a string never moves once it is
+* 					in the pool and is never removed. Only the additions
+* 					intern a string: a look-up by name uses find(), a name
+* 					which is not in the pool is not added to it.
+* 					The class CPooledString is the handle of a string of
+* 					the pool: it takes 4 bytes, two handles are equal if
+* 					their numbers are equal. The names and descriptions
+* 					of the Waypoints and POIs and the keys of the
+* 					databases are pooled strings, so that a name is kept
+* 					only once however often it is used. With the
+* 					HASH_TABLE storage of the databases a look-up by name
+* 					then compares numbers only; the NAME_ORDER and
+* 					MORTON_ORDER storages keep the names in alphabetical
+* 					order and still compare their characters.
+*
+****************************************************************************/
+
+#ifndef CSTRINGPOOL_H
+#define CSTRINGPOOL_H
+
+//System Include Files
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+
+class CStringPool {
+public:
+
+	typedef uint32_t			String_Id_t;
+
+	/**
+	 * Number of the empty string; it is always in the pool
+	 */
+	static const String_Id_t	EMPTY_STRING = 0;
+
+	/**
+	 * Result of find() for a string which is not in the pool and of intern() for a string
+	 * which the full pool cannot take; never the number of a string
+	 */
+	static const String_Id_t	NOT_FOUND = 0xFFFFFFFF;
+
+	/**
+	 * The pool of the program
+	 * returnvalue@ CStringPool&		-	the pool
+	 */
+	static CStringPool& getInstance();
+
+	/**
+	 * Get the number of a string, the string is added to the pool if it is not yet in it.
+	 * The method may be called by several threads at the same time.
+	 * param@ char const *pChars		-	characters of the string	(IN)
+	 * param@ size_t length				-	number of characters		(IN)
+	 * returnvalue@ String_Id_t			-	number of the string, NOT_FOUND if the pool is full
+	 */
+	String_Id_t intern(char const *pChars, size_t length);
+
+	/**
+	 * Get the number of a string without adding it to the pool, e.g. to look a name up.
+	 * The method may be called by several threads at the same time, it takes no lock.
+	 * param@ char const *pChars		-	characters of the string	(IN)
+	 * param@ size_t length				-	number of characters		(IN)
+	 * returnvalue@ String_Id_t			-	number of the string, NOT_FOUND if it is not in the pool
+	 */
+	String_Id_t find(char const *pChars, size_t length) const;
+
+	/**
+	 * Get the characters of a string, terminated by '\0'
+	 * param@ String_Id_t id			-	number of the string		(IN)
+	 * returnvalue@ char const*			-	characters of the string
+	 */
+	char const* getChars(String_Id_t id) const;
+
+	/**
+	 * Get the number of characters of a string
+	 * param@ String_Id_t id			-	number of the string		(IN)
+	 * returnvalue@ size_t				-	number of characters
+	 */
+	size_t getLength(String_Id_t id) const;
+
+	/**
+	 * Get the number of strings in the pool, the empty string included
+	 * returnvalue@ size_t				-	number of strings
+	 */
+	size_t getStringCount() const;
+
+	/**
+	 * Get the memory held by the pool: characters, string table and hash table
+	 * returnvalue@ size_t				-	bytes
+	 */
+	size_t getMemoryUsage() const;
+
+private:
+
+	/**
+	 * A string of the pool
+	 */
+	struct Entry
+	{
+		char const	*pChars;
+		uint32_t	length;
+		uint32_t	hash;
+	};
+
+	/**
+	 * The strings are spread over SHARD_COUNT shards by their hash; every shard has a lock of
+	 * its own, so threads which add different strings rarely wait for each other. The number
+	 * of a string holds its shard in the low SHARD_BITS bits and its number within the shard above them
+	 */
+	static const unsigned int	SHARD_BITS 		= 4;
+	static const unsigned int	SHARD_COUNT 	= 1u << SHARD_BITS;
+
+	/**
+	 * The entries of a shard are kept in blocks which never move: reading a string needs no lock
+	 */
+	static const unsigned int	BLOCK_BITS 		= 12;
+	static const unsigned int	BLOCK_SIZE 		= 1u << BLOCK_BITS;
+	static const unsigned int	BLOCK_COUNT 	= 4096;
+	static const size_t			CHUNK_SIZE 		= 64 * 1024;
+
+	/**
+	 * A slot of the hash table holds the number of a string in its low ID_BITS bits and the top
+	 * bits of the hash of the string above them: most of the strings probed on the way are
+	 * skipped without reading their entry
+	 */
+	static const unsigned int	ID_BITS 		= 28;
+	static const String_Id_t	ID_MASK 		= (1u << ID_BITS) - 1;
+
+	/**
+	 * Hash table (linear probing) of the numbers and hash tags of the strings; EMPTY_STRING marks a free slot.
+	 * A slot is written once, under the lock, after the entry of its string: it is read without the lock
+	 */
+	struct Table
+	{
+		std::vector<std::atomic<String_Id_t> >	slots;
+
+		explicit Table(size_t size) : slots(size)
+		{
+		}
+	};
+
+	/**
+	 * A part of the pool with its own strings, characters, hash table and lock; aligned to a
+	 * cache line, so that the locks of two shards do not share one
+	 */
+	struct alignas(64) Shard
+	{
+		/**
+		 * Entry blocks, BLOCK_COUNT pointers allocated once
+		 */
+		std::vector<Entry *>		blocks;
+
+		/**
+		 * Number of strings in the shard
+		 */
+		std::atomic<String_Id_t>	count;
+
+		/**
+		 * Chunks of characters; the unused rest of the last chunk
+		 */
+		std::vector<char *>			chunks;
+		char						*pFree;
+		size_t						freeLength;
+		size_t						charBytes;
+
+		/**
+		 * The hash tables; the last one is in use and published in pTable. A table which
+		 * was grown is kept with the pool: a look-up may still probe it
+		 */
+		std::vector<Table *>		tables;
+		std::atomic<Table const *>	pTable;
+
+		/**
+		 * Serializes the additions to the shard, which may grow its hash table
+		 */
+		mutable std::mutex			mutex;
+	};
+
+	/**
+	 * The shards; the empty string is the first string of the first shard
+	 */
+	Shard						m_shards[SHARD_COUNT];
+
+	/**
+	 * CStringPool constructor: the pool holds the empty string
+	 */
+	CStringPool();
+
+	/**
+	 * CStringPool destructor
+	 */
+	~CStringPool();
+
+	/**
+	 * The pool cannot be copied
+	 */
+	CStringPool(CStringPool const &origin);
+	CStringPool& operator=(CStringPool const &rhs);
+
+	/**
+	 * Get the entry of a string
+	 */
+	Entry const& getEntry(String_Id_t id) const;
+
+	/**
+	 * Hash of the characters of a string (FNV-1a)
+	 */
+	static uint32_t hashChars(char const *pChars, size_t length);
+
+	/**
+	 * Shard of a string: taken from all the bits of the hash, the slots and the tags of the shard
+	 * still use every value
+	 */
+	static unsigned int getShard(uint32_t hash);
+
+	/**
+	 * Find the slot of a string in a hash table: the slot which holds it or the free
+	 * slot where it is to be added, and the value read from it
+	 */
+	size_t findSlot(Table const &table, char const *pChars, size_t length, uint32_t hash, String_Id_t &value) const;
+
+	/**
+	 * Copy characters into the chunks of a shard, terminated by '\0'
+	 */
+	static char const* storeChars(Shard &shard, char const *pChars, size_t length);
+
+	/**
+	 * Double the hash table of a shard
+	 */
+	void growTable(unsigned int shardIndex);
+};
+/********************
+**  CLASS END
+*********************/
+
+
+class CPooledString {
+public:
+
+	/**
+	 * CPooledString constructor: the empty string
+	 */
+	CPooledString();
+
+	/**
+	 * CPooledString constructor: the string is added to the pool. If the pool is full the
+	 * string is the empty string, which a Waypoint or a POI rejects as name; a loader which
+	 * must not lose a string uses intern()
+	 * param@ std::string const &text	-	the string	(IN)
+	 */
+	CPooledString(std::string const &text);
+	CPooledString(char const *pText);
+
+	/**
+	 * CPooledString constructor: the characters are added to the pool, e.g. a string read in place from a file
+	 * param@ char const *pChars		-	characters of the string	(IN)
+	 * param@ size_t length				-	number of characters		(IN)
+	 */
+	CPooledString(char const *pChars, size_t length);
+
+	/**
+	 * Get the pooled string with the given characters, the string is added to the pool if it is not yet in it
+	 * param@ std::string_view text		-	the string			(IN)
+	 * param@ CPooledString &pooled		-	the pooled string	(OUT)
+	 * returnvalue@ bool				-	false if the pool is full
+	 */
+	static bool intern(std::string_view text, CPooledString &pooled);
+
+	/**
+	 * Get the pooled string with the given characters without adding it to the pool,
+	 * e.g. to look a name up in a database
+	 * param@ std::string_view text		-	the string			(IN)
+	 * param@ CPooledString &pooled		-	the pooled string	(OUT)
+	 * returnvalue@ bool				-	false if the string is not in the pool
+	 */
+	static bool find(std::string_view text, CPooledString &pooled);
+
+	/**
+	 * Get the number of the string in the pool
+	 * returnvalue@ CStringPool::String_Id_t	-	number of the string
+	 */
+	CStringPool::String_Id_t getId() const;
+
+	/**
+	 * Get a copy of the string
+	 * returnvalue@ std::string			-	the string
+	 */
+	std::string str() const;
+	operator std::string() const;
+
+	/**
+	 * Get the characters of the string, terminated by '\0'
+	 * returnvalue@ char const*			-	characters of the string
+	 */
+	char const* data() const;
+	char const* c_str() const;
+
+	/**
+	 * Get the characters of the string without a copy, e.g. for a look-up by name
+	 * returnvalue@ std::string_view	-	the string
+	 */
+	operator std::string_view() const;
+
+	/**
+	 * Get the number of characters of the string
+	 * returnvalue@ size_t				-	number of characters
+	 */
+	size_t size() const;
+
+	/**
+	 * Check if the string is empty
+	 * returnvalue@ bool				-	true for the empty string
+	 */
+	bool empty() const;
+
+	/**
+	 * Compare the characters of two strings like std::string::compare
+	 * param@ CPooledString const &other	-	string to compare with	(IN)
+	 * returnvalue@ int				-	<0, 0 or >0
+	 */
+	int compare(CPooledString const &other) const;
+
+	/**
+	 * Equal strings have equal numbers: an integer comparison
+	 */
+	bool operator==(CPooledString const &rhs) const;
+	bool operator!=(CPooledString const &rhs) const;
+
+	/**
+	 * Order of the characters, like std::string
+	 */
+	bool operator<(CPooledString const &rhs) const;
+
+	/**
+	 * An operator overloaded friend function which prints the string
+	 * param@ ostream &stream				-	output stream	(IN/OUT)
+	 * param@ CPooledString const &text	-	the string		(IN)
+	 * returnvalue@ output stream with the string
+	 */
+	friend std::ostream& operator<< (std::ostream &stream, CPooledString const &text);
+
+private:
+
+	/**
+	 * Number of the string in the pool
+	 */
+	CStringPool::String_Id_t	m_id;
+};
+/********************
+**  CLASS END
+*********************/
+
+
+/**
+ * The hash of a pooled string is its number, e.g. for the CHashStorage
+ */
+namespace std
+{
+	template<>
+	struct hash<CPooledString>
+	{
+		size_t operator()(CPooledString const &text) const
+		{
+			return text.getId();
+		}
+	};
+}
+#endif /* CSTRINGPOOL_H */
@@ -0,0 +1,108 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CSyntheticGPSProvider.cpp
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines all the methods pertaining to the
+* 					class type - class CSyntheticGPSProvider.
+*
+****************************************************************************/
+
+//System Include Files
+#include <cmath>
+
+//Own Include Files
+#include "CSyntheticGPSProvider.h"
+#include "CWaypoint.h"
+
+//Namespaces
+using namespace std;
+
+//Macros
+// standard deviation of the change of the heading per fix, radians
+#define SYNTHETIC_TURN_SIGMA		0.1
+
+//Method Implementations
+/**
+ * CSyntheticGPSProvider constructor
+ * @param latitude start of the trace in degrees
+ * @param longitude start of the trace in degrees
+ * @param fixCount number of fixes of the trace
+ * @param step distance between two fixes in KMs, one fix per second
+ * @param seed of the random generator
+ */
+CSyntheticGPSProvider::CSyntheticGPSProvider(double latitude, double longitude, unsigned int fixCount, double step, unsigned int seed)
+	: m_turn(0.0, SYNTHETIC_TURN_SIGMA)
+{
+	this->m_startLatitude 	= latitude;
+	this->m_startLongitude 	= longitude;
+	this->m_fixCount 		= fixCount;
+	this->m_step 			= step;
+	this->m_seed 			= seed;
+
+	this->open();
+}
+
+
+/**
+ * Start the trace again
+ * @return true
+ */
+bool CSyntheticGPSProvider::open()
+{
+	this->m_latitude 	= this->m_startLatitude;
+	this->m_longitude 	= this->m_startLongitude;
+	this->m_fixIndex 	= 0;
+
+	this->m_generator.seed(this->m_seed);
+	this->m_turn.reset();
+
+	this->m_heading 	= 2 * M_PI * generate_canonical<double, 32>(this->m_generator);
+
+	return true;
+}
+
+
+/**
+ * Generate the next fix
+ * @param fix the next position
+ * @return false when all the fixes were generated
+ */
+bool CSyntheticGPSProvider::readFix(CGPSFix &fix)
+{
+	if (this->m_fixIndex >= this->m_fixCount)
+	{
+		return false;
+	}
+
+	fix.time 		= this->m_fixIndex;
+	fix.latitude 	= this->m_latitude;
+	fix.longitude 	= this->m_longitude;
+
+	this->m_fixIndex++;
+
+	// drive the step along the heading on the sphere, then turn
+	double angle 	= this->m_step / EARTH_RADIUS_KM;
+
+	this->m_latitude 	+= angle * cos(this->m_heading) / DEG_TO_RAD;
+	this->m_longitude 	+= angle * sin(this->m_heading) / (cos(this->m_latitude * DEG_TO_RAD) * DEG_TO_RAD);
+	this->m_heading 	+= this->m_turn(this->m_generator);
+
+	// the vehicle turns back before the pole and wraps around at the date line
+	if (fabs(this->m_latitude) > 85)
+	{
+		this->m_latitude 	= copysign(85.0, this->m_latitude);
+		this->m_heading 	+= M_PI;
+	}
+
+	if (this->m_longitude > LONGITUDE_MAX)
+	{
+		this->m_longitude -= 360;
+	}
+	else if (this->m_longitude < LONGITUDE_MIN)
+	{
+		this->m_longitude += 360;
+	}
+
+	return true;
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+*============= Copyright by Darmstadt University of Applied Sciences =======
+****************************************************************************
+* Filename        : CSyntheticGPSProvider.h
+* Author          : Bharath Ramachandraiah
+* Description     : The file defines a class CSyntheticGPSProvider.
+* 					The class CSyntheticGPSProvider generates the trace of
+* 					a vehicle which drives a fixed distance per fix and
+* 					turns a little at random (random walk of the heading).
+* 					The same seed gives the same trace.
+*
+****************************************************************************/
+
+#ifndef CSYNTHETICGPSPROVIDER_H
+#define CSYNTHETICGPSPROVIDER_H
+
+//System Include Files
+#include <random>
+
+//Own Include Files
+#include "CGPSProvider.h"
+
+class CSyntheticGPSProvider : public CGPSProvider {
+public:
+
+	/**
+	 * CSyntheticGPSProvider constructor
+	 * @param latitude start of the trace in degrees
+	 * @param longitude start of the trace in degrees
+	 * @param fixCount number of fixes of the trace
+	 * @param step distance between two fixes in KMs, one fix per second
+	 * @param seed of the random generator
+	 */
+	CSyntheticGPSProvider(double latitude, double longitude, unsigned int fixCount, double step = 0.02, unsigned int seed = 1);
+
+	/**
+	 * Start the trace again
+	 * @return true
+	 */
+	bool open();
+
+	/**
+	 * Generate the next fix
+	 * @param fix the next position
+	 * @return false when all the fixes were generated
+	 */
+	bool readFix(CGPSFix &fix);
+
+private:
+
+	double									m_startLatitude;
+	double									m_startLongitude;
+	unsigned int							m_fixCount;
+	double									m_step;
+	unsigned int							m_seed;
+
+	/**
+	 * The vehicle: position in degrees, heading in radians (0 = north)
+	 */
+	double									m_latitude;
+	double									m_longitude;
+	double									m_heading;
+	unsigned int							m_fixIndex;
+
+	std::mt19937							m_generator;
+	std::normal_distribution<double>		m_turn;
+};
+/********************
+**  CLASS END
+*********************/
+#endif /* CSYNTHETICGPSPROVIDER_H */
@@ -16,11 +16,6 @@
 //Own Include Files
 #include "CWaypoint.h"
 
-//Macros
-#define PI_VALUE						(atan(1) * 4)
-#define degToRad(angleInDegrees) 		((angleInDegrees) * PI_VALUE / 180.0)
-#define radToDeg(angleInRadians) 		((angleInRadians) * 180.0 / PI_VALUE)
-
 //Namespaces
 using namespace std;
 
@@ -28,17 +23,26 @@ using namespace std;
 /**
  * CWaypoint constructor:
  * Sets the value of any object when created
- * param@ string name		-	name of a Waypoint 		(IN)
+ * param@ CPooledString name	-	name of a Waypoint 		(IN)
+ * param@ double latitude	-	latitude of a Waypoint 	(IN)
+ * param@ double longitude	-	longitude of a Waypoint (IN)
+ */
+CWaypoint::CWaypoint(CPooledString name, double latitude, double longitude) : CWaypoint(name, latitude, longitude, CWaypoint::WAYPOINT)
+{
+}
+
+
+/**
+ * CWaypoint constructor for the derived classes, which give their type tag
+ * param@ CPooledString name	-	name of a Waypoint 		(IN)
  * param@ double latitude	-	latitude of a Waypoint 	(IN)
  * param@ double longitude	-	longitude of a Waypoint (IN)
  * param@ wp_type type		-	type of data the object represents:
- * 								POI / Waypoint / Invalid(IN)
+ * 								POI / Waypoint			(IN)
  */
-CWaypoint::CWaypoint(string name, double latitude, double longitude, wp_type type)
+CWaypoint::CWaypoint(CPooledString name, double latitude, double longitude, wp_type type)
 {
-	if (((latitude >= LATITUDE_MIN) && (latitude <= LATITUDE_MAX)) &&
-			((longitude >= LONGITUDE_MIN) && (longitude <= LONGITUDE_MAX)) &&
-			(!name.empty()))
+	if (isValidPosition(latitude, longitude) && (!name.empty()))
 	{
 		// All the parameters values are valid; we can assign these values to the respective data members of the class
 		this->m_name 		= name;
@@ -48,12 +52,15 @@ CWaypoint::CWaypoint(string name, double latitude, double longitude, wp_type typ
 	}
 	else
 	{
-		// some of the parameters values are invalid, hence set the values default to 0
+		// some of the parameters values are invalid, hence set the values default to 0;
+		// a POI keeps its tag, it is still a CPOI
 		this->m_name 		= "";
 		this->m_latitude 	= 0;
 		this->m_longitude 	= 0;
-		this->m_type	 	= CWaypoint::INVALID;
+		this->m_type	 	= (type == CWaypoint::POI) ? CWaypoint::POI : CWaypoint::INVALID;
 	}
+
+	this->cacheTrigonometry();
 }
 
 
@@ -71,6 +78,17 @@ CWaypoint::~CWaypoint()
  * retuvalue@ string name	-	name of a Waypoint
  */
 string CWaypoint::getName() const
+{
+	return (this->m_name.str());
+}
+
+
+/**
+ * Return the current waypoint co-ordinate name as a string of the pool,
+ * e.g. to compare it with a key of the database by its number
+ * retuvalue@ CPooledString const&	-	name of a Waypoint
+ */
+CPooledString const& CWaypoint::getPooledName() const
 {
 	return (this->m_name);
 }
@@ -80,7 +98,7 @@ string CWaypoint::getName() const
  * Return the current waypoint latitude
  * returnvalue@ double latitude	-	latitude of a Waypoint
  */
-double CWaypoint::getLatitude()
+double CWaypoint::getLatitude() const
 {
 	return (this->m_latitude);
 }
@@ -90,12 +108,55 @@ double CWaypoint::getLatitude()
  * Return the current waypoint longitude
  * returnvalue@ double longitude-	longitude of a Waypoint
  */
-double CWaypoint::getLongitude()
+double CWaypoint::getLongitude() const
 {
 	return (this->m_longitude);
 }
 
 
+/**
+ * Return the current waypoint latitude in radians
+ * returnvalue@ double			-	latitude of a Waypoint in radians
+ */
+double CWaypoint::getLatitudeRad() const
+{
+	return (this->m_latitudeRad);
+}
+
+
+/**
+ * Return the current waypoint longitude in radians
+ * returnvalue@ double			-	longitude of a Waypoint in radians
+ */
+double CWaypoint::getLongitudeRad() const
+{
+	return (this->m_longitudeRad);
+}
+
+
+/**
+ * Return the cosine of the current waypoint latitude
+ * returnvalue@ double			-	cos(latitude)
+ */
+double CWaypoint::getCosLatitude() const
+{
+	return (this->m_cosLatitude);
+}
+
+
+/**
+ * Return the position of the waypoint on the unit sphere (earth centered, earth fixed)
+ * param@ double coord[3]		-	x, y, z			(OUT)
+ * returnvalue@ void
+ */
+void CWaypoint::getUnitVector(double coord[3]) const
+{
+	coord[0] = this->m_unitVector[0];
+	coord[1] = this->m_unitVector[1];
+	coord[2] = this->m_unitVector[2];
+}
+
+
 /**
  * Return the current waypoint co-ordinate values
  * param@ string& name		-	name of a Waypoint		(OUT)
@@ -103,7 +164,7 @@ double CWaypoint::getLongitude()
  * param@ double& longitude	-	longitude of a Waypoint (OUT)
  * returnvalue@ void
  */
-void CWaypoint::getAllDataByReference(string& name, double& latitude, double& longitude)
+void CWaypoint::getAllDataByReference(string& name, double& latitude, double& longitude) const
 {
 	name 		= this->getName();
 	latitude 	= this->getLatitude();
@@ -167,16 +228,29 @@ void CWaypoint::transformLongitude2degmmss(int& deg, int& mm, double& ss)
 
 /**
  * Return the distance between 2 waypoint co-ordinates
- * param@ const CWaypoint& wp	-	Waypoint co-ordinate (IN)
- * returnvalue@ double			- 	Distance in KMs
+ * param@ const CWaypoint& wp			-	Waypoint co-ordinate (IN)
+ * param@ t_distance_model model		-	model of the earth, HAVERSINE by default (IN)
+ * returnvalue@ double					- 	Distance in KMs
  */
-double CWaypoint::calculateDistance(const CWaypoint& wp)
+double CWaypoint::calculateDistance(const CWaypoint& wp, t_distance_model model)
 {
 	double distance = 0;
 
-	// distance in a spherical co-ordinate system
-	distance = 6378.17 * (acos(sin(degToRad(this->m_latitude)) * sin(degToRad(wp.m_latitude)) + 		\
-						 cos(degToRad(this->m_latitude)) * cos(degToRad(wp.m_latitude)) * cos(degToRad(wp.m_longitude - this->m_longitude))));
+	switch (model)
+	{
+	case VINCENTY:
+		distance = this->calculateVincentyDistance(wp);
+		break;
+
+	case EQUIRECTANGULAR:
+		distance = this->calculateEquirectangularDistance(wp);
+		break;
+
+	case HAVERSINE:
+	default:
+		distance = this->calculateHaversineDistance(wp);
+		break;
+	}
 
 	return distance;
 }
@@ -240,3 +314,124 @@ ostream& operator<< (ostream &stream, CWaypoint const &wp)
 
 	return stream;
 }
+
+
+/**
+ * Fill the cached trigonometry of the position
+ * returnvalue@ void
+ */
+void CWaypoint::cacheTrigonometry()
+{
+	this->m_latitudeRad 	= this->m_latitude * DEG_TO_RAD;
+	this->m_longitudeRad 	= this->m_longitude * DEG_TO_RAD;
+	this->m_cosLatitude 	= cos(this->m_latitudeRad);
+
+	this->m_unitVector[0] 	= this->m_cosLatitude * cos(this->m_longitudeRad);
+	this->m_unitVector[1] 	= this->m_cosLatitude * sin(this->m_longitudeRad);
+	this->m_unitVector[2] 	= sin(this->m_latitudeRad);
+}
+
+
+/**
+ * Great circle distance on the sphere of radius EARTH_RADIUS_KM
+ */
+double CWaypoint::calculateHaversineDistance(const CWaypoint& wp) const
+{
+	double const *a = this->m_unitVector, *b = wp.m_unitVector;
+
+	// angle between the positions on the unit sphere; atan2 stays accurate for short and antipodal distances
+	double cross[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+	double dot		= a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+
+	return EARTH_RADIUS_KM * atan2(sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot);
+}
+
+
+/**
+ * Geodesic distance on the WGS84 ellipsoid (Vincenty's inverse formula)
+ */
+double CWaypoint::calculateVincentyDistance(const CWaypoint& wp) const
+{
+	const double	a = WGS84_SEMI_MAJOR_KM, f = WGS84_FLATTENING, b = a * (1 - f);
+	const double	PI = 3.14159265358979323846;
+
+	double L		= wp.m_longitudeRad - this->m_longitudeRad;
+	double U1		= atan((1 - f) * tan(this->m_latitudeRad));
+	double U2		= atan((1 - f) * tan(wp.m_latitudeRad));
+	double sinU1	= sin(U1), cosU1 = cos(U1);
+	double sinU2	= sin(U2), cosU2 = cos(U2);
+
+	double lambda = L, sinSigma = 0, cosSigma = 1, sigma = 0, cos2Alpha = 1, cos2SigmaM = 0;
+
+	for (unsigned int iteration = 0; iteration < 100; ++iteration)
+	{
+		double sinLambda	= sin(lambda), cosLambda = cos(lambda);
+		double crossTerm	= cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+
+		sinSigma = sqrt((cosU2 * sinLambda) * (cosU2 * sinLambda) + crossTerm * crossTerm);
+
+		if (sinSigma == 0)
+		{
+			// coincident points
+			return 0;
+		}
+
+		cosSigma 		= sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+		sigma 			= atan2(sinSigma, cosSigma);
+
+		double sinAlpha	= cosU1 * cosU2 * sinLambda / sinSigma;
+
+		cos2Alpha 		= 1 - sinAlpha * sinAlpha;
+		cos2SigmaM 		= (cos2Alpha != 0) ? (cosSigma - 2 * sinU1 * sinU2 / cos2Alpha) : 0;	// 0 on the equator
+
+		double C			= f / 16 * cos2Alpha * (4 + f * (4 - 3 * cos2Alpha));
+		double lambdaPrev	= lambda;
+
+		lambda = L + (1 - C) * f * sinAlpha * (sigma + C * sinSigma * (cos2SigmaM + C * cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM)));
+
+		if (fabs(lambda - lambdaPrev) < 1e-12)
+		{
+			double u2		= cos2Alpha * (a * a - b * b) / (b * b);
+			double A		= 1 + u2 / 16384 * (4096 + u2 * (-768 + u2 * (320 - 175 * u2)));
+			double B		= u2 / 1024 * (256 + u2 * (-128 + u2 * (74 - 47 * u2)));
+			double dSigma	= B * sinSigma * (cos2SigmaM + B / 4 * (cosSigma * (-1 + 2 * cos2SigmaM * cos2SigmaM) -
+								B / 6 * cos2SigmaM * (-3 + 4 * sinSigma * sinSigma) * (-3 + 4 * cos2SigmaM * cos2SigmaM)));
+
+			return b * A * (sigma - dSigma);
+		}
+
+		if (fabs(lambda) > PI)
+		{
+			// diverges for nearly antipodal points
+			break;
+		}
+	}
+
+	return this->calculateHaversineDistance(wp);
+}
+
+
+/**
+ * Flat projection around the mean latitude, using the cached cosines
+ */
+double CWaypoint::calculateEquirectangularDistance(const CWaypoint& wp) const
+{
+	const double PI = 3.14159265358979323846;
+
+	double dLongitude	= wp.m_longitudeRad - this->m_longitudeRad;
+	double dLatitude	= wp.m_latitudeRad - this->m_latitudeRad;
+
+	// the short way across the date line
+	if (dLongitude > PI)
+	{
+		dLongitude -= 2 * PI;
+	}
+	else if (dLongitude < -PI)
+	{
+		dLongitude += 2 * PI;
+	}
+
+	double x = dLongitude * 0.5 * (this->m_cosLatitude + wp.m_cosLatitude);
+
+	return EARTH_RADIUS_KM * sqrt(x * x + dLatitude * dLatitude);
+}
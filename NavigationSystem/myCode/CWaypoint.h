@@ -16,8 +16,11 @@
 //System Include Files
 #include <string>
 #include <ostream>
+#include <type_traits>
 
 //Own Include Files
+#include "CStringPool.h"
+#include "CArena.h"
 
 //Macros
 #define DEGREE					1
@@ -28,6 +31,18 @@
 #define LONGITUDE_MIN			(-180)
 #define LONGITUDE_MAX			(+180)
 
+#define EARTH_RADIUS_KM			6378.17
+#define DEG_TO_RAD				(3.14159265358979323846 / 180.0)
+
+// WGS84 ellipsoid
+#define WGS84_SEMI_MAJOR_KM		6378.137
+#define WGS84_FLATTENING		(1 / 298.257223563)
+
+// the ellipsoidal distance divided by the great circle distance on the sphere of radius EARTH_RADIUS_KM
+// lies between the smallest and the largest radius of curvature of the ellipsoid, divided by that radius
+#define ELLIPSOID_RATIO_MIN		0.9933
+#define ELLIPSOID_RATIO_MAX		1.0034
+
 
 class CWaypoint {
 public:
@@ -39,38 +54,117 @@ public:
 		INVALID,
 	};
 
+	/**
+	 * Models of the earth for the distance calculation
+	 * VINCENTY			-	geodesic on the WGS84 ellipsoid (Vincenty's inverse formula);
+	 * 						error below 1 mm, 10 to 20 times the cost of HAVERSINE.
+	 * 						Nearly antipodal points where it does not converge use HAVERSINE.
+	 * HAVERSINE		-	great circle on a sphere of radius EARTH_RADIUS_KM;
+	 * 						within -0.7% / +0.4% of VINCENTY (ELLIPSOID_RATIO_MIN / MAX).
+	 * EQUIRECTANGULAR	-	flat projection around the mean latitude, no trigonometry;
+	 * 						within 0.1% of HAVERSINE below 100 km and 70 degrees latitude,
+	 * 						the error grows with the distance and the latitude: pre-filtering only.
+	 */
+	enum t_distance_model
+	{
+		VINCENTY,
+		HAVERSINE,
+		EQUIRECTANGULAR,
+	};
+
 	/**
 	 * CWaypoint constructor:
 	 * Sets the value of an object when created.
-	 * param@ string name		-	name of a Waypoint, default value ""	(IN)
+	 * param@ CPooledString name	-	name of a Waypoint, default value ""	(IN)
 	 * param@ double latitude	-	latitude of a Waypoint, default value 0	(IN)
 	 * param@ double longitude	-	longitude of a Waypoint,default value 0	(IN)
-	 * param@ wp_type type		-	Type of data - POI / Waypoint, default invalid (IN)
 	 */
-	CWaypoint(std::string name = "", double latitude = 0, double longitude = 0, wp_type type = WAYPOINT);
+	CWaypoint(CPooledString name = CPooledString(), double latitude = 0, double longitude = 0);
 
 	/**
 	 * Destructor
 	 */
 	virtual ~CWaypoint();
 
+	/**
+	 * Copy and move: a moved Waypoint hands over its name, e.g. when it is loaded into a database
+	 */
+	CWaypoint(CWaypoint const &origin) = default;
+	CWaypoint(CWaypoint &&origin) = default;
+	CWaypoint& operator=(CWaypoint const &rhs) = default;
+	CWaypoint& operator=(CWaypoint &&rhs) = default;
+
 	/**
 	 * Return the current waypoint co-ordinate name
 	 * retuvalue@ string name	-	name of a Waypoint
 	 */
 	std::string getName() const;
 
+	/**
+	 * Return the current waypoint co-ordinate name as a string of the pool,
+	 * e.g. to compare it with a key of the database by its number
+	 * retuvalue@ CPooledString const&	-	name of a Waypoint
+	 */
+	CPooledString const& getPooledName() const;
+
+	/**
+	 * Return the type of the object without RTTI: WAYPOINT, POI (the object is a CPOI)
+	 * or INVALID (the values given to the constructor of a Waypoint were rejected;
+	 * a POI keeps its type, see isValid)
+	 * returnvalue@ wp_type			-	type of the object
+	 */
+	wp_type getType() const;
+
+	/**
+	 * Check if the values given to the constructor were accepted, for a Waypoint and a POI
+	 * returnvalue@ bool			-	false if they were rejected
+	 */
+	bool isValid() const;
+
+	/**
+	 * Check if a position is on the earth: the latitude within +-90 and the longitude within +-180 degrees
+	 * param@ double latitude		-	latitude of the position	(IN)
+	 * param@ double longitude		-	longitude of the position	(IN)
+	 * returnvalue@ bool			-	false if a coordinate is out of range
+	 */
+	static bool isValidPosition(double latitude, double longitude);
+
 	/**
 	 * Return the current waypoint latitude
 	 * returnvalue@ double latitude	-	latitude of a Waypoint
 	 */
-	double getLatitude();
+	double getLatitude() const;
 
 	/**
 	 * Return the current waypoint longitude
 	 * returnvalue@ double longitude-	longitude of a Waypoint
 	 */
-	double getLongitude();
+	double getLongitude() const;
+
+	/**
+	 * Return the current waypoint latitude in radians
+	 * returnvalue@ double			-	latitude of a Waypoint in radians
+	 */
+	double getLatitudeRad() const;
+
+	/**
+	 * Return the current waypoint longitude in radians
+	 * returnvalue@ double			-	longitude of a Waypoint in radians
+	 */
+	double getLongitudeRad() const;
+
+	/**
+	 * Return the cosine of the current waypoint latitude
+	 * returnvalue@ double			-	cos(latitude)
+	 */
+	double getCosLatitude() const;
+
+	/**
+	 * Return the position of the waypoint on the unit sphere (earth centered, earth fixed)
+	 * param@ double coord[3]		-	x, y, z			(OUT)
+	 * returnvalue@ void
+	 */
+	void getUnitVector(double coord[3]) const;
 
 	/**
 	 * Return the current waypoint co-ordinate values
@@ -79,7 +173,7 @@ public:
 	 * param@ double& longitude	-	longitude of a Waypoint (OUT)
 	 * returnvalue@ void
 	 */
-	void getAllDataByReference(std::string& name, double& latitude, double& longitude);
+	void getAllDataByReference(std::string& name, double& latitude, double& longitude) const;
 
 	/**
 	 * Converts the Latitude in decimal to deg-min-sec format
@@ -101,10 +195,11 @@ public:
 
 	/**
 	 * Return the distance between 2 waypoint co-ordinates
-	 * param@ const CWaypoint& wp	-	Waypoint co-ordinate (IN)
-	 * returnvalue@ double			- 	Distance in KMs
+	 * param@ const CWaypoint& wp			-	Waypoint co-ordinate (IN)
+	 * param@ t_distance_model model		-	model of the earth, HAVERSINE by default (IN)
+	 * returnvalue@ double					- 	Distance in KMs
 	 */
-	double calculateDistance(const CWaypoint& wp);
+	double calculateDistance(const CWaypoint& wp, t_distance_model model = HAVERSINE);
 
 	/**
 	 * Prints the waypoint values in Degree-Mins-secs format or Decimal format
@@ -121,13 +216,30 @@ public:
 	 */
 	friend std::ostream& operator<< (std::ostream &stream, CWaypoint const &wp);
 
+protected:
+
+	/**
+	 * CWaypoint constructor for the derived classes, which give their type tag:
+	 * only a CPOI may be tagged POI, the tag is what CPOI::castFrom checks
+	 * param@ CPooledString name	-	name of a Waypoint						(IN)
+	 * param@ double latitude	-	latitude of a Waypoint					(IN)
+	 * param@ double longitude	-	longitude of a Waypoint					(IN)
+	 * param@ wp_type type		-	Type of data - POI / Waypoint			(IN)
+	 */
+	CWaypoint(CPooledString name, double latitude, double longitude, wp_type type);
+
 private:
 
 	/*
 	 * A name for the waypoint.
 	 * eg: Berlin, California, Rio, Sydney etc
 	 */
-	std::string 	m_name;
+	CPooledString 	m_name;
+
+	/**
+	 * The type of data - POI or Waypoint
+	 */
+	wp_type			m_type;
 
 	/**
 	 * The latitude value of a co-ordinate
@@ -140,11 +252,74 @@ private:
 	double 			m_longitude;
 
 	/**
-	 * The type of data - POI or Waypoint
+	 * The latitude and longitude in radians and cos(latitude), cached as the position never changes
 	 */
-	wp_type			m_type;
+	double			m_latitudeRad;
+	double			m_longitudeRad;
+	double			m_cosLatitude;
+
+	/**
+	 * The position on the unit sphere: x, y, z (z = sin(latitude))
+	 */
+	double			m_unitVector[3];
+
+	/**
+	 * Fill the cached trigonometry of the position
+	 * returnvalue@ void
+	 */
+	void cacheTrigonometry();
+
+	/**
+	 * Distance models, see t_distance_model
+	 */
+	double calculateHaversineDistance(const CWaypoint& wp) const;
+	double calculateVincentyDistance(const CWaypoint& wp) const;
+	double calculateEquirectangularDistance(const CWaypoint& wp) const;
 };
 /********************
 **  CLASS END
 *********************/
+
+/**
+ * The destructor may be skipped when a database releases all its memory at once:
+ * the Waypoint owns no memory: its name is a string of the pool
+ */
+template<>
+struct CArenaTraits<CWaypoint>
+{
+	static_assert(std::is_trivially_destructible<CPooledString>::value, "the name of a Waypoint must own no memory");
+
+	static const bool	CAN_SKIP_DESTRUCTOR = true;
+};
+
+
+/**
+ * Return the type of the object without RTTI; inline, it is read for every element of a scan
+ * returnvalue@ wp_type			-	type of the object
+ */
+inline CWaypoint::wp_type CWaypoint::getType() const
+{
+	return this->m_type;
+}
+
+
+/**
+ * Check if the values given to the constructor were accepted: a rejected name is cleared
+ * returnvalue@ bool			-	false if they were rejected
+ */
+inline bool CWaypoint::isValid() const
+{
+	return !this->m_name.empty();
+}
+
+
+/**
+ * Check if a position is on the earth: the latitude within +-90 and the longitude within +-180 degrees
+ * returnvalue@ bool			-	false if a coordinate is out of range
+ */
+inline bool CWaypoint::isValidPosition(double latitude, double longitude)
+{
+	return ((latitude >= LATITUDE_MIN) && (latitude <= LATITUDE_MAX)) &&
+			((longitude >= LONGITUDE_MIN) && (longitude <= LONGITUDE_MAX));
+}
 #endif /* CWAYPOINT_H */
@@ -25,7 +25,17 @@ using namespace std;
  */
 CWpDatabase::CWpDatabase()
 {
-	// do nothing
+	this->m_indexGeneration = this->getGeneration();
+}
+
+/**
+ * CWpDatabase copy constructor: the spatial index is rebuilt over the copied waypoints
+ * param@ CWpDatabase const &origin	-	database to be copied	(IN)
+ */
+CWpDatabase::CWpDatabase(CWpDatabase const &origin) : CDatabase<Wp_Database_key_t, CWaypoint, Wp_Storage_t>(origin)
+{
+	// the index of the origin points to the waypoints of the origin
+	this->rebuildSpatialIndex();
 }
 
 /**
@@ -37,6 +47,23 @@ CWpDatabase::~CWpDatabase()
 }
 
 
+/**
+ * A copy assignment operator: the spatial index is rebuilt over the copied waypoints
+ * param@ CWpDatabase const &rhs		-	database to be copied	(IN)
+ * returnvalue@ CWpDatabase&
+ */
+CWpDatabase& CWpDatabase::operator=(CWpDatabase const &rhs)
+{
+	if (this != &rhs)
+	{
+		this->CDatabase<Wp_Database_key_t, CWaypoint, Wp_Storage_t>::operator=(rhs);
+		this->rebuildSpatialIndex();
+	}
+
+	return *this;
+}
+
+
 /**
  * Add a Waypoint to the database
  * param@ Wp_Database_key_t const &key	- 	key for the wp	(IN)
@@ -45,23 +72,58 @@ CWpDatabase::~CWpDatabase()
  */
 void CWpDatabase::addWaypoint(Wp_Database_key_t const &key, CWaypoint const &wp)
 {
-	this->addElement(key, wp);
+	// the other elements must stay where the index saw them
+	bool isIndexInSync = (this->m_indexGeneration == this->getGeneration()) && this->hasStableAddresses();
+
+	if (this->addElement(key, wp) && isIndexInSync)
+	{
+		// keep the index up to date instead of rebuilding it on the next query
+		this->m_spatialIndex.insert(this->getPointerToElement(key));
+		this->m_indexGeneration = this->getGeneration();
+	}
+}
+
+
+/**
+ * Get pointer to a Waypoint from the Database which matches the name;
+ * the name is not added to the string pool
+ * param@ std::string_view name		-	name of a Waypoint	(IN)
+ * returnvalue@ CWaypoint*			-	Pointer to a Waypoint in the database, 0 if not found
+ */
+CWaypoint* CWpDatabase::getPointerToWaypoint(string_view name)
+{
+	Wp_Database_key_t key;
+
+	// a name which is not in the pool is not the name of any Waypoint
+	if (!Wp_Database_key_t::find(name, key))
+	{
+		return 0;
+	}
+
+	return (this->getPointerToElement(key));
 }
 
 
 /**
- * Get pointer to a Waypoint from the Database which matches the name
- * param@ Wp_Database_key_t name	-	name of a Waypoint	(IN)
- * returnvalue@ CPOI*				-	Pointer to a Waypoint in the database
+ * Get read only access to a Waypoint from the Database which matches the name
+ * param@ std::string_view name		-	name of a Waypoint	(IN)
+ * returnvalue@ CWaypoint const*	-	Pointer to a Waypoint in the database, 0 if not found
  */
-CWaypoint* CWpDatabase::getPointerToWaypoint(Wp_Database_key_t name)
+CWaypoint const* CWpDatabase::getPointerToWaypoint(string_view name) const
 {
-	return (this->getPointerToElement(name));
+	Wp_Database_key_t key;
+
+	if (!Wp_Database_key_t::find(name, key))
+	{
+		return 0;
+	}
+
+	return (this->getPointerToElement(key));
 }
 
 
 /**
- * Get Waypoints from the Database
+ * Get a copy of the Waypoints from the Database; visitWaypoints reads them without a copy
  * returnvalue@ Wp_Map_t			-	Waypoints in the Database	(OUT)
  */
 const CWpDatabase::Wp_Map_t CWpDatabase::getWpsFromDatabase() const
@@ -88,3 +150,47 @@ void CWpDatabase::print()
 {
 	this->CDatabase::print();
 }
+
+
+/**
+ * Build the spatial index now instead of on the next query, e.g. after loading the database;
+ * Waypoints added one by one are merged into the trees
+ * returnvalue@ void
+ */
+void CWpDatabase::buildSpatialIndex()
+{
+	// the Waypoints added one by one since the last build are merged into one tree
+	if ((this->m_indexGeneration != this->getGeneration()) || !this->m_spatialIndex.isNumbered())
+	{
+		this->rebuildSpatialIndex();
+	}
+}
+
+
+/**
+ * Rebuild the spatial index if the database has changed since it was built
+ * returnvalue@ void
+ */
+void CWpDatabase::syncSpatialIndex()
+{
+	if (this->m_indexGeneration != this->getGeneration())
+	{
+		this->rebuildSpatialIndex();
+	}
+}
+
+
+/**
+ * Build the spatial index over all the Waypoints of the database
+ * returnvalue@ void
+ */
+void CWpDatabase::rebuildSpatialIndex()
+{
+	vector<CWaypoint *> wps;
+
+	// a Waypoint is numbered in the order of the names, as a snapshot stores it
+	this->getElementsInKeyOrder(wps);
+
+	this->m_spatialIndex.build(wps);
+	this->m_indexGeneration = this->getGeneration();
+}
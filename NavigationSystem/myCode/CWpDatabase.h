@@ -6,6 +6,8 @@
 * Description     : The file defines a class CWpDatabase.
 * 					The class CWpDatabase is used to hold the information
 * 					of all the waypoints in a container.
+* 					The waypoints are kept in a spatial index for
+* 					viewport queries.
 *
 ****************************************************************************/
 
@@ -14,32 +16,57 @@
 
 //System Include Files
 #include <string>
+#include <string_view>
 #include <map>
+#include <vector>
 
 //Own Include Files
 #include "CWaypoint.h"
 #include "CDatabase.h"
+#include "CSpatialIndex.h"
 
 //typedefs
-typedef std::string											Wp_Database_key_t;
+typedef CPooledString										Wp_Database_key_t;
 
-class CWpDatabase : public CDatabase<Wp_Database_key_t, CWaypoint> {
+#if (defined(CONFIG_DATABASE_STORAGE) && (CONFIG_DATABASE_STORAGE == MORTON_ORDER))
+typedef CMortonStorage<Wp_Database_key_t, CWaypoint>				Wp_Storage_t;
+#elif (defined(CONFIG_DATABASE_STORAGE) && (CONFIG_DATABASE_STORAGE == HASH_TABLE))
+typedef CHashStorage<Wp_Database_key_t, CWaypoint>					Wp_Storage_t;
+#else
+typedef CMapStorage<Wp_Database_key_t, CWaypoint>					Wp_Storage_t;
+#endif
+
+class CWpDatabase : public CDatabase<Wp_Database_key_t, CWaypoint, Wp_Storage_t> {
 public:
 
 	typedef std::map<Wp_Database_key_t, CWaypoint> 						Wp_Map_t;
 	typedef std::map<Wp_Database_key_t, CWaypoint>::iterator 			Wp_Map_Itr_t;
 	typedef std::map<Wp_Database_key_t, CWaypoint>::reverse_iterator 	Wp_Map_RevItr_t;
+	typedef Wp_Storage_t::Storage_ConstItr_t							Wp_ConstItr_t;
 
 	/**
 	 * CWpDatabase constructor
 	 */
     CWpDatabase();
 
+    /**
+     * CWpDatabase copy constructor: the spatial index is rebuilt over the copied waypoints
+     * param@ CWpDatabase const &origin	-	database to be copied	(IN)
+     */
+    CWpDatabase(CWpDatabase const &origin);
+
     /**
      * CWpDatabase destructor
      */
     ~CWpDatabase();
 
+    /**
+     * A copy assignment operator: the spatial index is rebuilt over the copied waypoints
+     * param@ CWpDatabase const &rhs		-	database to be copied	(IN)
+     * returnvalue@ CWpDatabase&
+     */
+    CWpDatabase& operator=(CWpDatabase const &rhs);
+
     /**
 	 * Add a Waypoint to the database
 	 * param@ Wp_Database_key_t &name	- 	unique name for the wp		(IN)
@@ -49,18 +76,36 @@ public:
 	void addWaypoint(Wp_Database_key_t const &name, CWaypoint const &wp);
 
     /**
-	 * Get pointer to a Waypoint from the Database which matches the name
-	 * param@ Wp_Database_key_t name	-	name of a Waypoint	(IN)
-	 * returnvalue@ CWaypoint*			-	Pointer to a Waypoint in the database
+	 * Get pointer to a Waypoint from the Database which matches the name;
+	 * the name is not added to the string pool
+	 * param@ std::string_view name		-	name of a Waypoint	(IN)
+	 * returnvalue@ CWaypoint*			-	Pointer to a Waypoint in the database, 0 if not found
 	 */
-    CWaypoint* getPointerToWaypoint(Wp_Database_key_t name);
+    CWaypoint* getPointerToWaypoint(std::string_view name);
 
     /**
-     * Get Waypoints from the Database
+	 * Get read only access to a Waypoint from the Database which matches the name
+	 * param@ std::string_view name		-	name of a Waypoint	(IN)
+	 * returnvalue@ CWaypoint const*	-	Pointer to a Waypoint in the database, 0 if not found
+	 */
+    CWaypoint const* getPointerToWaypoint(std::string_view name) const;
+
+    /**
+     * Get a copy of the Waypoints from the Database; visitWaypoints reads them without a copy
      * returnvalue@ Wp_Map_t			-	Waypoints in the Database	(OUT)
      */
     const Wp_Map_t getWpsFromDatabase() const;
 
+    /**
+	 * Visit all the Waypoints in place, in the order of their names.
+	 * The visitor is called as visitor(Wp_Database_key_t const &name, CWaypoint const &wp)
+	 * and must not add Waypoints to the database.
+	 * param@ TVisitor &visitor			-	called for every Waypoint	(IN)
+	 * returnvalue@ void
+	 */
+    template<class TVisitor>
+    void visitWaypoints(TVisitor &visitor) const;
+
     /**
 	 * Resets the Database
 	 * returnvalue@ void
@@ -72,8 +117,172 @@ public:
 	 * returnvalue@ void
 	 */
     void print();
+
+	/**
+	 * Visit all the Waypoints inside the latitude / longitude rectangle, e.g. the viewport of the map.
+	 * A rectangle with minLongitude > maxLongitude crosses the date line.
+	 * The visitor is called as visitor(CWaypoint &wp) and must not add Waypoints to the database.
+	 * param@ double minLatitude		-	southern border		(IN)
+	 * param@ double maxLatitude		-	northern border		(IN)
+	 * param@ double minLongitude		-	western border		(IN)
+	 * param@ double maxLongitude		-	eastern border		(IN)
+	 * param@ TVisitor &visitor			-	called for every Waypoint in the rectangle	(IN)
+	 * returnvalue@ void
+	 */
+	template<class TVisitor>
+	void visitWaypointsInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor);
+
+	/**
+	 * Build the spatial index now instead of on the next query, e.g. after loading the database;
+	 * Waypoints added one by one are merged into the trees
+	 * returnvalue@ void
+	 */
+	void buildSpatialIndex();
+
+	/**
+	 * Take over a spatial index which was built over the Waypoints of the database, e.g. stored in
+	 * a snapshot, instead of building it again. A node gives the number of its Waypoint in keys;
+	 * the index is built again if the nodes do not match the Waypoints.
+	 * param@ TNode const pNodes[]						-	nodes of the tree					(IN)
+	 * param@ uint32_t count								-	number of nodes						(IN)
+	 * param@ std::vector<Wp_Database_key_t> const &keys	-	names of the Waypoints by number	(IN)
+	 * returnvalue@ bool									-	false if the index was built again
+	 */
+	template<class TNode>
+	bool adoptSpatialIndex(TNode const pNodes[], uint32_t count, std::vector<Wp_Database_key_t> const &keys);
+
+	/**
+	 * Visit the nodes of the spatial index, e.g. to store it in a snapshot; a node gives the
+	 * number of its Waypoint in the order of the names (see CSpatialIndex::visitNodes).
+	 * The visitor is called as visitor(CWaypoint const &wp, uint32_t number, double const coord[3], int axis).
+	 * param@ TVisitor &visitor			-	called for every node	(IN)
+	 * returnvalue@ bool				-	false if the index is not one tree over the current Waypoints;
+	 * 										nothing is visited then
+	 */
+	template<class TVisitor>
+	bool visitSpatialIndexNodes(TVisitor &visitor) const;
+
+private:
+
+	/**
+	 * Spatial index over all the Waypoints
+	 */
+	CSpatialIndex<CWaypoint>		m_spatialIndex;
+
+	/**
+	 * The database generation the spatial index reflects
+	 */
+	unsigned long					m_indexGeneration;
+
+	/**
+	 * Rebuild the spatial index if the database has changed since it was built
+	 * returnvalue@ void
+	 */
+	void syncSpatialIndex();
+
+	/**
+	 * Build the spatial index over all the Waypoints of the database
+	 * returnvalue@ void
+	 */
+	void rebuildSpatialIndex();
 };
 /********************
 **  CLASS END
 *********************/
+
+/**
+ * Visit all the Waypoints inside the latitude / longitude rectangle, e.g. the viewport of the map.
+ * A rectangle with minLongitude > maxLongitude crosses the date line.
+ * The visitor is called as visitor(CWaypoint &wp) and must not add Waypoints to the database.
+ * param@ double minLatitude		-	southern border		(IN)
+ * param@ double maxLatitude		-	northern border		(IN)
+ * param@ double minLongitude		-	western border		(IN)
+ * param@ double maxLongitude		-	eastern border		(IN)
+ * param@ TVisitor &visitor			-	called for every Waypoint in the rectangle	(IN)
+ * returnvalue@ void
+ */
+template<class TVisitor>
+void CWpDatabase::visitWaypointsInRectangle(double minLatitude, double maxLatitude, double minLongitude, double maxLongitude, TVisitor &visitor)
+{
+	this->syncSpatialIndex();
+	this->m_spatialIndex.visitRectangle(minLatitude, maxLatitude, minLongitude, maxLongitude, visitor);
+}
+
+
+/**
+ * Visit all the Waypoints in place, in the order of their names.
+ * The visitor is called as visitor(Wp_Database_key_t const &name, CWaypoint const &wp)
+ * and must not add Waypoints to the database.
+ * param@ TVisitor &visitor			-	called for every Waypoint	(IN)
+ * returnvalue@ void
+ */
+template<class TVisitor>
+void CWpDatabase::visitWaypoints(TVisitor &visitor) const
+{
+	this->visitElements(visitor);
+}
+
+
+/**
+ * Take over a spatial index which was built over the Waypoints of the database, e.g. stored in
+ * a snapshot, instead of building it again. A node gives the number of its Waypoint in keys;
+ * the index is built again if the nodes do not match the Waypoints.
+ * param@ TNode const pNodes[]						-	nodes of the tree					(IN)
+ * param@ uint32_t count								-	number of nodes						(IN)
+ * param@ std::vector<Wp_Database_key_t> const &keys	-	names of the Waypoints by number	(IN)
+ * returnvalue@ bool									-	false if the index was built again
+ */
+template<class TNode>
+bool CWpDatabase::adoptSpatialIndex(TNode const pNodes[], uint32_t count, std::vector<Wp_Database_key_t> const &keys)
+{
+	std::vector<CWaypoint *> 	wps;
+	std::vector<bool> 			isIndexed(keys.size(), false);
+	bool 						isValid = (count == keys.size()) && (this->getElementCount() == keys.size()) && this->getElementsByKey(keys, wps);
+
+	// every Waypoint is in the tree once
+	for (uint32_t node = 0; isValid && (node < count); ++node)
+	{
+		isValid = (pNodes[node].element < keys.size()) && !isIndexed[pNodes[node].element] && (pNodes[node].axis < 3);
+
+		if (isValid)
+		{
+			isIndexed[pNodes[node].element] = true;
+		}
+	}
+
+	if (isValid)
+	{
+		this->m_spatialIndex.adoptTree(pNodes, count, wps.data());
+		this->m_indexGeneration = this->getGeneration();
+	}
+	else
+	{
+		this->rebuildSpatialIndex();
+	}
+
+	return isValid;
+}
+
+
+/**
+ * Visit the nodes of the spatial index, e.g. to store it in a snapshot; a node gives the
+ * number of its Waypoint in the order of the names (see CSpatialIndex::visitNodes).
+ * The visitor is called as visitor(CWaypoint const &wp, uint32_t number, double const coord[3], int axis).
+ * param@ TVisitor &visitor			-	called for every node	(IN)
+ * returnvalue@ bool				-	false if the index is not one tree over the current Waypoints;
+ * 										nothing is visited then
+ */
+template<class TVisitor>
+bool CWpDatabase::visitSpatialIndexNodes(TVisitor &visitor) const
+{
+	bool isCurrent = (this->m_indexGeneration == this->getGeneration()) && this->m_spatialIndex.isNumbered()
+						&& (this->m_spatialIndex.size() == this->getElementCount());
+
+	if (isCurrent)
+	{
+		this->m_spatialIndex.visitNodes(visitor);
+	}
+
+	return isCurrent;
+}
 #endif /* CWPDATABASE_H */
@@ -0,0 +1,230 @@
+/*
+ * CArenaTest.h
+ */
+
+#ifndef CARENATEST_H_
+#define CARENATEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <list>
+#include <sstream>
+#include <stdint.h>
+
+#include "../myCode/CArena.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CRoute.h"
+#include "../myCode/CMapStorage.h"
+#include "../myCode/CMortonStorage.h"
+
+/**
+ * This class implements several test cases related to the CMonotonicArena, the CNodePool
+ * and the containers which take their memory from them.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CArenaTest: public CppUnit::TestFixture {
+private:
+
+	/**
+	 * Element which counts its destructions; it does not opt in to CArenaTraits
+	 */
+	struct CCountedElement
+	{
+		static unsigned int destroyedCount;
+
+		~CCountedElement() {
+				destroyedCount++;
+			}
+	};
+
+public:
+
+	void testMonotonicArena() {
+			CMonotonicArena arena;
+
+			CPPUNIT_ASSERT(0 == arena.getReservedBytes());
+
+			char 	*pFirst 	= static_cast<char *>(arena.allocate(3, 1));
+			double 	*pSecond 	= static_cast<double *>(arena.allocate(sizeof(double), alignof(double)));
+
+			// the memory follows in the same block, aligned
+			CPPUNIT_ASSERT(0 == ((uintptr_t)pSecond % alignof(double)));
+			CPPUNIT_ASSERT((char *)pSecond - pFirst < 16);
+
+			// larger than a block
+			char *pLarge = static_cast<char *>(arena.allocate(1024 * 1024, 16));
+
+			pLarge[1024 * 1024 - 1] = 'x';
+			CPPUNIT_ASSERT(0 == ((uintptr_t)pLarge % 16));
+			CPPUNIT_ASSERT(arena.getReservedBytes() >= 1024 * 1024);
+
+			arena.release();
+
+			CPPUNIT_ASSERT(0 == arena.getReservedBytes());
+		}
+
+	void testNodePoolReusesNodes() {
+			CNodePool 	pool;
+			void 		*pFirst 	= pool.allocate(24, 8);
+			void 		*pSecond 	= pool.allocate(24, 8);
+
+			CPPUNIT_ASSERT(pFirst != pSecond);
+
+			pool.deallocate(pFirst, 24, 8);
+
+			// a freed node is handed out again
+			CPPUNIT_ASSERT(pFirst == pool.allocate(24, 8));
+
+			// other sizes and larger alignments come from the heap and go back to it
+			void *pOther 	= pool.allocate(100, 8);
+			void *pAligned 	= pool.allocate(24, 64);
+
+			CPPUNIT_ASSERT(0 == ((uintptr_t)pAligned % 64));
+
+			pool.deallocate(pOther, 100, 8);
+			pool.deallocate(pAligned, 24, 64);
+
+			CPPUNIT_ASSERT(pAligned != pool.allocate(24, 8));
+
+			std::list<int, CArenaAllocator<int, CNodePool> > numbers((CArenaAllocator<int, CNodePool>(&pool)));
+
+			for (int value = 0; value < 1000; ++value)
+			{
+				numbers.push_back(value);
+			}
+
+			numbers.remove_if(isOdd);
+
+			CPPUNIT_ASSERT(500 == numbers.size());
+			CPPUNIT_ASSERT(998 == numbers.back());
+		}
+
+	void testDatabaseReset() {
+			CWpDatabase *pWpDatabase = new CWpDatabase;
+
+			for (unsigned int index = 0; index < 10000; ++index)
+			{
+				std::ostringstream name;
+
+				name << "Waypoint " << index;
+				pWpDatabase->addWaypoint(name.str(), CWaypoint(name.str(), 49.0 + index * 1e-4, 8.0));
+			}
+
+			// the copy takes its own memory, it outlives the reset of the original
+			CWpDatabase copy(*pWpDatabase);
+
+			pWpDatabase->resetWpsDatabase();
+
+			CPPUNIT_ASSERT(0 == pWpDatabase->getElementCount());
+			CPPUNIT_ASSERT(0 == pWpDatabase->getPointerToWaypoint("Waypoint 17"));
+			CPPUNIT_ASSERT(10000 == copy.getElementCount());
+			CPPUNIT_ASSERT(!copy.getPointerToWaypoint("Waypoint 17")->getName().compare("Waypoint 17"));
+
+			// the database is filled again after the reset
+			pWpDatabase->addWaypoint("Luisenplatz", CWaypoint("Luisenplatz", 49.8728, 8.6512));
+
+			CPPUNIT_ASSERT(1 == pWpDatabase->getElementCount());
+			CPPUNIT_ASSERT(pWpDatabase->getPointerToWaypoint("Luisenplatz"));
+
+			*pWpDatabase = copy;
+
+			CPPUNIT_ASSERT(10000 == pWpDatabase->getElementCount());
+			CPPUNIT_ASSERT(0 == pWpDatabase->getPointerToWaypoint("Luisenplatz"));
+
+			delete pWpDatabase;
+		}
+
+	void testClearKeepsDestructors() {
+			CMapStorage<unsigned int, CCountedElement> 		storage;
+			CMortonStorage<std::string, CPOI> 				mortonStorage;
+
+			// only the types without resources skip the destructor
+			CPPUNIT_ASSERT(CArenaTraits<CWaypoint>::CAN_SKIP_DESTRUCTOR && CArenaTraits<CPOI>::CAN_SKIP_DESTRUCTOR);
+			CPPUNIT_ASSERT(!CArenaTraits<std::string>::CAN_SKIP_DESTRUCTOR && !CArenaTraits<CCountedElement>::CAN_SKIP_DESTRUCTOR);
+
+			for (unsigned int key = 0; key < 100; ++key)
+			{
+				storage.insert(key, CCountedElement());
+			}
+
+			CCountedElement::destroyedCount = 0;
+			storage.clear();
+
+			CPPUNIT_ASSERT(100 == CCountedElement::destroyedCount);
+			CPPUNIT_ASSERT(0 == storage.size());
+
+			// the keys of the name index own memory: it is cleared node by node and can be filled again
+			for (unsigned int index = 0; index < 100; ++index)
+			{
+				std::ostringstream name;
+
+				name << "A name which does not fit into a short string " << index;
+				mortonStorage.insert(name.str(), CPOI(CPOI::RESTAURANT, name.str(), "", 49.0, 8.0 + index * 1e-3));
+			}
+
+			mortonStorage.clear();
+			mortonStorage.insert("Mensa", CPOI(CPOI::RESTAURANT, "Mensa", "", 49.8, 8.6));
+
+			CPPUNIT_ASSERT(1 == mortonStorage.size());
+			CPPUNIT_ASSERT(mortonStorage.find("Mensa"));
+		}
+
+	void testRoutesWithOwnPools() {
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CRoute			*pRoute 		= new CRoute;
+
+			pWpDatabase->addWaypoint("Luisenplatz", CWaypoint("Luisenplatz", 49.8728, 8.6512));
+			pWpDatabase->addWaypoint("Hauptbahnhof", CWaypoint("Hauptbahnhof", 49.8728, 8.6297));
+
+			pRoute->connectToWpDatabase(pWpDatabase);
+			pRoute->addWaypoint("Luisenplatz");
+			pRoute->addWaypoint("Hauptbahnhof");
+
+			CRoute copy(*pRoute);
+			CRoute sum = *pRoute + copy;
+
+			// the nodes of the copies do not depend on the original
+			delete pRoute;
+
+			CPPUNIT_ASSERT(2 == copy.getRoute().size());
+			CPPUNIT_ASSERT(4 == sum.getRoute().size());
+			CPPUNIT_ASSERT(!sum.getRoute()[2]->getName().compare("Luisenplatz"));
+
+			delete pWpDatabase;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Arena tests");
+
+		suite->addTest(new CppUnit::TestCaller<CArenaTest>
+				 ("Monotonic arena allocates aligned and releases at once", &CArenaTest::testMonotonicArena));
+
+		suite->addTest(new CppUnit::TestCaller<CArenaTest>
+				 ("Node pool reuses freed nodes", &CArenaTest::testNodePoolReusesNodes));
+
+		suite->addTest(new CppUnit::TestCaller<CArenaTest>
+				 ("Database reset releases the arena", &CArenaTest::testDatabaseReset));
+
+		suite->addTest(new CppUnit::TestCaller<CArenaTest>
+				 ("Route copies do not depend on the original", &CArenaTest::testRoutesWithOwnPools));
+
+		suite->addTest(new CppUnit::TestCaller<CArenaTest>
+				 ("Clearing a storage destroys the elements which own resources", &CArenaTest::testClearKeepsDestructors));
+
+		return suite;
+	}
+
+private:
+
+	static bool isOdd(int value) {
+			return (value % 2);
+		}
+};
+
+unsigned int CArenaTest::CCountedElement::destroyedCount = 0;
+
+#endif /* CARENATEST_H_ */
@@ -0,0 +1,304 @@
+/*
+ * CCSVTest.h
+ */
+
+#ifndef CCSVTEST_H_
+#define CCSVTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <iostream>
+
+#include "../myCode/CCSV.h"
+#include "../myCode/CParser.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class implements several test cases related to the CSV persistence.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CCSVTest: public CppUnit::TestFixture {
+private:
+
+	/**
+	 * Remove the files of a media name
+	 */
+	static void removeFiles(std::string const &mediaName) {
+			std::remove((mediaName + "-wp.txt").c_str());
+			std::remove((mediaName + "-poi.txt").c_str());
+		}
+
+	/**
+	 * Read the files with the given number of threads; the output of readData is returned
+	 */
+	static std::string readFiles(unsigned int threads, CWpDatabase &wpDatabase, CPoiDatabase &poiDatabase) {
+			CCSV 				csv;
+			std::ostringstream 	output;
+			std::streambuf 		*pConsole = std::cout.rdbuf(output.rdbuf());
+
+			csv.setMediaName("CSVTest");
+			csv.setThreadCount(threads);
+			csv.readData(wpDatabase, poiDatabase, CCSV::REPLACE);
+
+			std::cout.rdbuf(pConsole);
+
+			return output.str();
+		}
+
+public:
+
+	void testNumberParser() {
+			double number = 0;
+
+			CPPUNIT_ASSERT(CParser::parseNumber("49.866851", number) && 49.866851 == number);
+			CPPUNIT_ASSERT(CParser::parseNumber(" \t-33.85 \r", number) && -33.85 == number);
+			CPPUNIT_ASSERT(CParser::parseNumber("+151.2", number) && 151.2 == number);
+			CPPUNIT_ASSERT(CParser::parseNumber("1e-05", number) && 1e-05 == number);
+			CPPUNIT_ASSERT(CParser::parseNumber("-.5", number) && -0.5 == number);
+			CPPUNIT_ASSERT(CParser::parseNumber("12.", number) && 12 == number);
+			CPPUNIT_ASSERT(CParser::parseNumber("-0", number) && 0 == number);
+
+			number = 7;
+
+			CPPUNIT_ASSERT(!CParser::parseNumber("", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("  ", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("-", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("- 5", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("+-5", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("1.2.3", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("8,6", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("5 6", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("inf", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("-nan", number));
+			CPPUNIT_ASSERT(!CParser::parseNumber("abc", number));
+
+			// a failed conversion leaves the number as it was
+			CPPUNIT_ASSERT(7 == number);
+		}
+
+	void testNegativeCoordinates() {
+			CWpDatabase 	wpDatabase, wpRead;
+			CPoiDatabase 	poiDatabase, poiRead;
+			CCSV 			csv;
+
+			wpDatabase.addWaypoint("Sydney", CWaypoint("Sydney", -33.8688, 151.2093));
+			wpDatabase.addWaypoint("New York", CWaypoint("New York", 40.7128, -74.0060));
+			wpDatabase.addWaypoint("Rio", CWaypoint("Rio", -22.9068, -43.1729));
+			wpDatabase.addWaypoint("Greenwich", CWaypoint("Greenwich", 51.4779, -0.00001));
+
+			poiDatabase.addPoi("Opera", CPOI(CPOI::TOURISTIC, "Opera", "Harbour; opera house", -33.8568, 151.2153));
+			poiDatabase.addPoi("Diner", CPOI(CPOI::RESTAURANT, "Diner", "Open late", 40.7, -74.0));
+
+			csv.setMediaName("CSVTest");
+			CPPUNIT_ASSERT(csv.writeData(wpDatabase, poiDatabase));
+			CPPUNIT_ASSERT(csv.readData(wpRead, poiRead, CCSV::REPLACE));
+			removeFiles("CSVTest");
+
+			CPPUNIT_ASSERT(4 == wpRead.getElementCount());
+			CPPUNIT_ASSERT(1 == poiRead.getElementCount());
+
+			CWaypoint *pRio = wpRead.getPointerToWaypoint("Rio");
+
+			CPPUNIT_ASSERT(pRio);
+			CPPUNIT_ASSERT(-22.9068 == pRio->getLatitude() && -43.1729 == pRio->getLongitude());
+			CPPUNIT_ASSERT(-0.00001 == wpRead.getPointerToWaypoint("Greenwich")->getLongitude());
+
+			CPOI *pDiner = poiRead.getPointerToPoi("Diner");
+
+			CPPUNIT_ASSERT(pDiner);
+			CPPUNIT_ASSERT(CPOI::RESTAURANT == pDiner->getPoiType());
+			CPPUNIT_ASSERT(40.7 == pDiner->getLatitude() && -74.0 == pDiner->getLongitude());
+
+			// the ';' in the description splits the line: the POI is rejected
+			CPPUNIT_ASSERT(!poiRead.getPointerToPoi("Opera"));
+		}
+
+	void testMalformedLines() {
+			std::ofstream wpFile("CSVTest-wp.txt");
+
+			wpFile << "Berliner Alle; 49.866851; 8.634864\r\n";
+			wpFile << "\n";
+			wpFile << "No delimiter 49.8 8.6\n";
+			wpFile << "Too few; 49.8\n";
+			wpFile << "; 49.8; 8.6\n";
+			wpFile << "Not a number; 49.8x; 8.6\n";
+			wpFile << "Out of range; 95; 8.6\n";
+			wpFile << "Comma,-49.5,-8.25\n";
+			wpFile << "Semicolon; in the name,49.5,8.25\n";
+			wpFile << "\tLast line; -1; -2";
+			wpFile.close();
+
+			std::ofstream poiFile("CSVTest-poi.txt");
+
+			poiFile << "Gas station; Aral; Refuel your vehicle; 49.871558; 8.639206\n";
+			poiFile << "Spaceport; Launch; Not a type; 49.8; 8.6\n";
+			poiFile << "Restaurant; Starbucks; Coffee\n";
+			poiFile << "University,HDA,An awesome University,49.86727,8.638459\n";
+			poiFile << "Restaurant,Bar; Grill,Steaks; Drinks,49.8,8.6\n";
+			poiFile << "Restaurant; Polar; Out of range; 91; 8.6\n";
+			poiFile.close();
+
+			CWpDatabase 	wpRead;
+			CPoiDatabase 	poiRead;
+			CCSV 			csv;
+
+			std::ostringstream 	output;
+			std::streambuf 		*pConsole = std::cout.rdbuf(output.rdbuf());
+
+			csv.setMediaName("CSVTest");
+			CPPUNIT_ASSERT(csv.readData(wpRead, poiRead, CCSV::REPLACE));
+			removeFiles("CSVTest");
+
+			std::cout.rdbuf(pConsole);
+
+			CPPUNIT_ASSERT(4 == wpRead.getElementCount());
+			CPPUNIT_ASSERT(wpRead.getPointerToWaypoint("Berliner Alle"));
+			CPPUNIT_ASSERT(-8.25 == wpRead.getPointerToWaypoint("Comma")->getLongitude());
+			CPPUNIT_ASSERT(-1 == wpRead.getPointerToWaypoint("Last line")->getLatitude());
+
+			// a ',' in the line is the delimiter, the ';' belong to the fields
+			CPPUNIT_ASSERT(8.25 == wpRead.getPointerToWaypoint("Semicolon; in the name")->getLongitude());
+
+			CPPUNIT_ASSERT(3 == poiRead.getElementCount());
+			CPPUNIT_ASSERT(CPOI::UNIVERSITY == poiRead.getPointerToPoi("HDA")->getPoiType());
+
+			CPOI::t_poi 	type;
+			std::string 	name, description;
+			double 			latitude, longitude;
+
+			poiRead.getPointerToPoi("Bar; Grill")->getAllDataByReference(name, latitude, longitude, type, description);
+			CPPUNIT_ASSERT(!description.compare("Steaks; Drinks"));
+
+			CPPUNIT_ASSERT(std::string::npos != output.str().find("ERROR: Invalid Waypoint in line 7: Out of range"));
+			CPPUNIT_ASSERT(std::string::npos != output.str().find("ERROR: Invalid POI in line 6: Restaurant; Polar"));
+
+			// the files are missing
+			csv.setMediaName("CSVTest");
+			CPPUNIT_ASSERT(!csv.readData(wpRead, poiRead, CCSV::MERGE));
+		}
+
+	void testParallelMatchesSequential() {
+			std::ofstream 	wpFile("CSVTest-wp.txt");
+			std::ofstream 	poiFile("CSVTest-poi.txt");
+
+			// large enough for several chunks; repeated keys, bad lines and a last line without line end
+			for (unsigned int index = 0; index < 40000; ++index)
+			{
+				wpFile << "Waypoint " << index % 30000 << "; " << -45.0 + index % 90 << "; " << -(int)(index % 180) << ".25\n";
+				poiFile << "Restaurant; POI " << index % 35000 << "; Line " << index + 1 << "; " << 45.5 - index % 90 << "; " << index % 180 << "\n";
+
+				if (index % 997 == 0)
+				{
+					wpFile << "Broken line " << index << "\n\n";
+					poiFile << "Spaceport; POI; Not a type; 1; 2\r\n";
+				}
+			}
+
+			wpFile << "Last; -1; -2";
+			wpFile.close();
+			poiFile.close();
+
+			CWpDatabase 	wpSequential, wpParallel;
+			CPoiDatabase 	poiSequential, poiParallel;
+			std::string 	sequentialOutput 	= readFiles(1, wpSequential, poiSequential);
+			std::string 	parallelOutput 		= readFiles(8, wpParallel, poiParallel);
+
+			removeFiles("CSVTest");
+
+			// the same errors and warnings in the same order
+			CPPUNIT_ASSERT(sequentialOutput == parallelOutput);
+			CPPUNIT_ASSERT(sequentialOutput.find("Empty line in line 3\n") != std::string::npos);
+
+			CPPUNIT_ASSERT(30001 == wpParallel.getElementCount());
+			CPPUNIT_ASSERT(35000 == poiParallel.getElementCount());
+			CPPUNIT_ASSERT(wpSequential.getElementCount() == wpParallel.getElementCount());
+			CPPUNIT_ASSERT(poiSequential.getElementCount() == poiParallel.getElementCount());
+
+			for (CWpDatabase::Database_Storage_ConstItr_t itr = wpParallel.begin(); itr != wpParallel.end(); ++itr)
+			{
+				CWaypoint const *pWp = wpSequential.getPointerToWaypoint(itr->first);
+
+				CPPUNIT_ASSERT(pWp);
+				CPPUNIT_ASSERT(pWp->getLatitude() == itr->second.getLatitude() && pWp->getLongitude() == itr->second.getLongitude());
+			}
+
+			// the first line of a repeated key wins
+			std::string 	description, name;
+			double 			latitude, longitude;
+			CPOI::t_poi 	type;
+
+			poiParallel.getPointerToPoi("POI 10")->getAllDataByReference(name, latitude, longitude, type, description);
+			CPPUNIT_ASSERT(description == "Line 11");
+			CPPUNIT_ASSERT(-1 == wpParallel.getPointerToWaypoint("Last")->getLatitude());
+		}
+
+	void testShortestRoundTrip() {
+			CWpDatabase 	wpDatabase, wpRead;
+			CPoiDatabase 	poiDatabase, poiRead;
+			CCSV 			csv;
+
+			// more digits than any fixed precision would keep, and the smallest steps of a double
+			wpDatabase.addWaypoint("Sum", CWaypoint("Sum", 0.1 + 0.2, -(0.1 + 0.7)));
+			wpDatabase.addWaypoint("Tiny", CWaypoint("Tiny", 1e-300, -4.9406564584124654e-324));
+			wpDatabase.addWaypoint("Pole", CWaypoint("Pole", 89.99999999999999, 179.99999999999997));
+			poiDatabase.addPoi("Third", CPOI(CPOI::TOURISTIC, "Third", "One third", 1.0 / 3, -2.0 / 3));
+
+			csv.setMediaName("CSVTest");
+			CPPUNIT_ASSERT(csv.writeData(wpDatabase, poiDatabase));
+
+			std::ifstream 		wpFile("CSVTest-wp.txt");
+			std::stringstream 	wpText;
+
+			wpText << wpFile.rdbuf();
+			wpFile.close();
+
+			CPPUNIT_ASSERT(csv.readData(wpRead, poiRead, CCSV::REPLACE));
+			removeFiles("CSVTest");
+
+			// the shortest text which reads back as the same double
+			CPPUNIT_ASSERT(wpText.str().find("Sum; 0.30000000000000004; -0.7999999999999999\n") != std::string::npos);
+
+			for (CWpDatabase::Database_Storage_ConstItr_t itr = wpDatabase.begin(); itr != wpDatabase.end(); ++itr)
+			{
+				CWaypoint const *pWp = wpRead.getPointerToWaypoint(itr->first);
+
+				CPPUNIT_ASSERT(pWp);
+				CPPUNIT_ASSERT(pWp->getLatitude() == itr->second.getLatitude() && pWp->getLongitude() == itr->second.getLongitude());
+			}
+
+			CPPUNIT_ASSERT(1.0 / 3 == poiRead.getPointerToPoi("Third")->getLatitude());
+			CPPUNIT_ASSERT(-2.0 / 3 == poiRead.getPointerToPoi("Third")->getLongitude());
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("CSV persistence tests");
+
+		suite->addTest(new CppUnit::TestCaller<CCSVTest>
+				 ("Numbers are parsed independent of the locale", &CCSVTest::testNumberParser));
+
+		suite->addTest(new CppUnit::TestCaller<CCSVTest>
+				 ("Negative coordinates survive a write and a read", &CCSVTest::testNegativeCoordinates));
+
+		suite->addTest(new CppUnit::TestCaller<CCSVTest>
+				 ("Malformed lines are skipped", &CCSVTest::testMalformedLines));
+
+		suite->addTest(new CppUnit::TestCaller<CCSVTest>
+				 ("Parallel reading gives the result of the sequential one", &CCSVTest::testParallelMatchesSequential));
+
+		suite->addTest(new CppUnit::TestCaller<CCSVTest>
+				 ("Numbers are written with the shortest text which reads back exactly", &CCSVTest::testShortestRoundTrip));
+
+		return suite;
+	}
+};
+
+#endif /* CCSVTEST_H_ */
@@ -0,0 +1,306 @@
+/*
+ * CContractionHierarchyTest.h
+ */
+
+#ifndef CCONTRACTIONHIERARCHYTEST_H_
+#define CCONTRACTIONHIERARCHYTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <iterator>
+#include <iostream>
+
+#include "../myCode/CRoute.h"
+#include "../myCode/CRoadGraph.h"
+#include "../myCode/CContractionHierarchy.h"
+#include "CRandomRoadGraph.h"
+
+/**
+ * This class implements several test cases related to the CContractionHierarchy.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CContractionHierarchyTest: public CppUnit::TestFixture {
+private:
+
+	/**
+	 * Write the contents to the file and read it as a hierarchy; the messages are not shown
+	 */
+	static bool readDamaged(const char *fileName, std::string const &contents) {
+			CContractionHierarchy 	hierarchy;
+			std::ostringstream 		output;
+			std::streambuf 			*pConsole = std::cout.rdbuf(output.rdbuf());
+
+			std::ofstream(fileName, std::ios::binary) << contents;
+
+			bool isRead = hierarchy.readFromFile(fileName);
+
+			std::cout.rdbuf(pConsole);
+
+			return isRead;
+		}
+
+	/**
+	 * Length of the path in the road graph, -1 if two nodes of the path are not connected
+	 */
+	static double getPathLength(CRoadGraph &graph, CContractionHierarchy::Path_t const &path) {
+			double length = 0;
+
+			for (unsigned int index = 0; index + 1 < path.size(); ++index)
+			{
+				unsigned int begin, end;
+				double shortest = -1;
+
+				graph.getEdges(path[index], begin, end);
+
+				for (unsigned int edge = begin; edge < end; ++edge)
+				{
+					if ((graph.getEdgeTarget(edge) == path[index + 1]) && ((shortest < 0) || (graph.getEdgeLength(edge) < shortest)))
+					{
+						shortest = graph.getEdgeLength(edge);
+					}
+				}
+
+				if (shortest < 0)
+				{
+					return -1;
+				}
+
+				length += shortest;
+			}
+
+			return length;
+		}
+
+	static void checkQueries(CRoadGraph &graph, CContractionHierarchy &hierarchy) {
+			CRoadGraph::Path_t dijkstraPath, hierarchyPath;
+
+			srand(37);
+
+			for (unsigned int query = 0; query < 200; ++query)
+			{
+				CRoadGraph::Node_t source = rand() % graph.getNodeCount();
+				CRoadGraph::Node_t target = rand() % graph.getNodeCount();
+				double dijkstraLength = 0, hierarchyLength = 0;
+
+				bool isFound = graph.findPath(source, target, dijkstraPath, dijkstraLength, CRoadGraph::DIJKSTRA);
+
+				CPPUNIT_ASSERT(isFound == hierarchy.findPath(source, target, hierarchyPath, hierarchyLength));
+
+				if (isFound)
+				{
+					CPPUNIT_ASSERT_DOUBLES_EQUAL(dijkstraLength, hierarchyLength, 1e-9);
+					CPPUNIT_ASSERT(source == hierarchyPath.front() && target == hierarchyPath.back());
+
+					// the unpacked path consists of roads of the graph
+					CPPUNIT_ASSERT_DOUBLES_EQUAL(hierarchyLength, getPathLength(graph, hierarchyPath), 1e-9);
+				}
+			}
+		}
+
+public:
+
+	void testMatchesDijkstra() {
+			CRoadGraph *pGraph = new CRoadGraph;
+			CContractionHierarchy *pHierarchy = new CContractionHierarchy;
+
+			CRandomRoadGraph::fill(*pGraph, 1500, 31);
+			pHierarchy->build(*pGraph);
+
+			CPPUNIT_ASSERT(pGraph->getNodeCount() == pHierarchy->getNodeCount());
+			CPPUNIT_ASSERT(pHierarchy->getShortcutCount() > 0);
+
+			checkQueries(*pGraph, *pHierarchy);
+
+			delete pGraph;
+			delete pHierarchy;
+		}
+
+	void testMatchesDijkstraOnGrid() {
+			CRoadGraph *pGraph = new CRoadGraph;
+			CContractionHierarchy *pHierarchy = new CContractionHierarchy;
+
+			// a street grid: the witnesses have many edges and many nodes are stalled in the queries
+			srand(41);
+
+			for (unsigned int row = 0; row < 40; ++row)
+			{
+				for (unsigned int column = 0; column < 40; ++column)
+				{
+					pGraph->addNode(CRandomRoadGraph::name(row * 40 + column), 49.8 + 0.001 * row, 8.6 + 0.0015 * column);
+				}
+			}
+
+			for (unsigned int node = 0; node < 40 * 40; ++node)
+			{
+				if (node % 40 + 1 < 40)
+				{
+					pGraph->addEdge(CRandomRoadGraph::name(node), CRandomRoadGraph::name(node + 1), (rand() % 10 == 0), 0.1 * (1.0 + 0.5 * rand() / RAND_MAX));
+				}
+
+				if (node + 40 < 40 * 40)
+				{
+					pGraph->addEdge(CRandomRoadGraph::name(node), CRandomRoadGraph::name(node + 40), (rand() % 10 == 0), 0.1 * (1.0 + 0.5 * rand() / RAND_MAX));
+				}
+			}
+
+			pHierarchy->build(*pGraph);
+			checkQueries(*pGraph, *pHierarchy);
+
+			delete pGraph;
+			delete pHierarchy;
+		}
+
+	void testFileRoundTrip() {
+			CRoadGraph *pGraph = new CRoadGraph;
+			CContractionHierarchy *pHierarchy = new CContractionHierarchy;
+			CContractionHierarchy *pLoaded = new CContractionHierarchy;
+			const char *fileName = "Test-hierarchy.ch";
+
+			CRandomRoadGraph::fill(*pGraph, 500, 31);
+			pHierarchy->build(*pGraph);
+
+			CPPUNIT_ASSERT(pHierarchy->writeToFile(fileName));
+			CPPUNIT_ASSERT(pLoaded->readFromFile(fileName));
+
+			CPPUNIT_ASSERT(pHierarchy->getNodeCount() == pLoaded->getNodeCount());
+			CPPUNIT_ASSERT(pHierarchy->getEdgeCount() == pLoaded->getEdgeCount());
+			CPPUNIT_ASSERT(pHierarchy->getShortcutCount() == pLoaded->getShortcutCount());
+			CPPUNIT_ASSERT(pGraph->getNode("Node42") == pLoaded->getNode("Node42"));
+
+			checkQueries(*pGraph, *pLoaded);
+
+			// a truncated file is rejected
+			std::ofstream(fileName, std::ios::binary) << "NAVSYSCH";
+
+			CPPUNIT_ASSERT(!pLoaded->readFromFile(fileName));
+			CPPUNIT_ASSERT(0 == pLoaded->getNodeCount());
+			CPPUNIT_ASSERT(!pLoaded->readFromFile("Not-existing.ch"));
+
+			std::remove(fileName);
+
+			delete pGraph;
+			delete pHierarchy;
+			delete pLoaded;
+		}
+
+	void testDamagedFile() {
+			CRoadGraph *pGraph = new CRoadGraph;
+			CContractionHierarchy *pHierarchy = new CContractionHierarchy;
+			const char *fileName = "Test-damaged.ch";
+
+			pGraph->addNode("A", 49.0, 8.0);
+			pGraph->addNode("B", 49.0, 8.1);
+			pGraph->addNode("C", 49.0, 8.2);
+			pGraph->addEdge("A", "B");
+			pGraph->addEdge("B", "C");
+			pHierarchy->build(*pGraph);
+
+			CPPUNIT_ASSERT(pHierarchy->writeToFile(fileName));
+
+			std::ifstream 	input(fileName, std::ios::binary);
+			std::string		contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+			input.close();
+
+			// file id, version, node count and 3 names of one character: the ranks follow with their size
+			const unsigned int ranks = 8 + 4 + 4 + 3 * (4 + 1) + 4;
+			unsigned int invalid = 7;
+
+			// two nodes of the same rank
+			std::string damaged = contents;
+
+			damaged.replace(ranks + 4, 4, contents, ranks, 4);
+			CPPUNIT_ASSERT(!readDamaged(fileName, damaged));
+
+			// the ranks of two neighbours are swapped: their edges go to a node of a lower rank
+			damaged = contents;
+			damaged.replace(ranks, 4, contents, ranks + 4, 4);
+			damaged.replace(ranks + 4, 4, contents, ranks, 4);
+			CPPUNIT_ASSERT(!readDamaged(fileName, damaged));
+
+			// the last edge skips a node which does not exist
+			damaged = contents;
+			damaged.replace(damaged.size() - 4, 4, reinterpret_cast<char const *>(&invalid), 4);
+			CPPUNIT_ASSERT(!readDamaged(fileName, damaged));
+
+			CPPUNIT_ASSERT(readDamaged(fileName, contents));
+
+			std::remove(fileName);
+
+			delete pGraph;
+			delete pHierarchy;
+		}
+
+	void testShortestPathFillsRoute() {
+			CRoute* porigin 			= new CRoute;
+			CWpDatabase *pWpDatabase 	= new CWpDatabase;
+			CRoadGraph *pGraph 			= new CRoadGraph;
+			CContractionHierarchy *pHierarchy = new CContractionHierarchy;
+
+			pWpDatabase->addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 49.866851, 8.634864));
+			pWpDatabase->addWaypoint("Rheinstrasse", CWaypoint("Rheinstrasse", 49.87262, 8.63489));
+			pWpDatabase->addWaypoint("Neckarstrasse", CWaypoint("Neckarstrasse", 49.871700, 8.644417));
+			pWpDatabase->addWaypoint("Luisenplatz", CWaypoint("Luisenplatz", 49.87271, 8.65050));
+
+			pGraph->addNodes(*pWpDatabase);
+			pGraph->addEdge("Berliner Alle", "Rheinstrasse");
+			pGraph->addEdge("Rheinstrasse", "Neckarstrasse");
+			pGraph->addEdge("Neckarstrasse", "Luisenplatz");
+			pGraph->addEdge("Berliner Alle", "Luisenplatz", false, 10.0);
+
+			pHierarchy->build(*pGraph);
+
+			porigin->connectToWpDatabase(pWpDatabase);
+
+			CPPUNIT_ASSERT(porigin->addShortestPath(*pHierarchy, "Luisenplatz", "Berliner Alle"));
+			CPPUNIT_ASSERT(!porigin->addShortestPath(*pHierarchy, "Luisenplatz", "Unknown"));
+
+			const std::vector<const CWaypoint*> route = porigin->getRoute();
+			const char *expected[] = { "Luisenplatz", "Neckarstrasse", "Rheinstrasse", "Berliner Alle" };
+
+			CPPUNIT_ASSERT(4 == route.size());
+
+			for (unsigned int index = 0; index < route.size(); ++index)
+			{
+				CPPUNIT_ASSERT(!route[index]->getName().compare(expected[index]));
+			}
+
+			delete porigin;
+			delete pWpDatabase;
+			delete pGraph;
+			delete pHierarchy;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Contraction hierarchy tests");
+
+		suite->addTest(new CppUnit::TestCaller<CContractionHierarchyTest>
+				 ("Contraction hierarchy matches Dijkstra", &CContractionHierarchyTest::testMatchesDijkstra));
+
+		suite->addTest(new CppUnit::TestCaller<CContractionHierarchyTest>
+				 ("Contraction hierarchy matches Dijkstra on a street grid", &CContractionHierarchyTest::testMatchesDijkstraOnGrid));
+
+		suite->addTest(new CppUnit::TestCaller<CContractionHierarchyTest>
+				 ("Write and read the hierarchy", &CContractionHierarchyTest::testFileRoundTrip));
+
+		suite->addTest(new CppUnit::TestCaller<CContractionHierarchyTest>
+				 ("A hierarchy file with damaged ranks or edges is rejected", &CContractionHierarchyTest::testDamagedFile));
+
+		suite->addTest(new CppUnit::TestCaller<CContractionHierarchyTest>
+				 ("Shortest path of the hierarchy fills the route", &CContractionHierarchyTest::testShortestPathFillsRoute));
+
+		return suite;
+	}
+};
+
+#endif /* CCONTRACTIONHIERARCHYTEST_H_ */
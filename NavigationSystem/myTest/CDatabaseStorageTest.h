@@ -0,0 +1,374 @@
+/*
+ * CDatabaseStorageTest.h
+ */
+
+#ifndef CDATABASESTORAGETEST_H_
+#define CDATABASESTORAGETEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+#include "../myCode/CPOI.h"
+#include "../myCode/CDatabase.h"
+
+/**
+ * This class implements several test cases related to the storage policies of the CDatabase.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CDatabaseStorageTest: public CppUnit::TestFixture {
+private:
+
+	typedef CDatabase<std::string, CPOI>										Name_Database_t;
+	typedef CDatabase<std::string, CPOI, CMortonStorage<std::string, CPOI> >	Morton_Database_t;
+	typedef CDatabase<std::string, CPOI, CHashStorage<std::string, CPOI> >		Hash_Database_t;
+
+	/**
+	 * Database which gives access to the storage for the tests
+	 */
+	class CMortonDatabase : public Morton_Database_t {
+	public:
+		Morton_Database_t::Database_Storage_t &getStorage() {
+				return this->m_container;
+			}
+	};
+
+	/**
+	 * Add the same random POIs to both databases
+	 */
+	void fillDatabases(Name_Database_t *pNameDb, Morton_Database_t *pMortonDb, unsigned int count) {
+			srand(7);
+
+			for (unsigned int index = 0; index < count; ++index)
+			{
+				std::ostringstream name;
+				double latitude 	= -90 + 180.0 * rand() / RAND_MAX;
+				double longitude 	= -180 + 360.0 * rand() / RAND_MAX;
+
+				name << "POI" << index;
+				pNameDb->addElement(name.str(), CPOI(CPOI::RESTAURANT, name.str(), "", latitude, longitude));
+				pMortonDb->addElement(name.str(), CPOI(CPOI::RESTAURANT, name.str(), "", latitude, longitude));
+			}
+		}
+
+	/**
+	 * Collect the visited keys and check the element belongs to its key
+	 */
+	struct KeyCollector {
+		std::vector<std::string> keys;
+
+		void operator()(std::string const &key, CPOI const &poi) {
+				CPPUNIT_ASSERT(!poi.getName().compare(key));
+				keys.push_back(key);
+			}
+	};
+
+public:
+
+	void testMortonOrder() {
+			Name_Database_t *pNameDb 		= new Name_Database_t;
+			CMortonDatabase *pMortonDb 		= new CMortonDatabase;
+
+			fillDatabases(pNameDb, pMortonDb, 500);
+
+			CMortonCode::Morton_Code_t previous = 0;
+			unsigned int count 					= 0;
+
+			for (Morton_Database_t::Database_Storage_Itr_t itr = pMortonDb->getStorage().begin(); itr != pMortonDb->getStorage().end(); ++itr)
+			{
+				CMortonCode::Morton_Code_t code = CMortonCode::encode(itr->second.getLatitude(), itr->second.getLongitude());
+
+				CPPUNIT_ASSERT(previous <= code);
+				previous = code;
+				++count;
+			}
+
+			CPPUNIT_ASSERT(500 == count);
+
+			Name_Database_t::Database_Container_t byName 	= pNameDb->getElementsFromDatabase();
+			Name_Database_t::Database_Container_t byMorton 	= pMortonDb->getElementsFromDatabase();
+
+			CPPUNIT_ASSERT(byName.size() == byMorton.size());
+
+			for (Name_Database_t::Database_Container_Itr_t itr = byName.begin(); itr != byName.end(); ++itr)
+			{
+				CPOI *pPoi = pMortonDb->getPointerToElement(itr->first);
+
+				CPPUNIT_ASSERT(pPoi != 0);
+				CPPUNIT_ASSERT(itr->second.getLatitude() == pPoi->getLatitude());
+				CPPUNIT_ASSERT(!byMorton[itr->first].getName().compare(itr->first));
+			}
+
+			CPPUNIT_ASSERT(false == pMortonDb->hasStableAddresses());
+
+			delete pNameDb;
+			delete pMortonDb;
+		}
+
+	void testLookupByName() {
+			Morton_Database_t *pMortonDb 	= new Morton_Database_t;
+
+			pMortonDb->addElement("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "A blissful coffee", 49.872409, 8.650744));
+
+			CPPUNIT_ASSERT(!pMortonDb->getPointerToElement("Starbucks")->getName().compare("Starbucks"));
+
+			// the first element moves when one with a smaller code is added
+			pMortonDb->addElement("Sydney Opera", CPOI(CPOI::TOURISTIC, "Sydney Opera", "", -33.8568, 151.2153));
+			pMortonDb->addElement("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10", "An awesome University", 49.86727, 8.638459));
+
+			CPPUNIT_ASSERT(false == pMortonDb->addElement("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "", 0, 0)));
+
+			// the read only access finds the added elements without merging them
+			Morton_Database_t const &mortonDb = *pMortonDb;
+			KeyCollector			visited;
+			unsigned int			count = 0;
+
+			CPPUNIT_ASSERT(!mortonDb.getPointerToElement("HDA BuildingC10")->getName().compare("HDA BuildingC10"));
+			mortonDb.visitElements(visited);
+
+			for (Morton_Database_t::Database_Storage_ConstItr_t itr = mortonDb.begin(); itr != mortonDb.end(); ++itr)
+			{
+				CPPUNIT_ASSERT(&itr->second == mortonDb.getPointerToElement(itr->first));
+				++count;
+			}
+
+			CPPUNIT_ASSERT((3 == visited.keys.size()) && (3 == count));
+
+			CPPUNIT_ASSERT(!pMortonDb->getPointerToElement("Starbucks")->getName().compare("Starbucks"));
+			CPPUNIT_ASSERT(!pMortonDb->getPointerToElement("Sydney Opera")->getName().compare("Sydney Opera"));
+			CPPUNIT_ASSERT(!pMortonDb->getPointerToElement("HDA BuildingC10")->getName().compare("HDA BuildingC10"));
+			CPPUNIT_ASSERT(0 == pMortonDb->getPointerToElement("Mensa"));
+
+			Morton_Database_t::Database_Container_t elements = pMortonDb->getElementsFromDatabase();
+
+			pMortonDb->resetDatabase();
+
+			CPPUNIT_ASSERT(0 == pMortonDb->getPointerToElement("Starbucks"));
+
+			pMortonDb->setDatabase(elements);
+
+			CPPUNIT_ASSERT(3 == pMortonDb->getElementsFromDatabase().size());
+			CPPUNIT_ASSERT(!pMortonDb->getPointerToElement("Sydney Opera")->getName().compare("Sydney Opera"));
+
+			delete pMortonDb;
+		}
+
+	void testGenerationOfTheMerge() {
+			Morton_Database_t 			*pMortonDb 	= new Morton_Database_t;
+			Morton_Database_t const 	&mortonDb 	= *pMortonDb;
+
+			pMortonDb->addElement("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "A blissful coffee", 49.872409, 8.650744));
+			CPPUNIT_ASSERT(pMortonDb->getPointerToElement("Starbucks"));
+
+			// the added element has a smaller code: the merge moves the first one behind it
+			pMortonDb->addElement("Sydney Opera", CPOI(CPOI::TOURISTIC, "Sydney Opera", "", -33.8568, 151.2153));
+
+			unsigned long 	generation 	= mortonDb.getGeneration();
+			CPOI const 		*pStarbucks = mortonDb.getPointerToElement("Starbucks");
+
+			CPPUNIT_ASSERT(!pStarbucks->getName().compare("Starbucks"));
+			CPPUNIT_ASSERT(generation == mortonDb.getGeneration());
+
+			// the non-const look-up merges: the pointer read before is stale and the generation tells it
+			CPPUNIT_ASSERT(pMortonDb->getPointerToElement("Sydney Opera"));
+			CPPUNIT_ASSERT(pStarbucks != mortonDb.getPointerToElement("Starbucks"));
+			CPPUNIT_ASSERT(generation != mortonDb.getGeneration());
+
+			// without added elements a look-up moves nothing
+			generation = mortonDb.getGeneration();
+			pStarbucks = mortonDb.getPointerToElement("Starbucks");
+
+			CPPUNIT_ASSERT(pStarbucks == pMortonDb->getPointerToElement("Starbucks"));
+			CPPUNIT_ASSERT(generation == mortonDb.getGeneration());
+
+			delete pMortonDb;
+		}
+
+	void testVisitInPlace() {
+			Name_Database_t *pNameDb 		= new Name_Database_t;
+			CMortonDatabase *pMortonDb 		= new CMortonDatabase;
+			KeyCollector	byName, byMorton;
+
+			fillDatabases(pNameDb, pMortonDb, 300);
+
+			Name_Database_t const 	&nameDb 	= *pNameDb;
+			Morton_Database_t const &mortonDb 	= *pMortonDb;
+
+			// both storages visit in the order of the keys
+			nameDb.visitElements(byName);
+			mortonDb.visitElements(byMorton);
+
+			CPPUNIT_ASSERT(300 == byName.keys.size());
+			CPPUNIT_ASSERT(byName.keys == byMorton.keys);
+			CPPUNIT_ASSERT(std::is_sorted(byName.keys.begin(), byName.keys.end()));
+
+			// the iterators and the lookups give the elements in place
+			unsigned int count = 0;
+
+			for (Morton_Database_t::Database_Storage_ConstItr_t itr = mortonDb.begin(); itr != mortonDb.end(); ++itr)
+			{
+				CPPUNIT_ASSERT(&itr->second == mortonDb.getPointerToElement(itr->first));
+				++count;
+			}
+
+			CPPUNIT_ASSERT(300 == count);
+			CPPUNIT_ASSERT(300 == mortonDb.getElementCount());
+			CPPUNIT_ASSERT(nameDb.getPointerToElement(std::string("POI7")) == pNameDb->getPointerToElement("POI7"));
+			CPPUNIT_ASSERT(0 == nameDb.getPointerToElement(std::string("Mensa")));
+
+			delete pNameDb;
+			delete pMortonDb;
+		}
+
+	/**
+	 * Load a batch into a database: replace with an unsorted batch, then merge
+	 */
+	template<class TDatabase>
+	void checkBulkLoad(TDatabase *pDb) {
+			typename TDatabase::Database_Batch_t batch;
+
+			pDb->addElement("Mensa", CPOI(CPOI::RESTAURANT, "Mensa", "old", 49.8, 8.6));
+
+			batch.push_back(std::make_pair(std::string("Sydney Opera"), CPOI(CPOI::TOURISTIC, "Sydney Opera", "", -33.8568, 151.2153)));
+			batch.push_back(std::make_pair(std::string("Starbucks"), CPOI(CPOI::RESTAURANT, "Starbucks", "first", 49.872409, 8.650744)));
+			batch.push_back(std::make_pair(std::string("Starbucks"), CPOI(CPOI::RESTAURANT, "Starbucks", "second", 0, 0)));
+
+			// the old content is gone, the first of the equal keys is kept
+			CPPUNIT_ASSERT(2 == pDb->replaceElements(batch));
+			CPPUNIT_ASSERT(batch.empty());
+			CPPUNIT_ASSERT(2 == pDb->getElementCount());
+			CPPUNIT_ASSERT(0 == pDb->getPointerToElement("Mensa"));
+			CPPUNIT_ASSERT(49.872409 == pDb->getPointerToElement("Starbucks")->getLatitude());
+
+			batch.push_back(std::make_pair(std::string("Mensa"), CPOI(CPOI::RESTAURANT, "Mensa", "", 49.8, 8.6)));
+			batch.push_back(std::make_pair(std::string("Starbucks"), CPOI(CPOI::RESTAURANT, "Starbucks", "third", 0, 0)));
+			batch.push_back(std::make_pair(std::string("Zoo"), CPOI(CPOI::TOURISTIC, "Zoo", "", 50.0, 8.0)));
+
+			// the existing elements win
+			CPPUNIT_ASSERT(2 == pDb->mergeElements(batch));
+			CPPUNIT_ASSERT(4 == pDb->getElementCount());
+			CPPUNIT_ASSERT(49.872409 == pDb->getPointerToElement("Starbucks")->getLatitude());
+			CPPUNIT_ASSERT(!pDb->getPointerToElement("Zoo")->getName().compare("Zoo"));
+
+			KeyCollector visited;
+
+			pDb->visitElements(visited);
+			CPPUNIT_ASSERT(4 == visited.keys.size());
+			CPPUNIT_ASSERT(std::is_sorted(visited.keys.begin(), visited.keys.end()));
+
+			// the print follows the order of the names as well
+			std::ostringstream 	output;
+			std::streambuf 		*pConsole = std::cout.rdbuf(output.rdbuf());
+
+			pDb->print();
+			std::cout.rdbuf(pConsole);
+
+			std::string::size_type 	mensa 		= output.str().find(": Mensa\n");
+			std::string::size_type 	starbucks 	= output.str().find(": Starbucks\n");
+			std::string::size_type 	sydney 		= output.str().find(": Sydney Opera\n");
+			std::string::size_type 	zoo 		= output.str().find(": Zoo\n");
+
+			CPPUNIT_ASSERT((mensa < starbucks) && (starbucks < sydney) && (sydney < zoo) && (zoo != std::string::npos));
+		}
+
+	void testBulkLoad() {
+			Name_Database_t 	*pNameDb 	= new Name_Database_t;
+			Morton_Database_t 	*pMortonDb 	= new Morton_Database_t;
+			Hash_Database_t 	*pHashDb 	= new Hash_Database_t;
+
+			checkBulkLoad(pNameDb);
+			checkBulkLoad(pMortonDb);
+			checkBulkLoad(pHashDb);
+
+			delete pNameDb;
+			delete pMortonDb;
+			delete pHashDb;
+		}
+
+	void testHashLookup() {
+			Name_Database_t *pNameDb 		= new Name_Database_t;
+			Hash_Database_t *pHashDb 		= new Hash_Database_t;
+			KeyCollector	byName, byHash;
+
+			// grows the table several times
+			for (unsigned int index = 0; index < 5000; ++index)
+			{
+				std::ostringstream name;
+
+				name << "POI" << (index * 7919) % 5003;
+				pNameDb->addElement(name.str(), CPOI(CPOI::RESTAURANT, name.str(), "", 49.0 + index * 0.0001, 8.0));
+				pHashDb->addElement(name.str(), CPOI(CPOI::RESTAURANT, name.str(), "", 49.0 + index * 0.0001, 8.0));
+			}
+
+			CPPUNIT_ASSERT(false == pHashDb->addElement("POI0", CPOI(CPOI::RESTAURANT, "POI0", "", 0, 0)));
+			CPPUNIT_ASSERT(5000 == pHashDb->getElementCount());
+
+			for (Name_Database_t::Database_Storage_ConstItr_t itr = pNameDb->begin(); itr != pNameDb->end(); ++itr)
+			{
+				CPOI *pPoi = pHashDb->getPointerToElement(itr->first);
+
+				CPPUNIT_ASSERT(pPoi != 0);
+				CPPUNIT_ASSERT(!pPoi->getName().compare(itr->first));
+				CPPUNIT_ASSERT(itr->second.getLatitude() == pPoi->getLatitude());
+			}
+
+			CPPUNIT_ASSERT(0 == pHashDb->getPointerToElement("POI5003"));
+			CPPUNIT_ASSERT(0 == pHashDb->getPointerToElement(""));
+
+			// without a bulk load the key order is sorted for every visit
+			pNameDb->visitElements(byName);
+			pHashDb->visitElements(byHash);
+			CPPUNIT_ASSERT(byName.keys == byHash.keys);
+
+			// a bulk load sorts the key order, an added element drops it
+			pHashDb->setDatabase(pNameDb->getElementsFromDatabase());
+			byHash.keys.clear();
+			pHashDb->visitElements(byHash);
+			CPPUNIT_ASSERT(byName.keys == byHash.keys);
+
+			pHashDb->addElement("AAA", CPOI(CPOI::RESTAURANT, "AAA", "", 0, 0));
+			byHash.keys.clear();
+			pHashDb->visitElements(byHash);
+			CPPUNIT_ASSERT(5001 == byHash.keys.size());
+			CPPUNIT_ASSERT(!byHash.keys.front().compare("AAA"));
+
+			CPPUNIT_ASSERT(false == pHashDb->hasStableAddresses());
+
+			delete pNameDb;
+			delete pHashDb;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Database storage tests");
+
+		suite->addTest(new CppUnit::TestCaller<CDatabaseStorageTest>
+				 ("Morton storage keeps the Z-order", &CDatabaseStorageTest::testMortonOrder));
+
+		suite->addTest(new CppUnit::TestCaller<CDatabaseStorageTest>
+				 ("Morton storage finds elements by name", &CDatabaseStorageTest::testLookupByName));
+
+		suite->addTest(new CppUnit::TestCaller<CDatabaseStorageTest>
+				 ("Morton storage changes the generation when it merges", &CDatabaseStorageTest::testGenerationOfTheMerge));
+
+		suite->addTest(new CppUnit::TestCaller<CDatabaseStorageTest>
+				 ("Both storages are read in place", &CDatabaseStorageTest::testVisitInPlace));
+
+		suite->addTest(new CppUnit::TestCaller<CDatabaseStorageTest>
+				 ("All storages load and merge batches", &CDatabaseStorageTest::testBulkLoad));
+
+		suite->addTest(new CppUnit::TestCaller<CDatabaseStorageTest>
+				 ("Hash storage finds elements by name", &CDatabaseStorageTest::testHashLookup));
+
+		return suite;
+	}
+};
+
+#endif /* CDATABASESTORAGETEST_H_ */
@@ -0,0 +1,171 @@
+/*
+ * CDistanceKernelTest.h
+ */
+
+#ifndef CDISTANCEKERNELTEST_H_
+#define CDISTANCEKERNELTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "../myCode/CWaypoint.h"
+#include "../myCode/CDistanceKernel.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class implements several test cases related to the CDistanceKernel.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CDistanceKernelTest: public CppUnit::TestFixture {
+private:
+
+	std::vector<double> latitudes, longitudes;
+
+	/**
+	 * Random positions all over the world, close to the date line, the poles and the origin
+	 */
+	void fillPositions(double originLatitude, double originLongitude) {
+			srand(3);
+			latitudes.clear();
+			longitudes.clear();
+
+			for (unsigned int index = 0; index < 1001; ++index)
+			{
+				double latitude 	= -90 + 180.0 * rand() / RAND_MAX;
+				double longitude 	= -180 + 360.0 * rand() / RAND_MAX;
+
+				if (index % 4 == 1)
+				{
+					// a few meters away from the origin
+					latitude 	= originLatitude + 1e-4 * rand() / RAND_MAX;
+					longitude 	= originLongitude + 1e-4 * rand() / RAND_MAX;
+				}
+
+				latitudes.push_back(latitude);
+				longitudes.push_back(longitude);
+			}
+
+			latitudes[2] = 90;		longitudes[2] = 180;
+			latitudes[3] = -90;		longitudes[3] = -180;
+		}
+
+	void checkImplementation(CDistanceKernel::t_implementation implementation, double originLatitude, double originLongitude) {
+			std::vector<double> distances(latitudes.size());
+			CWaypoint origin("Origin", originLatitude, originLongitude);
+
+			CPPUNIT_ASSERT(CDistanceKernel::setImplementation(implementation));
+
+			CDistanceKernel::haversine(originLatitude, originLongitude, &latitudes[0], &longitudes[0], latitudes.size(), &distances[0]);
+
+			unsigned int nearest = 0;
+
+			for (unsigned int index = 0; index < latitudes.size(); ++index)
+			{
+				double expected = origin.calculateDistance(CWaypoint("Position", latitudes[index], longitudes[index]));
+
+				// 1 mm: asin(sqrt(a)) is ill-conditioned close to the antipode
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(expected, distances[index], 1e-6);
+
+				if (distances[index] < distances[nearest])
+				{
+					nearest = index;
+				}
+			}
+
+			CPPUNIT_ASSERT(nearest == CDistanceKernel::nearest(originLatitude, originLongitude, &latitudes[0], &longitudes[0], latitudes.size()));
+		}
+
+public:
+
+	void testImplementationsMatchCalculateDistance() {
+			const CDistanceKernel::t_implementation implementations[] = { CDistanceKernel::SCALAR, CDistanceKernel::SSE2, CDistanceKernel::AVX2 };
+			const double origins[][2] = { { 49.86727, 8.638459 }, { -33.8568, 179.99 }, { 89.999, -45 } };
+			CDistanceKernel::t_implementation selected = CDistanceKernel::getImplementation();
+
+			for (unsigned int origin = 0; origin < sizeof(origins) / sizeof(origins[0]); ++origin)
+			{
+				fillPositions(origins[origin][0], origins[origin][1]);
+
+				for (unsigned int index = 0; index < sizeof(implementations) / sizeof(implementations[0]); ++index)
+				{
+					if (CDistanceKernel::isSupported(implementations[index]))
+					{
+						checkImplementation(implementations[index], origins[origin][0], origins[origin][1]);
+					}
+				}
+			}
+
+			CDistanceKernel::setImplementation(selected);
+		}
+
+	void testRadiansWithCachedCosines() {
+			double latitudes[] 		= { 49.872409 * DEG_TO_RAD, 49.86727 * DEG_TO_RAD, -33.8568 * DEG_TO_RAD };
+			double longitudes[] 	= { 8.650744 * DEG_TO_RAD, 8.638459 * DEG_TO_RAD, 151.2153 * DEG_TO_RAD };
+			double cosLatitudes[] 	= { cos(latitudes[0]), cos(latitudes[1]), cos(latitudes[2]) };
+			double withCosines[3], withoutCosines[3];
+			CWaypoint origin("Origin", 49.8, 8.6);
+
+			CDistanceKernel::haversineRadians(49.8 * DEG_TO_RAD, 8.6 * DEG_TO_RAD, cos(49.8 * DEG_TO_RAD), latitudes, longitudes, cosLatitudes, 3, withCosines);
+			CDistanceKernel::haversineRadians(49.8 * DEG_TO_RAD, 8.6 * DEG_TO_RAD, cos(49.8 * DEG_TO_RAD), latitudes, longitudes, 0, 3, withoutCosines);
+
+			for (unsigned int index = 0; index < 3; ++index)
+			{
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(withCosines[index], withoutCosines[index], 1e-9);
+			}
+
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(origin.calculateDistance(CWaypoint("Sydney", -33.8568, 151.2153)), withCosines[2], 1e-6);
+			CPPUNIT_ASSERT(0 == CDistanceKernel::nearest(49.8, 8.6, latitudes, longitudes, 0));
+		}
+
+	void testTrigonometryCache() {
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+			double coord[3];
+
+			pPOIDatabase->addPoi("Sydney Opera", CPOI(CPOI::TOURISTIC, "Sydney Opera", "", -33.8568, 151.2153));
+
+			// the cache is copied into the database with the POI
+			CPOI *pPoi = pPOIDatabase->getPointerToPoi("Sydney Opera");
+
+			pPoi->getUnitVector(coord);
+
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(-33.8568 * DEG_TO_RAD, pPoi->getLatitudeRad(), 1e-15);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(151.2153 * DEG_TO_RAD, pPoi->getLongitudeRad(), 1e-15);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(cos(-33.8568 * DEG_TO_RAD), pPoi->getCosLatitude(), 1e-15);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, coord[0] * coord[0] + coord[1] * coord[1] + coord[2] * coord[2], 1e-15);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(sin(-33.8568 * DEG_TO_RAD), coord[2], 1e-15);
+
+			// an invalid waypoint is placed at 0, 0
+			CWaypoint invalid("", 100, 0);
+
+			invalid.getUnitVector(coord);
+
+			CPPUNIT_ASSERT(1.0 == coord[0] && 0.0 == coord[1] && 0.0 == coord[2]);
+			CPPUNIT_ASSERT(0.0 == invalid.calculateDistance(CWaypoint("Origin", 0, 0)));
+
+			delete pPOIDatabase;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Distance kernel tests");
+
+		suite->addTest(new CppUnit::TestCaller<CDistanceKernelTest>
+				 ("All the implementations match calculateDistance", &CDistanceKernelTest::testImplementationsMatchCalculateDistance));
+
+		suite->addTest(new CppUnit::TestCaller<CDistanceKernelTest>
+				 ("Radians with cached cosines", &CDistanceKernelTest::testRadiansWithCachedCosines));
+
+		suite->addTest(new CppUnit::TestCaller<CDistanceKernelTest>
+				 ("Cached trigonometry of a waypoint", &CDistanceKernelTest::testTrigonometryCache));
+
+		return suite;
+	}
+};
+
+#endif /* CDISTANCEKERNELTEST_H_ */
@@ -0,0 +1,141 @@
+/*
+ * CDistanceModelTest.h
+ */
+
+#ifndef CDISTANCEMODELTEST_H_
+#define CDISTANCEMODELTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <cmath>
+#include <sstream>
+
+#include "../myCode/CWaypoint.h"
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class implements several test cases related to the distance models of CWaypoint.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CDistanceModelTest: public CppUnit::TestFixture {
+public:
+
+	void testVincentyReference() {
+			// Flinders Peak to Buninyong, the worked example of Vincenty's inverse formula: 54972.271 m
+			CWaypoint flindersPeak("Flinders Peak", -(37 + 57 / 60.0 + 3.72030 / 3600), 144 + 25 / 60.0 + 29.52440 / 3600);
+			CWaypoint buninyong("Buninyong", -(37 + 39 / 60.0 + 10.15610 / 3600), 143 + 55 / 60.0 + 35.38390 / 3600);
+
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(54.972271, flindersPeak.calculateDistance(buninyong, CWaypoint::VINCENTY), 1e-6);
+			CPPUNIT_ASSERT(0.0 == flindersPeak.calculateDistance(flindersPeak, CWaypoint::VINCENTY));
+
+			// the iteration does not converge for antipodal points: the haversine distance is returned
+			CWaypoint origin("Origin", 0, 0), antipode("Antipode", 0, 180);
+
+			CPPUNIT_ASSERT(origin.calculateDistance(antipode) == origin.calculateDistance(antipode, CWaypoint::VINCENTY));
+		}
+
+	void testErrorBounds() {
+			srand(5);
+
+			for (unsigned int index = 0; index < 10000; ++index)
+			{
+				CWaypoint first("First", -89 + 178.0 * rand() / RAND_MAX, -180 + 360.0 * rand() / RAND_MAX);
+				CWaypoint second("Second", -89 + 178.0 * rand() / RAND_MAX, -180 + 360.0 * rand() / RAND_MAX);
+
+				double haversine 	= first.calculateDistance(second);
+				double vincenty 	= first.calculateDistance(second, CWaypoint::VINCENTY);
+
+				CPPUNIT_ASSERT(vincenty >= haversine * ELLIPSOID_RATIO_MIN && vincenty <= haversine * ELLIPSOID_RATIO_MAX);
+
+				// below 100 km and 70 degrees, across the date line as well
+				double latitude 	= -69.7 + 139.4 * rand() / RAND_MAX;
+				CWaypoint near("Near", latitude, 179.7 + 0.3 * rand() / RAND_MAX);
+				CWaypoint local("Local", latitude + 0.6 * rand() / RAND_MAX - 0.3, -180 + 0.3 * rand() / RAND_MAX);
+
+				haversine = near.calculateDistance(local);
+
+				if (haversine < 100)
+				{
+					CPPUNIT_ASSERT_DOUBLES_EQUAL(haversine, near.calculateDistance(local, CWaypoint::EQUIRECTANGULAR), haversine * 1e-3);
+				}
+			}
+		}
+
+	void testNearestPoiUnderModel() {
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+			double distance;
+
+			// a degree of latitude is shorter than a degree of longitude on the equator of the ellipsoid
+			pPOIDatabase->addPoi("North", CPOI(CPOI::TOURISTIC, "North", "", 1, 0));
+			pPOIDatabase->addPoi("East", CPOI(CPOI::TOURISTIC, "East", "", 0, 0.995));
+
+			CPPUNIT_ASSERT(pPOIDatabase->getPointerToPoi("East") == pPOIDatabase->getNearestPoi(0, 0, CWaypoint::HAVERSINE, distance));
+			CPPUNIT_ASSERT(pPOIDatabase->getPointerToPoi("East") == pPOIDatabase->getNearestPoi(0, 0, CWaypoint::EQUIRECTANGULAR, distance));
+			CPPUNIT_ASSERT(pPOIDatabase->getPointerToPoi("North") == pPOIDatabase->getNearestPoi(0, 0, CWaypoint::VINCENTY, distance));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(110.574, distance, 1e-3);
+
+			// the re-ranked result matches a full scan
+			srand(9);
+
+			for (unsigned int index = 0; index < 2000; ++index)
+			{
+				std::ostringstream name;
+
+				name << "POI" << index;
+				pPOIDatabase->addPoi(name.str(), CPOI(CPOI::RESTAURANT, name.str(), "", 49 + 2.0 * rand() / RAND_MAX, 8 + 2.0 * rand() / RAND_MAX));
+			}
+
+			CPoiDatabase::Poi_Map_t pois = pPOIDatabase->getPoisFromDatabase();
+
+			for (unsigned int query = 0; query < 50; ++query)
+			{
+				CWaypoint position("Position", 49 + 2.0 * rand() / RAND_MAX, 8 + 2.0 * rand() / RAND_MAX);
+				double shortest = 0;
+
+				for (CPoiDatabase::Poi_Map_Itr_t itr = pois.begin(); itr != pois.end(); ++itr)
+				{
+					double poiDistance = position.calculateDistance(itr->second, CWaypoint::VINCENTY);
+
+					if (itr == pois.begin() || poiDistance < shortest)
+					{
+						shortest = poiDistance;
+					}
+				}
+
+				CPPUNIT_ASSERT(0 != pPOIDatabase->getNearestPoi(position.getLatitude(), position.getLongitude(), CWaypoint::VINCENTY, distance));
+				CPPUNIT_ASSERT(shortest == distance);
+			}
+
+			CPPUNIT_ASSERT(0 == CPoiDatabase().getNearestPoi(0, 0, CWaypoint::VINCENTY, distance));
+
+			// an invalid position finds nothing instead of the POIs around 0, 0
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getNearestPoi(91, 0, CWaypoint::HAVERSINE, distance));
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getNearestPoi(0, -180.5, CWaypoint::VINCENTY, distance));
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getNearestPoi(0, 200, CPOI::TOURISTIC));
+			CPPUNIT_ASSERT(0 != pPOIDatabase->getNearestPoi(-90, 180, CPOI::TOURISTIC));
+
+			delete pPOIDatabase;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Distance model tests");
+
+		suite->addTest(new CppUnit::TestCaller<CDistanceModelTest>
+				 ("Vincenty reference distance", &CDistanceModelTest::testVincentyReference));
+
+		suite->addTest(new CppUnit::TestCaller<CDistanceModelTest>
+				 ("Error bounds of the distance models", &CDistanceModelTest::testErrorBounds));
+
+		suite->addTest(new CppUnit::TestCaller<CDistanceModelTest>
+				 ("Nearest POI under a distance model", &CDistanceModelTest::testNearestPoiUnderModel));
+
+		return suite;
+	}
+};
+
+#endif /* CDISTANCEMODELTEST_H_ */
@@ -0,0 +1,240 @@
+/*
+ * CGPSSourceTest.h
+ */
+
+#ifndef CGPSSOURCETEST_H_
+#define CGPSSOURCETEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../myCode/CRingBuffer.h"
+#include "../myCode/CGPSSource.h"
+#include "../myCode/CNmeaGPSProvider.h"
+#include "../myCode/CCsvGPSProvider.h"
+#include "../myCode/CSyntheticGPSProvider.h"
+
+/**
+ * This class implements several test cases related to the CGPSSource and its providers.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CGPSSourceTest: public CppUnit::TestFixture {
+private:
+
+	/**
+	 * Complete a sentence "$...": append '*' and the checksum
+	 */
+	static std::string withChecksum(std::string const &sentence) {
+			unsigned char 	checksum = 0;
+			char 			hex[4];
+
+			for (unsigned int index = 1; index < sentence.size(); ++index)
+			{
+				checksum ^= (unsigned char)sentence[index];
+			}
+
+			snprintf(hex, sizeof(hex), "*%02X", checksum);
+
+			return sentence + hex;
+		}
+
+	/**
+	 * Take all the fixes of a started source
+	 */
+	static std::vector<CGPSFix> drain(CGPSSource &source) {
+			std::vector<CGPSFix> 	fixes;
+			CGPSFix 				fix;
+
+			while (!source.isFinished())
+			{
+				if (source.poll(fix))
+				{
+					fixes.push_back(fix);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+
+			return fixes;
+		}
+
+public:
+
+	void testRingBufferKeepsOrder() {
+			CRingBuffer<unsigned int> 	buffer(100);
+			const unsigned int 			count = 200000;
+
+			CPPUNIT_ASSERT(128 == buffer.getCapacity());
+			CPPUNIT_ASSERT(buffer.isEmpty());
+
+			std::thread producer([&buffer, count]() {
+					for (unsigned int value = 0; value < count; ++value)
+					{
+						while (!buffer.push(value))
+						{
+							std::this_thread::yield();
+						}
+					}
+				});
+
+			unsigned int expected = 0;
+
+			while (expected < count)
+			{
+				unsigned int value;
+
+				if (buffer.pop(value))
+				{
+					CPPUNIT_ASSERT(expected == value);
+					expected++;
+				}
+			}
+
+			producer.join();
+
+			CPPUNIT_ASSERT(buffer.isEmpty());
+		}
+
+	void testNmeaProvider() {
+			const char		*fileName = "GPSSourceTest.nmea";
+			std::ofstream 	log(fileName);
+
+			log << withChecksum("$GPGGA,120000.00,4952.0111,N,00838.0919,E,1,08,0.9,145.0,M,47.9,M,,") << "\r\n";
+			// the RMC sentence of the same epoch
+			log << withChecksum("$GPRMC,120000.00,A,4952.0111,N,00838.0919,E,0.0,0.0,010120,,,A") << "\n";
+			// other sentences and a broken checksum
+			log << withChecksum("$GPGSV,3,1,11,01,45,120,40") << "\n";
+			log << "$GPGGA,120001.00,4952.0111,N,00838.0919,E,1,08,0.9,145.0,M,47.9,M,,*00\n";
+			// no fix and a warning
+			log << withChecksum("$GPGGA,120002.00,,,,,0,00,,,M,,M,,") << "\n";
+			log << withChecksum("$GPRMC,120003.00,V,3351.0000,S,15112.0000,E,0.0,0.0,010120,,,N") << "\n";
+			// the southern and the western hemisphere, another talker
+			log << withChecksum("$GNRMC,120004.50,A,3351.0000,S,15112.0000,E,0.0,0.0,010120,,,A") << "\n";
+			log << withChecksum("$GNGGA,120005.00,4042.7680,N,07400.3600,W,2,10,0.8,10.0,M,-34.0,M,,") << "\n";
+			log.close();
+
+			CNmeaGPSProvider 	provider(fileName);
+			CGPSSource 			source(&provider, 2);
+
+			CPPUNIT_ASSERT(source.start());
+
+			std::vector<CGPSFix> fixes = drain(source);
+
+			std::remove(fileName);
+
+			CPPUNIT_ASSERT(3 == fixes.size());
+			CPPUNIT_ASSERT(3 == provider.getRejectedCount());
+
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(43200.0, fixes[0].time, 1e-9);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(49.866851, fixes[0].latitude, 1e-6);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(8.634865, fixes[0].longitude, 1e-6);
+
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(43204.5, fixes[1].time, 1e-9);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(-33.85, fixes[1].latitude, 1e-9);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(151.2, fixes[1].longitude, 1e-9);
+
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(40.7128, fixes[2].latitude, 1e-9);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(-74.006, fixes[2].longitude, 1e-9);
+
+			// the log is missing
+			CNmeaGPSProvider 	missing("GPSSourceTest.missing");
+			CGPSSource 			missingSource(&missing);
+
+			CPPUNIT_ASSERT(!missingSource.start());
+		}
+
+	void testCsvProvider() {
+			const char		*fileName = "GPSSourceTest.csv";
+			std::ofstream 	trace(fileName);
+
+			trace << "0; 49.866851; 8.634864\n";
+			trace << "1;-33.85;151.2\r\n";
+			trace << "\n";
+			trace << "2; 49.8; \n";
+			trace << "3; 95; 8.6\n";
+			trace << "4; 49.8; 8.6; 12\n";
+			trace << "5 ; -0.5 ; -179.5\n";
+			trace.close();
+
+			CCsvGPSProvider 	provider(fileName);
+			CGPSSource 			source(&provider);
+
+			CPPUNIT_ASSERT(source.start());
+
+			std::vector<CGPSFix> fixes = drain(source);
+
+			std::remove(fileName);
+
+			CPPUNIT_ASSERT(3 == fixes.size());
+			CPPUNIT_ASSERT(3 == provider.getRejectedCount());
+
+			CPPUNIT_ASSERT(0 == fixes[0].time && 49.866851 == fixes[0].latitude && 8.634864 == fixes[0].longitude);
+			CPPUNIT_ASSERT(1 == fixes[1].time && -33.85 == fixes[1].latitude && 151.2 == fixes[1].longitude);
+			CPPUNIT_ASSERT(5 == fixes[2].time && -0.5 == fixes[2].latitude && -179.5 == fixes[2].longitude);
+		}
+
+	void testSyntheticTraceIsRepeatable() {
+			CSyntheticGPSProvider 	provider(49.866851, 8.634864, 5000, 0.02, 7);
+			CGPSSource 				source(&provider, 16);
+
+			CPPUNIT_ASSERT(source.start());
+
+			std::vector<CGPSFix> fixes = drain(source);
+
+			CPPUNIT_ASSERT(5000 == fixes.size());
+
+			// the same seed gives the same trace, directly from the provider
+			CGPSFix fix;
+
+			CPPUNIT_ASSERT(provider.open());
+
+			for (unsigned int index = 0; index < fixes.size(); ++index)
+			{
+				CPPUNIT_ASSERT(provider.readFix(fix));
+				CPPUNIT_ASSERT(index == fixes[index].time);
+				CPPUNIT_ASSERT(fix.latitude == fixes[index].latitude && fix.longitude == fixes[index].longitude);
+
+				// about 20 m per second
+				if (index > 0)
+				{
+					CWaypoint previous("Previous", fixes[index - 1].latitude, fixes[index - 1].longitude);
+					CWaypoint current("Current", fixes[index].latitude, fixes[index].longitude);
+
+					CPPUNIT_ASSERT_DOUBLES_EQUAL(0.02, previous.calculateDistance(current), 1e-4);
+				}
+			}
+
+			CPPUNIT_ASSERT(!provider.readFix(fix));
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("GPS source tests");
+
+		suite->addTest(new CppUnit::TestCaller<CGPSSourceTest>
+				 ("Ring buffer passes the elements between two threads in order", &CGPSSourceTest::testRingBufferKeepsOrder));
+
+		suite->addTest(new CppUnit::TestCaller<CGPSSourceTest>
+				 ("NMEA log with checksums, invalid fixes and hemispheres", &CGPSSourceTest::testNmeaProvider));
+
+		suite->addTest(new CppUnit::TestCaller<CGPSSourceTest>
+				 ("CSV trace skips malformed lines", &CGPSSourceTest::testCsvProvider));
+
+		suite->addTest(new CppUnit::TestCaller<CGPSSourceTest>
+				 ("Synthetic trace is repeatable", &CGPSSourceTest::testSyntheticTraceIsRepeatable));
+
+		return suite;
+	}
+};
+
+#endif /* CGPSSOURCETEST_H_ */
@@ -72,6 +72,72 @@ public:
 			delete pPOIDatabase;
 		}
 
+	void testGetDistanceNextPoiOfRoute() {
+			CRoute* porigin 			= new CRoute;
+			CWpDatabase *pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+			CPOI poi;
+			CWaypoint position("Berliner Alle", 49.866851, 8.634864);
+
+			pWpDatabase->addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 49.866851, 8.634864));
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10"	, "An awesome University", 49.86727, 8.638459));
+			pPOIDatabase->addPoi("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "A blissful coffee", 49.872409, 8.650744));
+
+			porigin->connectToWpDatabase(pWpDatabase);
+			porigin->connectToPoiDatabase(pPOIDatabase);
+			porigin->addWaypoint("Berliner Alle");
+			porigin->addPoi("Starbucks", "Berliner Alle");
+
+			// the closest POI of the route, not the closest POI of the database
+			CPPUNIT_ASSERT(porigin->getDistanceNextPoi(position, poi) == pPOIDatabase->getPointerToPoi("Starbucks")->CWaypoint::calculateDistance(position));
+			CPPUNIT_ASSERT(!poi.getName().compare("Starbucks"));
+			CPPUNIT_ASSERT(porigin->getDistanceNextDatabasePoi(position, poi) == pPOIDatabase->getPointerToPoi("HDA BuildingC10")->CWaypoint::calculateDistance(position));
+			CPPUNIT_ASSERT(!poi.getName().compare("HDA BuildingC10"));
+
+			// the index of the route follows the route and the database
+			porigin->addPoi("HDA BuildingC10", "Berliner Alle");
+			porigin->getDistanceNextPoi(position, poi, CWaypoint::VINCENTY);
+			CPPUNIT_ASSERT(!poi.getName().compare("HDA BuildingC10"));
+
+			pPOIDatabase->addPoi("Mensa", CPOI(CPOI::RESTAURANT, "Mensa", "Lunch", 49.8669, 8.6349));
+			porigin->getDistanceNextPoi(position, poi);
+			CPPUNIT_ASSERT(!poi.getName().compare("HDA BuildingC10"));
+
+			delete porigin;
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+	void testGetDistanceNextPoisBatch() {
+			CRoute* porigin 			= new CRoute;
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+			CPoiDatabase::Poi_Neighbour_Container_t results, single;
+			CWaypoint positions[3] = { CWaypoint("Berliner Alle", 49.866851, 8.634864),
+									   CWaypoint("Neckarstrasse", 49.871700, 8.644417),
+									   CWaypoint("Rheinstrasse", 49.872000, 8.651000) };
+
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10"	, "An awesome University", 49.86727, 8.638459));
+			pPOIDatabase->addPoi("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "A blissful coffee", 49.872409, 8.650744));
+
+			porigin->connectToPoiDatabase(pPOIDatabase);
+			porigin->getDistanceNextPois(positions, 3, 3, results);
+
+			CPPUNIT_ASSERT(9 == results.size());
+
+			for (unsigned int query = 0; query < 3; ++query)
+			{
+				pPOIDatabase->getNearestPois(positions[query].getLatitude(), positions[query].getLongitude(), 3, single);
+
+				CPPUNIT_ASSERT(2 == single.size());
+				CPPUNIT_ASSERT(results[query * 3].pElement == single[0].pElement);
+				CPPUNIT_ASSERT(results[query * 3 + 1].pElement == single[1].pElement);
+				CPPUNIT_ASSERT(results[query * 3 + 2].pElement == 0);
+			}
+
+			delete porigin;
+			delete pPOIDatabase;
+		}
+
 	static CppUnit::TestSuite* suite() {
 		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Get distance tests");
 
@@ -81,6 +147,12 @@ public:
 		suite->addTest(new CppUnit::TestCaller<CGetDistanceNextPoiTest>
 				 ("Get Distance", &CGetDistanceNextPoiTest::testGetDistanceNextPoiRoute));
 
+		suite->addTest(new CppUnit::TestCaller<CGetDistanceNextPoiTest>
+				 ("Get Distance to the closest POI of the route", &CGetDistanceNextPoiTest::testGetDistanceNextPoiOfRoute));
+
+		suite->addTest(new CppUnit::TestCaller<CGetDistanceNextPoiTest>
+				 ("Get Distances for a batch of positions", &CGetDistanceNextPoiTest::testGetDistanceNextPoisBatch));
+
 		return suite;
 	}
 };
@@ -0,0 +1,353 @@
+/*
+ * CMappedDatabaseTest.h
+ */
+
+#ifndef CMAPPEDDATABASETEST_H_
+#define CMAPPEDDATABASETEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#include "../myCode/CMappedDatabase.h"
+#include "../myCode/CSnapshot.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+#include "CRandomPoiDatabase.h"
+
+/**
+ * Collects the names of the rows visited by the mapped database
+ */
+struct CMappedRowCollector
+{
+	CMappedDatabase const			*pDatabase;
+	bool							isPoi;
+	std::vector<std::string>		names;
+
+	CMappedRowCollector(CMappedDatabase const *pDatabase, bool isPoi) : pDatabase(pDatabase), isPoi(isPoi)
+	{
+	}
+
+	void operator()(CMappedDatabase::Row_t row)
+	{
+		this->names.push_back(std::string(this->isPoi ? this->pDatabase->getPoiName(row) : this->pDatabase->getWaypointName(row)));
+	}
+};
+
+/**
+ * Collects the names of the elements visited by the heap databases
+ */
+struct CHeapElementCollector
+{
+	std::vector<std::string>		names;
+
+	void operator()(CWaypoint const &element)
+	{
+		this->names.push_back(element.getName());
+	}
+};
+
+/**
+ * This class implements several test cases related to the queries on a mapped snapshot.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CMappedDatabaseTest: public CppUnit::TestFixture {
+private:
+
+	CWpDatabase 	m_wpDatabase;
+	CPoiDatabase 	m_poiDatabase;
+	CMappedDatabase m_mapped;
+
+	/**
+	 * Check that both results hold the same POIs in the same order at the same distances
+	 */
+	static void assertSameResult(CPoiDatabase::Poi_Neighbour_Container_t const &heapResult, CMappedDatabase const &mapped,
+			CMappedDatabase::Neighbour_Container_t const &mappedResult) {
+			CPPUNIT_ASSERT(heapResult.size() == mappedResult.size());
+
+			for (unsigned int index = 0; index < heapResult.size(); ++index)
+			{
+				CPPUNIT_ASSERT(heapResult[index].pElement->getName() == mapped.getPoiName(mappedResult[index].row));
+				CPPUNIT_ASSERT(heapResult[index].distance == mappedResult[index].distance);
+			}
+		}
+
+public:
+
+	void setUp() {
+			srand(7);
+
+			for (unsigned int index = 0; index < 300; ++index)
+			{
+				char name[32];
+
+				snprintf(name, sizeof(name), "Waypoint %u", index);
+				this->m_wpDatabase.addWaypoint(name, CWaypoint(name, -90.0 + 180.0 * rand() / RAND_MAX, -180.0 + 360.0 * rand() / RAND_MAX));
+			}
+
+			CRandomPoiDatabase::fill(&this->m_poiDatabase, 2000, 8, -90, 90, CPOI::DEFAULT_POI);
+
+			CSnapshot snapshot;
+
+			snapshot.setMediaName("MappedDatabaseTest.snapshot");
+			CPPUNIT_ASSERT(snapshot.writeData(this->m_wpDatabase, this->m_poiDatabase));
+			CPPUNIT_ASSERT(this->m_mapped.open("MappedDatabaseTest.snapshot"));
+		}
+
+	void tearDown() {
+			this->m_mapped.close();
+			std::remove("MappedDatabaseTest.snapshot");
+		}
+
+	void testLookup() {
+			CPPUNIT_ASSERT(this->m_mapped.verify());
+			CPPUNIT_ASSERT(300 == this->m_mapped.getWaypointCount());
+			CPPUNIT_ASSERT(2000 == this->m_mapped.getPoiCount());
+
+			CMappedDatabase::Row_t row = this->m_mapped.findPoi("POI1234");
+
+			CPPUNIT_ASSERT(row < this->m_mapped.getPoiCount());
+			CPPUNIT_ASSERT("POI1234" == this->m_mapped.getPoiName(row));
+			CPPUNIT_ASSERT("Description 2" == this->m_mapped.getPoiDescription(row));
+
+			CPOI const 	*pPoi 	= this->m_poiDatabase.getPointerToPoi("POI1234");
+			CPOI 		poi 	= this->m_mapped.getPoi(row);
+
+			CPPUNIT_ASSERT(pPoi->getPoiType() == this->m_mapped.getPoiType(row));
+			CPPUNIT_ASSERT(pPoi->getLatitude() == poi.getLatitude() && pPoi->getLongitude() == poi.getLongitude());
+			CPPUNIT_ASSERT(poi.getPooledDescription() == pPoi->getPooledDescription());
+
+			row = this->m_mapped.findWaypoint("Waypoint 42");
+			CPPUNIT_ASSERT("Waypoint 42" == this->m_mapped.getWaypoint(row).getName());
+			CPPUNIT_ASSERT(this->m_wpDatabase.getPointerToWaypoint("Waypoint 42")->getLatitude() == this->m_mapped.getWaypointLatitude(row));
+
+			CPPUNIT_ASSERT(this->m_mapped.getPoiCount() == this->m_mapped.findPoi("POI2000"));
+			CPPUNIT_ASSERT(this->m_mapped.getWaypointCount() == this->m_mapped.findWaypoint("POI1234"));
+		}
+
+	void testSpatialQueries() {
+			for (unsigned int query = 0; query < 50; ++query)
+			{
+				double 		latitude 	= -90.0 + 180.0 * rand() / RAND_MAX;
+				double 		longitude 	= -180.0 + 360.0 * rand() / RAND_MAX;
+				CPOI::t_poi type 		= (CPOI::t_poi)(query % CPOI::DEFAULT_POI);
+
+				CPPUNIT_ASSERT(this->m_poiDatabase.getNearestPoi(latitude, longitude)->getName()
+						== this->m_mapped.getPoiName(this->m_mapped.getNearestPoi(latitude, longitude)));
+				CPPUNIT_ASSERT(this->m_poiDatabase.getNearestPoi(latitude, longitude, type)->getName()
+						== this->m_mapped.getPoiName(this->m_mapped.getNearestPoi(latitude, longitude, type)));
+
+				CPoiDatabase::Poi_Neighbour_Container_t 	heapResult;
+				CMappedDatabase::Neighbour_Container_t 		mappedResult;
+
+				this->m_poiDatabase.getNearestPois(latitude, longitude, 10, heapResult);
+				this->m_mapped.getNearestPois(latitude, longitude, 10, mappedResult);
+				CPPUNIT_ASSERT(heapResult.size() == mappedResult.size());
+
+				for (unsigned int index = 0; index < heapResult.size(); ++index)
+				{
+					CPPUNIT_ASSERT(heapResult[index].distance == mappedResult[index].distance);
+				}
+
+				this->m_poiDatabase.getPoisWithinRadius(latitude, longitude, 1500, type, heapResult);
+				this->m_mapped.getPoisWithinRadius(latitude, longitude, 1500, type, mappedResult);
+				CPPUNIT_ASSERT(heapResult.size() == mappedResult.size());
+
+				for (unsigned int index = 0; index < mappedResult.size(); ++index)
+				{
+					CPPUNIT_ASSERT(type == this->m_mapped.getPoiType(mappedResult[index].row));
+					CPPUNIT_ASSERT(heapResult[index].distance == mappedResult[index].distance);
+				}
+			}
+
+			// a rectangle across the date line finds the same elements
+			CMappedRowCollector 	mappedPois(&this->m_mapped, true);
+			CMappedRowCollector 	mappedWps(&this->m_mapped, false);
+			CHeapElementCollector 	heapPois;
+			CHeapElementCollector 	heapWps;
+
+			this->m_mapped.visitPoisInRectangle(-30, 40, 150, -150, mappedPois);
+			this->m_poiDatabase.visitPoisInRectangle(-30, 40, 150, -150, heapPois);
+			std::sort(mappedPois.names.begin(), mappedPois.names.end());
+			std::sort(heapPois.names.begin(), heapPois.names.end());
+			CPPUNIT_ASSERT(!heapPois.names.empty() && (heapPois.names == mappedPois.names));
+
+			this->m_mapped.visitWaypointsInRectangle(-60, 60, -90, 90, mappedWps);
+
+			for (CWpDatabase::Database_Storage_ConstItr_t itr = this->m_wpDatabase.begin(); itr != this->m_wpDatabase.end(); ++itr)
+			{
+				if ((fabs(itr->second.getLatitude()) <= 60) && (fabs(itr->second.getLongitude()) <= 90))
+				{
+					heapWps(itr->second);
+				}
+			}
+
+			std::sort(mappedWps.names.begin(), mappedWps.names.end());
+			std::sort(heapWps.names.begin(), heapWps.names.end());
+			CPPUNIT_ASSERT(!heapWps.names.empty() && (heapWps.names == mappedWps.names));
+
+			CWaypoint const *pWp = this->m_wpDatabase.getPointerToWaypoint("Waypoint 7");
+
+			CPPUNIT_ASSERT("Waypoint 7" == this->m_mapped.getWaypointName(this->m_mapped.getNearestWaypoint(pWp->getLatitude(), pWp->getLongitude())));
+		}
+
+	void testSharedSearches() {
+			CPoiDatabase 	poiDatabase;
+			CWpDatabase 	wpDatabase;
+			CMappedDatabase mapped;
+			CSnapshot 		snapshot;
+
+			// one POI on each pole: every longitude of a pole is the same point
+			CRandomPoiDatabase::fill(&poiDatabase, 3000, 21, -90, 90, CPOI::DEFAULT_POI);
+			poiDatabase.addPoi("North Pole", CPOI(CPOI::TOURISTIC, "North Pole", "Pole", 90, 45));
+			poiDatabase.addPoi("South Pole", CPOI(CPOI::UNIVERSITY, "South Pole", "Pole", -90, -120));
+
+			snapshot.setMediaName("MappedDatabaseTest.shared");
+			CPPUNIT_ASSERT(snapshot.writeData(wpDatabase, poiDatabase));
+			CPPUNIT_ASSERT(mapped.open("MappedDatabaseTest.shared"));
+
+			for (unsigned int query = 0; query < 100; ++query)
+			{
+				double 		latitude 	= (query < 2) ? (query ? -89.5 : 89.5) : -90.0 + 180.0 * rand() / RAND_MAX;
+				double 		longitude 	= -180.0 + 360.0 * rand() / RAND_MAX;
+				CPOI::t_poi type 		= (CPOI::t_poi)(query % CPOI::DEFAULT_POI);
+
+				CPoiDatabase::Poi_Neighbour_Container_t 	heapResult;
+				CMappedDatabase::Neighbour_Container_t 		mappedResult;
+
+				poiDatabase.getNearestPois(latitude, longitude, 15, heapResult);
+				mapped.getNearestPois(latitude, longitude, 15, mappedResult);
+				assertSameResult(heapResult, mapped, mappedResult);
+
+				poiDatabase.getNearestPois(latitude, longitude, 15, type, heapResult);
+				mapped.getNearestPois(latitude, longitude, 15, type, mappedResult);
+				assertSameResult(heapResult, mapped, mappedResult);
+
+				poiDatabase.getPoisWithinRadius(latitude, longitude, 800, heapResult);
+				mapped.getPoisWithinRadius(latitude, longitude, 800, mappedResult);
+				assertSameResult(heapResult, mapped, mappedResult);
+
+				poiDatabase.getPoisWithinRadius(latitude, longitude, 800, type, heapResult);
+				mapped.getPoisWithinRadius(latitude, longitude, 800, type, mappedResult);
+				assertSameResult(heapResult, mapped, mappedResult);
+			}
+
+			// rectangles around the poles, across the date line and of one type
+			double 	rectangles[][4] = { { 80, 90, 0, 10 }, { -95, -75, 170, -170 }, { -40, 25, 100, -120 }, { 10, 50, -30, 60 } };
+
+			for (unsigned int index = 0; index < sizeof(rectangles) / sizeof(rectangles[0]); ++index)
+			{
+				double const 			*pRectangle = rectangles[index];
+				CMappedRowCollector 	mappedPois(&mapped, true);
+				CMappedRowCollector 	mappedOfType(&mapped, true);
+				CHeapElementCollector 	heapPois;
+				CHeapElementCollector 	heapOfType;
+
+				mapped.visitPoisInRectangle(pRectangle[0], pRectangle[1], pRectangle[2], pRectangle[3], mappedPois);
+				poiDatabase.visitPoisInRectangle(pRectangle[0], pRectangle[1], pRectangle[2], pRectangle[3], heapPois);
+				mapped.visitPoisInRectangle(pRectangle[0], pRectangle[1], pRectangle[2], pRectangle[3], CPOI::GASSTATION, mappedOfType);
+				poiDatabase.visitPoisInRectangle(pRectangle[0], pRectangle[1], pRectangle[2], pRectangle[3], CPOI::GASSTATION, heapOfType);
+
+				std::sort(mappedPois.names.begin(), mappedPois.names.end());
+				std::sort(heapPois.names.begin(), heapPois.names.end());
+				std::sort(mappedOfType.names.begin(), mappedOfType.names.end());
+				std::sort(heapOfType.names.begin(), heapOfType.names.end());
+				CPPUNIT_ASSERT(!heapPois.names.empty() && (heapPois.names == mappedPois.names));
+				CPPUNIT_ASSERT(heapOfType.names == mappedOfType.names);
+			}
+
+			CMappedRowCollector pole(&mapped, true);
+
+			mapped.visitPoisInRectangle(80, 90, 0, 10, pole);
+			CPPUNIT_ASSERT(std::find(pole.names.begin(), pole.names.end(), "North Pole") != pole.names.end());
+
+			mapped.close();
+			std::remove("MappedDatabaseTest.shared");
+		}
+
+	void testInvalidFile() {
+			std::ostringstream 	output;
+			std::streambuf 		*pConsole = std::cout.rdbuf(output.rdbuf());
+			CMappedDatabase 	mapped;
+
+			CPPUNIT_ASSERT(!mapped.open("MappedDatabaseTest.missing"));
+
+			// a file which is not a snapshot
+			std::ofstream("MappedDatabaseTest.txt") << "Waypoint 1;49.8;8.6\n";
+			CPPUNIT_ASSERT(!mapped.open("MappedDatabaseTest.txt"));
+			std::remove("MappedDatabaseTest.txt");
+
+			std::cout.rdbuf(pConsole);
+
+			// a closed database answers nothing
+			CPPUNIT_ASSERT(!mapped.isOpen() && !mapped.verify());
+			CPPUNIT_ASSERT(0 == mapped.getPoiCount());
+			CPPUNIT_ASSERT(0 == mapped.getNearestPoi(49.8, 8.6));
+			CPPUNIT_ASSERT(0 == mapped.findWaypoint("Waypoint 1"));
+			CPPUNIT_ASSERT(output.str().find("not a snapshot") != std::string::npos);
+		}
+
+	void testDamagedIndex() {
+			std::ifstream 	input("MappedDatabaseTest.snapshot", std::ios::binary);
+			std::string 	image((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+			// a name index without a free slot: every slot refers to the first POI
+			CSnapshot::Header const &header 	= *reinterpret_cast<CSnapshot::Header const *>(image.data());
+			CSnapshot::Section const &index 	= header.sections[CSnapshot::POI_NAME_INDEX];
+			uint32_t 				firstPoi 	= 1;
+
+			for (uint64_t offset = index.offset; offset < index.offset + index.size; offset += sizeof(uint32_t))
+			{
+				memcpy(&image[offset], &firstPoi, sizeof(uint32_t));
+			}
+
+			std::ofstream("MappedDatabaseTest.damaged", std::ios::binary) << image;
+
+			CMappedDatabase mapped;
+
+			CPPUNIT_ASSERT(mapped.open("MappedDatabaseTest.damaged"));
+			CPPUNIT_ASSERT(!mapped.verify());
+			CPPUNIT_ASSERT(mapped.getPoiCount() == mapped.findPoi("POI1234"));
+			CPPUNIT_ASSERT(mapped.getWaypointCount() > mapped.findWaypoint("Waypoint 42"));
+
+			mapped.close();
+			std::remove("MappedDatabaseTest.damaged");
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Mapped database tests");
+
+		suite->addTest(new CppUnit::TestCaller<CMappedDatabaseTest>
+				 ("Elements are looked up by name in the mapped snapshot", &CMappedDatabaseTest::testLookup));
+
+		suite->addTest(new CppUnit::TestCaller<CMappedDatabaseTest>
+				 ("Spatial queries on the mapped snapshot match the databases", &CMappedDatabaseTest::testSpatialQueries));
+
+		suite->addTest(new CppUnit::TestCaller<CMappedDatabaseTest>
+				 ("Mapped and heap searches find the same POIs in the same order", &CMappedDatabaseTest::testSharedSearches));
+
+		suite->addTest(new CppUnit::TestCaller<CMappedDatabaseTest>
+				 ("A file which is not a snapshot is not mapped", &CMappedDatabaseTest::testInvalidFile));
+
+		suite->addTest(new CppUnit::TestCaller<CMappedDatabaseTest>
+				 ("A damaged name index ends the lookup", &CMappedDatabaseTest::testDamagedIndex));
+
+		return suite;
+	}
+};
+
+#endif /* CMAPPEDDATABASETEST_H_ */
@@ -0,0 +1,107 @@
+/*
+ * CNearestPoiTrackerTest.h
+ */
+
+#ifndef CNEARESTPOITRACKERTEST_H_
+#define CNEARESTPOITRACKERTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <sstream>
+
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CNearestPoiTracker.h"
+
+/**
+ * This class implements several test cases related to the CNearestPoiTracker.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CNearestPoiTrackerTest: public CppUnit::TestFixture {
+public:
+
+	void testTraceMatchesIndex() {
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+
+			srand(19);
+
+			for (unsigned int index = 0; index < 5000; ++index)
+			{
+				std::ostringstream name;
+
+				name << "POI" << index;
+				pPOIDatabase->addPoi(name.str(), CPOI(CPOI::RESTAURANT, name.str(), "A restaurant",
+						49.0 + 2.0 * rand() / RAND_MAX, 8.0 + 2.0 * rand() / RAND_MAX));
+			}
+
+			CNearestPoiTracker 	tracker(pPOIDatabase);
+			double 				latitude 	= 49.2;
+			double 				longitude 	= 8.2;
+
+			// a vehicle driving north east with some noise, about 30 m per fix
+			for (unsigned int fix = 0; fix < 5000; ++fix)
+			{
+				double 	distance;
+				CPOI 	*pTracked 	= tracker.update(latitude, longitude, distance);
+				CPOI 	*pNearest 	= pPOIDatabase->getNearestPoi(latitude, longitude);
+
+				CWaypoint position("Position", latitude, longitude);
+
+				CPPUNIT_ASSERT(pTracked);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(position.calculateDistance(*pNearest), distance, 1e-6);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(position.calculateDistance(*pNearest), position.calculateDistance(*pTracked), 1e-6);
+
+				latitude 	+= 0.0002 + 0.0001 * rand() / RAND_MAX;
+				longitude 	+= 0.0002 - 0.0003 * rand() / RAND_MAX;
+			}
+
+			CPPUNIT_ASSERT(5000 == tracker.getUpdateCount());
+			CPPUNIT_ASSERT(tracker.getQueryCount() < 5000 / 4);
+
+			delete pPOIDatabase;
+		}
+
+	void testDatabaseChanges() {
+			CPoiDatabase		*pPOIDatabase 	= new CPoiDatabase;
+			CNearestPoiTracker 	tracker(pPOIDatabase, 2);
+			double 				distance;
+
+			CPPUNIT_ASSERT(0 == tracker.update(49.87, 8.65, distance));
+
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10", "An awesome University", 49.86727, 8.638459));
+
+			// fewer POIs than candidates: every position is inside the region
+			CPPUNIT_ASSERT(pPOIDatabase->getPointerToPoi("HDA BuildingC10") == tracker.update(49.87, 8.65, distance));
+			CPPUNIT_ASSERT(pPOIDatabase->getPointerToPoi("HDA BuildingC10") == tracker.update(-30.0, 100.0, distance));
+
+			// a new POI at the position is found without a reset
+			pPOIDatabase->addPoi("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "Coffee", -30.0, 100.0));
+
+			CPPUNIT_ASSERT(pPOIDatabase->getPointerToPoi("Starbucks") == tracker.update(-30.0, 100.0, distance));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, distance, 1e-9);
+
+			pPOIDatabase->resetPoisDatabase();
+
+			CPPUNIT_ASSERT(0 == tracker.update(-30.0, 100.0, distance));
+
+			delete pPOIDatabase;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Nearest POI tracker tests");
+
+		suite->addTest(new CppUnit::TestCaller<CNearestPoiTrackerTest>
+				 ("Tracked POI along a trace matches the spatial index", &CNearestPoiTrackerTest::testTraceMatchesIndex));
+
+		suite->addTest(new CppUnit::TestCaller<CNearestPoiTrackerTest>
+				 ("Tracker follows the changes of the database", &CNearestPoiTrackerTest::testDatabaseChanges));
+
+		return suite;
+	}
+};
+
+#endif /* CNEARESTPOITRACKERTEST_H_ */
@@ -0,0 +1,189 @@
+/*
+ * CPoiColumnStoreTest.h
+ */
+
+#ifndef CPOICOLUMNSTORETEST_H_
+#define CPOICOLUMNSTORETEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <set>
+
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CPoiColumnStore.h"
+#include "CRandomPoiDatabase.h"
+
+/**
+ * This class implements several test cases related to the CPoiColumnStore.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CPoiColumnStoreTest: public CppUnit::TestFixture {
+private:
+
+	/**
+	 * Collect the names of the visited rows
+	 */
+	struct RowCollector {
+		CPoiColumnStore const 	*pStore;
+		std::set<std::string> 	names;
+
+		void operator()(CPoiColumnStore::Row_t row) {
+				names.insert(pStore->getName(row).str());
+			}
+	};
+
+public:
+
+	void testColumnsMatchDatabase() {
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+			CPoiColumnStore	store;
+
+			CRandomPoiDatabase::fill(pPOIDatabase, 1000, 11, -60, 60, 5);
+			store.assign(*pPOIDatabase);
+
+			CPPUNIT_ASSERT(1000 == store.getCount());
+
+			for (CPoiColumnStore::Row_t row = 0; row < store.getCount(); ++row)
+			{
+				CPOI const *pPoi = pPOIDatabase->getPointerToPoi(store.getName(row));
+
+				CPPUNIT_ASSERT(pPoi);
+				CPPUNIT_ASSERT(pPoi->getLatitude() == store.getLatitude(row));
+				CPPUNIT_ASSERT(pPoi->getLongitude() == store.getLongitude(row));
+				CPPUNIT_ASSERT(pPoi->getPoiType() == store.getType(row));
+
+				// the full record is built on demand
+				std::string		name, description, storedName, storedDescription;
+				double			latitude, longitude, storedLatitude, storedLongitude;
+				CPOI::t_poi		type, storedType;
+
+				store.getPoi(row).getAllDataByReference(name, latitude, longitude, type, description);
+				pPoi->getAllDataByReference(storedName, storedLatitude, storedLongitude, storedType, storedDescription);
+
+				CPPUNIT_ASSERT(name == storedName);
+				CPPUNIT_ASSERT(description == storedDescription);
+				CPPUNIT_ASSERT(latitude == storedLatitude && longitude == storedLongitude && type == storedType);
+			}
+
+			// the rows are in the order of the names
+			CPPUNIT_ASSERT(store.getName(0) < store.getName(1));
+
+			store.assign(CPoiDatabase());
+
+			CPPUNIT_ASSERT(0 == store.getCount());
+			CPPUNIT_ASSERT(0 == store.findNearest(0, 0));
+			CPPUNIT_ASSERT(0 == store.findNearest(0, 0, CPOI::RESTAURANT));
+
+			delete pPOIDatabase;
+		}
+
+	void testNearestMatchesSpatialIndex() {
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+			CPoiColumnStore	store;
+
+			CRandomPoiDatabase::fill(pPOIDatabase, 3000, 11, -60, 60, 5);
+			store.assign(*pPOIDatabase);
+
+			srand(5);
+
+			for (unsigned int query = 0; query < 100; ++query)
+			{
+				double 		latitude 	= -60 + 120.0 * rand() / RAND_MAX;
+				double 		longitude 	= -180 + 360.0 * rand() / RAND_MAX;
+				CWaypoint 	position("Position", latitude, longitude);
+				CPOI::t_poi type 		= (CPOI::t_poi)(query % 5);
+
+				CPOI 					*pNearest 		= pPOIDatabase->getNearestPoi(latitude, longitude);
+				CPOI 					*pNearestOfType = pPOIDatabase->getNearestPoi(latitude, longitude, type);
+				CPoiColumnStore::Row_t 	row 			= store.findNearest(latitude, longitude);
+				CPoiColumnStore::Row_t 	rowOfType 		= store.findNearest(latitude, longitude, type);
+
+				// equal distances: both answers are correct
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(position.calculateDistance(*pNearest), position.calculateDistance(store.getPoi(row)), 1e-9);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(position.calculateDistance(*pNearestOfType), position.calculateDistance(store.getPoi(rowOfType)), 1e-9);
+				CPPUNIT_ASSERT(type == store.getType(rowOfType));
+			}
+
+			delete pPOIDatabase;
+		}
+
+	void testRectangle() {
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+			CPoiColumnStore	store;
+
+			CRandomPoiDatabase::fill(pPOIDatabase, 2000, 11, -60, 60, 5);
+			store.assign(*pPOIDatabase);
+
+			// across the date line, all types and one type
+			RowCollector all 		= { &store, std::set<std::string>() };
+			RowCollector gasStations = { &store, std::set<std::string>() };
+
+			store.visitRectangle(-20, 30, 150, -160, all);
+			store.visitRectangle(-20, 30, 150, -160, CPOI::GASSTATION, gasStations);
+
+			unsigned int expected 	= 0;
+			unsigned int expectedGas = 0;
+
+			for (CPoiColumnStore::Row_t row = 0; row < store.getCount(); ++row)
+			{
+				CPOI 	poi 	= store.getPoi(row);
+				bool 	isInside = (poi.getLatitude() >= -20) && (poi.getLatitude() <= 30)
+									&& ((poi.getLongitude() >= 150) || (poi.getLongitude() <= -160));
+
+				if (isInside)
+				{
+					CPPUNIT_ASSERT(all.names.count(poi.getName()));
+					expected++;
+
+					if (poi.getPoiType() == CPOI::GASSTATION)
+					{
+						CPPUNIT_ASSERT(gasStations.names.count(poi.getName()));
+						expectedGas++;
+					}
+				}
+			}
+
+			CPPUNIT_ASSERT(expected > 0 && expected == all.names.size());
+			CPPUNIT_ASSERT(expectedGas > 0 && expectedGas == gasStations.names.size());
+
+			// on a pole every longitude is the same point
+			CPoiDatabase	poleDatabase;
+			CPoiColumnStore	poleStore;
+			RowCollector 	pole 		= { &poleStore, std::set<std::string>() };
+			RowCollector 	poleOfType 	= { &poleStore, std::set<std::string>() };
+
+			poleDatabase.addPoi("North Pole", CPOI(CPOI::TOURISTIC, "North Pole", "Pole", 90, 120));
+			poleDatabase.addPoi("Alert", CPOI(CPOI::TOURISTIC, "Alert", "Near the pole", 82.5, 120));
+			poleStore.assign(poleDatabase);
+
+			poleStore.visitRectangle(80, 90, 0, 10, pole);
+			poleStore.visitRectangle(80, 95, 170, -170, CPOI::TOURISTIC, poleOfType);
+
+			CPPUNIT_ASSERT(pole.names.size() == 1 && pole.names.count("North Pole"));
+			CPPUNIT_ASSERT(poleOfType.names.size() == 1 && poleOfType.names.count("North Pole"));
+
+			delete pPOIDatabase;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("POI column store tests");
+
+		suite->addTest(new CppUnit::TestCaller<CPoiColumnStoreTest>
+				 ("Columns hold the POIs of the database", &CPoiColumnStoreTest::testColumnsMatchDatabase));
+
+		suite->addTest(new CppUnit::TestCaller<CPoiColumnStoreTest>
+				 ("Nearest POI scan matches the spatial index", &CPoiColumnStoreTest::testNearestMatchesSpatialIndex));
+
+		suite->addTest(new CppUnit::TestCaller<CPoiColumnStoreTest>
+				 ("Rectangle scan across the date line", &CPoiColumnStoreTest::testRectangle));
+
+		return suite;
+	}
+};
+
+#endif /* CPOICOLUMNSTORETEST_H_ */
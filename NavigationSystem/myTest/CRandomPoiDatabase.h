@@ -0,0 +1,44 @@
+/*
+ * CRandomPoiDatabase.h
+ */
+
+#ifndef CRANDOMPOIDATABASE_H_
+#define CRANDOMPOIDATABASE_H_
+
+#include <cstdlib>
+#include <sstream>
+
+#include "../myCode/CPoiDatabase.h"
+
+/**
+ * This class fills the POI databases of the tests of the spatial queries and the CPoiColumnStore.
+ */
+class CRandomPoiDatabase {
+public:
+
+	/**
+	 * Fill the database with POIs at random positions around the date line, named "POI<index>"
+	 * param@ CPoiDatabase *pPOIDatabase	-	database to be filled					(IN)
+	 * param@ unsigned int count			-	number of POIs							(IN)
+	 * param@ unsigned int seed				-	seed of the positions					(IN)
+	 * param@ double minLatitude			-	southern border of the positions		(IN)
+	 * param@ double maxLatitude			-	northern border of the positions		(IN)
+	 * param@ unsigned int typeCount		-	the types 0 to typeCount - 1 take turns	(IN)
+	 */
+	static void fill(CPoiDatabase *pPOIDatabase, unsigned int count, unsigned int seed, double minLatitude, double maxLatitude, unsigned int typeCount) {
+			srand(seed);
+
+			for (unsigned int index = 0; index < count; ++index)
+			{
+				std::ostringstream name, description;
+				double latitude 	= minLatitude + (maxLatitude - minLatitude) * rand() / RAND_MAX;
+				double longitude 	= -180 + 360.0 * rand() / RAND_MAX;
+
+				name << "POI" << index;
+				description << "Description " << index % 7;
+				pPOIDatabase->addPoi(name.str(), CPOI((CPOI::t_poi)(index % typeCount), name.str(), description.str(), latitude, longitude));
+			}
+		}
+};
+
+#endif /* CRANDOMPOIDATABASE_H_ */
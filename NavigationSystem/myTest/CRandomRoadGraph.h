@@ -0,0 +1,57 @@
+/*
+ * CRandomRoadGraph.h
+ */
+
+#ifndef CRANDOMROADGRAPH_H_
+#define CRANDOMROADGRAPH_H_
+
+#include <cstdlib>
+#include <string>
+#include <sstream>
+
+#include "../myCode/CRoadGraph.h"
+
+/**
+ * This class fills the road graphs of the tests of the CRoadGraph and the CContractionHierarchy.
+ */
+class CRandomRoadGraph {
+public:
+
+	/**
+	 * Random roads between random nodes around Darmstadt; every node has a road to a few of the following nodes
+	 */
+	static void fill(CRoadGraph &graph, unsigned int nodeCount, unsigned int seed) {
+			srand(seed);
+
+			for (unsigned int node = 0; node < nodeCount; ++node)
+			{
+				graph.addNode(name(node), 49.7 + 0.3 * rand() / RAND_MAX, 8.5 + 0.4 * rand() / RAND_MAX);
+			}
+
+			for (unsigned int node = 0; node < nodeCount; ++node)
+			{
+				for (unsigned int road = 0; road < 3; ++road)
+				{
+					unsigned int other = (node + 1 + rand() % 20) % nodeCount;
+
+					// detours, one-way streets and a few ferries shorter than the great circle
+					double length = (rand() % 50 == 0) ? 0.01 : 0;
+
+					graph.addEdge(name(node), name(other), (rand() % 4 == 0), length);
+				}
+			}
+		}
+
+	/**
+	 * Name of a node of the graph
+	 */
+	static std::string name(unsigned int node) {
+			std::ostringstream stream;
+
+			stream << "Node" << node;
+
+			return stream.str();
+		}
+};
+
+#endif /* CRANDOMROADGRAPH_H_ */
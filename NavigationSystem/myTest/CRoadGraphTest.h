@@ -0,0 +1,159 @@
+/*
+ * CRoadGraphTest.h
+ */
+
+#ifndef CROADGRAPHTEST_H_
+#define CROADGRAPHTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "../myCode/CRoute.h"
+#include "../myCode/CRoadGraph.h"
+#include "CRandomRoadGraph.h"
+
+/**
+ * This class implements several test cases related to the CRoadGraph.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CRoadGraphTest: public CppUnit::TestFixture {
+public:
+
+	void testShortestPathFillsRoute() {
+			CRoute* porigin 			= new CRoute;
+			CWpDatabase *pWpDatabase 	= new CWpDatabase;
+			CRoadGraph *pGraph 			= new CRoadGraph;
+
+			pWpDatabase->addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 49.866851, 8.634864));
+			pWpDatabase->addWaypoint("Rheinstrasse", CWaypoint("Rheinstrasse", 49.87262, 8.63489));
+			pWpDatabase->addWaypoint("Neckarstrasse", CWaypoint("Neckarstrasse", 49.871700, 8.644417));
+			pWpDatabase->addWaypoint("Luisenplatz", CWaypoint("Luisenplatz", 49.87271, 8.65050));
+			pWpDatabase->addWaypoint("Bessunger", CWaypoint("Bessunger", 49.86165, 8.65445));
+
+			pGraph->addNodes(*pWpDatabase);
+
+			CPPUNIT_ASSERT(pGraph->addEdge("Berliner Alle", "Rheinstrasse"));
+			CPPUNIT_ASSERT(pGraph->addEdge("Berliner Alle", "Neckarstrasse"));
+			CPPUNIT_ASSERT(pGraph->addEdge("Rheinstrasse", "Luisenplatz"));
+			CPPUNIT_ASSERT(pGraph->addEdge("Neckarstrasse", "Luisenplatz", false, 5.0));
+			CPPUNIT_ASSERT(pGraph->addEdge("Luisenplatz", "Bessunger", true));
+			CPPUNIT_ASSERT(!pGraph->addEdge("Luisenplatz", "Unknown"));
+
+			CPPUNIT_ASSERT(5 == pGraph->getNodeCount());
+			CPPUNIT_ASSERT(9 == pGraph->getEdgeCount());
+
+			porigin->connectToWpDatabase(pWpDatabase);
+			porigin->addWaypoint("Berliner Alle");
+
+			CPPUNIT_ASSERT(porigin->addShortestPath(*pGraph, "Berliner Alle", "Bessunger"));
+
+			const std::vector<const CWaypoint*> route = porigin->getRoute();
+			const char *expected[] = { "Berliner Alle", "Rheinstrasse", "Luisenplatz", "Bessunger" };
+
+			CPPUNIT_ASSERT(4 == route.size());
+
+			for (unsigned int index = 0; index < route.size(); ++index)
+			{
+				CPPUNIT_ASSERT(!route[index]->getName().compare(expected[index]));
+			}
+
+			// the road to Bessunger is one way
+			CPPUNIT_ASSERT(!porigin->addShortestPath(*pGraph, "Bessunger", "Berliner Alle"));
+			CPPUNIT_ASSERT(!porigin->addShortestPath(*pGraph, "Berliner Alle", "Unknown"));
+			CPPUNIT_ASSERT(4 == porigin->getRoute().size());
+
+			delete porigin;
+			delete pWpDatabase;
+			delete pGraph;
+		}
+
+	void testAStarMatchesDijkstra() {
+			CRoadGraph *pGraph = new CRoadGraph;
+			CRoadGraph::Path_t dijkstraPath, aStarPath;
+			unsigned int dijkstraSettled = 0, aStarSettled = 0;
+
+			CRandomRoadGraph::fill(*pGraph, 2000, 21);
+
+			for (unsigned int query = 0; query < 100; ++query)
+			{
+				CRoadGraph::Node_t source = rand() % pGraph->getNodeCount();
+				CRoadGraph::Node_t target = rand() % pGraph->getNodeCount();
+				double dijkstraLength = 0, aStarLength = 0;
+
+				bool isFound = pGraph->findPath(source, target, dijkstraPath, dijkstraLength, CRoadGraph::DIJKSTRA);
+				dijkstraSettled += pGraph->getSettledCount();
+
+				CPPUNIT_ASSERT(isFound == pGraph->findPath(source, target, aStarPath, aStarLength, CRoadGraph::ASTAR));
+				aStarSettled += pGraph->getSettledCount();
+
+				if (isFound)
+				{
+					CPPUNIT_ASSERT_DOUBLES_EQUAL(dijkstraLength, aStarLength, 1e-9);
+					CPPUNIT_ASSERT(source == aStarPath.front() && target == aStarPath.back());
+				}
+			}
+
+			CPPUNIT_ASSERT(aStarSettled < dijkstraSettled);
+
+			delete pGraph;
+		}
+
+	void testGraphChangesAfterQuery() {
+			CRoadGraph *pGraph = new CRoadGraph;
+			CRoadGraph::Name_Path_t path;
+			double length;
+
+			pGraph->addNode("A", 49.0, 8.0);
+			pGraph->addNode("B", 49.0, 8.1);
+			CPPUNIT_ASSERT(!pGraph->addNode("A", 50.0, 8.0));
+
+			// a position out of range is no node, not one at 0, 0
+			CPPUNIT_ASSERT(!pGraph->addNode("Out of range", 49.0, 181.0));
+			CPPUNIT_ASSERT(!pGraph->addNode("Below the pole", -90.5, 8.0));
+			CPPUNIT_ASSERT(CRoadGraph::INVALID_NODE == pGraph->getNode("Out of range"));
+			CPPUNIT_ASSERT(!pGraph->addEdge("A", "Out of range"));
+
+			CPPUNIT_ASSERT(pGraph->findPath("A", "A", path, length));
+			CPPUNIT_ASSERT(1 == path.size() && 0.0 == length);
+			CPPUNIT_ASSERT(!pGraph->findPath("A", "B", path, length));
+
+			// the built graph is extended
+			pGraph->addNode("C", 49.0, 8.2);
+			pGraph->addEdge("A", "C");
+			pGraph->addEdge("C", "B", true, 2.5);
+
+			CPPUNIT_ASSERT(pGraph->findPath("A", "B", path, length));
+			CPPUNIT_ASSERT(3 == path.size() && !path[1].compare("C"));
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(CWaypoint("A", 49.0, 8.0).calculateDistance(CWaypoint("C", 49.0, 8.2)) + 2.5, length, 1e-5);
+
+			pGraph->clear();
+
+			CPPUNIT_ASSERT(0 == pGraph->getNodeCount() && 0 == pGraph->getEdgeCount());
+			CPPUNIT_ASSERT(!pGraph->findPath("A", "B", path, length));
+
+			delete pGraph;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Road graph tests");
+
+		suite->addTest(new CppUnit::TestCaller<CRoadGraphTest>
+				 ("Shortest path fills the route", &CRoadGraphTest::testShortestPathFillsRoute));
+
+		suite->addTest(new CppUnit::TestCaller<CRoadGraphTest>
+				 ("A* matches Dijkstra", &CRoadGraphTest::testAStarMatchesDijkstra));
+
+		suite->addTest(new CppUnit::TestCaller<CRoadGraphTest>
+				 ("Graph changes after a query", &CRoadGraphTest::testGraphChangesAfterQuery));
+
+		return suite;
+	}
+};
+
+#endif /* CROADGRAPHTEST_H_ */
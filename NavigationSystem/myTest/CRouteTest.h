@@ -9,6 +9,8 @@
 #include <cppunit/TestCaller.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include <type_traits>
+
 #include "../myCode/CRoute.h"
 
 /**
@@ -48,14 +50,167 @@ public:
 			delete pWpDatabase;
 		}
 
+	void testPoiAfterNamedWaypoint() {
+			CRoute 			route;
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 	*pPOIDatabase 	= new CPoiDatabase;
+
+			pWpDatabase->addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 49.866851, 8.634864));
+			pWpDatabase->addWaypoint("Rheinstrasse", CWaypoint("Rheinstrasse", 49.87, 8.63));
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10", "An awesome University", 49.86727, 8.638459));
+			pPOIDatabase->addPoi("Aral Tankst.", CPOI(CPOI::GASSTATION, "Aral Tankst.", "Fuel", 49.87, 8.64));
+
+			route.connectToWpDatabase(pWpDatabase);
+			route.connectToPoiDatabase(pPOIDatabase);
+
+			route.addWaypoint("Berliner Alle");
+			route.addWaypoint("Rheinstrasse");
+			route.addWaypoint("Berliner Alle");
+			route.addWaypoint("Rheinstrasse");
+
+			// after the last hop of the name, the positions behind move
+			route.addPoi("HDA BuildingC10", "Berliner Alle");
+			route.addPoi("Aral Tankst.", "Rheinstrasse");
+			route.addPoi("Aral Tankst.", "HDA BuildingC10");
+
+			std::vector<const CWaypoint*> hops = route.getRoute();
+
+			CPPUNIT_ASSERT(7 == hops.size());
+			CPPUNIT_ASSERT(!hops[2]->getName().compare("Berliner Alle"));
+			CPPUNIT_ASSERT(!hops[3]->getName().compare("HDA BuildingC10"));
+			CPPUNIT_ASSERT(!hops[4]->getName().compare("Aral Tankst."));
+			CPPUNIT_ASSERT(!hops[5]->getName().compare("Rheinstrasse"));
+			CPPUNIT_ASSERT(!hops[6]->getName().compare("Aral Tankst."));
+
+			// the concatenation keeps the positions of both routes
+			CRoute sum = route + route;
+
+			sum.addPoi("HDA BuildingC10", "Berliner Alle");
+			hops = sum.getRoute();
+
+			CPPUNIT_ASSERT(15 == hops.size());
+			CPPUNIT_ASSERT(!hops[10]->getName().compare("HDA BuildingC10"));
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+	void testHopsFollowDatabase() {
+			CRoute 			route;
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 	*pPOIDatabase 	= new CPoiDatabase;
+
+			pWpDatabase->addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 49.866851, 8.634864));
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10", "An awesome University", 49.86727, 8.638459));
+
+			route.connectToWpDatabase(pWpDatabase);
+			route.connectToPoiDatabase(pPOIDatabase);
+			route.addWaypoint("Berliner Alle");
+			route.addPoi("HDA BuildingC10", "Berliner Alle");
+
+			// the databases are loaded again: the hops find the new elements by their names
+			pWpDatabase->resetWpsDatabase();
+			pPOIDatabase->resetPoisDatabase();
+			pWpDatabase->addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 1.0, 2.0));
+
+			std::vector<const CWaypoint*> hops = route.getRoute();
+
+			// the POI is gone
+			CPPUNIT_ASSERT(1 == hops.size());
+			CPPUNIT_ASSERT(hops[0] == pWpDatabase->getPointerToWaypoint("Berliner Alle"));
+			CPPUNIT_ASSERT(1.0 == hops[0]->getLatitude());
+
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10", "An awesome University", 3.0, 4.0));
+
+			CPPUNIT_ASSERT(2 == route.getRoute().size());
+			CPPUNIT_ASSERT(3.0 == route.getRoute()[1]->getLatitude());
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+	void testTypedStreams() {
+			CRoute 			route;
+			CWpDatabase 	*pWpDatabase 	= new CWpDatabase;
+			CPoiDatabase 	*pPOIDatabase 	= new CPoiDatabase;
+			NameCollector	pois, waypoints;
+
+			pWpDatabase->addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 49.866851, 8.634864));
+			pWpDatabase->addWaypoint("Rheinstrasse", CWaypoint("Rheinstrasse", 49.87, 8.63));
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10", "An awesome University", 49.86727, 8.638459));
+			pPOIDatabase->addPoi("Aral Tankst.", CPOI(CPOI::GASSTATION, "Aral Tankst.", "Fuel", 49.87, 8.64));
+
+			route.connectToWpDatabase(pWpDatabase);
+			route.connectToPoiDatabase(pPOIDatabase);
+			route.addWaypoint("Berliner Alle");
+			route.addWaypoint("Rheinstrasse");
+			route.addPoi("HDA BuildingC10", "Berliner Alle");
+			route.addPoi("Aral Tankst.", "Rheinstrasse");
+
+			route.visitPois(pois);
+			route.visitWaypoints(waypoints);
+
+			CPPUNIT_ASSERT(2 == pois.names.size() && 2 == waypoints.names.size());
+			CPPUNIT_ASSERT(!pois.names[0].compare("HDA BuildingC10") && !pois.names[1].compare("Aral Tankst."));
+			CPPUNIT_ASSERT(!waypoints.names[0].compare("Berliner Alle") && !waypoints.names[1].compare("Rheinstrasse"));
+
+			// the type tags tell the classes without RTTI
+			CWaypoint	waypoint("Rheinstrasse", 49.87, 8.63);
+			CWaypoint	invalid("Nowhere", 100, 8.63);
+			CPOI		poi(CPOI::RESTAURANT, "Starbucks", "Coffee", 49.87, 8.65);
+			CWaypoint	*pPoiAsWaypoint = &poi;
+
+			CPPUNIT_ASSERT(CWaypoint::WAYPOINT == waypoint.getType());
+			CPPUNIT_ASSERT(CWaypoint::INVALID == invalid.getType());
+			CPPUNIT_ASSERT(CWaypoint::POI == pPoiAsWaypoint->getType());
+			CPPUNIT_ASSERT(&poi == CPOI::castFrom(pPoiAsWaypoint));
+			CPPUNIT_ASSERT(0 == CPOI::castFrom(&waypoint));
+			CPPUNIT_ASSERT(0 == CPOI::castFrom((CWaypoint const *)0));
+
+			// only a CPOI can carry the POI tag, and a rejected POI is still a POI
+			CPOI		invalidPoi(CPOI::RESTAURANT, "Nowhere", "Coffee", 100, 8.65);
+			CWaypoint	*pInvalidPoiAsWaypoint = &invalidPoi;
+
+			CPPUNIT_ASSERT(!(std::is_constructible<CWaypoint, std::string, double, double, CWaypoint::wp_type>::value));
+			CPPUNIT_ASSERT(CWaypoint::POI == pInvalidPoiAsWaypoint->getType());
+			CPPUNIT_ASSERT(&invalidPoi == CPOI::castFrom(pInvalidPoiAsWaypoint));
+			CPPUNIT_ASSERT(!invalidPoi.isValid() && !invalid.isValid());
+			CPPUNIT_ASSERT(poi.isValid() && waypoint.isValid());
+
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
 	static CppUnit::TestSuite* suite() {
 		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Connect Waypoint Database tests");
 
 		suite->addTest(new CppUnit::TestCaller<CRouteTest>
 				 ("Copy constructor", &CRouteTest::testRouteTest));
 
+		suite->addTest(new CppUnit::TestCaller<CRouteTest>
+				 ("POI after the last hop of a name", &CRouteTest::testPoiAfterNamedWaypoint));
+
+		suite->addTest(new CppUnit::TestCaller<CRouteTest>
+				 ("Hops follow the reloaded databases", &CRouteTest::testHopsFollowDatabase));
+
+		suite->addTest(new CppUnit::TestCaller<CRouteTest>
+				 ("POIs and waypoints as separate streams", &CRouteTest::testTypedStreams));
+
 		return suite;
 	}
+
+private:
+
+	/**
+	 * Collect the names of the visited waypoints or POIs
+	 */
+	struct NameCollector {
+		std::vector<std::string> names;
+
+		void operator()(CWaypoint &wp) {
+				names.push_back(wp.getName());
+			}
+	};
 };
 
 #endif /* CROUTETEST_H_ */
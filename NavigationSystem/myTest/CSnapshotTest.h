@@ -0,0 +1,277 @@
+/*
+ * CSnapshotTest.h
+ */
+
+#ifndef CSNAPSHOTTEST_H_
+#define CSNAPSHOTTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#include "../myCode/CSnapshot.h"
+#include "../myCode/CMappedFile.h"
+#include "../myCode/CWpDatabase.h"
+#include "../myCode/CPoiDatabase.h"
+#include "CRandomPoiDatabase.h"
+
+/**
+ * This class implements several test cases related to the binary snapshot of the databases.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CSnapshotTest: public CppUnit::TestFixture {
+private:
+
+	CWpDatabase 	m_wpDatabase;
+	CPoiDatabase 	m_poiDatabase;
+
+	/**
+	 * Read the file into a buffer
+	 */
+	static std::vector<char> readFile(char const *pFileName) {
+			std::ifstream file(pFileName, std::ios::binary);
+
+			return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+	/**
+	 * Replace the file by a buffer
+	 */
+	static void writeFile(char const *pFileName, std::vector<char> const &content) {
+			std::ofstream file(pFileName, std::ios::binary | std::ios::trunc);
+
+			file.write(&content[0], content.size());
+		}
+
+	/**
+	 * Read the snapshot into databases with one element each; true if they were replaced
+	 */
+	static bool readSnapshot() {
+			CWpDatabase 	wpRead;
+			CPoiDatabase 	poiRead;
+			CSnapshot 		snapshot;
+
+			wpRead.addWaypoint("Kept", CWaypoint("Kept", 1, 2));
+			poiRead.addPoi("Kept", CPOI(CPOI::RESTAURANT, "Kept", "Kept", 1, 2));
+
+			snapshot.setMediaName("SnapshotTest.snapshot");
+
+			bool ret = snapshot.readData(wpRead, poiRead, CSnapshot::REPLACE);
+
+			// a file which is not valid leaves the databases unchanged
+			CPPUNIT_ASSERT(ret == !wpRead.getPointerToWaypoint("Kept"));
+			CPPUNIT_ASSERT(ret == !poiRead.getPointerToPoi("Kept"));
+
+			return ret;
+		}
+
+public:
+
+	void setUp() {
+			this->m_wpDatabase.addWaypoint("Sydney", CWaypoint("Sydney", -33.8688, 151.2093));
+			this->m_wpDatabase.addWaypoint("Sum", CWaypoint("Sum", 0.1 + 0.2, -180));
+			this->m_wpDatabase.addWaypoint("Berliner Alle", CWaypoint("Berliner Alle", 49.866851, 8.634864));
+
+			this->m_poiDatabase.addPoi("Opera", CPOI(CPOI::TOURISTIC, "Opera", "Harbour; \"opera\" house", -33.8568, 151.2153));
+			this->m_poiDatabase.addPoi("Diner", CPOI(CPOI::RESTAURANT, "Diner", "Open late", 40.7, -74.0));
+			this->m_poiDatabase.addPoi("Station", CPOI(CPOI::GASSTATION, "Station", "Open late", 89.99999999999999, 1e-300));
+			this->m_poiDatabase.addPoi("HDA", CPOI(CPOI::UNIVERSITY, "HDA", "", 49.86727, 8.638459));
+
+			CSnapshot snapshot;
+
+			snapshot.setMediaName("SnapshotTest.snapshot");
+			CPPUNIT_ASSERT(snapshot.writeData(this->m_wpDatabase, this->m_poiDatabase));
+		}
+
+	void tearDown() {
+			std::remove("SnapshotTest.snapshot");
+		}
+
+	void testRoundTrip() {
+			CWpDatabase 	wpRead;
+			CPoiDatabase 	poiRead;
+			CSnapshot 		snapshot;
+
+			snapshot.setMediaName("SnapshotTest.snapshot");
+			CPPUNIT_ASSERT(snapshot.readData(wpRead, poiRead, CSnapshot::REPLACE));
+
+			CPPUNIT_ASSERT(3 == wpRead.getElementCount());
+			CPPUNIT_ASSERT(4 == poiRead.getElementCount());
+
+			for (CWpDatabase::Database_Storage_ConstItr_t itr = this->m_wpDatabase.begin(); itr != this->m_wpDatabase.end(); ++itr)
+			{
+				CWaypoint const *pWp = wpRead.getPointerToWaypoint(itr->first);
+
+				CPPUNIT_ASSERT(pWp);
+				CPPUNIT_ASSERT(pWp->getLatitude() == itr->second.getLatitude() && pWp->getLongitude() == itr->second.getLongitude());
+			}
+
+			for (CPoiDatabase::Database_Storage_ConstItr_t itr = this->m_poiDatabase.begin(); itr != this->m_poiDatabase.end(); ++itr)
+			{
+				CPOI const *pPoi = poiRead.getPointerToPoi(itr->first);
+
+				CPPUNIT_ASSERT(pPoi);
+				CPPUNIT_ASSERT(pPoi->getLatitude() == itr->second.getLatitude() && pPoi->getLongitude() == itr->second.getLongitude());
+				CPPUNIT_ASSERT(pPoi->getPoiType() == itr->second.getPoiType());
+				CPPUNIT_ASSERT(pPoi->getPooledDescription() == itr->second.getPooledDescription());
+			}
+
+			// the spatial index is built with the load
+			CPPUNIT_ASSERT(poiRead.getNearestPoi(49.87, 8.64) == poiRead.getPointerToPoi("HDA"));
+
+			// a merge keeps the elements of the database
+			wpRead.resetWpsDatabase();
+			wpRead.addWaypoint("Sydney", CWaypoint("Sydney", 1, 2));
+			CPPUNIT_ASSERT(snapshot.readData(wpRead, poiRead, CSnapshot::MERGE));
+			CPPUNIT_ASSERT(3 == wpRead.getElementCount());
+			CPPUNIT_ASSERT(1 == wpRead.getPointerToWaypoint("Sydney")->getLatitude());
+		}
+
+	void testNameIndex() {
+			CMappedFile file;
+
+			CPPUNIT_ASSERT(file.open("SnapshotTest.snapshot"));
+
+			CSnapshot::Header const *pHeader = CSnapshot::getHeader(file.getData(), file.getSize());
+
+			CPPUNIT_ASSERT(pHeader);
+			CPPUNIT_ASSERT(CSnapshot::FORMAT_VERSION == pHeader->version);
+			CPPUNIT_ASSERT(0 == pHeader->sections[CSnapshot::POI_LATITUDES].offset % CSnapshot::SECTION_ALIGNMENT);
+
+			// the elements are in the order of their names
+			uint32_t index = CSnapshot::findName(file.getData(), *pHeader, CSnapshot::POI_NAMES, CSnapshot::POI_NAME_INDEX, "Opera", 5);
+
+			CPPUNIT_ASSERT(2 == index);
+			CPPUNIT_ASSERT(-33.8568 == CSnapshot::getSection<double>(file.getData(), *pHeader, CSnapshot::POI_LATITUDES)[index]);
+			CPPUNIT_ASSERT(CPOI::TOURISTIC == CSnapshot::getSection<uint8_t>(file.getData(), *pHeader, CSnapshot::POI_TYPES)[index]);
+
+			CPPUNIT_ASSERT(1 == CSnapshot::findName(file.getData(), *pHeader, CSnapshot::WP_NAMES, CSnapshot::WP_NAME_INDEX, "Sum", 3));
+			CPPUNIT_ASSERT(CSnapshot::NOT_FOUND == CSnapshot::findName(file.getData(), *pHeader, CSnapshot::WP_NAMES, CSnapshot::WP_NAME_INDEX, "Opera", 5));
+			CPPUNIT_ASSERT(CSnapshot::NOT_FOUND == CSnapshot::findName(file.getData(), *pHeader, CSnapshot::WP_NAMES, CSnapshot::WP_NAME_INDEX, "Su", 2));
+		}
+
+	void testDamagedFile() {
+			std::vector<char> 	content = readFile("SnapshotTest.snapshot");
+			std::ostringstream 	output;
+			std::streambuf 		*pConsole = std::cout.rdbuf(output.rdbuf());
+
+			// one bit of a coordinate
+			content[content.size() / 2] ^= 0x10;
+			writeFile("SnapshotTest.snapshot", content);
+			CPPUNIT_ASSERT(!readSnapshot());
+			content[content.size() / 2] ^= 0x10;
+
+			// another version of the format
+			content[8]++;
+			writeFile("SnapshotTest.snapshot", content);
+			CPPUNIT_ASSERT(!readSnapshot());
+			content[8]--;
+
+			// the padding behind the header: the checksum covers the whole file
+			content[sizeof(CSnapshot::Header)] ^= 0x10;
+			writeFile("SnapshotTest.snapshot", content);
+			CPPUNIT_ASSERT(!readSnapshot());
+			content[sizeof(CSnapshot::Header)] ^= 0x10;
+
+			// truncated
+			content.pop_back();
+			writeFile("SnapshotTest.snapshot", content);
+			CPPUNIT_ASSERT(!readSnapshot());
+
+			std::cout.rdbuf(pConsole);
+
+			CPPUNIT_ASSERT(output.str().find("checksum") != std::string::npos);
+			CPPUNIT_ASSERT(output.str().find("version") != std::string::npos);
+			CPPUNIT_ASSERT(output.str().find("truncated") != std::string::npos);
+		}
+
+	void testStoredTrees() {
+			CPoiDatabase 	poiWritten;
+			CWpDatabase 	wpRead;
+			CPoiDatabase 	poiRead;
+			CSnapshot 		snapshot;
+
+			CRandomPoiDatabase::fill(&poiWritten, 3000, 5, -80, 80, CPOI::DEFAULT_POI + 1);
+			snapshot.setMediaName("SnapshotTest.snapshot");
+			CPPUNIT_ASSERT(snapshot.writeData(this->m_wpDatabase, poiWritten));
+			CPPUNIT_ASSERT(snapshot.readData(wpRead, poiRead, CSnapshot::REPLACE));
+
+			// the trees of the file answer like the trees built over the POIs
+			CPoiDatabase 								poiBuilt(poiRead);
+			CPoiDatabase::Poi_Neighbour_Container_t 	stored, built;
+
+			for (unsigned int query = 0; query < 50; ++query)
+			{
+				double latitude 	= -80 + 3.2 * query;
+				double longitude 	= -180 + 7.2 * query;
+
+				poiRead.getNearestPois(latitude, longitude, 5, stored);
+				poiBuilt.getNearestPois(latitude, longitude, 5, built);
+
+				CPPUNIT_ASSERT(5 == stored.size() && 5 == built.size());
+
+				for (unsigned int index = 0; index < stored.size(); ++index)
+				{
+					CPPUNIT_ASSERT(stored[index].pElement->getPooledName() == built[index].pElement->getPooledName());
+				}
+
+				CPPUNIT_ASSERT(poiRead.getNearestPoi(latitude, longitude, CPOI::RESTAURANT)->getPooledName()
+						== poiBuilt.getNearestPoi(latitude, longitude, CPOI::RESTAURANT)->getPooledName());
+			}
+
+			CPPUNIT_ASSERT(wpRead.getPointerToWaypoint("Sydney"));
+
+			// the trees of the databases are stored as they are: the same file as with the trees
+			// built for the snapshot while the POIs of poiWritten were added one by one
+			std::vector<char> written = readFile("SnapshotTest.snapshot");
+
+			poiWritten.buildSpatialIndex();
+			CPPUNIT_ASSERT(snapshot.writeData(this->m_wpDatabase, poiWritten));
+			CPPUNIT_ASSERT(written == readFile("SnapshotTest.snapshot"));
+			CPPUNIT_ASSERT(snapshot.writeData(wpRead, poiRead));
+			CPPUNIT_ASSERT(written == readFile("SnapshotTest.snapshot"));
+
+			// nodes which do not match the POIs are not taken over, the trees are built instead
+			std::vector<POI_Database_key_t> 	keys(1, POI_Database_key_t("POI0"));
+			CSnapshot::Node 					node = { { 0, 0, 1 }, 0, 1 };
+			uint32_t 							bounds[CSnapshot::POI_TREE_COUNT + 1] = { 0 };
+
+			for (unsigned int tree = 1; tree <= CSnapshot::POI_TREE_COUNT; ++tree)
+			{
+				bounds[tree] = 1;
+			}
+
+			CPPUNIT_ASSERT(!poiRead.adoptSpatialIndex(&node, bounds, keys));
+			CPPUNIT_ASSERT(poiRead.getNearestPoi(49.87, 8.64) == poiRead.getPointerToPoi(poiBuilt.getNearestPoi(49.87, 8.64)->getName()));
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Snapshot persistence tests");
+
+		suite->addTest(new CppUnit::TestCaller<CSnapshotTest>
+				 ("The databases survive a write and a read of the snapshot", &CSnapshotTest::testRoundTrip));
+
+		suite->addTest(new CppUnit::TestCaller<CSnapshotTest>
+				 ("Names are found in the index of the snapshot", &CSnapshotTest::testNameIndex));
+
+		suite->addTest(new CppUnit::TestCaller<CSnapshotTest>
+				 ("A damaged snapshot is not read", &CSnapshotTest::testDamagedFile));
+
+		suite->addTest(new CppUnit::TestCaller<CSnapshotTest>
+				 ("The spatial indexes are taken over from the snapshot", &CSnapshotTest::testStoredTrees));
+
+		return suite;
+	}
+};
+
+#endif /* CSNAPSHOTTEST_H_ */
@@ -0,0 +1,256 @@
+/*
+ * CSpatialIndexTest.h
+ */
+
+#ifndef CSPATIALINDEXTEST_H_
+#define CSPATIALINDEXTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <cstdlib>
+#include <set>
+
+#include "../myCode/CRoute.h"
+#include "../myCode/CWpDatabase.h"
+#include "CRandomPoiDatabase.h"
+
+/**
+ * This class implements several test cases related to the spatial queries of the CPoiDatabase.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CSpatialIndexTest: public CppUnit::TestFixture {
+private:
+
+	/**
+	 * Find the closest POI by comparing all of them
+	 */
+	double bruteForceNearest(CPoiDatabase *pPOIDatabase, CWaypoint const &wp) {
+			CPoiDatabase::Poi_Map_t pois 	= pPOIDatabase->getPoisFromDatabase();
+			double shortestDistance			= 1e9;
+
+			for (CPoiDatabase::Poi_Map_Itr_t itr = pois.begin(); itr != pois.end(); ++itr)
+			{
+				double distance = itr->second.CWaypoint::calculateDistance(wp);
+
+				if (distance < shortestDistance)
+				{
+					shortestDistance = distance;
+				}
+			}
+
+			return shortestDistance;
+		}
+
+	/**
+	 * Collect the names of the visited elements
+	 */
+	struct NameCollector {
+		std::multiset<std::string> names;
+
+		void operator()(CWaypoint &wp) {
+				names.insert(wp.getName());
+			}
+	};
+
+	/**
+	 * Find the names of the POIs inside the rectangle by checking all of them
+	 */
+	std::multiset<std::string> bruteForceRectangle(CPoiDatabase *pPOIDatabase, double minLatitude, double maxLatitude, double minLongitude, double maxLongitude) {
+			CPoiDatabase::Poi_Map_t pois 	= pPOIDatabase->getPoisFromDatabase();
+			std::multiset<std::string> names;
+
+			for (CPoiDatabase::Poi_Map_Itr_t itr = pois.begin(); itr != pois.end(); ++itr)
+			{
+				double latitude 	= itr->second.getLatitude();
+				double longitude 	= itr->second.getLongitude();
+				bool isOnPole 		= (latitude == 90) || (latitude == -90);
+				bool isInLongitude 	= (minLongitude <= maxLongitude) ? ((longitude >= minLongitude) && (longitude <= maxLongitude))
+																		: ((longitude >= minLongitude) || (longitude <= maxLongitude));
+
+				if ((latitude >= minLatitude) && (latitude <= maxLatitude) && (isOnPole || isInLongitude))
+				{
+					names.insert(itr->second.getName());
+				}
+			}
+
+			return names;
+		}
+
+public:
+
+	void testNearestMatchesFullScan() {
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+
+			CRandomPoiDatabase::fill(pPOIDatabase, 2000, 42, 60, 90, 1);
+
+			for (int query = 0; query < 50; ++query)
+			{
+				CWaypoint wp("Query", 55 + query * 0.7, (query % 2) ? 179.9 : -179.9);
+				CPOI *pPoi = pPOIDatabase->getNearestPoi(wp.getLatitude(), wp.getLongitude());
+
+				CPPUNIT_ASSERT(pPoi != 0);
+				CPPUNIT_ASSERT_DOUBLES_EQUAL(bruteForceNearest(pPOIDatabase, wp), pPoi->CWaypoint::calculateDistance(wp), 1e-6);
+			}
+
+			delete pPOIDatabase;
+		}
+
+	void testKNearestAndRadius() {
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+			CPoiDatabase::Poi_Neighbour_Container_t nearest, withinRadius;
+
+			CRandomPoiDatabase::fill(pPOIDatabase, 2000, 42, 60, 90, 1);
+
+			pPOIDatabase->getNearestPois(89.5, 0, 10, nearest);
+
+			CPPUNIT_ASSERT(10 == nearest.size());
+
+			for (unsigned int index = 1; index < nearest.size(); ++index)
+			{
+				CPPUNIT_ASSERT(nearest[index - 1].distance <= nearest[index].distance);
+			}
+
+			// all the k nearest POIs are within the distance of the k-th one
+			pPOIDatabase->getPoisWithinRadius(89.5, 0, nearest.back().distance + 1e-6, withinRadius);
+
+			CPPUNIT_ASSERT(withinRadius.size() >= nearest.size());
+
+			for (unsigned int index = 0; index < nearest.size(); ++index)
+			{
+				CPPUNIT_ASSERT(withinRadius[index].pElement == nearest[index].pElement);
+			}
+
+			delete pPOIDatabase;
+		}
+
+	void testIndexFollowsDatabase() {
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getNearestPoi(49.86, 8.63));
+
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10"	, "An awesome University", 49.86727, 8.638459));
+
+			CPPUNIT_ASSERT(!pPOIDatabase->getNearestPoi(49.86, 8.63)->getName().compare("HDA BuildingC10"));
+
+			pPOIDatabase->addPoi("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "A blissful coffee", 49.872409, 8.650744));
+
+			CPPUNIT_ASSERT(!pPOIDatabase->getNearestPoi(49.8725, 8.6507)->getName().compare("Starbucks"));
+
+			pPOIDatabase->resetPoisDatabase();
+
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getNearestPoi(49.86, 8.63));
+
+			delete pPOIDatabase;
+		}
+
+	void testTypeFilteredQueries() {
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+			CPoiDatabase::Poi_Neighbour_Container_t result;
+
+			pPOIDatabase->addPoi("HDA BuildingC10", CPOI(CPOI::UNIVERSITY, "HDA BuildingC10"	, "An awesome University", 49.86727, 8.638459));
+			pPOIDatabase->addPoi("Aral Tankst.", CPOI(CPOI::GASSTATION, "Aral Tankst.", "Refuel your vehicle", 49.871558, 8.639206));
+			pPOIDatabase->addPoi("Starbucks", CPOI(CPOI::RESTAURANT, "Starbucks", "A blissful coffee", 49.872409, 8.650744));
+
+			CPPUNIT_ASSERT(!pPOIDatabase->getNearestPoi(49.86727, 8.638459)->getName().compare("HDA BuildingC10"));
+			CPPUNIT_ASSERT(!pPOIDatabase->getNearestPoi(49.86727, 8.638459, CPOI::RESTAURANT)->getName().compare("Starbucks"));
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getNearestPoi(49.86727, 8.638459, CPOI::TOURISTIC));
+
+			pPOIDatabase->getPoisWithinRadius(49.86727, 8.638459, 100, CPOI::GASSTATION, result);
+
+			CPPUNIT_ASSERT(1 == result.size());
+			CPPUNIT_ASSERT(!result[0].pElement->getName().compare("Aral Tankst."));
+
+			pPOIDatabase->getNearestPois(49.86727, 8.638459, 5, CPOI::UNIVERSITY, result);
+
+			CPPUNIT_ASSERT(1 == result.size());
+
+			delete pPOIDatabase;
+		}
+
+	void testRectangleMatchesFullScan() {
+			CPoiDatabase *pPOIDatabase 	= new CPoiDatabase;
+			const double rectangles[][4] = {
+					{ 70, 80, -10, 10 },		// a plain viewport
+					{ 60, 75, 170, -170 },		// crossing the date line
+					{ 85, 90, -180, 180 },		// around the north pole
+					{ 88, 95, 100, -100 },		// crossing the date line up to the pole
+					{ 75, 70, -10, 10 }			// empty
+			};
+
+			CRandomPoiDatabase::fill(pPOIDatabase, 2000, 42, 60, 90, 1);
+			pPOIDatabase->addPoi("North Pole", CPOI(CPOI::TOURISTIC, "North Pole", "", 90, 42));
+
+			for (unsigned int index = 0; index < sizeof(rectangles) / sizeof(rectangles[0]); ++index)
+			{
+				const double *r = rectangles[index];
+				NameCollector visitor;
+
+				pPOIDatabase->visitPoisInRectangle(r[0], r[1], r[2], r[3], visitor);
+
+				CPPUNIT_ASSERT(bruteForceRectangle(pPOIDatabase, r[0], r[1], r[2], r[3]) == visitor.names);
+			}
+
+			NameCollector touristic;
+
+			pPOIDatabase->visitPoisInRectangle(88, 90, 100, -100, CPOI::TOURISTIC, touristic);
+
+			CPPUNIT_ASSERT(1 == touristic.names.size());
+			CPPUNIT_ASSERT(1 == touristic.names.count("North Pole"));
+
+			delete pPOIDatabase;
+		}
+
+	void testWaypointRectangle() {
+			CWpDatabase *pWpDatabase 	= new CWpDatabase;
+			NameCollector visitor;
+
+			pWpDatabase->addWaypoint("Darmstadt", CWaypoint("Darmstadt", 49.8728, 8.6512));
+			pWpDatabase->addWaypoint("Berlin", CWaypoint("Berlin", 52.5200, 13.4050));
+			pWpDatabase->addWaypoint("Suva", CWaypoint("Suva", -18.1416, 178.4419));
+			pWpDatabase->addWaypoint("Apia", CWaypoint("Apia", -13.8507, -171.7514));
+
+			pWpDatabase->visitWaypointsInRectangle(45, 55, 5, 10, visitor);
+
+			CPPUNIT_ASSERT(1 == visitor.names.size());
+			CPPUNIT_ASSERT(1 == visitor.names.count("Darmstadt"));
+
+			visitor.names.clear();
+			pWpDatabase->visitWaypointsInRectangle(-20, -10, 175, -170, visitor);
+
+			CPPUNIT_ASSERT(2 == visitor.names.size());
+			CPPUNIT_ASSERT(1 == visitor.names.count("Suva"));
+			CPPUNIT_ASSERT(1 == visitor.names.count("Apia"));
+
+			delete pWpDatabase;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("Spatial index tests");
+
+		suite->addTest(new CppUnit::TestCaller<CSpatialIndexTest>
+				 ("Nearest POI matches a full scan", &CSpatialIndexTest::testNearestMatchesFullScan));
+
+		suite->addTest(new CppUnit::TestCaller<CSpatialIndexTest>
+				 ("K nearest and radius queries", &CSpatialIndexTest::testKNearestAndRadius));
+
+		suite->addTest(new CppUnit::TestCaller<CSpatialIndexTest>
+				 ("Index follows the database", &CSpatialIndexTest::testIndexFollowsDatabase));
+
+		suite->addTest(new CppUnit::TestCaller<CSpatialIndexTest>
+				 ("Queries filtered by the POI type", &CSpatialIndexTest::testTypeFilteredQueries));
+
+		suite->addTest(new CppUnit::TestCaller<CSpatialIndexTest>
+				 ("Rectangle query matches a full scan", &CSpatialIndexTest::testRectangleMatchesFullScan));
+
+		suite->addTest(new CppUnit::TestCaller<CSpatialIndexTest>
+				 ("Rectangle query over the waypoints", &CSpatialIndexTest::testWaypointRectangle));
+
+		return suite;
+	}
+};
+
+#endif /* CSPATIALINDEXTEST_H_ */
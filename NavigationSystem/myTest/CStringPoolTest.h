@@ -0,0 +1,338 @@
+/*
+ * CStringPoolTest.h
+ */
+
+#ifndef CSTRINGPOOLTEST_H_
+#define CSTRINGPOOLTEST_H_
+
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <atomic>
+
+#include "../myCode/CStringPool.h"
+#include "../myCode/CPoiDatabase.h"
+#include "../myCode/CRoute.h"
+
+/**
+ * This class implements several test cases related to the CStringPool.
+ * Each test case is implemented
+ * as a method testXXX. The static method suite() returns a TestSuite
+ * in which all tests are registered.
+ */
+class CStringPoolTest: public CppUnit::TestFixture {
+public:
+
+	void testInternOnce() {
+			CStringPool		&pool 	= CStringPool::getInstance();
+			std::string		name 	= "Darmstadt Hauptbahnhof";
+			CPooledString	first(name);
+			size_t			count 	= pool.getStringCount();
+			CPooledString	second(std::string("Darmstadt ") + "Hauptbahnhof");
+
+			// the second string is found in the pool, it is not added again
+			CPPUNIT_ASSERT(first == second);
+			CPPUNIT_ASSERT(first.getId() == second.getId());
+			CPPUNIT_ASSERT(count == pool.getStringCount());
+			CPPUNIT_ASSERT(first.data() == second.data());
+			CPPUNIT_ASSERT(name == first.str());
+			CPPUNIT_ASSERT(name.size() == first.size());
+			CPPUNIT_ASSERT(first != CPooledString("Darmstadt Hbf"));
+
+			// the loaders intern a string this way: the pool reports if it cannot take it
+			CPooledString	interned;
+
+			CPPUNIT_ASSERT(CPooledString::intern("Darmstadt Hauptbahnhof", interned) && (first == interned));
+			CPPUNIT_ASSERT(CPooledString::intern("", interned) && interned.empty());
+			CPPUNIT_ASSERT(CStringPool::NOT_FOUND != pool.intern("Darmstadt Nord", 14));
+
+			// the empty string is always in the pool
+			CPPUNIT_ASSERT(CPooledString().empty());
+			CPPUNIT_ASSERT(CPooledString("") == CPooledString());
+			CPPUNIT_ASSERT(CStringPool::EMPTY_STRING == CPooledString(std::string()).getId());
+			CPPUNIT_ASSERT(std::string() == CPooledString().c_str());
+
+			// characters after a '\0' belong to the string
+			CPooledString withZero(std::string("a\0b", 3));
+
+			CPPUNIT_ASSERT(3 == withZero.size());
+			CPPUNIT_ASSERT(withZero != CPooledString("a"));
+		}
+
+	void testOrderLikeStdString() {
+			std::vector<std::string>	texts;
+			std::vector<CPooledString>	pooled;
+
+			texts.push_back("Zoo");
+			texts.push_back("Aral");
+			texts.push_back("Aral Tankst.");
+			texts.push_back("aral");
+			texts.push_back("Ar");
+			texts.push_back("Berlin");
+			texts.push_back("");
+
+			for (unsigned int index = 0; index < texts.size(); ++index)
+			{
+				pooled.push_back(CPooledString(texts[index]));
+			}
+
+			for (unsigned int lhs = 0; lhs < texts.size(); ++lhs)
+			{
+				for (unsigned int rhs = 0; rhs < texts.size(); ++rhs)
+				{
+					int expected 	= texts[lhs].compare(texts[rhs]);
+					int result		= pooled[lhs].compare(pooled[rhs]);
+
+					CPPUNIT_ASSERT((expected < 0) == (result < 0));
+					CPPUNIT_ASSERT((expected == 0) == (result == 0));
+					CPPUNIT_ASSERT((texts[lhs] < texts[rhs]) == (pooled[lhs] < pooled[rhs]));
+				}
+			}
+
+			std::ostringstream stream;
+
+			stream << pooled[2] << "|" << pooled[6] << "|";
+
+			CPPUNIT_ASSERT(!stream.str().compare("Aral Tankst.||"));
+		}
+
+	void testGrowingPool() {
+			std::vector<CPooledString> pooled;
+
+			// enough strings for several chunks and table sizes
+			for (unsigned int index = 0; index < 100000; ++index)
+			{
+				std::ostringstream text;
+
+				text << "Point of interest " << index;
+				pooled.push_back(CPooledString(text.str()));
+			}
+
+			for (unsigned int index = 0; index < pooled.size(); index += 997)
+			{
+				std::ostringstream text;
+
+				text << "Point of interest " << index;
+
+				CPPUNIT_ASSERT(pooled[index] == CPooledString(text.str()));
+				CPPUNIT_ASSERT(!text.str().compare(pooled[index].c_str()));
+			}
+
+			// a string longer than a chunk
+			std::string 	longText(300000, 'x');
+			CPooledString	longPooled(longText);
+
+			CPPUNIT_ASSERT(longText == longPooled.str());
+			CPPUNIT_ASSERT(longPooled == CPooledString(longText));
+		}
+
+	void testConcurrentLookup() {
+			CStringPool						&pool = CStringPool::getInstance();
+			std::vector<std::string> 		texts;
+			std::vector<CStringPool::String_Id_t> ids(4000);
+			bool							isFound[4] = { true, true, true, true };
+			std::atomic<bool>				isWriting(true);
+
+			for (unsigned int index = 0; index < 200000; ++index)
+			{
+				std::ostringstream text;
+
+				text << "Concurrent string " << index;
+				texts.push_back(text.str());
+			}
+
+			for (unsigned int index = 0; index < ids.size(); ++index)
+			{
+				ids[index] = pool.intern(texts[index].data(), texts[index].size());
+			}
+
+			// the look-ups take no lock while the table grows: the strings added before are always found
+			std::thread writer([&]() {
+					for (unsigned int index = ids.size(); index < texts.size(); ++index)
+					{
+						pool.intern(texts[index].data(), texts[index].size());
+					}
+
+					isWriting = false;
+				});
+			std::vector<std::thread> readers;
+
+			for (unsigned int reader = 0; reader < 4; ++reader)
+			{
+				readers.push_back(std::thread([&, reader]() {
+						do
+						{
+							for (unsigned int index = reader; index < ids.size(); index += 4)
+							{
+								isFound[reader] = isFound[reader] && (ids[index] == pool.find(texts[index].data(), texts[index].size()));
+							}
+						} while (isWriting);
+					}));
+			}
+
+			writer.join();
+
+			for (unsigned int reader = 0; reader < readers.size(); ++reader)
+			{
+				readers[reader].join();
+				CPPUNIT_ASSERT(isFound[reader]);
+			}
+
+			CPPUNIT_ASSERT(pool.intern(texts.back().data(), texts.back().size()) == pool.find(texts.back().data(), texts.back().size()));
+		}
+
+	void testConcurrentIntern() {
+			CStringPool						&pool = CStringPool::getInstance();
+			std::vector<std::string> 		texts;
+			std::vector<std::vector<CStringPool::String_Id_t> > ids(4);
+			std::vector<std::thread>		writers;
+
+			for (unsigned int index = 0; index < 50000; ++index)
+			{
+				std::ostringstream text;
+
+				text << "Shared string " << index;
+				texts.push_back(text.str());
+			}
+
+			// the threads add the same strings in different orders, each string gets one number
+			for (unsigned int writer = 0; writer < ids.size(); ++writer)
+			{
+				writers.push_back(std::thread([&, writer]() {
+						ids[writer].resize(texts.size());
+
+						for (unsigned int step = 0; step < texts.size(); ++step)
+						{
+							unsigned int index = (writer % 2) ? (texts.size() - 1 - step) : step;
+
+							ids[writer][index] = pool.intern(texts[index].data(), texts[index].size());
+						}
+					}));
+			}
+
+			for (unsigned int writer = 0; writer < writers.size(); ++writer)
+			{
+				writers[writer].join();
+			}
+
+			for (unsigned int index = 0; index < texts.size(); ++index)
+			{
+				CPPUNIT_ASSERT(ids[0][index] == ids[1][index]);
+				CPPUNIT_ASSERT(ids[0][index] == ids[2][index]);
+				CPPUNIT_ASSERT(ids[0][index] == ids[3][index]);
+				CPPUNIT_ASSERT(!texts[index].compare(pool.getChars(ids[0][index])));
+			}
+		}
+
+	void testSharedNames() {
+			CPoiDatabase	*pPOIDatabase = new CPoiDatabase;
+			CPOI			first(CPOI::RESTAURANT, "Starbucks", "Coffee", 49.8725, 8.6507);
+			CPOI			second(CPOI::RESTAURANT, "Vapiano", "Pasta", 49.8721, 8.6502);
+
+			pPOIDatabase->addPoi("Starbucks", first);
+			pPOIDatabase->addPoi("Vapiano", second);
+
+			// the key and the name of a POI are the same string of the pool
+			CPOI *pPoi = pPOIDatabase->getPointerToPoi("Starbucks");
+
+			CPPUNIT_ASSERT(pPoi);
+			CPPUNIT_ASSERT(pPoi->getPooledName() == POI_Database_key_t("Starbucks"));
+			CPPUNIT_ASSERT(pPoi->getPooledName().data() == first.getPooledName().data());
+
+			// the data is handed out as std::string like before
+			std::string 	name, description;
+			double			latitude, longitude;
+			CPOI::t_poi		type;
+
+			pPoi->getAllDataByReference(name, latitude, longitude, type, description);
+
+			CPPUNIT_ASSERT(!name.compare("Starbucks"));
+			CPPUNIT_ASSERT(!description.compare("Coffee"));
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getPointerToPoi("Starbucks Coffee"));
+
+			// the keys are visited in the order of the characters
+			CPoiDatabase::Poi_Map_t pois = pPOIDatabase->getPoisFromDatabase();
+
+			CPPUNIT_ASSERT(!pois.begin()->first.str().compare("Starbucks"));
+			CPPUNIT_ASSERT(!pois.rbegin()->first.str().compare("Vapiano"));
+
+			delete pPOIDatabase;
+		}
+
+	void testLookupDoesNotIntern() {
+			CStringPool		&pool 			= CStringPool::getInstance();
+			CPoiDatabase	*pPOIDatabase 	= new CPoiDatabase;
+			CWpDatabase		*pWpDatabase 	= new CWpDatabase;
+			CRoute			*pRoute 		= new CRoute;
+			CPooledString	pooled;
+
+			pPOIDatabase->addPoi("Mensa", CPOI(CPOI::RESTAURANT, "Mensa", "Lunch", 49.8666, 8.6379));
+			pWpDatabase->addWaypoint("Luisenplatz", CWaypoint("Luisenplatz", 49.8728, 8.6512));
+			pRoute->connectToPoiDatabase(pPOIDatabase);
+			pRoute->connectToWpDatabase(pWpDatabase);
+
+			size_t count = pool.getStringCount();
+
+			// the names which are looked up and not found stay out of the pool
+			std::ostringstream 	output;
+			std::streambuf 		*pConsole = std::cout.rdbuf(output.rdbuf());
+
+			CPPUNIT_ASSERT(0 == pPOIDatabase->getPointerToPoi("Unknown POI"));
+			CPPUNIT_ASSERT(0 == pWpDatabase->getPointerToWaypoint(std::string("Unknown Waypoint")));
+			pRoute->addWaypoint("Unknown Waypoint");
+			pRoute->addPoi("Mensa", "Unknown Waypoint");
+			*pRoute += "Unknown Name";
+
+			std::cout.rdbuf(pConsole);
+
+			CPPUNIT_ASSERT(count == pool.getStringCount());
+			CPPUNIT_ASSERT(!CPooledString::find("Unknown Name", pooled));
+			CPPUNIT_ASSERT(CStringPool::NOT_FOUND == pool.find("Unknown POI", 11));
+
+			// the names of the elements are found
+			CPPUNIT_ASSERT(CPooledString::find("Luisenplatz", pooled) && (pooled == CPooledString("Luisenplatz")));
+			CPPUNIT_ASSERT(CStringPool::EMPTY_STRING == pool.find("", 0));
+			CPPUNIT_ASSERT(pWpDatabase->getPointerToWaypoint("Luisenplatz"));
+			CPPUNIT_ASSERT(1 == pRoute->getRoute().size());
+
+			delete pRoute;
+			delete pWpDatabase;
+			delete pPOIDatabase;
+		}
+
+	static CppUnit::TestSuite* suite() {
+		CppUnit::TestSuite* suite = new CppUnit::TestSuite("String pool tests");
+
+		suite->addTest(new CppUnit::TestCaller<CStringPoolTest>
+				 ("A string is added to the pool once", &CStringPoolTest::testInternOnce));
+
+		suite->addTest(new CppUnit::TestCaller<CStringPoolTest>
+				 ("Pooled strings are ordered like std::string", &CStringPoolTest::testOrderLikeStdString));
+
+		suite->addTest(new CppUnit::TestCaller<CStringPoolTest>
+				 ("The pool grows without moving the strings", &CStringPoolTest::testGrowingPool));
+
+		suite->addTest(new CppUnit::TestCaller<CStringPoolTest>
+				 ("Strings are looked up while the pool grows", &CStringPoolTest::testConcurrentLookup));
+
+		suite->addTest(new CppUnit::TestCaller<CStringPoolTest>
+				 ("Threads add the same strings at the same time", &CStringPoolTest::testConcurrentIntern));
+
+		suite->addTest(new CppUnit::TestCaller<CStringPoolTest>
+				 ("Keys and names of the database share the strings", &CStringPoolTest::testSharedNames));
+
+		suite->addTest(new CppUnit::TestCaller<CStringPoolTest>
+				 ("A look-up by name does not add the name to the pool", &CStringPoolTest::testLookupDoesNotIntern));
+
+		return suite;
+	}
+};
+
+#endif /* CSTRINGPOOLTEST_H_ */
@@ -17,6 +17,20 @@
 #include "CGetDistanceNextPoiTest.h"
 #include "CConnectToPoiDatabaseTest.h"
 #include "CConnectToWpDatabaseTest.h"
+#include "CSpatialIndexTest.h"
+#include "CDatabaseStorageTest.h"
+#include "CDistanceKernelTest.h"
+#include "CDistanceModelTest.h"
+#include "CRoadGraphTest.h"
+#include "CContractionHierarchyTest.h"
+#include "CStringPoolTest.h"
+#include "CArenaTest.h"
+#include "CPoiColumnStoreTest.h"
+#include "CNearestPoiTrackerTest.h"
+#include "CGPSSourceTest.h"
+#include "CCSVTest.h"
+#include "CSnapshotTest.h"
+#include "CMappedDatabaseTest.h"
 
 using namespace CppUnit;
 
@@ -35,6 +49,20 @@ int main (int argc, char* argv[]) {
 	runner.addTest( CPrintTest::suite() );
 	runner.addTest( COperatorOverloadingTest::suite() );
 	runner.addTest( CAddWaypointTest::suite() );
+	runner.addTest( CSpatialIndexTest::suite() );
+	runner.addTest( CDatabaseStorageTest::suite() );
+	runner.addTest( CDistanceKernelTest::suite() );
+	runner.addTest( CDistanceModelTest::suite() );
+	runner.addTest( CRoadGraphTest::suite() );
+	runner.addTest( CContractionHierarchyTest::suite() );
+	runner.addTest( CStringPoolTest::suite() );
+	runner.addTest( CArenaTest::suite() );
+	runner.addTest( CPoiColumnStoreTest::suite() );
+	runner.addTest( CNearestPoiTrackerTest::suite() );
+	runner.addTest( CGPSSourceTest::suite() );
+	runner.addTest( CCSVTest::suite() );
+	runner.addTest( CSnapshotTest::suite() );
+	runner.addTest( CMappedDatabaseTest::suite() );
 
 	runner.run();
 